@@ -0,0 +1,136 @@
+/*
+Copyright (c) 2017, Michael J Welsh
+
+Permission to use, copy, modify, and/or distribute this software
+for any purpose with or without fee is hereby granted, provided
+that the above copyright notice and this permission notice appear
+in all copies.
+
+THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL
+WARRANTIES WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE
+AUTHOR BE LIABLE FOR ANY SPECIAL, DIRECT, INDIRECT, OR
+CONSEQUENTIAL DAMAGES OR ANY DAMAGES WHATSOEVER RESULTING FROM
+LOSS OF USE, DATA OR PROFITS, WHETHER IN AN ACTION OF CONTRACT,
+NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF OR IN
+CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <stddef.h>
+#include <string.h>
+
+#include "benchmarking_framework.h"
+#include "../src/arena.h"
+#include "../src/rbtree.h"
+#include "../src/hashtable.h"
+
+/* ========================================================================================================
+ *
+ *                                            BENCHMARK UTILITIES
+ *
+ * ======================================================================================================== */
+
+/* The number of objects built and torn down per simulated request. */
+#define REQUEST_SIZE 1000
+
+#define CHUNK_SIZE (64 * 1024)
+
+typedef struct Object {
+    size_t key;
+    RBTreeNode rbtree_node;
+    HashTableNode hashtable_node;
+} Object;
+
+size_t sink;
+
+static int compare_func(const void *key, const RBTreeNode *node) {
+    size_t a = *(const size_t*) key, b = rbtree_entry(node, Object, rbtree_node)->key;
+
+    return a < b ? -1 : a > b;
+}
+
+static size_t hash_func(const void *key) {
+    return *(const size_t*) key;
+}
+
+static int equal_func(const void *key, const HashTableNode *node) {
+    return *(const size_t*) key == hashtable_entry(node, Object, hashtable_node)->key;
+}
+
+/* ========================================================================================================
+ *
+ *                                                BENCHMARKS
+ *
+ * ======================================================================================================== */
+
+int main(int argc, char *argv[]) {
+    size_t count = bench_count(argc, argv, 1000000), requests = (count + REQUEST_SIZE - 1) / REQUEST_SIZE;
+    size_t *keys = (size_t*) malloc(REQUEST_SIZE * sizeof(size_t)), request, i;
+    HashTableNode **bucket_array;
+    HashTable hashtable;
+    RBTree rbtree;
+    RBTreeNode *first;
+    Object *obj;
+    Arena arena;
+    double start;
+
+    for (i = 0; i < REQUEST_SIZE; ++i) {
+        keys[i] = bench_random();
+    }
+
+    /* Every object and bucket array comes from malloc(), and every node is removed and freed one by one. */
+    start = bench_seconds();
+    for (request = 0; request < requests; ++request) {
+        bucket_array = (HashTableNode**) calloc(REQUEST_SIZE, sizeof(HashTableNode*));
+        hashtable_fast_init(&hashtable, bucket_array, REQUEST_SIZE, hash_func, equal_func, NULL, NULL);
+        rbtree_init(&rbtree, compare_func, NULL, NULL);
+
+        for (i = 0; i < REQUEST_SIZE; ++i) {
+            obj = (Object*) malloc(sizeof(Object));
+            obj->key = keys[i] + request;
+            rbtree_insert(&rbtree, &obj->key, &obj->rbtree_node);
+            hashtable_insert(&hashtable, &obj->key, &obj->hashtable_node);
+        }
+        sink += rbtree_size(&rbtree);
+
+        while ((first = rbtree_first(&rbtree))) {
+            obj = rbtree_entry(first, Object, rbtree_node);
+            rbtree_remove_first(&rbtree);
+            hashtable_remove_key(&hashtable, &obj->key);
+            free(obj);
+        }
+        free(bucket_array);
+    }
+    bench_report("malloc, per-node teardown", requests * REQUEST_SIZE, bench_seconds() - start);
+
+    /* Everything comes from the arena, and is torn down with the remove_all functions and one reset. */
+    arena_init(&arena, CHUNK_SIZE, NULL, NULL, NULL);
+    start = bench_seconds();
+    for (request = 0; request < requests; ++request) {
+        bucket_array = (HashTableNode**) arena_alloc_zeroed(&arena, REQUEST_SIZE * sizeof(HashTableNode*));
+        hashtable_fast_init(&hashtable, bucket_array, REQUEST_SIZE, hash_func, equal_func, NULL, NULL);
+        rbtree_init(&rbtree, compare_func, NULL, NULL);
+
+        for (i = 0; i < REQUEST_SIZE; ++i) {
+            obj = (Object*) arena_alloc(&arena, sizeof(Object));
+            obj->key = keys[i] + request;
+            rbtree_insert(&rbtree, &obj->key, &obj->rbtree_node);
+            hashtable_insert(&hashtable, &obj->key, &obj->hashtable_node);
+        }
+        sink += rbtree_size(&rbtree);
+
+        rbtree_remove_all(&rbtree);
+        hashtable_remove_all(&hashtable);
+        arena_reset(&arena);
+    }
+    bench_report("arena, remove_all + arena_reset", requests * REQUEST_SIZE, bench_seconds() - start);
+    arena_release(&arena);
+
+    printf("(checksum %lu)\n", (unsigned long) sink);
+
+    free(keys);
+
+    return 0;
+}
@@ -0,0 +1,163 @@
+/*
+Copyright (c) 2017, Michael J Welsh
+
+Permission to use, copy, modify, and/or distribute this software
+for any purpose with or without fee is hereby granted, provided
+that the above copyright notice and this permission notice appear
+in all copies.
+
+THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL
+WARRANTIES WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE
+AUTHOR BE LIABLE FOR ANY SPECIAL, DIRECT, INDIRECT, OR
+CONSEQUENTIAL DAMAGES OR ANY DAMAGES WHATSOEVER RESULTING FROM
+LOSS OF USE, DATA OR PROFITS, WHETHER IN AN ACTION OF CONTRACT,
+NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF OR IN
+CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <stddef.h>
+#include <string.h>
+
+#include "benchmarking_framework.h"
+#include "../src/hashtable.h"
+#include "../src/hash_string.h"
+
+/* ========================================================================================================
+ *
+ *                                            BENCHMARK UTILITIES
+ *
+ * ======================================================================================================== */
+
+#define KEY_CAPACITY 32
+#define NUM_COLLIDING_BLOCKS 13
+
+typedef struct Entry {
+    char key[KEY_CAPACITY];
+    HashTableNode node;
+} Entry;
+
+size_t sink;
+
+static int equal_func(const void *key, const HashTableNode *node) {
+    return strcmp((const char*) key, hashtable_entry(node, Entry, node)->key) == 0;
+}
+
+static void random_string(char *str, size_t len) {
+    size_t i;
+    for (i = 0; i < len; ++i) {
+        str[i] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789-_"[bench_random() % 64];
+    }
+    str[len] = '\0';
+}
+
+/* "az" and "bY" contribute the same amount to a djb2 hash, so any sequence of them collides. */
+static void colliding_string(char *str, size_t index) {
+    size_t i;
+    for (i = 0; i < NUM_COLLIDING_BLOCKS; ++i) {
+        str[2 * i] = (index >> i) & 1 ? 'b' : 'a';
+        str[2 * i + 1] = (index >> i) & 1 ? 'Y' : 'z';
+    }
+    str[2 * NUM_COLLIDING_BLOCKS] = '\0';
+}
+
+static void bench_raw_hash(size_t count, size_t len, const HashStringSeed *seed) {
+    char name[64], *strs;
+    size_t i, num_strs = 256;
+    double start;
+
+    strs = (char*) malloc(num_strs * (len + 1));
+    for (i = 0; i < num_strs; ++i) {
+        random_string(strs + i * (len + 1), len);
+    }
+
+    start = bench_seconds();
+    for (i = 0; i < count; ++i) {
+        sink += hash_string(strs + (i % num_strs) * (len + 1));
+    }
+    sprintf(name, "hash_string, %lu bytes", (unsigned long) len);
+    bench_report(name, count, bench_seconds() - start);
+
+    start = bench_seconds();
+    for (i = 0; i < count; ++i) {
+        sink += hash_string_seeded(strs + (i % num_strs) * (len + 1), seed);
+    }
+    sprintf(name, "hash_string_seeded, %lu bytes", (unsigned long) len);
+    bench_report(name, count, bench_seconds() - start);
+
+    free(strs);
+}
+
+static void bench_table(const char *label, Entry *entries, size_t count, const HashStringSeed *seed) {
+    HashTable hashtable;
+    HashTableNode **bucket_array;
+    char name[64];
+    size_t i;
+    double start;
+
+    bucket_array = (HashTableNode**) calloc(count, sizeof(HashTableNode*));
+    hashtable_fast_init(&hashtable, bucket_array, count, hash_string, equal_func, NULL, NULL);
+    if (seed) {
+        hashtable_seed(&hashtable, hash_string_seeded, seed);
+    }
+
+    start = bench_seconds();
+    for (i = 0; i < count; ++i) {
+        hashtable_insert(&hashtable, entries[i].key, &entries[i].node);
+    }
+    sprintf(name, "%s insert (%s)", label, seed ? "seeded" : "djb2");
+    bench_report(name, count, bench_seconds() - start);
+
+    start = bench_seconds();
+    for (i = 0; i < count; ++i) {
+        sink += hashtable_lookup_key(&hashtable, entries[i].key) != NULL;
+    }
+    sprintf(name, "%s lookup (%s)", label, seed ? "seeded" : "djb2");
+    bench_report(name, count, bench_seconds() - start);
+
+    free(bucket_array);
+}
+
+/* ========================================================================================================
+ *
+ *                                                BENCHMARKS
+ *
+ * ======================================================================================================== */
+
+int main(int argc, char *argv[]) {
+    size_t count = bench_count(argc, argv, 1000000), i;
+    size_t num_colliding = (size_t) 1 << NUM_COLLIDING_BLOCKS;
+    HashStringSeed seed;
+    Entry *entries;
+
+    seed.k0 = bench_random();
+    seed.k1 = bench_random();
+
+    bench_raw_hash(count, 8, &seed);
+    bench_raw_hash(count, 16, &seed);
+    bench_raw_hash(count, 64, &seed);
+    bench_raw_hash(count, 256, &seed);
+    bench_raw_hash(count / 4, 1024, &seed);
+    bench_raw_hash(count / 8, 2048, &seed);
+
+    entries = (Entry*) malloc((count > num_colliding ? count : num_colliding) * sizeof(Entry));
+
+    for (i = 0; i < count; ++i) {
+        random_string(entries[i].key, 16);
+    }
+    bench_table("random 16 byte keys,", entries, count, NULL);
+    bench_table("random 16 byte keys,", entries, count, &seed);
+
+    for (i = 0; i < num_colliding; ++i) {
+        colliding_string(entries[i].key, i);
+    }
+    bench_table("crafted djb2 collisions,", entries, num_colliding, NULL);
+    bench_table("crafted djb2 collisions,", entries, num_colliding, &seed);
+
+    printf("(checksum %lu)\n", (unsigned long) sink);
+    free(entries);
+
+    return 0;
+}
@@ -0,0 +1,251 @@
+/*
+Copyright (c) 2017, Michael J Welsh
+
+Permission to use, copy, modify, and/or distribute this software
+for any purpose with or without fee is hereby granted, provided
+that the above copyright notice and this permission notice appear
+in all copies.
+
+THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL
+WARRANTIES WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE
+AUTHOR BE LIABLE FOR ANY SPECIAL, DIRECT, INDIRECT, OR
+CONSEQUENTIAL DAMAGES OR ANY DAMAGES WHATSOEVER RESULTING FROM
+LOSS OF USE, DATA OR PROFITS, WHETHER IN AN ACTION OF CONTRACT,
+NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF OR IN
+CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <stddef.h>
+#include <string.h>
+
+#include "benchmarking_framework.h"
+#include "../src/hashtable.h"
+#include "../src/hash_string.h"
+
+/* ========================================================================================================
+ *
+ *                                            BENCHMARK UTILITIES
+ *
+ * ======================================================================================================== */
+
+#define NUM_TABLES 3
+#define NUM_KEYS 4096
+
+#define NUM_COUNTERS 65536
+
+typedef struct Entry {
+    const char *key;
+    HashTableNode node;
+} Entry;
+
+typedef struct Item {
+    size_t key;
+    HashTableNode node;
+} Item;
+
+typedef struct Counter {
+    const char *key;
+    size_t count;
+    HashTableNode node;
+} Counter;
+
+size_t sink;
+
+static int equal_func(const void *key, const HashTableNode *node) {
+    return strcmp((const char*) key, hashtable_entry(node, Entry, node)->key) == 0;
+}
+
+static int counter_equal_func(const void *key, const HashTableNode *node) {
+    return strcmp((const char*) key, hashtable_entry(node, Counter, node)->key) == 0;
+}
+
+static size_t item_hash_func(const void *key) {
+    return *(const size_t*) key;
+}
+
+static int item_equal_func(const void *key, const HashTableNode *node) {
+    return *(const size_t*) key == hashtable_entry(node, Item, node)->key;
+}
+
+static char* random_strings(size_t num_strs, size_t len) {
+    char *strs = (char*) malloc(num_strs * (len + 1));
+    size_t i, j;
+
+    for (i = 0; i < num_strs; ++i) {
+        for (j = 0; j < len; ++j) {
+            strs[i * (len + 1) + j] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789-_"[bench_random() % 64];
+        }
+        strs[i * (len + 1) + len] = '\0';
+    }
+
+    return strs;
+}
+
+/* Looks every key up in NUM_TABLES tables sharing the same hash function, hashing once or once per table. */
+static void bench_fan_out(size_t count, size_t len) {
+    static HashTableNode *bucket_arrays[NUM_TABLES][NUM_KEYS];
+    static Entry entries[NUM_TABLES][NUM_KEYS];
+    HashTable tables[NUM_TABLES];
+    char name[64], *strs = random_strings(NUM_KEYS, len);
+    size_t i, t;
+    double start;
+
+    for (t = 0; t < NUM_TABLES; ++t) {
+        hashtable_init(&tables[t], bucket_arrays[t], NUM_KEYS, hash_string, equal_func, NULL, NULL);
+        for (i = 0; i < NUM_KEYS; ++i) {
+            entries[t][i].key = strs + i * (len + 1);
+            hashtable_insert(&tables[t], entries[t][i].key, &entries[t][i].node);
+        }
+    }
+
+    start = bench_seconds();
+    for (i = 0; i < count; ++i) {
+        const char *key = strs + (i % NUM_KEYS) * (len + 1);
+        for (t = 0; t < NUM_TABLES; ++t) {
+            sink += hashtable_lookup_key(&tables[t], key) != NULL;
+        }
+    }
+    sprintf(name, "%d-table lookup, %lu byte keys", NUM_TABLES, (unsigned long) len);
+    bench_report(name, count, bench_seconds() - start);
+
+    start = bench_seconds();
+    for (i = 0; i < count; ++i) {
+        const char *key = strs + (i % NUM_KEYS) * (len + 1);
+        size_t hashcode = hashtable_hash_key(&tables[0], key);
+        for (t = 0; t < NUM_TABLES; ++t) {
+            sink += hashtable_lookup_key_hashed(&tables[t], key, hashcode) != NULL;
+        }
+    }
+    sprintf(name, "%d-table lookup_hashed, %lu byte keys", NUM_TABLES, (unsigned long) len);
+    bench_report(name, count, bench_seconds() - start);
+
+    free(strs);
+}
+
+/* Increments the counter of a random key, creating the counter on first use ("get or create"). */
+static void bench_get_or_create(size_t count) {
+    static HashTableNode *bucket_array[NUM_COUNTERS];
+    static Counter counters[NUM_COUNTERS + 1];
+    char *strs = random_strings(NUM_COUNTERS, 16);
+    size_t *picks = (size_t*) malloc(count * sizeof(size_t)), i, num_created;
+    HashTable hashtable;
+    double start;
+    int method;
+
+    for (i = 0; i < count; ++i) {
+        picks[i] = bench_random() % NUM_COUNTERS;
+    }
+
+    for (method = 0; method < 3; ++method) {
+        hashtable_init(&hashtable, bucket_array, NUM_COUNTERS, hash_string, counter_equal_func, NULL, NULL);
+        num_created = 0;
+
+        start = bench_seconds();
+        for (i = 0; i < count; ++i) {
+            const char *key = strs + picks[i] * 17;
+            Counter *c = &counters[num_created];
+            HashTableNode *n, **slot;
+
+            if (method == 0) {
+                n = hashtable_lookup_key(&hashtable, key);
+                if (!n) {
+                    c->key = key;
+                    c->count = 0;
+                    hashtable_insert(&hashtable, key, &c->node);
+                    n = &c->node;
+                    ++num_created;
+                }
+            } else if (method == 1) {
+                c->key = key;
+                c->count = 0;
+                n = hashtable_insert_unique(&hashtable, key, &c->node);
+                if (!n) {
+                    n = &c->node;
+                    ++num_created;
+                }
+            } else {
+                slot = hashtable_lookup_slot(&hashtable, key);
+                if (!*slot) {
+                    c->key = key;
+                    c->count = 0;
+                    hashtable_insert_at_slot(&hashtable, slot, &c->node);
+                    ++num_created;
+                }
+                n = *slot;
+            }
+
+            ++hashtable_entry(n, Counter, node)->count;
+        }
+        bench_report(
+            method == 0 ? "get or create, lookup_key + insert"
+                : method == 1 ? "get or create, insert_unique"
+                : "get or create, lookup_slot + insert_at_slot",
+            count,
+            bench_seconds() - start
+        );
+        sink += num_created;
+    }
+
+    free(picks);
+    free(strs);
+}
+
+/* Scans a table of count random keys in as many buckets, with and without prefetching. */
+static void bench_scan(size_t count) {
+    HashTableNode **bucket_array = (HashTableNode**) calloc(count, sizeof(HashTableNode*)), *n;
+    Item *items = (Item*) malloc(count * sizeof(Item));
+    HashTable hashtable;
+    size_t i, bkt;
+    double start;
+    int prefetch;
+
+    hashtable_fast_init(&hashtable, bucket_array, count, item_hash_func, item_equal_func, NULL, NULL);
+    for (i = 0; i < count; ++i) {
+        items[i].key = bench_random();
+        hashtable_insert(&hashtable, &items[i].key, &items[i].node);
+    }
+
+    for (prefetch = 0; prefetch <= 1; ++prefetch) {
+        start = bench_seconds();
+        if (prefetch) {
+            hashtable_for_each_prefetch(n, bkt, &hashtable) {
+                sink += hashtable_entry(n, Item, node)->key;
+            }
+        } else {
+            hashtable_for_each(n, bkt, &hashtable) {
+                sink += hashtable_entry(n, Item, node)->key;
+            }
+        }
+        bench_report(
+            prefetch ? "hashtable_for_each_prefetch" : "hashtable_for_each",
+            count,
+            bench_seconds() - start
+        );
+    }
+
+    free(items);
+    free(bucket_array);
+}
+
+/* ========================================================================================================
+ *
+ *                                                BENCHMARKS
+ *
+ * ======================================================================================================== */
+
+int main(int argc, char *argv[]) {
+    size_t count = bench_count(argc, argv, 1000000);
+
+    bench_fan_out(count, 16);
+    bench_fan_out(count, 256);
+    bench_fan_out(count / 4, 2048);
+    bench_get_or_create(count);
+    bench_scan(count);
+
+    printf("(checksum %lu)\n", (unsigned long) sink);
+
+    return 0;
+}
@@ -0,0 +1,181 @@
+/*
+Copyright (c) 2017, Michael J Welsh
+
+Permission to use, copy, modify, and/or distribute this software
+for any purpose with or without fee is hereby granted, provided
+that the above copyright notice and this permission notice appear
+in all copies.
+
+THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL
+WARRANTIES WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE
+AUTHOR BE LIABLE FOR ANY SPECIAL, DIRECT, INDIRECT, OR
+CONSEQUENTIAL DAMAGES OR ANY DAMAGES WHATSOEVER RESULTING FROM
+LOSS OF USE, DATA OR PROFITS, WHETHER IN AN ACTION OF CONTRACT,
+NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF OR IN
+CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <stddef.h>
+#include <string.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+
+#include "benchmarking_framework.h"
+#include "../src/hashtable_snapshot.h"
+
+/* ========================================================================================================
+ *
+ *                                            BENCHMARK UTILITIES
+ *
+ * ======================================================================================================== */
+
+#define SNAPSHOT_PATH "bench_hashtable_snapshot.tmp"
+
+/* A cache entry of 64 bytes. */
+typedef struct Item {
+    size_t key;
+    size_t val[6];
+    HashTableNode node;
+} Item;
+
+size_t sink;
+
+static size_t hash_func(const void *key) {
+    return *(const size_t*) key;
+}
+
+static int equal_func(const void *key, const HashTableNode *node) {
+    return *(const size_t*) key == hashtable_entry(node, Item, node)->key;
+}
+
+static const void* node_key_func(const HashTableNode *node) {
+    return &hashtable_entry(node, Item, node)->key;
+}
+
+/* Maps the snapshot file into memory, copy-on-write if writable. */
+static void* map_snapshot(size_t size, int writable) {
+    int fd = open(SNAPSHOT_PATH, writable ? O_RDWR : O_RDONLY);
+    void *snapshot;
+
+    snapshot = mmap(NULL, size, PROT_READ | (writable ? PROT_WRITE : 0), MAP_PRIVATE, fd, 0);
+    close(fd);
+
+    if (snapshot == MAP_FAILED) {
+        perror("mmap");
+        exit(1);
+    }
+
+    return snapshot;
+}
+
+/* Looks up every key once, in random order, and returns the elapsed time. */
+static double lookup_all(const HashTable *hashtable, const void *snapshot, const size_t *keys, size_t count) {
+    const HashTableNode *n;
+    double start = bench_seconds();
+    size_t i;
+
+    for (i = 0; i < count; ++i) {
+        if (snapshot) {
+            n = hashtable_snapshot_lookup_key(hashtable, snapshot, &keys[bench_random() % count]);
+        } else {
+            n = hashtable_lookup_key(hashtable, &keys[bench_random() % count]);
+        }
+        sink += hashtable_entry(n, Item, node)->val[0];
+    }
+
+    return bench_seconds() - start;
+}
+
+/* ========================================================================================================
+ *
+ *                                                BENCHMARKS
+ *
+ * ======================================================================================================== */
+
+int main(int argc, char *argv[]) {
+    size_t count = bench_count(argc, argv, 1000000), size, i;
+    size_t *keys = (size_t*) malloc(count * sizeof(size_t));
+    Item **items = (Item**) malloc(count * sizeof(Item*));
+    HashTableNode **bucket_array, *loaded_bucket;
+    HashTable hashtable, loaded;
+    void *snapshot;
+    double start;
+    FILE *file;
+
+    for (i = 0; i < count; ++i) {
+        keys[i] = bench_random() * 2 + 1;
+    }
+
+    /* Rebuilding the table from its source, one allocation per item. */
+    start = bench_seconds();
+    bucket_array = (HashTableNode**) calloc(count, sizeof(HashTableNode*));
+    hashtable_fast_init(&hashtable, bucket_array, count, hash_func, equal_func, NULL, NULL);
+    for (i = 0; i < count; ++i) {
+        items[i] = (Item*) malloc(sizeof(Item));
+        items[i]->key = keys[i];
+        items[i]->val[0] = i;
+        hashtable_insert(&hashtable, &items[i]->key, &items[i]->node);
+    }
+    bench_report("rebuild (malloc + hashtable_insert)", count, bench_seconds() - start);
+
+    start = bench_seconds();
+    size = hashtable_snapshot_bytes(&hashtable, sizeof(Item));
+    snapshot = malloc(size);
+    hashtable_snapshot_write(&hashtable, snapshot, sizeof(Item), offsetof(Item, node));
+    file = fopen(SNAPSHOT_PATH, "wb");
+    if (!file || fwrite(snapshot, 1, size, file) != size || fclose(file) != 0) {
+        perror(SNAPSHOT_PATH);
+        return 1;
+    }
+    free(snapshot);
+    bench_report("hashtable_snapshot_write + fwrite", count, bench_seconds() - start);
+    printf("    (%.1f MB snapshot, read back from the page cache below)\n", size / 1e6);
+
+    bench_report("lookup hit, rebuilt table", count, lookup_all(&hashtable, NULL, keys, count));
+
+    /* Relocating the offsets into pointers, with and without checking every record's bucket. */
+    start = bench_seconds();
+    snapshot = map_snapshot(size, 1);
+    hashtable_init(&loaded, &loaded_bucket, 1, hash_func, equal_func, NULL, NULL);
+    if (!hashtable_snapshot_load(&loaded, snapshot, size, NULL)) {
+        return 1;
+    }
+    bench_report("mmap + hashtable_snapshot_load", count, bench_seconds() - start);
+    bench_report("lookup hit, loaded table", count, lookup_all(&loaded, NULL, keys, count));
+    munmap(snapshot, size);
+
+    start = bench_seconds();
+    snapshot = map_snapshot(size, 1);
+    hashtable_init(&loaded, &loaded_bucket, 1, hash_func, equal_func, NULL, NULL);
+    if (!hashtable_snapshot_load(&loaded, snapshot, size, node_key_func)) {
+        return 1;
+    }
+    bench_report("mmap + hashtable_snapshot_load, node_key", count, bench_seconds() - start);
+    munmap(snapshot, size);
+
+    /* Following the offsets of a read-only mapping. */
+    start = bench_seconds();
+    snapshot = map_snapshot(size, 0);
+    if (!hashtable_snapshot_check(&loaded, snapshot, size, NULL)) {
+        return 1;
+    }
+    bench_report("mmap read-only + hashtable_snapshot_check", count, bench_seconds() - start);
+    bench_report("hashtable_snapshot_lookup_key hit", count, lookup_all(&loaded, snapshot, keys, count));
+    munmap(snapshot, size);
+
+    printf("(checksum %lu)\n", (unsigned long) sink);
+
+    remove(SNAPSHOT_PATH);
+    for (i = 0; i < count; ++i) {
+        free(items[i]);
+    }
+    free(bucket_array);
+    free(items);
+    free(keys);
+
+    return 0;
+}
@@ -0,0 +1,138 @@
+/*
+Copyright (c) 2017, Michael J Welsh
+
+Permission to use, copy, modify, and/or distribute this software
+for any purpose with or without fee is hereby granted, provided
+that the above copyright notice and this permission notice appear
+in all copies.
+
+THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL
+WARRANTIES WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE
+AUTHOR BE LIABLE FOR ANY SPECIAL, DIRECT, INDIRECT, OR
+CONSEQUENTIAL DAMAGES OR ANY DAMAGES WHATSOEVER RESULTING FROM
+LOSS OF USE, DATA OR PROFITS, WHETHER IN AN ACTION OF CONTRACT,
+NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF OR IN
+CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <stddef.h>
+
+#include "benchmarking_framework.h"
+#include "../src/rbtree.h"
+#include "../src/heap.h"
+
+/* ========================================================================================================
+ *
+ *                                            BENCHMARK UTILITIES
+ *
+ * ======================================================================================================== */
+
+/* Each structure gets its own copy of the timers, so that both see the same deadlines. */
+typedef struct Timer {
+    size_t deadline;
+    HeapNode heap_node;
+    RBTreeNode rbtree_node;
+} Timer;
+
+size_t sink;
+
+static int heap_compare_func(const HeapNode *a, const HeapNode *b) {
+    size_t x = heap_entry(a, Timer, heap_node)->deadline, y = heap_entry(b, Timer, heap_node)->deadline;
+
+    return x < y ? -1 : x > y;
+}
+
+/* Timers with equal deadlines are ordered by address, since a RBTree replaces equal keys. */
+static int rbtree_compare_func(const void *key, const RBTreeNode *node) {
+    const Timer *a = (const Timer*) key, *b = rbtree_entry(node, Timer, rbtree_node);
+
+    if (a->deadline != b->deadline) {
+        return a->deadline < b->deadline ? -1 : 1;
+    }
+
+    return a < b ? -1 : a > b;
+}
+
+/* ========================================================================================================
+ *
+ *                                                BENCHMARKS
+ *
+ * ======================================================================================================== */
+
+int main(int argc, char *argv[]) {
+    size_t count = bench_count(argc, argv, 1000000), i;
+    Timer *timers = (Timer*) malloc(count * sizeof(Timer));
+    Timer *rbtree_timers = (Timer*) malloc(count * sizeof(Timer));
+    HeapNode **node_array = (HeapNode**) malloc(count * sizeof(HeapNode*));
+    size_t *order = (size_t*) malloc(count * sizeof(size_t));
+    RBTreeNode *node;
+    RBTree rbtree;
+    Heap heap;
+    double start;
+
+    for (i = 0; i < count; ++i) {
+        timers[i].deadline = bench_random();
+        rbtree_timers[i].deadline = timers[i].deadline;
+        order[i] = bench_random() % count;
+    }
+
+    start = bench_seconds();
+    heap_init(&heap, node_array, count, heap_compare_func);
+    for (i = 0; i < count; ++i) {
+        heap_push(&heap, &timers[i].heap_node);
+    }
+    bench_report("heap_push", count, bench_seconds() - start);
+
+    start = bench_seconds();
+    rbtree_init(&rbtree, rbtree_compare_func, NULL, NULL);
+    for (i = 0; i < count; ++i) {
+        rbtree_insert(&rbtree, &rbtree_timers[i], &rbtree_timers[i].rbtree_node);
+    }
+    bench_report("rbtree_insert", count, bench_seconds() - start);
+
+    /* Rescheduling timers a quarter earlier, in a random order. */
+    start = bench_seconds();
+    for (i = 0; i < count; ++i) {
+        Timer *timer = &timers[order[i]];
+
+        timer->deadline -= timer->deadline / 4;
+        heap_update(&heap, &timer->heap_node);
+    }
+    bench_report("heap_update, decrease-key", count, bench_seconds() - start);
+
+    /* The RBTree needs the old key to find the node, so it is removed before the key changes. */
+    start = bench_seconds();
+    for (i = 0; i < count; ++i) {
+        Timer *timer = &rbtree_timers[order[i]];
+
+        rbtree_remove(&rbtree, &timer->rbtree_node);
+        timer->deadline -= timer->deadline / 4;
+        rbtree_insert(&rbtree, timer, &timer->rbtree_node);
+    }
+    bench_report("rbtree_remove + rbtree_insert, decrease-key", count, bench_seconds() - start);
+
+    start = bench_seconds();
+    while (!heap_empty(&heap)) {
+        sink += heap_entry(heap_pop(&heap), Timer, heap_node)->deadline;
+    }
+    bench_report("heap_pop", count, bench_seconds() - start);
+
+    start = bench_seconds();
+    while ((node = rbtree_first(&rbtree))) {
+        sink += rbtree_entry(node, Timer, rbtree_node)->deadline;
+        rbtree_remove(&rbtree, node);
+    }
+    bench_report("rbtree_first + rbtree_remove", count, bench_seconds() - start);
+
+    printf("(checksum %lu)\n", (unsigned long) sink);
+
+    free(order);
+    free(node_array);
+    free(rbtree_timers);
+    free(timers);
+
+    return 0;
+}
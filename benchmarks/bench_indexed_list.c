@@ -0,0 +1,123 @@
+/*
+Copyright (c) 2017, Michael J Welsh
+
+Permission to use, copy, modify, and/or distribute this software
+for any purpose with or without fee is hereby granted, provided
+that the above copyright notice and this permission notice appear
+in all copies.
+
+THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL
+WARRANTIES WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE
+AUTHOR BE LIABLE FOR ANY SPECIAL, DIRECT, INDIRECT, OR
+CONSEQUENTIAL DAMAGES OR ANY DAMAGES WHATSOEVER RESULTING FROM
+LOSS OF USE, DATA OR PROFITS, WHETHER IN AN ACTION OF CONTRACT,
+NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF OR IN
+CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <stddef.h>
+#include <string.h>
+
+#include "benchmarking_framework.h"
+#include "../src/list.h"
+#include "../src/indexed_list.h"
+
+/* ========================================================================================================
+ *
+ *                                            BENCHMARK UTILITIES
+ *
+ * ======================================================================================================== */
+
+#define NUM_ELEMENTS 100000
+
+/* The O(n) List functions get this many times fewer operations. */
+#define LIST_OPS_DIVISOR 1000
+
+typedef struct Object {
+    unsigned long val;
+    ListNode list_node;
+    IndexedListNode indexed_node;
+} Object;
+
+size_t sink;
+
+/* ========================================================================================================
+ *
+ *                                                BENCHMARKS
+ *
+ * ======================================================================================================== */
+
+int main(int argc, char *argv[]) {
+    size_t count = bench_count(argc, argv, 1000000), list_count, i;
+    Object *objs = (Object*) malloc(NUM_ELEMENTS * sizeof(Object));
+    List list;
+    IndexedList indexed_list;
+    double start;
+
+    list_count = count / LIST_OPS_DIVISOR ? count / LIST_OPS_DIVISOR : 1;
+
+    printf("(%d elements)\n", NUM_ELEMENTS);
+
+    list_init(&list);
+    start = bench_seconds();
+    for (i = 0; i < NUM_ELEMENTS; ++i) {
+        objs[i].val = i;
+        list_insert_back(&list, &objs[i].list_node);
+    }
+    bench_report("list_insert_back", NUM_ELEMENTS, bench_seconds() - start);
+
+    indexed_list_init(&indexed_list);
+    start = bench_seconds();
+    for (i = 0; i < NUM_ELEMENTS; ++i) {
+        indexed_list_insert_back(&indexed_list, &objs[i].indexed_node);
+    }
+    bench_report("indexed_list_insert_back", NUM_ELEMENTS, bench_seconds() - start);
+
+    start = bench_seconds();
+    for (i = 0; i < list_count; ++i) {
+        sink += list_entry(list_at(&list, bench_random() % NUM_ELEMENTS), Object, list_node)->val;
+    }
+    bench_report("list_at, random index", list_count, bench_seconds() - start);
+
+    start = bench_seconds();
+    for (i = 0; i < count; ++i) {
+        IndexedListNode *n = indexed_list_at(&indexed_list, bench_random() % NUM_ELEMENTS);
+        sink += indexed_list_entry(n, Object, indexed_node)->val;
+    }
+    bench_report("indexed_list_at, random index", count, bench_seconds() - start);
+
+    start = bench_seconds();
+    for (i = 0; i < list_count; ++i) {
+        sink += list_index_of(&list, &objs[bench_random() % NUM_ELEMENTS].list_node);
+    }
+    bench_report("list_index_of, random node", list_count, bench_seconds() - start);
+
+    start = bench_seconds();
+    for (i = 0; i < count; ++i) {
+        sink += indexed_list_index_of(&indexed_list, &objs[bench_random() % NUM_ELEMENTS].indexed_node);
+    }
+    bench_report("indexed_list_index_of, random node", count, bench_seconds() - start);
+
+    start = bench_seconds();
+    for (i = 0; i < list_count; ++i) {
+        ListNode *n = list_at(&list, bench_random() % NUM_ELEMENTS);
+        list_remove(&list, n);
+        list_insert_left(&list, n, list_at(&list, bench_random() % (NUM_ELEMENTS - 1)));
+    }
+    bench_report("list move to random index", list_count, bench_seconds() - start);
+
+    start = bench_seconds();
+    for (i = 0; i < count; ++i) {
+        IndexedListNode *n = indexed_list_at(&indexed_list, bench_random() % NUM_ELEMENTS);
+        indexed_list_remove(&indexed_list, n);
+        indexed_list_insert_at(&indexed_list, n, bench_random() % NUM_ELEMENTS);
+    }
+    bench_report("indexed_list move to random index", count, bench_seconds() - start);
+
+    free(objs);
+
+    return 0;
+}
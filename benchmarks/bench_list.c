@@ -0,0 +1,231 @@
+/*
+Copyright (c) 2017, Michael J Welsh
+
+Permission to use, copy, modify, and/or distribute this software
+for any purpose with or without fee is hereby granted, provided
+that the above copyright notice and this permission notice appear
+in all copies.
+
+THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL
+WARRANTIES WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE
+AUTHOR BE LIABLE FOR ANY SPECIAL, DIRECT, INDIRECT, OR
+CONSEQUENTIAL DAMAGES OR ANY DAMAGES WHATSOEVER RESULTING FROM
+LOSS OF USE, DATA OR PROFITS, WHETHER IN AN ACTION OF CONTRACT,
+NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF OR IN
+CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <stddef.h>
+#include <string.h>
+#include <pthread.h>
+
+#include "benchmarking_framework.h"
+#include "../src/list.h"
+
+/* ========================================================================================================
+ *
+ *                                            BENCHMARK UTILITIES
+ *
+ * ======================================================================================================== */
+
+#define NUM_PATTERNS 4
+#define NUM_THREADS 4
+
+typedef struct Object {
+    unsigned long key;
+    ListNode node;
+} Object;
+
+size_t sink;
+
+typedef void (*SortFunc)(List *list, int (*compare)(const ListNode *a, const ListNode *b));
+
+static ListSortEntry *entries;
+static ListSortTask tasks[NUM_THREADS];
+
+typedef struct Worker {
+    pthread_t thread;
+    void (*run)(ListSortTask *task);
+    ListSortTask *task;
+} Worker;
+
+static const char *pattern_names[NUM_PATTERNS] = { "random", "sorted", "reversed", "nearly sorted" };
+
+static int compare(const ListNode *a, const ListNode *b) {
+    unsigned long x = list_entry(a, Object, node)->key, y = list_entry(b, Object, node)->key;
+    return (x > y) - (x < y);
+}
+
+static size_t object_key(const ListNode *n) {
+    return list_entry(n, Object, node)->key;
+}
+
+static void sort_buffered(List *list, int (*compare)(const ListNode *a, const ListNode *b)) {
+    list_sort_buffered(list, entries, NULL, compare);
+}
+
+static void sort_buffered_keyed(List *list, int (*compare)(const ListNode *a, const ListNode *b)) {
+    list_sort_buffered(list, entries, object_key, compare);
+}
+
+static void sort_buffered_radix(List *list, int (*compare)(const ListNode *a, const ListNode *b)) {
+    (void) compare;
+    list_sort_buffered(list, entries, object_key, NULL);
+}
+
+static void sort_radix(List *list, int (*compare)(const ListNode *a, const ListNode *b)) {
+    (void) compare;
+    list_sort_radix(list, object_key);
+}
+
+static void* start_worker(void *worker) {
+    ((Worker*) worker)->run(((Worker*) worker)->task);
+    return NULL;
+}
+
+/* Runs each task on its own thread, and the first on the calling thread. */
+static void execute(void (*run)(ListSortTask *task), ListSortTask *tasks, size_t num_tasks, void *executor_data) {
+    Worker workers[NUM_THREADS];
+    size_t i;
+
+    (void) executor_data;
+
+    for (i = 1; i < num_tasks; ++i) {
+        workers[i].run = run;
+        workers[i].task = &tasks[i];
+        pthread_create(&workers[i].thread, NULL, start_worker, &workers[i]);
+    }
+    run(&tasks[0]);
+    for (i = 1; i < num_tasks; ++i) {
+        pthread_join(workers[i].thread, NULL);
+    }
+}
+
+static void sort_parallel(List *list, int (*compare)(const ListNode *a, const ListNode *b)) {
+    list_sort_parallel(list, compare, tasks, NUM_THREADS, execute, NULL);
+}
+
+/*
+ * Gives the objects keys following the pattern, and links them in a random memory order so that walking the
+ * list jumps around the heap like a long-lived list does.
+ */
+static void build_list(List *list, Object *objs, size_t *order, size_t count, int pattern) {
+    size_t i;
+
+    for (i = 0; i < count; ++i) {
+        switch (pattern) {
+            case 0:
+                objs[order[i]].key = bench_random();
+                break;
+            case 1:
+                objs[order[i]].key = i;
+                break;
+            case 2:
+                objs[order[i]].key = count - i;
+                break;
+            default:
+                /* Time-ordered events with 1% stragglers. */
+                objs[order[i]].key = bench_random() % 100 == 0 && i > 1000 ? i - bench_random() % 1000 : i;
+        }
+    }
+
+    list_init(list);
+    for (i = 0; i < count; ++i) {
+        list_insert_back(list, &objs[order[i]].node);
+    }
+}
+
+static void bench_sort(const char *sort_name, SortFunc sort, Object *objs, size_t *order, size_t count) {
+    char name[64];
+    List list;
+    int pattern;
+    double start;
+
+    for (pattern = 0; pattern < NUM_PATTERNS; ++pattern) {
+        build_list(&list, objs, order, count, pattern);
+
+        start = bench_seconds();
+        sort(&list, compare);
+        sprintf(name, "%s, %s", sort_name, pattern_names[pattern]);
+        bench_report(name, count, bench_seconds() - start);
+    }
+}
+
+/* Mixes the key a number of times, standing in for the work a loop's body does on each node. */
+static unsigned long work(unsigned long key, int rounds) {
+    while (rounds-- > 0) {
+        key = (key ^ (key >> 15)) * 2654435761UL;
+    }
+    return key;
+}
+
+/* Scans a list linked in random memory order, with and without prefetching. */
+static void bench_scan(Object *objs, size_t *order, size_t count) {
+    char name[64];
+    List list;
+    ListNode *n;
+    int rounds, prefetch;
+    double start;
+
+    build_list(&list, objs, order, count, 0);
+
+    for (rounds = 0; rounds <= 16; rounds += 8) {
+        for (prefetch = 0; prefetch <= 1; ++prefetch) {
+            start = bench_seconds();
+            if (prefetch) {
+                list_for_each_prefetch(n, &list) {
+                    sink += work(list_entry(n, Object, node)->key, rounds);
+                }
+            } else {
+                list_for_each(n, &list) {
+                    sink += work(list_entry(n, Object, node)->key, rounds);
+                }
+            }
+            sprintf(name, "%s, %d rounds of work", prefetch ? "list_for_each_prefetch" : "list_for_each",
+                rounds);
+            bench_report(name, count, bench_seconds() - start);
+        }
+    }
+}
+
+/* ========================================================================================================
+ *
+ *                                                BENCHMARKS
+ *
+ * ======================================================================================================== */
+
+int main(int argc, char *argv[]) {
+    size_t count = bench_count(argc, argv, 1000000), i;
+    Object *objs = (Object*) malloc(count * sizeof(Object));
+    size_t *order = (size_t*) malloc(count * sizeof(size_t));
+
+    entries = (ListSortEntry*) malloc(2 * count * sizeof(ListSortEntry));
+
+    for (i = 0; i < count; ++i) {
+        order[i] = i;
+    }
+    for (i = count - 1; i > 0; --i) {
+        size_t j = bench_random() % (i + 1), tmp = order[i];
+        order[i] = order[j];
+        order[j] = tmp;
+    }
+
+    printf("(ns/op is per node)\n");
+    bench_scan(objs, order, count);
+    bench_sort("list_sort", list_sort, objs, order, count);
+    bench_sort("list_sort_natural", list_sort_natural, objs, order, count);
+    bench_sort("list_sort_buffered", sort_buffered, objs, order, count);
+    bench_sort("list_sort_buffered (key)", sort_buffered_keyed, objs, order, count);
+    bench_sort("list_sort_buffered (radix)", sort_buffered_radix, objs, order, count);
+    bench_sort("list_sort_radix", sort_radix, objs, order, count);
+    bench_sort("list_sort_parallel (4 threads)", sort_parallel, objs, order, count);
+
+    free(entries);
+    free(order);
+    free(objs);
+
+    return 0;
+}
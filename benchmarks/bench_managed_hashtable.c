@@ -0,0 +1,144 @@
+/*
+Copyright (c) 2017, Michael J Welsh
+
+Permission to use, copy, modify, and/or distribute this software
+for any purpose with or without fee is hereby granted, provided
+that the above copyright notice and this permission notice appear
+in all copies.
+
+THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL
+WARRANTIES WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE
+AUTHOR BE LIABLE FOR ANY SPECIAL, DIRECT, INDIRECT, OR
+CONSEQUENTIAL DAMAGES OR ANY DAMAGES WHATSOEVER RESULTING FROM
+LOSS OF USE, DATA OR PROFITS, WHETHER IN AN ACTION OF CONTRACT,
+NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF OR IN
+CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <stddef.h>
+#include <string.h>
+
+#include "benchmarking_framework.h"
+#include "../src/managed_hashtable.h"
+
+/* ========================================================================================================
+ *
+ *                                            BENCHMARK UTILITIES
+ *
+ * ======================================================================================================== */
+
+typedef struct Item {
+    size_t key;
+    size_t val;
+    HashTableNode node;
+} Item;
+
+/* The maximum load factors compared, in percent. */
+static const size_t max_loads[] = { 50, 75, 100, 150, 200, 400 };
+
+size_t sink;
+
+static size_t hash_func(const void *key) {
+    return *(const size_t*) key;
+}
+
+static int equal_func(const void *key, const HashTableNode *node) {
+    return *(const size_t*) key == hashtable_entry(node, Item, node)->key;
+}
+
+static const void* node_key_func(const HashTableNode *node) {
+    return &hashtable_entry(node, Item, node)->key;
+}
+
+/* ========================================================================================================
+ *
+ *                                                BENCHMARKS
+ *
+ * ======================================================================================================== */
+
+int main(int argc, char *argv[]) {
+    size_t count = bench_count(argc, argv, 1000000), i, l, key;
+    Item *items = (Item*) malloc(count * sizeof(Item));
+    HashTableNode **bucket_array = (HashTableNode**) malloc(count * sizeof(HashTableNode*));
+    ManagedHashTable table;
+    HashTable hashtable;
+    HashTableNode *n;
+    char name[100];
+    double start;
+
+    for (i = 0; i < count; ++i) {
+        items[i].key = bench_random() * 2 + 1;
+        items[i].val = i;
+    }
+
+    /* A plain HashTable with one bucket per item, sized by hand, as the baseline. */
+    start = bench_seconds();
+    hashtable_init(&hashtable, bucket_array, count, hash_func, equal_func, NULL, NULL);
+    for (i = 0; i < count; ++i) {
+        hashtable_insert(&hashtable, &items[i].key, &items[i].node);
+    }
+    bench_report("hashtable_insert, presized", count, bench_seconds() - start);
+
+    start = bench_seconds();
+    for (i = 0; i < count; ++i) {
+        n = hashtable_lookup_key(&hashtable, &items[bench_random() % count].key);
+        sink += hashtable_entry(n, Item, node)->val;
+    }
+    bench_report("hashtable_lookup_key hit, presized", count, bench_seconds() - start);
+
+    for (l = 0; l < sizeof(max_loads) / sizeof(max_loads[0]); ++l) {
+        managed_hashtable_init(&table, hash_func, equal_func, node_key_func, NULL, NULL);
+        managed_hashtable_set_load_factors(&table, max_loads[l], max_loads[l] / 4);
+
+        /* Growing from an empty table includes every rehash. */
+        start = bench_seconds();
+        for (i = 0; i < count; ++i) {
+            managed_hashtable_insert(&table, &items[i].key, &items[i].node);
+        }
+        sprintf(name, "insert, max load %lu%%", (unsigned long) max_loads[l]);
+        bench_report(name, count, bench_seconds() - start);
+
+        start = bench_seconds();
+        for (i = 0; i < count; ++i) {
+            n = managed_hashtable_lookup_key(&table, &items[bench_random() % count].key);
+            sink += hashtable_entry(n, Item, node)->val;
+        }
+        sprintf(name, "lookup hit, max load %lu%%", (unsigned long) max_loads[l]);
+        bench_report(name, count, bench_seconds() - start);
+
+        /* Even keys are never inserted. */
+        start = bench_seconds();
+        for (i = 0; i < count; ++i) {
+            key = bench_random() * 2;
+            sink += managed_hashtable_lookup_key(&table, &key) != NULL;
+        }
+        sprintf(name, "lookup miss, max load %lu%%", (unsigned long) max_loads[l]);
+        bench_report(name, count, bench_seconds() - start);
+
+        printf(
+            "    (%lu buckets, %.1f bucket bytes per item)\n",
+            (unsigned long) managed_hashtable_num_buckets(&table),
+            (double) (managed_hashtable_num_buckets(&table) * sizeof(HashTableNode*)) / count
+        );
+
+        /* Removing every item shrinks the table step by step. */
+        start = bench_seconds();
+        for (i = 0; i < count; ++i) {
+            managed_hashtable_remove_key(&table, &items[i].key);
+        }
+        sprintf(name, "remove, max load %lu%%", (unsigned long) max_loads[l]);
+        bench_report(name, count, bench_seconds() - start);
+
+        managed_hashtable_remove_all(&table);
+    }
+
+    printf("(checksum %lu)\n", (unsigned long) sink);
+
+    free(bucket_array);
+    free(items);
+
+    return 0;
+}
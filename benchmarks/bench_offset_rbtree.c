@@ -0,0 +1,164 @@
+/*
+Copyright (c) 2017, Michael J Welsh
+
+Permission to use, copy, modify, and/or distribute this software
+for any purpose with or without fee is hereby granted, provided
+that the above copyright notice and this permission notice appear
+in all copies.
+
+THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL
+WARRANTIES WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE
+AUTHOR BE LIABLE FOR ANY SPECIAL, DIRECT, INDIRECT, OR
+CONSEQUENTIAL DAMAGES OR ANY DAMAGES WHATSOEVER RESULTING FROM
+LOSS OF USE, DATA OR PROFITS, WHETHER IN AN ACTION OF CONTRACT,
+NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF OR IN
+CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <stddef.h>
+#include <string.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+
+#include "benchmarking_framework.h"
+#include "../src/rbtree.h"
+#include "../src/offset_rbtree.h"
+
+/* ========================================================================================================
+ *
+ *                                            BENCHMARK UTILITIES
+ *
+ * ======================================================================================================== */
+
+#define SEGMENT_PATH "bench_offset_rbtree.tmp"
+
+typedef struct Item {
+    size_t key;
+    RBTreeNode node;
+} Item;
+
+typedef struct OffsetItem {
+    size_t key;
+    OffsetRBTreeNode node;
+} OffsetItem;
+
+/* The layout of the shared segment. */
+typedef struct Segment {
+    OffsetRBTree tree;
+    OffsetItem items[1];
+} Segment;
+
+size_t sink;
+
+static int compare_func(const void *key, const RBTreeNode *node) {
+    size_t a = *(const size_t*) key, b = rbtree_entry(node, Item, node)->key;
+
+    return a < b ? -1 : a > b;
+}
+
+static int offset_compare_func(const void *key, const OffsetRBTreeNode *node) {
+    size_t a = *(const size_t*) key, b = offset_rbtree_entry(node, OffsetItem, node)->key;
+
+    return a < b ? -1 : a > b;
+}
+
+/* ========================================================================================================
+ *
+ *                                                BENCHMARKS
+ *
+ * ======================================================================================================== */
+
+int main(int argc, char *argv[]) {
+    size_t count = bench_count(argc, argv, 1000000), size, i, key;
+    size_t *keys = (size_t*) malloc(count * sizeof(size_t));
+    Item *items = (Item*) malloc(count * sizeof(Item));
+    Segment *segment, *other;
+    OffsetRBTreeNode *offset_node;
+    RBTreeNode *node;
+    RBTree rbtree;
+    double start;
+    int fd;
+
+    for (i = 0; i < count; ++i) {
+        keys[i] = bench_random();
+    }
+
+    /* The same segment mapped twice stands in for two processes mapping it at different addresses. */
+    size = offsetof(Segment, items) + count * sizeof(OffsetItem);
+    fd = open(SEGMENT_PATH, O_RDWR | O_CREAT | O_TRUNC, 0600);
+    if (fd < 0 || ftruncate(fd, (off_t) size) != 0) {
+        perror(SEGMENT_PATH);
+        return 1;
+    }
+    segment = (Segment*) mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    other = (Segment*) mmap(NULL, size, PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);
+    remove(SEGMENT_PATH);
+    if (segment == MAP_FAILED || other == MAP_FAILED) {
+        perror("mmap");
+        return 1;
+    }
+
+    start = bench_seconds();
+    rbtree_init(&rbtree, compare_func, NULL, NULL);
+    for (i = 0; i < count; ++i) {
+        items[i].key = keys[i];
+        rbtree_insert(&rbtree, &items[i].key, &items[i].node);
+    }
+    bench_report("rbtree_insert", count, bench_seconds() - start);
+
+    start = bench_seconds();
+    offset_rbtree_init(&segment->tree);
+    for (i = 0; i < count; ++i) {
+        segment->items[i].key = keys[i];
+        offset_rbtree_insert(&segment->tree, offset_compare_func, &keys[i], &segment->items[i].node);
+    }
+    bench_report("offset_rbtree_insert, shared segment", count, bench_seconds() - start);
+
+    start = bench_seconds();
+    for (i = 0; i < count; ++i) {
+        node = rbtree_lookup_key(&rbtree, &keys[bench_random() % count]);
+        sink += rbtree_entry(node, Item, node)->key;
+    }
+    bench_report("rbtree_lookup_key", count, bench_seconds() - start);
+
+    start = bench_seconds();
+    for (i = 0; i < count; ++i) {
+        key = keys[bench_random() % count];
+        offset_node = offset_rbtree_lookup_key(&other->tree, offset_compare_func, &key);
+        sink += offset_rbtree_entry(offset_node, OffsetItem, node)->key;
+    }
+    bench_report("offset_rbtree_lookup_key, second mapping", count, bench_seconds() - start);
+
+    /* Nodes found through the second mapping lie inside it, not inside the first one. */
+    offset_node = offset_rbtree_first(&other->tree);
+    if ((char*) offset_node < (char*) other || (char*) offset_node >= (char*) other + size) {
+        printf("offset_rbtree_first returned a node outside the second mapping\n");
+        return 1;
+    }
+
+    start = bench_seconds();
+    rbtree_for_each(node, &rbtree) {
+        sink += rbtree_entry(node, Item, node)->key;
+    }
+    bench_report("rbtree_for_each", count, bench_seconds() - start);
+
+    start = bench_seconds();
+    offset_rbtree_for_each(offset_node, &other->tree) {
+        sink += offset_rbtree_entry(offset_node, OffsetItem, node)->key;
+    }
+    bench_report("offset_rbtree_for_each, second mapping", count, bench_seconds() - start);
+
+    printf("(checksum %lu)\n", (unsigned long) sink);
+
+    munmap(segment, size);
+    munmap(other, size);
+    free(items);
+    free(keys);
+
+    return 0;
+}
@@ -0,0 +1,294 @@
+/*
+Copyright (c) 2017, Michael J Welsh
+
+Permission to use, copy, modify, and/or distribute this software
+for any purpose with or without fee is hereby granted, provided
+that the above copyright notice and this permission notice appear
+in all copies.
+
+THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL
+WARRANTIES WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE
+AUTHOR BE LIABLE FOR ANY SPECIAL, DIRECT, INDIRECT, OR
+CONSEQUENTIAL DAMAGES OR ANY DAMAGES WHATSOEVER RESULTING FROM
+LOSS OF USE, DATA OR PROFITS, WHETHER IN AN ACTION OF CONTRACT,
+NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF OR IN
+CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+
+/* For PTHREAD_RWLOCK_PREFER_WRITER_NONRECURSIVE_NP: with the default, readers starve the writer. */
+#define _GNU_SOURCE
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <stddef.h>
+#include <pthread.h>
+
+#include "benchmarking_framework.h"
+#include "../src/rbtree.h"
+#include "../src/persistent_rbtree.h"
+
+/* ========================================================================================================
+ *
+ *                                            BENCHMARK UTILITIES
+ *
+ * ======================================================================================================== */
+
+#define NUM_READERS 3
+
+/* The number of consecutive keys a reader query visits, all from the same point in time. */
+#define QUERY_LENGTH 16
+
+typedef struct Item {
+    size_t key;
+    RBTreeNode node;
+} Item;
+
+/* A published version, freed once no reader that may have seen it is still running a query. */
+typedef struct Version {
+    PersistentRBTree tree;
+    size_t retired_epoch;
+    struct Version *next_retired;
+} Version;
+
+typedef struct Reader {
+    pthread_t thread;
+    unsigned long random_state;
+    size_t num_queries;
+    size_t sum;
+    size_t epoch;
+} Reader;
+
+size_t sink;
+
+static size_t count;
+static int done;
+
+static RBTree rbtree;
+static pthread_rwlock_t rbtree_lock;
+
+static Version *current;
+static Version *retired;
+static size_t global_epoch = 1;
+static Reader readers[NUM_READERS];
+
+static int compare_func(const void *key, const RBTreeNode *node) {
+    size_t a = *(const size_t*) key, b = rbtree_entry(node, Item, node)->key;
+
+    return a < b ? -1 : a > b;
+}
+
+static int persistent_compare_func(const void *key, const void *value) {
+    size_t a = *(const size_t*) key, b = ((const Item*) value)->key;
+
+    return a < b ? -1 : a > b;
+}
+
+/* bench_random is not thread-safe, so every reader has its own generator. */
+static size_t reader_random(Reader *reader) {
+    reader->random_state ^= reader->random_state << 13;
+    reader->random_state ^= reader->random_state >> 17;
+    reader->random_state ^= reader->random_state << 5;
+
+    return (size_t) reader->random_state;
+}
+
+static void* run_rbtree_reader(void *arg) {
+    Reader *reader = (Reader*) arg;
+    RBTreeNode *node;
+    size_t key, i;
+
+    while (!__atomic_load_n(&done, __ATOMIC_ACQUIRE)) {
+        key = reader_random(reader) % count;
+
+        pthread_rwlock_rdlock(&rbtree_lock);
+        node = rbtree_lookup_key(&rbtree, &key);
+        for (i = 0; node && i < QUERY_LENGTH; ++i, node = rbtree_next(node)) {
+            reader->sum += rbtree_entry(node, Item, node)->key;
+        }
+        pthread_rwlock_unlock(&rbtree_lock);
+
+        ++reader->num_queries;
+    }
+
+    return NULL;
+}
+
+static void* run_persistent_reader(void *arg) {
+    Reader *reader = (Reader*) arg;
+    PersistentRBTreeIterator iterator;
+    const Version *version;
+    const Item *item;
+    size_t key, i;
+
+    while (!__atomic_load_n(&done, __ATOMIC_ACQUIRE)) {
+        key = reader_random(reader) % count;
+
+        /* Announcing the epoch before loading the version keeps the writer from freeing it. */
+        __atomic_store_n(&reader->epoch, __atomic_load_n(&global_epoch, __ATOMIC_SEQ_CST), __ATOMIC_SEQ_CST);
+        version = __atomic_load_n(&current, __ATOMIC_SEQ_CST);
+
+        persistent_rbtree_iterator_seek(&iterator, &version->tree, &key);
+        for (i = 0; i < QUERY_LENGTH; ++i) {
+            item = (const Item*) persistent_rbtree_iterator_next(&iterator);
+            if (!item) {
+                break;
+            }
+            reader->sum += item->key;
+        }
+
+        __atomic_store_n(&reader->epoch, 0, __ATOMIC_RELEASE);
+        ++reader->num_queries;
+    }
+
+    return NULL;
+}
+
+/* Frees the retired versions no running query can have loaded. */
+static void reclaim(void) {
+    size_t oldest = (size_t) -1, epoch;
+    Version **link = &retired, *version;
+    int i;
+
+    for (i = 0; i < NUM_READERS; ++i) {
+        epoch = __atomic_load_n(&readers[i].epoch, __ATOMIC_SEQ_CST);
+        if (epoch != 0 && epoch < oldest) {
+            oldest = epoch;
+        }
+    }
+
+    while (*link) {
+        version = *link;
+        if (version->retired_epoch <= oldest) {
+            *link = version->next_retired;
+            persistent_rbtree_release(&version->tree);
+            free(version);
+        } else {
+            link = &version->next_retired;
+        }
+    }
+}
+
+/* Makes the tree the current version, and retires the previous one. */
+static void publish(const PersistentRBTree *tree) {
+    Version *version = (Version*) malloc(sizeof(Version)), *old = current;
+
+    version->tree = *tree;
+    __atomic_store_n(&current, version, __ATOMIC_SEQ_CST);
+
+    old->retired_epoch = __atomic_add_fetch(&global_epoch, 1, __ATOMIC_SEQ_CST);
+    old->next_retired = retired;
+    retired = old;
+    reclaim();
+}
+
+static void update_rbtree(Item *item) {
+    pthread_rwlock_wrlock(&rbtree_lock);
+    rbtree_remove(&rbtree, &item->node);
+    pthread_rwlock_unlock(&rbtree_lock);
+
+    pthread_rwlock_wrlock(&rbtree_lock);
+    rbtree_insert(&rbtree, &item->key, &item->node);
+    pthread_rwlock_unlock(&rbtree_lock);
+}
+
+static void update_persistent_rbtree(Item *item) {
+    PersistentRBTree next;
+
+    persistent_rbtree_remove_key(&current->tree, &next, &item->key);
+    publish(&next);
+
+    persistent_rbtree_insert(&current->tree, &next, &item->key, item);
+    publish(&next);
+}
+
+/* Runs the readers while the calling thread removes and reinserts random items, and reports both sides. */
+static void run(
+    const char *name,
+    void* (*reader)(void *arg),
+    void (*update)(Item *item),
+    Item *items,
+    size_t num_updates,
+    size_t num_readers
+) {
+    size_t i, num_queries = 0;
+    char label[100];
+    double start, seconds;
+
+    done = 0;
+    for (i = 0; i < num_readers; ++i) {
+        readers[i].random_state = 2463534242ul + i;
+        readers[i].num_queries = 0;
+        readers[i].epoch = 0;
+        pthread_create(&readers[i].thread, NULL, reader, &readers[i]);
+    }
+
+    start = bench_seconds();
+    for (i = 0; i < num_updates; ++i) {
+        update(&items[bench_random() % count]);
+    }
+    seconds = bench_seconds() - start;
+
+    __atomic_store_n(&done, 1, __ATOMIC_RELEASE);
+    for (i = 0; i < num_readers; ++i) {
+        pthread_join(readers[i].thread, NULL);
+        num_queries += readers[i].num_queries;
+        sink += readers[i].sum;
+    }
+
+    if (num_readers > 0) {
+        sprintf(label, "%s, %lu reader queries of %d keys", name, (unsigned long) num_readers, QUERY_LENGTH);
+        bench_report(label, num_queries, seconds);
+    }
+    sprintf(label, "%s, writer updates, %lu readers", name, (unsigned long) num_readers);
+    bench_report(label, num_updates, seconds);
+}
+
+/* ========================================================================================================
+ *
+ *                                                BENCHMARKS
+ *
+ * ======================================================================================================== */
+
+int main(int argc, char *argv[]) {
+    Item *items;
+    PersistentRBTree tree, next;
+    pthread_rwlockattr_t attr;
+    size_t i;
+
+    count = bench_count(argc, argv, 1000000);
+    items = (Item*) malloc(count * sizeof(Item));
+
+    rbtree_init(&rbtree, compare_func, NULL, NULL);
+    pthread_rwlockattr_init(&attr);
+    pthread_rwlockattr_setkind_np(&attr, PTHREAD_RWLOCK_PREFER_WRITER_NONRECURSIVE_NP);
+    pthread_rwlock_init(&rbtree_lock, &attr);
+    pthread_rwlockattr_destroy(&attr);
+    persistent_rbtree_init(&tree, persistent_compare_func, NULL, NULL, NULL);
+    for (i = 0; i < count; ++i) {
+        items[i].key = i;
+        rbtree_insert(&rbtree, &items[i].key, &items[i].node);
+
+        persistent_rbtree_insert(&tree, &next, &items[i].key, &items[i]);
+        persistent_rbtree_release(&tree);
+        tree = next;
+    }
+    current = (Version*) malloc(sizeof(Version));
+    current->tree = tree;
+
+    /* An update removes and reinserts an item, i.e. two versions of the persistent_rbtree. */
+    run("rbtree + pthread_rwlock", run_rbtree_reader, update_rbtree, items, count / 4, 0);
+    run("persistent_rbtree", run_persistent_reader, update_persistent_rbtree, items, count / 4, 0);
+    run("rbtree + pthread_rwlock", run_rbtree_reader, update_rbtree, items, count / 4, NUM_READERS);
+    run("persistent_rbtree", run_persistent_reader, update_persistent_rbtree, items, count / 4, NUM_READERS);
+
+    printf("(checksum %lu)\n", (unsigned long) sink);
+
+    reclaim();
+    persistent_rbtree_release(&current->tree);
+    free(current);
+    pthread_rwlock_destroy(&rbtree_lock);
+    free(items);
+
+    return 0;
+}
@@ -0,0 +1,246 @@
+/*
+Copyright (c) 2017, Michael J Welsh
+
+Permission to use, copy, modify, and/or distribute this software
+for any purpose with or without fee is hereby granted, provided
+that the above copyright notice and this permission notice appear
+in all copies.
+
+THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL
+WARRANTIES WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE
+AUTHOR BE LIABLE FOR ANY SPECIAL, DIRECT, INDIRECT, OR
+CONSEQUENTIAL DAMAGES OR ANY DAMAGES WHATSOEVER RESULTING FROM
+LOSS OF USE, DATA OR PROFITS, WHETHER IN AN ACTION OF CONTRACT,
+NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF OR IN
+CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <stddef.h>
+#include <string.h>
+#include <pthread.h>
+
+#include "benchmarking_framework.h"
+#include "../src/pool.h"
+#include "../src/hashtable.h"
+
+/* ========================================================================================================
+ *
+ *                                            BENCHMARK UTILITIES
+ *
+ * ======================================================================================================== */
+
+#define CHUNK_SIZE (1024 * 1024)
+#define WORKING_SET 65536
+#define CACHE_CAPACITY 64
+
+typedef struct Item {
+    size_t key;
+    size_t val;
+    HashTableNode node;
+} Item;
+
+typedef enum Method {
+    METHOD_MALLOC,
+    METHOD_POOL,
+    METHOD_POOL_CACHE
+} Method;
+
+static const char *method_names[] = { "malloc/free", "pool_alloc/pool_free", "pool_cache (mutex)" };
+
+size_t sink;
+
+static pthread_mutex_t mutex = PTHREAD_MUTEX_INITIALIZER;
+
+static void lock(void *lock_data) {
+    pthread_mutex_lock((pthread_mutex_t*) lock_data);
+}
+
+static void unlock(void *lock_data) {
+    pthread_mutex_unlock((pthread_mutex_t*) lock_data);
+}
+
+static size_t hash_func(const void *key) {
+    return *(const size_t*) key;
+}
+
+static int equal_func(const void *key, const HashTableNode *node) {
+    return *(const size_t*) key == hashtable_entry(node, Item, node)->key;
+}
+
+static Item* alloc_item(Method method, Pool *pool, PoolCache *cache) {
+    switch (method) {
+        case METHOD_MALLOC:
+            return (Item*) malloc(sizeof(Item));
+        case METHOD_POOL:
+            return (Item*) pool_alloc(pool);
+        default:
+            return (Item*) pool_cache_alloc(cache);
+    }
+}
+
+static void free_item(Method method, Pool *pool, PoolCache *cache, Item *item) {
+    switch (method) {
+        case METHOD_MALLOC:
+            free(item);
+            break;
+        case METHOD_POOL:
+            pool_free(pool, item);
+            break;
+        default:
+            pool_cache_free(cache, item);
+    }
+}
+
+/* Allocates count objects, then frees them one by one, or all at once with pool_reset. */
+static void bench_alloc_free(size_t count) {
+    Item **items = (Item**) malloc(count * sizeof(Item*));
+    char name[64];
+    Pool pool;
+    PoolCache cache;
+    size_t i;
+    double start;
+    int method;
+
+    pool_init(&pool, sizeof(Item), CHUNK_SIZE, NULL, NULL, NULL);
+
+    for (method = METHOD_MALLOC; method <= METHOD_POOL_CACHE; ++method) {
+        if (method == METHOD_POOL_CACHE) {
+            pool_set_lock(&pool, lock, unlock, &mutex);
+        }
+        pool_cache_init(&cache, &pool, CACHE_CAPACITY);
+
+        start = bench_seconds();
+        for (i = 0; i < count; ++i) {
+            items[i] = alloc_item((Method) method, &pool, &cache);
+            items[i]->key = i;
+        }
+        for (i = 0; i < count; ++i) {
+            free_item((Method) method, &pool, &cache, items[i]);
+        }
+        pool_cache_flush(&cache);
+        sprintf(name, "alloc + free, %s", method_names[method]);
+        bench_report(name, count, bench_seconds() - start);
+    }
+
+    pool_set_lock(&pool, NULL, NULL, NULL);
+    start = bench_seconds();
+    for (i = 0; i < count; ++i) {
+        items[i] = (Item*) pool_alloc(&pool);
+        items[i]->key = i;
+    }
+    pool_reset(&pool);
+    bench_report("alloc + free, pool_alloc/pool_reset", count, bench_seconds() - start);
+
+    pool_release(&pool);
+    free(items);
+}
+
+/* Keeps WORKING_SET objects alive, replacing a random one count times. */
+static void bench_churn(size_t count) {
+    static Item *items[WORKING_SET];
+    char name[64];
+    Pool pool;
+    PoolCache cache;
+    size_t i;
+    double start;
+    int method;
+
+    pool_init(&pool, sizeof(Item), CHUNK_SIZE, NULL, NULL, NULL);
+
+    for (method = METHOD_MALLOC; method <= METHOD_POOL_CACHE; ++method) {
+        if (method == METHOD_POOL_CACHE) {
+            pool_set_lock(&pool, lock, unlock, &mutex);
+        }
+        pool_cache_init(&cache, &pool, CACHE_CAPACITY);
+
+        for (i = 0; i < WORKING_SET; ++i) {
+            items[i] = alloc_item((Method) method, &pool, &cache);
+        }
+
+        start = bench_seconds();
+        for (i = 0; i < count; ++i) {
+            size_t j = bench_random() % WORKING_SET;
+            free_item((Method) method, &pool, &cache, items[j]);
+            items[j] = alloc_item((Method) method, &pool, &cache);
+            items[j]->key = i;
+        }
+        sprintf(name, "churn, %s", method_names[method]);
+        bench_report(name, count, bench_seconds() - start);
+
+        for (i = 0; i < WORKING_SET; ++i) {
+            free_item((Method) method, &pool, &cache, items[i]);
+        }
+        pool_cache_flush(&cache);
+    }
+
+    pool_release(&pool);
+}
+
+/* Allocates count objects and inserts them into a HashTable, then looks every one of them up. */
+static void bench_hashtable_insert(size_t count) {
+    HashTableNode **bucket_array = (HashTableNode**) malloc(count * sizeof(HashTableNode*));
+    Item **items = (Item**) malloc(count * sizeof(Item*));
+    HashTable hashtable;
+    char name[64];
+    Pool pool;
+    size_t i, key;
+    double start;
+    int method;
+
+    pool_init(&pool, sizeof(Item), CHUNK_SIZE, NULL, NULL, NULL);
+
+    for (method = METHOD_MALLOC; method <= METHOD_POOL; ++method) {
+        hashtable_init(&hashtable, bucket_array, count, hash_func, equal_func, NULL, NULL);
+
+        start = bench_seconds();
+        for (i = 0; i < count; ++i) {
+            items[i] = alloc_item((Method) method, &pool, NULL);
+            items[i]->key = i * 2654435761UL;
+            items[i]->val = i;
+            hashtable_insert(&hashtable, &items[i]->key, &items[i]->node);
+        }
+        sprintf(name, "alloc + hashtable_insert, %s", method_names[method]);
+        bench_report(name, count, bench_seconds() - start);
+
+        start = bench_seconds();
+        for (i = 0; i < count; ++i) {
+            key = (bench_random() % count) * 2654435761UL;
+            sink += hashtable_entry(hashtable_lookup_key(&hashtable, &key), Item, node)->val;
+        }
+        sprintf(name, "hashtable_lookup_key, %s", method_names[method]);
+        bench_report(name, count, bench_seconds() - start);
+
+        if (method == METHOD_MALLOC) {
+            for (i = 0; i < count; ++i) {
+                free(items[i]);
+            }
+        } else {
+            pool_reset(&pool);
+        }
+    }
+
+    pool_release(&pool);
+    free(items);
+    free(bucket_array);
+}
+
+/* ========================================================================================================
+ *
+ *                                                BENCHMARKS
+ *
+ * ======================================================================================================== */
+
+int main(int argc, char *argv[]) {
+    size_t count = bench_count(argc, argv, 1000000);
+
+    bench_alloc_free(count);
+    bench_churn(count);
+    bench_hashtable_insert(count);
+
+    printf("(checksum %lu)\n", (unsigned long) sink);
+
+    return 0;
+}
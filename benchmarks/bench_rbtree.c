@@ -0,0 +1,110 @@
+/*
+Copyright (c) 2017, Michael J Welsh
+
+Permission to use, copy, modify, and/or distribute this software
+for any purpose with or without fee is hereby granted, provided
+that the above copyright notice and this permission notice appear
+in all copies.
+
+THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL
+WARRANTIES WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE
+AUTHOR BE LIABLE FOR ANY SPECIAL, DIRECT, INDIRECT, OR
+CONSEQUENTIAL DAMAGES OR ANY DAMAGES WHATSOEVER RESULTING FROM
+LOSS OF USE, DATA OR PROFITS, WHETHER IN AN ACTION OF CONTRACT,
+NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF OR IN
+CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <stddef.h>
+
+#include "benchmarking_framework.h"
+#include "../src/rbtree.h"
+
+/* ========================================================================================================
+ *
+ *                                            BENCHMARK UTILITIES
+ *
+ * ======================================================================================================== */
+
+typedef struct Item {
+    size_t key;
+    RBTreeNode node;
+} Item;
+
+size_t sink;
+
+static int compare_func(const void *key, const RBTreeNode *node) {
+    size_t a = *(const size_t*) key, b = rbtree_entry(node, Item, node)->key;
+
+    return a < b ? -1 : a > b;
+}
+
+/* Fills the rbtree with every item, bottom-up, so that both removals start from the same tree shape. */
+static void fill(RBTree *rbtree, Item *items, size_t count) {
+    size_t i;
+
+    rbtree_init(rbtree, compare_func, NULL, NULL);
+    for (i = 0; i < count; ++i) {
+        rbtree_insert(rbtree, &items[i].key, &items[i].node);
+    }
+}
+
+/* ========================================================================================================
+ *
+ *                                                BENCHMARKS
+ *
+ * ======================================================================================================== */
+
+int main(int argc, char *argv[]) {
+    size_t count = bench_count(argc, argv, 1000000), i;
+    size_t *keys = (size_t*) malloc(count * sizeof(size_t));
+    Item *items = (Item*) malloc(count * sizeof(Item));
+    RBTree rbtree;
+    double start;
+
+    /* Removals happen in a different random order than insertions. */
+    for (i = 0; i < count; ++i) {
+        items[i].key = bench_random();
+        keys[i] = items[bench_random() % count].key;
+    }
+
+    start = bench_seconds();
+    rbtree_init(&rbtree, compare_func, NULL, NULL);
+    for (i = 0; i < count; ++i) {
+        rbtree_insert(&rbtree, &items[i].key, &items[i].node);
+    }
+    bench_report("rbtree_insert", count, bench_seconds() - start);
+
+    start = bench_seconds();
+    rbtree_init(&rbtree, compare_func, NULL, NULL);
+    for (i = 0; i < count; ++i) {
+        rbtree_insert_top_down(&rbtree, &items[i].key, &items[i].node);
+    }
+    bench_report("rbtree_insert_top_down", count, bench_seconds() - start);
+
+    fill(&rbtree, items, count);
+    start = bench_seconds();
+    for (i = 0; i < count; ++i) {
+        rbtree_remove_key(&rbtree, &keys[i]);
+    }
+    bench_report("rbtree_remove_key", count, bench_seconds() - start);
+    sink += rbtree_size(&rbtree);
+
+    fill(&rbtree, items, count);
+    start = bench_seconds();
+    for (i = 0; i < count; ++i) {
+        sink += rbtree_remove_key_top_down(&rbtree, &keys[i]) != NULL;
+    }
+    bench_report("rbtree_remove_key_top_down", count, bench_seconds() - start);
+    sink += rbtree_size(&rbtree);
+
+    printf("(checksum %lu)\n", (unsigned long) sink);
+
+    free(items);
+    free(keys);
+
+    return 0;
+}
@@ -0,0 +1,186 @@
+/*
+Copyright (c) 2017, Michael J Welsh
+
+Permission to use, copy, modify, and/or distribute this software
+for any purpose with or without fee is hereby granted, provided
+that the above copyright notice and this permission notice appear
+in all copies.
+
+THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL
+WARRANTIES WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE
+AUTHOR BE LIABLE FOR ANY SPECIAL, DIRECT, INDIRECT, OR
+CONSEQUENTIAL DAMAGES OR ANY DAMAGES WHATSOEVER RESULTING FROM
+LOSS OF USE, DATA OR PROFITS, WHETHER IN AN ACTION OF CONTRACT,
+NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF OR IN
+CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <stddef.h>
+#include <pthread.h>
+
+#include "benchmarking_framework.h"
+#include "../src/rbtree.h"
+#include "../src/seqlock_rbtree.h"
+
+/* ========================================================================================================
+ *
+ *                                            BENCHMARK UTILITIES
+ *
+ * ======================================================================================================== */
+
+#define MAX_THREADS 8
+
+typedef struct Item {
+    size_t key;
+    size_t val;
+    RBTreeNode node;
+} Item;
+
+typedef struct Worker {
+    pthread_t thread;
+    unsigned long random_state;
+    size_t num_ops;
+    size_t sum;
+} Worker;
+
+size_t sink;
+
+static size_t count;
+static Item *items;
+
+static RBTree rbtree;
+static pthread_rwlock_t rbtree_lock = PTHREAD_RWLOCK_INITIALIZER;
+static SeqlockRBTree seqlock_rbtree;
+
+static Worker workers[MAX_THREADS];
+
+static int compare_func(const void *key, const RBTreeNode *node) {
+    size_t a = *(const size_t*) key, b = rbtree_entry(node, Item, node)->key;
+
+    return a < b ? -1 : a > b;
+}
+
+/* bench_random is not thread-safe, so every worker has its own generator. */
+static size_t worker_random(Worker *worker) {
+    worker->random_state ^= worker->random_state << 13;
+    worker->random_state ^= worker->random_state >> 17;
+    worker->random_state ^= worker->random_state << 5;
+
+    return (size_t) worker->random_state;
+}
+
+/* 99% lookups, and 1% removals and reinsertions of the same item, which rebalance the tree. */
+static void* run_rbtree_worker(void *arg) {
+    Worker *worker = (Worker*) arg;
+    RBTreeNode *node;
+    size_t i, r, key;
+
+    for (i = 0; i < worker->num_ops; ++i) {
+        r = worker_random(worker);
+        key = (r >> 8) % count;
+
+        if (r % 100 == 0) {
+            pthread_rwlock_wrlock(&rbtree_lock);
+            rbtree_remove(&rbtree, &items[key].node);
+            rbtree_insert(&rbtree, &items[key].key, &items[key].node);
+            pthread_rwlock_unlock(&rbtree_lock);
+        } else {
+            pthread_rwlock_rdlock(&rbtree_lock);
+            node = rbtree_lookup_key(&rbtree, &key);
+            worker->sum += rbtree_entry(node, Item, node)->val;
+            pthread_rwlock_unlock(&rbtree_lock);
+        }
+    }
+
+    return NULL;
+}
+
+/* The same mix as run_rbtree_worker, with speculative readers. */
+static void* run_seqlock_rbtree_worker(void *arg) {
+    Worker *worker = (Worker*) arg;
+    const RBTreeNode *node;
+    size_t i, r, key, val, sequence;
+
+    for (i = 0; i < worker->num_ops; ++i) {
+        r = worker_random(worker);
+        key = (r >> 8) % count;
+
+        if (r % 100 == 0) {
+            seqlock_rbtree_write_begin(&seqlock_rbtree);
+            rbtree_remove(seqlock_rbtree_rbtree(&seqlock_rbtree), &items[key].node);
+            rbtree_insert(seqlock_rbtree_rbtree(&seqlock_rbtree), &items[key].key, &items[key].node);
+            seqlock_rbtree_write_end(&seqlock_rbtree);
+        } else {
+            do {
+                sequence = seqlock_rbtree_read_begin(&seqlock_rbtree);
+                node = seqlock_rbtree_find(&seqlock_rbtree, &key);
+                val = node ? rbtree_entry(node, Item, node)->val : 0;
+            } while (seqlock_rbtree_read_retry(&seqlock_rbtree, sequence));
+            worker->sum += val;
+        }
+    }
+
+    return NULL;
+}
+
+/* Splits count operations between the threads. */
+static void run(const char *name, void* (*worker)(void *arg), size_t num_threads) {
+    size_t i;
+    char label[100];
+    double start, seconds;
+
+    start = bench_seconds();
+    for (i = 0; i < num_threads; ++i) {
+        workers[i].random_state = 2463534242ul + i;
+        workers[i].num_ops = count / num_threads;
+        workers[i].sum = 0;
+        pthread_create(&workers[i].thread, NULL, worker, &workers[i]);
+    }
+    for (i = 0; i < num_threads; ++i) {
+        pthread_join(workers[i].thread, NULL);
+        sink += workers[i].sum;
+    }
+    seconds = bench_seconds() - start;
+
+    sprintf(label, "%s, %lu threads", name, (unsigned long) num_threads);
+    bench_report(label, count / num_threads * num_threads, seconds);
+}
+
+/* ========================================================================================================
+ *
+ *                                                BENCHMARKS
+ *
+ * ======================================================================================================== */
+
+int main(int argc, char *argv[]) {
+    size_t i, num_threads;
+
+    count = bench_count(argc, argv, 1000000);
+    items = (Item*) malloc(count * sizeof(Item));
+
+    /* Both trees hold every key, so an item is always in the tree its workers update. */
+    for (num_threads = 1; num_threads <= MAX_THREADS; num_threads *= 2) {
+        rbtree_init(&rbtree, compare_func, NULL, NULL);
+        for (i = 0; i < count; ++i) {
+            items[i].key = i;
+            items[i].val = bench_random();
+            rbtree_insert(&rbtree, &items[i].key, &items[i].node);
+        }
+        run("rbtree + pthread_rwlock, 99% lookups", run_rbtree_worker, num_threads);
+
+        seqlock_rbtree_init(&seqlock_rbtree, compare_func, NULL, NULL);
+        for (i = 0; i < count; ++i) {
+            seqlock_rbtree_insert(&seqlock_rbtree, &items[i].key, &items[i].node);
+        }
+        run("seqlock_rbtree, 99% lookups", run_seqlock_rbtree_worker, num_threads);
+    }
+
+    printf("(checksum %lu)\n", (unsigned long) sink);
+
+    free(items);
+
+    return 0;
+}
@@ -0,0 +1,203 @@
+/*
+Copyright (c) 2017, Michael J Welsh
+
+Permission to use, copy, modify, and/or distribute this software
+for any purpose with or without fee is hereby granted, provided
+that the above copyright notice and this permission notice appear
+in all copies.
+
+THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL
+WARRANTIES WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE
+AUTHOR BE LIABLE FOR ANY SPECIAL, DIRECT, INDIRECT, OR
+CONSEQUENTIAL DAMAGES OR ANY DAMAGES WHATSOEVER RESULTING FROM
+LOSS OF USE, DATA OR PROFITS, WHETHER IN AN ACTION OF CONTRACT,
+NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF OR IN
+CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <stddef.h>
+#include <pthread.h>
+
+#include "benchmarking_framework.h"
+#include "../src/rbtree.h"
+#include "../src/skiplist.h"
+
+/* ========================================================================================================
+ *
+ *                                            BENCHMARK UTILITIES
+ *
+ * ======================================================================================================== */
+
+#define MAX_THREADS 8
+
+/* The number of consecutive keys a range scan visits. */
+#define SCAN_LENGTH 16
+
+/* Removed items are never reused, so that no thread can still be reading an item that is reinserted. */
+typedef struct Item {
+    size_t key;
+    RBTreeNode rbtree_node;
+    SkipListNode skiplist_node;
+} Item;
+
+typedef struct Worker {
+    pthread_t thread;
+    unsigned long random_state;
+    Item *items;
+    size_t num_ops;
+    size_t sum;
+} Worker;
+
+size_t sink;
+
+static size_t count;
+
+static RBTree rbtree;
+static pthread_mutex_t rbtree_lock = PTHREAD_MUTEX_INITIALIZER;
+static SkipList list;
+
+static Worker workers[MAX_THREADS];
+
+static int compare_func(const void *key, const RBTreeNode *node) {
+    size_t a = *(const size_t*) key, b = rbtree_entry(node, Item, rbtree_node)->key;
+
+    return a < b ? -1 : a > b;
+}
+
+static int skiplist_compare_func(const void *key, const SkipListNode *node) {
+    size_t a = *(const size_t*) key, b = skiplist_entry(node, Item, skiplist_node)->key;
+
+    return a < b ? -1 : a > b;
+}
+
+/* bench_random is not thread-safe, so every worker has its own generator. */
+static size_t worker_random(Worker *worker) {
+    worker->random_state ^= worker->random_state << 13;
+    worker->random_state ^= worker->random_state >> 17;
+    worker->random_state ^= worker->random_state << 5;
+
+    return (size_t) worker->random_state;
+}
+
+/* 80% range scans, 10% inserts and 10% removes of random keys, under a single mutex. */
+static void* run_rbtree_worker(void *arg) {
+    Worker *worker = (Worker*) arg;
+    RBTreeNode *node;
+    size_t i, j, r, key;
+
+    for (i = 0; i < worker->num_ops; ++i) {
+        r = worker_random(worker);
+        key = (r >> 4) % count;
+
+        pthread_mutex_lock(&rbtree_lock);
+        if (r % 10 == 0) {
+            worker->items[i].key = key;
+            rbtree_insert(&rbtree, &worker->items[i].key, &worker->items[i].rbtree_node);
+        } else if (r % 10 == 1) {
+            rbtree_remove_key(&rbtree, &key);
+        } else {
+            node = rbtree_lookup_key(&rbtree, &key);
+            for (j = 0; node && j < SCAN_LENGTH; ++j, node = rbtree_next(node)) {
+                worker->sum += rbtree_entry(node, Item, rbtree_node)->key;
+            }
+        }
+        pthread_mutex_unlock(&rbtree_lock);
+    }
+
+    return NULL;
+}
+
+/* The same mix as run_rbtree_worker, without any lock. */
+static void* run_skiplist_worker(void *arg) {
+    Worker *worker = (Worker*) arg;
+    SkipListNode *node;
+    size_t i, j, r, key;
+
+    for (i = 0; i < worker->num_ops; ++i) {
+        r = worker_random(worker);
+        key = (r >> 4) % count;
+
+        if (r % 10 == 0) {
+            worker->items[i].key = key;
+            skiplist_insert(&list, &worker->items[i].key, &worker->items[i].skiplist_node);
+        } else if (r % 10 == 1) {
+            skiplist_remove_key(&list, &key);
+        } else {
+            node = skiplist_lookup_key(&list, &key);
+            for (j = 0; node && j < SCAN_LENGTH; ++j, node = skiplist_next(node)) {
+                worker->sum += skiplist_entry(node, Item, skiplist_node)->key;
+            }
+        }
+    }
+
+    return NULL;
+}
+
+/* Splits count operations between the threads, each with its own unused items to insert. */
+static void run(const char *name, void* (*worker)(void *arg), Item *items, size_t num_threads) {
+    size_t i;
+    char label[100];
+    double start, seconds;
+
+    start = bench_seconds();
+    for (i = 0; i < num_threads; ++i) {
+        workers[i].random_state = 2463534242ul + i;
+        workers[i].items = items + i * (count / num_threads);
+        workers[i].num_ops = count / num_threads;
+        workers[i].sum = 0;
+        pthread_create(&workers[i].thread, NULL, worker, &workers[i]);
+    }
+    for (i = 0; i < num_threads; ++i) {
+        pthread_join(workers[i].thread, NULL);
+        sink += workers[i].sum;
+    }
+    seconds = bench_seconds() - start;
+
+    sprintf(label, "%s, %lu threads", name, (unsigned long) num_threads);
+    bench_report(label, count / num_threads * num_threads, seconds);
+}
+
+/* Fills both structures with the same random keys, about 40% of the key range. */
+static void fill(Item *items) {
+    size_t i;
+
+    rbtree_init(&rbtree, compare_func, NULL, NULL);
+    skiplist_init(&list, skiplist_compare_func, NULL, NULL);
+    for (i = 0; i < count / 2; ++i) {
+        items[i].key = bench_random() % count;
+        rbtree_insert(&rbtree, &items[i].key, &items[i].rbtree_node);
+        skiplist_insert(&list, &items[i].key, &items[i].skiplist_node);
+    }
+}
+
+/* ========================================================================================================
+ *
+ *                                                BENCHMARKS
+ *
+ * ======================================================================================================== */
+
+int main(int argc, char *argv[]) {
+    Item *initial_items, *items;
+    size_t num_threads;
+
+    count = bench_count(argc, argv, 200000);
+    initial_items = (Item*) malloc(count / 2 * sizeof(Item));
+    items = (Item*) malloc(count * sizeof(Item));
+
+    /* Every configuration refills both structures, and runs count operations in total. */
+    for (num_threads = 1; num_threads <= MAX_THREADS; num_threads *= 2) {
+        fill(initial_items);
+        run("rbtree + pthread_mutex, 80% scans", run_rbtree_worker, items, num_threads);
+        run("skiplist, 80% scans", run_skiplist_worker, items, num_threads);
+    }
+
+    printf("(checksum %lu)\n", (unsigned long) sink);
+
+    free(items);
+    free(initial_items);
+
+    return 0;
+}
@@ -0,0 +1,139 @@
+/*
+Copyright (c) 2017, Michael J Welsh
+
+Permission to use, copy, modify, and/or distribute this software
+for any purpose with or without fee is hereby granted, provided
+that the above copyright notice and this permission notice appear
+in all copies.
+
+THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL
+WARRANTIES WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE
+AUTHOR BE LIABLE FOR ANY SPECIAL, DIRECT, INDIRECT, OR
+CONSEQUENTIAL DAMAGES OR ANY DAMAGES WHATSOEVER RESULTING FROM
+LOSS OF USE, DATA OR PROFITS, WHETHER IN AN ACTION OF CONTRACT,
+NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF OR IN
+CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <stddef.h>
+
+#include "benchmarking_framework.h"
+#include "../src/rbtree.h"
+#include "../src/static_index.h"
+
+/* ========================================================================================================
+ *
+ *                                            BENCHMARK UTILITIES
+ *
+ * ======================================================================================================== */
+
+typedef struct Item {
+    size_t key;
+    RBTreeNode node;
+} Item;
+
+size_t sink;
+
+static int compare_func(const void *key, const RBTreeNode *node) {
+    size_t a = *(const size_t*) key, b = rbtree_entry(node, Item, node)->key;
+
+    return a < b ? -1 : a > b;
+}
+
+/* A plain binary search over the sorted keys, for comparison. */
+static size_t sorted_lower_bound(const size_t *sorted, size_t count, size_t key) {
+    size_t low = 0, high = count;
+
+    while (low < high) {
+        size_t mid = low + (high - low) / 2;
+
+        if (sorted[mid] < key) {
+            low = mid + 1;
+        } else {
+            high = mid;
+        }
+    }
+
+    return low;
+}
+
+/* ========================================================================================================
+ *
+ *                                                BENCHMARKS
+ *
+ * ======================================================================================================== */
+
+int main(int argc, char *argv[]) {
+    size_t count = bench_count(argc, argv, 4000000), i;
+    size_t *keys = (size_t*) malloc(count * sizeof(size_t));
+    size_t *sorted = (size_t*) malloc(count * sizeof(size_t));
+    Item *items = (Item*) malloc(count * sizeof(Item));
+    void **value_array = (void**) malloc((count + 1) * sizeof(void*));
+    StaticIndexKey *key_array;
+    StaticIndex index;
+    RBTreeNode *node;
+    RBTree rbtree;
+    double start;
+
+    if (posix_memalign((void**) &key_array, 64, (count + 1) * sizeof(StaticIndexKey)) != 0) {
+        perror("posix_memalign");
+        return 1;
+    }
+
+    rbtree_init(&rbtree, compare_func, NULL, NULL);
+    for (i = 0; i < count; ++i) {
+        items[i].key = bench_random();
+        rbtree_insert(&rbtree, &items[i].key, &items[i].node);
+    }
+    for (i = 0; i < count; ++i) {
+        keys[i] = items[bench_random() % count].key;
+    }
+
+    start = bench_seconds();
+    static_index_init(&index, key_array, value_array, rbtree_size(&rbtree));
+    i = 0;
+    rbtree_for_each(node, &rbtree) {
+        sorted[i++] = rbtree_entry(node, Item, node)->key;
+        static_index_append(&index, rbtree_entry(node, Item, node)->key, node);
+    }
+    bench_report("static_index_append, from rbtree_for_each", rbtree_size(&rbtree), bench_seconds() - start);
+
+    start = bench_seconds();
+    for (i = 0; i < count; ++i) {
+        node = rbtree_lookup_key(&rbtree, &keys[i]);
+        sink += rbtree_entry(node, Item, node)->key;
+    }
+    bench_report("rbtree_lookup_key", count, bench_seconds() - start);
+
+    start = bench_seconds();
+    for (i = 0; i < count; ++i) {
+        sink += sorted[sorted_lower_bound(sorted, rbtree_size(&rbtree), keys[i])];
+    }
+    bench_report("binary search, sorted array", count, bench_seconds() - start);
+
+    start = bench_seconds();
+    for (i = 0; i < count; ++i) {
+        node = (RBTreeNode*) static_index_lookup_key(&index, keys[i]);
+        sink += rbtree_entry(node, Item, node)->key;
+    }
+    bench_report("static_index_lookup_key", count, bench_seconds() - start);
+
+    start = bench_seconds();
+    for (i = 0; i < count; ++i) {
+        sink += static_index_lower_bound(&index, keys[i]);
+    }
+    bench_report("static_index_lower_bound", count, bench_seconds() - start);
+
+    printf("(checksum %lu)\n", (unsigned long) sink);
+
+    free(key_array);
+    free(value_array);
+    free(items);
+    free(sorted);
+    free(keys);
+
+    return 0;
+}
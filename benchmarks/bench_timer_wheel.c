@@ -0,0 +1,205 @@
+/*
+Copyright (c) 2017, Michael J Welsh
+
+Permission to use, copy, modify, and/or distribute this software
+for any purpose with or without fee is hereby granted, provided
+that the above copyright notice and this permission notice appear
+in all copies.
+
+THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL
+WARRANTIES WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE
+AUTHOR BE LIABLE FOR ANY SPECIAL, DIRECT, INDIRECT, OR
+CONSEQUENTIAL DAMAGES OR ANY DAMAGES WHATSOEVER RESULTING FROM
+LOSS OF USE, DATA OR PROFITS, WHETHER IN AN ACTION OF CONTRACT,
+NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF OR IN
+CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <stddef.h>
+
+#include "benchmarking_framework.h"
+#include "../src/list.h"
+#include "../src/rbtree.h"
+#include "../src/timer_wheel.h"
+
+/* ========================================================================================================
+ *
+ *                                            BENCHMARK UTILITIES
+ *
+ * ======================================================================================================== */
+
+/* Timeouts of up to about a minute, with a tick per millisecond. */
+#define MAX_DELAY 65536
+
+/* The number of timers re-armed between two ticks, as when every packet pushes back its timeout. */
+#define OPS_PER_TICK 100
+
+typedef struct WheelTimer {
+    TimerWheelNode node;
+} WheelTimer;
+
+typedef struct RBTreeTimer {
+    unsigned long expires;
+    int armed;
+    RBTreeNode node;
+} RBTreeTimer;
+
+size_t sink;
+
+static size_t count;
+static size_t *order;
+static unsigned long *delays;
+
+/* Timers with equal expiry ticks are ordered by address, since a RBTree replaces equal keys. */
+static int compare_func(const void *key, const RBTreeNode *node) {
+    const RBTreeTimer *a = (const RBTreeTimer*) key, *b = rbtree_entry(node, RBTreeTimer, node);
+
+    if (a->expires != b->expires) {
+        return a->expires < b->expires ? -1 : 1;
+    }
+
+    return a < b ? -1 : a > b;
+}
+
+static void rbtree_arm(RBTree *rbtree, RBTreeTimer *timer, unsigned long expires) {
+    timer->expires = expires;
+    timer->armed = 1;
+    rbtree_insert(rbtree, timer, &timer->node);
+}
+
+static void rbtree_cancel(RBTree *rbtree, RBTreeTimer *timer) {
+    rbtree_remove(rbtree, &timer->node);
+    timer->armed = 0;
+}
+
+/* Removes the timers expiring at or before @ref now, and arms each of them again with the next delay. */
+static void rbtree_tick(RBTree *rbtree, unsigned long now, size_t *next_delay) {
+    RBTreeNode *node;
+    RBTreeTimer *timer;
+
+    while ((node = rbtree_first(rbtree)) && (timer = rbtree_entry(node, RBTreeTimer, node))->expires <= now) {
+        rbtree_cancel(rbtree, timer);
+        rbtree_arm(rbtree, timer, now + delays[*next_delay % count]);
+        ++*next_delay;
+        ++sink;
+    }
+}
+
+/* Pops the timers off @ref expired, and arms each of them again with the next delay. */
+static void wheel_rearm(TimerWheel *wheel, List *expired, size_t *next_delay) {
+    ListNode *n;
+
+    while ((n = list_front(expired))) {
+        list_remove_front(expired);
+        timer_wheel_arm(
+            wheel, list_entry(n, TimerWheelNode, node), timer_wheel_now(wheel) + delays[*next_delay % count]
+        );
+        ++*next_delay;
+        ++sink;
+    }
+}
+
+/* ========================================================================================================
+ *
+ *                                                BENCHMARKS
+ *
+ * ======================================================================================================== */
+
+int main(int argc, char *argv[]) {
+    WheelTimer *wheel_timers;
+    RBTreeTimer *rbtree_timers;
+    TimerWheel *wheel;
+    RBTree rbtree;
+    RBTreeNode *node;
+    List expired;
+    unsigned long now;
+    size_t i, next_delay;
+    double start;
+
+    count = bench_count(argc, argv, 10000000);
+    order = (size_t*) malloc(count * sizeof(size_t));
+    delays = (unsigned long*) malloc(count * sizeof(unsigned long));
+    for (i = 0; i < count; ++i) {
+        order[i] = bench_random() % count;
+        delays[i] = bench_random() % MAX_DELAY + 1;
+    }
+
+    /* A TimerWheel holds a List per slot, too many for the stack. */
+    wheel_timers = (WheelTimer*) malloc(count * sizeof(WheelTimer));
+    wheel = (TimerWheel*) malloc(sizeof(TimerWheel));
+    list_init(&expired);
+
+    start = bench_seconds();
+    timer_wheel_init(wheel, 0);
+    for (i = 0; i < count; ++i) {
+        timer_wheel_arm(wheel, &wheel_timers[i].node, delays[i]);
+    }
+    bench_report("timer_wheel_arm", count, bench_seconds() - start);
+
+    start = bench_seconds();
+    for (i = 0, next_delay = 0; i < count; ++i) {
+        TimerWheelNode *timer = &wheel_timers[order[i]].node;
+
+        if (timer_wheel_armed(timer)) {
+            timer_wheel_cancel(wheel, timer);
+        }
+        timer_wheel_arm(wheel, timer, timer_wheel_now(wheel) + delays[i]);
+
+        if (i % OPS_PER_TICK == OPS_PER_TICK - 1) {
+            timer_wheel_tick(wheel, &expired);
+            wheel_rearm(wheel, &expired, &next_delay);
+        }
+    }
+    bench_report("timer_wheel_cancel + timer_wheel_arm, ticking", count, bench_seconds() - start);
+
+    now = timer_wheel_now(wheel);
+    start = bench_seconds();
+    timer_wheel_advance(wheel, now + MAX_DELAY, &expired);
+    sink += list_size(&expired);
+    bench_report("timer_wheel_advance, expiring all", count, bench_seconds() - start);
+
+    free(wheel);
+    free(wheel_timers);
+
+    rbtree_timers = (RBTreeTimer*) malloc(count * sizeof(RBTreeTimer));
+
+    start = bench_seconds();
+    rbtree_init(&rbtree, compare_func, NULL, NULL);
+    for (i = 0; i < count; ++i) {
+        rbtree_arm(&rbtree, &rbtree_timers[i], delays[i]);
+    }
+    bench_report("rbtree_insert", count, bench_seconds() - start);
+
+    start = bench_seconds();
+    for (i = 0, next_delay = 0, now = 0; i < count; ++i) {
+        RBTreeTimer *timer = &rbtree_timers[order[i]];
+
+        if (timer->armed) {
+            rbtree_cancel(&rbtree, timer);
+        }
+        rbtree_arm(&rbtree, timer, now + delays[i]);
+
+        if (i % OPS_PER_TICK == OPS_PER_TICK - 1) {
+            rbtree_tick(&rbtree, ++now, &next_delay);
+        }
+    }
+    bench_report("rbtree_remove + rbtree_insert, ticking", count, bench_seconds() - start);
+
+    start = bench_seconds();
+    while ((node = rbtree_first(&rbtree))) {
+        rbtree_cancel(&rbtree, rbtree_entry(node, RBTreeTimer, node));
+        ++sink;
+    }
+    bench_report("rbtree_first + rbtree_remove, expiring all", count, bench_seconds() - start);
+
+    printf("(checksum %lu)\n", (unsigned long) sink);
+
+    free(rbtree_timers);
+    free(delays);
+    free(order);
+
+    return 0;
+}
@@ -0,0 +1,137 @@
+/*
+Copyright (c) 2017, Michael J Welsh
+
+Permission to use, copy, modify, and/or distribute this software
+for any purpose with or without fee is hereby granted, provided
+that the above copyright notice and this permission notice appear
+in all copies.
+
+THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL
+WARRANTIES WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE
+AUTHOR BE LIABLE FOR ANY SPECIAL, DIRECT, INDIRECT, OR
+CONSEQUENTIAL DAMAGES OR ANY DAMAGES WHATSOEVER RESULTING FROM
+LOSS OF USE, DATA OR PROFITS, WHETHER IN AN ACTION OF CONTRACT,
+NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF OR IN
+CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <stddef.h>
+#include <string.h>
+
+#include "benchmarking_framework.h"
+#include "../src/list.h"
+#include "../src/unrolled_list.h"
+
+/* ========================================================================================================
+ *
+ *                                            BENCHMARK UTILITIES
+ *
+ * ======================================================================================================== */
+
+/* Every scan visits at least this many nodes in total, so that small lists are scanned several times. */
+#define MIN_SCANNED_NODES 10000000
+
+typedef struct Object {
+    unsigned long val;
+    ListNode list_node;
+    UnrolledListNode unrolled_node;
+} Object;
+
+size_t sink;
+
+/*
+ * Returns a stride close to count / phi that is coprime to count. Inserting the objects i * stride % count
+ * for i in [0, count) inserts each object once, with neighbors far apart in memory, as they are in a list
+ * after a long run of insertions and removals.
+ */
+static size_t shuffle_stride(size_t count) {
+    size_t stride = (size_t) (count * 0.6180339887) | 1, a, b, t;
+
+    for (;; stride += 2) {
+        a = count;
+        b = stride;
+        while (b) {
+            t = a % b;
+            a = b;
+            b = t;
+        }
+        if (a == 1) {
+            return stride;
+        }
+    }
+}
+
+/* ========================================================================================================
+ *
+ *                                                BENCHMARKS
+ *
+ * ======================================================================================================== */
+
+int main(int argc, char *argv[]) {
+    size_t count = bench_count(argc, argv, 1000000), stride = shuffle_stride(count), passes, pass, i;
+    Object *objs = (Object*) malloc(count * sizeof(Object));
+    int shuffled;
+
+    passes = count < MIN_SCANNED_NODES ? MIN_SCANNED_NODES / count : 1;
+
+    printf("(%lu elements)\n", (unsigned long) count);
+
+    for (i = 0; i < count; ++i) {
+        objs[i].val = bench_random();
+    }
+
+    for (shuffled = 0; shuffled <= 1; ++shuffled) {
+        const char *order = shuffled ? "shuffled" : "sequential";
+        char name[100];
+        List list;
+        UnrolledList unrolled_list;
+        ListNode *n;
+        UnrolledListNode *un;
+        UnrolledListChunk *chunk;
+        size_t index;
+        double start;
+
+        list_init(&list);
+        start = bench_seconds();
+        for (i = 0; i < count; ++i) {
+            list_insert_back(&list, &objs[shuffled ? i * stride % count : i].list_node);
+        }
+        sprintf(name, "list_insert_back, %s", order);
+        bench_report(name, count, bench_seconds() - start);
+
+        start = bench_seconds();
+        for (pass = 0; pass < passes; ++pass) {
+            list_for_each(n, &list) {
+                sink += list_entry(n, Object, list_node)->val;
+            }
+        }
+        sprintf(name, "list_for_each, %s", order);
+        bench_report(name, passes * count, bench_seconds() - start);
+
+        unrolled_list_init(&unrolled_list, NULL, NULL, NULL);
+        start = bench_seconds();
+        for (i = 0; i < count; ++i) {
+            unrolled_list_insert_back(&unrolled_list, &objs[shuffled ? i * stride % count : i].unrolled_node);
+        }
+        sprintf(name, "unrolled_list_insert_back, %s", order);
+        bench_report(name, count, bench_seconds() - start);
+
+        start = bench_seconds();
+        for (pass = 0; pass < passes; ++pass) {
+            unrolled_list_for_each(un, chunk, index, &unrolled_list) {
+                sink += unrolled_list_entry(un, Object, unrolled_node)->val;
+            }
+        }
+        sprintf(name, "unrolled_list_for_each, %s", order);
+        bench_report(name, passes * count, bench_seconds() - start);
+
+        unrolled_list_remove_all(&unrolled_list);
+    }
+
+    free(objs);
+
+    return 0;
+}
@@ -0,0 +1,117 @@
+/*
+Copyright (c) 2017, Michael J Welsh
+
+Permission to use, copy, modify, and/or distribute this software
+for any purpose with or without fee is hereby granted, provided
+that the above copyright notice and this permission notice appear
+in all copies.
+
+THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL
+WARRANTIES WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE
+AUTHOR BE LIABLE FOR ANY SPECIAL, DIRECT, INDIRECT, OR
+CONSEQUENTIAL DAMAGES OR ANY DAMAGES WHATSOEVER RESULTING FROM
+LOSS OF USE, DATA OR PROFITS, WHETHER IN AN ACTION OF CONTRACT,
+NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF OR IN
+CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+
+/**
+ * @file    benchmarking_framework.h
+ *
+ * Tools for benchmarking the data structures and algorithms.
+ */
+
+#ifndef BENCHMARKING_FRAMEWORK_H__
+#define BENCHMARKING_FRAMEWORK_H__
+
+#ifdef __cplusplus
+extern "C" {
+#endif /* __cplusplus */
+
+#include <stddef.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+/* ========================================================================================================
+ *
+ *                                               PROTOTYPES
+ *
+ * ======================================================================================================== */
+
+/**
+ * Returns the number of operations to benchmark: the first command line argument if given, otherwise
+ * @param default_count.
+ *
+ * @param argc                  The argc passed to main.
+ * @param argv                  The argv passed to main.
+ * @param default_count         The count used when no argument is given.
+ */
+static size_t bench_count(int argc, char *argv[], size_t default_count);
+
+/**
+ * Returns a wall clock timestamp in seconds. Only differences between two timestamps are meaningful.
+ */
+static double bench_seconds(void);
+
+/**
+ * Returns a pseudo-random number (xorshift). The sequence is the same on every run, so results are
+ * reproducible.
+ */
+static unsigned long bench_random(void);
+
+/**
+ * Outputs the time per operation and the throughput of a benchmark.
+ *
+ * @param name                  The name of the benchmark.
+ * @param num_ops               The number of operations timed.
+ * @param seconds               The time taken by all the operations.
+ */
+static void bench_report(const char *name, size_t num_ops, double seconds);
+
+/* ========================================================================================================
+ *
+ *                                          FUNCTION DEFINITIONS
+ *
+ * ======================================================================================================== */
+
+static size_t bench_count(int argc, char *argv[], size_t default_count) {
+    if (argc > 1 && atol(argv[1]) > 0) {
+        return (size_t) atol(argv[1]);
+    }
+    return default_count;
+}
+
+static double bench_seconds(void) {
+#ifdef CLOCK_MONOTONIC
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double) ts.tv_sec + (double) ts.tv_nsec / 1e9;
+#else
+    return (double) clock() / CLOCKS_PER_SEC;
+#endif
+}
+
+static unsigned long bench_random(void) {
+    static unsigned long state = 2463534242ul;
+    state = (state ^ (state << 13)) & 0xFFFFFFFFul;
+    state ^= state >> 17;
+    state = (state ^ (state << 5)) & 0xFFFFFFFFul;
+    return state;
+}
+
+static void bench_report(const char *name, size_t num_ops, double seconds) {
+    printf(
+        "%-48s %10.2f ns/op %14.0f ops/s\n",
+        name,
+        seconds * 1e9 / (double) (num_ops ? num_ops : 1),
+        seconds > 0 ? (double) num_ops / seconds : 0.0
+    );
+}
+
+#ifdef __cplusplus
+}
+#endif /* __cplusplus */
+
+#endif /* BENCHMARKING_FRAMEWORK_H__ */
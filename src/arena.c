@@ -0,0 +1,280 @@
+/*
+Copyright (c) 2017, Michael J Welsh
+
+Permission to use, copy, modify, and/or distribute this software
+for any purpose with or without fee is hereby granted, provided
+that the above copyright notice and this permission notice appear
+in all copies.
+
+THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL
+WARRANTIES WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE
+AUTHOR BE LIABLE FOR ANY SPECIAL, DIRECT, INDIRECT, OR
+CONSEQUENTIAL DAMAGES OR ANY DAMAGES WHATSOEVER RESULTING FROM
+LOSS OF USE, DATA OR PROFITS, WHETHER IN AN ACTION OF CONTRACT,
+NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF OR IN
+CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+
+#include <assert.h>
+#include <stddef.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "arena.h"
+
+/* ========================================================================================================
+ *
+ *                                        STATIC FUNCTION PROTOTYPES
+ *
+ * ======================================================================================================== */
+
+/*
+ * Returns the number of bytes to skip after @ref cursor to align it to @ref alignment.
+ */
+static size_t padding(const char *cursor, size_t alignment);
+
+/*
+ * Returns 1 if a block of @ref size bytes aligned to @ref alignment fits between @ref cursor and @ref limit.
+ */
+static int fits(const char *cursor, const char *limit, size_t size, size_t alignment);
+
+/*
+ * Makes the @ref chunk the one blocks are allocated from.
+ */
+static void use_chunk(Arena *arena, ArenaChunk *chunk);
+
+/*
+ * Links the @ref chunk right after the current chunk, so that it is used next.
+ */
+static void link_chunk(Arena *arena, ArenaChunk *chunk);
+
+/*
+ * Moves on to the next chunk that can hold the block, allocating one if there is none. Returns 0 if no chunk
+ * is available.
+ */
+static int next_chunk(Arena *arena, size_t size, size_t alignment);
+
+/* ========================================================================================================
+ *
+ *                                        STATIC FUNCTION DEFINITIONS
+ *
+ * ======================================================================================================== */
+
+static size_t padding(const char *cursor, size_t alignment) {
+    assert(alignment > 0 && (alignment & (alignment - 1)) == 0);
+
+    return (alignment - ((size_t) cursor & (alignment - 1))) & (alignment - 1);
+}
+
+static int fits(const char *cursor, const char *limit, size_t size, size_t alignment) {
+    size_t available = (size_t) (limit - cursor), skipped = padding(cursor, alignment);
+
+    assert(cursor && limit && cursor <= limit);
+
+    return available >= skipped && available - skipped >= size;
+}
+
+static void use_chunk(Arena *arena, ArenaChunk *chunk) {
+    assert(arena && chunk);
+
+    arena->current = chunk;
+    arena->cursor = (char*) chunk + ARENA_CHUNK_OVERHEAD;
+    arena->limit = (char*) chunk + chunk->size;
+}
+
+static void link_chunk(Arena *arena, ArenaChunk *chunk) {
+    assert(arena && chunk);
+
+    if (arena->current) {
+        chunk->next = arena->current->next;
+        arena->current->next = chunk;
+    } else {
+        chunk->next = arena->head;
+        arena->head = chunk;
+    }
+}
+
+static int next_chunk(Arena *arena, size_t size, size_t alignment) {
+    ArenaChunk *chunk;
+    size_t chunk_size;
+
+    assert(arena);
+
+    /* Chunks kept by a reset or a rewind and chunks given by the user come first. */
+    while ((chunk = arena->current ? arena->current->next : arena->head)) {
+        if (fits((char*) chunk + ARENA_CHUNK_OVERHEAD, (char*) chunk + chunk->size, size, alignment)) {
+            use_chunk(arena, chunk);
+            return 1;
+        }
+
+        if (arena->chunk_size) {
+            break;
+        }
+
+        /* Without chunks of its own, the arena can only skip the chunk. */
+        use_chunk(arena, chunk);
+    }
+
+    if (!arena->chunk_size) {
+        return 0;
+    }
+
+    /* A large block gets a chunk of its own. */
+    chunk_size = ARENA_CHUNK_OVERHEAD + size;
+    if (alignment > ARENA_ALIGNMENT) {
+        chunk_size += alignment - ARENA_ALIGNMENT;
+    }
+    if (chunk_size < arena->chunk_size) {
+        chunk_size = arena->chunk_size;
+    }
+
+    if (arena->allocate) {
+        chunk = (ArenaChunk*) arena->allocate(chunk_size, arena->allocator_data);
+    } else {
+        chunk = (ArenaChunk*) malloc(chunk_size);
+    }
+
+    if (!chunk) {
+        return 0;
+    }
+
+    chunk->size = chunk_size;
+    chunk->owned = 1;
+    link_chunk(arena, chunk);
+    use_chunk(arena, chunk);
+
+    return 1;
+}
+
+/* ========================================================================================================
+ *
+ *                                        EXTERN FUNCTION DEFINITIONS
+ *
+ * ======================================================================================================== */
+
+void arena_init(
+    Arena *arena,
+    size_t chunk_size,
+    void* (*allocate)(size_t size, void *allocator_data),
+    void (*deallocate)(void *ptr, size_t size, void *allocator_data),
+    void *allocator_data
+) {
+    assert(arena && ((!allocate && !deallocate) || (allocate && deallocate)));
+
+    arena->head = NULL;
+    arena->current = NULL;
+    arena->cursor = NULL;
+    arena->limit = NULL;
+    arena->chunk_size = chunk_size;
+    arena->size = 0;
+    arena->allocate = allocate;
+    arena->deallocate = deallocate;
+    arena->allocator_data = allocator_data;
+}
+
+size_t arena_size(const Arena *arena) {
+    assert(arena);
+
+    return arena->size;
+}
+
+void arena_add_chunk(Arena *arena, void *memory, size_t size) {
+    ArenaChunk *chunk = (ArenaChunk*) memory;
+
+    assert(arena && memory && size > ARENA_CHUNK_OVERHEAD);
+
+    chunk->size = size;
+    chunk->owned = 0;
+    link_chunk(arena, chunk);
+}
+
+void* arena_alloc(Arena *arena, size_t size) {
+    assert(arena);
+
+    return arena_alloc_aligned(arena, size, ARENA_ALIGNMENT);
+}
+
+void* arena_alloc_aligned(Arena *arena, size_t size, size_t alignment) {
+    char *block;
+
+    assert(arena && alignment > 0 && (alignment & (alignment - 1)) == 0);
+
+    if (!arena->current || !fits(arena->cursor, arena->limit, size, alignment)) {
+        if (!next_chunk(arena, size, alignment)) {
+            return NULL;
+        }
+    }
+
+    block = arena->cursor + padding(arena->cursor, alignment);
+    arena->cursor = block + size;
+    arena->size += size;
+
+    return block;
+}
+
+void* arena_alloc_zeroed(Arena *arena, size_t size) {
+    void *block;
+
+    assert(arena);
+
+    block = arena_alloc(arena, size);
+
+    if (block) {
+        memset(block, 0, size);
+    }
+
+    return block;
+}
+
+void arena_mark(const Arena *arena, ArenaMark *mark) {
+    assert(arena && mark);
+
+    mark->chunk = arena->current;
+    mark->cursor = arena->cursor;
+    mark->size = arena->size;
+}
+
+void arena_rewind(Arena *arena, const ArenaMark *mark) {
+    assert(arena && mark && mark->size <= arena->size);
+
+    arena->current = mark->chunk;
+    arena->cursor = mark->cursor;
+    arena->limit = mark->chunk ? (char*) mark->chunk + mark->chunk->size : NULL;
+    arena->size = mark->size;
+}
+
+void arena_reset(Arena *arena) {
+    assert(arena);
+
+    arena->current = NULL;
+    arena->cursor = NULL;
+    arena->limit = NULL;
+    arena->size = 0;
+}
+
+void arena_release(Arena *arena) {
+    ArenaChunk *chunk, *next;
+
+    assert(arena);
+
+    for (chunk = arena->head; chunk; chunk = next) {
+        next = chunk->next;
+
+        if (!chunk->owned) {
+            continue;
+        }
+
+        if (arena->deallocate) {
+            arena->deallocate(chunk, chunk->size, arena->allocator_data);
+        } else {
+            free(chunk);
+        }
+    }
+
+    arena->head = NULL;
+    arena->current = NULL;
+    arena->cursor = NULL;
+    arena->limit = NULL;
+    arena->size = 0;
+}
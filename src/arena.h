@@ -0,0 +1,383 @@
+/*
+Copyright (c) 2017, Michael J Welsh
+
+Permission to use, copy, modify, and/or distribute this software
+for any purpose with or without fee is hereby granted, provided
+that the above copyright notice and this permission notice appear
+in all copies.
+
+THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL
+WARRANTIES WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE
+AUTHOR BE LIABLE FOR ANY SPECIAL, DIRECT, INDIRECT, OR
+CONSEQUENTIAL DAMAGES OR ANY DAMAGES WHATSOEVER RESULTING FROM
+LOSS OF USE, DATA OR PROFITS, WHETHER IN AN ACTION OF CONTRACT,
+NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF OR IN
+CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+
+/**
+ * @file    arena.h
+ * @brief   ARENA (BUMP-POINTER ALLOCATOR)
+ *
+ * An @ref Arena hands out blocks of any size by moving a pointer forward through large chunks of memory.
+ * Blocks are NEVER freed one by one; instead, @ref arena_reset frees every block at once, and
+ * @ref arena_rewind frees every block allocated since an @ref ArenaMark was taken. Both are O(1). An
+ * @ref Arena MUST be initialized before it is used.
+ *
+ * This suits structures whose lifetime is known in advance, such as the ones built while handling a
+ * request. Allocate the objects holding the nodes and the bucket arrays from the @ref Arena, remove all the
+ * nodes with the O(1)/O(m) "remove_all" function of each structure, and reset the @ref Arena, instead of
+ * removing and freeing every node one by one. @ref arena_alloc_zeroed returns memory filled with zero bytes,
+ * which is what @ref hashtable_fast_init expects of its bucket array on every common platform.
+ *
+ * Chunks come from two sources, as with a @ref Pool. The user can give the @ref Arena memory of their own
+ * with @ref arena_add_chunk; such chunks are NEVER freed by the @ref Arena. When the @ref Arena runs out of
+ * memory and its chunk size is non-zero, it allocates a chunk with the OPTIONAL allocate function given
+ * during initialization, and with malloc() otherwise. A block larger than the chunk size gets a chunk of its
+ * own. Chunks are kept by @ref arena_reset and @ref arena_rewind, so a warmed-up @ref Arena does not
+ * allocate.
+ *
+ * An @ref Arena is NOT thread-safe.
+ *
+ * Example:
+ *          struct Object {
+ *              int key;
+ *              RBTreeNode rbtree_node;
+ *              HashTableNode hashtable_node;
+ *          };
+ *
+ *          void handle_request(Arena *arena, const int *keys, size_t num_keys) {
+ *              HashTableNode **bucket_array;
+ *              struct Object *obj;
+ *              HashTable hashtable;
+ *              RBTree rbtree;
+ *              size_t i;
+ *
+ *              bucket_array = (HashTableNode**) arena_alloc_zeroed(arena, num_keys * sizeof(HashTableNode*));
+ *              hashtable_fast_init(&hashtable, bucket_array, num_keys, hash, equal, NULL, NULL);
+ *              rbtree_init(&rbtree, compare, NULL, NULL);
+ *
+ *              for (i = 0; i < num_keys; ++i) {
+ *                  obj = (struct Object*) arena_alloc(arena, sizeof(struct Object));
+ *                  obj->key = keys[i];
+ *                  rbtree_insert(&rbtree, &obj->key, &obj->rbtree_node);
+ *                  hashtable_insert(&hashtable, &obj->key, &obj->hashtable_node);
+ *              }
+ *
+ *              ...
+ *
+ *              rbtree_remove_all(&rbtree);
+ *              hashtable_remove_all(&hashtable);
+ *              arena_reset(arena);
+ *          }
+ *
+ * Dependencies:
+ *      -   C89 assert.h
+ *      -   C89 stddef.h
+ *      -   C89 stdlib.h
+ *      -   C89 string.h
+ *
+ * API:
+ *      ====  TYPES  ====
+ *      -   typedef struct Arena Arena
+ *      -   typedef struct ArenaChunk ArenaChunk
+ *      -   typedef struct ArenaMark ArenaMark
+ *
+ *      ====  FUNCTIONS  ====
+ *      Initializers:
+ *          -   arena_init
+ *      Properties:
+ *          -   arena_size
+ *      Chunks:
+ *          -   arena_add_chunk
+ *      Allocation:
+ *          -   arena_alloc
+ *          -   arena_alloc_aligned
+ *          -   arena_alloc_zeroed
+ *      Marks:
+ *          -   arena_mark
+ *          -   arena_rewind
+ *      Removal:
+ *          -   arena_reset
+ *          -   arena_release
+ *
+ *      ====  MACROS  ====
+ *      Constants:
+ *          -   ARENA_ALIGNMENT
+ *          -   ARENA_CHUNK_OVERHEAD
+ */
+
+#ifndef ARENA_H
+#define ARENA_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif /* __cplusplus */
+
+#include <stddef.h>
+
+/* ========================================================================================================
+ *
+ *                                                  TYPES
+ *
+ * ======================================================================================================== */
+
+/* Struct type declarations. */
+struct Arena;
+struct ArenaChunk;
+struct ArenaMark;
+
+/* Struct typedef's. */
+typedef struct Arena Arena;
+typedef struct ArenaChunk ArenaChunk;
+typedef struct ArenaMark ArenaMark;
+
+/**
+ * Represents a bump-pointer allocator.
+ */
+struct Arena {
+    ArenaChunk *head;
+    ArenaChunk *current;
+    char *cursor;
+    char *limit;
+    size_t chunk_size;
+    size_t size;
+    void* (*allocate)(size_t size, void *allocator_data);
+    void (*deallocate)(void *ptr, size_t size, void *allocator_data);
+    void *allocator_data;
+};
+
+/**
+ * Represents the header at the start of every chunk of an @ref Arena. Managed by the @ref Arena.
+ */
+struct ArenaChunk {
+    ArenaChunk *next;
+    size_t size;
+    int owned;
+};
+
+/**
+ * Represents a position in an @ref Arena, which @ref arena_rewind goes back to.
+ */
+struct ArenaMark {
+    ArenaChunk *chunk;
+    char *cursor;
+    size_t size;
+};
+
+/* ========================================================================================================
+ *
+ *                                               PROTOTYPES
+ *
+ * ======================================================================================================== */
+
+/**
+ * Initializes the @ref arena. Use @ref arena_release to reset an @ref arena that owns chunks, otherwise they
+ * are leaked.
+ *
+ * Requirements:
+ *      -   @ref arena != NULL
+ *      -   Either @ref allocate and @ref deallocate are both NULL, or are both non-NULL
+ *
+ * Time complexity:
+ *      -   O(1)
+ *
+ * @param arena                 The @ref Arena to be initialized.
+ * @param chunk_size            The size in bytes of the chunks the @ref arena allocates when it runs out of
+ *                              memory, including @ref ARENA_CHUNK_OVERHEAD. If 0, the @ref arena never
+ *                              allocates chunks, and only uses the chunks given to it with
+ *                              @ref arena_add_chunk.
+ * @param allocate              The OPTIONAL (i.e. can be NULL) function used to allocate a chunk of
+ *                              @ref size bytes, aligned to @ref ARENA_ALIGNMENT. Returns NULL on failure. If
+ *                              NULL, malloc() is used.
+ * @param deallocate            The OPTIONAL (i.e. can be NULL) function used to free a chunk of @ref size
+ *                              bytes allocated by @ref allocate. If NULL, free() is used.
+ * @param allocator_data        The OPTIONAL (i.e. can be NULL) data passed to @ref allocate and
+ *                              @ref deallocate. This data is NEVER manipulated by the @ref arena.
+ */
+void arena_init(
+    Arena *arena,
+    size_t chunk_size,
+    void* (*allocate)(size_t size, void *allocator_data),
+    void (*deallocate)(void *ptr, size_t size, void *allocator_data),
+    void *allocator_data
+);
+
+/**
+ * Returns the number of bytes requested from the @ref arena since it was last reset, excluding alignment
+ * padding.
+ *
+ * Requirements:
+ *      -   @ref arena != NULL
+ *
+ * Time complexity:
+ *      -   O(1)
+ *
+ * @param arena                 The @ref Arena whose "size" member will be returned.
+ * @return                      @ref arena->size.
+ */
+size_t arena_size(const Arena *arena);
+
+/**
+ * Gives the @ref arena the @ref size bytes of memory starting at @ref memory. The @ref arena allocates from
+ * it before allocating chunks of its own, and NEVER frees it.
+ *
+ * Requirements:
+ *      -   @ref arena != NULL
+ *      -   @ref memory != NULL
+ *      -   @ref memory is aligned to @ref ARENA_ALIGNMENT
+ *      -   @ref size > @ref ARENA_CHUNK_OVERHEAD
+ *      -   The memory outlives its use by the @ref arena, i.e. until @ref arena_release is called.
+ *
+ * Time complexity:
+ *      -   O(1)
+ *
+ * @param arena                 The @ref Arena to be operated on.
+ * @param memory                The memory to allocate blocks from.
+ * @param size                  The size in bytes of the @ref memory.
+ */
+void arena_add_chunk(Arena *arena, void *memory, size_t size);
+
+/**
+ * Allocates a block of @ref size bytes from the @ref arena, aligned to @ref ARENA_ALIGNMENT. Same as
+ * @ref arena_alloc_aligned with an alignment of @ref ARENA_ALIGNMENT.
+ *
+ * Requirements:
+ *      -   @ref arena != NULL
+ *
+ * Time complexity:
+ *      -   O(1), plus the allocation of a chunk once per chunk
+ *
+ * @param arena                 The @ref Arena to be operated on.
+ * @param size                  The size in bytes of the block.
+ * @return                      The block. NULL if the @ref arena ran out of memory and a chunk could not be
+ *                              allocated.
+ */
+void* arena_alloc(Arena *arena, size_t size);
+
+/**
+ * Allocates a block of @ref size bytes from the @ref arena, aligned to @ref alignment (e.g. the size of a
+ * cache line, for a bucket array). Moves on to the next chunk that is large enough, or allocates a chunk,
+ * when the current chunk is used up; the rest of the current chunk is skipped until the next reset or rewind.
+ *
+ * Requirements:
+ *      -   @ref arena != NULL
+ *      -   @ref alignment is a power of two
+ *
+ * Time complexity:
+ *      -   O(1), plus the allocation of a chunk once per chunk
+ *
+ * @param arena                 The @ref Arena to be operated on.
+ * @param size                  The size in bytes of the block.
+ * @param alignment             The alignment in bytes of the block.
+ * @return                      The block. NULL if the @ref arena ran out of memory and a chunk could not be
+ *                              allocated.
+ */
+void* arena_alloc_aligned(Arena *arena, size_t size, size_t alignment);
+
+/**
+ * Same as @ref arena_alloc, but fills the block with zero bytes.
+ *
+ * Requirements:
+ *      -   @ref arena != NULL
+ *
+ * Time complexity:
+ *      -   O(size)
+ *
+ * @param arena                 The @ref Arena to be operated on.
+ * @param size                  The size in bytes of the block.
+ * @return                      The block. NULL if the @ref arena ran out of memory and a chunk could not be
+ *                              allocated.
+ */
+void* arena_alloc_zeroed(Arena *arena, size_t size);
+
+/**
+ * Stores the current position of the @ref arena in the @ref mark.
+ *
+ * Requirements:
+ *      -   @ref arena != NULL
+ *      -   @ref mark != NULL
+ *
+ * Time complexity:
+ *      -   O(1)
+ *
+ * @param arena                 The @ref Arena to be operated on.
+ * @param mark                  The @ref ArenaMark to be filled.
+ */
+void arena_mark(const Arena *arena, ArenaMark *mark);
+
+/**
+ * Frees every block allocated from the @ref arena since the @ref mark was taken. The chunks are kept.
+ *
+ * Requirements:
+ *      -   @ref arena != NULL
+ *      -   @ref mark != NULL
+ *      -   @ref mark was taken from the @ref arena, and the @ref arena has not been reset, released or
+ *          rewound to an earlier position since.
+ *      -   No block allocated since the @ref mark was taken is used afterwards.
+ *
+ * Time complexity:
+ *      -   O(1)
+ *
+ * @param arena                 The @ref Arena to be operated on.
+ * @param mark                  The position to go back to.
+ */
+void arena_rewind(Arena *arena, const ArenaMark *mark);
+
+/**
+ * Frees every block of the @ref arena at once. The chunks are kept, and are allocated from anew starting with
+ * the first one.
+ *
+ * Requirements:
+ *      -   @ref arena != NULL
+ *      -   No block of the @ref arena is used afterwards.
+ *
+ * Time complexity:
+ *      -   O(1)
+ *
+ * @param arena                 The @ref Arena to be operated on.
+ */
+void arena_reset(Arena *arena);
+
+/**
+ * Frees every block of the @ref arena, frees the chunks the @ref arena allocated, and forgets the chunks
+ * given to it with @ref arena_add_chunk. The @ref arena can be used again afterwards.
+ *
+ * Requirements:
+ *      -   @ref arena != NULL
+ *      -   No block of the @ref arena is used afterwards.
+ *
+ * Time complexity:
+ *      -   O(number of chunks)
+ *
+ * @param arena                 The @ref Arena to be operated on.
+ */
+void arena_release(Arena *arena);
+
+/* ========================================================================================================
+ *
+ *                                                 MACROS
+ *
+ * ======================================================================================================== */
+
+/**
+ * The alignment of the blocks returned by @ref arena_alloc, and the alignment required of the chunks given to
+ * an @ref Arena. Can be overridden by defining it before including this header; it must then be a power of
+ * two, and have the same value in every translation unit.
+ */
+#ifndef ARENA_ALIGNMENT
+    #define ARENA_ALIGNMENT 16
+#endif
+
+/**
+ * The number of bytes at the start of every chunk that are used by the @ref ArenaChunk header, rounded up to
+ * @ref ARENA_ALIGNMENT.
+ */
+#define ARENA_CHUNK_OVERHEAD ((sizeof(ArenaChunk) + ARENA_ALIGNMENT - 1) / ARENA_ALIGNMENT * ARENA_ALIGNMENT)
+
+#ifdef __cplusplus
+}
+#endif /* __cplusplus */
+
+#endif /* ARENA_H */
@@ -17,19 +17,228 @@ CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
 */
 
 #include <assert.h>
+#include <limits.h>
 #include <stddef.h>
+#include <string.h>
 
 #include "hash_string.h"
 
+/*
+ * The AVX2 path of hash_string is only compiled by GCC >= 4.9/Clang on x86-64, which support per-function
+ * target attributes, so the rest of the file is still built for the baseline instruction set. It stores
+ * 64-bit lanes into size_t, so the x32 ABI (__ILP32__), where size_t is 32 bits, uses the portable code.
+ * Define HASH_STRING_NO_SIMD to force the portable code.
+ */
+#if defined(__x86_64__) && !defined(__ILP32__) && !defined(HASH_STRING_NO_SIMD) && \
+    (defined(__clang__) || (defined(__GNUC__) && (__GNUC__ > 4 || (__GNUC__ == 4 && __GNUC_MINOR__ >= 9))))
+    #define HASH_STRING_AVX2
+    #include <immintrin.h>
+#endif
+
+/* ========================================================================================================
+ *
+ *                                              STATIC MACROS
+ *
+ * ======================================================================================================== */
+
+#if ULONG_MAX > 0xFFFFFFFFUL
+    /* SipHash-1-3 on 64-bit words. */
+    #define SIP_WORD_SIZE 8
+    #define SIP_MASK(x) (x)
+    #define SIP_ROTL(x, b) (((x) << (b)) | ((x) >> (64 - (b))))
+    #define SIP_ROUND(v0, v1, v2, v3) \
+        do { \
+            v0 += v1; v1 = SIP_ROTL(v1, 13); v1 ^= v0; v0 = SIP_ROTL(v0, 32); \
+            v2 += v3; v3 = SIP_ROTL(v3, 16); v3 ^= v2; \
+            v0 += v3; v3 = SIP_ROTL(v3, 21); v3 ^= v0; \
+            v2 += v1; v1 = SIP_ROTL(v1, 17); v1 ^= v2; v2 = SIP_ROTL(v2, 32); \
+        } while (0)
+#else
+    /* HalfSipHash-1-3 on 32-bit words. */
+    #define SIP_WORD_SIZE 4
+    #define SIP_MASK(x) ((x) & 0xFFFFFFFFUL)
+    #define SIP_ROTL(x, b) SIP_MASK(((x) << (b)) | ((x) >> (32 - (b))))
+    #define SIP_ROUND(v0, v1, v2, v3) \
+        do { \
+            v0 = SIP_MASK(v0 + v1); v1 = SIP_ROTL(v1, 5); v1 ^= v0; v0 = SIP_ROTL(v0, 16); \
+            v2 = SIP_MASK(v2 + v3); v3 = SIP_ROTL(v3, 8); v3 ^= v2; \
+            v0 = SIP_MASK(v0 + v3); v3 = SIP_ROTL(v3, 7); v3 ^= v0; \
+            v2 = SIP_MASK(v2 + v1); v1 = SIP_ROTL(v1, 13); v1 ^= v2; v2 = SIP_ROTL(v2, 16); \
+        } while (0)
+#endif
+
+/* Number of leading characters hashed by the scalar loop before considering the AVX2 path. */
+#define HASH_STRING_SIMD_THRESHOLD 32
+
+/* ========================================================================================================
+ *
+ *                                        STATIC FUNCTION PROTOTYPES
+ *
+ * ======================================================================================================== */
+
+#ifdef HASH_STRING_AVX2
+static int avx2_supported(void);
+static size_t hash_string_avx2(const char *str, size_t len, size_t hash) __attribute__((target("avx2")));
+#endif /* HASH_STRING_AVX2 */
+
+/* ========================================================================================================
+ *
+ *                                        STATIC FUNCTION DEFINITIONS
+ *
+ * ======================================================================================================== */
+
+#ifdef HASH_STRING_AVX2
+/* Runtime CPU dispatch. The result is cached; racing threads all store the same value. */
+static int avx2_supported(void) {
+    static int supported = -1;
+
+    if (supported < 0) {
+        supported = __builtin_cpu_supports("avx2") != 0;
+    }
+
+    return supported;
+}
+
+/*
+ * Continues the djb2 hash over @ref len characters of @ref str, producing exactly what the scalar loop would.
+ * Unrolled 32 times, djb2 becomes hash * 33^32 + sum(str[j] * 33^(31 - j)). The sum is a dot product, which
+ * is folded pairwise: bytes into 16-bit words with weights (33, 1), words into 32-bit lanes with weights
+ * (33^2, 1), and lanes into 64-bit lanes with weights (33^4, 1). Intermediate values never overflow, and the
+ * final 64-bit lanes are combined with the running hash in size_t arithmetic (i.e. modulo 2^64, like djb2).
+ */
+static size_t hash_string_avx2(const char *str, size_t len, size_t hash) {
+    const __m256i pair_weights = _mm256_set1_epi16(0x0121);
+    const __m256i quad_weights = _mm256_set1_epi32(0x00010441);
+    const __m256i octet_weight = _mm256_set1_epi32(1185921);
+    const __m256i one = _mm256_set1_epi32(1);
+    size_t lanes[4], p8, p16, p24, p32, i;
+
+    for (p8 = 1, i = 0; i < 8; ++i) {
+        p8 *= 33;
+    }
+    p16 = p8 * p8;
+    p24 = p16 * p8;
+    p32 = p16 * p16;
+
+    for (; len >= 32; str += 32, len -= 32) {
+        __m256i data, pairs, quads, octets;
+
+        data = _mm256_loadu_si256((const __m256i*) str);
+
+        /* The operand treated as unsigned must match the signedness of char, just like in the scalar loop. */
+        #if CHAR_MIN < 0
+        pairs = _mm256_maddubs_epi16(pair_weights, data);
+        #else
+        pairs = _mm256_maddubs_epi16(data, pair_weights);
+        #endif
+
+        quads = _mm256_madd_epi16(pairs, quad_weights);
+        octets = _mm256_add_epi64(
+            _mm256_mul_epi32(quads, octet_weight),
+            _mm256_mul_epi32(_mm256_srli_epi64(quads, 32), one)
+        );
+
+        _mm256_storeu_si256((__m256i*) lanes, octets);
+        hash = hash * p32 + lanes[0] * p24 + lanes[1] * p16 + lanes[2] * p8 + lanes[3];
+    }
+
+    while (len--) {
+        hash = (hash << 5) + hash + *str++;
+    }
+
+    return hash;
+}
+#endif /* HASH_STRING_AVX2 */
+
+/* ========================================================================================================
+ *
+ *                                        EXTERN FUNCTION DEFINITIONS
+ *
+ * ======================================================================================================== */
+
 size_t hash_string(const void *string) {
     const char *str = (const char*) string;
     register size_t hash = 5381;
 
     assert(string);
 
+    #ifdef HASH_STRING_AVX2
+    {
+        const char *end = str + HASH_STRING_SIMD_THRESHOLD;
+
+        /* Short strings never pay for the strlen or the dispatch. */
+        while (*str && str != end) {
+            hash = (hash << 5) + hash + *str++;
+        }
+
+        if (str == end && *str && avx2_supported()) {
+            return hash_string_avx2(str, strlen(str), hash);
+        }
+    }
+    #endif /* HASH_STRING_AVX2 */
+
     while (*str) {
         hash = (hash << 5) + hash + *str++;
     }
 
     return hash;
 }
+
+size_t hash_string_seeded(const void *string, const void *seed) {
+    const unsigned char *str = (const unsigned char*) string;
+    const HashStringSeed *key = (const HashStringSeed*) seed;
+    size_t len, i;
+    unsigned long k0, k1, v0, v1, v2, v3, m;
+    int shift;
+
+    assert(string && seed);
+
+    len = strlen((const char*) string);
+    k0 = SIP_MASK(key->k0);
+    k1 = SIP_MASK(key->k1);
+
+    #if SIP_WORD_SIZE == 8
+    v0 = k0 ^ 0x736f6d6570736575UL;
+    v1 = k1 ^ 0x646f72616e646f6dUL;
+    v2 = k0 ^ 0x6c7967656e657261UL;
+    v3 = k1 ^ 0x7465646279746573UL;
+    #else
+    v0 = k0;
+    v1 = k1;
+    v2 = k0 ^ 0x6c796765UL;
+    v3 = k1 ^ 0x74656462UL;
+    #endif
+
+    /* Compression: one round per little-endian word. */
+    for (i = 0; i + SIP_WORD_SIZE <= len; i += SIP_WORD_SIZE) {
+        for (m = 0, shift = SIP_WORD_SIZE - 1; shift >= 0; --shift) {
+            m = (m << 8) | str[i + shift];
+        }
+
+        v3 ^= m;
+        SIP_ROUND(v0, v1, v2, v3);
+        v0 ^= m;
+    }
+
+    /* The last word holds the remaining bytes and the low byte of the length. */
+    m = SIP_MASK((unsigned long) len << (SIP_WORD_SIZE * 8 - 8));
+    for (shift = 0; i < len; ++i, shift += 8) {
+        m |= (unsigned long) str[i] << shift;
+    }
+
+    v3 ^= m;
+    SIP_ROUND(v0, v1, v2, v3);
+    v0 ^= m;
+
+    /* Finalization: three rounds. */
+    v2 ^= 0xFF;
+    SIP_ROUND(v0, v1, v2, v3);
+    SIP_ROUND(v0, v1, v2, v3);
+    SIP_ROUND(v0, v1, v2, v3);
+
+    #if SIP_WORD_SIZE == 8
+    return (size_t) (v0 ^ v1 ^ v2 ^ v3);
+    #else
+    return (size_t) (v1 ^ v3);
+    #endif
+}
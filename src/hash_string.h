@@ -18,11 +18,43 @@ CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
 
 /**
  * @file    hash_string.h
- * @brief   DJB2 HASH STRING FUNCTION
+ * @brief   STRING HASH FUNCTIONS
+ *
+ * @ref hash_string is the classic djb2 hash. It is very fast, but it is NOT keyed, so anyone who controls the
+ * strings being hashed can trivially craft keys that all land in the same bucket of a @ref HashTable, turning
+ * every insert/lookup into a linear scan. On x86-64 CPUs with AVX2 (detected at runtime when compiled with
+ * GCC >= 4.9 or Clang), long strings are hashed 32 characters at a time. The result is always identical to
+ * the portable code, which is used everywhere else (or when HASH_STRING_NO_SIMD is defined).
+ *
+ * @ref hash_string_seeded is a keyed hash (SipHash-1-3 when unsigned long is 64 bits wide, HalfSipHash-1-3
+ * otherwise). As long as the @ref HashStringSeed is random and kept secret, an attacker cannot predict which
+ * strings collide. Use it for tables keyed on untrusted input, and @ref hash_string everywhere else.
+ *
+ * Example:
+ *          HashStringSeed seed;
+ *          HashTable hashtable;
+ *          HashTableNode *bucket_array[50] = { NULL };
+ *
+ *          seed.k0 = random_bits();
+ *          seed.k1 = random_bits();
+ *
+ *          hashtable_fast_init(&hashtable, bucket_array, 50, hash_string, equal, NULL, NULL);
+ *          hashtable_seed(&hashtable, hash_string_seeded, &seed);
  *
  * Dependencies:
  *      -   C89 assert.h
+ *      -   C89 limits.h
  *      -   C89 stddef.h
+ *      -   C89 string.h
+ *
+ * API:
+ *      ====  TYPES  ====
+ *      -   typedef struct HashStringSeed HashStringSeed;
+ *
+ *      ====  FUNCTIONS  ====
+ *      Hashing:
+ *          -   hash_string
+ *          -   hash_string_seeded
  */
 
 #ifndef HASH_STRING_H
@@ -34,6 +66,34 @@ extern "C" {
 
 #include <stddef.h>
 
+/* ========================================================================================================
+ *
+ *                                                  TYPES
+ *
+ * ======================================================================================================== */
+
+/* Struct type declarations. */
+struct HashStringSeed;
+
+/* Struct typedef's. */
+typedef struct HashStringSeed HashStringSeed;
+
+/**
+ * Represents the secret key of @ref hash_string_seeded. Fill both members with random bits (e.g. read from
+ * /dev/urandom) once at startup. When unsigned long is 32 bits wide, only the low 32 bits of each member are
+ * used.
+ */
+struct HashStringSeed {
+    unsigned long k0;
+    unsigned long k1;
+};
+
+/* ========================================================================================================
+ *
+ *                                               PROTOTYPES
+ *
+ * ======================================================================================================== */
+
 /**
  * Returns the hash of the @ref string using the djb2 algorithm.
  *
@@ -48,6 +108,24 @@ extern "C" {
  */
 size_t hash_string(const void *string);
 
+/**
+ * Returns the keyed hash of the @ref string using SipHash-1-3 (HalfSipHash-1-3 when unsigned long is 32 bits
+ * wide) under the secret @ref seed. The signature matches the one expected by @ref hashtable_seed.
+ *
+ * Requirements:
+ *      -   @ref string != NULL
+ *      -   @ref seed != NULL
+ *      -   @ref seed points to a @ref HashStringSeed
+ *
+ * Time complexity:
+ *      -   O(n), where n == length of string
+ *
+ * @param string                The string used for generating a hash.
+ * @param seed                  The @ref HashStringSeed used as the secret key.
+ * @return                      The keyed hash of the @ref string.
+ */
+size_t hash_string_seeded(const void *string, const void *seed);
+
 #ifdef __cplusplus
 }
 #endif /* __cplusplus */
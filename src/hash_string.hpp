@@ -0,0 +1,80 @@
+/*
+Copyright (c) 2017, Michael J Welsh
+
+Permission to use, copy, modify, and/or distribute this software
+for any purpose with or without fee is hereby granted, provided
+that the above copyright notice and this permission notice appear
+in all copies.
+
+THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL
+WARRANTIES WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE
+AUTHOR BE LIABLE FOR ANY SPECIAL, DIRECT, INDIRECT, OR
+CONSEQUENTIAL DAMAGES OR ANY DAMAGES WHATSOEVER RESULTING FROM
+LOSS OF USE, DATA OR PROFITS, WHETHER IN AN ACTION OF CONTRACT,
+NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF OR IN
+CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+
+/**
+ * @file    hash_string.hpp
+ * @brief   COMPILE-TIME DJB2 HASH STRING FUNCTION (C++11)
+ *
+ * @ref hash_string_constexpr computes the same hash as @ref hash_string, but as a C++11 constexpr function.
+ * Combined with @ref hashtable_lookup_key_hashed, lookups on string literals skip hashing at runtime
+ * entirely.
+ *
+ * C++11 constexpr functions consist of a single return statement, so the hash is computed recursively (one
+ * level per character). It is meant for literals evaluated at compile time; compilers bound the recursion
+ * depth (512 by default for GCC), and @ref hash_string should be used for strings only known at runtime.
+ *
+ * Note that a precomputed hash is only valid for a @ref HashTable that hashes with @ref hash_string (i.e.
+ * one that was NOT seeded with @ref hashtable_seed).
+ *
+ * Example:
+ *          constexpr std::size_t content_type_hash = hash_string_constexpr("content-type");
+ *          static_assert(content_type_hash != 0, "hashed at compile time");
+ *
+ *          HashTableNode *n = hashtable_lookup_key_hashed(&headers, "content-type", content_type_hash);
+ *
+ * Dependencies:
+ *      -   C++11 cstddef
+ *      -   hash_string.h
+ *
+ * API:
+ *      ====  FUNCTIONS  ====
+ *      Hashing:
+ *          -   hash_string_constexpr
+ */
+
+#ifndef HASH_STRING_HPP
+#define HASH_STRING_HPP
+
+#ifndef __cplusplus
+    #error "hash_string.hpp requires C++11; include hash_string.h from C."
+#endif /* __cplusplus */
+
+#include <cstddef>
+
+#include "hash_string.h"
+
+/**
+ * Returns the hash of the @ref string using the djb2 algorithm. Always equal to @ref hash_string(string).
+ *
+ * Requirements:
+ *      -   @ref string != NULL
+ *
+ * Time complexity:
+ *      -   O(n), where n == length of string (at compile time when @ref string is a constant expression)
+ *
+ * @param string                The string used for generating a hash.
+ * @param hash                  The hash of the characters before @ref string. Leave as the default.
+ * @return                      The hash of the @ref string.
+ */
+constexpr std::size_t hash_string_constexpr(const char *string, std::size_t hash = 5381) {
+    return *string
+        ? hash_string_constexpr(string + 1, (hash << 5) + hash + static_cast<std::size_t>(*string))
+        : hash;
+}
+
+#endif /* HASH_STRING_HPP */
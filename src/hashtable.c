@@ -39,6 +39,8 @@ void hashtable_init(
     }
 
     hashtable->hash = hash;
+    hashtable->seeded_hash = NULL;
+    hashtable->hash_seed = NULL;
     hashtable->equal = equal;
     hashtable->collide = collide;
     hashtable->auxiliary_data = auxiliary_data;
@@ -68,6 +70,8 @@ void hashtable_fast_init(
     #endif /* NDEBUG */
 
     hashtable->hash = hash;
+    hashtable->seeded_hash = NULL;
+    hashtable->hash_seed = NULL;
     hashtable->equal = equal;
     hashtable->collide = collide;
     hashtable->auxiliary_data = auxiliary_data;
@@ -76,6 +80,17 @@ void hashtable_fast_init(
     hashtable->size = 0;
 }
 
+void hashtable_seed(
+    HashTable *hashtable,
+    size_t (*seeded_hash)(const void *key, const void *seed),
+    const void *seed
+) {
+    assert(hashtable && hashtable->size == 0);
+
+    hashtable->seeded_hash = seeded_hash;
+    hashtable->hash_seed = seed;
+}
+
 HashTableNode** hashtable_bucket_array(const HashTable *hashtable) {
     assert(hashtable);
 
@@ -103,15 +118,35 @@ int hashtable_empty(const HashTable *hashtable) {
 int hashtable_contains_key(const HashTable *hashtable, const void *key) {
     assert(hashtable);
 
-    return hashtable_lookup_key(hashtable, key) != NULL;
+    return hashtable_lookup_key_hashed(hashtable, key, hashtable_hash_key(hashtable, key)) != NULL;
+}
+
+int hashtable_contains_key_hashed(const HashTable *hashtable, const void *key, size_t hashcode) {
+    assert(hashtable);
+
+    return hashtable_lookup_key_hashed(hashtable, key, hashcode) != NULL;
+}
+
+size_t hashtable_hash_key(const HashTable *hashtable, const void *key) {
+    assert(hashtable);
+
+    return hashtable->seeded_hash
+        ? hashtable->seeded_hash(key, hashtable->hash_seed)
+        : hashtable->hash(key);
 }
 
 void hashtable_insert(HashTable *hashtable, const void *key, HashTableNode *node) {
+    assert(hashtable && node);
+
+    hashtable_insert_hashed(hashtable, key, hashtable_hash_key(hashtable, key), node);
+}
+
+void hashtable_insert_hashed(HashTable *hashtable, const void *key, size_t hashcode, HashTableNode *node) {
     HashTableNode **bucket, *n, *prev;
 
     assert(hashtable && node);
 
-    bucket = hashtable->bucket_array + hashtable->hash(key) % hashtable->num_buckets;
+    bucket = hashtable->bucket_array + hashcode % hashtable->num_buckets;
 
     for (n = *bucket, prev = NULL; n; prev = n, n = n->next) {
         if (hashtable->equal(key, n)) {
@@ -138,12 +173,59 @@ void hashtable_insert(HashTable *hashtable, const void *key, HashTableNode *node
     ++hashtable->size;
 }
 
+HashTableNode* hashtable_insert_unique(HashTable *hashtable, const void *key, HashTableNode *node) {
+    assert(hashtable && node);
+
+    return hashtable_insert_unique_hashed(hashtable, key, hashtable_hash_key(hashtable, key), node);
+}
+
+HashTableNode* hashtable_insert_unique_hashed(
+    HashTable *hashtable,
+    const void *key,
+    size_t hashcode,
+    HashTableNode *node
+) {
+    HashTableNode **bucket, *n;
+
+    assert(hashtable && node);
+
+    bucket = hashtable->bucket_array + hashcode % hashtable->num_buckets;
+
+    for (n = *bucket; n; n = n->next) {
+        if (hashtable->equal(key, n)) {
+            return n;
+        }
+    }
+
+    node->next = *bucket;
+    *bucket = node;
+
+    ++hashtable->size;
+
+    return NULL;
+}
+
+void hashtable_insert_at_slot(HashTable *hashtable, HashTableNode **slot, HashTableNode *node) {
+    assert(hashtable && slot && node && !*slot);
+
+    node->next = NULL;
+    *slot = node;
+
+    ++hashtable->size;
+}
+
 HashTableNode* hashtable_lookup_key(const HashTable *hashtable, const void *key) {
+    assert(hashtable);
+
+    return hashtable_lookup_key_hashed(hashtable, key, hashtable_hash_key(hashtable, key));
+}
+
+HashTableNode* hashtable_lookup_key_hashed(const HashTable *hashtable, const void *key, size_t hashcode) {
     HashTableNode *n;
 
     assert(hashtable);
 
-    n = hashtable->bucket_array[hashtable->hash(key) % hashtable->num_buckets];
+    n = hashtable->bucket_array[hashcode % hashtable->num_buckets];
 
     while (n && !hashtable->equal(key, n)) {
         n = n->next;
@@ -152,12 +234,38 @@ HashTableNode* hashtable_lookup_key(const HashTable *hashtable, const void *key)
     return n;
 }
 
+HashTableNode** hashtable_lookup_slot(HashTable *hashtable, const void *key) {
+    assert(hashtable);
+
+    return hashtable_lookup_slot_hashed(hashtable, key, hashtable_hash_key(hashtable, key));
+}
+
+HashTableNode** hashtable_lookup_slot_hashed(HashTable *hashtable, const void *key, size_t hashcode) {
+    HashTableNode **slot;
+
+    assert(hashtable);
+
+    slot = hashtable->bucket_array + hashcode % hashtable->num_buckets;
+
+    while (*slot && !hashtable->equal(key, *slot)) {
+        slot = &(*slot)->next;
+    }
+
+    return slot;
+}
+
 void hashtable_remove_key(HashTable *hashtable, const void *key) {
+    assert(hashtable);
+
+    hashtable_remove_key_hashed(hashtable, key, hashtable_hash_key(hashtable, key));
+}
+
+void hashtable_remove_key_hashed(HashTable *hashtable, const void *key, size_t hashcode) {
     HashTableNode **bucket, *n, *prev;
 
     assert(hashtable);
 
-    bucket = hashtable->bucket_array + hashtable->hash(key) % hashtable->num_buckets;
+    bucket = hashtable->bucket_array + hashcode % hashtable->num_buckets;
 
     for (n = *bucket, prev = NULL; n; prev = n, n = n->next) {
         if (hashtable->equal(key, n)) {
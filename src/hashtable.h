@@ -46,13 +46,29 @@ CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
  * by the @ref HashTable. This data is user-defined. This data, for example, could be a memory pool object
  * that is used for freeing up resources held by the old @ref HashTableNode in the collide function.
  *
+ * The user can OPTIONALLY switch the @ref HashTable over to a keyed (seeded) hash function with
+ * @ref hashtable_seed. A keyed hash such as @ref hash_string_seeded protects tables keyed on untrusted input
+ * from crafted bucket collisions (HashDoS). The seed is stored by pointer and is NEVER manipulated by the
+ * @ref HashTable, so one seed can be shared by any number of tables.
+ *
+ * To insert a @ref HashTableNode only if its key is absent, use @ref hashtable_insert_unique, which returns
+ * the already existing @ref HashTableNode instead of replacing it. For the "find or create" pattern where the
+ * new @ref HashTableNode should only be created when needed, use @ref hashtable_lookup_slot followed by
+ * @ref hashtable_insert_at_slot. Both walk the chain only once.
+ *
+ * Every operation taking a key has a "_hashed" variant that takes the hashcode of the key as well (see
+ * @ref hashtable_hash_key). The "_hashed" variants of the hashtable_for_each_possible macros take the
+ * hashcode instead of the key, since the bucket is all they need. Hashing a key once and reusing the
+ * hashcode across several operations, or across several @ref HashTable's sharing the same hash function,
+ * avoids rehashing expensive keys.
+ *
  * Note the difference between a key collision and a bucket collision. The @ref HashTable handles bucket
  * collisions internally by using a singly linked list at each bucket. This allows the @ref HashTable to grow
  * in size indefinitely without having to resize (at the cost of poor insert/lookup/removal time complexities
  * when the size of the @ref HashTable is severely greater than the number buckets). If you wish to resize a
  * @ref HashTable, you are best off creating an entirely new @ref HashTable and iteratively removing each
  * @ref HashTableNode from the old @ref HashTable while immediately inserting it into the new @ref HashTable
- * afterwards.
+ * afterwards, or using a @ref ManagedHashTable (see managed_hashtable.h), which does so automatically.
  *
  * Example:
  *          struct Object {
@@ -99,32 +115,48 @@ CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
  *      Initializers:
  *          -   hashtable_init
  *          -   hashtable_fast_init
+ *          -   hashtable_seed
  *      Properties:
  *          -   hashtable_bucket_array
  *          -   hashtable_num_buckets
  *          -   hashtable_size
  *          -   hashtable_empty
  *          -   hashtable_contains_key
+ *          -   hashtable_contains_key_hashed
+ *      Hashing:
+ *          -   hashtable_hash_key
  *      Insertion:
  *          -   hashtable_insert
+ *          -   hashtable_insert_hashed
+ *          -   hashtable_insert_unique
+ *          -   hashtable_insert_unique_hashed
+ *          -   hashtable_insert_at_slot
  *      Lookup:
  *          -   hashtable_lookup_key
+ *          -   hashtable_lookup_key_hashed
+ *          -   hashtable_lookup_slot
+ *          -   hashtable_lookup_slot_hashed
  *      Removal:
  *          -   hashtable_remove_key
+ *          -   hashtable_remove_key_hashed
  *          -   hashtable_remove_all
  *
  *      ====  MACROS  ====
  *      Constants:
  *          -   HASHTABLE_POISON_NEXT
+ *          -   HASHTABLE_PREFETCH_DISTANCE
  *      Convenient Node Initializer:
  *          -   HASHTABLE_NODE_INIT
  *      Properties:
  *          -   hashtable_entry
  *      Traversal:
  *          -   hashtable_for_each
+ *          -   hashtable_for_each_prefetch
  *          -   hashtable_for_each_safe
  *          -   hashtable_for_each_possible
+ *          -   hashtable_for_each_possible_hashed
  *          -   hashtable_for_each_possible_safe
+ *          -   hashtable_for_each_possible_safe_hashed
  */
 
 #ifndef HASHTABLE_H
@@ -156,6 +188,8 @@ typedef struct HashTableNode HashTableNode;
 struct HashTable {
     HashTableNode **bucket_array;
     size_t (*hash)(const void *key);
+    size_t (*seeded_hash)(const void *key, const void *seed);
+    const void *hash_seed;
     int (*equal)(const void *key, const HashTableNode *node);
     void (*collide)(const HashTableNode *old_node, const HashTableNode *new_node, void *auxiliary_data);
     void *auxiliary_data;
@@ -259,6 +293,30 @@ void hashtable_fast_init(
     void *auxiliary_data
 );
 
+/**
+ * Makes the @ref hashtable hash keys with @ref seeded_hash(key, @ref seed) instead of @ref hashtable->hash.
+ * Passing a NULL @ref seeded_hash switches the @ref hashtable back to @ref hashtable->hash. The @ref seed is
+ * stored by pointer, so it MUST outlive its use by the @ref hashtable.
+ *
+ * Requirements:
+ *      -   @ref hashtable != NULL
+ *      -   @ref hashtable is empty
+ *
+ * Time complexity:
+ *      -   O(1)
+ *
+ * @param hashtable             The @ref HashTable to be operated on.
+ * @param seeded_hash           The OPTIONAL (i.e. can be NULL) callback function used to hash a key under
+ *                              the @ref seed (e.g. @ref hash_string_seeded).
+ * @param seed                  The seed passed to @ref seeded_hash. This data is NEVER manipulated by the
+ *                              @ref hashtable.
+ */
+void hashtable_seed(
+    HashTable *hashtable,
+    size_t (*seeded_hash)(const void *key, const void *seed),
+    const void *seed
+);
+
 /**
  * Returns the bucket array used by the @ref hashtable.
  *
@@ -333,6 +391,43 @@ int hashtable_empty(const HashTable *hashtable);
  */
 int hashtable_contains_key(const HashTable *hashtable, const void *key);
 
+/**
+ * Same as @ref hashtable_contains_key, but uses the precomputed @ref hashcode of the @ref key instead of
+ * hashing the @ref key again.
+ *
+ * Requirements:
+ *      -   @ref hashtable != NULL
+ *      -   @ref hashcode == @ref hashtable_hash_key(hashtable, key)
+ *
+ * Time complexity:
+ *      -   O(n/m), where m == number of buckets in bucket array
+ *
+ * @param hashtable             The @ref HashTable that may potentially contain the @ref HashTableNode
+ *                              associated with the @ref key.
+ * @param key                   The key used for lookup.
+ * @param hashcode              The precomputed hashcode of the @ref key.
+ * @return                      Whether or not the @ref hashtable contains the @ref HashTableNode associated
+ *                              with the @ref key.
+ */
+int hashtable_contains_key_hashed(const HashTable *hashtable, const void *key, size_t hashcode);
+
+/**
+ * Returns the hashcode the @ref hashtable computes for the @ref key, i.e. @ref hashtable->hash(key), or the
+ * seeded hash of the @ref key if @ref hashtable_seed was used. The hashcode can be passed to the "_hashed"
+ * variants of the @ref HashTable functions, including those of other @ref HashTable's hashing the same way.
+ *
+ * Requirements:
+ *      -   @ref hashtable != NULL
+ *
+ * Time complexity:
+ *      -   Same as the hash function
+ *
+ * @param hashtable             The @ref HashTable whose hash function will be used.
+ * @param key                   The key to be hashed.
+ * @return                      The hashcode of the @ref key.
+ */
+size_t hashtable_hash_key(const HashTable *hashtable, const void *key);
+
 /**
  * Inserts the @ref node with associated @ref key into the @ref hashtable. If a @ref HashTableNode already
  * exists with the same @ref key, the already existing @ref HashTableNode will be replaced by the new
@@ -351,6 +446,92 @@ int hashtable_contains_key(const HashTable *hashtable, const void *key);
  */
 void hashtable_insert(HashTable *hashtable, const void *key, HashTableNode *node);
 
+/**
+ * Same as @ref hashtable_insert, but uses the precomputed @ref hashcode of the @ref key instead of hashing the
+ * @ref key again.
+ *
+ * Requirements:
+ *      -   @ref hashtable != NULL
+ *      -   @ref node != NULL
+ *      -   @ref hashcode == @ref hashtable_hash_key(hashtable, key)
+ *
+ * Time complexity:
+ *      -   O(n/m), where m == number of buckets in bucket array
+ *
+ * @param hashtable             The @ref HashTable to be operated on.
+ * @param key                   The key associated with the @ref node.
+ * @param hashcode              The precomputed hashcode of the @ref key.
+ * @param node                  The @ref HashTableNode to be inserted.
+ */
+void hashtable_insert_hashed(HashTable *hashtable, const void *key, size_t hashcode, HashTableNode *node);
+
+/**
+ * Inserts the @ref node with associated @ref key into the @ref hashtable, unless a @ref HashTableNode with the
+ * same @ref key already exists. In that case, the @ref hashtable is left untouched, the collide function is
+ * NOT called, and the already existing @ref HashTableNode is returned.
+ *
+ * Requirements:
+ *      -   @ref hashtable != NULL
+ *      -   @ref node != NULL
+ *
+ * Time complexity:
+ *      -   O(n/m), where m == number of buckets in bucket array
+ *
+ * @param hashtable             The @ref HashTable to be operated on.
+ * @param key                   The key associated with the @ref node.
+ * @param node                  The @ref HashTableNode to be inserted.
+ * @return                      NULL if the @ref node was inserted; otherwise, the already existing
+ *                              @ref HashTableNode associated with the @ref key.
+ */
+HashTableNode* hashtable_insert_unique(HashTable *hashtable, const void *key, HashTableNode *node);
+
+/**
+ * Same as @ref hashtable_insert_unique, but uses the precomputed @ref hashcode of the @ref key instead of
+ * hashing the @ref key again.
+ *
+ * Requirements:
+ *      -   @ref hashtable != NULL
+ *      -   @ref node != NULL
+ *      -   @ref hashcode == @ref hashtable_hash_key(hashtable, key)
+ *
+ * Time complexity:
+ *      -   O(n/m), where m == number of buckets in bucket array
+ *
+ * @param hashtable             The @ref HashTable to be operated on.
+ * @param key                   The key associated with the @ref node.
+ * @param hashcode              The precomputed hashcode of the @ref key.
+ * @param node                  The @ref HashTableNode to be inserted.
+ * @return                      NULL if the @ref node was inserted; otherwise, the already existing
+ *                              @ref HashTableNode associated with the @ref key.
+ */
+HashTableNode* hashtable_insert_unique_hashed(
+    HashTable *hashtable,
+    const void *key,
+    size_t hashcode,
+    HashTableNode *node
+);
+
+/**
+ * Inserts the @ref node into the empty @ref slot returned by @ref hashtable_lookup_slot (or
+ * @ref hashtable_lookup_slot_hashed). The @ref node becomes the last @ref HashTableNode of its bucket.
+ *
+ * Requirements:
+ *      -   @ref hashtable != NULL
+ *      -   @ref slot != NULL
+ *      -   @ref node != NULL
+ *      -   *@ref slot == NULL
+ *      -   The @ref hashtable has NOT been modified since the @ref slot was looked up
+ *      -   The key of the @ref node is the key used to look up the @ref slot
+ *
+ * Time complexity:
+ *      -   O(1)
+ *
+ * @param hashtable             The @ref HashTable to be operated on.
+ * @param slot                  The empty slot returned by the lookup.
+ * @param node                  The @ref HashTableNode to be inserted.
+ */
+void hashtable_insert_at_slot(HashTable *hashtable, HashTableNode **slot, HashTableNode *node);
+
 /**
  * Returns the @ref HashTableNode associated with the @ref key in the @ref hashtable. NULL if a match for the
  * @ref key is not found.
@@ -368,6 +549,61 @@ void hashtable_insert(HashTable *hashtable, const void *key, HashTableNode *node
  */
 HashTableNode* hashtable_lookup_key(const HashTable *hashtable, const void *key);
 
+/**
+ * Same as @ref hashtable_lookup_key, but uses the precomputed @ref hashcode of the @ref key instead of hashing
+ * the @ref key again (e.g. a hashcode computed at compile time with hash_string_constexpr).
+ *
+ * Requirements:
+ *      -   @ref hashtable != NULL
+ *      -   @ref hashcode == @ref hashtable_hash_key(hashtable, key)
+ *
+ * Time complexity:
+ *      -   O(n/m), where m == number of buckets in bucket array
+ *
+ * @param hashtable             The @ref HashTable containing nodes.
+ * @param key                   The key used for lookup.
+ * @param hashcode              The precomputed hashcode of the @ref key.
+ * @return                      NULL if a match for the @ref key is not found; otherwise, the
+ *                              @ref HashTableNode associated with the @ref key.
+ */
+HashTableNode* hashtable_lookup_key_hashed(const HashTable *hashtable, const void *key, size_t hashcode);
+
+/**
+ * Returns the slot (i.e. the link in the bucket's chain) of the @ref key in the @ref hashtable. If a match for
+ * the @ref key is found, *slot is the @ref HashTableNode associated with the @ref key. Otherwise, *slot is
+ * NULL, and the slot can be passed to @ref hashtable_insert_at_slot to insert a @ref HashTableNode with the
+ * @ref key without walking the chain again.
+ *
+ * Requirements:
+ *      -   @ref hashtable != NULL
+ *
+ * Time complexity:
+ *      -   O(n/m), where m == number of buckets in bucket array
+ *
+ * @param hashtable             The @ref HashTable to be operated on.
+ * @param key                   The key used for lookup.
+ * @return                      The slot of the @ref key. Never NULL.
+ */
+HashTableNode** hashtable_lookup_slot(HashTable *hashtable, const void *key);
+
+/**
+ * Same as @ref hashtable_lookup_slot, but uses the precomputed @ref hashcode of the @ref key instead of hashing
+ * the @ref key again.
+ *
+ * Requirements:
+ *      -   @ref hashtable != NULL
+ *      -   @ref hashcode == @ref hashtable_hash_key(hashtable, key)
+ *
+ * Time complexity:
+ *      -   O(n/m), where m == number of buckets in bucket array
+ *
+ * @param hashtable             The @ref HashTable to be operated on.
+ * @param key                   The key used for lookup.
+ * @param hashcode              The precomputed hashcode of the @ref key.
+ * @return                      The slot of the @ref key. Never NULL.
+ */
+HashTableNode** hashtable_lookup_slot_hashed(HashTable *hashtable, const void *key, size_t hashcode);
+
 /**
  * Removes the @ref HashTableNode associated with the @ref key from the @ref hashtable. If a match for the
  * @ref key is not found, this function simply returns.
@@ -383,6 +619,23 @@ HashTableNode* hashtable_lookup_key(const HashTable *hashtable, const void *key)
  */
 void hashtable_remove_key(HashTable *hashtable, const void *key);
 
+/**
+ * Same as @ref hashtable_remove_key, but uses the precomputed @ref hashcode of the @ref key instead of hashing
+ * the @ref key again.
+ *
+ * Requirements:
+ *      -   @ref hashtable != NULL
+ *      -   @ref hashcode == @ref hashtable_hash_key(hashtable, key)
+ *
+ * Time complexity:
+ *      -   O(n/m), where m == number of buckets in bucket array
+ *
+ * @param hashtable             The @ref HashTable to be operated on.
+ * @param key                   The key used for lookup.
+ * @param hashcode              The precomputed hashcode of the @ref key.
+ */
+void hashtable_remove_key_hashed(HashTable *hashtable, const void *key, size_t hashcode);
+
 /**
  * Removes all the @ref HashTableNode's from the @ref hashtable. If the @ref hashtable is empty, this function
  * simply returns.
@@ -409,6 +662,14 @@ void hashtable_remove_all(HashTable *hashtable);
  */
 #define HASHTABLE_POISON_NEXT ((HashTableNode*) 0x100)
 
+/**
+ * How many buckets ahead @ref hashtable_for_each_prefetch prefetches the first @ref HashTableNode of a
+ * bucket. Can be overridden by defining it before including this header.
+ */
+#ifndef HASHTABLE_PREFETCH_DISTANCE
+    #define HASHTABLE_PREFETCH_DISTANCE 16
+#endif
+
 /**
  * Initializing a @ref HashTableNode before it is used is NOT required. This macro is simply for allowing you
  * to initialize a struct (containing one or more @ref HashTableNode's) with an initializer-list conveniently.
@@ -463,6 +724,45 @@ void hashtable_remove_all(HashTable *hashtable);
             cursor_node_ptr = cursor_node_ptr->next \
         )
 
+/**
+ * Iterates over the @ref HashTable, and prefetches the first @ref HashTableNode of the bucket
+ * @ref HASHTABLE_PREFETCH_DISTANCE buckets ahead, as well as the next @ref HashTableNode in the current
+ * bucket. Since the bucket array is read sequentially, the first @ref HashTableNode's of upcoming buckets are
+ * known in advance, and their cache misses overlap with each other instead of being taken one at a time.
+ * Without GNU extensions, this is simply @ref hashtable_for_each.
+ *
+ * Requirements:
+ *      -   @ref hashtable_ptr != NULL
+ *      -   The @ref cursor_node_ptr is neither reassigned nor removed from its associated @ref HashTable in
+ *          the loop's body.
+ *      -   The @ref bucket_index is not reassigned.
+ *
+ * @param cursor_node_ptr       The @ref HashTableNode to use as a loop cursor.
+ * @param bucket_index          The integer to use to keep track of the current bucket index.
+ * @param hashtable_ptr         The pointer to a @ref HashTable that will be iterated over.
+ */
+#if defined(__GNUC__) && !defined(__STRICT_ANSI__)
+    #define hashtable_for_each_prefetch(cursor_node_ptr, bucket_index, hashtable_ptr) \
+        for ( \
+            bucket_index = 0; \
+            bucket_index < (hashtable_ptr)->num_buckets; \
+            ++bucket_index \
+        ) \
+            for ( \
+                cursor_node_ptr = (hashtable_ptr)->bucket_array[bucket_index], \
+                __builtin_prefetch( \
+                    bucket_index + HASHTABLE_PREFETCH_DISTANCE < (hashtable_ptr)->num_buckets \
+                        ? (hashtable_ptr)->bucket_array[bucket_index + HASHTABLE_PREFETCH_DISTANCE] \
+                        : NULL \
+                ); \
+                cursor_node_ptr && (__builtin_prefetch(cursor_node_ptr->next), 1); \
+                cursor_node_ptr = cursor_node_ptr->next \
+            )
+#else
+    #define hashtable_for_each_prefetch(cursor_node_ptr, bucket_index, hashtable_ptr) \
+        hashtable_for_each(cursor_node_ptr, bucket_index, hashtable_ptr)
+#endif
+
 /**
  * Iterates over the @ref HashTable, and is safe against reassignment and/or removal of the
  * @ref cursor_node_ptr.
@@ -508,8 +808,27 @@ void hashtable_remove_all(HashTable *hashtable);
  * @param hashtable_ptr         The pointer to a @ref HashTable that will be iterated over.
  */
 #define hashtable_for_each_possible(cursor_node_ptr, key_ptr, hashtable_ptr) \
+    hashtable_for_each_possible_hashed( \
+        cursor_node_ptr, hashtable_hash_key((hashtable_ptr), (key_ptr)), hashtable_ptr \
+    )
+
+/**
+ * Iterates over all possible @ref HashTableNode's hashing to the bucket of the @ref hashcode in the
+ * @ref HashTable. Unlike @ref hashtable_for_each_possible, the key is not hashed again.
+ *
+ * Requirements:
+ *      -   @ref hashtable_ptr != NULL
+ *      -   @ref hashcode is the hashcode of the key (see @ref hashtable_hash_key)
+ *      -   The @ref cursor_node_ptr is neither reassigned nor removed from its associated @ref HashTable in
+ *          the loop's body.
+ *
+ * @param cursor_node_ptr       The @ref HashTableNode to use as a loop cursor.
+ * @param hashcode              The hashcode used to determine which bucket will be iterated over.
+ * @param hashtable_ptr         The pointer to a @ref HashTable that will be iterated over.
+ */
+#define hashtable_for_each_possible_hashed(cursor_node_ptr, hashcode, hashtable_ptr) \
     for ( \
-        cursor_node_ptr = (hashtable_ptr)->bucket_array[(hashtable_ptr)->hash((key_ptr)) % (hashtable_ptr)->num_buckets]; \
+        cursor_node_ptr = (hashtable_ptr)->bucket_array[(hashcode) % (hashtable_ptr)->num_buckets]; \
         cursor_node_ptr; \
         cursor_node_ptr = cursor_node_ptr->next \
     )
@@ -530,8 +849,30 @@ void hashtable_remove_all(HashTable *hashtable);
  * @param hashtable_ptr         The pointer to a @ref HashTable that will be iterated over.
  */
 #define hashtable_for_each_possible_safe(cursor_node_ptr, backup_node_ptr, key_ptr, hashtable_ptr) \
+    hashtable_for_each_possible_safe_hashed( \
+        cursor_node_ptr, backup_node_ptr, hashtable_hash_key((hashtable_ptr), (key_ptr)), hashtable_ptr \
+    )
+
+/**
+ * Iterates over all possible @ref HashTableNode's hashing to the bucket of the @ref hashcode in the
+ * @ref HashTable, and is safe against reassignment and/or removal of the @ref cursor_node_ptr. Unlike
+ * @ref hashtable_for_each_possible_safe, the key is not hashed again.
+ *
+ * Requirements:
+ *      -   @ref hashtable_ptr != NULL
+ *      -   @ref hashcode is the hashcode of the key (see @ref hashtable_hash_key)
+ *      -   The @ref backup_node_ptr is neither reassigned nor removed from its associated @ref HashTable in
+ *          the loop's body.
+ *      -   @ref backup_node_ptr and @ref cursor_node_ptr are not the same variable.
+ *
+ * @param cursor_node_ptr       The @ref HashTableNode to use as a loop cursor.
+ * @param backup_node_ptr       Another @ref HashTableNode to use as a temporary storage.
+ * @param hashcode              The hashcode used to determine which bucket will be iterated over.
+ * @param hashtable_ptr         The pointer to a @ref HashTable that will be iterated over.
+ */
+#define hashtable_for_each_possible_safe_hashed(cursor_node_ptr, backup_node_ptr, hashcode, hashtable_ptr) \
     for ( \
-        cursor_node_ptr = (hashtable_ptr)->bucket_array[(hashtable_ptr)->hash((key_ptr)) % (hashtable_ptr)->num_buckets], \
+        cursor_node_ptr = (hashtable_ptr)->bucket_array[(hashcode) % (hashtable_ptr)->num_buckets], \
         backup_node_ptr = cursor_node_ptr ? cursor_node_ptr->next : NULL; \
         \
         cursor_node_ptr; \
@@ -0,0 +1,280 @@
+/*
+Copyright (c) 2017, Michael J Welsh
+
+Permission to use, copy, modify, and/or distribute this software
+for any purpose with or without fee is hereby granted, provided
+that the above copyright notice and this permission notice appear
+in all copies.
+
+THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL
+WARRANTIES WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE
+AUTHOR BE LIABLE FOR ANY SPECIAL, DIRECT, INDIRECT, OR
+CONSEQUENTIAL DAMAGES OR ANY DAMAGES WHATSOEVER RESULTING FROM
+LOSS OF USE, DATA OR PROFITS, WHETHER IN AN ACTION OF CONTRACT,
+NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF OR IN
+CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+
+#include <assert.h>
+#include <stddef.h>
+#include <string.h>
+
+#include "hashtable_snapshot.h"
+
+/* ========================================================================================================
+ *
+ *                                        STATIC FUNCTION PROTOTYPES
+ *
+ * ======================================================================================================== */
+
+/*
+ * Returns the offset of the first record in a snapshot with @ref num_buckets buckets, i.e. the size of the
+ * header and bucket array, rounded up to @ref HASHTABLE_SNAPSHOT_ALIGNMENT.
+ */
+static size_t records_offset(size_t num_buckets);
+
+/*
+ * Returns the bucket array of the @ref snapshot, as offsets.
+ */
+static size_t* snapshot_buckets(const void *snapshot);
+
+/*
+ * Returns the offset stored in the "next" member of the @ref node, which is inside a snapshot that has not
+ * been loaded.
+ */
+static size_t next_offset(const HashTableNode *node);
+
+/* ========================================================================================================
+ *
+ *                                        STATIC FUNCTION DEFINITIONS
+ *
+ * ======================================================================================================== */
+
+static size_t records_offset(size_t num_buckets) {
+    size_t offset = sizeof(HashTableSnapshot) + num_buckets * sizeof(size_t);
+
+    return (offset + HASHTABLE_SNAPSHOT_ALIGNMENT - 1) / HASHTABLE_SNAPSHOT_ALIGNMENT
+        * HASHTABLE_SNAPSHOT_ALIGNMENT;
+}
+
+static size_t* snapshot_buckets(const void *snapshot) {
+    assert(snapshot);
+
+    return (size_t*) ((char*) snapshot + sizeof(HashTableSnapshot));
+}
+
+static size_t next_offset(const HashTableNode *node) {
+    size_t offset;
+
+    assert(node);
+
+    /* The "next" member holds an offset, not a pointer, so it is copied rather than read. */
+    memcpy(&offset, &node->next, sizeof(offset));
+    return offset;
+}
+
+/* ========================================================================================================
+ *
+ *                                        EXTERN FUNCTION DEFINITIONS
+ *
+ * ======================================================================================================== */
+
+size_t hashtable_snapshot_bytes(const HashTable *hashtable, size_t record_size) {
+    assert(hashtable && record_size > 0 && record_size % sizeof(HashTableNode*) == 0);
+
+    return records_offset(hashtable->num_buckets) + hashtable->size * record_size;
+}
+
+void hashtable_snapshot_write(
+    const HashTable *hashtable,
+    void *buffer,
+    size_t record_size,
+    size_t node_offset
+) {
+    HashTableSnapshot *header = (HashTableSnapshot*) buffer;
+    size_t *buckets, i, offset, next;
+    const HashTableNode *n;
+    char *record;
+
+    assert(hashtable && buffer && record_size > 0 && record_size % sizeof(HashTableNode*) == 0);
+    assert(node_offset + sizeof(HashTableNode) <= record_size && sizeof(size_t) == sizeof(HashTableNode*));
+
+    header->magic = HASHTABLE_SNAPSHOT_MAGIC;
+    header->snapshot_size = hashtable_snapshot_bytes(hashtable, record_size);
+    header->record_size = record_size;
+    header->node_offset = node_offset;
+    header->num_buckets = hashtable->num_buckets;
+    header->size = hashtable->size;
+    header->records_offset = records_offset(hashtable->num_buckets);
+
+    buckets = snapshot_buckets(buffer);
+    offset = header->records_offset + node_offset;
+    record = (char*) buffer + header->records_offset;
+
+    /* The records of each bucket are written one after the other, so every offset is the next record's. */
+    for (i = 0; i < hashtable->num_buckets; ++i) {
+        n = hashtable->bucket_array[i];
+        buckets[i] = n ? offset : 0;
+
+        for (; n; n = n->next, record += record_size) {
+            memcpy(record, (const char*) n - node_offset, record_size);
+            offset += record_size;
+            next = n->next ? offset : 0;
+            memcpy(record + node_offset, &next, sizeof(next));
+        }
+    }
+}
+
+int hashtable_snapshot_check(
+    const HashTable *hashtable,
+    const void *snapshot,
+    size_t snapshot_size,
+    const void* (*node_key)(const HashTableNode *node)
+) {
+    const HashTableSnapshot *header = (const HashTableSnapshot*) snapshot;
+    const HashTableNode *n;
+    const size_t *buckets;
+    size_t i, offset, expected, end;
+    const void *key;
+
+    assert(hashtable && snapshot && sizeof(size_t) == sizeof(HashTableNode*));
+
+    if (snapshot_size < sizeof(HashTableSnapshot) || header->magic != HASHTABLE_SNAPSHOT_MAGIC) {
+        return 0;
+    }
+
+    /* Every size is checked against the ones before it, so that none of the arithmetic can overflow. */
+    if (
+        header->snapshot_size > snapshot_size ||
+        header->snapshot_size < sizeof(HashTableSnapshot) ||
+        header->record_size == 0 ||
+        header->record_size % sizeof(HashTableNode*) != 0 ||
+        header->node_offset % sizeof(HashTableNode*) != 0 ||
+        header->node_offset >= header->record_size ||
+        header->num_buckets == 0 ||
+        header->num_buckets > (header->snapshot_size - sizeof(HashTableSnapshot)) / sizeof(size_t) ||
+        header->records_offset != records_offset(header->num_buckets) ||
+        header->records_offset > header->snapshot_size ||
+        header->size != (header->snapshot_size - header->records_offset) / header->record_size ||
+        header->size * header->record_size != header->snapshot_size - header->records_offset
+    ) {
+        return 0;
+    }
+
+    buckets = snapshot_buckets(snapshot);
+    expected = header->records_offset + header->node_offset;
+    end = expected + header->size * header->record_size;
+
+    for (i = 0; i < header->num_buckets; ++i) {
+        for (offset = buckets[i]; offset != 0; offset = next_offset(n)) {
+            if (offset != expected || offset == end) {
+                return 0;
+            }
+
+            n = (const HashTableNode*) ((const char*) snapshot + offset);
+
+            if (node_key) {
+                key = node_key(n);
+
+                if (
+                    hashtable_hash_key(hashtable, key) % header->num_buckets != i ||
+                    !hashtable->equal(key, n)
+                ) {
+                    return 0;
+                }
+            }
+
+            expected += header->record_size;
+        }
+    }
+
+    return expected == end;
+}
+
+int hashtable_snapshot_load(
+    HashTable *hashtable,
+    void *snapshot,
+    size_t snapshot_size,
+    const void* (*node_key)(const HashTableNode *node)
+) {
+    HashTableSnapshot *header = (HashTableSnapshot*) snapshot;
+    HashTableNode *n;
+    size_t *buckets, i, offset;
+    char *base = (char*) snapshot;
+
+    assert(hashtable && hashtable->size == 0 && snapshot);
+
+    if (!hashtable_snapshot_check(hashtable, snapshot, snapshot_size, node_key)) {
+        return 0;
+    }
+
+    buckets = snapshot_buckets(snapshot);
+
+    for (i = 0; i < header->num_buckets; ++i) {
+        n = buckets[i] ? (HashTableNode*) (base + buckets[i]) : NULL;
+        memcpy(&buckets[i], &n, sizeof(n));
+    }
+
+    for (i = 0; i < header->size; ++i) {
+        n = (HashTableNode*) (base + header->records_offset + i * header->record_size + header->node_offset);
+        offset = next_offset(n);
+        n->next = offset ? (HashTableNode*) (base + offset) : NULL;
+    }
+
+    /* The offsets are gone, so the snapshot must not pass hashtable_snapshot_check anymore. */
+    header->magic = 0;
+
+    hashtable->bucket_array = (HashTableNode**) (void*) buckets;
+    hashtable->num_buckets = header->num_buckets;
+    hashtable->size = header->size;
+
+    return 1;
+}
+
+size_t hashtable_snapshot_num_buckets(const void *snapshot) {
+    assert(snapshot && ((const HashTableSnapshot*) snapshot)->magic == HASHTABLE_SNAPSHOT_MAGIC);
+
+    return ((const HashTableSnapshot*) snapshot)->num_buckets;
+}
+
+size_t hashtable_snapshot_size(const void *snapshot) {
+    assert(snapshot && ((const HashTableSnapshot*) snapshot)->magic == HASHTABLE_SNAPSHOT_MAGIC);
+
+    return ((const HashTableSnapshot*) snapshot)->size;
+}
+
+const HashTableNode* hashtable_snapshot_lookup_key(
+    const HashTable *hashtable,
+    const void *snapshot,
+    const void *key
+) {
+    assert(hashtable && snapshot);
+
+    return hashtable_snapshot_lookup_key_hashed(hashtable, snapshot, key, hashtable_hash_key(hashtable, key));
+}
+
+const HashTableNode* hashtable_snapshot_lookup_key_hashed(
+    const HashTable *hashtable,
+    const void *snapshot,
+    const void *key,
+    size_t hashcode
+) {
+    const HashTableSnapshot *header = (const HashTableSnapshot*) snapshot;
+    const HashTableNode *n;
+    size_t offset;
+
+    assert(hashtable && snapshot && header->magic == HASHTABLE_SNAPSHOT_MAGIC);
+
+    offset = snapshot_buckets(snapshot)[hashcode % header->num_buckets];
+
+    for (; offset; offset = next_offset(n)) {
+        n = (const HashTableNode*) ((const char*) snapshot + offset);
+
+        if (hashtable->equal(key, n)) {
+            return n;
+        }
+    }
+
+    return NULL;
+}
@@ -0,0 +1,385 @@
+/*
+Copyright (c) 2017, Michael J Welsh
+
+Permission to use, copy, modify, and/or distribute this software
+for any purpose with or without fee is hereby granted, provided
+that the above copyright notice and this permission notice appear
+in all copies.
+
+THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL
+WARRANTIES WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE
+AUTHOR BE LIABLE FOR ANY SPECIAL, DIRECT, INDIRECT, OR
+CONSEQUENTIAL DAMAGES OR ANY DAMAGES WHATSOEVER RESULTING FROM
+LOSS OF USE, DATA OR PROFITS, WHETHER IN AN ACTION OF CONTRACT,
+NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF OR IN
+CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+
+/**
+ * @file    hashtable_snapshot.h
+ * @brief   HASH TABLE SNAPSHOT
+ *
+ * A snapshot is a single block of memory holding a copy of a @ref HashTable: a @ref HashTableSnapshot
+ * header, the bucket array, and a copy of every struct a @ref HashTableNode is embedded in (a "record"), with
+ * byte offsets from the start of the snapshot in place of pointers. Since a snapshot contains no pointers, it
+ * can be written to a file and mapped back into memory (e.g. with mmap()) by another process, which avoids
+ * rebuilding a large @ref HashTable from its original source on startup.
+ *
+ * Every record MUST have the same size, and MUST NOT contain pointers other than the "next" member of its
+ * @ref HashTableNode (e.g. fixed-size keys and values only). The records of a bucket are stored next to each
+ * other, in bucket order, so walking a chain reads memory sequentially.
+ *
+ * A mapped snapshot can be used in two ways, both of which use the hash, equal and seeded hash functions of a
+ * @ref HashTable set up by the user. No bucket array or @ref HashTableNode is ever allocated:
+ *      -   @ref hashtable_snapshot_load converts the offsets into pointers in one linear pass over the
+ *          snapshot, and makes the @ref HashTable use the bucket array and records inside the snapshot. The
+ *          snapshot must be writable (e.g. mapped with MAP_PRIVATE), and the @ref HashTable can then be used
+ *          like any other, insertions and removals included.
+ *      -   @ref hashtable_snapshot_lookup_key follows the offsets directly, so the snapshot can stay
+ *          read-only and be shared by several processes. Nothing is done before the first lookup except
+ *          @ref hashtable_snapshot_check.
+ *
+ * A snapshot is only valid for the platform it was written on (byte order, size of pointers, struct layout)
+ * and for the same hash function and seed, since the bucket of each record is NOT recomputed.
+ * @ref hashtable_snapshot_check rejects a snapshot whose header or offsets are inconsistent, and, given a
+ * node_key function returning the key of a @ref HashTableNode, one whose records are not found by the hash
+ * and equal functions of the @ref HashTable (e.g. because the hash function or seed changed).
+ *
+ * Example:
+ *          struct Object {
+ *              int key;
+ *              int val;
+ *              HashTableNode n;
+ *          };
+ *
+ *          size_t hash(const void *key) {
+ *              return *(const int*)key;
+ *          }
+ *
+ *          int equal(const void *key, const HashTableNode *node) {
+ *              return *(const int*)key == hashtable_entry(node, struct Object, n)->key;
+ *          }
+ *
+ *          int main(void) {
+ *              struct Object objs[100];
+ *              HashTable hashtable, loaded;
+ *              HashTableNode *bucket_array[50], *loaded_bucket;
+ *              size_t size;
+ *              void *snapshot;
+ *              int i;
+ *
+ *              hashtable_init(&hashtable, bucket_array, 50, hash, equal, NULL, NULL);
+ *              for (i = 0; i < 100; ++i) {
+ *                  objs[i].key = i;
+ *                  objs[i].val = i * i;
+ *                  hashtable_insert(&hashtable, &objs[i].key, &objs[i].n);
+ *              }
+ *
+ *              size = hashtable_snapshot_bytes(&hashtable, sizeof(struct Object));
+ *              snapshot = malloc(size);
+ *              hashtable_snapshot_write(
+ *                  &hashtable, snapshot, sizeof(struct Object), offsetof(struct Object, n)
+ *              );
+ *
+ *              hashtable_init(&loaded, &loaded_bucket, 1, hash, equal, NULL, NULL);
+ *              if (hashtable_snapshot_load(&loaded, snapshot, size, NULL)) {
+ *                  i = 10;
+ *                  assert(hashtable_entry(hashtable_lookup_key(&loaded, &i), struct Object, n)->val == 100);
+ *              }
+ *
+ *              free(snapshot);
+ *              return 0;
+ *          }
+ *
+ * Dependencies:
+ *      -   C89 assert.h
+ *      -   C89 stddef.h
+ *      -   C89 string.h
+ *      -   hashtable.h/hashtable.c
+ *
+ * API:
+ *      ====  TYPES  ====
+ *      -   typedef struct HashTableSnapshot HashTableSnapshot
+ *
+ *      ====  FUNCTIONS  ====
+ *      Writing:
+ *          -   hashtable_snapshot_bytes
+ *          -   hashtable_snapshot_write
+ *      Loading:
+ *          -   hashtable_snapshot_check
+ *          -   hashtable_snapshot_load
+ *      Properties:
+ *          -   hashtable_snapshot_num_buckets
+ *          -   hashtable_snapshot_size
+ *      Lookup:
+ *          -   hashtable_snapshot_lookup_key
+ *          -   hashtable_snapshot_lookup_key_hashed
+ *
+ *      ====  MACROS  ====
+ *      Constants:
+ *          -   HASHTABLE_SNAPSHOT_MAGIC
+ *          -   HASHTABLE_SNAPSHOT_ALIGNMENT
+ */
+
+#ifndef HASHTABLE_SNAPSHOT_H
+#define HASHTABLE_SNAPSHOT_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif /* __cplusplus */
+
+#include <stddef.h>
+
+#include "hashtable.h"
+
+/* ========================================================================================================
+ *
+ *                                                  TYPES
+ *
+ * ======================================================================================================== */
+
+/* Struct type declarations. */
+struct HashTableSnapshot;
+
+/* Struct typedef's. */
+typedef struct HashTableSnapshot HashTableSnapshot;
+
+/**
+ * Represents the header at the start of a snapshot. It is followed by the bucket array (one offset per
+ * bucket, 0 for an empty bucket), then, at @ref records_offset, by the records. Every offset is counted in
+ * bytes from the start of the snapshot, and points to a @ref HashTableNode.
+ */
+struct HashTableSnapshot {
+    size_t magic;
+    size_t snapshot_size;
+    size_t record_size;
+    size_t node_offset;
+    size_t num_buckets;
+    size_t size;
+    size_t records_offset;
+};
+
+/* ========================================================================================================
+ *
+ *                                               PROTOTYPES
+ *
+ * ======================================================================================================== */
+
+/**
+ * Returns the size in bytes of a snapshot of the @ref hashtable.
+ *
+ * Requirements:
+ *      -   @ref hashtable != NULL
+ *      -   @ref record_size > 0
+ *      -   @ref record_size is a multiple of sizeof(HashTableNode*)
+ *
+ * Time complexity:
+ *      -   O(1)
+ *
+ * @param hashtable             The @ref HashTable to be written.
+ * @param record_size           The size of the struct every @ref HashTableNode is embedded in.
+ * @return                      The size in bytes of a snapshot of the @ref hashtable.
+ */
+size_t hashtable_snapshot_bytes(const HashTable *hashtable, size_t record_size);
+
+/**
+ * Writes a snapshot of the @ref hashtable into the @ref buffer, which can then be written to a file. The
+ * @ref hashtable is left untouched.
+ *
+ * Requirements:
+ *      -   @ref hashtable != NULL
+ *      -   @ref buffer != NULL
+ *      -   @ref buffer is aligned to @ref HASHTABLE_SNAPSHOT_ALIGNMENT bytes (e.g. returned by malloc())
+ *      -   @ref buffer holds at least @ref hashtable_snapshot_bytes(hashtable, record_size) bytes
+ *      -   @ref record_size > 0
+ *      -   @ref record_size is a multiple of sizeof(HashTableNode*)
+ *      -   @ref node_offset + sizeof(HashTableNode) <= @ref record_size
+ *      -   Every @ref HashTableNode in the @ref hashtable is embedded in a struct of @ref record_size bytes,
+ *          at @ref node_offset bytes from its start
+ *
+ * Time complexity:
+ *      -   O(n * r + m), where r == @ref record_size and m == number of buckets in bucket array
+ *
+ * @param hashtable             The @ref HashTable to be written.
+ * @param buffer                The memory the snapshot is written to.
+ * @param record_size           The size of the struct every @ref HashTableNode is embedded in.
+ * @param node_offset           The offset of the @ref HashTableNode within its struct (see offsetof).
+ */
+void hashtable_snapshot_write(
+    const HashTable *hashtable,
+    void *buffer,
+    size_t record_size,
+    size_t node_offset
+);
+
+/**
+ * Returns whether or not the @ref snapshot is a consistent snapshot that can be used with the
+ * @ref hashtable: the header matches this platform and the @ref snapshot_size, and every offset points to
+ * the next record in order. If @ref node_key is non-NULL, every record must also be in the bucket the
+ * @ref hashtable hashes its key to, and be equal to its key according to the @ref hashtable. Call this once
+ * before using @ref hashtable_snapshot_lookup_key on a @ref snapshot that was read from a file.
+ *
+ * Requirements:
+ *      -   @ref hashtable != NULL
+ *      -   @ref snapshot != NULL
+ *      -   @ref snapshot is aligned to @ref HASHTABLE_SNAPSHOT_ALIGNMENT bytes (e.g. mapped with mmap())
+ *
+ * Time complexity:
+ *      -   O(n + m), where m == number of buckets in the @ref snapshot, and assuming node_key, hash and equal
+ *          are O(1)
+ *
+ * @param hashtable             The @ref HashTable whose hash and equal functions are used.
+ * @param snapshot              The snapshot to be checked.
+ * @param snapshot_size         The size in bytes of the memory holding the @ref snapshot (e.g. of the file).
+ * @param node_key              The OPTIONAL (i.e. can be NULL) callback function returning the key of a
+ *                              @ref HashTableNode.
+ * @return                      Whether or not the @ref snapshot is consistent.
+ */
+int hashtable_snapshot_check(
+    const HashTable *hashtable,
+    const void *snapshot,
+    size_t snapshot_size,
+    const void* (*node_key)(const HashTableNode *node)
+);
+
+/**
+ * Checks the @ref snapshot like @ref hashtable_snapshot_check, then converts its offsets into pointers in
+ * place, and makes the @ref hashtable use the bucket array and @ref HashTableNode's inside the
+ * @ref snapshot. The @ref snapshot must outlive its use by the @ref hashtable, and can NOT be loaded again
+ * nor used with @ref hashtable_snapshot_lookup_key afterwards. If the @ref snapshot is inconsistent, neither
+ * the @ref snapshot nor the @ref hashtable are modified.
+ *
+ * Requirements:
+ *      -   @ref hashtable != NULL
+ *      -   @ref hashtable is empty
+ *      -   @ref snapshot != NULL
+ *      -   @ref snapshot is aligned to @ref HASHTABLE_SNAPSHOT_ALIGNMENT bytes (e.g. mapped with mmap())
+ *      -   @ref snapshot is writable
+ *
+ * Time complexity:
+ *      -   O(n + m), where m == number of buckets in the @ref snapshot, and assuming node_key, hash and equal
+ *          are O(1)
+ *
+ * @param hashtable             The empty @ref HashTable that will use the @ref snapshot. Only its bucket
+ *                              array, number of buckets and size are changed.
+ * @param snapshot              The snapshot to be loaded.
+ * @param snapshot_size         The size in bytes of the memory holding the @ref snapshot (e.g. of the file).
+ * @param node_key              The OPTIONAL (i.e. can be NULL) callback function returning the key of a
+ *                              @ref HashTableNode, see @ref hashtable_snapshot_check.
+ * @return                      1 if the @ref snapshot was loaded; otherwise, 0.
+ */
+int hashtable_snapshot_load(
+    HashTable *hashtable,
+    void *snapshot,
+    size_t snapshot_size,
+    const void* (*node_key)(const HashTableNode *node)
+);
+
+/**
+ * Returns the number of buckets in the bucket array of the @ref snapshot.
+ *
+ * Requirements:
+ *      -   @ref snapshot != NULL
+ *      -   @ref snapshot passed @ref hashtable_snapshot_check
+ *
+ * Time complexity:
+ *      -   O(1)
+ *
+ * @param snapshot              The snapshot whose number of buckets will be returned.
+ * @return                      The number of buckets in the @ref snapshot.
+ */
+size_t hashtable_snapshot_num_buckets(const void *snapshot);
+
+/**
+ * Returns the number of @ref HashTableNode's in the @ref snapshot.
+ *
+ * Requirements:
+ *      -   @ref snapshot != NULL
+ *      -   @ref snapshot passed @ref hashtable_snapshot_check
+ *
+ * Time complexity:
+ *      -   O(1)
+ *
+ * @param snapshot              The snapshot whose size will be returned.
+ * @return                      The number of @ref HashTableNode's in the @ref snapshot.
+ */
+size_t hashtable_snapshot_size(const void *snapshot);
+
+/**
+ * Returns the @ref HashTableNode associated with the @ref key in the @ref snapshot, following the offsets of
+ * the @ref snapshot without modifying it. The "next" member of the returned @ref HashTableNode holds an
+ * offset and must NOT be used.
+ *
+ * Requirements:
+ *      -   @ref hashtable != NULL
+ *      -   @ref snapshot != NULL
+ *      -   @ref snapshot passed @ref hashtable_snapshot_check
+ *
+ * Time complexity:
+ *      -   O(n/m), where m == number of buckets in the @ref snapshot
+ *
+ * @param hashtable             The @ref HashTable whose hash and equal functions are used.
+ * @param snapshot              The snapshot to be searched.
+ * @param key                   The key used for lookup.
+ * @return                      NULL if the @ref snapshot does not contain a @ref HashTableNode associated
+ *                              with the @ref key; otherwise, the @ref HashTableNode inside the
+ *                              @ref snapshot.
+ */
+const HashTableNode* hashtable_snapshot_lookup_key(
+    const HashTable *hashtable,
+    const void *snapshot,
+    const void *key
+);
+
+/**
+ * Same as @ref hashtable_snapshot_lookup_key, but uses the precomputed @ref hashcode of the @ref key instead
+ * of hashing the @ref key again.
+ *
+ * Requirements:
+ *      -   @ref hashtable != NULL
+ *      -   @ref snapshot != NULL
+ *      -   @ref snapshot passed @ref hashtable_snapshot_check
+ *      -   @ref hashcode == @ref hashtable_hash_key(hashtable, key)
+ *
+ * Time complexity:
+ *      -   O(n/m), where m == number of buckets in the @ref snapshot
+ *
+ * @param hashtable             The @ref HashTable whose equal function is used.
+ * @param snapshot              The snapshot to be searched.
+ * @param key                   The key used for lookup.
+ * @param hashcode              The precomputed hashcode of the @ref key.
+ * @return                      NULL if the @ref snapshot does not contain a @ref HashTableNode associated
+ *                              with the @ref key; otherwise, the @ref HashTableNode inside the
+ *                              @ref snapshot.
+ */
+const HashTableNode* hashtable_snapshot_lookup_key_hashed(
+    const HashTable *hashtable,
+    const void *snapshot,
+    const void *key,
+    size_t hashcode
+);
+
+/* ========================================================================================================
+ *
+ *                                                 MACROS
+ *
+ * ======================================================================================================== */
+
+/**
+ * The first member of every @ref HashTableSnapshot, "HTS1" in ASCII. A snapshot written on a platform with a
+ * different byte order or size_t width does not start with this value, and is rejected.
+ */
+#define HASHTABLE_SNAPSHOT_MAGIC ((size_t) 0x48545331UL)
+
+/**
+ * The alignment in bytes of the records in a snapshot, relative to its start. Records whose struct needs a
+ * larger alignment are NOT supported.
+ */
+#define HASHTABLE_SNAPSHOT_ALIGNMENT 16
+
+#ifdef __cplusplus
+}
+#endif /* __cplusplus */
+
+#endif /* HASHTABLE_SNAPSHOT_H */
@@ -0,0 +1,218 @@
+/*
+Copyright (c) 2017, Michael J Welsh
+
+Permission to use, copy, modify, and/or distribute this software
+for any purpose with or without fee is hereby granted, provided
+that the above copyright notice and this permission notice appear
+in all copies.
+
+THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL
+WARRANTIES WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE
+AUTHOR BE LIABLE FOR ANY SPECIAL, DIRECT, INDIRECT, OR
+CONSEQUENTIAL DAMAGES OR ANY DAMAGES WHATSOEVER RESULTING FROM
+LOSS OF USE, DATA OR PROFITS, WHETHER IN AN ACTION OF CONTRACT,
+NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF OR IN
+CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+
+#include <assert.h>
+#include <stddef.h>
+
+#include "heap.h"
+
+/* ========================================================================================================
+ *
+ *                                        STATIC FUNCTION PROTOTYPES
+ *
+ * ======================================================================================================== */
+
+/*
+ * Places the @ref node into the @ref heap at the @ref index or above it, moving the ancestors with greater
+ * keys down one level.
+ */
+static void sift_up(Heap *heap, HeapNode *node, size_t index);
+
+/*
+ * Places the @ref node into the @ref heap at the @ref index or below it, moving the smallest child up one
+ * level while it has a smaller key than the @ref node.
+ */
+static void sift_down(Heap *heap, HeapNode *node, size_t index);
+
+/* ========================================================================================================
+ *
+ *                                        STATIC FUNCTION DEFINITIONS
+ *
+ * ======================================================================================================== */
+
+static void sift_up(Heap *heap, HeapNode *node, size_t index) {
+    assert(heap && node && index < heap->size);
+
+    while (index > 0) {
+        size_t parent = (index - 1) / HEAP_ARITY;
+
+        if (heap->compare(node, heap->nodes[parent]) >= 0) {
+            break;
+        }
+
+        heap->nodes[index] = heap->nodes[parent];
+        heap->nodes[index]->index = index;
+        index = parent;
+    }
+
+    heap->nodes[index] = node;
+    node->index = index;
+}
+
+static void sift_down(Heap *heap, HeapNode *node, size_t index) {
+    assert(heap && node && index < heap->size);
+
+    for ( ; ; ) {
+        size_t first = HEAP_ARITY * index + 1, last, best, i;
+
+        if (first >= heap->size) {
+            break;
+        }
+
+        last = heap->size - first < HEAP_ARITY ? heap->size : first + HEAP_ARITY;
+
+        for (best = first, i = first + 1; i < last; ++i) {
+            if (heap->compare(heap->nodes[i], heap->nodes[best]) < 0) {
+                best = i;
+            }
+        }
+
+        if (heap->compare(heap->nodes[best], node) >= 0) {
+            break;
+        }
+
+        heap->nodes[index] = heap->nodes[best];
+        heap->nodes[index]->index = index;
+        index = best;
+    }
+
+    heap->nodes[index] = node;
+    node->index = index;
+}
+
+/* ========================================================================================================
+ *
+ *                                        EXTERN FUNCTION DEFINITIONS
+ *
+ * ======================================================================================================== */
+
+void heap_init(
+    Heap *heap,
+    HeapNode **node_array,
+    size_t capacity,
+    int (*compare)(const HeapNode *a, const HeapNode *b)
+) {
+    assert(heap && (node_array || capacity == 0) && compare);
+
+    heap->nodes = node_array;
+    heap->size = 0;
+    heap->capacity = capacity;
+    heap->compare = compare;
+}
+
+void heap_set_array(Heap *heap, HeapNode **node_array, size_t capacity) {
+    size_t i;
+
+    assert(heap && (node_array || capacity == 0) && capacity >= heap->size);
+
+    for (i = 0; i < heap->size; ++i) {
+        node_array[i] = heap->nodes[i];
+    }
+
+    heap->nodes = node_array;
+    heap->capacity = capacity;
+}
+
+HeapNode* heap_peek(const Heap *heap) {
+    assert(heap);
+
+    return heap->size ? heap->nodes[0] : NULL;
+}
+
+size_t heap_size(const Heap *heap) {
+    assert(heap);
+
+    return heap->size;
+}
+
+size_t heap_capacity(const Heap *heap) {
+    assert(heap);
+
+    return heap->capacity;
+}
+
+int heap_empty(const Heap *heap) {
+    assert(heap);
+
+    return heap->size == 0;
+}
+
+void heap_push(Heap *heap, HeapNode *node) {
+    assert(heap && node && heap->size < heap->capacity);
+
+    ++heap->size;
+    sift_up(heap, node, heap->size - 1);
+}
+
+void heap_update(Heap *heap, HeapNode *node) {
+    size_t index;
+
+    assert(heap && node && node->index < heap->size && heap->nodes[node->index] == node);
+
+    index = node->index;
+
+    if (index > 0 && heap->compare(node, heap->nodes[(index - 1) / HEAP_ARITY]) < 0) {
+        sift_up(heap, node, index);
+    } else {
+        sift_down(heap, node, index);
+    }
+}
+
+HeapNode* heap_pop(Heap *heap) {
+    HeapNode *node;
+
+    assert(heap);
+
+    if (!heap->size) {
+        return NULL;
+    }
+
+    node = heap->nodes[0];
+    heap_remove(heap, node);
+
+    return node;
+}
+
+void heap_remove(Heap *heap, HeapNode *node) {
+    HeapNode *last;
+
+    assert(heap && node && node->index < heap->size && heap->nodes[node->index] == node);
+
+    last = heap->nodes[--heap->size];
+
+    /* The last HeapNode fills the hole, and then moves up or down from there. */
+    if (last != node) {
+        heap->nodes[node->index] = last;
+        last->index = node->index;
+        heap_update(heap, last);
+    }
+
+    node->index = HEAP_POISON_INDEX;
+}
+
+void heap_remove_all(Heap *heap) {
+    size_t i;
+
+    assert(heap);
+
+    for (i = 0; i < heap->size; ++i) {
+        heap->nodes[i]->index = HEAP_POISON_INDEX;
+    }
+
+    heap->size = 0;
+}
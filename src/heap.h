@@ -0,0 +1,385 @@
+/*
+Copyright (c) 2017, Michael J Welsh
+
+Permission to use, copy, modify, and/or distribute this software
+for any purpose with or without fee is hereby granted, provided
+that the above copyright notice and this permission notice appear
+in all copies.
+
+THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL
+WARRANTIES WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE
+AUTHOR BE LIABLE FOR ANY SPECIAL, DIRECT, INDIRECT, OR
+CONSEQUENTIAL DAMAGES OR ANY DAMAGES WHATSOEVER RESULTING FROM
+LOSS OF USE, DATA OR PROFITS, WHETHER IN AN ACTION OF CONTRACT,
+NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF OR IN
+CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+
+/**
+ * @file    heap.h
+ * @brief   HEAP (PRIORITY QUEUE)
+ *
+ * Embed a @ref HeapNode into your struct to make it a potential node in a heap. A @ref Heap is a 4-ary
+ * min-heap kept in an array of pointers to @ref HeapNode's, which the @ref Heap is given and never
+ * allocates itself. The @ref HeapNode's with the same parent are next to each other in the array, so a
+ * sift down compares four children from one or two cache lines instead of chasing pointers through the
+ * tree, and the heap is half as deep as a binary heap. Each @ref HeapNode holds its position in the array,
+ * so any @ref HeapNode can be removed, or moved after its key changes, in O(log(n)).
+ *
+ * A @ref Heap structure MUST be initialized before it is used. A @ref HeapNode structure does NOT need to be
+ * initialized before it is used. A @ref HeapNode should belong to at most ONE @ref Heap. The compare
+ * function has the same contract as the one of a @ref RBTree, except that the key is the key of the first
+ * @ref HeapNode: the @ref HeapNode with the smallest key is at the top. The order of @ref HeapNode's with
+ * equal keys is unspecified.
+ *
+ * Example:
+ *          struct Timer {
+ *              unsigned long deadline;
+ *              HeapNode n;
+ *          };
+ *
+ *          int compare(const HeapNode *a, const HeapNode *b) {
+ *              unsigned long x = heap_entry(a, struct Timer, n)->deadline;
+ *              unsigned long y = heap_entry(b, struct Timer, n)->deadline;
+ *
+ *              return x < y ? -1 : x > y;
+ *          }
+ *
+ *          int main(void) {
+ *              struct Timer timers[100];
+ *              HeapNode *array[100];
+ *              Heap heap;
+ *              int i;
+ *
+ *              heap_init(&heap, array, 100, compare);
+ *              for (i = 0; i < 100; ++i) {
+ *                  timers[i].deadline = 1000 - i;
+ *                  heap_push(&heap, &timers[i].n);
+ *              }
+ *
+ *              timers[50].deadline = 0;
+ *              heap_update(&heap, &timers[50].n);
+ *              assert(heap_pop(&heap) == &timers[50].n);
+ *
+ *              return 0;
+ *          }
+ *
+ * Dependencies:
+ *      -   C89 assert.h
+ *      -   C89 stddef.h
+ *
+ * API:
+ *      ====  TYPES  ====
+ *      -   typedef struct Heap Heap
+ *      -   typedef struct HeapNode HeapNode
+ *
+ *      ====  FUNCTIONS  ====
+ *      Initializers:
+ *          -   heap_init
+ *          -   heap_set_array
+ *      Properties:
+ *          -   heap_peek
+ *          -   heap_size
+ *          -   heap_capacity
+ *          -   heap_empty
+ *      Insertion:
+ *          -   heap_push
+ *      Update:
+ *          -   heap_update
+ *      Removal:
+ *          -   heap_pop
+ *          -   heap_remove
+ *          -   heap_remove_all
+ *
+ *      ====  MACROS  ====
+ *      Constants:
+ *          -   HEAP_ARITY
+ *          -   HEAP_POISON_INDEX
+ *      Convenient Node Initializer:
+ *          -   HEAP_NODE_INIT
+ *      Properties:
+ *          -   heap_entry
+ */
+
+#ifndef HEAP_H
+#define HEAP_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif /* __cplusplus */
+
+#include <stddef.h>
+
+/* ========================================================================================================
+ *
+ *                                                CONSTANTS
+ *
+ * ======================================================================================================== */
+
+/**
+ * The number of children of each @ref HeapNode. Can be overridden by defining it, the same way for heap.c
+ * and every file including heap.h.
+ */
+#ifndef HEAP_ARITY
+    #define HEAP_ARITY 4
+#endif
+
+/* ========================================================================================================
+ *
+ *                                                  TYPES
+ *
+ * ======================================================================================================== */
+
+/* Struct type declarations. */
+struct Heap;
+struct HeapNode;
+
+/* Struct typedef's. */
+typedef struct Heap Heap;
+typedef struct HeapNode HeapNode;
+
+/**
+ * Represents a heap. "nodes[0]" is the top @ref HeapNode, and the children of "nodes[i]" are
+ * "nodes[HEAP_ARITY * i + 1]" to "nodes[HEAP_ARITY * i + HEAP_ARITY]".
+ */
+struct Heap {
+    HeapNode **nodes;
+    size_t size;
+    size_t capacity;
+    int (*compare)(const HeapNode *a, const HeapNode *b);
+};
+
+/**
+ * Represents a node in a @ref Heap. Embed this into your structure to make it a node. The "index" member is
+ * the position of the @ref HeapNode in the array of the @ref Heap.
+ */
+struct HeapNode {
+    size_t index;
+};
+
+/* ========================================================================================================
+ *
+ *                                               PROTOTYPES
+ *
+ * ======================================================================================================== */
+
+/**
+ * Initializes/resets the @ref heap, which will keep its @ref HeapNode's in the @ref node_array.
+ *
+ * Requirements:
+ *      -   @ref heap != NULL
+ *      -   @ref node_array != NULL, or @ref capacity == 0
+ *      -   @ref compare != NULL
+ *
+ * Time complexity:
+ *      -   O(1)
+ *
+ * @param heap                  The @ref Heap to be initialized/reset.
+ * @param node_array            The array that will hold the pointers to the @ref HeapNode's.
+ * @param capacity              The number of elements of the @ref node_array.
+ * @param compare               The callback function used to compare two @ref HeapNode's. Returns < 0, 0 or
+ *                              > 0 if the key of the first @ref HeapNode is less than, equal to or greater
+ *                              than the key of the second one.
+ */
+void heap_init(
+    Heap *heap,
+    HeapNode **node_array,
+    size_t capacity,
+    int (*compare)(const HeapNode *a, const HeapNode *b)
+);
+
+/**
+ * Moves the @ref HeapNode's of the @ref heap into the @ref node_array, e.g. a larger array when the
+ * @ref heap is full. The previous array is no longer used, and can be freed.
+ *
+ * Requirements:
+ *      -   @ref heap != NULL
+ *      -   @ref node_array != NULL, or @ref capacity == 0
+ *      -   @ref capacity >= @ref heap->size
+ *
+ * Time complexity:
+ *      -   O(n)
+ *
+ * @param heap                  The @ref Heap to be operated on.
+ * @param node_array            The array that will hold the pointers to the @ref HeapNode's.
+ * @param capacity              The number of elements of the @ref node_array.
+ */
+void heap_set_array(Heap *heap, HeapNode **node_array, size_t capacity);
+
+/**
+ * Returns the @ref HeapNode with the smallest key in the @ref heap.
+ *
+ * Requirements:
+ *      -   @ref heap != NULL
+ *
+ * Time complexity:
+ *      -   O(1)
+ *
+ * @param heap                  The @ref Heap to be operated on.
+ * @return                      The top @ref HeapNode, or NULL if the @ref heap is empty.
+ */
+HeapNode* heap_peek(const Heap *heap);
+
+/**
+ * Returns the size of the @ref heap.
+ *
+ * Requirements:
+ *      -   @ref heap != NULL
+ *
+ * Time complexity:
+ *      -   O(1)
+ *
+ * @param heap                  The @ref Heap whose "size" member will be returned.
+ * @return                      @ref heap->size.
+ */
+size_t heap_size(const Heap *heap);
+
+/**
+ * Returns the number of @ref HeapNode's the array of the @ref heap can hold.
+ *
+ * Requirements:
+ *      -   @ref heap != NULL
+ *
+ * Time complexity:
+ *      -   O(1)
+ *
+ * @param heap                  The @ref Heap whose "capacity" member will be returned.
+ * @return                      @ref heap->capacity.
+ */
+size_t heap_capacity(const Heap *heap);
+
+/**
+ * Returns whether or not the @ref heap is empty (i.e. @ref heap->size == 0).
+ *
+ * Requirements:
+ *      -   @ref heap != NULL
+ *
+ * Time complexity:
+ *      -   O(1)
+ *
+ * @param heap                  The @ref Heap whose "size" member will be used to determine if it is empty.
+ * @return                      Whether or not the @ref heap is empty (i.e. @ref heap->size == 0).
+ */
+int heap_empty(const Heap *heap);
+
+/**
+ * Pushes the @ref node into the @ref heap.
+ *
+ * Requirements:
+ *      -   @ref heap != NULL
+ *      -   @ref node != NULL
+ *      -   @ref heap->size < @ref heap->capacity
+ *
+ * Time complexity:
+ *      -   O(log(n))
+ *
+ * @param heap                  The @ref Heap to be operated on.
+ * @param node                  The @ref HeapNode to be inserted.
+ */
+void heap_push(Heap *heap, HeapNode *node);
+
+/**
+ * Moves the @ref node to its place in the @ref heap after its key changed, whether the key decreased or
+ * increased.
+ *
+ * Requirements:
+ *      -   @ref heap != NULL
+ *      -   @ref node is in the @ref heap
+ *
+ * Time complexity:
+ *      -   O(log(n))
+ *
+ * @param heap                  The @ref Heap containing the @ref node.
+ * @param node                  The @ref HeapNode whose key changed.
+ */
+void heap_update(Heap *heap, HeapNode *node);
+
+/**
+ * Pops off the @ref HeapNode with the smallest key in the @ref heap AND returns it. If the @ref heap is
+ * empty, this function simply returns NULL.
+ *
+ * Requirements:
+ *      -   @ref heap != NULL
+ *
+ * Time complexity:
+ *      -   O(log(n))
+ *
+ * @param heap                  The @ref Heap to be operated on.
+ * @return                      The removed top @ref HeapNode.
+ */
+HeapNode* heap_pop(Heap *heap);
+
+/**
+ * Removes the @ref node from the @ref heap.
+ *
+ * Requirements:
+ *      -   @ref heap != NULL
+ *      -   @ref node is in the @ref heap
+ *
+ * Time complexity:
+ *      -   O(log(n))
+ *
+ * @param heap                  The @ref Heap containing the @ref node.
+ * @param node                  The @ref HeapNode to be removed.
+ */
+void heap_remove(Heap *heap, HeapNode *node);
+
+/**
+ * Removes all @ref HeapNode's from the @ref heap. If the @ref heap is empty, this function simply returns.
+ *
+ * Requirements:
+ *      -   @ref heap != NULL
+ *
+ * Time complexity:
+ *      -   O(n)
+ *
+ * @param heap                  The @ref Heap to be operated on.
+ */
+void heap_remove_all(Heap *heap);
+
+/* ========================================================================================================
+ *
+ *                                                 MACROS
+ *
+ * ======================================================================================================== */
+
+/**
+ * The "index" member of a removed @ref HeapNode. Useful for identifying bugs.
+ */
+#define HEAP_POISON_INDEX ((size_t) -1)
+
+/**
+ * Initializing a @ref HeapNode before it is used is NOT required. This macro is simply for allowing you to
+ * initialize a struct (containing one or more @ref HeapNode's) with an initializer-list conveniently.
+ */
+#define HEAP_NODE_INIT { HEAP_POISON_INDEX }
+
+/**
+ * Obtains the pointer to the struct for this entry.
+ *
+ * Requirements:
+ *      -   @ref node_ptr != NULL
+ *
+ * @param node_ptr              The pointer to the @ref HeapNode in the struct.
+ * @param type                  The type of the struct the @ref HeapNode is embedded in.
+ * @param member                The name of the @ref HeapNode in the struct.
+ */
+#if defined(__GNUC__) && !defined(__STRICT_ANSI__)
+    #define heap_entry(node_ptr, type, member) \
+        ({ \
+            const typeof(((type*)0)->member) *__mptr = (node_ptr); \
+            (type*) ((char*)__mptr - offsetof(type, member)); \
+        })
+#else
+    #define heap_entry(node_ptr, type, member) \
+        ( \
+            (type*) ((char*)(node_ptr) - offsetof(type, member)) \
+        )
+#endif
+
+#ifdef __cplusplus
+}
+#endif /* __cplusplus */
+
+#endif /* HEAP_H */
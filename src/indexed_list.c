@@ -0,0 +1,756 @@
+/*
+Copyright (c) 2017, Michael J Welsh
+
+Permission to use, copy, modify, and/or distribute this software
+for any purpose with or without fee is hereby granted, provided
+that the above copyright notice and this permission notice appear
+in all copies.
+
+THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL
+WARRANTIES WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE
+AUTHOR BE LIABLE FOR ANY SPECIAL, DIRECT, INDIRECT, OR
+CONSEQUENTIAL DAMAGES OR ANY DAMAGES WHATSOEVER RESULTING FROM
+LOSS OF USE, DATA OR PROFITS, WHETHER IN AN ACTION OF CONTRACT,
+NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF OR IN
+CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+
+#include <assert.h>
+#include <stddef.h>
+
+#include "indexed_list.h"
+
+/* ========================================================================================================
+ *
+ *                                        STATIC FUNCTION PROTOTYPES
+ *
+ * ======================================================================================================== */
+
+/*
+ * Returns the color of the @ref node. If @ref node == NULL, return @ref INDEXED_LIST_NODE_BLACK.
+ */
+static IndexedListNodeColor color(const IndexedListNode *node);
+
+/*
+ * Returns the number of nodes in the subtree rooted at the @ref node. If @ref node == NULL, return 0.
+ */
+static size_t count(const IndexedListNode *node);
+
+/*
+ * Returns the sibling of the @ref node.
+ */
+static IndexedListNode* sibling(const IndexedListNode *node);
+
+/*
+ * Returns the grandparent of the @ref node.
+ */
+static IndexedListNode* grandparent(const IndexedListNode *node);
+
+/*
+ * Returns the uncle of the @ref node.
+ */
+static IndexedListNode* uncle(const IndexedListNode *node);
+
+/*
+ * Performs a transplant on the @ref old_node and the @ref new_node in the @ref list.
+ */
+static void transplant(IndexedList *list, IndexedListNode *old_node, IndexedListNode *new_node);
+
+/*
+ * Swaps the places of the @ref high_node and @ref low_node in the @ref list. The @ref high_node must be
+ * higher in the @ref list than the @ref low_node.
+ */
+static void swap_places(IndexedList *list, IndexedListNode *high_node, IndexedListNode *low_node);
+
+/*
+ * Performs a left rotation around the @ref node in the @ref list.
+ */
+static void rotate_left(IndexedList *list, IndexedListNode *node);
+
+/*
+ * Performs a right rotation around the @ref node in the @ref list.
+ */
+static void rotate_right(IndexedList *list, IndexedListNode *node);
+
+/*
+ * Repairs the @ref list after the insertion of the @ref node.
+ */
+static void repair_after_insert(IndexedList *list, IndexedListNode *node);
+
+/*
+ * Repairs the @ref list after the removal of the @ref node.
+ */
+static void repair_after_remove(IndexedList *list, IndexedListNode *node);
+
+/*
+ * Attaches the @ref node as a leaf to the @ref parent (or as the root if @ref parent == NULL) on the given
+ * side, and rebalances the @ref list.
+ */
+static void attach(IndexedList *list, IndexedListNode *parent, int as_left_child, IndexedListNode *node);
+
+/*
+ * Moves all the nodes of the @ref src_list into the empty @ref list.
+ */
+static void move_all(IndexedList *list, IndexedList *src_list);
+
+/* ========================================================================================================
+ *
+ *                                        STATIC FUNCTION DEFINITIONS
+ *
+ * ======================================================================================================== */
+
+static IndexedListNodeColor color(const IndexedListNode *node) {
+    return node ? node->color : INDEXED_LIST_NODE_BLACK;
+}
+
+static size_t count(const IndexedListNode *node) {
+    return node ? node->count : 0;
+}
+
+static IndexedListNode* sibling(const IndexedListNode *node) {
+    assert(node && node->parent);
+
+    if (node == node->parent->left_child) {
+        return node->parent->right_child;
+    } else {
+        return node->parent->left_child;
+    }
+}
+
+static IndexedListNode* grandparent(const IndexedListNode *node) {
+    assert(node && node->parent && node->parent->parent);
+
+    return node->parent->parent;
+}
+
+static IndexedListNode* uncle(const IndexedListNode *node) {
+    assert(node && node->parent && node->parent->parent);
+
+    return sibling(node->parent);
+}
+
+static void transplant(IndexedList *list, IndexedListNode *old_node, IndexedListNode *new_node) {
+    assert(list && old_node);
+
+    if (!old_node->parent) {
+        list->root = new_node;
+    } else if (old_node == old_node->parent->left_child) {
+        old_node->parent->left_child = new_node;
+    } else {
+        old_node->parent->right_child = new_node;
+    }
+
+    if (new_node) {
+        new_node->parent = old_node->parent;
+    }
+}
+
+static void swap_places(IndexedList *list, IndexedListNode *high_node, IndexedListNode *low_node) {
+    IndexedListNode high_cpy;
+
+    assert(list && high_node && low_node);
+
+    if (!high_node->parent) {
+        list->root = low_node;
+    } else if (high_node->parent->left_child == high_node) {
+        high_node->parent->left_child = low_node;
+    } else {
+        high_node->parent->right_child = low_node;
+    }
+
+    if (low_node->left_child) {
+        low_node->left_child->parent = high_node;
+    }
+
+    if (low_node->right_child) {
+        low_node->right_child->parent = high_node;
+    }
+
+    if (high_node->left_child == low_node) {
+        if (high_node->right_child) {
+            high_node->right_child->parent = low_node;
+        }
+
+        high_node->left_child = high_node;
+        low_node->parent = low_node;
+    } else if (high_node->right_child == low_node) {
+        if (high_node->left_child) {
+            high_node->left_child->parent = low_node;
+        }
+
+        high_node->right_child = high_node;
+        low_node->parent = low_node;
+    } else {
+        if (high_node->left_child) {
+            high_node->left_child->parent = low_node;
+        }
+
+        if (high_node->right_child) {
+            high_node->right_child->parent = low_node;
+        }
+
+        if (low_node->parent->left_child == low_node) {
+            low_node->parent->left_child = high_node;
+        } else {
+            low_node->parent->right_child = high_node;
+        }
+    }
+
+    /* The count and color belong to the place in the tree, so they are swapped along with the links. */
+    high_cpy = *high_node;
+    *high_node = *low_node;
+    *low_node = high_cpy;
+}
+
+static void rotate_left(IndexedList *list, IndexedListNode *node) {
+    IndexedListNode *n;
+
+    assert(list && node);
+
+    n = node->right_child;
+
+    transplant(list, node, n);
+
+    node->right_child = n->left_child;
+
+    if (n->left_child) {
+        n->left_child->parent = node;
+    }
+
+    n->left_child = node;
+    node->parent = n;
+
+    n->count = node->count;
+    node->count = count(node->left_child) + count(node->right_child) + 1;
+}
+
+static void rotate_right(IndexedList *list, IndexedListNode *node) {
+    IndexedListNode *n;
+
+    assert(list && node);
+
+    n = node->left_child;
+
+    transplant(list, node, n);
+
+    node->left_child = n->right_child;
+
+    if (n->right_child) {
+        n->right_child->parent = node;
+    }
+
+    n->right_child = node;
+    node->parent = n;
+
+    n->count = node->count;
+    node->count = count(node->left_child) + count(node->right_child) + 1;
+}
+
+static void repair_after_insert(IndexedList *list, IndexedListNode *node) {
+    assert(list && node);
+
+    for ( ; ; ) {
+        if (!node->parent) {
+            node->color = INDEXED_LIST_NODE_BLACK;
+
+            break;
+        }
+
+        if (color(node->parent) == INDEXED_LIST_NODE_BLACK) {
+            break;
+        }
+
+        if (color(uncle(node)) == INDEXED_LIST_NODE_RED) {
+            node->parent->color = INDEXED_LIST_NODE_BLACK;
+            uncle(node)->color = INDEXED_LIST_NODE_BLACK;
+            grandparent(node)->color = INDEXED_LIST_NODE_RED;
+            node = grandparent(node);
+
+            continue;
+        }
+
+        if (node == node->parent->right_child && node->parent == grandparent(node)->left_child) {
+            rotate_left(list, node->parent);
+
+            node = node->left_child;
+        } else if (node == node->parent->left_child && node->parent == grandparent(node)->right_child) {
+            rotate_right(list, node->parent);
+
+            node = node->right_child;
+        }
+
+        node->parent->color = INDEXED_LIST_NODE_BLACK;
+        grandparent(node)->color = INDEXED_LIST_NODE_RED;
+
+        if (node == node->parent->left_child && node->parent == grandparent(node)->left_child) {
+            rotate_right(list, grandparent(node));
+        } else {
+            rotate_left(list, grandparent(node));
+        }
+
+        break;
+    }
+}
+
+static void repair_after_remove(IndexedList *list, IndexedListNode *node) {
+    assert(list && node);
+
+    for ( ; ; ) {
+        if (!node->parent) {
+            break;
+        }
+
+        if (color(sibling(node)) == INDEXED_LIST_NODE_RED) {
+            node->parent->color = INDEXED_LIST_NODE_RED;
+            sibling(node)->color = INDEXED_LIST_NODE_BLACK;
+
+            if (node == node->parent->left_child) {
+                rotate_left(list, node->parent);
+            } else {
+                rotate_right(list, node->parent);
+            }
+        }
+
+        if (
+            color(node->parent) == INDEXED_LIST_NODE_BLACK &&
+            color(sibling(node)) == INDEXED_LIST_NODE_BLACK &&
+            color(sibling(node)->left_child) == INDEXED_LIST_NODE_BLACK &&
+            color(sibling(node)->right_child) == INDEXED_LIST_NODE_BLACK
+        ) {
+            sibling(node)->color = INDEXED_LIST_NODE_RED;
+            node = node->parent;
+
+            continue;
+        }
+
+        if (
+            color(node->parent) == INDEXED_LIST_NODE_RED &&
+            color(sibling(node)) == INDEXED_LIST_NODE_BLACK &&
+            color(sibling(node)->left_child) == INDEXED_LIST_NODE_BLACK &&
+            color(sibling(node)->right_child) == INDEXED_LIST_NODE_BLACK
+        ) {
+            sibling(node)->color = INDEXED_LIST_NODE_RED;
+            node->parent->color = INDEXED_LIST_NODE_BLACK;
+
+            break;
+        }
+
+        if (
+            node == node->parent->left_child &&
+            color(sibling(node)) == INDEXED_LIST_NODE_BLACK &&
+            color(sibling(node)->left_child) == INDEXED_LIST_NODE_RED &&
+            color(sibling(node)->right_child) == INDEXED_LIST_NODE_BLACK
+        ) {
+            sibling(node)->color = INDEXED_LIST_NODE_RED;
+            sibling(node)->left_child->color = INDEXED_LIST_NODE_BLACK;
+
+            rotate_right(list, sibling(node));
+        } else if (
+            node == node->parent->right_child &&
+            color(sibling(node)) == INDEXED_LIST_NODE_BLACK &&
+            color(sibling(node)->left_child) == INDEXED_LIST_NODE_BLACK &&
+            color(sibling(node)->right_child) == INDEXED_LIST_NODE_RED
+        ) {
+            sibling(node)->color = INDEXED_LIST_NODE_RED;
+            sibling(node)->right_child->color = INDEXED_LIST_NODE_BLACK;
+
+            rotate_left(list, sibling(node));
+        }
+
+        sibling(node)->color = color(node->parent);
+        node->parent->color = INDEXED_LIST_NODE_BLACK;
+
+        if (node == node->parent->left_child) {
+            sibling(node)->right_child->color = INDEXED_LIST_NODE_BLACK;
+
+            rotate_left(list, node->parent);
+        } else {
+            sibling(node)->left_child->color = INDEXED_LIST_NODE_BLACK;
+
+            rotate_right(list, node->parent);
+        }
+
+        break;
+    }
+}
+
+static void attach(IndexedList *list, IndexedListNode *parent, int as_left_child, IndexedListNode *node) {
+    IndexedListNode *n;
+
+    assert(list && node);
+
+    node->parent = parent;
+    node->left_child = NULL;
+    node->right_child = NULL;
+    node->count = 1;
+    node->color = INDEXED_LIST_NODE_RED;
+
+    if (!parent) {
+        list->root = node;
+    } else if (as_left_child) {
+        parent->left_child = node;
+    } else {
+        parent->right_child = node;
+    }
+
+    for (n = parent; n; n = n->parent) {
+        ++n->count;
+    }
+
+    repair_after_insert(list, node);
+
+    ++list->size;
+}
+
+static void move_all(IndexedList *list, IndexedList *src_list) {
+    assert(list && src_list && !list->root);
+
+    list->root = src_list->root;
+    list->size = src_list->size;
+
+    src_list->root = NULL;
+    src_list->size = 0;
+}
+
+/* ========================================================================================================
+ *
+ *                                        EXTERN FUNCTION DEFINITIONS
+ *
+ * ======================================================================================================== */
+
+void indexed_list_init(IndexedList *list) {
+    assert(list);
+
+    list->root = NULL;
+    list->size = 0;
+}
+
+IndexedListNode* indexed_list_front(const IndexedList *list) {
+    IndexedListNode *n;
+
+    assert(list);
+
+    n = list->root;
+
+    if (!n) {
+        return NULL;
+    }
+
+    while (n->left_child) {
+        n = n->left_child;
+    }
+
+    return n;
+}
+
+IndexedListNode* indexed_list_back(const IndexedList *list) {
+    IndexedListNode *n;
+
+    assert(list);
+
+    n = list->root;
+
+    if (!n) {
+        return NULL;
+    }
+
+    while (n->right_child) {
+        n = n->right_child;
+    }
+
+    return n;
+}
+
+IndexedListNode* indexed_list_prev(const IndexedListNode *node) {
+    IndexedListNode *n;
+
+    if (!node) {
+        return NULL;
+    }
+
+    if (node->left_child) {
+        node = node->left_child;
+
+        while (node->right_child) {
+            node = node->right_child;
+        }
+
+        return (IndexedListNode*) node;
+    }
+
+    while ((n = node->parent) && node == n->left_child) {
+        node = n;
+    }
+
+    return n;
+}
+
+IndexedListNode* indexed_list_next(const IndexedListNode *node) {
+    IndexedListNode *n;
+
+    if (!node) {
+        return NULL;
+    }
+
+    if (node->right_child) {
+        node = node->right_child;
+
+        while (node->left_child) {
+            node = node->left_child;
+        }
+
+        return (IndexedListNode*) node;
+    }
+
+    while ((n = node->parent) && node == n->right_child) {
+        node = n;
+    }
+
+    return n;
+}
+
+size_t indexed_list_size(const IndexedList *list) {
+    assert(list);
+
+    return list->size;
+}
+
+int indexed_list_empty(const IndexedList *list) {
+    assert(list);
+
+    return list->size == 0;
+}
+
+size_t indexed_list_index_of(const IndexedList *list, const IndexedListNode *node) {
+    size_t index;
+
+    assert(list && node);
+
+    index = count(node->left_child);
+
+    for ( ; node != list->root; node = node->parent) {
+        if (node == node->parent->right_child) {
+            index += count(node->parent->left_child) + 1;
+        }
+    }
+
+    return index;
+}
+
+IndexedListNode* indexed_list_at(const IndexedList *list, size_t index) {
+    IndexedListNode *n;
+
+    assert(list && index < list->size);
+
+    for (n = list->root; ; ) {
+        size_t left_count = count(n->left_child);
+
+        if (index < left_count) {
+            n = n->left_child;
+        } else if (index > left_count) {
+            index -= left_count + 1;
+            n = n->right_child;
+        } else {
+            return n;
+        }
+    }
+}
+
+void indexed_list_insert_left(IndexedList *list, IndexedListNode *new_node, IndexedListNode *position) {
+    IndexedListNode *n;
+
+    assert(list && new_node);
+
+    if (!position) {
+        indexed_list_insert_front(list, new_node);
+    } else if (!position->left_child) {
+        attach(list, position, 1, new_node);
+    } else {
+        n = position->left_child;
+
+        while (n->right_child) {
+            n = n->right_child;
+        }
+
+        attach(list, n, 0, new_node);
+    }
+}
+
+void indexed_list_insert_right(IndexedList *list, IndexedListNode *new_node, IndexedListNode *position) {
+    IndexedListNode *n;
+
+    assert(list && new_node);
+
+    if (!position) {
+        indexed_list_insert_back(list, new_node);
+    } else if (!position->right_child) {
+        attach(list, position, 0, new_node);
+    } else {
+        n = position->right_child;
+
+        while (n->left_child) {
+            n = n->left_child;
+        }
+
+        attach(list, n, 1, new_node);
+    }
+}
+
+void indexed_list_insert_front(IndexedList *list, IndexedListNode *new_node) {
+    assert(list && new_node);
+
+    attach(list, indexed_list_front(list), 1, new_node);
+}
+
+void indexed_list_insert_back(IndexedList *list, IndexedListNode *new_node) {
+    assert(list && new_node);
+
+    attach(list, indexed_list_back(list), 0, new_node);
+}
+
+void indexed_list_insert_at(IndexedList *list, IndexedListNode *new_node, size_t index) {
+    assert(list && new_node && index <= list->size);
+
+    if (index == list->size) {
+        indexed_list_insert_back(list, new_node);
+    } else {
+        indexed_list_insert_left(list, new_node, indexed_list_at(list, index));
+    }
+}
+
+void indexed_list_splice_left(IndexedList *list, IndexedList *src_list, IndexedListNode *position) {
+    IndexedListNode *n;
+
+    assert(list && src_list);
+
+    if (!position) {
+        indexed_list_splice_front(list, src_list);
+        return;
+    }
+
+    /* Inserting front to back right before the position keeps the order. */
+    while ((n = indexed_list_front(src_list))) {
+        indexed_list_remove(src_list, n);
+        indexed_list_insert_left(list, n, position);
+    }
+}
+
+void indexed_list_splice_right(IndexedList *list, IndexedList *src_list, IndexedListNode *position) {
+    IndexedListNode *n;
+
+    assert(list && src_list);
+
+    if (!position) {
+        indexed_list_splice_back(list, src_list);
+        return;
+    }
+
+    /* Inserting back to front right after the position keeps the order. */
+    while ((n = indexed_list_back(src_list))) {
+        indexed_list_remove(src_list, n);
+        indexed_list_insert_right(list, n, position);
+    }
+}
+
+void indexed_list_splice_front(IndexedList *list, IndexedList *src_list) {
+    IndexedListNode *n;
+
+    assert(list && src_list);
+
+    if (!list->root) {
+        move_all(list, src_list);
+        return;
+    }
+
+    while ((n = indexed_list_back(src_list))) {
+        indexed_list_remove(src_list, n);
+        indexed_list_insert_front(list, n);
+    }
+}
+
+void indexed_list_splice_back(IndexedList *list, IndexedList *src_list) {
+    IndexedListNode *n;
+
+    assert(list && src_list);
+
+    if (!list->root) {
+        move_all(list, src_list);
+        return;
+    }
+
+    while ((n = indexed_list_front(src_list))) {
+        indexed_list_remove(src_list, n);
+        indexed_list_insert_back(list, n);
+    }
+}
+
+void indexed_list_remove(IndexedList *list, IndexedListNode *node) {
+    IndexedListNode *n;
+
+    assert(list);
+
+    if (!node) {
+        return;
+    }
+
+    if (node->left_child && node->right_child) {
+        IndexedListNode *k = node->left_child;
+
+        while (k->right_child) {
+            k = k->right_child;
+        }
+
+        swap_places(list, node, k);
+    }
+
+    n = node->right_child ? node->right_child : node->left_child;
+
+    if (color(node) == INDEXED_LIST_NODE_BLACK) {
+        node->color = color(n);
+
+        repair_after_remove(list, node);
+    }
+
+    transplant(list, node, n);
+
+    if (!node->parent && n) {
+        n->color = INDEXED_LIST_NODE_BLACK;
+    }
+
+    /* The node is gone from the subtree of each of its former ancestors. */
+    for (n = node->parent; n; n = n->parent) {
+        --n->count;
+    }
+
+    node->parent = INDEXED_LIST_POISON_PARENT;
+    node->left_child = INDEXED_LIST_POISON_LEFT_CHILD;
+    node->right_child = INDEXED_LIST_POISON_RIGHT_CHILD;
+
+    --list->size;
+}
+
+void indexed_list_remove_front(IndexedList *list) {
+    assert(list);
+
+    indexed_list_remove(list, indexed_list_front(list));
+}
+
+void indexed_list_remove_back(IndexedList *list) {
+    assert(list);
+
+    indexed_list_remove(list, indexed_list_back(list));
+}
+
+void indexed_list_remove_all(IndexedList *list) {
+    assert(list);
+
+    if (list->root) {
+        list->root->parent = INDEXED_LIST_POISON_PARENT;
+        list->root->left_child = INDEXED_LIST_POISON_LEFT_CHILD;
+        list->root->right_child = INDEXED_LIST_POISON_RIGHT_CHILD;
+    }
+
+    list->root = NULL;
+    list->size = 0;
+}
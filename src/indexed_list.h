@@ -0,0 +1,672 @@
+/*
+Copyright (c) 2017, Michael J Welsh
+
+Permission to use, copy, modify, and/or distribute this software
+for any purpose with or without fee is hereby granted, provided
+that the above copyright notice and this permission notice appear
+in all copies.
+
+THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL
+WARRANTIES WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE
+AUTHOR BE LIABLE FOR ANY SPECIAL, DIRECT, INDIRECT, OR
+CONSEQUENTIAL DAMAGES OR ANY DAMAGES WHATSOEVER RESULTING FROM
+LOSS OF USE, DATA OR PROFITS, WHETHER IN AN ACTION OF CONTRACT,
+NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF OR IN
+CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+
+/**
+ * @file    indexed_list.h
+ * @brief   INDEXED LIST
+ *
+ * Embed one or more @ref IndexedListNode's into your struct to make it a potential node in one or more
+ * indexed lists. The @ref IndexedList structure keeps track of a sequence of @ref IndexedListNode's, just like
+ * a @ref List does, but positional access (@ref indexed_list_at, @ref indexed_list_index_of) takes O(log(n))
+ * instead of O(n). A @ref IndexedList structure MUST be initialized before it is used. A @ref IndexedListNode
+ * structure does NOT need to be initialized before it is used. A @ref IndexedListNode should belong to at
+ * most ONE @ref IndexedList.
+ *
+ * Internally, the sequence is a red-black tree ordered by position rather than by key, where every
+ * @ref IndexedListNode also tracks the number of @ref IndexedListNode's in its subtree. The price for the fast
+ * positional access is that insertion and removal take O(log(n)) instead of O(1).
+ *
+ * Example:
+ *          struct Object {
+ *              int val;
+ *              IndexedListNode n;
+ *          };
+ *
+ *          int main(void) {
+ *              struct Object obj1, obj2;
+ *              IndexedList list;
+ *
+ *              indexed_list_init(&list);
+ *              indexed_list_insert_back(&list, &obj1.n);
+ *              indexed_list_insert_front(&list, &obj2.n);
+ *
+ *              obj1.val = 5;
+ *              assert(indexed_list_entry(indexed_list_at(&list, 1), struct Object, n)->val == 5);
+ *              assert(indexed_list_index_of(&list, &obj2.n) == 0);
+ *
+ *              return 0;
+ *          }
+ *
+ * Dependencies:
+ *      -   C89 assert.h
+ *      -   C89 stddef.h
+ *
+ * API:
+ *      ====  TYPES  ====
+ *      -   typedef struct IndexedList IndexedList
+ *      -   typedef struct IndexedListNode IndexedListNode
+ *      -   typedef enum IndexedListNodeColor IndexedListNodeColor
+ *          -   INDEXED_LIST_NODE_RED = 0
+ *          -   INDEXED_LIST_NODE_BLACK = 1
+ *
+ *      ====  FUNCTIONS  ====
+ *      Initializers:
+ *          -   indexed_list_init
+ *      Properties:
+ *          -   indexed_list_front
+ *          -   indexed_list_back
+ *          -   indexed_list_prev
+ *          -   indexed_list_next
+ *          -   indexed_list_size
+ *          -   indexed_list_empty
+ *      Array Interfacing:
+ *          -   indexed_list_index_of
+ *          -   indexed_list_at
+ *      Insertion:
+ *          -   indexed_list_insert_left
+ *          -   indexed_list_insert_right
+ *          -   indexed_list_insert_front
+ *          -   indexed_list_insert_back
+ *          -   indexed_list_insert_at
+ *      Splicing:
+ *          -   indexed_list_splice_left
+ *          -   indexed_list_splice_right
+ *          -   indexed_list_splice_front
+ *          -   indexed_list_splice_back
+ *      Removal:
+ *          -   indexed_list_remove
+ *          -   indexed_list_remove_front
+ *          -   indexed_list_remove_back
+ *          -   indexed_list_remove_all
+ *
+ *      ====  MACROS  ====
+ *      Constants:
+ *          -   INDEXED_LIST_POISON_PARENT
+ *          -   INDEXED_LIST_POISON_LEFT_CHILD
+ *          -   INDEXED_LIST_POISON_RIGHT_CHILD
+ *      Convenient Node Initializer:
+ *          -   INDEXED_LIST_NODE_INIT
+ *      Properties:
+ *          -   indexed_list_entry
+ *      Traversal:
+ *          -   indexed_list_for_each
+ *          -   indexed_list_for_each_reverse
+ *          -   indexed_list_for_each_safe
+ *          -   indexed_list_for_each_safe_reverse
+ */
+
+#ifndef INDEXED_LIST_H
+#define INDEXED_LIST_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif /* __cplusplus */
+
+#include <stddef.h>
+
+/* ========================================================================================================
+ *
+ *                                                  TYPES
+ *
+ * ======================================================================================================== */
+
+/* Struct type declarations. */
+struct IndexedList;
+struct IndexedListNode;
+
+/* Struct typedef's. */
+typedef struct IndexedList IndexedList;
+typedef struct IndexedListNode IndexedListNode;
+
+/**
+ * Represents an indexed list.
+ */
+struct IndexedList {
+    IndexedListNode *root;
+    size_t size;
+};
+
+/**
+ * Represents the color of a @ref IndexedListNode.
+ */
+typedef enum IndexedListNodeColor {
+    INDEXED_LIST_NODE_RED = 0,
+    INDEXED_LIST_NODE_BLACK = 1
+} IndexedListNodeColor;
+
+/**
+ * Represents a node in a @ref IndexedList. Embed this into your structure to make it a node. The "count"
+ * member is the number of @ref IndexedListNode's in the subtree rooted at this node.
+ */
+struct IndexedListNode {
+    IndexedListNode *parent;
+    IndexedListNode *left_child;
+    IndexedListNode *right_child;
+    size_t count;
+    IndexedListNodeColor color;
+};
+
+/* ========================================================================================================
+ *
+ *                                               PROTOTYPES
+ *
+ * ======================================================================================================== */
+
+/**
+ * Initializes/resets the @ref list.
+ *
+ * Requirements:
+ *      -   @ref list != NULL
+ *
+ * Time complexity:
+ *      -   O(1)
+ *
+ * @param list                  The @ref IndexedList to be initialized/reset.
+ */
+void indexed_list_init(IndexedList *list);
+
+/**
+ * Returns the front of the @ref list. NULL if the @ref list is empty.
+ *
+ * Requirements:
+ *      -   @ref list != NULL
+ *
+ * Time complexity:
+ *      -   O(log(n))
+ *
+ * @param list                  The @ref IndexedList whose first @ref IndexedListNode will be returned.
+ * @return                      The first @ref IndexedListNode of the @ref list.
+ */
+IndexedListNode* indexed_list_front(const IndexedList *list);
+
+/**
+ * Returns the back of the @ref list. NULL if the @ref list is empty.
+ *
+ * Requirements:
+ *      -   @ref list != NULL
+ *
+ * Time complexity:
+ *      -   O(log(n))
+ *
+ * @param list                  The @ref IndexedList whose last @ref IndexedListNode will be returned.
+ * @return                      The last @ref IndexedListNode of the @ref list.
+ */
+IndexedListNode* indexed_list_back(const IndexedList *list);
+
+/**
+ * Returns the @ref IndexedListNode before the @ref node. NULL if @ref node == NULL.
+ *
+ * Requirements:
+ *      -   None
+ *
+ * Time complexity:
+ *      -   Amortized:      O(1)
+ *      -   Worst case:     O(log(n))
+ *
+ * @param node                  The @ref IndexedListNode whose predecessor will be returned.
+ * @return                      NULL if @ref node == NULL; otherwise, the predecessor of the @ref node.
+ */
+IndexedListNode* indexed_list_prev(const IndexedListNode *node);
+
+/**
+ * Returns the @ref IndexedListNode after the @ref node. NULL if @ref node == NULL.
+ *
+ * Requirements:
+ *      -   None
+ *
+ * Time complexity:
+ *      -   Amortized:      O(1)
+ *      -   Worst case:     O(log(n))
+ *
+ * @param node                  The @ref IndexedListNode whose successor will be returned.
+ * @return                      NULL if @ref node == NULL; otherwise, the successor of the @ref node.
+ */
+IndexedListNode* indexed_list_next(const IndexedListNode *node);
+
+/**
+ * Returns the size of the @ref list.
+ *
+ * Requirements:
+ *      -   @ref list != NULL
+ *
+ * Time complexity:
+ *      -   O(1)
+ *
+ * @param list                  The @ref IndexedList whose "size" member will be returned.
+ * @return                      @ref list->size.
+ */
+size_t indexed_list_size(const IndexedList *list);
+
+/**
+ * Returns whether or not the @ref list is empty (i.e. @ref list->size == 0).
+ *
+ * Requirements:
+ *      -   @ref list != NULL
+ *
+ * Time complexity:
+ *      -   O(1)
+ *
+ * @param list                  The @ref IndexedList whose "size" member will be used to determine if it is
+ *                              empty.
+ * @return                      Whether or not the @ref list is empty (i.e. @ref list->size == 0).
+ */
+int indexed_list_empty(const IndexedList *list);
+
+/**
+ * Retrieves the index of the @ref node in the @ref list.
+ *
+ * Requirements:
+ *      -   @ref list != NULL
+ *      -   @ref node != NULL
+ *
+ * Time complexity:
+ *      -   O(log(n))
+ *
+ * @param list                  The @ref IndexedList that contains the @ref node.
+ * @param node                  The @ref IndexedListNode whose index is wanted.
+ * @return                      The index of the @ref node in the @ref list.
+ */
+size_t indexed_list_index_of(const IndexedList *list, const IndexedListNode *node);
+
+/**
+ * Retrieves the @ref IndexedListNode at the @ref index.
+ *
+ * Requirements:
+ *      -   @ref list != NULL
+ *      -   @ref index < @ref list->size
+ *
+ * Time complexity:
+ *      -   O(log(n))
+ *
+ * @param list                  The @ref IndexedList containing nodes.
+ * @param index                 The index of the wanted @ref IndexedListNode.
+ * @return                      The @ref IndexedListNode at the @ref index in the @ref list.
+ */
+IndexedListNode* indexed_list_at(const IndexedList *list, size_t index);
+
+/**
+ * Inserts the @ref new_node to the left of the @ref position. If @ref position == NULL, inserts the
+ * @ref new_node at the front of the @ref list.
+ *
+ * Requirements:
+ *      -   @ref list != NULL
+ *      -   @ref new_node != NULL
+ *
+ * Time complexity:
+ *      -   O(log(n))
+ *
+ * @param list                  The @ref IndexedList to be operated on.
+ * @param new_node              The @ref IndexedListNode to be inserted.
+ * @param position              The @ref IndexedListNode in the @ref list used as a reference point.
+ */
+void indexed_list_insert_left(IndexedList *list, IndexedListNode *new_node, IndexedListNode *position);
+
+/**
+ * Inserts the @ref new_node to the right of the @ref position. If @ref position == NULL, inserts the
+ * @ref new_node at the back of the @ref list.
+ *
+ * Requirements:
+ *      -   @ref list != NULL
+ *      -   @ref new_node != NULL
+ *
+ * Time complexity:
+ *      -   O(log(n))
+ *
+ * @param list                  The @ref IndexedList to be operated on.
+ * @param new_node              The @ref IndexedListNode to be inserted.
+ * @param position              The @ref IndexedListNode in the @ref list used as a reference point.
+ */
+void indexed_list_insert_right(IndexedList *list, IndexedListNode *new_node, IndexedListNode *position);
+
+/**
+ * Inserts the @ref new_node into the front of the @ref list.
+ *
+ * Requirements:
+ *      -   @ref list != NULL
+ *      -   @ref new_node != NULL
+ *
+ * Time complexity:
+ *      -   O(log(n))
+ *
+ * @param list                  The @ref IndexedList to be operated on.
+ * @param new_node              The @ref IndexedListNode to be inserted.
+ */
+void indexed_list_insert_front(IndexedList *list, IndexedListNode *new_node);
+
+/**
+ * Inserts the @ref new_node into the back of the @ref list.
+ *
+ * Requirements:
+ *      -   @ref list != NULL
+ *      -   @ref new_node != NULL
+ *
+ * Time complexity:
+ *      -   O(log(n))
+ *
+ * @param list                  The @ref IndexedList to be operated on.
+ * @param new_node              The @ref IndexedListNode to be inserted.
+ */
+void indexed_list_insert_back(IndexedList *list, IndexedListNode *new_node);
+
+/**
+ * Inserts the @ref new_node into the @ref list so that its index becomes @ref index. If
+ * @ref index == @ref list->size, inserts the @ref new_node at the back of the @ref list.
+ *
+ * Requirements:
+ *      -   @ref list != NULL
+ *      -   @ref new_node != NULL
+ *      -   @ref index <= @ref list->size
+ *
+ * Time complexity:
+ *      -   O(log(n))
+ *
+ * @param list                  The @ref IndexedList to be operated on.
+ * @param new_node              The @ref IndexedListNode to be inserted.
+ * @param index                 The index the @ref new_node will have.
+ */
+void indexed_list_insert_at(IndexedList *list, IndexedListNode *new_node, size_t index);
+
+/**
+ * Removes all the @ref IndexedListNode's in the @ref src_list, and inserts them into the @ref list to the
+ * left of the @ref position. If @ref position == NULL, inserts all the @ref IndexedListNode's into the front
+ * of the @ref list.
+ *
+ * Requirements:
+ *      -   @ref list != NULL
+ *      -   @ref src_list != NULL
+ *
+ * Time complexity:
+ *      -   If @ref list is empty:
+ *          -   O(1)
+ *      -   Else:
+ *          -   O(mlog(n + m)), where m is @ref src_list->size
+ *
+ * @param list                  The consumer @ref IndexedList to which elements are moved.
+ * @param src_list              The producer @ref IndexedList from which elements are removed.
+ * @param position              The @ref IndexedListNode in the @ref list used as a reference point.
+ */
+void indexed_list_splice_left(IndexedList *list, IndexedList *src_list, IndexedListNode *position);
+
+/**
+ * Removes all the @ref IndexedListNode's in the @ref src_list, and inserts them into the @ref list to the
+ * right of the @ref position. If @ref position == NULL, inserts all the @ref IndexedListNode's into the back
+ * of the @ref list.
+ *
+ * Requirements:
+ *      -   @ref list != NULL
+ *      -   @ref src_list != NULL
+ *
+ * Time complexity:
+ *      -   If @ref list is empty:
+ *          -   O(1)
+ *      -   Else:
+ *          -   O(mlog(n + m)), where m is @ref src_list->size
+ *
+ * @param list                  The consumer @ref IndexedList to which elements are moved.
+ * @param src_list              The producer @ref IndexedList from which elements are removed.
+ * @param position              The @ref IndexedListNode in the @ref list used as a reference point.
+ */
+void indexed_list_splice_right(IndexedList *list, IndexedList *src_list, IndexedListNode *position);
+
+/**
+ * Removes all the @ref IndexedListNode's in the @ref src_list, and inserts them into the front of the
+ * @ref list.
+ *
+ * Requirements:
+ *      -   @ref list != NULL
+ *      -   @ref src_list != NULL
+ *
+ * Time complexity:
+ *      -   If @ref list is empty:
+ *          -   O(1)
+ *      -   Else:
+ *          -   O(mlog(n + m)), where m is @ref src_list->size
+ *
+ * @param list                  The consumer @ref IndexedList to which elements are moved.
+ * @param src_list              The producer @ref IndexedList from which elements are removed.
+ */
+void indexed_list_splice_front(IndexedList *list, IndexedList *src_list);
+
+/**
+ * Removes all the @ref IndexedListNode's in the @ref src_list, and inserts them into the back of the
+ * @ref list.
+ *
+ * Requirements:
+ *      -   @ref list != NULL
+ *      -   @ref src_list != NULL
+ *
+ * Time complexity:
+ *      -   If @ref list is empty:
+ *          -   O(1)
+ *      -   Else:
+ *          -   O(mlog(n + m)), where m is @ref src_list->size
+ *
+ * @param list                  The consumer @ref IndexedList to which elements are moved.
+ * @param src_list              The producer @ref IndexedList from which elements are removed.
+ */
+void indexed_list_splice_back(IndexedList *list, IndexedList *src_list);
+
+/**
+ * Removes the @ref node from the @ref list. If @ref node == NULL, this function simply returns.
+ *
+ * Requirements:
+ *      -   @ref list != NULL
+ *
+ * Time complexity:
+ *      -   O(log(n))
+ *
+ * @param list                  The @ref IndexedList containing the @ref node to be removed.
+ * @param node                  The @ref IndexedListNode in the @ref list to be removed.
+ */
+void indexed_list_remove(IndexedList *list, IndexedListNode *node);
+
+/**
+ * Removes the front of the @ref list. If the @ref list is empty, this function simply returns.
+ *
+ * Requirements:
+ *      -   @ref list != NULL
+ *
+ * Time complexity:
+ *      -   O(log(n))
+ *
+ * @param list                  The @ref IndexedList to be operated on.
+ */
+void indexed_list_remove_front(IndexedList *list);
+
+/**
+ * Removes the back of the @ref list. If the @ref list is empty, this function simply returns.
+ *
+ * Requirements:
+ *      -   @ref list != NULL
+ *
+ * Time complexity:
+ *      -   O(log(n))
+ *
+ * @param list                  The @ref IndexedList to be operated on.
+ */
+void indexed_list_remove_back(IndexedList *list);
+
+/**
+ * Removes all the @ref IndexedListNode's from the @ref list. If the @ref list is empty, this function simply
+ * returns.
+ *
+ * Requirements:
+ *      -   @ref list != NULL
+ *
+ * Time complexity:
+ *      -   O(1)
+ *
+ * @param list                  The @ref IndexedList to be operated on.
+ */
+void indexed_list_remove_all(IndexedList *list);
+
+/* ========================================================================================================
+ *
+ *                                                 MACROS
+ *
+ * ======================================================================================================== */
+
+/**
+ * Non-NULL pointer that will result in page faults under normal circumstances. Is the "parent" member of the
+ * root @ref IndexedListNode in a chain of removed @ref IndexedListNode's or a single removed
+ * @ref IndexedListNode. Useful for identifying bugs.
+ */
+#define INDEXED_LIST_POISON_PARENT ((IndexedListNode*) 0x100)
+
+/**
+ * Non-NULL pointer that will result in page faults under normal circumstances. Is the "left_child" member of
+ * the root @ref IndexedListNode in a chain of removed @ref IndexedListNode's or a single removed
+ * @ref IndexedListNode. Useful for identifying bugs.
+ */
+#define INDEXED_LIST_POISON_LEFT_CHILD ((IndexedListNode*) 0x200)
+
+/**
+ * Non-NULL pointer that will result in page faults under normal circumstances. Is the "right_child" member of
+ * the root @ref IndexedListNode in a chain of removed @ref IndexedListNode's or a single removed
+ * @ref IndexedListNode. Useful for identifying bugs.
+ */
+#define INDEXED_LIST_POISON_RIGHT_CHILD ((IndexedListNode*) 0x300)
+
+/**
+ * Initializing a @ref IndexedListNode before it is used is NOT required. This macro is simply for allowing
+ * you to initialize a struct (containing one or more @ref IndexedListNode's) with an initializer-list
+ * conveniently.
+ */
+#define INDEXED_LIST_NODE_INIT \
+    { \
+        INDEXED_LIST_POISON_PARENT, \
+        INDEXED_LIST_POISON_LEFT_CHILD, \
+        INDEXED_LIST_POISON_RIGHT_CHILD, \
+        0, \
+        INDEXED_LIST_NODE_RED \
+    }
+
+/**
+ * Obtains the pointer to the struct for this entry.
+ *
+ * Requirements:
+ *      -   @ref node_ptr != NULL
+ *
+ * @param node_ptr              The pointer to the @ref IndexedListNode in the struct.
+ * @param type                  The type of the struct the @ref IndexedListNode is embedded in.
+ * @param member                The name of the @ref IndexedListNode in the struct.
+ */
+#if defined(__GNUC__) && !defined(__STRICT_ANSI__)
+    #define indexed_list_entry(node_ptr, type, member) \
+        ({ \
+            const typeof(((type*)0)->member) *__mptr = (node_ptr); \
+            (type*) ((char*)__mptr - offsetof(type, member)); \
+        })
+#else
+    #define indexed_list_entry(node_ptr, type, member) \
+        ( \
+            (type*) ((char*)(node_ptr) - offsetof(type, member)) \
+        )
+#endif
+
+/**
+ * Iterates over the @ref IndexedList from the front to the back.
+ *
+ * Requirements:
+ *      -   @ref list_ptr != NULL
+ *      -   The @ref cursor_node_ptr is neither reassigned nor removed from its associated @ref IndexedList in
+ *          the loop's body.
+ *
+ * @param cursor_node_ptr       The @ref IndexedListNode to use as a loop cursor.
+ * @param list_ptr              The pointer to a @ref IndexedList that will be iterated over.
+ */
+#define indexed_list_for_each(cursor_node_ptr, list_ptr) \
+    for ( \
+        cursor_node_ptr = indexed_list_front(list_ptr); \
+        cursor_node_ptr; \
+        cursor_node_ptr = indexed_list_next(cursor_node_ptr) \
+    )
+
+/**
+ * Iterates over the @ref IndexedList from the back to the front.
+ *
+ * Requirements:
+ *      -   @ref list_ptr != NULL
+ *      -   The @ref cursor_node_ptr is neither reassigned nor removed from its associated @ref IndexedList in
+ *          the loop's body.
+ *
+ * @param cursor_node_ptr       The @ref IndexedListNode to use as a loop cursor.
+ * @param list_ptr              The pointer to a @ref IndexedList that will be iterated over.
+ */
+#define indexed_list_for_each_reverse(cursor_node_ptr, list_ptr) \
+    for ( \
+        cursor_node_ptr = indexed_list_back(list_ptr); \
+        cursor_node_ptr; \
+        cursor_node_ptr = indexed_list_prev(cursor_node_ptr) \
+    )
+
+/**
+ * Iterates over the @ref IndexedList from the front to the back, and is safe against reassignment and/or
+ * removal of the @ref cursor_node_ptr.
+ *
+ * Requirements:
+ *      -   @ref list_ptr != NULL.
+ *      -   @ref backup_node_ptr is neither reassigned nor removed from its associated @ref IndexedList in the
+ *          loop's body.
+ *      -   @ref backup_node_ptr and @ref cursor_node_ptr are not the same variable.
+ *
+ * @param cursor_node_ptr       The @ref IndexedListNode to use as a loop cursor.
+ * @param backup_node_ptr       Another @ref IndexedListNode to use as a temporary storage.
+ * @param list_ptr              The pointer to a @ref IndexedList that will be iterated over.
+ */
+#define indexed_list_for_each_safe(cursor_node_ptr, backup_node_ptr, list_ptr) \
+    for ( \
+        cursor_node_ptr = indexed_list_front(list_ptr), \
+        backup_node_ptr = indexed_list_next(cursor_node_ptr); \
+        \
+        cursor_node_ptr; \
+        \
+        cursor_node_ptr = backup_node_ptr, \
+        backup_node_ptr = indexed_list_next(backup_node_ptr) \
+    )
+
+/**
+ * Iterates over the @ref IndexedList from the back to the front, and is safe against reassignment and/or
+ * removal of the @ref cursor_node_ptr.
+ *
+ * Requirements:
+ *      -   @ref list_ptr != NULL.
+ *      -   @ref backup_node_ptr is neither reassigned nor removed from its associated @ref IndexedList in the
+ *          loop's body.
+ *      -   @ref backup_node_ptr and @ref cursor_node_ptr are not the same variable.
+ *
+ * @param cursor_node_ptr       The @ref IndexedListNode to use as a loop cursor.
+ * @param backup_node_ptr       Another @ref IndexedListNode to use as a temporary storage.
+ * @param list_ptr              The pointer to a @ref IndexedList that will be iterated over.
+ */
+#define indexed_list_for_each_safe_reverse(cursor_node_ptr, backup_node_ptr, list_ptr) \
+    for ( \
+        cursor_node_ptr = indexed_list_back(list_ptr), \
+        backup_node_ptr = indexed_list_prev(cursor_node_ptr); \
+        \
+        cursor_node_ptr; \
+        \
+        cursor_node_ptr = backup_node_ptr, \
+        backup_node_ptr = indexed_list_prev(backup_node_ptr) \
+    )
+
+#ifdef __cplusplus
+}
+#endif /* __cplusplus */
+
+#endif /* INDEXED_LIST_H */
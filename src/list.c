@@ -17,10 +17,412 @@ CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
 */
 
 #include <assert.h>
+#include <limits.h>
 #include <stddef.h>
 
 #include "list.h"
 
+/* ========================================================================================================
+ *
+ *                                               STATIC TYPES
+ *
+ * ======================================================================================================== */
+
+/* A sorted, NULL-terminated, singly linked run of nodes. */
+typedef struct ListRun {
+    ListNode *head;
+    ListNode *tail;
+    size_t size;
+} ListRun;
+
+/* Upper bound on the number of pending runs in list_sort_natural (see collapse_runs). */
+#define LIST_SORT_MAX_RUNS (sizeof(size_t) * CHAR_BIT * 3 / 2)
+
+/* Minimum length of an ascending run before stragglers get set aside (short runs mean unordered input). */
+#define LIST_SORT_MIN_STRAGGLER_RUN 16
+
+/* Blocks of entries sorted with insertion sort by list_sort_buffered before merging. */
+#define LIST_SORT_INSERTION_BLOCK 16
+
+/* ========================================================================================================
+ *
+ *                                        STATIC FUNCTION PROTOTYPES
+ *
+ * ======================================================================================================== */
+
+static void merge_runs(ListRun *left, const ListRun *right, int (*compare)(const ListNode *a, const ListNode *b));
+static void collapse_runs(
+    ListRun *runs,
+    size_t *num_runs,
+    int force,
+    int (*compare)(const ListNode *a, const ListNode *b)
+);
+static ListNode* detect_run(
+    ListRun *run,
+    ListNode *head,
+    ListRun *aside,
+    int (*compare)(const ListNode *a, const ListNode *b)
+);
+static int compare_entries(
+    const ListSortEntry *a,
+    const ListSortEntry *b,
+    int (*compare)(const ListNode *a, const ListNode *b)
+);
+static void insertion_sort_entries(
+    ListSortEntry *entries,
+    size_t num_entries,
+    int (*compare)(const ListNode *a, const ListNode *b)
+);
+static void merge_entries(
+    const ListSortEntry *src,
+    ListSortEntry *dst,
+    size_t mid,
+    size_t end,
+    int (*compare)(const ListNode *a, const ListNode *b)
+);
+static ListSortEntry* radix_sort_entries(ListSortEntry *src, ListSortEntry *dst, size_t num_entries);
+static void sort_task(ListSortTask *task);
+static void merge_task(ListSortTask *task);
+static void run_tasks(
+    void (*run)(ListSortTask *task),
+    ListSortTask *tasks,
+    size_t num_tasks,
+    void (*execute)(
+        void (*run)(ListSortTask *task),
+        ListSortTask *tasks,
+        size_t num_tasks,
+        void *executor_data
+    ),
+    void *executor_data
+);
+
+/* ========================================================================================================
+ *
+ *                                        STATIC FUNCTION DEFINITIONS
+ *
+ * ======================================================================================================== */
+
+/* Stably merges the run @ref right into the run @ref left, which precedes it. */
+static void merge_runs(ListRun *left, const ListRun *right, int (*compare)(const ListNode *a, const ListNode *b)) {
+    ListNode dummy, *tail, *a, *b;
+
+    if (compare(left->tail, right->head) <= 0) {
+        /* Already in order. */
+        left->tail->next = right->head;
+        left->tail = right->tail;
+    } else if (compare(left->head, right->tail) > 0) {
+        /* Every node of the right run is strictly smaller than every node of the left run. */
+        right->tail->next = left->head;
+        left->head = right->head;
+    } else {
+        tail = &dummy;
+        a = left->head;
+        b = right->head;
+
+        while (a && b) {
+            if (compare(a, b) <= 0) {
+                tail->next = a;
+                tail = a;
+                a = a->next;
+            } else {
+                tail->next = b;
+                tail = b;
+                b = b->next;
+            }
+        }
+
+        if (a) {
+            tail->next = a;
+        } else {
+            tail->next = b;
+            left->tail = right->tail;
+        }
+
+        left->head = dummy.next;
+    }
+
+    left->size += right->size;
+}
+
+/*
+ * Merges pending runs on top of the stack while their sizes (from the bottom of the stack up) do not shrink
+ * like the Fibonacci numbers, always merging the smaller neighbour first (the TimSort merge policy, including
+ * the check of the 4th run from the top). Runs of similar size get merged, which keeps merges balanced, and
+ * the stack stays shorter than LIST_SORT_MAX_RUNS. If @ref force is non-zero, all runs are merged into one.
+ */
+static void collapse_runs(
+    ListRun *runs,
+    size_t *num_runs,
+    int force,
+    int (*compare)(const ListNode *a, const ListNode *b)
+) {
+    while (*num_runs >= 2) {
+        size_t n = *num_runs, i = n - 2;
+
+        if (
+            (n >= 3 && runs[n - 3].size <= runs[n - 2].size + runs[n - 1].size) ||
+            (n >= 4 && runs[n - 4].size <= runs[n - 3].size + runs[n - 2].size)
+        ) {
+            if (runs[n - 3].size < runs[n - 1].size) {
+                i = n - 3;
+            }
+        } else if (!force && runs[n - 2].size > runs[n - 1].size) {
+            break;
+        }
+
+        merge_runs(&runs[i], &runs[i + 1], compare);
+        if (i == n - 3) {
+            runs[n - 2] = runs[n - 1];
+        }
+        --*num_runs;
+    }
+}
+
+/*
+ * Detaches the run starting at @ref head into @ref run and returns the node following it. A strictly
+ * descending run is reversed. If @ref aside is non-NULL, lone stragglers (a node smaller than the run's tail
+ * that is followed by a node that is not) are moved to @ref aside instead of ending an ascending run that is
+ * already LIST_SORT_MIN_STRAGGLER_RUN long. Since
+ * the stragglers of a run all come from that run's span of the list, merging them back into the run (with
+ * ties going to the run) keeps the sort stable.
+ */
+static ListNode* detect_run(
+    ListRun *run,
+    ListNode *head,
+    ListRun *aside,
+    int (*compare)(const ListNode *a, const ListNode *b)
+) {
+    ListNode *cur = head, *next = head->next;
+
+    run->head = head;
+    run->tail = head;
+    run->size = 1;
+
+    if (aside) {
+        aside->head = NULL;
+        aside->tail = NULL;
+        aside->size = 0;
+    }
+
+    if (next && compare(cur, next) > 0) {
+        do {
+            cur = next;
+            next = cur->next;
+            cur->next = run->head;
+            run->head = cur;
+            ++run->size;
+        } while (next && compare(cur, next) > 0);
+    } else {
+        while (next) {
+            if (compare(cur, next) <= 0) {
+                cur = next;
+                next = cur->next;
+                ++run->size;
+            } else if (
+                aside &&
+                run->size >= LIST_SORT_MIN_STRAGGLER_RUN &&
+                next->next &&
+                compare(cur, next->next) <= 0
+            ) {
+                if (aside->tail) {
+                    aside->tail->next = next;
+                } else {
+                    aside->head = next;
+                }
+                aside->tail = next;
+                ++aside->size;
+
+                next = next->next;
+                cur->next = next;
+                cur = next;
+                next = cur->next;
+                ++run->size;
+            } else {
+                break;
+            }
+        }
+        run->tail = cur;
+    }
+
+    run->tail->next = NULL;
+    if (aside && aside->tail) {
+        aside->tail->next = NULL;
+    }
+
+    return next;
+}
+
+/* Orders entries by key, and by @ref compare on equal keys. */
+static int compare_entries(
+    const ListSortEntry *a,
+    const ListSortEntry *b,
+    int (*compare)(const ListNode *a, const ListNode *b)
+) {
+    if (a->key != b->key) {
+        return a->key < b->key ? -1 : 1;
+    }
+
+    return compare(a->node, b->node);
+}
+
+/* Stably sorts a small number of entries in place. */
+static void insertion_sort_entries(
+    ListSortEntry *entries,
+    size_t num_entries,
+    int (*compare)(const ListNode *a, const ListNode *b)
+) {
+    size_t i, j;
+
+    for (i = 1; i < num_entries; ++i) {
+        ListSortEntry tmp = entries[i];
+
+        for (j = i; j > 0 && compare_entries(&entries[j - 1], &tmp, compare) > 0; --j) {
+            entries[j] = entries[j - 1];
+        }
+
+        entries[j] = tmp;
+    }
+}
+
+/* Stably merges the sorted ranges @ref src[0, mid) and @ref src[mid, end) into @ref dst[0, end). */
+static void merge_entries(
+    const ListSortEntry *src,
+    ListSortEntry *dst,
+    size_t mid,
+    size_t end,
+    int (*compare)(const ListNode *a, const ListNode *b)
+) {
+    size_t i = 0, j = mid, k = 0;
+
+    if (mid < end && compare_entries(&src[mid - 1], &src[mid], compare) > 0) {
+        while (i < mid && j < end) {
+            dst[k++] = compare_entries(&src[j], &src[i], compare) < 0 ? src[j++] : src[i++];
+        }
+    }
+
+    while (i < mid) {
+        dst[k++] = src[i++];
+    }
+    while (j < end) {
+        dst[k++] = src[j++];
+    }
+}
+
+/*
+ * Stably sorts the entries by key with a LSD radix sort on 8-bit digits, ping-ponging between @ref src and
+ * @ref dst. Digits that are the same for every key are skipped. Returns the array holding the result.
+ */
+static ListSortEntry* radix_sort_entries(ListSortEntry *src, ListSortEntry *dst, size_t num_entries) {
+    size_t counts[256], shift, digit, sum, i;
+
+    for (shift = 0; shift < sizeof(size_t) * CHAR_BIT; shift += 8) {
+        ListSortEntry *tmp;
+
+        for (digit = 0; digit < 256; ++digit) {
+            counts[digit] = 0;
+        }
+        for (i = 0; i < num_entries; ++i) {
+            ++counts[(src[i].key >> shift) & 0xFF];
+        }
+        if (counts[(src[0].key >> shift) & 0xFF] == num_entries) {
+            continue;
+        }
+
+        for (sum = 0, digit = 0; digit < 256; ++digit) {
+            size_t count = counts[digit];
+            counts[digit] = sum;
+            sum += count;
+        }
+        for (i = 0; i < num_entries; ++i) {
+            dst[counts[(src[i].key >> shift) & 0xFF]++] = src[i];
+        }
+
+        tmp = src;
+        src = dst;
+        dst = tmp;
+    }
+
+    return src;
+}
+
+/* Sorts the piece of a @ref list_sort_parallel. */
+static void sort_task(ListSortTask *task) {
+    list_sort(&task->list, task->compare);
+}
+
+/* Stably merges the sorted piece @ref task->other into the sorted piece @ref task->list, which precedes it. */
+static void merge_task(ListSortTask *task) {
+    ListNode dummy, *tail, *a, *b;
+    List *list = &task->list, *other = &task->other;
+
+    if (!list->size || task->compare(list->tail, other->head) <= 0) {
+        list_splice_back(list, other);
+        return;
+    }
+
+    tail = &dummy;
+    a = list->head;
+    b = other->head;
+
+    while (a && b) {
+        if (task->compare(a, b) <= 0) {
+            tail->next = a;
+            a->prev = tail;
+            tail = a;
+            a = a->next;
+        } else {
+            tail->next = b;
+            b->prev = tail;
+            tail = b;
+            b = b->next;
+        }
+    }
+
+    if (a) {
+        tail->next = a;
+        a->prev = tail;
+    } else {
+        tail->next = b;
+        b->prev = tail;
+        list->tail = other->tail;
+    }
+
+    list->head = dummy.next;
+    list->head->prev = NULL;
+    list->size += other->size;
+    list_init(other);
+}
+
+/* Runs the tasks with the user's @ref execute function, or one after another if there is none. */
+static void run_tasks(
+    void (*run)(ListSortTask *task),
+    ListSortTask *tasks,
+    size_t num_tasks,
+    void (*execute)(
+        void (*run)(ListSortTask *task),
+        ListSortTask *tasks,
+        size_t num_tasks,
+        void *executor_data
+    ),
+    void *executor_data
+) {
+    size_t i;
+
+    if (execute) {
+        execute(run, tasks, num_tasks, executor_data);
+    } else {
+        for (i = 0; i < num_tasks; ++i) {
+            run(&tasks[i]);
+        }
+    }
+}
+
+/* ========================================================================================================
+ *
+ *                                        EXTERN FUNCTION DEFINITIONS
+ *
+ * ======================================================================================================== */
+
 void list_init(List *list) {
     assert(list);
 
@@ -322,3 +724,236 @@ void list_sort(List *list, int (*compare)(const ListNode *a, const ListNode *b))
     list->head = head;
     list->tail = tail;
 }
+
+void list_sort_natural(List *list, int (*compare)(const ListNode *a, const ListNode *b)) {
+    ListRun runs[LIST_SORT_MAX_RUNS], aside_runs[LIST_SORT_MAX_RUNS], aside;
+    ListNode *cur, *prev, *aside_cur;
+    size_t num_runs = 0, num_aside_runs;
+
+    assert(list && compare);
+
+    if (list->size < 2) {
+        return;
+    }
+
+    for (cur = list->head; cur; ) {
+        assert(num_runs < LIST_SORT_MAX_RUNS);
+
+        cur = detect_run(&runs[num_runs], cur, &aside, compare);
+
+        /* Sort the stragglers of the run, then merge them back in. */
+        if (aside.size > 0) {
+            num_aside_runs = 0;
+            for (aside_cur = aside.head; aside_cur; ) {
+                aside_cur = detect_run(&aside_runs[num_aside_runs++], aside_cur, NULL, compare);
+                collapse_runs(aside_runs, &num_aside_runs, 0, compare);
+            }
+            collapse_runs(aside_runs, &num_aside_runs, 1, compare);
+            merge_runs(&runs[num_runs], &aside_runs[0], compare);
+        }
+
+        ++num_runs;
+        collapse_runs(runs, &num_runs, 0, compare);
+    }
+
+    collapse_runs(runs, &num_runs, 1, compare);
+
+    /* Restore the "prev" members. */
+    for (prev = NULL, cur = runs[0].head; cur; prev = cur, cur = cur->next) {
+        cur->prev = prev;
+    }
+
+    list->head = runs[0].head;
+    list->tail = runs[0].tail;
+}
+
+void list_sort_buffered(
+    List *list,
+    ListSortEntry *buffer,
+    size_t (*key)(const ListNode *node),
+    int (*compare)(const ListNode *a, const ListNode *b)
+) {
+    ListSortEntry *src, *dst, *tmp;
+    ListNode *n, *prev;
+    size_t size, width, begin, i;
+
+    assert(list && buffer && (key || compare));
+
+    size = list->size;
+
+    if (size < 2) {
+        return;
+    }
+
+    /* Gather. */
+    for (i = 0, n = list->head; n; ++i, n = n->next) {
+        buffer[i].node = n;
+        buffer[i].key = key ? key(n) : 0;
+    }
+
+    /* Sort the contiguous entries. */
+    src = buffer;
+    dst = buffer + size;
+
+    if (!compare) {
+        src = radix_sort_entries(src, dst, size);
+    } else {
+        for (begin = 0; begin < size; begin += LIST_SORT_INSERTION_BLOCK) {
+            insertion_sort_entries(
+                src + begin,
+                size - begin < LIST_SORT_INSERTION_BLOCK ? size - begin : LIST_SORT_INSERTION_BLOCK,
+                compare
+            );
+        }
+
+        for (width = LIST_SORT_INSERTION_BLOCK; width < size; width *= 2) {
+            for (begin = 0; begin < size; begin += 2 * width) {
+                size_t mid = size - begin < width ? size - begin : width;
+                size_t end = size - begin < 2 * width ? size - begin : 2 * width;
+
+                merge_entries(src + begin, dst + begin, mid, end, compare);
+            }
+
+            tmp = src;
+            src = dst;
+            dst = tmp;
+        }
+    }
+
+    /* Relink. */
+    for (prev = NULL, i = 0; i < size; ++i) {
+        n = src[i].node;
+        n->prev = prev;
+        if (prev) {
+            prev->next = n;
+        }
+        prev = n;
+    }
+    prev->next = NULL;
+
+    list->head = src[0].node;
+    list->tail = prev;
+}
+
+void list_sort_radix(List *list, size_t (*key)(const ListNode *node)) {
+    ListNode *heads[256], *tails[256], *n, *next;
+    size_t first, varying, shift, digit;
+
+    assert(list && key);
+
+    if (list->size < 2) {
+        return;
+    }
+
+    /* Find the bytes that differ between keys; the others are skipped. */
+    first = key(list->head);
+    for (varying = 0, n = list->head->next; n; n = n->next) {
+        varying |= key(n) ^ first;
+    }
+
+    for (shift = 0; shift < sizeof(size_t) * CHAR_BIT; shift += 8) {
+        if (!((varying >> shift) & 0xFF)) {
+            continue;
+        }
+
+        /* Distribute into buckets, keeping the order within each. */
+        for (digit = 0; digit < 256; ++digit) {
+            heads[digit] = tails[digit] = NULL;
+        }
+        for (n = list->head; n; n = next) {
+            next = n->next;
+            digit = (key(n) >> shift) & 0xFF;
+
+            if (heads[digit]) {
+                tails[digit]->next = n;
+            } else {
+                heads[digit] = n;
+            }
+            tails[digit] = n;
+        }
+
+        /* Concatenate the buckets. */
+        for (n = NULL, digit = 0; digit < 256; ++digit) {
+            if (heads[digit]) {
+                if (n) {
+                    n->next = heads[digit];
+                } else {
+                    list->head = heads[digit];
+                }
+                n = tails[digit];
+            }
+        }
+        n->next = NULL;
+    }
+
+    /* Fix the "prev" pointers. */
+    list->head->prev = NULL;
+    for (n = list->head; n->next; n = n->next) {
+        n->next->prev = n;
+    }
+    list->tail = n;
+}
+
+void list_sort_parallel(
+    List *list,
+    int (*compare)(const ListNode *a, const ListNode *b),
+    ListSortTask *tasks,
+    size_t num_tasks,
+    void (*execute)(
+        void (*run)(ListSortTask *task),
+        ListSortTask *tasks,
+        size_t num_tasks,
+        void *executor_data
+    ),
+    void *executor_data
+) {
+    ListNode *from, *to;
+    size_t size, piece_size, i, j;
+
+    assert(list && compare && tasks && num_tasks > 0);
+
+    size = list->size;
+
+    if (num_tasks > size) {
+        num_tasks = size;
+    }
+    if (num_tasks < 2) {
+        list_sort(list, compare);
+        return;
+    }
+
+    /* Cut the list into pieces whose sizes differ by at most one. */
+    for (i = 0; i < num_tasks; ++i) {
+        piece_size = size / num_tasks + (i < size % num_tasks);
+
+        from = list->head;
+        for (to = from, j = 1; j < piece_size; ++j) {
+            to = to->next;
+        }
+
+        list_cut(list, from, to, piece_size);
+        list_init(&tasks[i].list);
+        list_init(&tasks[i].other);
+        list_paste(&tasks[i].list, NULL, from, to, NULL, piece_size);
+        tasks[i].compare = compare;
+    }
+
+    run_tasks(sort_task, tasks, num_tasks, execute, executor_data);
+
+    /* Merge adjacent pieces pairwise until one is left. */
+    while (num_tasks > 1) {
+        for (i = 0; i < num_tasks / 2; ++i) {
+            tasks[i].list = tasks[2 * i].list;
+            tasks[i].other = tasks[2 * i + 1].list;
+        }
+
+        run_tasks(merge_task, tasks, num_tasks / 2, execute, executor_data);
+
+        if (num_tasks % 2) {
+            tasks[num_tasks / 2].list = tasks[num_tasks - 1].list;
+        }
+        num_tasks = (num_tasks + 1) / 2;
+    }
+
+    list_splice_back(list, &tasks[0].list);
+}
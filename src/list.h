@@ -48,12 +48,15 @@ CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
  *
  * Dependencies:
  *      -   C89 assert.h
+ *      -   C89 limits.h
  *      -   C89 stddef.h
  *
  * API:
  *      ====  TYPES  ====
  *      -   typedef struct List List
  *      -   typedef struct ListNode ListNode
+ *      -   typedef struct ListSortEntry ListSortEntry
+ *      -   typedef struct ListSortTask ListSortTask
  *
  *      ====  FUNCTIONS  ====
  *      Initializers:
@@ -88,6 +91,10 @@ CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
  *          -   list_paste
  *      Sorting:
  *          -   list_sort
+ *          -   list_sort_natural
+ *          -   list_sort_buffered
+ *          -   list_sort_radix
+ *          -   list_sort_parallel
  *
  *      ====  MACROS  ====
  *      Constants:
@@ -100,6 +107,8 @@ CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
  *      Traversal:
  *          -   list_for_each
  *          -   list_for_each_reverse
+ *          -   list_for_each_prefetch
+ *          -   list_for_each_prefetch_reverse
  *          -   list_for_each_safe
  *          -   list_for_each_safe_reverse
  *          -   list_for_each_after
@@ -130,10 +139,14 @@ extern "C" {
 /* Struct type declarations. */
 struct List;
 struct ListNode;
+struct ListSortEntry;
+struct ListSortTask;
 
 /* Struct typedef's. */
 typedef struct List List;
 typedef struct ListNode ListNode;
+typedef struct ListSortEntry ListSortEntry;
+typedef struct ListSortTask ListSortTask;
 
 /**
  * Represents a doubly linked list.
@@ -152,6 +165,25 @@ struct ListNode {
     ListNode *next;
 };
 
+/**
+ * Represents an element of the scratch buffer used by @ref list_sort_buffered. Only needs to be declared by
+ * the user; its members are managed by @ref list_sort_buffered.
+ */
+struct ListSortEntry {
+    ListNode *node;
+    size_t key;
+};
+
+/**
+ * Represents a unit of work of @ref list_sort_parallel: sorting one piece of the @ref List, or merging two
+ * sorted pieces. Only needs to be declared by the user; its members are managed by @ref list_sort_parallel.
+ */
+struct ListSortTask {
+    List list;
+    List other;
+    int (*compare)(const ListNode *a, const ListNode *b);
+};
+
 /* ========================================================================================================
  *
  *                                               PROTOTYPES
@@ -555,6 +587,136 @@ void list_paste(List *list, ListNode *left, ListNode *from, ListNode *to, ListNo
  */
 void list_sort(List *list, int (*compare)(const ListNode *a, const ListNode *b));
 
+/**
+ * Uses a natural merge sort to sort the @ref list in-place. This sort is stable (order of "equal"
+ * @ref ListNode's is preserved). Unlike @ref list_sort, which always makes log(n) passes over the whole
+ * @ref list, this function first splits the @ref list into the ascending and strictly descending runs it
+ * already contains (reversing the latter), and then merges neighbouring runs of similar size, as TimSort
+ * does. Lone stragglers (e.g. a late event in a time-ordered @ref list) do not end a run; they are set aside
+ * and merged back into their run. A sorted or reversed @ref list is sorted with n - 1 comparisons, and a
+ * nearly sorted @ref list in close to linear time. This function uses an iterative algorithm rather than a
+ * recursive one. It keeps two fixed-size arrays of (3 * bits in size_t / 2) run descriptors on the stack.
+ *
+ * Requirements:
+ *      -   @ref list != NULL
+ *      -   @ref compare != NULL
+ *
+ * Time complexity:
+ *      -   O(nlog(r)), where r == number of runs in the @ref list
+ *
+ * @param list                  The @ref List to sort.
+ * @param compare               The compare function to be used.
+ */
+void list_sort_natural(List *list, int (*compare)(const ListNode *a, const ListNode *b));
+
+/**
+ * Sorts the @ref list using the user-supplied scratch @ref buffer. This sort is stable (order of "equal"
+ * @ref ListNode's is preserved). The @ref ListNode's (and, if @ref key is non-NULL, their keys) are gathered
+ * into the contiguous @ref buffer in one pass, the @ref buffer is sorted, and the @ref list is relinked in one
+ * more pass. Unlike @ref list_sort, which chases "next" pointers all over memory during every merge pass, the
+ * sorting itself only touches the @ref buffer, which makes this function several times faster on large
+ * lists. If @ref compare is NULL, the @ref buffer is sorted with a LSD radix sort on the keys; otherwise it is
+ * sorted with a merge sort that compares the keys first and only calls @ref compare on equal keys.
+ *
+ * The OPTIONAL @ref key function returns a number that is consistent with @ref compare (i.e. if
+ * key(a) < key(b), then compare(a, b) < 0), such as a timestamp or an ID, or a prefix of a string packed into
+ * a size_t. If @ref compare is NULL, @ref key alone defines the order.
+ *
+ * Requirements:
+ *      -   @ref list != NULL
+ *      -   @ref buffer != NULL
+ *      -   @ref buffer holds at least (2 * @ref list->size) entries
+ *      -   @ref key != NULL or @ref compare != NULL
+ *
+ * Time complexity:
+ *      -   O(nlog(n)) if @ref compare != NULL; otherwise O(n * bytes in size_t)
+ *
+ * @param list                  The @ref List to sort.
+ * @param buffer                The scratch buffer of at least (2 * @ref list->size) entries.
+ * @param key                   The OPTIONAL (i.e. can be NULL) key function to be used.
+ * @param compare               The OPTIONAL (i.e. can be NULL) compare function to be used.
+ */
+void list_sort_buffered(
+    List *list,
+    ListSortEntry *buffer,
+    size_t (*key)(const ListNode *node),
+    int (*compare)(const ListNode *a, const ListNode *b)
+);
+
+/**
+ * Uses a LSD radix sort to sort the @ref list in-place by the unsigned integer returned by @ref key, such as a
+ * timestamp or an ID. This sort is stable (order of @ref ListNode's with equal keys is preserved). Each pass
+ * distributes the @ref ListNode's into 256 buckets by one byte of their keys and relinks the buckets in order,
+ * so no comparisons are made and no memory is allocated. Bytes that are the same for every key are skipped,
+ * so small keys only take a pass or two.
+ *
+ * The keys are size_t, since C89 has no 64-bit integer type: where size_t is 32 bits, a 64-bit key such as a
+ * nanosecond timestamp would be truncated by @ref key. Since the sort is stable, such keys can be sorted by
+ * their low 32 bits first, and then by their high 32 bits.
+ *
+ * Requirements:
+ *      -   @ref list != NULL
+ *      -   @ref key != NULL
+ *
+ * Time complexity:
+ *      -   O(n * bytes in size_t)
+ *
+ * @param list                  The @ref List to sort.
+ * @param key                   The key function to be used.
+ */
+void list_sort_radix(List *list, size_t (*key)(const ListNode *node));
+
+/**
+ * Sorts the @ref list in parallel using up to @ref num_tasks threads of the user's choosing. The @ref list
+ * is cut into @ref num_tasks pieces, which are sorted concurrently with @ref list_sort, and then merged
+ * pairwise in concurrent rounds until one piece is left. Only adjacent pieces are merged, favoring the left
+ * one, so the result is identical to that of @ref list_sort: the sort is stable (order of "equal"
+ * @ref ListNode's is preserved).
+ *
+ * Threading is left to the OPTIONAL @ref execute function, so this function can run on any thread pool. It
+ * must call @ref run once on each of its @ref num_tasks tasks (in any order, and from any threads), and only
+ * return once all the calls have returned. If @ref execute is NULL, the tasks are run one after another on
+ * the calling thread. Example with OpenMP:
+ *
+ *      void execute(void (*run)(ListSortTask*), ListSortTask *tasks, size_t num_tasks, void *data) {
+ *          long i;
+ *
+ *          #pragma omp parallel for
+ *          for (i = 0; i < (long) num_tasks; ++i) {
+ *              run(&tasks[i]);
+ *          }
+ *      }
+ *
+ * Requirements:
+ *      -   @ref list != NULL
+ *      -   @ref compare != NULL
+ *      -   @ref tasks != NULL
+ *      -   @ref num_tasks > 0
+ *
+ * Time complexity:
+ *      -   O(nlog(n)), of which O((n / num_tasks)log(n / num_tasks) + n) on the critical path
+ *
+ * @param list                  The @ref List to sort.
+ * @param compare               The compare function to be used.
+ * @param tasks                 The array of at least @ref num_tasks tasks.
+ * @param num_tasks             The maximum number of pieces to sort concurrently.
+ * @param execute               The OPTIONAL (i.e. can be NULL) function that runs a batch of tasks.
+ * @param executor_data         The OPTIONAL (i.e. can be NULL) data passed to @ref execute.
+ */
+void list_sort_parallel(
+    List *list,
+    int (*compare)(const ListNode *a, const ListNode *b),
+    ListSortTask *tasks,
+    size_t num_tasks,
+    void (*execute)(
+        void (*run)(ListSortTask *task),
+        ListSortTask *tasks,
+        size_t num_tasks,
+        void *executor_data
+    ),
+    void *executor_data
+);
+
 /* ========================================================================================================
  *
  *                                                 MACROS
@@ -640,6 +802,55 @@ void list_sort(List *list, int (*compare)(const ListNode *a, const ListNode *b))
         cursor_node_ptr = cursor_node_ptr->prev \
     )
 
+/**
+ * Iterates over the @ref List from front to back, and prefetches the next @ref ListNode while the loop's body
+ * runs, so that the body overlaps with the cache miss of the next step. Worthwhile when the body does enough
+ * work to hide some of that latency. Without GNU extensions, this is simply @ref list_for_each.
+ *
+ * Requirements:
+ *      -   @ref list_ptr != NULL
+ *      -   The @ref cursor_node_ptr is neither reassigned nor removed from its associated @ref List in the
+ *          loop's body.
+ *
+ * @param cursor_node_ptr       The @ref ListNode to use as a loop cursor.
+ * @param list_ptr              The pointer to a @ref List that will be iterated over.
+ */
+#if defined(__GNUC__) && !defined(__STRICT_ANSI__)
+    #define list_for_each_prefetch(cursor_node_ptr, list_ptr) \
+        for ( \
+            cursor_node_ptr = (list_ptr)->head; \
+            cursor_node_ptr && (__builtin_prefetch(cursor_node_ptr->next), 1); \
+            cursor_node_ptr = cursor_node_ptr->next \
+        )
+#else
+    #define list_for_each_prefetch(cursor_node_ptr, list_ptr) \
+        list_for_each(cursor_node_ptr, list_ptr)
+#endif
+
+/**
+ * Iterates over the @ref List from back to front, and prefetches the previous @ref ListNode while the loop's
+ * body runs. Without GNU extensions, this is simply @ref list_for_each_reverse.
+ *
+ * Requirements:
+ *      -   @ref list_ptr != NULL
+ *      -   The @ref cursor_node_ptr is neither reassigned nor removed from its associated @ref List in the
+ *          loop's body.
+ *
+ * @param cursor_node_ptr       The @ref ListNode to use as a loop cursor.
+ * @param list_ptr              The pointer to a @ref List that will be iterated over.
+ */
+#if defined(__GNUC__) && !defined(__STRICT_ANSI__)
+    #define list_for_each_prefetch_reverse(cursor_node_ptr, list_ptr) \
+        for ( \
+            cursor_node_ptr = (list_ptr)->tail; \
+            cursor_node_ptr && (__builtin_prefetch(cursor_node_ptr->prev), 1); \
+            cursor_node_ptr = cursor_node_ptr->prev \
+        )
+#else
+    #define list_for_each_prefetch_reverse(cursor_node_ptr, list_ptr) \
+        list_for_each_reverse(cursor_node_ptr, list_ptr)
+#endif
+
 /**
  * Iterates over the @ref List from front to back, and is safe against reassignment and/or removal of the
  * @ref cursor_node_ptr.
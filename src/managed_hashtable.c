@@ -0,0 +1,342 @@
+/*
+Copyright (c) 2017, Michael J Welsh
+
+Permission to use, copy, modify, and/or distribute this software
+for any purpose with or without fee is hereby granted, provided
+that the above copyright notice and this permission notice appear
+in all copies.
+
+THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL
+WARRANTIES WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE
+AUTHOR BE LIABLE FOR ANY SPECIAL, DIRECT, INDIRECT, OR
+CONSEQUENTIAL DAMAGES OR ANY DAMAGES WHATSOEVER RESULTING FROM
+LOSS OF USE, DATA OR PROFITS, WHETHER IN AN ACTION OF CONTRACT,
+NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF OR IN
+CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+
+#include <assert.h>
+#include <stddef.h>
+#include <stdlib.h>
+
+#include "managed_hashtable.h"
+
+/* ========================================================================================================
+ *
+ *                                               STATIC DATA
+ *
+ * ======================================================================================================== */
+
+/*
+ * The largest primes below the powers of two, used as bucket counts. A prime number of buckets spreads
+ * hashcodes that share a common factor (e.g. aligned pointers, or keys that are all even) over every bucket,
+ * which a power of two would not.
+ */
+static const unsigned long primes[] = {
+    7UL, 13UL, 31UL, 61UL, 127UL, 251UL, 509UL, 1021UL, 2039UL, 4093UL, 8191UL, 16381UL, 32749UL, 65521UL,
+    131071UL, 262139UL, 524287UL, 1048573UL, 2097143UL, 4194301UL, 8388593UL, 16777213UL, 33554393UL,
+    67108859UL, 134217689UL, 268435399UL, 536870909UL, 1073741789UL, 2147483647UL, 4294967291UL
+};
+
+/* ========================================================================================================
+ *
+ *                                        STATIC FUNCTION PROTOTYPES
+ *
+ * ======================================================================================================== */
+
+/*
+ * Returns 1 if the @ref table has a bucket array of its own, i.e. is not using its single empty bucket.
+ */
+static int has_bucket_array(const ManagedHashTable *table);
+
+/*
+ * Frees the bucket array of the @ref table, if it has one, and goes back to the single empty bucket.
+ */
+static void free_bucket_array(ManagedHashTable *table);
+
+/*
+ * Returns the next number of buckets after @ref num_buckets, about twice as large.
+ */
+static size_t larger_num_buckets(size_t num_buckets);
+
+/*
+ * Returns the number of buckets before @ref num_buckets, about half as large, and at least
+ * @ref MANAGED_HASHTABLE_MIN_BUCKETS.
+ */
+static size_t smaller_num_buckets(size_t num_buckets);
+
+/*
+ * Returns the number of buckets needed to hold @ref num_nodes nodes without going above the maximum load
+ * factor, growing from the current number of buckets.
+ */
+static size_t grown_num_buckets(const ManagedHashTable *table, size_t num_nodes);
+
+/* ========================================================================================================
+ *
+ *                                        STATIC FUNCTION DEFINITIONS
+ *
+ * ======================================================================================================== */
+
+static int has_bucket_array(const ManagedHashTable *table) {
+    assert(table);
+
+    return table->hashtable.bucket_array != &table->empty_bucket;
+}
+
+static void free_bucket_array(ManagedHashTable *table) {
+    assert(table);
+
+    if (has_bucket_array(table)) {
+        if (table->deallocate) {
+            table->deallocate(
+                table->hashtable.bucket_array,
+                table->hashtable.num_buckets * sizeof(HashTableNode*),
+                table->allocator_data
+            );
+        } else {
+            free(table->hashtable.bucket_array);
+        }
+    }
+
+    table->empty_bucket = NULL;
+    table->hashtable.bucket_array = &table->empty_bucket;
+    table->hashtable.num_buckets = 1;
+}
+
+static size_t larger_num_buckets(size_t num_buckets) {
+    size_t i;
+
+    for (i = 0; i < sizeof(primes) / sizeof(primes[0]); ++i) {
+        if (primes[i] > num_buckets) {
+            return (size_t) primes[i];
+        }
+    }
+
+    return num_buckets * 2 + 1;
+}
+
+static size_t smaller_num_buckets(size_t num_buckets) {
+    size_t i, smaller = 0;
+
+    if (num_buckets > primes[sizeof(primes) / sizeof(primes[0]) - 1]) {
+        smaller = (num_buckets - 1) / 2;
+    } else {
+        for (i = 0; i < sizeof(primes) / sizeof(primes[0]) && primes[i] < num_buckets; ++i) {
+            smaller = (size_t) primes[i];
+        }
+    }
+
+    return smaller > MANAGED_HASHTABLE_MIN_BUCKETS ? smaller : MANAGED_HASHTABLE_MIN_BUCKETS;
+}
+
+static size_t grown_num_buckets(const ManagedHashTable *table, size_t num_nodes) {
+    size_t num_buckets;
+
+    assert(table);
+
+    num_buckets = has_bucket_array(table) ? table->hashtable.num_buckets : MANAGED_HASHTABLE_MIN_BUCKETS;
+
+    while (num_nodes * 100 > num_buckets * table->max_load) {
+        num_buckets = larger_num_buckets(num_buckets);
+    }
+
+    return num_buckets;
+}
+
+/* ========================================================================================================
+ *
+ *                                        EXTERN FUNCTION DEFINITIONS
+ *
+ * ======================================================================================================== */
+
+void managed_hashtable_init(
+    ManagedHashTable *table,
+    size_t (*hash)(const void *key),
+    int (*equal)(const void *key, const HashTableNode *node),
+    const void* (*node_key)(const HashTableNode *node),
+    void (*collide)(const HashTableNode *old_node, const HashTableNode *new_node, void *auxiliary_data),
+    void *auxiliary_data
+) {
+    assert(table && hash && equal && node_key);
+
+    hashtable_init(&table->hashtable, &table->empty_bucket, 1, hash, equal, collide, auxiliary_data);
+    table->node_key = node_key;
+    table->allocate = NULL;
+    table->deallocate = NULL;
+    table->allocator_data = NULL;
+    table->max_load = MANAGED_HASHTABLE_MAX_LOAD;
+    table->min_load = MANAGED_HASHTABLE_MIN_LOAD;
+}
+
+void managed_hashtable_set_allocator(
+    ManagedHashTable *table,
+    void* (*allocate)(size_t size, void *allocator_data),
+    void (*deallocate)(void *ptr, size_t size, void *allocator_data),
+    void *allocator_data
+) {
+    assert(table && ((!allocate && !deallocate) || (allocate && deallocate)) && table->hashtable.size == 0);
+
+    /* The bucket array left over from removals was allocated by the old functions. */
+    free_bucket_array(table);
+
+    table->allocate = allocate;
+    table->deallocate = deallocate;
+    table->allocator_data = allocator_data;
+}
+
+void managed_hashtable_set_load_factors(ManagedHashTable *table, size_t max_load, size_t min_load) {
+    assert(table && max_load > 0 && min_load * 4 <= max_load);
+
+    table->max_load = max_load;
+    table->min_load = min_load;
+}
+
+HashTable* managed_hashtable_hashtable(ManagedHashTable *table) {
+    assert(table);
+
+    return &table->hashtable;
+}
+
+size_t managed_hashtable_num_buckets(const ManagedHashTable *table) {
+    assert(table);
+
+    return table->hashtable.num_buckets;
+}
+
+size_t managed_hashtable_size(const ManagedHashTable *table) {
+    assert(table);
+
+    return table->hashtable.size;
+}
+
+int managed_hashtable_empty(const ManagedHashTable *table) {
+    assert(table);
+
+    return table->hashtable.size == 0;
+}
+
+int managed_hashtable_contains_key(const ManagedHashTable *table, const void *key) {
+    assert(table);
+
+    return hashtable_contains_key(&table->hashtable, key);
+}
+
+int managed_hashtable_reserve(ManagedHashTable *table, size_t num_nodes) {
+    size_t num_buckets;
+
+    assert(table);
+
+    num_buckets = grown_num_buckets(table, num_nodes);
+
+    if (has_bucket_array(table) && num_buckets == table->hashtable.num_buckets) {
+        return 1;
+    }
+
+    return managed_hashtable_rehash(table, num_buckets);
+}
+
+int managed_hashtable_rehash(ManagedHashTable *table, size_t num_buckets) {
+    HashTableNode **bucket_array, **bucket, *n, *next;
+    size_t i;
+
+    assert(table && num_buckets > 0);
+
+    if (table->allocate) {
+        bucket_array = (HashTableNode**) table->allocate(
+            num_buckets * sizeof(HashTableNode*),
+            table->allocator_data
+        );
+    } else {
+        bucket_array = (HashTableNode**) malloc(num_buckets * sizeof(HashTableNode*));
+    }
+
+    if (!bucket_array) {
+        return 0;
+    }
+
+    for (i = 0; i < num_buckets; ++i) {
+        bucket_array[i] = NULL;
+    }
+
+    for (i = 0; i < table->hashtable.num_buckets; ++i) {
+        for (n = table->hashtable.bucket_array[i]; n; n = next) {
+            next = n->next;
+            bucket = bucket_array + hashtable_hash_key(&table->hashtable, table->node_key(n)) % num_buckets;
+            n->next = *bucket;
+            *bucket = n;
+        }
+    }
+
+    free_bucket_array(table);
+    table->hashtable.bucket_array = bucket_array;
+    table->hashtable.num_buckets = num_buckets;
+
+    return 1;
+}
+
+void managed_hashtable_insert(ManagedHashTable *table, const void *key, HashTableNode *node) {
+    size_t size;
+
+    assert(table && node);
+
+    size = table->hashtable.size;
+    hashtable_insert(&table->hashtable, key, node);
+
+    /*
+     * Only an added node can raise the load factor, replacing one does not. Resizing is best effort, the node
+     * is in the current bucket array regardless.
+     */
+    if (table->hashtable.size != size) {
+        managed_hashtable_reserve(table, table->hashtable.size);
+    }
+}
+
+HashTableNode* managed_hashtable_insert_unique(
+    ManagedHashTable *table,
+    const void *key,
+    HashTableNode *node
+) {
+    HashTableNode *existing_node;
+
+    assert(table && node);
+
+    existing_node = hashtable_insert_unique(&table->hashtable, key, node);
+    if (!existing_node) {
+        managed_hashtable_reserve(table, table->hashtable.size);
+    }
+
+    return existing_node;
+}
+
+HashTableNode* managed_hashtable_lookup_key(const ManagedHashTable *table, const void *key) {
+    assert(table);
+
+    return hashtable_lookup_key(&table->hashtable, key);
+}
+
+void managed_hashtable_remove_key(ManagedHashTable *table, const void *key) {
+    size_t num_buckets;
+
+    assert(table);
+
+    hashtable_remove_key(&table->hashtable, key);
+
+    num_buckets = table->hashtable.num_buckets;
+
+    /* Like growing, shrinking is best effort. */
+    if (
+        has_bucket_array(table) &&
+        num_buckets > MANAGED_HASHTABLE_MIN_BUCKETS &&
+        table->hashtable.size * 100 < num_buckets * table->min_load
+    ) {
+        managed_hashtable_rehash(table, smaller_num_buckets(num_buckets));
+    }
+}
+
+void managed_hashtable_remove_all(ManagedHashTable *table) {
+    assert(table);
+
+    free_bucket_array(table);
+    table->hashtable.size = 0;
+}
@@ -0,0 +1,485 @@
+/*
+Copyright (c) 2017, Michael J Welsh
+
+Permission to use, copy, modify, and/or distribute this software
+for any purpose with or without fee is hereby granted, provided
+that the above copyright notice and this permission notice appear
+in all copies.
+
+THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL
+WARRANTIES WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE
+AUTHOR BE LIABLE FOR ANY SPECIAL, DIRECT, INDIRECT, OR
+CONSEQUENTIAL DAMAGES OR ANY DAMAGES WHATSOEVER RESULTING FROM
+LOSS OF USE, DATA OR PROFITS, WHETHER IN AN ACTION OF CONTRACT,
+NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF OR IN
+CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+
+/**
+ * @file    managed_hashtable.h
+ * @brief   MANAGED HASH TABLE
+ *
+ * A @ref ManagedHashTable is a @ref HashTable that allocates its own bucket array, grows it when the load
+ * factor (the number of @ref HashTableNode's per bucket) rises above a maximum, and shrinks it when the load
+ * factor falls below a minimum after removals. The number of buckets is a prime about twice as large (or
+ * half as large) as before, so hashcodes that share a common factor still spread over every bucket. A
+ * @ref ManagedHashTable MUST be initialized before it is used. Use a plain @ref HashTable when the bucket
+ * array must be provided by the user (e.g. on embedded systems without an allocator).
+ *
+ * Since a @ref HashTableNode does not store its key, the user is required to define a node_key function,
+ * which returns the key of a @ref HashTableNode, so that the @ref HashTableNode's can be moved to their new
+ * buckets when the bucket array is resized. The hash, equal and collide functions are the same as those of a
+ * @ref HashTable.
+ *
+ * Bucket arrays are allocated with malloc() and freed with free(), unless allocation functions are given
+ * with @ref managed_hashtable_set_allocator (e.g. to allocate them from an @ref Arena, with a deallocate
+ * function that does nothing). A @ref ManagedHashTable has no bucket array until the first insertion, and
+ * after @ref managed_hashtable_remove_all. Resizing is best effort: if a bucket array cannot be allocated,
+ * the @ref ManagedHashTable keeps its current bucket array, so insertion never fails.
+ *
+ * The @ref HashTable inside a @ref ManagedHashTable can be obtained with
+ * @ref managed_hashtable_hashtable, and used with every @ref HashTable function and macro that does NOT
+ * insert or remove @ref HashTableNode's (e.g. @ref hashtable_lookup_key_hashed, @ref hashtable_for_each,
+ * @ref hashtable_seed). A @ref ManagedHashTable refers to itself, so it must NOT be copied.
+ *
+ * Example:
+ *          struct Object {
+ *              int key;
+ *              int val;
+ *              HashTableNode n;
+ *          };
+ *
+ *          size_t hash(const void *key) {
+ *              return *(const int*)key;
+ *          }
+ *
+ *          int equal(const void *key, const HashTableNode *node) {
+ *              return *(const int*)key == hashtable_entry(node, struct Object, n)->key;
+ *          }
+ *
+ *          const void* node_key(const HashTableNode *node) {
+ *              return &hashtable_entry(node, struct Object, n)->key;
+ *          }
+ *
+ *          int main(void) {
+ *              struct Object objs[1000];
+ *              ManagedHashTable table;
+ *              int i;
+ *
+ *              managed_hashtable_init(&table, hash, equal, node_key, NULL, NULL);
+ *
+ *              for (i = 0; i < 1000; ++i) {
+ *                  objs[i].key = i;
+ *                  objs[i].val = i * i;
+ *                  managed_hashtable_insert(&table, &objs[i].key, &objs[i].n);
+ *              }
+ *              assert(managed_hashtable_num_buckets(&table) >= 1000 * 100 / MANAGED_HASHTABLE_MAX_LOAD);
+ *
+ *              i = 10;
+ *              assert(managed_hashtable_contains_key(&table, &i));
+ *
+ *              managed_hashtable_remove_all(&table);
+ *              return 0;
+ *          }
+ *
+ * Dependencies:
+ *      -   C89 assert.h
+ *      -   C89 stddef.h
+ *      -   C89 stdlib.h
+ *      -   hashtable.h/hashtable.c
+ *
+ * API:
+ *      ====  TYPES  ====
+ *      -   typedef struct ManagedHashTable ManagedHashTable
+ *
+ *      ====  FUNCTIONS  ====
+ *      Initializers:
+ *          -   managed_hashtable_init
+ *          -   managed_hashtable_set_allocator
+ *          -   managed_hashtable_set_load_factors
+ *      Properties:
+ *          -   managed_hashtable_hashtable
+ *          -   managed_hashtable_num_buckets
+ *          -   managed_hashtable_size
+ *          -   managed_hashtable_empty
+ *          -   managed_hashtable_contains_key
+ *      Resizing:
+ *          -   managed_hashtable_reserve
+ *          -   managed_hashtable_rehash
+ *      Insertion:
+ *          -   managed_hashtable_insert
+ *          -   managed_hashtable_insert_unique
+ *      Lookup:
+ *          -   managed_hashtable_lookup_key
+ *      Removal:
+ *          -   managed_hashtable_remove_key
+ *          -   managed_hashtable_remove_all
+ *
+ *      ====  MACROS  ====
+ *      Constants:
+ *          -   MANAGED_HASHTABLE_MIN_BUCKETS
+ *          -   MANAGED_HASHTABLE_MAX_LOAD
+ *          -   MANAGED_HASHTABLE_MIN_LOAD
+ */
+
+#ifndef MANAGED_HASHTABLE_H
+#define MANAGED_HASHTABLE_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif /* __cplusplus */
+
+#include <stddef.h>
+
+#include "hashtable.h"
+
+/* ========================================================================================================
+ *
+ *                                                  TYPES
+ *
+ * ======================================================================================================== */
+
+/* Struct type declarations. */
+struct ManagedHashTable;
+
+/* Struct typedef's. */
+typedef struct ManagedHashTable ManagedHashTable;
+
+/**
+ * Represents a hash table that manages its own bucket array.
+ */
+struct ManagedHashTable {
+    HashTable hashtable;
+    HashTableNode *empty_bucket;
+    const void* (*node_key)(const HashTableNode *node);
+    void* (*allocate)(size_t size, void *allocator_data);
+    void (*deallocate)(void *ptr, size_t size, void *allocator_data);
+    void *allocator_data;
+    size_t max_load;
+    size_t min_load;
+};
+
+/* ========================================================================================================
+ *
+ *                                               PROTOTYPES
+ *
+ * ======================================================================================================== */
+
+/**
+ * Initializes the @ref table, with the default load factors and no bucket array. Use
+ * @ref managed_hashtable_remove_all to reset a @ref table that is not empty, otherwise its bucket array is
+ * leaked.
+ *
+ * Requirements:
+ *      -   @ref table != NULL
+ *      -   @ref hash != NULL
+ *      -   @ref equal != NULL
+ *      -   @ref node_key != NULL
+ *
+ * Time complexity:
+ *      -   O(1)
+ *
+ * @param table                 The @ref ManagedHashTable to be initialized.
+ * @param hash                  The callback function used to hash a key.
+ * @param equal                 The callback function used to to determine if a key is equal to the key of a
+ *                              @ref HashTableNode.
+ * @param node_key              The callback function used to obtain the key of a @ref HashTableNode.
+ * @param collide               The OPTIONAL (i.e. can be NULL) callback function used to handle key
+ *                              collisions. See @ref hashtable_init.
+ * @param auxiliary_data        The auxiliary data passed to the OPTIONAL @ref collide callback function if
+ *                              the @ref collide callback function is non-NULL. This data is NEVER manipulated
+ *                              by the @ref table.
+ */
+void managed_hashtable_init(
+    ManagedHashTable *table,
+    size_t (*hash)(const void *key),
+    int (*equal)(const void *key, const HashTableNode *node),
+    const void* (*node_key)(const HashTableNode *node),
+    void (*collide)(const HashTableNode *old_node, const HashTableNode *new_node, void *auxiliary_data),
+    void *auxiliary_data
+);
+
+/**
+ * Sets the functions the @ref table allocates and frees its bucket arrays with. Passing NULL for both
+ * functions goes back to malloc() and free().
+ *
+ * Requirements:
+ *      -   @ref table != NULL
+ *      -   Either @ref allocate and @ref deallocate are both NULL, or are both non-NULL
+ *      -   The @ref table is empty.
+ *
+ * Time complexity:
+ *      -   O(1)
+ *
+ * @param table                 The @ref ManagedHashTable to be operated on.
+ * @param allocate              The OPTIONAL (i.e. can be NULL) function used to allocate a bucket array of
+ *                              @ref size bytes. Returns NULL on failure.
+ * @param deallocate            The OPTIONAL (i.e. can be NULL) function used to free a bucket array of
+ *                              @ref size bytes allocated by @ref allocate.
+ * @param allocator_data        The OPTIONAL (i.e. can be NULL) data passed to @ref allocate and
+ *                              @ref deallocate. This data is NEVER manipulated by the @ref table.
+ */
+void managed_hashtable_set_allocator(
+    ManagedHashTable *table,
+    void* (*allocate)(size_t size, void *allocator_data),
+    void (*deallocate)(void *ptr, size_t size, void *allocator_data),
+    void *allocator_data
+);
+
+/**
+ * Sets the load factors of the @ref table, in percent (i.e. 100 means one @ref HashTableNode per bucket on
+ * average). The bucket array grows when an insertion would bring the load factor above @ref max_load, and
+ * shrinks when a removal brings it below @ref min_load. The new load factors take effect on the next
+ * insertion or removal.
+ *
+ * Requirements:
+ *      -   @ref table != NULL
+ *      -   @ref max_load > 0
+ *      -   @ref min_load * 4 <= @ref max_load, so that resizing the bucket array does not make it resize back
+ *
+ * Time complexity:
+ *      -   O(1)
+ *
+ * @param table                 The @ref ManagedHashTable to be operated on.
+ * @param max_load              The maximum load factor, in percent.
+ * @param min_load              The minimum load factor, in percent. If 0, the bucket array never shrinks.
+ */
+void managed_hashtable_set_load_factors(ManagedHashTable *table, size_t max_load, size_t min_load);
+
+/**
+ * Returns the @ref HashTable inside the @ref table. It can be used with every @ref HashTable function and
+ * macro that does NOT insert or remove @ref HashTableNode's.
+ *
+ * Requirements:
+ *      -   @ref table != NULL
+ *
+ * Time complexity:
+ *      -   O(1)
+ *
+ * @param table                 The @ref ManagedHashTable whose "hashtable" member will be returned.
+ * @return                      &@ref table->hashtable.
+ */
+HashTable* managed_hashtable_hashtable(ManagedHashTable *table);
+
+/**
+ * Returns the number of buckets of the @ref table. A @ref table without a bucket array has one bucket.
+ *
+ * Requirements:
+ *      -   @ref table != NULL
+ *
+ * Time complexity:
+ *      -   O(1)
+ *
+ * @param table                 The @ref ManagedHashTable to be operated on.
+ * @return                      The number of buckets.
+ */
+size_t managed_hashtable_num_buckets(const ManagedHashTable *table);
+
+/**
+ * Returns the number of @ref HashTableNode's in the @ref table.
+ *
+ * Requirements:
+ *      -   @ref table != NULL
+ *
+ * Time complexity:
+ *      -   O(1)
+ *
+ * @param table                 The @ref ManagedHashTable to be operated on.
+ * @return                      The number of @ref HashTableNode's.
+ */
+size_t managed_hashtable_size(const ManagedHashTable *table);
+
+/**
+ * Determines if the @ref table is empty.
+ *
+ * Requirements:
+ *      -   @ref table != NULL
+ *
+ * Time complexity:
+ *      -   O(1)
+ *
+ * @param table                 The @ref ManagedHashTable to be operated on.
+ * @return                      1 if the @ref table is empty, otherwise 0.
+ */
+int managed_hashtable_empty(const ManagedHashTable *table);
+
+/**
+ * Determines if the @ref table contains the @ref key.
+ *
+ * Requirements:
+ *      -   @ref table != NULL
+ *
+ * Time complexity:
+ *      -   O(1) on average
+ *
+ * @param table                 The @ref ManagedHashTable to be operated on.
+ * @param key                   The key used for lookup.
+ * @return                      1 if the @ref table contains the @ref key, otherwise 0.
+ */
+int managed_hashtable_contains_key(const ManagedHashTable *table, const void *key);
+
+/**
+ * Grows the bucket array of the @ref table, if needed, so that it can hold @ref num_nodes
+ * @ref HashTableNode's without going above the maximum load factor. Use this before inserting many
+ * @ref HashTableNode's to avoid growing the bucket array several times. The bucket array does not shrink
+ * below this size until the next removal.
+ *
+ * Requirements:
+ *      -   @ref table != NULL
+ *
+ * Time complexity:
+ *      -   O(n + m), where m == number of buckets in the new bucket array, if the bucket array grows
+ *      -   O(1) otherwise
+ *
+ * @param table                 The @ref ManagedHashTable to be operated on.
+ * @param num_nodes             The number of @ref HashTableNode's to make room for.
+ * @return                      1 on success, 0 if the bucket array could not be allocated.
+ */
+int managed_hashtable_reserve(ManagedHashTable *table, size_t num_nodes);
+
+/**
+ * Moves every @ref HashTableNode of the @ref table into a new bucket array of @ref num_buckets buckets, and
+ * frees the old bucket array. The load factors are NOT checked.
+ *
+ * Requirements:
+ *      -   @ref table != NULL
+ *      -   @ref num_buckets > 0
+ *
+ * Time complexity:
+ *      -   O(n + m), where m == @ref num_buckets
+ *
+ * @param table                 The @ref ManagedHashTable to be operated on.
+ * @param num_buckets           The number of buckets in the new bucket array.
+ * @return                      1 on success, 0 if the bucket array could not be allocated, in which case the
+ *                              @ref table is left untouched.
+ */
+int managed_hashtable_rehash(ManagedHashTable *table, size_t num_buckets);
+
+/**
+ * Inserts the @ref node into the @ref table, replacing the @ref HashTableNode with the same @ref key if there
+ * is one (see @ref hashtable_insert). Then grows the bucket array if the @ref node was added, rather than
+ * replacing another one, and brought the load factor above the maximum.
+ *
+ * Requirements:
+ *      -   @ref table != NULL
+ *      -   @ref node != NULL
+ *      -   @ref key is the key of the @ref node, i.e. the one returned by node_key.
+ *
+ * Time complexity:
+ *      -   Amortized: O(1) on average
+ *
+ * @param table                 The @ref ManagedHashTable to be operated on.
+ * @param key                   The key of the @ref node.
+ * @param node                  The @ref HashTableNode to be inserted.
+ */
+void managed_hashtable_insert(ManagedHashTable *table, const void *key, HashTableNode *node);
+
+/**
+ * Inserts the @ref node into the @ref table only if no @ref HashTableNode has the same @ref key (see
+ * @ref hashtable_insert_unique). Then grows the bucket array if the @ref node was inserted and brought the
+ * load factor above the maximum.
+ *
+ * Requirements:
+ *      -   @ref table != NULL
+ *      -   @ref node != NULL
+ *      -   @ref key is the key of the @ref node, i.e. the one returned by node_key.
+ *
+ * Time complexity:
+ *      -   Amortized: O(1) on average
+ *
+ * @param table                 The @ref ManagedHashTable to be operated on.
+ * @param key                   The key of the @ref node.
+ * @param node                  The @ref HashTableNode to be inserted.
+ * @return                      NULL if the @ref node was inserted, otherwise the already existing
+ *                              @ref HashTableNode with the same @ref key.
+ */
+HashTableNode* managed_hashtable_insert_unique(
+    ManagedHashTable *table,
+    const void *key,
+    HashTableNode *node
+);
+
+/**
+ * Returns the @ref HashTableNode associated with the @ref key in the @ref table. NULL if a match for the
+ * @ref key is not found.
+ *
+ * Requirements:
+ *      -   @ref table != NULL
+ *
+ * Time complexity:
+ *      -   O(1) on average
+ *
+ * @param table                 The @ref ManagedHashTable to be operated on.
+ * @param key                   The key used for lookup.
+ * @return                      The @ref HashTableNode associated with the @ref key, or NULL.
+ */
+HashTableNode* managed_hashtable_lookup_key(const ManagedHashTable *table, const void *key);
+
+/**
+ * Removes the @ref HashTableNode associated with the @ref key from the @ref table, if there is one. Shrinks
+ * the bucket array afterwards if the load factor fell below the minimum, down to
+ * @ref MANAGED_HASHTABLE_MIN_BUCKETS buckets.
+ *
+ * Requirements:
+ *      -   @ref table != NULL
+ *
+ * Time complexity:
+ *      -   Amortized: O(1) on average
+ *
+ * @param table                 The @ref ManagedHashTable to be operated on.
+ * @param key                   The key used for lookup.
+ */
+void managed_hashtable_remove_key(ManagedHashTable *table, const void *key);
+
+/**
+ * Removes all the @ref HashTableNode's from the @ref table, and frees its bucket array. The @ref table can
+ * be used again afterwards.
+ *
+ * Requirements:
+ *      -   @ref table != NULL
+ *
+ * Time complexity:
+ *      -   O(1), plus the time taken by the deallocate function
+ *
+ * @param table                 The @ref ManagedHashTable to be operated on.
+ */
+void managed_hashtable_remove_all(ManagedHashTable *table);
+
+/* ========================================================================================================
+ *
+ *                                                 MACROS
+ *
+ * ======================================================================================================== */
+
+/**
+ * The number of buckets of the first bucket array of a @ref ManagedHashTable, and the number of buckets
+ * below which it never shrinks. Can be overridden by defining it when compiling managed_hashtable.c.
+ */
+#ifndef MANAGED_HASHTABLE_MIN_BUCKETS
+    #define MANAGED_HASHTABLE_MIN_BUCKETS 7
+#endif
+
+/**
+ * The default maximum load factor of a @ref ManagedHashTable, in percent. Measured with
+ * bench_managed_hashtable, lookups at 100 are as fast as at 50 or 75 with half the bucket memory, while
+ * lookups at 150 and above are about 40% slower. Can be overridden by defining it when compiling
+ * managed_hashtable.c.
+ */
+#ifndef MANAGED_HASHTABLE_MAX_LOAD
+    #define MANAGED_HASHTABLE_MAX_LOAD 100
+#endif
+
+/**
+ * The default minimum load factor of a @ref ManagedHashTable, in percent. Can be overridden by defining it
+ * when compiling managed_hashtable.c.
+ */
+#ifndef MANAGED_HASHTABLE_MIN_LOAD
+    #define MANAGED_HASHTABLE_MIN_LOAD 25
+#endif
+
+#ifdef __cplusplus
+}
+#endif /* __cplusplus */
+
+#endif /* MANAGED_HASHTABLE_H */
@@ -0,0 +1,718 @@
+/*
+Copyright (c) 2017, Michael J Welsh
+
+Permission to use, copy, modify, and/or distribute this software
+for any purpose with or without fee is hereby granted, provided
+that the above copyright notice and this permission notice appear
+in all copies.
+
+THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL
+WARRANTIES WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE
+AUTHOR BE LIABLE FOR ANY SPECIAL, DIRECT, INDIRECT, OR
+CONSEQUENTIAL DAMAGES OR ANY DAMAGES WHATSOEVER RESULTING FROM
+LOSS OF USE, DATA OR PROFITS, WHETHER IN AN ACTION OF CONTRACT,
+NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF OR IN
+CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+
+#include <assert.h>
+#include <stddef.h>
+
+#include "offset_rbtree.h"
+
+/* ========================================================================================================
+ *
+ *                                        STATIC FUNCTION PROTOTYPES
+ *
+ * ======================================================================================================== */
+
+/*
+ * Returns the @ref OffsetRBTreeNode the @ref link refers to, or NULL if the @ref link is 0.
+ */
+static OffsetRBTreeNode* follow(const ptrdiff_t *link);
+
+/*
+ * Makes the @ref link refer to the @ref node, or to NULL if @ref node == NULL.
+ */
+static void point(ptrdiff_t *link, const OffsetRBTreeNode *node);
+
+/*
+ * Returns the parent of the @ref node.
+ */
+static OffsetRBTreeNode* parent(const OffsetRBTreeNode *node);
+
+/*
+ * Returns the left child of the @ref node.
+ */
+static OffsetRBTreeNode* left(const OffsetRBTreeNode *node);
+
+/*
+ * Returns the right child of the @ref node.
+ */
+static OffsetRBTreeNode* right(const OffsetRBTreeNode *node);
+
+/*
+ * Returns the link referring to the @ref node, i.e. the "root" member of the @ref tree or a child link of
+ * the parent of the @ref node.
+ */
+static ptrdiff_t* link_to(OffsetRBTree *tree, const OffsetRBTreeNode *node);
+
+/*
+ * Returns the color of the @ref node. If @ref node == NULL, return @ref OFFSET_RBTREE_NODE_BLACK.
+ */
+static OffsetRBTreeNodeColor color(const OffsetRBTreeNode *node);
+
+/*
+ * Returns the sibling of the @ref node.
+ */
+static OffsetRBTreeNode* sibling(const OffsetRBTreeNode *node);
+
+/*
+ * Returns the grandparent of the @ref node.
+ */
+static OffsetRBTreeNode* grandparent(const OffsetRBTreeNode *node);
+
+/*
+ * Returns the uncle of the @ref node.
+ */
+static OffsetRBTreeNode* uncle(const OffsetRBTreeNode *node);
+
+/*
+ * Replaces the @ref old_node with the @ref new_node in the @ref tree.
+ */
+static void replace(OffsetRBTree *tree, OffsetRBTreeNode *old_node, OffsetRBTreeNode *new_node);
+
+/*
+ * Performs a transplant on the @ref old_node and the @ref new_node in the @ref tree.
+ */
+static void transplant(OffsetRBTree *tree, OffsetRBTreeNode *old_node, OffsetRBTreeNode *new_node);
+
+/*
+ * Swaps the places of the @ref high_node and @ref low_node in the @ref tree. The @ref high_node must be
+ * higher in the @ref tree than the @ref low_node. Unlike in rbtree.c, the nodes can NOT be swapped by copying
+ * them, since their links are relative to their own addresses.
+ */
+static void swap_places(OffsetRBTree *tree, OffsetRBTreeNode *high_node, OffsetRBTreeNode *low_node);
+
+/*
+ * Performs a left rotation around the @ref node in the @ref tree.
+ */
+static void rotate_left(OffsetRBTree *tree, OffsetRBTreeNode *node);
+
+/*
+ * Performs a right rotation around the @ref node in the @ref tree.
+ */
+static void rotate_right(OffsetRBTree *tree, OffsetRBTreeNode *node);
+
+/*
+ * Repairs the @ref tree after the insertion of the @ref node.
+ */
+static void repair_after_insert(OffsetRBTree *tree, OffsetRBTreeNode *node);
+
+/*
+ * Repairs the @ref tree after the removal of the @ref node.
+ */
+static void repair_after_remove(OffsetRBTree *tree, OffsetRBTreeNode *node);
+
+/* ========================================================================================================
+ *
+ *                                        STATIC FUNCTION DEFINITIONS
+ *
+ * ======================================================================================================== */
+
+static OffsetRBTreeNode* follow(const ptrdiff_t *link) {
+    assert(link);
+
+    return *link ? (OffsetRBTreeNode*) ((const char*) link + *link) : NULL;
+}
+
+static void point(ptrdiff_t *link, const OffsetRBTreeNode *node) {
+    assert(link);
+
+    *link = node ? (const char*) node - (const char*) link : 0;
+}
+
+static OffsetRBTreeNode* parent(const OffsetRBTreeNode *node) {
+    assert(node);
+
+    return follow(&node->parent);
+}
+
+static OffsetRBTreeNode* left(const OffsetRBTreeNode *node) {
+    assert(node);
+
+    return follow(&node->left_child);
+}
+
+static OffsetRBTreeNode* right(const OffsetRBTreeNode *node) {
+    assert(node);
+
+    return follow(&node->right_child);
+}
+
+static ptrdiff_t* link_to(OffsetRBTree *tree, const OffsetRBTreeNode *node) {
+    OffsetRBTreeNode *p;
+
+    assert(tree && node);
+
+    p = parent(node);
+
+    if (!p) {
+        return &tree->root;
+    } else if (left(p) == node) {
+        return &p->left_child;
+    } else {
+        return &p->right_child;
+    }
+}
+
+static OffsetRBTreeNodeColor color(const OffsetRBTreeNode *node) {
+    return node ? node->color : OFFSET_RBTREE_NODE_BLACK;
+}
+
+static OffsetRBTreeNode* sibling(const OffsetRBTreeNode *node) {
+    assert(node && parent(node));
+
+    if (node == left(parent(node))) {
+        return right(parent(node));
+    } else {
+        return left(parent(node));
+    }
+}
+
+static OffsetRBTreeNode* grandparent(const OffsetRBTreeNode *node) {
+    assert(node && parent(node) && parent(parent(node)));
+
+    return parent(parent(node));
+}
+
+static OffsetRBTreeNode* uncle(const OffsetRBTreeNode *node) {
+    assert(node && parent(node) && parent(parent(node)));
+
+    return sibling(parent(node));
+}
+
+static void replace(OffsetRBTree *tree, OffsetRBTreeNode *old_node, OffsetRBTreeNode *new_node) {
+    OffsetRBTreeNode *p, *l, *r;
+
+    assert(tree && old_node && new_node);
+
+    p = parent(old_node);
+    l = left(old_node);
+    r = right(old_node);
+
+    point(link_to(tree, old_node), new_node);
+
+    if (l) {
+        point(&l->parent, new_node);
+    }
+
+    if (r) {
+        point(&r->parent, new_node);
+    }
+
+    point(&new_node->parent, p);
+    point(&new_node->left_child, l);
+    point(&new_node->right_child, r);
+    new_node->color = old_node->color;
+
+    old_node->parent = 0;
+    old_node->left_child = 0;
+    old_node->right_child = 0;
+}
+
+static void transplant(OffsetRBTree *tree, OffsetRBTreeNode *old_node, OffsetRBTreeNode *new_node) {
+    assert(tree && old_node);
+
+    point(link_to(tree, old_node), new_node);
+
+    if (new_node) {
+        point(&new_node->parent, parent(old_node));
+    }
+}
+
+static void swap_places(OffsetRBTree *tree, OffsetRBTreeNode *high_node, OffsetRBTreeNode *low_node) {
+    OffsetRBTreeNode *high_parent, *high_left, *high_right, *low_parent, *low_left, *low_right;
+    OffsetRBTreeNodeColor high_color;
+    ptrdiff_t *high_link, *low_link;
+
+    assert(tree && high_node && low_node);
+
+    high_parent = parent(high_node);
+    high_left = left(high_node);
+    high_right = right(high_node);
+    high_color = high_node->color;
+    low_parent = parent(low_node);
+    low_left = left(low_node);
+    low_right = right(low_node);
+    high_link = link_to(tree, high_node);
+    low_link = link_to(tree, low_node);
+
+    /* Every link is first read as a pointer, then rewritten relative to its (possibly new) place. */
+    point(high_link, low_node);
+
+    if (low_parent != high_node) {
+        point(low_link, high_node);
+    }
+
+    point(&low_node->parent, high_parent);
+    point(&low_node->left_child, high_left == low_node ? high_node : high_left);
+    point(&low_node->right_child, high_right == low_node ? high_node : high_right);
+    high_node->color = low_node->color;
+    low_node->color = high_color;
+
+    point(&high_node->parent, low_parent == high_node ? low_node : low_parent);
+    point(&high_node->left_child, low_left);
+    point(&high_node->right_child, low_right);
+
+    if (high_left && high_left != low_node) {
+        point(&high_left->parent, low_node);
+    }
+
+    if (high_right && high_right != low_node) {
+        point(&high_right->parent, low_node);
+    }
+
+    if (low_left) {
+        point(&low_left->parent, high_node);
+    }
+
+    if (low_right) {
+        point(&low_right->parent, high_node);
+    }
+}
+
+static void rotate_left(OffsetRBTree *tree, OffsetRBTreeNode *node) {
+    OffsetRBTreeNode *n;
+
+    assert(tree && node);
+
+    n = right(node);
+
+    transplant(tree, node, n);
+
+    point(&node->right_child, left(n));
+
+    if (left(n)) {
+        point(&left(n)->parent, node);
+    }
+
+    point(&n->left_child, node);
+    point(&node->parent, n);
+}
+
+static void rotate_right(OffsetRBTree *tree, OffsetRBTreeNode *node) {
+    OffsetRBTreeNode *n;
+
+    assert(tree && node);
+
+    n = left(node);
+
+    transplant(tree, node, n);
+
+    point(&node->left_child, right(n));
+
+    if (right(n)) {
+        point(&right(n)->parent, node);
+    }
+
+    point(&n->right_child, node);
+    point(&node->parent, n);
+}
+
+static void repair_after_insert(OffsetRBTree *tree, OffsetRBTreeNode *node) {
+    assert(tree && node);
+
+    for ( ; ; ) {
+        if (!parent(node)) {
+            node->color = OFFSET_RBTREE_NODE_BLACK;
+
+            break;
+        }
+
+        if (color(parent(node)) == OFFSET_RBTREE_NODE_BLACK) {
+            break;
+        }
+
+        if (color(uncle(node)) == OFFSET_RBTREE_NODE_RED) {
+            parent(node)->color = OFFSET_RBTREE_NODE_BLACK;
+            uncle(node)->color = OFFSET_RBTREE_NODE_BLACK;
+            grandparent(node)->color = OFFSET_RBTREE_NODE_RED;
+            node = grandparent(node);
+
+            continue;
+        }
+
+        if (node == right(parent(node)) && parent(node) == left(grandparent(node))) {
+            rotate_left(tree, parent(node));
+
+            node = left(node);
+        } else if (node == left(parent(node)) && parent(node) == right(grandparent(node))) {
+            rotate_right(tree, parent(node));
+
+            node = right(node);
+        }
+
+        parent(node)->color = OFFSET_RBTREE_NODE_BLACK;
+        grandparent(node)->color = OFFSET_RBTREE_NODE_RED;
+
+        if (node == left(parent(node)) && parent(node) == left(grandparent(node))) {
+            rotate_right(tree, grandparent(node));
+        } else {
+            rotate_left(tree, grandparent(node));
+        }
+
+        break;
+    }
+}
+
+static void repair_after_remove(OffsetRBTree *tree, OffsetRBTreeNode *node) {
+    assert(tree && node);
+
+    for ( ; ; ) {
+        if (!parent(node)) {
+            break;
+        }
+
+        if (color(sibling(node)) == OFFSET_RBTREE_NODE_RED) {
+            parent(node)->color = OFFSET_RBTREE_NODE_RED;
+            sibling(node)->color = OFFSET_RBTREE_NODE_BLACK;
+
+            if (node == left(parent(node))) {
+                rotate_left(tree, parent(node));
+            } else {
+                rotate_right(tree, parent(node));
+            }
+        }
+
+        if (
+            color(parent(node)) == OFFSET_RBTREE_NODE_BLACK &&
+            color(sibling(node)) == OFFSET_RBTREE_NODE_BLACK &&
+            color(left(sibling(node))) == OFFSET_RBTREE_NODE_BLACK &&
+            color(right(sibling(node))) == OFFSET_RBTREE_NODE_BLACK
+        ) {
+            sibling(node)->color = OFFSET_RBTREE_NODE_RED;
+            node = parent(node);
+
+            continue;
+        }
+
+        if (
+            color(parent(node)) == OFFSET_RBTREE_NODE_RED &&
+            color(sibling(node)) == OFFSET_RBTREE_NODE_BLACK &&
+            color(left(sibling(node))) == OFFSET_RBTREE_NODE_BLACK &&
+            color(right(sibling(node))) == OFFSET_RBTREE_NODE_BLACK
+        ) {
+            sibling(node)->color = OFFSET_RBTREE_NODE_RED;
+            parent(node)->color = OFFSET_RBTREE_NODE_BLACK;
+
+            break;
+        }
+
+        if (
+            node == left(parent(node)) &&
+            color(sibling(node)) == OFFSET_RBTREE_NODE_BLACK &&
+            color(left(sibling(node))) == OFFSET_RBTREE_NODE_RED &&
+            color(right(sibling(node))) == OFFSET_RBTREE_NODE_BLACK
+        ) {
+            sibling(node)->color = OFFSET_RBTREE_NODE_RED;
+            left(sibling(node))->color = OFFSET_RBTREE_NODE_BLACK;
+
+            rotate_right(tree, sibling(node));
+        } else if (
+            node == right(parent(node)) &&
+            color(sibling(node)) == OFFSET_RBTREE_NODE_BLACK &&
+            color(left(sibling(node))) == OFFSET_RBTREE_NODE_BLACK &&
+            color(right(sibling(node))) == OFFSET_RBTREE_NODE_RED
+        ) {
+            sibling(node)->color = OFFSET_RBTREE_NODE_RED;
+            right(sibling(node))->color = OFFSET_RBTREE_NODE_BLACK;
+
+            rotate_left(tree, sibling(node));
+        }
+
+        sibling(node)->color = color(parent(node));
+        parent(node)->color = OFFSET_RBTREE_NODE_BLACK;
+
+        if (node == left(parent(node))) {
+            right(sibling(node))->color = OFFSET_RBTREE_NODE_BLACK;
+
+            rotate_left(tree, parent(node));
+        } else {
+            left(sibling(node))->color = OFFSET_RBTREE_NODE_BLACK;
+
+            rotate_right(tree, parent(node));
+        }
+
+        break;
+    }
+}
+
+/* ========================================================================================================
+ *
+ *                                        EXTERN FUNCTION DEFINITIONS
+ *
+ * ======================================================================================================== */
+
+void offset_rbtree_init(OffsetRBTree *tree) {
+    assert(tree);
+
+    tree->root = 0;
+    tree->size = 0;
+}
+
+OffsetRBTreeNode* offset_rbtree_first(const OffsetRBTree *tree) {
+    OffsetRBTreeNode *n;
+
+    assert(tree);
+
+    n = follow(&tree->root);
+
+    if (!n) {
+        return NULL;
+    }
+
+    while (n->left_child) {
+        n = left(n);
+    }
+
+    return n;
+}
+
+OffsetRBTreeNode* offset_rbtree_last(const OffsetRBTree *tree) {
+    OffsetRBTreeNode *n;
+
+    assert(tree);
+
+    n = follow(&tree->root);
+
+    if (!n) {
+        return NULL;
+    }
+
+    while (n->right_child) {
+        n = right(n);
+    }
+
+    return n;
+}
+
+OffsetRBTreeNode* offset_rbtree_prev(const OffsetRBTreeNode *node) {
+    OffsetRBTreeNode *n;
+
+    if (!node) {
+        return NULL;
+    }
+
+    if (node->left_child) {
+        node = left(node);
+
+        while (node->right_child) {
+            node = right(node);
+        }
+
+        return (OffsetRBTreeNode*) node;
+    }
+
+    while ((n = parent(node)) && node == left(n)) {
+        node = n;
+    }
+
+    return n;
+}
+
+OffsetRBTreeNode* offset_rbtree_next(const OffsetRBTreeNode *node) {
+    OffsetRBTreeNode *n;
+
+    if (!node) {
+        return NULL;
+    }
+
+    if (node->right_child) {
+        node = right(node);
+
+        while (node->left_child) {
+            node = left(node);
+        }
+
+        return (OffsetRBTreeNode*) node;
+    }
+
+    while ((n = parent(node)) && node == right(n)) {
+        node = n;
+    }
+
+    return n;
+}
+
+size_t offset_rbtree_size(const OffsetRBTree *tree) {
+    assert(tree);
+
+    return tree->size;
+}
+
+int offset_rbtree_empty(const OffsetRBTree *tree) {
+    assert(tree);
+
+    return tree->size == 0;
+}
+
+int offset_rbtree_contains_key(
+    const OffsetRBTree *tree,
+    int (*compare)(const void *key, const OffsetRBTreeNode *node),
+    const void *key
+) {
+    assert(tree && compare);
+
+    return offset_rbtree_lookup_key(tree, compare, key) != NULL;
+}
+
+OffsetRBTreeNode* offset_rbtree_insert(
+    OffsetRBTree *tree,
+    int (*compare)(const void *key, const OffsetRBTreeNode *node),
+    const void *key,
+    OffsetRBTreeNode *node
+) {
+    OffsetRBTreeNode *n;
+
+    assert(tree && compare && node);
+
+    n = follow(&tree->root);
+
+    if (n) {
+        for ( ; ; ) {
+            int cmp = compare(key, n);
+
+            if (cmp < 0) {
+                if (n->left_child) {
+                    n = left(n);
+                } else {
+                    point(&n->left_child, node);
+
+                    break;
+                }
+            } else if (cmp > 0) {
+                if (n->right_child) {
+                    n = right(n);
+                } else {
+                    point(&n->right_child, node);
+
+                    break;
+                }
+            } else {
+                replace(tree, n, node);
+
+                return n;
+            }
+        }
+    }
+
+    point(&node->parent, n);
+    node->left_child = 0;
+    node->right_child = 0;
+    node->color = OFFSET_RBTREE_NODE_RED;
+
+    if (!n) {
+        point(&tree->root, node);
+    }
+
+    repair_after_insert(tree, node);
+
+    ++tree->size;
+
+    return NULL;
+}
+
+OffsetRBTreeNode* offset_rbtree_lookup_key(
+    const OffsetRBTree *tree,
+    int (*compare)(const void *key, const OffsetRBTreeNode *node),
+    const void *key
+) {
+    OffsetRBTreeNode *n;
+
+    assert(tree && compare);
+
+    for (n = follow(&tree->root); n; ) {
+        int cmp = compare(key, n);
+
+        if (cmp < 0) {
+            n = left(n);
+        } else if (cmp > 0) {
+            n = right(n);
+        } else {
+            break;
+        }
+    }
+
+    return n;
+}
+
+void offset_rbtree_remove(OffsetRBTree *tree, OffsetRBTreeNode *node) {
+    OffsetRBTreeNode *n;
+
+    assert(tree);
+
+    if (!node) {
+        return;
+    }
+
+    if (node->left_child && node->right_child) {
+        OffsetRBTreeNode *k = left(node);
+
+        while (k->right_child) {
+            k = right(k);
+        }
+
+        swap_places(tree, node, k);
+    }
+
+    n = node->right_child ? right(node) : left(node);
+
+    if (color(node) == OFFSET_RBTREE_NODE_BLACK) {
+        node->color = color(n);
+
+        repair_after_remove(tree, node);
+    }
+
+    transplant(tree, node, n);
+
+    if (!node->parent && n) {
+        n->color = OFFSET_RBTREE_NODE_BLACK;
+    }
+
+    node->parent = 0;
+    node->left_child = 0;
+    node->right_child = 0;
+
+    --tree->size;
+}
+
+void offset_rbtree_remove_key(
+    OffsetRBTree *tree,
+    int (*compare)(const void *key, const OffsetRBTreeNode *node),
+    const void *key
+) {
+    assert(tree && compare);
+
+    offset_rbtree_remove(tree, offset_rbtree_lookup_key(tree, compare, key));
+}
+
+void offset_rbtree_remove_first(OffsetRBTree *tree) {
+    assert(tree);
+
+    offset_rbtree_remove(tree, offset_rbtree_first(tree));
+}
+
+void offset_rbtree_remove_last(OffsetRBTree *tree) {
+    assert(tree);
+
+    offset_rbtree_remove(tree, offset_rbtree_last(tree));
+}
+
+void offset_rbtree_remove_all(OffsetRBTree *tree) {
+    assert(tree);
+
+    tree->root = 0;
+    tree->size = 0;
+}
@@ -0,0 +1,496 @@
+/*
+Copyright (c) 2017, Michael J Welsh
+
+Permission to use, copy, modify, and/or distribute this software
+for any purpose with or without fee is hereby granted, provided
+that the above copyright notice and this permission notice appear
+in all copies.
+
+THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL
+WARRANTIES WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE
+AUTHOR BE LIABLE FOR ANY SPECIAL, DIRECT, INDIRECT, OR
+CONSEQUENTIAL DAMAGES OR ANY DAMAGES WHATSOEVER RESULTING FROM
+LOSS OF USE, DATA OR PROFITS, WHETHER IN AN ACTION OF CONTRACT,
+NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF OR IN
+CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+
+/**
+ * @file    offset_rbtree.h
+ * @brief   OFFSET RED-BLACK TREE
+ *
+ * A red-black tree like @ref RBTree whose links are self-relative offsets instead of pointers: every link
+ * holds the distance in bytes from itself to the @ref OffsetRBTreeNode it refers to, or 0 for NULL. An
+ * @ref OffsetRBTree and its @ref OffsetRBTreeNode's can therefore be placed in a shared memory segment (or a
+ * memory-mapped file) that is mapped at a different address in each process, and used from any of them
+ * without being copied or relocated. Functions take and return ordinary pointers, valid in the calling
+ * process.
+ *
+ * Embed one or more @ref OffsetRBTreeNode's into your struct to make it a potential node in one or more
+ * trees. An @ref OffsetRBTree MUST be initialized before it is used. An @ref OffsetRBTreeNode does NOT need
+ * to be initialized before it is used. An @ref OffsetRBTreeNode should belong to at most ONE
+ * @ref OffsetRBTree, and MUST be in the same memory segment as its @ref OffsetRBTree.
+ *
+ * Since the address of a function differs between processes, an @ref OffsetRBTree does NOT store its compare
+ * function. It is passed to every function that needs it instead, and every process MUST use the same
+ * ordering. When a @ref OffsetRBTreeNode is inserted with an already existing key, the old
+ * @ref OffsetRBTreeNode is replaced and returned, in place of the collide function of a @ref RBTree.
+ *
+ * The @ref OffsetRBTree does NOT synchronize processes. Any number of processes can read it at once, but a
+ * process modifying it must exclude all others (e.g. with a process-shared pthread_rwlock_t stored in the
+ * segment).
+ *
+ * Example:
+ *          struct Object {
+ *              int key;
+ *              int val;
+ *              OffsetRBTreeNode n;
+ *          };
+ *
+ *          struct Segment {
+ *              OffsetRBTree tree;
+ *              struct Object objs[1000];
+ *          };
+ *
+ *          int compare(const void *key, const OffsetRBTreeNode *node) {
+ *              return *(const int*)key - offset_rbtree_entry(node, struct Object, n)->key;
+ *          }
+ *
+ *          int main(void) {
+ *              struct Segment *segment = create_shared_segment(), *other = map_segment_again();
+ *              int i;
+ *
+ *              offset_rbtree_init(&segment->tree);
+ *              for (i = 0; i < 1000; ++i) {
+ *                  segment->objs[i].key = i;
+ *                  segment->objs[i].val = i * i;
+ *                  offset_rbtree_insert(&segment->tree, compare, &segment->objs[i].key, &segment->objs[i].n);
+ *              }
+ *
+ *              i = 10;
+ *              assert(offset_rbtree_lookup_key(&other->tree, compare, &i) == &other->objs[10].n);
+ *              return 0;
+ *          }
+ *
+ * Dependencies:
+ *      -   C89 assert.h
+ *      -   C89 stddef.h
+ *
+ * API:
+ *      ====  TYPES  ====
+ *      -   typedef struct OffsetRBTree OffsetRBTree
+ *      -   typedef struct OffsetRBTreeNode OffsetRBTreeNode
+ *      -   typedef enum OffsetRBTreeNodeColor OffsetRBTreeNodeColor
+ *          -   OFFSET_RBTREE_NODE_RED = 0
+ *          -   OFFSET_RBTREE_NODE_BLACK = 1
+ *
+ *      ====  FUNCTIONS  ====
+ *      Initializers:
+ *          -   offset_rbtree_init
+ *      Properties:
+ *          -   offset_rbtree_first
+ *          -   offset_rbtree_last
+ *          -   offset_rbtree_prev
+ *          -   offset_rbtree_next
+ *          -   offset_rbtree_size
+ *          -   offset_rbtree_empty
+ *          -   offset_rbtree_contains_key
+ *      Insertion:
+ *          -   offset_rbtree_insert
+ *      Lookup:
+ *          -   offset_rbtree_lookup_key
+ *      Removal:
+ *          -   offset_rbtree_remove
+ *          -   offset_rbtree_remove_key
+ *          -   offset_rbtree_remove_first
+ *          -   offset_rbtree_remove_last
+ *          -   offset_rbtree_remove_all
+ *
+ *      ====  MACROS  ====
+ *      Properties:
+ *          -   offset_rbtree_entry
+ *      Traversal:
+ *          -   offset_rbtree_for_each
+ *          -   offset_rbtree_for_each_reverse
+ */
+
+#ifndef OFFSET_RBTREE_H
+#define OFFSET_RBTREE_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif /* __cplusplus */
+
+#include <stddef.h>
+
+/* ========================================================================================================
+ *
+ *                                                  TYPES
+ *
+ * ======================================================================================================== */
+
+/* Struct type declarations. */
+struct OffsetRBTree;
+struct OffsetRBTreeNode;
+
+/* Struct typedef's. */
+typedef struct OffsetRBTree OffsetRBTree;
+typedef struct OffsetRBTreeNode OffsetRBTreeNode;
+
+/**
+ * Represents a red-black tree with self-relative links. The "root" member is the offset from itself to the
+ * root @ref OffsetRBTreeNode.
+ */
+struct OffsetRBTree {
+    ptrdiff_t root;
+    size_t size;
+};
+
+/**
+ * Represents the color of an @ref OffsetRBTreeNode.
+ */
+typedef enum OffsetRBTreeNodeColor {
+    OFFSET_RBTREE_NODE_RED = 0,
+    OFFSET_RBTREE_NODE_BLACK = 1
+} OffsetRBTreeNodeColor;
+
+/**
+ * Represents a node in an @ref OffsetRBTree. Embed this into your structure to make it a node. Every link is
+ * the offset from itself to the @ref OffsetRBTreeNode it refers to, or 0 for NULL.
+ */
+struct OffsetRBTreeNode {
+    ptrdiff_t parent;
+    ptrdiff_t left_child;
+    ptrdiff_t right_child;
+    OffsetRBTreeNodeColor color;
+};
+
+/* ========================================================================================================
+ *
+ *                                               PROTOTYPES
+ *
+ * ======================================================================================================== */
+
+/**
+ * Initializes/resets the @ref tree.
+ *
+ * Requirements:
+ *      -   @ref tree != NULL
+ *
+ * Time complexity:
+ *      -   O(1)
+ *
+ * @param tree                  The @ref OffsetRBTree to be initialized/reset.
+ */
+void offset_rbtree_init(OffsetRBTree *tree);
+
+/**
+ * Returns the first (leftmost) @ref OffsetRBTreeNode in the @ref tree.
+ *
+ * Requirements:
+ *      -   @ref tree != NULL
+ *
+ * Time complexity:
+ *      -   O(log(n))
+ *
+ * @param tree                  The @ref OffsetRBTree to be operated on.
+ * @return                      The first (leftmost) @ref OffsetRBTreeNode in the @ref tree.
+ */
+OffsetRBTreeNode* offset_rbtree_first(const OffsetRBTree *tree);
+
+/**
+ * Returns the last (rightmost) @ref OffsetRBTreeNode in the @ref tree.
+ *
+ * Requirements:
+ *      -   @ref tree != NULL
+ *
+ * Time complexity:
+ *      -   O(log(n))
+ *
+ * @param tree                  The @ref OffsetRBTree to be operated on.
+ * @return                      The last (rightmost) @ref OffsetRBTreeNode in the @ref tree.
+ */
+OffsetRBTreeNode* offset_rbtree_last(const OffsetRBTree *tree);
+
+/**
+ * Returns the previous (inorder) @ref OffsetRBTreeNode of the @ref node. If @ref node == NULL, returns NULL.
+ *
+ * Requirements:
+ *      -   None
+ *
+ * Time complexity:
+ *      -   O(log(n))
+ *
+ * @param node                  The @ref OffsetRBTreeNode to be operated on.
+ * @return                      The previous (inorder) @ref OffsetRBTreeNode of the @ref node.
+ */
+OffsetRBTreeNode* offset_rbtree_prev(const OffsetRBTreeNode *node);
+
+/**
+ * Returns the next (inorder) @ref OffsetRBTreeNode of the @ref node. If @ref node == NULL, returns NULL.
+ *
+ * Requirements:
+ *      -   None
+ *
+ * Time complexity:
+ *      -   O(log(n))
+ *
+ * @param node                  The @ref OffsetRBTreeNode to be operated on.
+ * @return                      The next (inorder) @ref OffsetRBTreeNode of the @ref node.
+ */
+OffsetRBTreeNode* offset_rbtree_next(const OffsetRBTreeNode *node);
+
+/**
+ * Returns the size of the @ref tree.
+ *
+ * Requirements:
+ *      -   @ref tree != NULL
+ *
+ * Time complexity:
+ *      -   O(1)
+ *
+ * @param tree                  The @ref OffsetRBTree whose "size" member will be returned.
+ * @return                      @ref tree->size.
+ */
+size_t offset_rbtree_size(const OffsetRBTree *tree);
+
+/**
+ * Returns whether or not the @ref tree is empty (i.e. @ref tree->size == 0).
+ *
+ * Requirements:
+ *      -   @ref tree != NULL
+ *
+ * Time complexity:
+ *      -   O(1)
+ *
+ * @param tree                  The @ref OffsetRBTree whose "size" member will be used to determine if it is
+ *                              empty.
+ * @return                      Whether or not the @ref tree is empty (i.e. @ref tree->size == 0).
+ */
+int offset_rbtree_empty(const OffsetRBTree *tree);
+
+/**
+ * Returns whether or not the @ref tree contains the @ref OffsetRBTreeNode associated with the @ref key.
+ *
+ * Requirements:
+ *      -   @ref tree != NULL
+ *      -   @ref compare != NULL
+ *
+ * Time complexity:
+ *      -   O(log(n))
+ *
+ * @param tree                  The @ref OffsetRBTree that may potentially contain the @ref OffsetRBTreeNode
+ *                              associated with the @ref key.
+ * @param compare               The callback function used to compare a key with the key of an
+ *                              @ref OffsetRBTreeNode.
+ * @param key                   The key used for lookup.
+ * @return                      Whether or not the @ref tree contains the @ref OffsetRBTreeNode associated
+ *                              with the @ref key.
+ */
+int offset_rbtree_contains_key(
+    const OffsetRBTree *tree,
+    int (*compare)(const void *key, const OffsetRBTreeNode *node),
+    const void *key
+);
+
+/**
+ * Inserts the @ref node with associated @ref key into the @ref tree. If an @ref OffsetRBTreeNode already
+ * exists with the same @ref key, the already existing @ref OffsetRBTreeNode is replaced by the @ref node, and
+ * returned.
+ *
+ * Requirements:
+ *      -   @ref tree != NULL
+ *      -   @ref compare != NULL
+ *      -   @ref node != NULL
+ *      -   @ref node is in the same memory segment as the @ref tree
+ *
+ * Time complexity:
+ *      -   O(log(n))
+ *
+ * @param tree                  The @ref OffsetRBTree to be operated on.
+ * @param compare               The callback function used to compare a key with the key of an
+ *                              @ref OffsetRBTreeNode.
+ * @param key                   The key associated with the @ref node.
+ * @param node                  The @ref OffsetRBTreeNode to be inserted.
+ * @return                      NULL if no @ref OffsetRBTreeNode was associated with the @ref key; otherwise,
+ *                              the replaced @ref OffsetRBTreeNode.
+ */
+OffsetRBTreeNode* offset_rbtree_insert(
+    OffsetRBTree *tree,
+    int (*compare)(const void *key, const OffsetRBTreeNode *node),
+    const void *key,
+    OffsetRBTreeNode *node
+);
+
+/**
+ * Returns the @ref OffsetRBTreeNode associated with the @ref key in the @ref tree.
+ *
+ * Requirements:
+ *      -   @ref tree != NULL
+ *      -   @ref compare != NULL
+ *
+ * Time complexity:
+ *      -   O(log(n))
+ *
+ * @param tree                  The @ref OffsetRBTree to be searched.
+ * @param compare               The callback function used to compare a key with the key of an
+ *                              @ref OffsetRBTreeNode.
+ * @param key                   The key used for lookup.
+ * @return                      NULL if the @ref tree does not contain an @ref OffsetRBTreeNode associated
+ *                              with the @ref key; otherwise, the @ref OffsetRBTreeNode associated with the
+ *                              @ref key.
+ */
+OffsetRBTreeNode* offset_rbtree_lookup_key(
+    const OffsetRBTree *tree,
+    int (*compare)(const void *key, const OffsetRBTreeNode *node),
+    const void *key
+);
+
+/**
+ * Removes the @ref node from the @ref tree. If @ref node == NULL, nothing happens.
+ *
+ * Requirements:
+ *      -   @ref tree != NULL
+ *      -   @ref node is in the @ref tree, or NULL
+ *
+ * Time complexity:
+ *      -   O(log(n))
+ *
+ * @param tree                  The @ref OffsetRBTree to be operated on.
+ * @param node                  The @ref OffsetRBTreeNode to be removed.
+ */
+void offset_rbtree_remove(OffsetRBTree *tree, OffsetRBTreeNode *node);
+
+/**
+ * Removes the @ref OffsetRBTreeNode associated with the @ref key from the @ref tree, if there is one.
+ *
+ * Requirements:
+ *      -   @ref tree != NULL
+ *      -   @ref compare != NULL
+ *
+ * Time complexity:
+ *      -   O(log(n))
+ *
+ * @param tree                  The @ref OffsetRBTree to be operated on.
+ * @param compare               The callback function used to compare a key with the key of an
+ *                              @ref OffsetRBTreeNode.
+ * @param key                   The key associated with the @ref OffsetRBTreeNode to be removed.
+ */
+void offset_rbtree_remove_key(
+    OffsetRBTree *tree,
+    int (*compare)(const void *key, const OffsetRBTreeNode *node),
+    const void *key
+);
+
+/**
+ * Removes the first (leftmost) @ref OffsetRBTreeNode in the @ref tree, if there is one.
+ *
+ * Requirements:
+ *      -   @ref tree != NULL
+ *
+ * Time complexity:
+ *      -   O(log(n))
+ *
+ * @param tree                  The @ref OffsetRBTree to be operated on.
+ */
+void offset_rbtree_remove_first(OffsetRBTree *tree);
+
+/**
+ * Removes the last (rightmost) @ref OffsetRBTreeNode in the @ref tree, if there is one.
+ *
+ * Requirements:
+ *      -   @ref tree != NULL
+ *
+ * Time complexity:
+ *      -   O(log(n))
+ *
+ * @param tree                  The @ref OffsetRBTree to be operated on.
+ */
+void offset_rbtree_remove_last(OffsetRBTree *tree);
+
+/**
+ * Removes every @ref OffsetRBTreeNode from the @ref tree. The @ref OffsetRBTreeNode's are NOT modified.
+ *
+ * Requirements:
+ *      -   @ref tree != NULL
+ *
+ * Time complexity:
+ *      -   O(1)
+ *
+ * @param tree                  The @ref OffsetRBTree to be operated on.
+ */
+void offset_rbtree_remove_all(OffsetRBTree *tree);
+
+/* ========================================================================================================
+ *
+ *                                                 MACROS
+ *
+ * ======================================================================================================== */
+
+/**
+ * Obtains the pointer to the struct for this entry.
+ *
+ * Requirements:
+ *      -   @ref node_ptr != NULL
+ *
+ * @param node_ptr              The pointer to the @ref OffsetRBTreeNode in the struct.
+ * @param type                  The type of the struct the @ref OffsetRBTreeNode is embedded in.
+ * @param member                The name of the @ref OffsetRBTreeNode in the struct.
+ */
+#if defined(__GNUC__) && !defined(__STRICT_ANSI__)
+    #define offset_rbtree_entry(node_ptr, type, member) \
+        ({ \
+            const typeof(((type*)0)->member) *__mptr = (node_ptr); \
+            (type*) ((char*)__mptr - offsetof(type, member)); \
+        })
+#else
+    #define offset_rbtree_entry(node_ptr, type, member) \
+        ( \
+            (type*) ((char*)(node_ptr) - offsetof(type, member)) \
+        )
+#endif
+
+/**
+ * Iterates over the @ref OffsetRBTree (inorder) from the first @ref OffsetRBTreeNode to the last
+ * @ref OffsetRBTreeNode.
+ *
+ * Requirements:
+ *      -   @ref tree_ptr != NULL
+ *      -   The @ref cursor_node_ptr is neither reassigned nor removed from its associated
+ *          @ref OffsetRBTree in the loop's body.
+ *
+ * @param cursor_node_ptr       The @ref OffsetRBTreeNode to use as a loop cursor.
+ * @param tree_ptr              The pointer to an @ref OffsetRBTree that will be iterated over.
+ */
+#define offset_rbtree_for_each(cursor_node_ptr, tree_ptr) \
+    for ( \
+        cursor_node_ptr = offset_rbtree_first(tree_ptr); \
+        cursor_node_ptr; \
+        cursor_node_ptr = offset_rbtree_next(cursor_node_ptr) \
+    )
+
+/**
+ * Iterates over the @ref OffsetRBTree (inorder) from the last @ref OffsetRBTreeNode to the first
+ * @ref OffsetRBTreeNode.
+ *
+ * Requirements:
+ *      -   @ref tree_ptr != NULL
+ *      -   The @ref cursor_node_ptr is neither reassigned nor removed from its associated
+ *          @ref OffsetRBTree in the loop's body.
+ *
+ * @param cursor_node_ptr       The @ref OffsetRBTreeNode to use as a loop cursor.
+ * @param tree_ptr              The pointer to an @ref OffsetRBTree that will be iterated over.
+ */
+#define offset_rbtree_for_each_reverse(cursor_node_ptr, tree_ptr) \
+    for ( \
+        cursor_node_ptr = offset_rbtree_last(tree_ptr); \
+        cursor_node_ptr; \
+        cursor_node_ptr = offset_rbtree_prev(cursor_node_ptr) \
+    )
+
+#ifdef __cplusplus
+}
+#endif /* __cplusplus */
+
+#endif /* OFFSET_RBTREE_H */
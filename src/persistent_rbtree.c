@@ -0,0 +1,633 @@
+/*
+Copyright (c) 2017, Michael J Welsh
+
+Permission to use, copy, modify, and/or distribute this software
+for any purpose with or without fee is hereby granted, provided
+that the above copyright notice and this permission notice appear
+in all copies.
+
+THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL
+WARRANTIES WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE
+AUTHOR BE LIABLE FOR ANY SPECIAL, DIRECT, INDIRECT, OR
+CONSEQUENTIAL DAMAGES OR ANY DAMAGES WHATSOEVER RESULTING FROM
+LOSS OF USE, DATA OR PROFITS, WHETHER IN AN ACTION OF CONTRACT,
+NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF OR IN
+CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+
+#include <assert.h>
+#include <stddef.h>
+#include <stdlib.h>
+
+#include "persistent_rbtree.h"
+
+/* ========================================================================================================
+ *
+ *                                               STATIC TYPES
+ *
+ * ======================================================================================================== */
+
+/*
+ * An update in progress. Nodes have no parent links (a copied node would have to update the parent link of
+ * every child it shares with the old version), so the path from the root is kept here instead: "path[i]" is
+ * the node at depth i of the new version, and "dirs[i]" the side of "path[i]" the path continues on. The
+ * spares are allocated up front, and taken from "spares[num_taken]" onwards.
+ */
+typedef struct Update {
+    PersistentRBTree *tree;
+    PersistentRBTreeNode *path[PERSISTENT_RBTREE_MAX_HEIGHT + 1];
+    int dirs[PERSISTENT_RBTREE_MAX_HEIGHT + 1];
+    PersistentRBTreeNode *spares[2 * PERSISTENT_RBTREE_MAX_HEIGHT + 8];
+    size_t num_spares;
+    size_t num_taken;
+    PersistentRBTreeNode *removed;
+} Update;
+
+/* ========================================================================================================
+ *
+ *                                        STATIC FUNCTION PROTOTYPES
+ *
+ * ======================================================================================================== */
+
+/*
+ * Allocates a @ref PersistentRBTreeNode with the allocator of the @ref tree.
+ */
+static PersistentRBTreeNode* allocate_node(const PersistentRBTree *tree);
+
+/*
+ * Frees the @ref node with the allocator of the @ref tree.
+ */
+static void deallocate_node(const PersistentRBTree *tree, PersistentRBTreeNode *node);
+
+/*
+ * Returns the color of the @ref node. If @ref node == NULL, return @ref PERSISTENT_RBTREE_NODE_BLACK.
+ */
+static PersistentRBTreeNodeColor color(const PersistentRBTreeNode *node);
+
+/*
+ * Allocates @ref num_spares spares for the @ref update. Returns 0, having freed them again, if one of them
+ * could not be allocated.
+ */
+static int reserve(Update *update, const PersistentRBTree *tree, size_t num_spares);
+
+/*
+ * Clears the "fresh" member of the spares taken by the @ref update, frees the other spares and the removed
+ * node, if any.
+ */
+static void finish(Update *update);
+
+/*
+ * Makes a fresh copy of the @ref node from a spare of the @ref update. The copy refers to the children of the
+ * @ref node, whose reference counts are incremented.
+ */
+static PersistentRBTreeNode* copy_node(Update *update, const PersistentRBTreeNode *node);
+
+/*
+ * Returns the link referring to the node at depth @ref depth of the path of the @ref update.
+ */
+static PersistentRBTreeNode** link_to(Update *update, size_t depth);
+
+/*
+ * Returns the node the @ref link refers to, after replacing it with a fresh copy if it is shared with other
+ * versions.
+ */
+static PersistentRBTreeNode* make_mutable(Update *update, PersistentRBTreeNode **link);
+
+/*
+ * Copies the first @ref length nodes of the path of the @ref update, which refers to nodes of the old
+ * version, into the new version.
+ */
+static void copy_path(Update *update, size_t length);
+
+/*
+ * Rotates the node the @ref link refers to towards the @ref dir side (0 for a left rotation). The node and
+ * its child on the other side must be fresh.
+ */
+static void rotate(PersistentRBTreeNode **link, int dir);
+
+/*
+ * Repairs the new version of the @ref update after the insertion of the node at depth @ref depth.
+ */
+static void repair_after_insert(Update *update, size_t depth);
+
+/*
+ * Repairs the new version of the @ref update after the removal of a black node at depth @ref depth, whose
+ * place has been taken by its only child (or NULL).
+ */
+static void repair_after_remove(Update *update, size_t depth);
+
+/* ========================================================================================================
+ *
+ *                                        STATIC FUNCTION DEFINITIONS
+ *
+ * ======================================================================================================== */
+
+static PersistentRBTreeNode* allocate_node(const PersistentRBTree *tree) {
+    assert(tree);
+
+    if (tree->allocate) {
+        return (PersistentRBTreeNode*) tree->allocate(sizeof(PersistentRBTreeNode), tree->allocator_data);
+    }
+
+    return (PersistentRBTreeNode*) malloc(sizeof(PersistentRBTreeNode));
+}
+
+static void deallocate_node(const PersistentRBTree *tree, PersistentRBTreeNode *node) {
+    assert(tree && node);
+
+    if (tree->deallocate) {
+        tree->deallocate(node, sizeof(PersistentRBTreeNode), tree->allocator_data);
+    } else {
+        free(node);
+    }
+}
+
+static PersistentRBTreeNodeColor color(const PersistentRBTreeNode *node) {
+    return node ? node->color : PERSISTENT_RBTREE_NODE_BLACK;
+}
+
+static int reserve(Update *update, const PersistentRBTree *tree, size_t num_spares) {
+    assert(update && tree && num_spares <= sizeof(update->spares) / sizeof(update->spares[0]));
+
+    update->num_spares = 0;
+    update->num_taken = 0;
+    update->removed = NULL;
+
+    while (update->num_spares < num_spares) {
+        update->spares[update->num_spares] = allocate_node(tree);
+        if (!update->spares[update->num_spares]) {
+            while (update->num_spares > 0) {
+                deallocate_node(tree, update->spares[--update->num_spares]);
+            }
+            return 0;
+        }
+        ++update->num_spares;
+    }
+
+    return 1;
+}
+
+static void finish(Update *update) {
+    size_t i;
+
+    assert(update);
+
+    for (i = 0; i < update->num_taken; ++i) {
+        update->spares[i]->fresh = 0;
+    }
+    for (; i < update->num_spares; ++i) {
+        deallocate_node(update->tree, update->spares[i]);
+    }
+    if (update->removed) {
+        deallocate_node(update->tree, update->removed);
+    }
+}
+
+static PersistentRBTreeNode* copy_node(Update *update, const PersistentRBTreeNode *node) {
+    PersistentRBTreeNode *copy;
+
+    assert(update && node && update->num_taken < update->num_spares);
+
+    copy = update->spares[update->num_taken++];
+    copy->child[0] = node->child[0];
+    copy->child[1] = node->child[1];
+    copy->value = node->value;
+    copy->refs = 1;
+    copy->color = node->color;
+    copy->fresh = 1;
+
+    if (copy->child[0]) {
+        ++copy->child[0]->refs;
+    }
+    if (copy->child[1]) {
+        ++copy->child[1]->refs;
+    }
+
+    return copy;
+}
+
+static PersistentRBTreeNode** link_to(Update *update, size_t depth) {
+    assert(update);
+
+    if (depth == 0) {
+        return &update->tree->root;
+    }
+
+    return &update->path[depth - 1]->child[update->dirs[depth - 1]];
+}
+
+static PersistentRBTreeNode* make_mutable(Update *update, PersistentRBTreeNode **link) {
+    PersistentRBTreeNode *node;
+
+    assert(update && link && *link);
+
+    node = *link;
+    if (!node->fresh) {
+        /* The link was counted when it was copied, and the old version still refers to the node. */
+        --node->refs;
+        *link = node = copy_node(update, node);
+    }
+
+    return node;
+}
+
+static void copy_path(Update *update, size_t length) {
+    size_t i;
+
+    assert(update);
+
+    for (i = 0; i < length; ++i) {
+        update->path[i] = make_mutable(update, link_to(update, i));
+    }
+}
+
+static void rotate(PersistentRBTreeNode **link, int dir) {
+    PersistentRBTreeNode *node, *up;
+
+    assert(link && *link && (*link)->fresh && (*link)->child[!dir] && (*link)->child[!dir]->fresh);
+
+    /* Every node keeps the number of links referring to it, so reference counts are unchanged. */
+    node = *link;
+    up = node->child[!dir];
+    node->child[!dir] = up->child[dir];
+    up->child[dir] = node;
+    *link = up;
+}
+
+static void repair_after_insert(Update *update, size_t depth) {
+    PersistentRBTreeNode *parent, *grandparent, *uncle;
+    int parent_dir;
+
+    assert(update);
+
+    while (depth > 0 && update->path[depth - 1]->color == PERSISTENT_RBTREE_NODE_RED) {
+        /* A red parent is not the root, so there is a grandparent. */
+        parent = update->path[depth - 1];
+        grandparent = update->path[depth - 2];
+        parent_dir = update->dirs[depth - 2];
+
+        if (color(grandparent->child[!parent_dir]) == PERSISTENT_RBTREE_NODE_RED) {
+            uncle = make_mutable(update, &grandparent->child[!parent_dir]);
+            parent->color = PERSISTENT_RBTREE_NODE_BLACK;
+            uncle->color = PERSISTENT_RBTREE_NODE_BLACK;
+            grandparent->color = PERSISTENT_RBTREE_NODE_RED;
+            depth -= 2;
+            continue;
+        }
+
+        if (update->dirs[depth - 1] != parent_dir) {
+            rotate(&grandparent->child[parent_dir], parent_dir);
+            parent = grandparent->child[parent_dir];
+        }
+        parent->color = PERSISTENT_RBTREE_NODE_BLACK;
+        grandparent->color = PERSISTENT_RBTREE_NODE_RED;
+        rotate(link_to(update, depth - 2), !parent_dir);
+        break;
+    }
+
+    update->tree->root->color = PERSISTENT_RBTREE_NODE_BLACK;
+}
+
+static void repair_after_remove(Update *update, size_t depth) {
+    PersistentRBTreeNode *node, *parent, *sibling, *nephew;
+    int dir;
+
+    assert(update);
+
+    node = *link_to(update, depth);
+    while (depth > 0 && color(node) == PERSISTENT_RBTREE_NODE_BLACK) {
+        /* The node is one black node short, so its sibling is not NULL. */
+        parent = update->path[depth - 1];
+        dir = update->dirs[depth - 1];
+        sibling = make_mutable(update, &parent->child[!dir]);
+
+        if (sibling->color == PERSISTENT_RBTREE_NODE_RED) {
+            sibling->color = PERSISTENT_RBTREE_NODE_BLACK;
+            parent->color = PERSISTENT_RBTREE_NODE_RED;
+            rotate(link_to(update, depth - 1), dir);
+
+            /* The sibling took the place of the parent, which moved one level down, towards the node. */
+            update->path[depth - 1] = sibling;
+            update->dirs[depth - 1] = dir;
+            update->path[depth] = parent;
+            update->dirs[depth] = dir;
+            ++depth;
+            continue;
+        }
+
+        if (color(sibling->child[0]) == PERSISTENT_RBTREE_NODE_BLACK &&
+                color(sibling->child[1]) == PERSISTENT_RBTREE_NODE_BLACK) {
+            sibling->color = PERSISTENT_RBTREE_NODE_RED;
+            node = parent;
+            --depth;
+            continue;
+        }
+
+        if (color(sibling->child[!dir]) == PERSISTENT_RBTREE_NODE_BLACK) {
+            nephew = make_mutable(update, &sibling->child[dir]);
+            nephew->color = PERSISTENT_RBTREE_NODE_BLACK;
+            sibling->color = PERSISTENT_RBTREE_NODE_RED;
+            rotate(&parent->child[!dir], !dir);
+            sibling = nephew;
+        }
+
+        sibling->color = parent->color;
+        parent->color = PERSISTENT_RBTREE_NODE_BLACK;
+        nephew = make_mutable(update, &sibling->child[!dir]);
+        nephew->color = PERSISTENT_RBTREE_NODE_BLACK;
+        rotate(link_to(update, depth - 1), dir);
+        return;
+    }
+
+    if (color(node) == PERSISTENT_RBTREE_NODE_RED) {
+        make_mutable(update, link_to(update, depth))->color = PERSISTENT_RBTREE_NODE_BLACK;
+    }
+}
+
+/* ========================================================================================================
+ *
+ *                                        EXTERN FUNCTION DEFINITIONS
+ *
+ * ======================================================================================================== */
+
+void persistent_rbtree_init(
+    PersistentRBTree *tree,
+    int (*compare)(const void *key, const void *value),
+    void* (*allocate)(size_t size, void *allocator_data),
+    void (*deallocate)(void *ptr, size_t size, void *allocator_data),
+    void *allocator_data
+) {
+    assert(tree && compare && ((!allocate && !deallocate) || (allocate && deallocate)));
+
+    tree->root = NULL;
+    tree->size = 0;
+    tree->compare = compare;
+    tree->allocate = allocate;
+    tree->deallocate = deallocate;
+    tree->allocator_data = allocator_data;
+}
+
+void persistent_rbtree_copy(const PersistentRBTree *tree, PersistentRBTree *copy) {
+    assert(tree && copy);
+
+    *copy = *tree;
+    if (copy->root) {
+        ++copy->root->refs;
+    }
+}
+
+void* persistent_rbtree_first(const PersistentRBTree *tree) {
+    const PersistentRBTreeNode *n;
+
+    assert(tree);
+
+    if (!tree->root) {
+        return NULL;
+    }
+
+    for (n = tree->root; n->child[0]; n = n->child[0]) {
+    }
+
+    return n->value;
+}
+
+void* persistent_rbtree_last(const PersistentRBTree *tree) {
+    const PersistentRBTreeNode *n;
+
+    assert(tree);
+
+    if (!tree->root) {
+        return NULL;
+    }
+
+    for (n = tree->root; n->child[1]; n = n->child[1]) {
+    }
+
+    return n->value;
+}
+
+size_t persistent_rbtree_size(const PersistentRBTree *tree) {
+    assert(tree);
+
+    return tree->size;
+}
+
+int persistent_rbtree_empty(const PersistentRBTree *tree) {
+    assert(tree);
+
+    return tree->size == 0;
+}
+
+int persistent_rbtree_contains_key(const PersistentRBTree *tree, const void *key) {
+    assert(tree);
+
+    return persistent_rbtree_lookup_key(tree, key) != NULL;
+}
+
+int persistent_rbtree_insert(
+    const PersistentRBTree *tree,
+    PersistentRBTree *new_version,
+    const void *key,
+    void *value
+) {
+    PersistentRBTreeNode *n;
+    Update update;
+    size_t depth = 0;
+    int cmp;
+
+    assert(tree && new_version);
+
+    for (n = tree->root; n; n = n->child[update.dirs[depth++]]) {
+        cmp = tree->compare(key, n->value);
+        if (cmp == 0) {
+            break;
+        }
+        update.dirs[depth] = cmp > 0;
+    }
+
+    /* The path, the new node, and at most one uncle for every two levels the repair climbs. */
+    if (!reserve(&update, tree, depth + depth / 2 + 2)) {
+        return 0;
+    }
+
+    persistent_rbtree_copy(tree, new_version);
+    update.tree = new_version;
+    if (n) {
+        copy_path(&update, depth + 1);
+        update.path[depth]->value = value;
+    } else {
+        copy_path(&update, depth);
+        n = update.spares[update.num_taken++];
+        n->child[0] = NULL;
+        n->child[1] = NULL;
+        n->value = value;
+        n->refs = 1;
+        n->color = PERSISTENT_RBTREE_NODE_RED;
+        n->fresh = 1;
+        *link_to(&update, depth) = n;
+        update.path[depth] = n;
+        ++new_version->size;
+        repair_after_insert(&update, depth);
+    }
+    finish(&update);
+
+    return 1;
+}
+
+void* persistent_rbtree_lookup_key(const PersistentRBTree *tree, const void *key) {
+    const PersistentRBTreeNode *n;
+    int cmp;
+
+    assert(tree);
+
+    for (n = tree->root; n; n = n->child[cmp > 0]) {
+        cmp = tree->compare(key, n->value);
+        if (cmp == 0) {
+            return n->value;
+        }
+    }
+
+    return NULL;
+}
+
+int persistent_rbtree_remove_key(
+    const PersistentRBTree *tree,
+    PersistentRBTree *new_version,
+    const void *key
+) {
+    PersistentRBTreeNode *n, *removed, *child;
+    size_t depth = 0, removed_depth;
+    Update update;
+    int cmp;
+
+    assert(tree && new_version);
+
+    for (n = tree->root; n; n = n->child[update.dirs[depth++]]) {
+        cmp = tree->compare(key, n->value);
+        if (cmp == 0) {
+            break;
+        }
+        update.dirs[depth] = cmp > 0;
+    }
+
+    if (!n) {
+        persistent_rbtree_copy(tree, new_version);
+        return 1;
+    }
+
+    /* A node with two children is removed by moving the value of its successor into it. */
+    removed_depth = depth;
+    if (n->child[0] && n->child[1]) {
+        update.dirs[removed_depth++] = 1;
+        for (n = n->child[1]; n->child[0]; n = n->child[0]) {
+            update.dirs[removed_depth++] = 0;
+        }
+    }
+
+    /* The path, and at most one sibling per level plus five more nodes for the repair. */
+    if (!reserve(&update, tree, 2 * removed_depth + 6)) {
+        return 0;
+    }
+
+    persistent_rbtree_copy(tree, new_version);
+    update.tree = new_version;
+    copy_path(&update, removed_depth + 1);
+
+    removed = update.path[removed_depth];
+    if (removed_depth != depth) {
+        update.path[depth]->value = removed->value;
+    }
+
+    /* The child keeps its reference count, since the link of the removed node moves to its parent. */
+    child = removed->child[0] ? removed->child[0] : removed->child[1];
+    *link_to(&update, removed_depth) = child;
+    update.removed = removed;
+    --new_version->size;
+
+    if (removed->color == PERSISTENT_RBTREE_NODE_BLACK) {
+        repair_after_remove(&update, removed_depth);
+    }
+    finish(&update);
+
+    return 1;
+}
+
+void persistent_rbtree_release(PersistentRBTree *tree) {
+    PersistentRBTreeNode *dead = NULL, *n;
+    int i;
+
+    assert(tree);
+
+    if (tree->root && --tree->root->refs == 0) {
+        tree->root->value = NULL;
+        dead = tree->root;
+    }
+
+    /* The dead nodes are chained through their "value" member, so freeing a tree needs no stack. */
+    while (dead) {
+        n = dead;
+        dead = (PersistentRBTreeNode*) n->value;
+        for (i = 0; i < 2; ++i) {
+            if (n->child[i] && --n->child[i]->refs == 0) {
+                n->child[i]->value = dead;
+                dead = n->child[i];
+            }
+        }
+        deallocate_node(tree, n);
+    }
+
+    tree->root = NULL;
+    tree->size = 0;
+}
+
+void persistent_rbtree_iterator_init(PersistentRBTreeIterator *iterator, const PersistentRBTree *tree) {
+    const PersistentRBTreeNode *n;
+
+    assert(iterator && tree);
+
+    iterator->depth = 0;
+    for (n = tree->root; n; n = n->child[0]) {
+        iterator->stack[iterator->depth++] = n;
+    }
+}
+
+void persistent_rbtree_iterator_seek(
+    PersistentRBTreeIterator *iterator,
+    const PersistentRBTree *tree,
+    const void *key
+) {
+    const PersistentRBTreeNode *n;
+    int cmp;
+
+    assert(iterator && tree);
+
+    /* Only the nodes not less than the key, whose left subtrees remain to be visited, are stacked. */
+    iterator->depth = 0;
+    for (n = tree->root; n; n = n->child[cmp > 0]) {
+        cmp = tree->compare(key, n->value);
+        if (cmp <= 0) {
+            iterator->stack[iterator->depth++] = n;
+        }
+        if (cmp == 0) {
+            break;
+        }
+    }
+}
+
+void* persistent_rbtree_iterator_next(PersistentRBTreeIterator *iterator) {
+    const PersistentRBTreeNode *node, *n;
+
+    assert(iterator);
+
+    if (iterator->depth == 0) {
+        return NULL;
+    }
+
+    node = iterator->stack[--iterator->depth];
+    for (n = node->child[1]; n; n = n->child[0]) {
+        iterator->stack[iterator->depth++] = n;
+    }
+
+    return node->value;
+}
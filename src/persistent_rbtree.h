@@ -0,0 +1,464 @@
+/*
+Copyright (c) 2017, Michael J Welsh
+
+Permission to use, copy, modify, and/or distribute this software
+for any purpose with or without fee is hereby granted, provided
+that the above copyright notice and this permission notice appear
+in all copies.
+
+THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL
+WARRANTIES WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE
+AUTHOR BE LIABLE FOR ANY SPECIAL, DIRECT, INDIRECT, OR
+CONSEQUENTIAL DAMAGES OR ANY DAMAGES WHATSOEVER RESULTING FROM
+LOSS OF USE, DATA OR PROFITS, WHETHER IN AN ACTION OF CONTRACT,
+NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF OR IN
+CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+
+/**
+ * @file    persistent_rbtree.h
+ * @brief   PERSISTENT RED-BLACK TREE
+ *
+ * A red-black tree whose updates never modify an existing @ref PersistentRBTreeNode. Inserting or removing a
+ * key copies the O(log(n)) @ref PersistentRBTreeNode's on the path from the root to the key (path copying),
+ * and returns a new version of the tree that shares every other @ref PersistentRBTreeNode with the old one.
+ * Every version stays valid, and keeps the contents it had when it was created, until it is released with
+ * @ref persistent_rbtree_release.
+ *
+ * A @ref PersistentRBTree is a version handle: a small struct holding the root of one version, its size, the
+ * compare function and the allocator. It can be copied by value, but each version must be released exactly
+ * once (use @ref persistent_rbtree_copy to obtain a second reference to the same version). Unlike
+ * @ref RBTree, a @ref PersistentRBTree is NOT intrusive: it allocates its own @ref PersistentRBTreeNode's,
+ * each holding a pointer to a user value, with the allocate function given to @ref persistent_rbtree_init
+ * (or malloc() if none is given). A @ref PersistentRBTreeNode is shared by several versions, and freed when
+ * the last version referring to it is released. The values are NEVER freed or manipulated by the tree; a
+ * value removed from the newest version is still referred to by the older ones until they are released.
+ *
+ * The @ref PersistentRBTreeNode's of a version are never modified once the function creating it returns,
+ * so any number of threads can read a version (lookups, iteration with a @ref PersistentRBTreeIterator)
+ * without locks while another thread creates new versions. The tree does NOT publish versions: the writer
+ * must hand a new version to the readers with a release store (or a mutex), and must NOT release a version
+ * while a reader may still be using it (e.g. with reference counts or epochs). Functions that create or
+ * release versions update reference counts that are NOT atomic, so they must NOT run concurrently with each
+ * other, even on different versions of the same tree.
+ *
+ * Example:
+ *          struct Object {
+ *              int key;
+ *              int val;
+ *          };
+ *
+ *          int compare(const void *key, const void *value) {
+ *              return *(const int*)key - ((const struct Object*)value)->key;
+ *          }
+ *
+ *          int main(void) {
+ *              struct Object objs[1000];
+ *              PersistentRBTree v1, v2, next;
+ *              int i;
+ *
+ *              persistent_rbtree_init(&v1, compare, NULL, NULL, NULL);
+ *              for (i = 0; i < 1000; ++i) {
+ *                  objs[i].key = i;
+ *                  persistent_rbtree_insert(&v1, &next, &objs[i].key, &objs[i]);
+ *                  persistent_rbtree_release(&v1);
+ *                  v1 = next;
+ *              }
+ *
+ *              i = 10;
+ *              persistent_rbtree_remove_key(&v1, &v2, &i);
+ *              assert(persistent_rbtree_contains_key(&v1, &i));
+ *              assert(!persistent_rbtree_contains_key(&v2, &i));
+ *
+ *              persistent_rbtree_release(&v1);
+ *              persistent_rbtree_release(&v2);
+ *              return 0;
+ *          }
+ *
+ * Dependencies:
+ *      -   C89 assert.h
+ *      -   C89 stddef.h
+ *      -   C89 stdlib.h
+ *
+ * API:
+ *      ====  TYPES  ====
+ *      -   typedef struct PersistentRBTree PersistentRBTree
+ *      -   typedef struct PersistentRBTreeNode PersistentRBTreeNode
+ *      -   typedef struct PersistentRBTreeIterator PersistentRBTreeIterator
+ *      -   typedef enum PersistentRBTreeNodeColor PersistentRBTreeNodeColor
+ *          -   PERSISTENT_RBTREE_NODE_RED = 0
+ *          -   PERSISTENT_RBTREE_NODE_BLACK = 1
+ *
+ *      ====  FUNCTIONS  ====
+ *      Initializers:
+ *          -   persistent_rbtree_init
+ *          -   persistent_rbtree_copy
+ *      Properties:
+ *          -   persistent_rbtree_first
+ *          -   persistent_rbtree_last
+ *          -   persistent_rbtree_size
+ *          -   persistent_rbtree_empty
+ *          -   persistent_rbtree_contains_key
+ *      Insertion:
+ *          -   persistent_rbtree_insert
+ *      Lookup:
+ *          -   persistent_rbtree_lookup_key
+ *      Removal:
+ *          -   persistent_rbtree_remove_key
+ *          -   persistent_rbtree_release
+ *      Iteration:
+ *          -   persistent_rbtree_iterator_init
+ *          -   persistent_rbtree_iterator_seek
+ *          -   persistent_rbtree_iterator_next
+ *
+ *      ====  MACROS  ====
+ *      Constants:
+ *          -   PERSISTENT_RBTREE_MAX_HEIGHT
+ */
+
+#ifndef PERSISTENT_RBTREE_H
+#define PERSISTENT_RBTREE_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif /* __cplusplus */
+
+#include <stddef.h>
+
+/* ========================================================================================================
+ *
+ *                                                 MACROS
+ *
+ * ======================================================================================================== */
+
+/**
+ * The maximum height of a @ref PersistentRBTree. A red-black tree of n nodes is at most 2 * log2(n + 1)
+ * high, and fewer than 2^64 @ref PersistentRBTreeNode's fit in memory.
+ */
+#define PERSISTENT_RBTREE_MAX_HEIGHT 128
+
+/* ========================================================================================================
+ *
+ *                                                  TYPES
+ *
+ * ======================================================================================================== */
+
+/* Struct type declarations. */
+struct PersistentRBTree;
+struct PersistentRBTreeNode;
+struct PersistentRBTreeIterator;
+
+/* Struct typedef's. */
+typedef struct PersistentRBTree PersistentRBTree;
+typedef struct PersistentRBTreeNode PersistentRBTreeNode;
+typedef struct PersistentRBTreeIterator PersistentRBTreeIterator;
+
+/**
+ * Represents one version of a persistent red-black tree.
+ */
+struct PersistentRBTree {
+    PersistentRBTreeNode *root;
+    size_t size;
+    int (*compare)(const void *key, const void *value);
+    void* (*allocate)(size_t size, void *allocator_data);
+    void (*deallocate)(void *ptr, size_t size, void *allocator_data);
+    void *allocator_data;
+};
+
+/**
+ * Represents the color of a @ref PersistentRBTreeNode.
+ */
+typedef enum PersistentRBTreeNodeColor {
+    PERSISTENT_RBTREE_NODE_RED = 0,
+    PERSISTENT_RBTREE_NODE_BLACK = 1
+} PersistentRBTreeNodeColor;
+
+/**
+ * Represents a node in a @ref PersistentRBTree, allocated by the tree. The "child" member holds the left
+ * child and the right child, in that order. The "refs" member counts the versions and the
+ * @ref PersistentRBTreeNode's referring to it. The "fresh" member is only set during the update that created
+ * the @ref PersistentRBTreeNode.
+ */
+struct PersistentRBTreeNode {
+    PersistentRBTreeNode *child[2];
+    void *value;
+    size_t refs;
+    PersistentRBTreeNodeColor color;
+    int fresh;
+};
+
+/**
+ * Represents an in-order position in a version of a @ref PersistentRBTree. The "stack" member holds the
+ * @ref PersistentRBTreeNode's whose values have yet to be returned and whose left subtrees have been
+ * visited.
+ */
+struct PersistentRBTreeIterator {
+    const PersistentRBTreeNode *stack[PERSISTENT_RBTREE_MAX_HEIGHT];
+    size_t depth;
+};
+
+/* ========================================================================================================
+ *
+ *                                               PROTOTYPES
+ *
+ * ======================================================================================================== */
+
+/**
+ * Initializes the @ref tree as an empty version. Every version derived from the @ref tree allocates its
+ * @ref PersistentRBTreeNode's with @ref allocate, or with malloc() if @ref allocate is NULL.
+ *
+ * Requirements:
+ *      -   @ref tree != NULL
+ *      -   @ref compare != NULL
+ *      -   Either @ref allocate and @ref deallocate are both NULL, or are both non-NULL
+ *
+ * Time complexity:
+ *      -   O(1)
+ *
+ * @param tree                  The @ref PersistentRBTree to be initialized.
+ * @param compare               The callback function used to compare a key with a value. Returns < 0, 0
+ *                              or > 0 if the key is less than, equal to or greater than the key of the value.
+ * @param allocate              The OPTIONAL (i.e. can be NULL) function used to allocate a
+ *                              @ref PersistentRBTreeNode of @ref size bytes. Returns NULL on failure.
+ * @param deallocate            The OPTIONAL (i.e. can be NULL) function used to free a
+ *                              @ref PersistentRBTreeNode of @ref size bytes allocated by @ref allocate.
+ * @param allocator_data        The OPTIONAL (i.e. can be NULL) data passed to @ref allocate and
+ *                              @ref deallocate. This data is NEVER manipulated by the @ref tree.
+ */
+void persistent_rbtree_init(
+    PersistentRBTree *tree,
+    int (*compare)(const void *key, const void *value),
+    void* (*allocate)(size_t size, void *allocator_data),
+    void (*deallocate)(void *ptr, size_t size, void *allocator_data),
+    void *allocator_data
+);
+
+/**
+ * Makes the @ref copy a second reference to the version @ref tree. Both must be released.
+ *
+ * Requirements:
+ *      -   @ref tree != NULL
+ *      -   @ref copy != NULL
+ *
+ * Time complexity:
+ *      -   O(1)
+ *
+ * @param tree                  The @ref PersistentRBTree to be copied.
+ * @param copy                  The @ref PersistentRBTree that will refer to the same version.
+ */
+void persistent_rbtree_copy(const PersistentRBTree *tree, PersistentRBTree *copy);
+
+/**
+ * Returns the value with the smallest key in the @ref tree.
+ *
+ * Requirements:
+ *      -   @ref tree != NULL
+ *
+ * Time complexity:
+ *      -   O(log(n))
+ *
+ * @param tree                  The @ref PersistentRBTree to be operated on.
+ * @return                      The first value, or NULL if the @ref tree is empty.
+ */
+void* persistent_rbtree_first(const PersistentRBTree *tree);
+
+/**
+ * Returns the value with the largest key in the @ref tree.
+ *
+ * Requirements:
+ *      -   @ref tree != NULL
+ *
+ * Time complexity:
+ *      -   O(log(n))
+ *
+ * @param tree                  The @ref PersistentRBTree to be operated on.
+ * @return                      The last value, or NULL if the @ref tree is empty.
+ */
+void* persistent_rbtree_last(const PersistentRBTree *tree);
+
+/**
+ * Returns the number of values in the @ref tree.
+ *
+ * Requirements:
+ *      -   @ref tree != NULL
+ *
+ * Time complexity:
+ *      -   O(1)
+ *
+ * @param tree                  The @ref PersistentRBTree to be operated on.
+ * @return                      The number of values.
+ */
+size_t persistent_rbtree_size(const PersistentRBTree *tree);
+
+/**
+ * Determines if the @ref tree is empty.
+ *
+ * Requirements:
+ *      -   @ref tree != NULL
+ *
+ * Time complexity:
+ *      -   O(1)
+ *
+ * @param tree                  The @ref PersistentRBTree to be operated on.
+ * @return                      1 if the @ref tree is empty, otherwise 0.
+ */
+int persistent_rbtree_empty(const PersistentRBTree *tree);
+
+/**
+ * Determines if the @ref tree contains the @ref key.
+ *
+ * Requirements:
+ *      -   @ref tree != NULL
+ *
+ * Time complexity:
+ *      -   O(log(n))
+ *
+ * @param tree                  The @ref PersistentRBTree to be operated on.
+ * @param key                   The key used for lookup.
+ * @return                      1 if the @ref tree contains the @ref key, otherwise 0.
+ */
+int persistent_rbtree_contains_key(const PersistentRBTree *tree, const void *key);
+
+/**
+ * Creates the @ref new_version, a version of the @ref tree that also maps the @ref key to the @ref value,
+ * replacing the value the @ref key is mapped to in the @ref tree if there is one. The @ref tree is NOT
+ * modified, and must still be released. About 3 * h / 2 @ref PersistentRBTreeNode's, where h is the depth
+ * of the @ref key in the @ref tree, are allocated up front so that the update cannot fail halfway; the
+ * unused ones are freed before returning.
+ *
+ * Requirements:
+ *      -   @ref tree != NULL
+ *      -   @ref new_version != NULL
+ *      -   @ref key is the key of the @ref value.
+ *
+ * Time complexity:
+ *      -   O(log(n))
+ *
+ * @param tree                  The @ref PersistentRBTree to be operated on.
+ * @param new_version           The @ref PersistentRBTree that will hold the new version.
+ * @param key                   The key of the @ref value.
+ * @param value                 The value to be inserted.
+ * @return                      1 on success, 0 if a @ref PersistentRBTreeNode could not be allocated, in
+ *                              which case the @ref new_version is left untouched.
+ */
+int persistent_rbtree_insert(
+    const PersistentRBTree *tree,
+    PersistentRBTree *new_version,
+    const void *key,
+    void *value
+);
+
+/**
+ * Returns the value associated with the @ref key in the @ref tree. NULL if a match for the @ref key is not
+ * found.
+ *
+ * Requirements:
+ *      -   @ref tree != NULL
+ *
+ * Time complexity:
+ *      -   O(log(n))
+ *
+ * @param tree                  The @ref PersistentRBTree to be operated on.
+ * @param key                   The key used for lookup.
+ * @return                      The value associated with the @ref key, or NULL.
+ */
+void* persistent_rbtree_lookup_key(const PersistentRBTree *tree, const void *key);
+
+/**
+ * Creates the @ref new_version, a version of the @ref tree without the @ref key. If the @ref tree does not
+ * contain the @ref key, the @ref new_version is a copy of the @ref tree (see @ref persistent_rbtree_copy).
+ * The @ref tree is NOT modified, and must still be released.
+ *
+ * Requirements:
+ *      -   @ref tree != NULL
+ *      -   @ref new_version != NULL
+ *
+ * Time complexity:
+ *      -   O(log(n))
+ *
+ * @param tree                  The @ref PersistentRBTree to be operated on.
+ * @param new_version           The @ref PersistentRBTree that will hold the new version.
+ * @param key                   The key used for lookup.
+ * @return                      1 on success, 0 if a @ref PersistentRBTreeNode could not be allocated, in
+ *                              which case the @ref new_version is left untouched.
+ */
+int persistent_rbtree_remove_key(
+    const PersistentRBTree *tree,
+    PersistentRBTree *new_version,
+    const void *key
+);
+
+/**
+ * Releases the version @ref tree, freeing the @ref PersistentRBTreeNode's no other version refers to. The
+ * @ref tree is empty afterwards.
+ *
+ * Requirements:
+ *      -   @ref tree != NULL
+ *      -   No reader is using the version.
+ *
+ * Time complexity:
+ *      -   O(m), where m == number of @ref PersistentRBTreeNode's freed
+ *
+ * @param tree                  The @ref PersistentRBTree to be released.
+ */
+void persistent_rbtree_release(PersistentRBTree *tree);
+
+/**
+ * Positions the @ref iterator before the first value of the @ref tree.
+ *
+ * Requirements:
+ *      -   @ref iterator != NULL
+ *      -   @ref tree != NULL
+ *
+ * Time complexity:
+ *      -   O(log(n))
+ *
+ * @param iterator              The @ref PersistentRBTreeIterator to be initialized.
+ * @param tree                  The @ref PersistentRBTree to be iterated over. It must NOT be released while
+ *                              the @ref iterator is in use.
+ */
+void persistent_rbtree_iterator_init(PersistentRBTreeIterator *iterator, const PersistentRBTree *tree);
+
+/**
+ * Positions the @ref iterator before the first value of the @ref tree whose key is not less than the
+ * @ref key, e.g. to iterate over a range of keys.
+ *
+ * Requirements:
+ *      -   @ref iterator != NULL
+ *      -   @ref tree != NULL
+ *
+ * Time complexity:
+ *      -   O(log(n))
+ *
+ * @param iterator              The @ref PersistentRBTreeIterator to be initialized.
+ * @param tree                  The @ref PersistentRBTree to be iterated over. It must NOT be released while
+ *                              the @ref iterator is in use.
+ * @param key                   The lower bound of the keys to be iterated over.
+ */
+void persistent_rbtree_iterator_seek(
+    PersistentRBTreeIterator *iterator,
+    const PersistentRBTree *tree,
+    const void *key
+);
+
+/**
+ * Advances the @ref iterator, and returns the value it passed over.
+ *
+ * Requirements:
+ *      -   @ref iterator != NULL
+ *
+ * Time complexity:
+ *      -   Amortized: O(1)
+ *      -   O(log(n))
+ *
+ * @param iterator              The @ref PersistentRBTreeIterator to be advanced.
+ * @return                      The next value in key order, or NULL after the last one.
+ */
+void* persistent_rbtree_iterator_next(PersistentRBTreeIterator *iterator);
+
+#ifdef __cplusplus
+}
+#endif /* __cplusplus */
+
+#endif /* PERSISTENT_RBTREE_H */
@@ -0,0 +1,381 @@
+/*
+Copyright (c) 2017, Michael J Welsh
+
+Permission to use, copy, modify, and/or distribute this software
+for any purpose with or without fee is hereby granted, provided
+that the above copyright notice and this permission notice appear
+in all copies.
+
+THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL
+WARRANTIES WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE
+AUTHOR BE LIABLE FOR ANY SPECIAL, DIRECT, INDIRECT, OR
+CONSEQUENTIAL DAMAGES OR ANY DAMAGES WHATSOEVER RESULTING FROM
+LOSS OF USE, DATA OR PROFITS, WHETHER IN AN ACTION OF CONTRACT,
+NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF OR IN
+CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+
+#include <assert.h>
+#include <stddef.h>
+#include <stdlib.h>
+
+#include "pool.h"
+
+/* ========================================================================================================
+ *
+ *                                        STATIC FUNCTION PROTOTYPES
+ *
+ * ======================================================================================================== */
+
+/*
+ * Acquires the lock of the @ref pool, if it has one.
+ */
+static void lock_pool(Pool *pool);
+
+/*
+ * Releases the lock of the @ref pool, if it has one.
+ */
+static void unlock_pool(Pool *pool);
+
+/*
+ * Makes the @ref chunk the one objects are carved out of.
+ */
+static void use_chunk(Pool *pool, PoolChunk *chunk);
+
+/*
+ * Links the @ref chunk right after the current chunk, so that it is used next.
+ */
+static void link_chunk(Pool *pool, PoolChunk *chunk);
+
+/*
+ * Moves on to the next chunk, allocating one if there is none. Returns 0 if no chunk is available.
+ */
+static int next_chunk(Pool *pool);
+
+/*
+ * Allocates an object without taking the lock. Returns NULL if no memory is available.
+ */
+static void* alloc_object(Pool *pool);
+
+/*
+ * Frees the @ref object without taking the lock.
+ */
+static void free_object(Pool *pool, void *object);
+
+/* ========================================================================================================
+ *
+ *                                        STATIC FUNCTION DEFINITIONS
+ *
+ * ======================================================================================================== */
+
+static void lock_pool(Pool *pool) {
+    assert(pool);
+
+    if (pool->lock) {
+        pool->lock(pool->lock_data);
+    }
+}
+
+static void unlock_pool(Pool *pool) {
+    assert(pool);
+
+    if (pool->unlock) {
+        pool->unlock(pool->lock_data);
+    }
+}
+
+static void use_chunk(Pool *pool, PoolChunk *chunk) {
+    assert(pool && chunk);
+
+    pool->current = chunk;
+    pool->cursor = (char*) chunk + POOL_CHUNK_OVERHEAD;
+    pool->limit = (char*) chunk + chunk->size;
+}
+
+static void link_chunk(Pool *pool, PoolChunk *chunk) {
+    assert(pool && chunk);
+
+    if (pool->current) {
+        chunk->next = pool->current->next;
+        pool->current->next = chunk;
+    } else {
+        chunk->next = pool->head;
+        pool->head = chunk;
+    }
+}
+
+static int next_chunk(Pool *pool) {
+    PoolChunk *chunk;
+
+    assert(pool);
+
+    /* Chunks kept by pool_reset and chunks given by the user come first. */
+    if (pool->current && pool->current->next) {
+        use_chunk(pool, pool->current->next);
+        return 1;
+    } else if (!pool->current && pool->head) {
+        use_chunk(pool, pool->head);
+        return 1;
+    }
+
+    if (!pool->chunk_size) {
+        return 0;
+    }
+
+    if (pool->allocate) {
+        chunk = (PoolChunk*) pool->allocate(pool->chunk_size, pool->allocator_data);
+    } else {
+        chunk = (PoolChunk*) malloc(pool->chunk_size);
+    }
+
+    if (!chunk) {
+        return 0;
+    }
+
+    chunk->size = pool->chunk_size;
+    chunk->owned = 1;
+    link_chunk(pool, chunk);
+    use_chunk(pool, chunk);
+
+    return 1;
+}
+
+static void* alloc_object(Pool *pool) {
+    void *object;
+
+    assert(pool);
+
+    object = stack_pop(&pool->free_objects);
+
+    if (!object) {
+        if (!pool->current || (size_t) (pool->limit - pool->cursor) < pool->object_size) {
+            if (!next_chunk(pool)) {
+                return NULL;
+            }
+        }
+
+        object = pool->cursor;
+        pool->cursor += pool->object_size;
+    }
+
+    ++pool->size;
+
+    return object;
+}
+
+static void free_object(Pool *pool, void *object) {
+    assert(pool && object && pool->size > 0);
+
+    stack_push(&pool->free_objects, (StackNode*) object);
+    --pool->size;
+}
+
+/* ========================================================================================================
+ *
+ *                                        EXTERN FUNCTION DEFINITIONS
+ *
+ * ======================================================================================================== */
+
+void pool_init(
+    Pool *pool,
+    size_t object_size,
+    size_t chunk_size,
+    void* (*allocate)(size_t size, void *allocator_data),
+    void (*deallocate)(void *ptr, size_t size, void *allocator_data),
+    void *allocator_data
+) {
+    assert(pool && object_size > 0 && ((!allocate && !deallocate) || (allocate && deallocate)));
+
+    if (object_size < sizeof(StackNode)) {
+        object_size = sizeof(StackNode);
+    }
+    object_size = (object_size + POOL_ALIGNMENT - 1) / POOL_ALIGNMENT * POOL_ALIGNMENT;
+
+    assert(chunk_size == 0 || chunk_size >= POOL_CHUNK_OVERHEAD + object_size);
+
+    stack_init(&pool->free_objects);
+    pool->head = NULL;
+    pool->current = NULL;
+    pool->cursor = NULL;
+    pool->limit = NULL;
+    pool->object_size = object_size;
+    pool->chunk_size = chunk_size;
+    pool->size = 0;
+    pool->allocate = allocate;
+    pool->deallocate = deallocate;
+    pool->allocator_data = allocator_data;
+    pool->lock = NULL;
+    pool->unlock = NULL;
+    pool->lock_data = NULL;
+}
+
+void pool_set_lock(
+    Pool *pool,
+    void (*lock)(void *lock_data),
+    void (*unlock)(void *lock_data),
+    void *lock_data
+) {
+    assert(pool && ((!lock && !unlock) || (lock && unlock)));
+
+    pool->lock = lock;
+    pool->unlock = unlock;
+    pool->lock_data = lock_data;
+}
+
+void pool_cache_init(PoolCache *cache, Pool *pool, size_t capacity) {
+    assert(cache && pool && capacity > 0);
+
+    stack_init(&cache->free_objects);
+    cache->pool = pool;
+    cache->capacity = capacity;
+}
+
+size_t pool_size(const Pool *pool) {
+    assert(pool);
+
+    return pool->size;
+}
+
+size_t pool_object_size(const Pool *pool) {
+    assert(pool);
+
+    return pool->object_size;
+}
+
+void pool_add_chunk(Pool *pool, void *memory, size_t size) {
+    PoolChunk *chunk = (PoolChunk*) memory;
+
+    assert(pool && memory && size >= POOL_CHUNK_OVERHEAD + pool->object_size);
+
+    chunk->size = size;
+    chunk->owned = 0;
+
+    lock_pool(pool);
+    link_chunk(pool, chunk);
+    unlock_pool(pool);
+}
+
+void* pool_alloc(Pool *pool) {
+    void *object;
+
+    assert(pool);
+
+    lock_pool(pool);
+    object = alloc_object(pool);
+    unlock_pool(pool);
+
+    return object;
+}
+
+void pool_free(Pool *pool, void *object) {
+    assert(pool);
+
+    if (!object) {
+        return;
+    }
+
+    lock_pool(pool);
+    free_object(pool, object);
+    unlock_pool(pool);
+}
+
+void* pool_cache_alloc(PoolCache *cache) {
+    void *object, *extra;
+    size_t batch, i;
+
+    assert(cache);
+
+    object = stack_pop(&cache->free_objects);
+
+    if (object) {
+        return object;
+    }
+
+    batch = cache->capacity / 2 ? cache->capacity / 2 : 1;
+
+    lock_pool(cache->pool);
+    object = alloc_object(cache->pool);
+    for (i = 1; object && i < batch; ++i) {
+        extra = alloc_object(cache->pool);
+
+        if (!extra) {
+            break;
+        }
+
+        stack_push(&cache->free_objects, (StackNode*) extra);
+    }
+    unlock_pool(cache->pool);
+
+    return object;
+}
+
+void pool_cache_free(PoolCache *cache, void *object) {
+    assert(cache);
+
+    if (!object) {
+        return;
+    }
+
+    stack_push(&cache->free_objects, (StackNode*) object);
+
+    if (stack_size(&cache->free_objects) > cache->capacity) {
+        lock_pool(cache->pool);
+        while (stack_size(&cache->free_objects) > cache->capacity / 2) {
+            free_object(cache->pool, stack_pop(&cache->free_objects));
+        }
+        unlock_pool(cache->pool);
+    }
+}
+
+void pool_cache_flush(PoolCache *cache) {
+    assert(cache);
+
+    if (stack_empty(&cache->free_objects)) {
+        return;
+    }
+
+    lock_pool(cache->pool);
+    while (!stack_empty(&cache->free_objects)) {
+        free_object(cache->pool, stack_pop(&cache->free_objects));
+    }
+    unlock_pool(cache->pool);
+}
+
+void pool_reset(Pool *pool) {
+    assert(pool);
+
+    stack_init(&pool->free_objects);
+    pool->size = 0;
+
+    if (pool->head) {
+        use_chunk(pool, pool->head);
+    }
+}
+
+void pool_release(Pool *pool) {
+    PoolChunk *chunk, *next;
+
+    assert(pool);
+
+    for (chunk = pool->head; chunk; chunk = next) {
+        next = chunk->next;
+
+        if (!chunk->owned) {
+            continue;
+        }
+
+        if (pool->deallocate) {
+            pool->deallocate(chunk, chunk->size, pool->allocator_data);
+        } else {
+            free(chunk);
+        }
+    }
+
+    stack_init(&pool->free_objects);
+    pool->head = NULL;
+    pool->current = NULL;
+    pool->cursor = NULL;
+    pool->limit = NULL;
+    pool->size = 0;
+}
@@ -0,0 +1,450 @@
+/*
+Copyright (c) 2017, Michael J Welsh
+
+Permission to use, copy, modify, and/or distribute this software
+for any purpose with or without fee is hereby granted, provided
+that the above copyright notice and this permission notice appear
+in all copies.
+
+THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL
+WARRANTIES WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE
+AUTHOR BE LIABLE FOR ANY SPECIAL, DIRECT, INDIRECT, OR
+CONSEQUENTIAL DAMAGES OR ANY DAMAGES WHATSOEVER RESULTING FROM
+LOSS OF USE, DATA OR PROFITS, WHETHER IN AN ACTION OF CONTRACT,
+NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF OR IN
+CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+
+/**
+ * @file    pool.h
+ * @brief   POOL (FIXED-SIZE OBJECT ALLOCATOR)
+ *
+ * A @ref Pool hands out objects of one fixed size, carved out of large chunks of memory. Since the structures
+ * of this library are intrusive, their nodes live in objects the user allocates; allocating those objects
+ * from a @ref Pool instead of malloc() makes allocation and deallocation a handful of instructions, keeps
+ * the objects close together in memory, and allows freeing all of them at once. A @ref Pool MUST be
+ * initialized before it is used.
+ *
+ * Chunks come from two sources. The user can give the @ref Pool memory of their own (a static array, a
+ * region obtained with mmap(), etc) with @ref pool_add_chunk; such chunks are NEVER freed by the @ref Pool.
+ * When the @ref Pool runs out of memory and its chunk size is non-zero, it allocates a chunk with the
+ * OPTIONAL allocate function given during initialization, and with malloc() otherwise. Objects are carved
+ * out of a chunk only when they are first needed.
+ *
+ * Freed objects are kept on a @ref Stack, using the memory of the freed object itself as the @ref StackNode.
+ * Therefore an object is never smaller than a @ref StackNode, and the contents of a freed object are
+ * overwritten.
+ *
+ * A @ref Pool is NOT thread-safe by itself. For multithreaded use, give the @ref Pool a lock with
+ * @ref pool_set_lock, and give each thread a @ref PoolCache. A @ref PoolCache keeps a small @ref Stack of
+ * free objects that only its thread uses, and moves objects from and to the @ref Pool in batches, so the
+ * lock is taken once per batch instead of once per object.
+ *
+ * Example:
+ *          struct Object {
+ *              int val;
+ *              RBTreeNode n;
+ *          };
+ *
+ *          int main(void) {
+ *              struct Object *obj1, *obj2;
+ *              Pool pool;
+ *
+ *              pool_init(&pool, sizeof(struct Object), 64 * 1024, NULL, NULL, NULL);
+ *
+ *              obj1 = (struct Object*) pool_alloc(&pool);
+ *              obj2 = (struct Object*) pool_alloc(&pool);
+ *              if (!obj1 || !obj2) {
+ *                  pool_release(&pool);
+ *                  return 1;
+ *              }
+ *
+ *              pool_free(&pool, obj1);
+ *              assert(pool_size(&pool) == 1);
+ *
+ *              pool_reset(&pool);
+ *              assert(pool_size(&pool) == 0);
+ *
+ *              pool_release(&pool);
+ *
+ *              return 0;
+ *          }
+ *
+ * Dependencies:
+ *      -   C89 assert.h
+ *      -   C89 stddef.h
+ *      -   C89 stdlib.h
+ *      -   stack.h/stack.c
+ *
+ * API:
+ *      ====  TYPES  ====
+ *      -   typedef struct Pool Pool
+ *      -   typedef struct PoolChunk PoolChunk
+ *      -   typedef struct PoolCache PoolCache
+ *
+ *      ====  FUNCTIONS  ====
+ *      Initializers:
+ *          -   pool_init
+ *          -   pool_set_lock
+ *          -   pool_cache_init
+ *      Properties:
+ *          -   pool_size
+ *          -   pool_object_size
+ *      Chunks:
+ *          -   pool_add_chunk
+ *      Allocation:
+ *          -   pool_alloc
+ *          -   pool_free
+ *          -   pool_cache_alloc
+ *          -   pool_cache_free
+ *          -   pool_cache_flush
+ *      Removal:
+ *          -   pool_reset
+ *          -   pool_release
+ *
+ *      ====  MACROS  ====
+ *      Constants:
+ *          -   POOL_ALIGNMENT
+ *          -   POOL_CHUNK_OVERHEAD
+ */
+
+#ifndef POOL_H
+#define POOL_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif /* __cplusplus */
+
+#include <stddef.h>
+
+#include "stack.h"
+
+/* ========================================================================================================
+ *
+ *                                                  TYPES
+ *
+ * ======================================================================================================== */
+
+/* Struct type declarations. */
+struct Pool;
+struct PoolChunk;
+struct PoolCache;
+
+/* Struct typedef's. */
+typedef struct Pool Pool;
+typedef struct PoolChunk PoolChunk;
+typedef struct PoolCache PoolCache;
+
+/**
+ * Represents a pool of fixed-size objects.
+ */
+struct Pool {
+    Stack free_objects;
+    PoolChunk *head;
+    PoolChunk *current;
+    char *cursor;
+    char *limit;
+    size_t object_size;
+    size_t chunk_size;
+    size_t size;
+    void* (*allocate)(size_t size, void *allocator_data);
+    void (*deallocate)(void *ptr, size_t size, void *allocator_data);
+    void *allocator_data;
+    void (*lock)(void *lock_data);
+    void (*unlock)(void *lock_data);
+    void *lock_data;
+};
+
+/**
+ * Represents the header at the start of every chunk of a @ref Pool. Managed by the @ref Pool.
+ */
+struct PoolChunk {
+    PoolChunk *next;
+    size_t size;
+    int owned;
+};
+
+/**
+ * Represents a cache of free objects in front of a @ref Pool, meant to be used by a single thread.
+ */
+struct PoolCache {
+    Stack free_objects;
+    Pool *pool;
+    size_t capacity;
+};
+
+/* ========================================================================================================
+ *
+ *                                               PROTOTYPES
+ *
+ * ======================================================================================================== */
+
+/**
+ * Initializes the @ref pool. Use @ref pool_release to reset a @ref pool that owns chunks, otherwise they are
+ * leaked.
+ *
+ * Requirements:
+ *      -   @ref pool != NULL
+ *      -   @ref object_size > 0
+ *      -   Either @ref allocate and @ref deallocate are both NULL, or are both non-NULL
+ *      -   @ref chunk_size == 0, or @ref chunk_size is at least @ref POOL_CHUNK_OVERHEAD plus one object
+ *
+ * Time complexity:
+ *      -   O(1)
+ *
+ * @param pool                  The @ref Pool to be initialized.
+ * @param object_size           The size in bytes of the objects. Rounded up to a multiple of
+ *                              @ref POOL_ALIGNMENT that can hold a @ref StackNode.
+ * @param chunk_size            The size in bytes of the chunks the @ref pool allocates when it runs out of
+ *                              memory. If 0, the @ref pool never allocates chunks, and only uses the chunks
+ *                              given to it with @ref pool_add_chunk.
+ * @param allocate              The OPTIONAL (i.e. can be NULL) function used to allocate a chunk of
+ *                              @ref size bytes, aligned to @ref POOL_ALIGNMENT. Returns NULL on failure. If
+ *                              NULL, malloc() is used.
+ * @param deallocate            The OPTIONAL (i.e. can be NULL) function used to free a chunk of @ref size
+ *                              bytes allocated by @ref allocate. If NULL, free() is used.
+ * @param allocator_data        The OPTIONAL (i.e. can be NULL) data passed to @ref allocate and
+ *                              @ref deallocate. This data is NEVER manipulated by the @ref pool.
+ */
+void pool_init(
+    Pool *pool,
+    size_t object_size,
+    size_t chunk_size,
+    void* (*allocate)(size_t size, void *allocator_data),
+    void (*deallocate)(void *ptr, size_t size, void *allocator_data),
+    void *allocator_data
+);
+
+/**
+ * Gives the @ref pool a lock, which @ref pool_alloc, @ref pool_free, @ref pool_add_chunk and the
+ * @ref PoolCache's of the @ref pool hold while they manipulate the @ref pool. Passing NULL for both
+ * functions removes the lock.
+ *
+ * Requirements:
+ *      -   @ref pool != NULL
+ *      -   Either @ref lock and @ref unlock are both NULL, or are both non-NULL
+ *      -   No other thread is using the @ref pool.
+ *
+ * Time complexity:
+ *      -   O(1)
+ *
+ * @param pool                  The @ref Pool to be operated on.
+ * @param lock                  The OPTIONAL (i.e. can be NULL) function that acquires the lock.
+ * @param unlock                The OPTIONAL (i.e. can be NULL) function that releases the lock.
+ * @param lock_data             The OPTIONAL (i.e. can be NULL) data passed to @ref lock and @ref unlock
+ *                              (e.g. a pthread_mutex_t). This data is NEVER manipulated by the @ref pool.
+ */
+void pool_set_lock(
+    Pool *pool,
+    void (*lock)(void *lock_data),
+    void (*unlock)(void *lock_data),
+    void *lock_data
+);
+
+/**
+ * Initializes the @ref cache in front of the @ref pool. The @ref cache holds at most @ref capacity free
+ * objects, and moves about half of that many objects from or to the @ref pool at a time.
+ *
+ * Requirements:
+ *      -   @ref cache != NULL
+ *      -   @ref pool != NULL
+ *      -   @ref capacity > 0
+ *
+ * Time complexity:
+ *      -   O(1)
+ *
+ * @param cache                 The @ref PoolCache to be initialized.
+ * @param pool                  The @ref Pool the @ref cache gets its objects from.
+ * @param capacity              The maximum number of free objects in the @ref cache.
+ */
+void pool_cache_init(PoolCache *cache, Pool *pool, size_t capacity);
+
+/**
+ * Returns the number of objects handed out by the @ref pool, including the free objects held by its
+ * @ref PoolCache's.
+ *
+ * Requirements:
+ *      -   @ref pool != NULL
+ *
+ * Time complexity:
+ *      -   O(1)
+ *
+ * @param pool                  The @ref Pool whose "size" member will be returned.
+ * @return                      @ref pool->size.
+ */
+size_t pool_size(const Pool *pool);
+
+/**
+ * Returns the size in bytes of the objects of the @ref pool, after rounding.
+ *
+ * Requirements:
+ *      -   @ref pool != NULL
+ *
+ * Time complexity:
+ *      -   O(1)
+ *
+ * @param pool                  The @ref Pool whose "object_size" member will be returned.
+ * @return                      @ref pool->object_size.
+ */
+size_t pool_object_size(const Pool *pool);
+
+/**
+ * Gives the @ref pool the @ref size bytes of memory starting at @ref memory. The @ref pool carves objects out
+ * of it before allocating chunks of its own, and NEVER frees it.
+ *
+ * Requirements:
+ *      -   @ref pool != NULL
+ *      -   @ref memory != NULL
+ *      -   @ref memory is aligned to @ref POOL_ALIGNMENT
+ *      -   @ref size is at least @ref POOL_CHUNK_OVERHEAD plus one object
+ *      -   The memory outlives its use by the @ref pool, i.e. until @ref pool_release is called.
+ *
+ * Time complexity:
+ *      -   O(1)
+ *
+ * @param pool                  The @ref Pool to be operated on.
+ * @param memory                The memory to be carved into objects.
+ * @param size                  The size in bytes of the @ref memory.
+ */
+void pool_add_chunk(Pool *pool, void *memory, size_t size);
+
+/**
+ * Allocates an object from the @ref pool. Reuses the most recently freed object if there is one, otherwise
+ * carves a new object out of the current chunk, moving on to the next chunk or allocating a chunk when the
+ * current chunk is used up.
+ *
+ * Requirements:
+ *      -   @ref pool != NULL
+ *
+ * Time complexity:
+ *      -   O(1), plus the allocation of a chunk once per chunk
+ *
+ * @param pool                  The @ref Pool to be operated on.
+ * @return                      The object, aligned to @ref POOL_ALIGNMENT. NULL if the @ref pool ran out of
+ *                              memory and a chunk could not be allocated.
+ */
+void* pool_alloc(Pool *pool);
+
+/**
+ * Returns the @ref object to the @ref pool. If @ref object == NULL, this function simply returns.
+ *
+ * Requirements:
+ *      -   @ref pool != NULL
+ *      -   @ref object was allocated from the @ref pool and has not been freed since.
+ *
+ * Time complexity:
+ *      -   O(1)
+ *
+ * @param pool                  The @ref Pool to be operated on.
+ * @param object                The object to be freed.
+ */
+void pool_free(Pool *pool, void *object);
+
+/**
+ * Allocates an object from the @ref cache. When the @ref cache is empty, it first takes a batch of objects
+ * from its @ref Pool while holding the lock of the @ref Pool.
+ *
+ * Requirements:
+ *      -   @ref cache != NULL
+ *
+ * Time complexity:
+ *      -   Amortized: O(1)
+ *
+ * @param cache                 The @ref PoolCache to be operated on.
+ * @return                      The object. NULL if the @ref Pool ran out of memory and a chunk could not be
+ *                              allocated.
+ */
+void* pool_cache_alloc(PoolCache *cache);
+
+/**
+ * Returns the @ref object to the @ref cache. When the @ref cache is over capacity, it gives a batch of
+ * objects back to its @ref Pool while holding the lock of the @ref Pool. If @ref object == NULL, this
+ * function simply returns.
+ *
+ * Requirements:
+ *      -   @ref cache != NULL
+ *      -   @ref object was allocated from the @ref Pool of the @ref cache and has not been freed since.
+ *
+ * Time complexity:
+ *      -   Amortized: O(1)
+ *
+ * @param cache                 The @ref PoolCache to be operated on.
+ * @param object                The object to be freed.
+ */
+void pool_cache_free(PoolCache *cache, void *object);
+
+/**
+ * Gives all the free objects of the @ref cache back to its @ref Pool while holding the lock of the
+ * @ref Pool. Call this before the thread using the @ref cache exits.
+ *
+ * Requirements:
+ *      -   @ref cache != NULL
+ *
+ * Time complexity:
+ *      -   O(number of free objects in the @ref cache)
+ *
+ * @param cache                 The @ref PoolCache to be operated on.
+ */
+void pool_cache_flush(PoolCache *cache);
+
+/**
+ * Frees every object of the @ref pool at once. The chunks are kept, and are carved anew from the first one.
+ *
+ * Requirements:
+ *      -   @ref pool != NULL
+ *      -   No object of the @ref pool is used afterwards.
+ *      -   The @ref PoolCache's of the @ref pool are initialized again before they are used.
+ *      -   No other thread is using the @ref pool.
+ *
+ * Time complexity:
+ *      -   O(1)
+ *
+ * @param pool                  The @ref Pool to be operated on.
+ */
+void pool_reset(Pool *pool);
+
+/**
+ * Frees every object of the @ref pool, frees the chunks the @ref pool allocated, and forgets the chunks given
+ * to it with @ref pool_add_chunk. The @ref pool can be used again afterwards.
+ *
+ * Requirements:
+ *      -   @ref pool != NULL
+ *      -   No object of the @ref pool is used afterwards.
+ *      -   The @ref PoolCache's of the @ref pool are initialized again before they are used.
+ *      -   No other thread is using the @ref pool.
+ *
+ * Time complexity:
+ *      -   O(number of chunks)
+ *
+ * @param pool                  The @ref Pool to be operated on.
+ */
+void pool_release(Pool *pool);
+
+/* ========================================================================================================
+ *
+ *                                                 MACROS
+ *
+ * ======================================================================================================== */
+
+/**
+ * The alignment of the objects of a @ref Pool, and the alignment required of the chunks given to it. The
+ * default matches the alignment of malloc() on common 64-bit platforms. Can be overridden by defining it
+ * before including this header; it must then be a power of two, and have the same value in every translation
+ * unit.
+ */
+#ifndef POOL_ALIGNMENT
+    #define POOL_ALIGNMENT 16
+#endif
+
+/**
+ * The number of bytes at the start of every chunk that are used by the @ref PoolChunk header, rounded up to
+ * @ref POOL_ALIGNMENT.
+ */
+#define POOL_CHUNK_OVERHEAD ((sizeof(PoolChunk) + POOL_ALIGNMENT - 1) / POOL_ALIGNMENT * POOL_ALIGNMENT)
+
+#ifdef __cplusplus
+}
+#endif /* __cplusplus */
+
+#endif /* POOL_H */
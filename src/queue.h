@@ -77,6 +77,7 @@ CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
  *          -   queue_entry
  *      Traversal:
  *          -   queue_for_each
+ *          -   queue_for_each_prefetch
  *          -   queue_for_each_safe
  */
 
@@ -283,6 +284,31 @@ void queue_remove_all(Queue *queue);
         cursor_node_ptr = cursor_node_ptr->next \
     )
 
+/**
+ * Iterates over the @ref Queue from front to back, and prefetches the next @ref QueueNode while the loop's
+ * body runs, so that the body overlaps with the cache miss of the next step. Without GNU extensions, this is
+ * simply @ref queue_for_each.
+ *
+ * Requirements:
+ *      -   @ref queue_ptr != NULL
+ *      -   The @ref cursor_node_ptr is neither reassigned nor removed from its associated @ref Queue in the
+ *          loop's body.
+ *
+ * @param cursor_node_ptr       The @ref QueueNode to use as a loop cursor.
+ * @param queue_ptr             The pointer to a @ref Queue that will be iterated over.
+ */
+#if defined(__GNUC__) && !defined(__STRICT_ANSI__)
+    #define queue_for_each_prefetch(cursor_node_ptr, queue_ptr) \
+        for ( \
+            cursor_node_ptr = (queue_ptr)->head; \
+            cursor_node_ptr && (__builtin_prefetch(cursor_node_ptr->next), 1); \
+            cursor_node_ptr = cursor_node_ptr->next \
+        )
+#else
+    #define queue_for_each_prefetch(cursor_node_ptr, queue_ptr) \
+        queue_for_each(cursor_node_ptr, queue_ptr)
+#endif
+
 /**
  * Iterates over the @ref Queue from front to back, and is safe against reassignment and/or removal of the
  * @ref cursor_node_ptr.
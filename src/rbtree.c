@@ -21,6 +21,24 @@ CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
 
 #include "rbtree.h"
 
+/* ========================================================================================================
+ *
+ *                                              STATIC MACROS
+ *
+ * ======================================================================================================== */
+
+/*
+ * Stores the @ref value into a link of a @ref RBTreeNode, the root link or the size of a @ref RBTree. When
+ * RBTREE_ATOMIC_LINKS is defined, the stores are relaxed atomic stores, which is what a @ref SeqlockRBTree
+ * needs: its readers load the links while a writer changes them, and a plain store racing with those loads
+ * is undefined behavior in C11. On the usual targets, such a store is the same instruction as a plain one.
+ */
+#ifdef RBTREE_ATOMIC_LINKS
+    #define STORE(lvalue, value) __atomic_store_n(&(lvalue), (value), __ATOMIC_RELAXED)
+#else
+    #define STORE(lvalue, value) ((lvalue) = (value))
+#endif
+
 /* ========================================================================================================
  *
  *                                        STATIC FUNCTION PROTOTYPES
@@ -47,6 +65,12 @@ static RBTreeNode* grandparent(const RBTreeNode *node);
 */
 static RBTreeNode* uncle(const RBTreeNode *node);
 
+/*
+ * Copies the links and the color of the @ref src_node into the @ref dst_node, one member at a time so that
+ * every link goes through STORE.
+ */
+static void copy_node(RBTreeNode *dst_node, const RBTreeNode *src_node);
+
 /*
  * Replaces the @ref old_node with the @ref new_node in the @ref rbtree.
  */
@@ -73,6 +97,35 @@ static void rotate_left(RBTree *rbtree, RBTreeNode *node);
  */
 static void rotate_right(RBTree *rbtree, RBTreeNode *node);
 
+/*
+ * Returns the right child of the @ref node if @ref right != 0; otherwise, the left child.
+ */
+static RBTreeNode* child(const RBTreeNode *node, int right);
+
+/*
+ * Performs a rotation around the @ref node in the @ref rbtree that moves the @ref node down to the right if
+ * @ref right != 0; otherwise, down to the left.
+ */
+static void rotate(RBTree *rbtree, RBTreeNode *node, int right);
+
+/*
+ * Restores the red property between the red @ref node and its red parent with one or two rotations around
+ * the grandparent, during a top-down insertion. The uncle of the @ref node must be black.
+ */
+static void repair_red_parent(RBTree *rbtree, RBTreeNode *node);
+
+/*
+ * Links the @ref node into the @ref rbtree through the @ref link, a NULL child link of the @ref parent (or
+ * the root link if @ref parent == NULL), then rebalances the @ref rbtree.
+ */
+static void link_node(RBTree *rbtree, RBTreeNode *parent, RBTreeNode **link, RBTreeNode *node);
+
+/*
+ * Inserts the @ref node with associated @ref key, searching from @ref n down. The @ref key must belong to
+ * the subtree of @ref n.
+ */
+static void insert_below(RBTree *rbtree, RBTreeNode *n, const void *key, RBTreeNode *node);
+
 /*
  * Repairs the @ref rbtree after the insertion of the @ref node.
  */
@@ -115,45 +168,54 @@ static RBTreeNode* uncle(const RBTreeNode *node) {
     return sibling(node->parent);
 }
 
+static void copy_node(RBTreeNode *dst_node, const RBTreeNode *src_node) {
+    assert(dst_node && src_node);
+
+    STORE(dst_node->parent, src_node->parent);
+    STORE(dst_node->left_child, src_node->left_child);
+    STORE(dst_node->right_child, src_node->right_child);
+    dst_node->color = src_node->color;
+}
+
 static void replace(RBTree *rbtree, RBTreeNode *old_node, RBTreeNode *new_node) {
     assert(rbtree && old_node && new_node);
 
     if (rbtree->root == old_node) {
-        rbtree->root = new_node;
+        STORE(rbtree->root, new_node);
     } else if (old_node == old_node->parent->left_child) {
-        old_node->parent->left_child = new_node;
+        STORE(old_node->parent->left_child, new_node);
     } else {
-        old_node->parent->right_child = new_node;
+        STORE(old_node->parent->right_child, new_node);
     }
 
     if (old_node->left_child) {
-        old_node->left_child->parent = new_node;
+        STORE(old_node->left_child->parent, new_node);
     }
 
     if (old_node->right_child) {
-        old_node->right_child->parent = new_node;
+        STORE(old_node->right_child->parent, new_node);
     }
 
-    *new_node = *old_node;
+    copy_node(new_node, old_node);
 
-    old_node->parent = RBTREE_POISON_PARENT;
-    old_node->left_child = RBTREE_POISON_LEFT_CHILD;
-    old_node->right_child = RBTREE_POISON_RIGHT_CHILD;
+    STORE(old_node->parent, RBTREE_POISON_PARENT);
+    STORE(old_node->left_child, RBTREE_POISON_LEFT_CHILD);
+    STORE(old_node->right_child, RBTREE_POISON_RIGHT_CHILD);
 }
 
 static void transplant(RBTree *rbtree, RBTreeNode *old_node, RBTreeNode *new_node) {
     assert(rbtree && old_node);
 
     if (!old_node->parent) {
-        rbtree->root = new_node;
+        STORE(rbtree->root, new_node);
     } else if (old_node == old_node->parent->left_child) {
-        old_node->parent->left_child = new_node;
+        STORE(old_node->parent->left_child, new_node);
     } else {
-        old_node->parent->right_child = new_node;
+        STORE(old_node->parent->right_child, new_node);
     }
 
     if (new_node) {
-        new_node->parent = old_node->parent;
+        STORE(new_node->parent, old_node->parent);
     }
 }
 
@@ -163,54 +225,54 @@ static void swap_places(RBTree *rbtree, RBTreeNode *high_node, RBTreeNode *low_n
     assert(rbtree && high_node && low_node);
 
     if (!high_node->parent) {
-        rbtree->root = low_node;
+        STORE(rbtree->root, low_node);
     } else if (high_node->parent->left_child == high_node) {
-        high_node->parent->left_child = low_node;
+        STORE(high_node->parent->left_child, low_node);
     } else {
-        high_node->parent->right_child = low_node;
+        STORE(high_node->parent->right_child, low_node);
     }
 
     if (low_node->left_child) {
-        low_node->left_child->parent = high_node;
+        STORE(low_node->left_child->parent, high_node);
     }
 
     if (low_node->right_child) {
-        low_node->right_child->parent = high_node;
+        STORE(low_node->right_child->parent, high_node);
     }
 
     if (high_node->left_child == low_node) {
         if (high_node->right_child) {
-            high_node->right_child->parent = low_node;
+            STORE(high_node->right_child->parent, low_node);
         }
 
-        high_node->left_child = high_node;
-        low_node->parent = low_node;
+        STORE(high_node->left_child, high_node);
+        STORE(low_node->parent, low_node);
     } else if (high_node->right_child == low_node) {
         if (high_node->left_child) {
-            high_node->left_child->parent = low_node;
+            STORE(high_node->left_child->parent, low_node);
         }
 
-        high_node->right_child = high_node;
-        low_node->parent = low_node;
+        STORE(high_node->right_child, high_node);
+        STORE(low_node->parent, low_node);
     } else {
         if (high_node->left_child) {
-            high_node->left_child->parent = low_node;
+            STORE(high_node->left_child->parent, low_node);
         }
 
         if (high_node->right_child) {
-            high_node->right_child->parent = low_node;
+            STORE(high_node->right_child->parent, low_node);
         }
 
         if (low_node->parent->left_child == low_node) {
-            low_node->parent->left_child = high_node;
+            STORE(low_node->parent->left_child, high_node);
         } else {
-            low_node->parent->right_child = high_node;
+            STORE(low_node->parent->right_child, high_node);
         }
     }
 
     high_cpy = *high_node;
-    *high_node = *low_node;
-    *low_node = high_cpy;
+    copy_node(high_node, low_node);
+    copy_node(low_node, &high_cpy);
 }
 
 static void rotate_left(RBTree *rbtree, RBTreeNode *node) {
@@ -222,14 +284,14 @@ static void rotate_left(RBTree *rbtree, RBTreeNode *node) {
 
     transplant(rbtree, node, n);
 
-    node->right_child = n->left_child;
+    STORE(node->right_child, n->left_child);
 
     if (n->left_child) {
-        n->left_child->parent = node;
+        STORE(n->left_child->parent, node);
     }
 
-    n->left_child = node;
-    node->parent = n;
+    STORE(n->left_child, node);
+    STORE(node->parent, n);
 }
 
 static void rotate_right(RBTree *rbtree, RBTreeNode *node) {
@@ -241,14 +303,107 @@ static void rotate_right(RBTree *rbtree, RBTreeNode *node) {
 
     transplant(rbtree, node, n);
 
-    node->left_child = n->right_child;
+    STORE(node->left_child, n->right_child);
 
     if (n->right_child) {
-        n->right_child->parent = node;
+        STORE(n->right_child->parent, node);
     }
 
-    n->right_child = node;
-    node->parent = n;
+    STORE(n->right_child, node);
+    STORE(node->parent, n);
+}
+
+static RBTreeNode* child(const RBTreeNode *node, int right) {
+    assert(node);
+
+    return right ? node->right_child : node->left_child;
+}
+
+static void rotate(RBTree *rbtree, RBTreeNode *node, int right) {
+    if (right) {
+        rotate_right(rbtree, node);
+    } else {
+        rotate_left(rbtree, node);
+    }
+}
+
+static void repair_red_parent(RBTree *rbtree, RBTreeNode *node) {
+    RBTreeNode *p, *g;
+
+    assert(rbtree && node && node->parent && node->parent->parent);
+
+    p = node->parent;
+    g = p->parent;
+
+    if (p == g->left_child) {
+        if (node == p->right_child) {
+            rotate_left(rbtree, p);
+
+            p = node;
+        }
+
+        rotate_right(rbtree, g);
+    } else {
+        if (node == p->left_child) {
+            rotate_right(rbtree, p);
+
+            p = node;
+        }
+
+        rotate_left(rbtree, g);
+    }
+
+    p->color = RBTREE_NODE_BLACK;
+    g->color = RBTREE_NODE_RED;
+}
+
+static void link_node(RBTree *rbtree, RBTreeNode *parent, RBTreeNode **link, RBTreeNode *node) {
+    assert(rbtree && link && !*link && node);
+
+    STORE(*link, node);
+
+    STORE(node->parent, parent);
+    STORE(node->left_child, NULL);
+    STORE(node->right_child, NULL);
+    node->color = RBTREE_NODE_RED;
+
+    repair_after_insert(rbtree, node);
+
+    STORE(rbtree->size, rbtree->size + 1);
+}
+
+static void insert_below(RBTree *rbtree, RBTreeNode *n, const void *key, RBTreeNode *node) {
+    assert(rbtree && n && node);
+
+    for ( ; ; ) {
+        int cmp = rbtree->compare(key, n);
+
+        if (cmp < 0) {
+            if (n->left_child) {
+                n = n->left_child;
+            } else {
+                link_node(rbtree, n, &n->left_child, node);
+
+                return;
+            }
+        } else if (cmp > 0) {
+            if (n->right_child) {
+                n = n->right_child;
+            } else {
+                link_node(rbtree, n, &n->right_child, node);
+
+                return;
+            }
+        } else {
+            replace(rbtree, n, node);
+
+            if (rbtree->collide) {
+                rbtree->collide(n, node, rbtree->auxiliary_data);
+            }
+
+            return;
+        }
+    }
 }
 
 static void repair_after_insert(RBTree *rbtree, RBTreeNode *node) {
@@ -396,8 +551,8 @@ void rbtree_init(
     rbtree->compare = compare;
     rbtree->collide = collide;
     rbtree->auxiliary_data = auxiliary_data;
-    rbtree->root = NULL;
-    rbtree->size = 0;
+    STORE(rbtree->root, NULL);
+    STORE(rbtree->size, 0);
 }
 
 RBTreeNode* rbtree_first(const RBTree *rbtree) {
@@ -551,56 +706,146 @@ RBTreeNode* rbtree_at(const RBTree *rbtree, size_t index) {
 }
 
 void rbtree_insert(RBTree *rbtree, const void *key, RBTreeNode *node) {
-    RBTreeNode *n;
+    assert(rbtree && node);
+
+    if (rbtree->root) {
+        insert_below(rbtree, rbtree->root, key, node);
+    } else {
+        link_node(rbtree, NULL, &rbtree->root, node);
+    }
+}
+
+void rbtree_insert_near(RBTree *rbtree, RBTreeNode *hint, const void *key, RBTreeNode *node) {
+    RBTreeNode *n, *p;
+    int cmp, parent_cmp;
 
     assert(rbtree && node);
 
-    n = rbtree->root;
+    if (!hint) {
+        rbtree_insert(rbtree, key, node);
 
-    if (n) {
-        for ( ; ; ) {
-            int cmp = rbtree->compare(key, n);
+        return;
+    }
 
-            if (cmp < 0) {
-                if (n->left_child) {
-                    n = n->left_child;
-                } else {
-                    n->left_child = node;
+    n = hint;
+    cmp = rbtree->compare(key, n);
 
-                    break;
-                }
-            } else if (cmp > 0) {
-                if (n->right_child) {
-                    n = n->right_child;
-                } else {
-                    n->right_child = node;
+    if (cmp == 0) {
+        insert_below(rbtree, n, key, node);
 
-                    break;
-                }
-            } else {
-                replace(rbtree, n, node);
+        return;
+    }
 
-                if (rbtree->collide) {
-                    rbtree->collide(n, node, rbtree->auxiliary_data);
-                }
+    /*
+     * Climbs while the key is past the bound of the subtree of n, which is the lowest ancestor with n on its
+     * side of the key. Only the bounds are compared with the key, and the key belongs below the last n.
+     */
+    for (;;) {
+        for (p = n; p->parent && p == (cmp > 0 ? p->parent->right_child : p->parent->left_child);) {
+            p = p->parent;
+        }
+        p = p->parent;
 
-                return;
-            }
+        if (!p) {
+            break;
+        }
+
+        parent_cmp = rbtree->compare(key, p);
+
+        if (parent_cmp == 0) {
+            insert_below(rbtree, p, key, node);
+
+            return;
         }
+
+        if ((parent_cmp > 0) != (cmp > 0)) {
+            break;
+        }
+
+        n = p;
     }
 
-    node->parent = n;
-    node->left_child = NULL;
-    node->right_child = NULL;
-    node->color = RBTREE_NODE_RED;
+    if (cmp > 0) {
+        if (n->right_child) {
+            insert_below(rbtree, n->right_child, key, node);
+        } else {
+            link_node(rbtree, n, &n->right_child, node);
+        }
+    } else {
+        if (n->left_child) {
+            insert_below(rbtree, n->left_child, key, node);
+        } else {
+            link_node(rbtree, n, &n->left_child, node);
+        }
+    }
+}
 
-    if (!n) {
-        rbtree->root = node;
+void rbtree_insert_sorted(
+    RBTree *rbtree,
+    const void *const *keys,
+    RBTreeNode *const *nodes,
+    size_t num_nodes
+) {
+    RBTreeNode *hint = NULL;
+    size_t i;
+
+    assert(rbtree && ((keys && nodes) || num_nodes == 0));
+
+    for (i = 0; i < num_nodes; ++i) {
+        rbtree_insert_near(rbtree, hint, keys[i], nodes[i]);
+        hint = nodes[i];
     }
+}
 
-    repair_after_insert(rbtree, node);
+void rbtree_insert_top_down(RBTree *rbtree, const void *key, RBTreeNode *node) {
+    RBTreeNode *n, *p = NULL, **link = &rbtree->root;
+
+    assert(rbtree && node);
+
+    for (n = rbtree->root; n; n = *link) {
+        int cmp;
+
+        /* Splits a node with two red children on the way down, so that the uncle of a red node is black. */
+        if (color(n->left_child) == RBTREE_NODE_RED && color(n->right_child) == RBTREE_NODE_RED) {
+            n->color = RBTREE_NODE_RED;
+            n->left_child->color = RBTREE_NODE_BLACK;
+            n->right_child->color = RBTREE_NODE_BLACK;
+
+            if (n == rbtree->root) {
+                n->color = RBTREE_NODE_BLACK;
+            } else if (color(n->parent) == RBTREE_NODE_RED) {
+                repair_red_parent(rbtree, n);
+            }
+        }
+
+        cmp = rbtree->compare(key, n);
+
+        if (cmp == 0) {
+            replace(rbtree, n, node);
 
-    ++rbtree->size;
+            if (rbtree->collide) {
+                rbtree->collide(n, node, rbtree->auxiliary_data);
+            }
+
+            return;
+        }
+
+        p = n;
+        link = cmp < 0 ? &n->left_child : &n->right_child;
+    }
+
+    STORE(*link, node);
+
+    STORE(node->parent, p);
+    STORE(node->left_child, NULL);
+    STORE(node->right_child, NULL);
+    node->color = p ? RBTREE_NODE_RED : RBTREE_NODE_BLACK;
+
+    if (color(p) == RBTREE_NODE_RED) {
+        repair_red_parent(rbtree, node);
+    }
+
+    STORE(rbtree->size, rbtree->size + 1);
 }
 
 RBTreeNode* rbtree_lookup_key(const RBTree *rbtree, const void *key) {
@@ -656,11 +901,11 @@ void rbtree_remove(RBTree *rbtree, RBTreeNode *node) {
         n->color = RBTREE_NODE_BLACK;
     }
 
-    node->parent = RBTREE_POISON_PARENT;
-    node->left_child = RBTREE_POISON_LEFT_CHILD;
-    node->right_child = RBTREE_POISON_RIGHT_CHILD;
+    STORE(node->parent, RBTREE_POISON_PARENT);
+    STORE(node->left_child, RBTREE_POISON_LEFT_CHILD);
+    STORE(node->right_child, RBTREE_POISON_RIGHT_CHILD);
 
-    --rbtree->size;
+    STORE(rbtree->size, rbtree->size - 1);
 }
 
 void rbtree_remove_key(RBTree *rbtree, const void *key) {
@@ -669,6 +914,88 @@ void rbtree_remove_key(RBTree *rbtree, const void *key) {
     rbtree_remove(rbtree, rbtree_lookup_key(rbtree, key));
 }
 
+RBTreeNode* rbtree_remove_key_top_down(RBTree *rbtree, const void *key) {
+    RBTreeNode *n, *p, *s, *top, *found = NULL;
+    int dir = 0, last;
+
+    assert(rbtree);
+
+    /*
+     * Makes every node red before leaving it, by pulling red down from its parent or its sibling, so that the
+     * node removed at the bottom is red. Once the key is found, the search continues to its predecessor,
+     * which takes its place.
+     */
+    for (n = rbtree->root; n; n = child(n, dir)) {
+        p = n->parent;
+        last = p && n == p->right_child;
+
+        if (!found) {
+            int cmp = rbtree->compare(key, n);
+
+            if (cmp == 0) {
+                found = n;
+            }
+
+            dir = cmp > 0;
+        } else {
+            dir = 1;
+        }
+
+        if (color(n) == RBTREE_NODE_BLACK && color(child(n, dir)) == RBTREE_NODE_BLACK) {
+            if (color(child(n, !dir)) == RBTREE_NODE_RED) {
+                top = child(n, !dir);
+
+                rotate(rbtree, n, dir);
+
+                n->color = RBTREE_NODE_RED;
+                top->color = RBTREE_NODE_BLACK;
+            } else if (p && (s = child(p, !last))) {
+                if (color(s->left_child) == RBTREE_NODE_BLACK && color(s->right_child) == RBTREE_NODE_BLACK) {
+                    p->color = RBTREE_NODE_BLACK;
+                    s->color = RBTREE_NODE_RED;
+                    n->color = RBTREE_NODE_RED;
+                } else {
+                    if (color(child(s, last)) == RBTREE_NODE_RED) {
+                        rotate(rbtree, s, !last);
+                    }
+
+                    rotate(rbtree, p, last);
+
+                    top = p->parent;
+                    n->color = RBTREE_NODE_RED;
+                    top->color = RBTREE_NODE_RED;
+                    top->left_child->color = RBTREE_NODE_BLACK;
+                    top->right_child->color = RBTREE_NODE_BLACK;
+                }
+            }
+        }
+
+        if (!child(n, dir)) {
+            break;
+        }
+    }
+
+    if (found) {
+        transplant(rbtree, n, n->left_child ? n->left_child : n->right_child);
+
+        if (n != found) {
+            replace(rbtree, found, n);
+        } else {
+            STORE(found->parent, RBTREE_POISON_PARENT);
+            STORE(found->left_child, RBTREE_POISON_LEFT_CHILD);
+            STORE(found->right_child, RBTREE_POISON_RIGHT_CHILD);
+        }
+
+        STORE(rbtree->size, rbtree->size - 1);
+    }
+
+    if (rbtree->root) {
+        rbtree->root->color = RBTREE_NODE_BLACK;
+    }
+
+    return found;
+}
+
 void rbtree_remove_first(RBTree *rbtree) {
     assert(rbtree);
 
@@ -685,11 +1012,11 @@ void rbtree_remove_all(RBTree *rbtree) {
     assert(rbtree);
 
     if (rbtree->root) {
-        rbtree->root->parent = RBTREE_POISON_PARENT;
-        rbtree->root->left_child = RBTREE_POISON_LEFT_CHILD;
-        rbtree->root->right_child = RBTREE_POISON_RIGHT_CHILD;
+        STORE(rbtree->root->parent, RBTREE_POISON_PARENT);
+        STORE(rbtree->root->left_child, RBTREE_POISON_LEFT_CHILD);
+        STORE(rbtree->root->right_child, RBTREE_POISON_RIGHT_CHILD);
     }
 
-    rbtree->root = NULL;
-    rbtree->size = 0;
+    STORE(rbtree->root, NULL);
+    STORE(rbtree->size, 0);
 }
@@ -37,6 +37,10 @@ CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
  * @ref RBTree. This data is user-defined. This data, for example, could be a memory pool object that is used
  * for freeing up resources held by the old @ref RBTreeNode in the collide function.
  *
+ * Defining RBTREE_ATOMIC_LINKS when compiling rbtree.c makes it write the links of the @ref RBTreeNode's,
+ * and the root and size of the @ref RBTree, with relaxed atomic stores (GCC/Clang __atomic builtins), which
+ * a @ref SeqlockRBTree requires. It does not change the API.
+ *
  * Example:
  *          struct Object {
  *              int key;
@@ -93,11 +97,15 @@ CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
  *          -   rbtree_at
  *      Insertion:
  *          -   rbtree_insert
+ *          -   rbtree_insert_near
+ *          -   rbtree_insert_sorted
+ *          -   rbtree_insert_top_down
  *      Lookup:
  *          -   rbtree_lookup_key
  *      Removal:
  *          -   rbtree_remove
  *          -   rbtree_remove_key
+ *          -   rbtree_remove_key_top_down
  *          -   rbtree_remove_first
  *          -   rbtree_remove_last
  *          -   rbtree_remove_all
@@ -114,6 +122,8 @@ CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
  *      Traversal:
  *          -   rbtree_for_each
  *          -   rbtree_for_each_reverse
+ *          -   rbtree_for_each_prefetch
+ *          -   rbtree_for_each_prefetch_reverse
  *          -   rbtree_for_each_safe
  *          -   rbtree_for_each_safe_reverse
  *          -   rbtree_for_each_after
@@ -372,6 +382,76 @@ RBTreeNode* rbtree_at(const RBTree *rbtree, size_t index);
  */
 void rbtree_insert(RBTree *rbtree, const void *key, RBTreeNode *node);
 
+/**
+ * Inserts the @ref node with associated @ref key into the @ref rbtree like @ref rbtree_insert, but searches
+ * for its place from the @ref hint (a finger search) instead of from the root: the search climbs from the
+ * @ref hint to the lowest ancestor whose subtree the @ref key belongs to, then descends from there. This
+ * takes O(log(d)) comparisons, where d is the number of @ref RBTreeNode's between the @ref hint and the
+ * @ref key, so it pays off when the @ref key is close to the @ref hint, e.g. the previously inserted
+ * @ref RBTreeNode when keys arrive in sorted order.
+ *
+ * Requirements:
+ *      -   @ref rbtree != NULL
+ *      -   @ref node != NULL
+ *      -   @ref hint == NULL, or @ref hint is in the @ref rbtree.
+ *
+ * Time complexity:
+ *      -   O(log(d)) comparisons, and amortized O(1) rebalancing
+ *
+ * @param rbtree                The @ref RBTree to be operated on.
+ * @param hint                  The @ref RBTreeNode to start searching from. If NULL, the search starts from
+ *                              the root.
+ * @param key                   The key associated with the @ref node.
+ * @param node                  The @ref RBTreeNode to be inserted.
+ */
+void rbtree_insert_near(RBTree *rbtree, RBTreeNode *hint, const void *key, RBTreeNode *node);
+
+/**
+ * Inserts the @ref num_nodes @ref nodes with associated @ref keys into the @ref rbtree, each one searched
+ * for from the one inserted before it with @ref rbtree_insert_near. Any order is correct, but when the
+ * @ref keys are sorted (in either direction), inserting k keys costs O(k log(n/k)) comparisons instead of
+ * O(k log(n)). Collisions are handled like in @ref rbtree_insert, including collisions between the
+ * @ref keys themselves.
+ *
+ * Requirements:
+ *      -   @ref rbtree != NULL
+ *      -   @ref keys != NULL and @ref nodes != NULL, or @ref num_nodes == 0
+ *      -   @ref nodes[i] != NULL
+ *
+ * Time complexity:
+ *      -   O(k log(n/k)) comparisons for k sorted keys
+ *
+ * @param rbtree                The @ref RBTree to be operated on.
+ * @param keys                  The keys associated with the @ref nodes, keys[i] with nodes[i].
+ * @param nodes                 The @ref RBTreeNode's to be inserted.
+ * @param num_nodes             The number of @ref nodes.
+ */
+void rbtree_insert_sorted(
+    RBTree *rbtree,
+    const void *const *keys,
+    RBTreeNode *const *nodes,
+    size_t num_nodes
+);
+
+/**
+ * Inserts the @ref node with associated @ref key into the @ref rbtree like @ref rbtree_insert, but rebalances
+ * on the way down instead of walking back up from the new leaf: nodes with two red children are split as
+ * they are passed, so that at most one or two rotations near the current node are ever needed. The path is
+ * traversed once, and every change is made within a few levels of the current node.
+ *
+ * Requirements:
+ *      -   @ref rbtree != NULL
+ *      -   @ref node != NULL
+ *
+ * Time complexity:
+ *      -   O(log(n))
+ *
+ * @param rbtree                The @ref RBTree to be operated on.
+ * @param key                   The key associated with the @ref node.
+ * @param node                  The @ref RBTreeNode to be inserted.
+ */
+void rbtree_insert_top_down(RBTree *rbtree, const void *key, RBTreeNode *node);
+
 /**
  * Returns the @ref RBTreeNode associated with the @ref key in the @ref rbtree. NULL if a match for the @ref
  * key is not found.
@@ -418,6 +498,25 @@ void rbtree_remove(RBTree *rbtree, RBTreeNode *node);
  */
 void rbtree_remove_key(RBTree *rbtree, const void *key);
 
+/**
+ * Removes the @ref RBTreeNode associated with the @ref key from the @ref rbtree like @ref rbtree_remove_key,
+ * but in a single pass down the @ref rbtree: red is pushed down along the path as it is traversed, so that
+ * the @ref RBTreeNode finally unlinked at the bottom is red and needs no repair. The @ref rbtree may be
+ * restructured even if a match for the @ref key is not found.
+ *
+ * Requirements:
+ *      -   @ref rbtree != NULL
+ *
+ * Time complexity:
+ *      -   O(log(n))
+ *
+ * @param rbtree                The @ref RBTree to be operated on.
+ * @param key                   The key used for lookup.
+ * @return                      NULL if a match for the @ref key is not found; otherwise, the removed
+ *                              @ref RBTreeNode.
+ */
+RBTreeNode* rbtree_remove_key_top_down(RBTree *rbtree, const void *key);
+
 /**
  * Removes the first inorder @ref RBTreeNode from the @ref rbtree. If the @ref rbtree is empty, this function
  * simply returns.
@@ -552,6 +651,58 @@ void rbtree_remove_all(RBTree *rbtree);
         cursor_node_ptr = rbtree_prev(cursor_node_ptr) \
     )
 
+/**
+ * Iterates over the @ref RBTree (inorder) from the first @ref RBTreeNode to the last @ref RBTreeNode, and
+ * prefetches the first step of the path to the successor while the loop's body runs. When the
+ * @ref cursor_node_ptr has a right child, the successor lies below it; otherwise the successor is an ancestor
+ * that was visited on the way down, and is likely still cached. Without GNU extensions, this is simply
+ * @ref rbtree_for_each.
+ *
+ * Requirements:
+ *      -   @ref rbtree_ptr != NULL
+ *      -   The @ref cursor_node_ptr is neither reassigned nor removed from its associated @ref RBTree in the
+ *          loop's body.
+ *
+ * @param cursor_node_ptr       The @ref RBTreeNode to use as a loop cursor.
+ * @param rbtree_ptr            The pointer to a @ref RBTree that will be iterated over.
+ */
+#if defined(__GNUC__) && !defined(__STRICT_ANSI__)
+    #define rbtree_for_each_prefetch(cursor_node_ptr, rbtree_ptr) \
+        for ( \
+            cursor_node_ptr = rbtree_first(rbtree_ptr); \
+            cursor_node_ptr && (__builtin_prefetch(cursor_node_ptr->right_child), 1); \
+            cursor_node_ptr = rbtree_next(cursor_node_ptr) \
+        )
+#else
+    #define rbtree_for_each_prefetch(cursor_node_ptr, rbtree_ptr) \
+        rbtree_for_each(cursor_node_ptr, rbtree_ptr)
+#endif
+
+/**
+ * Iterates over the @ref RBTree (inorder) from the last @ref RBTreeNode to the first @ref RBTreeNode, and
+ * prefetches the first step of the path to the predecessor (the left child) while the loop's body runs.
+ * Without GNU extensions, this is simply @ref rbtree_for_each_reverse.
+ *
+ * Requirements:
+ *      -   @ref rbtree_ptr != NULL
+ *      -   The @ref cursor_node_ptr is neither reassigned nor removed from its associated @ref RBTree in the
+ *          loop's body.
+ *
+ * @param cursor_node_ptr       The @ref RBTreeNode to use as a loop cursor.
+ * @param rbtree_ptr            The pointer to a @ref RBTree that will be iterated over.
+ */
+#if defined(__GNUC__) && !defined(__STRICT_ANSI__)
+    #define rbtree_for_each_prefetch_reverse(cursor_node_ptr, rbtree_ptr) \
+        for ( \
+            cursor_node_ptr = rbtree_last(rbtree_ptr); \
+            cursor_node_ptr && (__builtin_prefetch(cursor_node_ptr->left_child), 1); \
+            cursor_node_ptr = rbtree_prev(cursor_node_ptr) \
+        )
+#else
+    #define rbtree_for_each_prefetch_reverse(cursor_node_ptr, rbtree_ptr) \
+        rbtree_for_each_reverse(cursor_node_ptr, rbtree_ptr)
+#endif
+
 /**
  * Iterates over the @ref RBTree (inorder) from the first @ref RBTreeNode to the last @ref RBTreeNode, and is
  * safe against reassignment and/or removal of the @ref cursor_node_ptr.
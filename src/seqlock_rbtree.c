@@ -0,0 +1,263 @@
+/*
+Copyright (c) 2017, Michael J Welsh
+
+Permission to use, copy, modify, and/or distribute this software
+for any purpose with or without fee is hereby granted, provided
+that the above copyright notice and this permission notice appear
+in all copies.
+
+THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL
+WARRANTIES WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE
+AUTHOR BE LIABLE FOR ANY SPECIAL, DIRECT, INDIRECT, OR
+CONSEQUENTIAL DAMAGES OR ANY DAMAGES WHATSOEVER RESULTING FROM
+LOSS OF USE, DATA OR PROFITS, WHETHER IN AN ACTION OF CONTRACT,
+NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF OR IN
+CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+
+#include <assert.h>
+#include <stddef.h>
+
+#include "seqlock_rbtree.h"
+
+/* ========================================================================================================
+ *
+ *                                        STATIC FUNCTION PROTOTYPES
+ *
+ * ======================================================================================================== */
+
+/*
+ * Loads the @ref link atomically, so that a link being rewritten by a writer is never torn, and is loaded
+ * again every time it is followed. The poison values a removal leaves in the links of a @ref RBTreeNode are
+ * loaded as NULL, since a traversal can reach a @ref RBTreeNode right after its removal.
+ */
+static RBTreeNode* load(RBTreeNode *const *link);
+
+/* ========================================================================================================
+ *
+ *                                        STATIC FUNCTION DEFINITIONS
+ *
+ * ======================================================================================================== */
+
+static RBTreeNode* load(RBTreeNode *const *link) {
+    RBTreeNode *node;
+
+    assert(link);
+
+    node = __atomic_load_n(link, __ATOMIC_RELAXED);
+    if (
+        node == RBTREE_POISON_PARENT ||
+        node == RBTREE_POISON_LEFT_CHILD ||
+        node == RBTREE_POISON_RIGHT_CHILD
+    ) {
+        return NULL;
+    }
+
+    return node;
+}
+
+/* ========================================================================================================
+ *
+ *                                        EXTERN FUNCTION DEFINITIONS
+ *
+ * ======================================================================================================== */
+
+void seqlock_rbtree_init(
+    SeqlockRBTree *tree,
+    int (*compare)(const void *key, const RBTreeNode *node),
+    void (*collide)(const RBTreeNode *old_node, const RBTreeNode *new_node, void *auxiliary_data),
+    void *auxiliary_data
+) {
+    assert(tree && compare);
+
+    rbtree_init(&tree->rbtree, compare, collide, auxiliary_data);
+    tree->sequence = 0;
+}
+
+RBTree* seqlock_rbtree_rbtree(SeqlockRBTree *tree) {
+    assert(tree);
+
+    return &tree->rbtree;
+}
+
+size_t seqlock_rbtree_size(const SeqlockRBTree *tree) {
+    size_t sequence, size;
+
+    assert(tree);
+
+    do {
+        sequence = seqlock_rbtree_read_begin(tree);
+        size = __atomic_load_n(&tree->rbtree.size, __ATOMIC_RELAXED);
+    } while (seqlock_rbtree_read_retry(tree, sequence));
+
+    return size;
+}
+
+void seqlock_rbtree_write_begin(SeqlockRBTree *tree) {
+    size_t sequence;
+
+    assert(tree);
+
+    /* Making the sequence odd is what excludes the other writers. */
+    for (;;) {
+        sequence = __atomic_load_n(&tree->sequence, __ATOMIC_RELAXED);
+        if (sequence % 2 == 0 && __atomic_compare_exchange_n(
+            &tree->sequence, &sequence, sequence + 1, 0, __ATOMIC_ACQUIRE, __ATOMIC_RELAXED
+        )) {
+            break;
+        }
+    }
+
+    /* Keeps the writes to the tree from becoming visible before the odd sequence. */
+    __atomic_thread_fence(__ATOMIC_RELEASE);
+}
+
+void seqlock_rbtree_write_end(SeqlockRBTree *tree) {
+    assert(tree);
+    assert(tree->sequence % 2 == 1);
+
+    __atomic_store_n(&tree->sequence, tree->sequence + 1, __ATOMIC_RELEASE);
+}
+
+void seqlock_rbtree_insert(SeqlockRBTree *tree, const void *key, RBTreeNode *node) {
+    assert(tree && node);
+
+    seqlock_rbtree_write_begin(tree);
+    rbtree_insert(&tree->rbtree, key, node);
+    seqlock_rbtree_write_end(tree);
+}
+
+void seqlock_rbtree_remove(SeqlockRBTree *tree, RBTreeNode *node) {
+    assert(tree && node);
+
+    seqlock_rbtree_write_begin(tree);
+    rbtree_remove(&tree->rbtree, node);
+    seqlock_rbtree_write_end(tree);
+}
+
+RBTreeNode* seqlock_rbtree_remove_key(SeqlockRBTree *tree, const void *key) {
+    RBTreeNode *node;
+
+    assert(tree);
+
+    seqlock_rbtree_write_begin(tree);
+    node = rbtree_lookup_key(&tree->rbtree, key);
+    if (node) {
+        rbtree_remove(&tree->rbtree, node);
+    }
+    seqlock_rbtree_write_end(tree);
+
+    return node;
+}
+
+size_t seqlock_rbtree_read_begin(const SeqlockRBTree *tree) {
+    size_t sequence;
+
+    assert(tree);
+
+    while ((sequence = __atomic_load_n(&tree->sequence, __ATOMIC_ACQUIRE)) % 2 == 1) {
+    }
+
+    return sequence;
+}
+
+int seqlock_rbtree_read_retry(const SeqlockRBTree *tree, size_t sequence) {
+    assert(tree);
+
+    /* Keeps the reads of the tree from being moved after the check. */
+    __atomic_thread_fence(__ATOMIC_ACQUIRE);
+
+    return __atomic_load_n(&tree->sequence, __ATOMIC_RELAXED) != sequence;
+}
+
+const RBTreeNode* seqlock_rbtree_find(const SeqlockRBTree *tree, const void *key) {
+    const RBTreeNode *n;
+    size_t depth;
+    int cmp;
+
+    assert(tree);
+
+    n = load(&tree->rbtree.root);
+    for (depth = 0; n && depth < SEQLOCK_RBTREE_MAX_DEPTH; ++depth) {
+        cmp = tree->rbtree.compare(key, n);
+
+        if (cmp < 0) {
+            n = load(&n->left_child);
+        } else if (cmp > 0) {
+            n = load(&n->right_child);
+        } else {
+            return n;
+        }
+    }
+
+    return NULL;
+}
+
+const RBTreeNode* seqlock_rbtree_first(const SeqlockRBTree *tree) {
+    const RBTreeNode *n, *left;
+    size_t depth;
+
+    assert(tree);
+
+    n = load(&tree->rbtree.root);
+    for (depth = 0; n && depth < SEQLOCK_RBTREE_MAX_DEPTH; ++depth) {
+        left = load(&n->left_child);
+        if (!left) {
+            return n;
+        }
+        n = left;
+    }
+
+    return NULL;
+}
+
+const RBTreeNode* seqlock_rbtree_next(const RBTreeNode *node) {
+    const RBTreeNode *n, *child;
+    size_t depth;
+
+    assert(node);
+
+    n = load(&node->right_child);
+    if (n) {
+        for (depth = 0; depth < SEQLOCK_RBTREE_MAX_DEPTH; ++depth) {
+            child = load(&n->left_child);
+            if (!child) {
+                return n;
+            }
+            n = child;
+        }
+
+        return NULL;
+    }
+
+    for (depth = 0; depth < SEQLOCK_RBTREE_MAX_DEPTH; ++depth) {
+        n = load(&node->parent);
+        if (!n || node != load(&n->right_child)) {
+            return n;
+        }
+        node = n;
+    }
+
+    return NULL;
+}
+
+const RBTreeNode* seqlock_rbtree_lookup_key(const SeqlockRBTree *tree, const void *key) {
+    const RBTreeNode *node;
+    size_t sequence;
+
+    assert(tree);
+
+    do {
+        sequence = seqlock_rbtree_read_begin(tree);
+        node = seqlock_rbtree_find(tree, key);
+    } while (seqlock_rbtree_read_retry(tree, sequence));
+
+    return node;
+}
+
+int seqlock_rbtree_contains_key(const SeqlockRBTree *tree, const void *key) {
+    assert(tree);
+
+    return seqlock_rbtree_lookup_key(tree, key) != NULL;
+}
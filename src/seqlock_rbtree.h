@@ -0,0 +1,438 @@
+/*
+Copyright (c) 2017, Michael J Welsh
+
+Permission to use, copy, modify, and/or distribute this software
+for any purpose with or without fee is hereby granted, provided
+that the above copyright notice and this permission notice appear
+in all copies.
+
+THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL
+WARRANTIES WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE
+AUTHOR BE LIABLE FOR ANY SPECIAL, DIRECT, INDIRECT, OR
+CONSEQUENTIAL DAMAGES OR ANY DAMAGES WHATSOEVER RESULTING FROM
+LOSS OF USE, DATA OR PROFITS, WHETHER IN AN ACTION OF CONTRACT,
+NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF OR IN
+CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+
+/**
+ * @file    seqlock_rbtree.h
+ * @brief   RED-BLACK TREE WITH OPTIMISTIC (SEQLOCK) READERS
+ *
+ * A @ref SeqlockRBTree is a @ref RBTree guarded by a sequence counter, for read-mostly trees shared between
+ * threads. Writers make the counter odd while they update the @ref RBTree, one writer at a time, and even
+ * again when they are done. Readers never write to shared memory: they read the counter, traverse the
+ * @ref RBTree speculatively, and retry if the counter changed meanwhile. A @ref SeqlockRBTree MUST be
+ * initialized before it is used.
+ *
+ * A speculative traversal can run into a @ref RBTree in the middle of a rotation, and see a node that was
+ * just removed (whose links hold the RBTREE_POISON_* values), a NULL link, or a cycle. The speculative
+ * functions (@ref seqlock_rbtree_find, @ref seqlock_rbtree_first and @ref seqlock_rbtree_next) therefore load
+ * every link atomically, treat poisoned links as NULL, never follow more than @ref SEQLOCK_RBTREE_MAX_DEPTH
+ * links, and return NULL when they give up. Their results, and everything read from the @ref RBTreeNode's
+ * they return, are meaningless until @ref seqlock_rbtree_read_retry returns 0 for the same read section:
+ * nothing read speculatively may be written anywhere, freed, or dereferenced beyond the @ref RBTreeNode's and
+ * keys themselves before then.
+ *
+ * The writer side of those links is rbtree.c, which MUST be compiled with RBTREE_ATOMIC_LINKS defined (e.g.
+ * "-DRBTREE_ATOMIC_LINKS") when it backs a @ref SeqlockRBTree. It then writes every link with a relaxed
+ * atomic store, so that the links never race with the atomic loads of the readers in the C11 memory model.
+ * Without it, the plain stores of rbtree.c race with those loads, which is undefined behavior, and is what
+ * ThreadSanitizer reports.
+ *
+ * The compare function may be called on ANY @ref RBTreeNode that was in the @ref SeqlockRBTree since the
+ * read section began. Removed @ref RBTreeNode's may be reinserted or recycled (e.g. through a @ref Pool), but
+ * their memory must NOT be freed, and their keys must remain safe to compare, while readers may still be
+ * traversing. The keys of @ref RBTreeNode's in the tree must not change.
+ *
+ * Example:
+ *          struct Object {
+ *              int key;
+ *              int val;
+ *              RBTreeNode n;
+ *          };
+ *
+ *          SeqlockRBTree tree;
+ *
+ *          int compare(const void *key, const RBTreeNode *node) {
+ *              return *(const int*)key - rbtree_entry(node, struct Object, n)->key;
+ *          }
+ *
+ *          int read_val(int key) {
+ *              const RBTreeNode *node;
+ *              size_t seq;
+ *              int val;
+ *
+ *              do {
+ *                  seq = seqlock_rbtree_read_begin(&tree);
+ *                  node = seqlock_rbtree_find(&tree, &key);
+ *                  val = node ? rbtree_entry(node, struct Object, n)->val : -1;
+ *              } while (seqlock_rbtree_read_retry(&tree, seq));
+ *              return val;
+ *          }
+ *
+ *          int main(void) {
+ *              static struct Object objs[1000];
+ *              int i;
+ *
+ *              seqlock_rbtree_init(&tree, compare, NULL, NULL);
+ *              for (i = 0; i < 1000; ++i) {
+ *                  objs[i].key = i;
+ *                  objs[i].val = i * i;
+ *                  seqlock_rbtree_insert(&tree, &objs[i].key, &objs[i].n);
+ *              }
+ *
+ *              assert(read_val(10) == 100);
+ *              return 0;
+ *          }
+ *
+ * Dependencies:
+ *      -   C89 assert.h
+ *      -   C89 stddef.h
+ *      -   GCC/Clang __atomic builtins
+ *      -   rbtree.h/rbtree.c, compiled with RBTREE_ATOMIC_LINKS defined
+ *
+ * API:
+ *      ====  TYPES  ====
+ *      -   typedef struct SeqlockRBTree SeqlockRBTree
+ *
+ *      ====  FUNCTIONS  ====
+ *      Initializers:
+ *          -   seqlock_rbtree_init
+ *      Properties:
+ *          -   seqlock_rbtree_rbtree
+ *          -   seqlock_rbtree_size
+ *      Writing:
+ *          -   seqlock_rbtree_write_begin
+ *          -   seqlock_rbtree_write_end
+ *      Insertion:
+ *          -   seqlock_rbtree_insert
+ *      Removal:
+ *          -   seqlock_rbtree_remove
+ *          -   seqlock_rbtree_remove_key
+ *      Speculative Reading:
+ *          -   seqlock_rbtree_read_begin
+ *          -   seqlock_rbtree_read_retry
+ *          -   seqlock_rbtree_find
+ *          -   seqlock_rbtree_first
+ *          -   seqlock_rbtree_next
+ *      Lookup:
+ *          -   seqlock_rbtree_lookup_key
+ *          -   seqlock_rbtree_contains_key
+ *
+ *      ====  MACROS  ====
+ *      Constants:
+ *          -   SEQLOCK_RBTREE_MAX_DEPTH
+ */
+
+#ifndef SEQLOCK_RBTREE_H
+#define SEQLOCK_RBTREE_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif /* __cplusplus */
+
+#include <stddef.h>
+
+#include "rbtree.h"
+
+/* ========================================================================================================
+ *
+ *                                                 MACROS
+ *
+ * ======================================================================================================== */
+
+/**
+ * The maximum number of links a speculative traversal follows before it gives up. A red-black tree with
+ * fewer than 2^64 @ref RBTreeNode's is less than 128 levels deep, so only a @ref RBTree being modified can
+ * need more.
+ */
+#define SEQLOCK_RBTREE_MAX_DEPTH 128
+
+/* ========================================================================================================
+ *
+ *                                                  TYPES
+ *
+ * ======================================================================================================== */
+
+/* Struct type declarations. */
+struct SeqlockRBTree;
+
+/* Struct typedef's. */
+typedef struct SeqlockRBTree SeqlockRBTree;
+
+/**
+ * Represents a red-black tree with optimistic readers. The "sequence" member is odd while a writer is
+ * updating the "rbtree" member.
+ */
+struct SeqlockRBTree {
+    RBTree rbtree;
+    size_t sequence;
+};
+
+/* ========================================================================================================
+ *
+ *                                               PROTOTYPES
+ *
+ * ======================================================================================================== */
+
+/**
+ * Initializes/resets the @ref tree. This is NOT thread-safe.
+ *
+ * Requirements:
+ *      -   @ref tree != NULL
+ *      -   @ref compare != NULL
+ *      -   No other thread is using the @ref tree.
+ *
+ * Time complexity:
+ *      -   O(1)
+ *
+ * @param tree                  The @ref SeqlockRBTree to be initialized/reset.
+ * @param compare               The callback function used to compare a key with the key of a
+ *                              @ref RBTreeNode. It must be safe to call from any number of threads at once.
+ * @param collide               The OPTIONAL (i.e. can be NULL) callback function used to handle key
+ *                              collisions. See @ref rbtree_init. It is called by the writer, before the
+ *                              write completes.
+ * @param auxiliary_data        The auxiliary data passed to the OPTIONAL @ref collide callback function if
+ *                              the @ref collide callback function is non-NULL. This data is NEVER manipulated
+ *                              by the @ref tree.
+ */
+void seqlock_rbtree_init(
+    SeqlockRBTree *tree,
+    int (*compare)(const void *key, const RBTreeNode *node),
+    void (*collide)(const RBTreeNode *old_node, const RBTreeNode *new_node, void *auxiliary_data),
+    void *auxiliary_data
+);
+
+/**
+ * Returns the @ref RBTree inside the @ref tree. Between @ref seqlock_rbtree_write_begin and
+ * @ref seqlock_rbtree_write_end, it can be used with every @ref RBTree function and macro. Outside of a
+ * write, it can only be read by threads that no writer runs concurrently with.
+ *
+ * Requirements:
+ *      -   @ref tree != NULL
+ *
+ * Time complexity:
+ *      -   O(1)
+ *
+ * @param tree                  The @ref SeqlockRBTree whose "rbtree" member will be returned.
+ * @return                      &@ref tree->rbtree.
+ */
+RBTree* seqlock_rbtree_rbtree(SeqlockRBTree *tree);
+
+/**
+ * Returns the number of @ref RBTreeNode's in the @ref tree, as of the last completed write.
+ *
+ * Requirements:
+ *      -   @ref tree != NULL
+ *
+ * Time complexity:
+ *      -   O(1) on average, waiting for a running write to complete
+ *
+ * @param tree                  The @ref SeqlockRBTree to be operated on.
+ * @return                      The number of @ref RBTreeNode's.
+ */
+size_t seqlock_rbtree_size(const SeqlockRBTree *tree);
+
+/**
+ * Starts a write to the @ref tree, waiting for the write of another thread to complete first. Readers that
+ * are traversing the @ref tree will retry.
+ *
+ * Requirements:
+ *      -   @ref tree != NULL
+ *      -   The calling thread is not already writing to the @ref tree.
+ *
+ * Time complexity:
+ *      -   O(1), waiting for a running write to complete
+ *
+ * @param tree                  The @ref SeqlockRBTree to be operated on.
+ */
+void seqlock_rbtree_write_begin(SeqlockRBTree *tree);
+
+/**
+ * Completes the write to the @ref tree started with @ref seqlock_rbtree_write_begin.
+ *
+ * Requirements:
+ *      -   @ref tree != NULL
+ *      -   The calling thread is writing to the @ref tree.
+ *
+ * Time complexity:
+ *      -   O(1)
+ *
+ * @param tree                  The @ref SeqlockRBTree to be operated on.
+ */
+void seqlock_rbtree_write_end(SeqlockRBTree *tree);
+
+/**
+ * Inserts the @ref node with associated @ref key into the @ref tree, as a write of its own. See
+ * @ref rbtree_insert.
+ *
+ * Requirements:
+ *      -   @ref tree != NULL
+ *      -   @ref node != NULL
+ *      -   The calling thread is not already writing to the @ref tree.
+ *      -   The @ref node is not in the @ref tree.
+ *
+ * Time complexity:
+ *      -   O(log(n)), waiting for a running write to complete
+ *
+ * @param tree                  The @ref SeqlockRBTree to be operated on.
+ * @param key                   The key associated with the @ref node.
+ * @param node                  The @ref RBTreeNode to be inserted.
+ */
+void seqlock_rbtree_insert(SeqlockRBTree *tree, const void *key, RBTreeNode *node);
+
+/**
+ * Removes the @ref node from the @ref tree, as a write of its own. The @ref node must remain readable until
+ * concurrent readers are done with it.
+ *
+ * Requirements:
+ *      -   @ref tree != NULL
+ *      -   @ref node != NULL
+ *      -   The calling thread is not already writing to the @ref tree.
+ *      -   The @ref node is in the @ref tree.
+ *
+ * Time complexity:
+ *      -   O(log(n)), waiting for a running write to complete
+ *
+ * @param tree                  The @ref SeqlockRBTree to be operated on.
+ * @param node                  The @ref RBTreeNode to be removed.
+ */
+void seqlock_rbtree_remove(SeqlockRBTree *tree, RBTreeNode *node);
+
+/**
+ * Removes the @ref RBTreeNode associated with the @ref key from the @ref tree, if there is one, as a write
+ * of its own.
+ *
+ * Requirements:
+ *      -   @ref tree != NULL
+ *      -   The calling thread is not already writing to the @ref tree.
+ *
+ * Time complexity:
+ *      -   O(log(n)), waiting for a running write to complete
+ *
+ * @param tree                  The @ref SeqlockRBTree to be operated on.
+ * @param key                   The key used for lookup.
+ * @return                      The removed @ref RBTreeNode, or NULL if there was none.
+ */
+RBTreeNode* seqlock_rbtree_remove_key(SeqlockRBTree *tree, const void *key);
+
+/**
+ * Starts a speculative read section of the @ref tree, waiting for a running write to complete first.
+ *
+ * Requirements:
+ *      -   @ref tree != NULL
+ *      -   The calling thread is not writing to the @ref tree.
+ *
+ * Time complexity:
+ *      -   O(1), waiting for a running write to complete
+ *
+ * @param tree                  The @ref SeqlockRBTree to be operated on.
+ * @return                      The sequence to pass to @ref seqlock_rbtree_read_retry.
+ */
+size_t seqlock_rbtree_read_begin(const SeqlockRBTree *tree);
+
+/**
+ * Ends the speculative read section of the @ref tree started by the @ref seqlock_rbtree_read_begin call
+ * that returned @ref sequence. Everything read in the section is consistent if and only if this returns 0.
+ *
+ * Requirements:
+ *      -   @ref tree != NULL
+ *
+ * Time complexity:
+ *      -   O(1)
+ *
+ * @param tree                  The @ref SeqlockRBTree to be operated on.
+ * @param sequence              The return value of @ref seqlock_rbtree_read_begin.
+ * @return                      1 if a write started meanwhile, and the section must be retried, otherwise 0.
+ */
+int seqlock_rbtree_read_retry(const SeqlockRBTree *tree, size_t sequence);
+
+/**
+ * Speculatively returns the @ref RBTreeNode associated with the @ref key in the @ref tree, in a read
+ * section.
+ *
+ * Requirements:
+ *      -   @ref tree != NULL
+ *      -   The calling thread is in a read section of the @ref tree.
+ *
+ * Time complexity:
+ *      -   O(log(n))
+ *
+ * @param tree                  The @ref SeqlockRBTree to be operated on.
+ * @param key                   The key used for lookup.
+ * @return                      The @ref RBTreeNode associated with the @ref key, or NULL.
+ */
+const RBTreeNode* seqlock_rbtree_find(const SeqlockRBTree *tree, const void *key);
+
+/**
+ * Speculatively returns the first @ref RBTreeNode of the @ref tree, in a read section.
+ *
+ * Requirements:
+ *      -   @ref tree != NULL
+ *      -   The calling thread is in a read section of the @ref tree.
+ *
+ * Time complexity:
+ *      -   O(log(n))
+ *
+ * @param tree                  The @ref SeqlockRBTree to be operated on.
+ * @return                      The first @ref RBTreeNode, or NULL if the @ref tree is empty.
+ */
+const RBTreeNode* seqlock_rbtree_first(const SeqlockRBTree *tree);
+
+/**
+ * Speculatively returns the @ref RBTreeNode after the @ref node, in a read section of the @ref RBTree the
+ * @ref node was returned from. Bound iterations by a count, since a concurrent write can make them skip
+ * @ref RBTreeNode's or visit some twice before the read section is retried.
+ *
+ * Requirements:
+ *      -   @ref node != NULL
+ *      -   The calling thread is in a read section.
+ *
+ * Time complexity:
+ *      -   O(log(n))
+ *
+ * @param node                  The @ref RBTreeNode to be operated on.
+ * @return                      The next @ref RBTreeNode, or NULL after the last one.
+ */
+const RBTreeNode* seqlock_rbtree_next(const RBTreeNode *node);
+
+/**
+ * Returns the @ref RBTreeNode associated with the @ref key in the @ref tree, retrying until no write
+ * interfered. The result was correct at some point during the call.
+ *
+ * Requirements:
+ *      -   @ref tree != NULL
+ *      -   The calling thread is not writing to the @ref tree.
+ *
+ * Time complexity:
+ *      -   O(log(n)) without concurrent writes
+ *
+ * @param tree                  The @ref SeqlockRBTree to be operated on.
+ * @param key                   The key used for lookup.
+ * @return                      The @ref RBTreeNode associated with the @ref key, or NULL.
+ */
+const RBTreeNode* seqlock_rbtree_lookup_key(const SeqlockRBTree *tree, const void *key);
+
+/**
+ * Determines if the @ref tree contains the @ref key, retrying until no write interfered.
+ *
+ * Requirements:
+ *      -   @ref tree != NULL
+ *      -   The calling thread is not writing to the @ref tree.
+ *
+ * Time complexity:
+ *      -   O(log(n)) without concurrent writes
+ *
+ * @param tree                  The @ref SeqlockRBTree to be operated on.
+ * @param key                   The key used for lookup.
+ * @return                      1 if the @ref tree contains the @ref key, otherwise 0.
+ */
+int seqlock_rbtree_contains_key(const SeqlockRBTree *tree, const void *key);
+
+#ifdef __cplusplus
+}
+#endif /* __cplusplus */
+
+#endif /* SEQLOCK_RBTREE_H */
@@ -0,0 +1,435 @@
+/*
+Copyright (c) 2017, Michael J Welsh
+
+Permission to use, copy, modify, and/or distribute this software
+for any purpose with or without fee is hereby granted, provided
+that the above copyright notice and this permission notice appear
+in all copies.
+
+THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL
+WARRANTIES WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE
+AUTHOR BE LIABLE FOR ANY SPECIAL, DIRECT, INDIRECT, OR
+CONSEQUENTIAL DAMAGES OR ANY DAMAGES WHATSOEVER RESULTING FROM
+LOSS OF USE, DATA OR PROFITS, WHETHER IN AN ACTION OF CONTRACT,
+NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF OR IN
+CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+
+#include <assert.h>
+#include <stddef.h>
+
+#include "skiplist.h"
+
+/* ========================================================================================================
+ *
+ *                                        STATIC FUNCTION PROTOTYPES
+ *
+ * ======================================================================================================== */
+
+/*
+ * Atomically loads the @ref link, with acquire ordering.
+ */
+static SkipListNode* load(SkipListNode *const *link);
+
+/*
+ * Atomically replaces the @ref link with @ref desired if it equals @ref expected, with acquire-release
+ * ordering. Returns 1 on success, otherwise 0.
+ */
+static int compare_and_swap(SkipListNode **link, SkipListNode *expected, SkipListNode *desired);
+
+/*
+ * Determines if the @ref link is marked, i.e. if the @ref SkipListNode it belongs to is being removed.
+ */
+static int is_marked(const SkipListNode *link);
+
+/*
+ * Returns the @ref link with its mark set.
+ */
+static SkipListNode* marked(const SkipListNode *link);
+
+/*
+ * Returns the @ref link with its mark cleared, i.e. the @ref SkipListNode it refers to.
+ */
+static SkipListNode* unmarked(const SkipListNode *link);
+
+/*
+ * Returns the height of the @ref node, 1 plus the number of times in a row that a hash of its address had
+ * its two lowest bits clear, so that about a quarter of the nodes of a level also belong to the next one.
+ * Hashing the address instead of drawing a random number keeps threads from sharing a generator.
+ */
+static size_t node_height(const SkipListNode *node);
+
+/*
+ * Fills @ref preds and @ref succs with the nodes each level of the @ref list should link the @ref key
+ * between, unlinking the nodes being removed it comes across. If @ref target != NULL, nodes with the same
+ * @ref key other than the @ref target are passed over, so that the @ref target is unlinked from every level
+ * it is linked into if it is being removed. Returns 1 if succs[0] is the @ref target (or, if
+ * @ref target == NULL, has the @ref key), otherwise 0.
+ */
+static int find(
+    SkipList *list,
+    const void *key,
+    const SkipListNode *target,
+    SkipListNode **preds,
+    SkipListNode **succs
+);
+
+/*
+ * Links the @ref node, already linked into the levels below, into the @ref level of the @ref list. Returns 0
+ * if the @ref node is being removed, in which case it must not be linked any further, otherwise 1.
+ */
+static int link_level(SkipList *list, const void *key, SkipListNode *node, size_t level);
+
+/*
+ * Returns the first node of the @ref list not less than the @ref key, without unlinking anything. Sets
+ * @ref found to 1 if its key equals the @ref key, otherwise to 0.
+ */
+static SkipListNode* search(const SkipList *list, const void *key, int *found);
+
+/*
+ * Returns the first node from the @ref node onwards that is not being removed, or NULL.
+ */
+static SkipListNode* skip_removed(SkipListNode *node);
+
+/*
+ * Marks every link of the @ref node, top level first. Returns 1 if this call marked the bottom link, i.e.
+ * removed the @ref node, otherwise 0.
+ */
+static int mark(SkipListNode *node);
+
+/* ========================================================================================================
+ *
+ *                                        STATIC FUNCTION DEFINITIONS
+ *
+ * ======================================================================================================== */
+
+static SkipListNode* load(SkipListNode *const *link) {
+    assert(link);
+
+    return __atomic_load_n(link, __ATOMIC_ACQUIRE);
+}
+
+static int compare_and_swap(SkipListNode **link, SkipListNode *expected, SkipListNode *desired) {
+    assert(link);
+
+    return __atomic_compare_exchange_n(link, &expected, desired, 0, __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE);
+}
+
+static int is_marked(const SkipListNode *link) {
+    return ((size_t) link & 1) != 0;
+}
+
+static SkipListNode* marked(const SkipListNode *link) {
+    return (SkipListNode*) ((size_t) link | 1);
+}
+
+static SkipListNode* unmarked(const SkipListNode *link) {
+    return (SkipListNode*) ((size_t) link & ~(size_t) 1);
+}
+
+static size_t node_height(const SkipListNode *node) {
+    size_t hash = (size_t) node / sizeof(SkipListNode*), height = 1;
+
+    hash ^= hash >> 16;
+    hash *= (size_t) 0x45D9F3BUL;
+    hash ^= hash >> 16;
+    hash *= (size_t) 0x45D9F3BUL;
+    hash ^= hash >> 16;
+
+    while (height < SKIPLIST_MAX_HEIGHT && (hash & 3) == 0) {
+        ++height;
+        hash >>= 2;
+    }
+
+    return height;
+}
+
+static int find(
+    SkipList *list,
+    const void *key,
+    const SkipListNode *target,
+    SkipListNode **preds,
+    SkipListNode **succs
+) {
+    SkipListNode *pred, *curr, *succ;
+    size_t level;
+    int cmp;
+
+    assert(list && preds && succs);
+
+retry:
+    pred = &list->head;
+    for (level = SKIPLIST_MAX_HEIGHT; level-- > 0;) {
+        curr = unmarked(load(&pred->next[level]));
+
+        while (curr) {
+            succ = load(&curr->next[level]);
+            if (is_marked(succ)) {
+                /* Fails if the pred was marked or linked to something else meanwhile. */
+                if (!compare_and_swap(&pred->next[level], curr, unmarked(succ))) {
+                    goto retry;
+                }
+                curr = unmarked(succ);
+                continue;
+            }
+
+            cmp = list->compare(key, curr);
+            if (cmp < 0 || (cmp == 0 && (!target || curr == target))) {
+                break;
+            }
+            pred = curr;
+            curr = succ;
+        }
+
+        preds[level] = pred;
+        succs[level] = curr;
+    }
+
+    if (target) {
+        return succs[0] == target;
+    }
+
+    return succs[0] && list->compare(key, succs[0]) == 0;
+}
+
+static int link_level(SkipList *list, const void *key, SkipListNode *node, size_t level) {
+    SkipListNode *preds[SKIPLIST_MAX_HEIGHT], *succs[SKIPLIST_MAX_HEIGHT], *next;
+
+    assert(list && node && level < node->height);
+
+    do {
+        find(list, key, node, preds, succs);
+
+        /* Once a remover marks the link, the node must stay out of the level. */
+        next = load(&node->next[level]);
+        if (is_marked(next)) {
+            return 0;
+        }
+        if (next != succs[level] && !compare_and_swap(&node->next[level], next, succs[level])) {
+            return 0;
+        }
+    } while (!compare_and_swap(&preds[level]->next[level], succs[level], node));
+
+    return 1;
+}
+
+static SkipListNode* search(const SkipList *list, const void *key, int *found) {
+    const SkipListNode *pred;
+    SkipListNode *curr, *succ;
+    size_t level;
+    int cmp = -1;
+
+    assert(list && found);
+
+    /* Nodes being removed are stepped over rather than unlinked, so readers never write. */
+    pred = &list->head;
+    curr = NULL;
+    for (level = SKIPLIST_MAX_HEIGHT; level-- > 0;) {
+        curr = unmarked(load(&pred->next[level]));
+
+        while (curr) {
+            succ = load(&curr->next[level]);
+            if (is_marked(succ)) {
+                curr = unmarked(succ);
+                continue;
+            }
+
+            cmp = list->compare(key, curr);
+            if (cmp <= 0) {
+                break;
+            }
+            pred = curr;
+            curr = succ;
+        }
+    }
+
+    *found = curr && cmp == 0;
+
+    return curr;
+}
+
+static SkipListNode* skip_removed(SkipListNode *node) {
+    SkipListNode *next;
+
+    while (node) {
+        next = load(&node->next[0]);
+        if (!is_marked(next)) {
+            break;
+        }
+        node = unmarked(next);
+    }
+
+    return node;
+}
+
+static int mark(SkipListNode *node) {
+    SkipListNode *next;
+    size_t level;
+
+    assert(node);
+
+    for (level = node->height; level-- > 0;) {
+        next = load(&node->next[level]);
+        while (!is_marked(next)) {
+            if (compare_and_swap(&node->next[level], next, marked(next))) {
+                if (level == 0) {
+                    return 1;
+                }
+                break;
+            }
+            next = load(&node->next[level]);
+        }
+    }
+
+    return 0;
+}
+
+/* ========================================================================================================
+ *
+ *                                        EXTERN FUNCTION DEFINITIONS
+ *
+ * ======================================================================================================== */
+
+void skiplist_init(
+    SkipList *list,
+    int (*compare)(const void *key, const SkipListNode *node),
+    void (*collide)(const SkipListNode *old_node, const SkipListNode *new_node, void *auxiliary_data),
+    void *auxiliary_data
+) {
+    size_t level;
+
+    assert(list && compare);
+
+    list->compare = compare;
+    list->collide = collide;
+    list->auxiliary_data = auxiliary_data;
+    for (level = 0; level < SKIPLIST_MAX_HEIGHT; ++level) {
+        list->head.next[level] = NULL;
+    }
+    list->head.height = SKIPLIST_MAX_HEIGHT;
+    list->size = 0;
+}
+
+SkipListNode* skiplist_first(const SkipList *list) {
+    assert(list);
+
+    return skip_removed(unmarked(load(&list->head.next[0])));
+}
+
+SkipListNode* skiplist_next(const SkipListNode *node) {
+    assert(node);
+
+    return skip_removed(unmarked(load(&node->next[0])));
+}
+
+size_t skiplist_size(const SkipList *list) {
+    assert(list);
+
+    return __atomic_load_n(&list->size, __ATOMIC_RELAXED);
+}
+
+int skiplist_empty(const SkipList *list) {
+    assert(list);
+
+    return skiplist_first(list) == NULL;
+}
+
+int skiplist_contains_key(const SkipList *list, const void *key) {
+    assert(list);
+
+    return skiplist_lookup_key(list, key) != NULL;
+}
+
+void skiplist_insert(SkipList *list, const void *key, SkipListNode *node) {
+    SkipListNode *preds[SKIPLIST_MAX_HEIGHT], *succs[SKIPLIST_MAX_HEIGHT], *next, *old;
+    size_t height, level;
+
+    assert(list && node);
+
+    height = node_height(node);
+    node->height = height;
+
+    /* Linking the bottom level inserts the node, in front of the nodes with the same key. */
+    do {
+        find(list, key, NULL, preds, succs);
+        for (level = 0; level < height; ++level) {
+            __atomic_store_n(&node->next[level], succs[level], __ATOMIC_RELAXED);
+        }
+    } while (!compare_and_swap(&preds[0]->next[0], succs[0], node));
+    __atomic_add_fetch(&list->size, 1, __ATOMIC_RELAXED);
+
+    /*
+     * Replaces the nodes with the same key behind the node, whose links can still be followed once marked.
+     * This comes before linking the upper levels, so that no level ever orders the node after them.
+     */
+    for (old = unmarked(load(&node->next[0])); old && list->compare(key, old) == 0; old = unmarked(next)) {
+        if (mark(old)) {
+            find(list, key, old, preds, succs);
+            __atomic_sub_fetch(&list->size, 1, __ATOMIC_RELAXED);
+            if (list->collide) {
+                list->collide(old, node, list->auxiliary_data);
+            }
+        }
+        next = load(&old->next[0]);
+    }
+
+    level = 1;
+    while (level < height && link_level(list, key, node, level)) {
+        ++level;
+    }
+
+    /* A remover that finished before a level was linked left the node reachable there. */
+    if (is_marked(load(&node->next[0]))) {
+        find(list, key, node, preds, succs);
+    }
+}
+
+SkipListNode* skiplist_lookup_key(const SkipList *list, const void *key) {
+    SkipListNode *node;
+    int found;
+
+    assert(list);
+
+    node = search(list, key, &found);
+
+    return found ? node : NULL;
+}
+
+SkipListNode* skiplist_lower_bound(const SkipList *list, const void *key) {
+    int found;
+
+    assert(list);
+
+    return search(list, key, &found);
+}
+
+int skiplist_remove(SkipList *list, const void *key, SkipListNode *node) {
+    SkipListNode *preds[SKIPLIST_MAX_HEIGHT], *succs[SKIPLIST_MAX_HEIGHT];
+    int removed;
+
+    assert(list && node);
+
+    /* Every remover unlinks the node, so that it is unreachable when any of them returns. */
+    removed = mark(node);
+    find(list, key, node, preds, succs);
+    if (removed) {
+        __atomic_sub_fetch(&list->size, 1, __ATOMIC_RELAXED);
+    }
+
+    return removed;
+}
+
+SkipListNode* skiplist_remove_key(SkipList *list, const void *key) {
+    SkipListNode *node;
+
+    assert(list);
+
+    while ((node = skiplist_lookup_key(list, key))) {
+        if (skiplist_remove(list, key, node)) {
+            return node;
+        }
+    }
+
+    return NULL;
+}
@@ -0,0 +1,450 @@
+/*
+Copyright (c) 2017, Michael J Welsh
+
+Permission to use, copy, modify, and/or distribute this software
+for any purpose with or without fee is hereby granted, provided
+that the above copyright notice and this permission notice appear
+in all copies.
+
+THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL
+WARRANTIES WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE
+AUTHOR BE LIABLE FOR ANY SPECIAL, DIRECT, INDIRECT, OR
+CONSEQUENTIAL DAMAGES OR ANY DAMAGES WHATSOEVER RESULTING FROM
+LOSS OF USE, DATA OR PROFITS, WHETHER IN AN ACTION OF CONTRACT,
+NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF OR IN
+CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+
+/**
+ * @file    skiplist.h
+ * @brief   LOCK-FREE SKIP LIST
+ *
+ * An ordered map that any number of threads can insert into, remove from, look up and iterate over at the
+ * same time, without locks. Each @ref SkipListNode is linked into the bottom level, which holds every
+ * @ref SkipListNode in key order, and into up to @ref SKIPLIST_MAX_HEIGHT - 1 express levels above it, each
+ * holding about a quarter of the @ref SkipListNode's of the level below. Links are updated with atomic
+ * compare-and-swap. A @ref SkipListNode is removed by first marking its links, after which no thread links
+ * anything after it, and then unlinking it from every level.
+ *
+ * Embed one or more @ref SkipListNode's into your struct to make it a potential node in one or more skip
+ * lists. A @ref SkipList MUST be initialized before it is used. A @ref SkipListNode does NOT need to be
+ * initialized before it is used. A @ref SkipListNode should belong to at most ONE @ref SkipList. The compare
+ * and collide functions have the same contract as those of a @ref RBTree, except that they may be called
+ * from several threads at once. When a @ref SkipListNode is inserted with an already existing key, the new
+ * @ref SkipListNode is linked in front of the old one, which is then removed and passed to collide.
+ *
+ * Other threads may still be reading a removed @ref SkipListNode, or standing on it while iterating. A
+ * removed @ref SkipListNode must therefore NOT be reused or freed until every skip list operation and
+ * iteration that was running when it was removed has finished (e.g. with epochs, or by only freeing objects
+ * when the program reaches a quiescent state). Iteration sees each @ref SkipListNode that stays in the
+ * @ref SkipList during the whole iteration, in key order, but is NOT a snapshot: @ref SkipListNode's
+ * inserted or removed meanwhile may or may not be seen. The size is exact once no update is in progress.
+ *
+ * Example:
+ *          struct Object {
+ *              int key;
+ *              int val;
+ *              SkipListNode n;
+ *          };
+ *
+ *          SkipList list;
+ *
+ *          int compare(const void *key, const SkipListNode *node) {
+ *              return *(const int*)key - skiplist_entry(node, struct Object, n)->key;
+ *          }
+ *
+ *          void* worker(void *arg) {
+ *              struct Object *objs = (struct Object*)arg;
+ *              int i;
+ *
+ *              for (i = 0; i < 1000; ++i) {
+ *                  skiplist_insert(&list, &objs[i].key, &objs[i].n);
+ *              }
+ *              return NULL;
+ *          }
+ *
+ *          int main(void) {
+ *              struct Object objs[4][1000];
+ *              pthread_t threads[4];
+ *              SkipListNode *node;
+ *              int i, j;
+ *
+ *              skiplist_init(&list, compare, NULL, NULL);
+ *              for (i = 0; i < 4; ++i) {
+ *                  for (j = 0; j < 1000; ++j) {
+ *                      objs[i][j].key = i * 1000 + j;
+ *                  }
+ *                  pthread_create(&threads[i], NULL, worker, objs[i]);
+ *              }
+ *              for (i = 0; i < 4; ++i) {
+ *                  pthread_join(threads[i], NULL);
+ *              }
+ *
+ *              i = 1500;
+ *              node = skiplist_lower_bound(&list, &i);
+ *              skiplist_for_each_from(node) {
+ *                  assert(skiplist_entry(node, struct Object, n)->key == i++);
+ *              }
+ *              return 0;
+ *          }
+ *
+ * Dependencies:
+ *      -   C89 assert.h
+ *      -   C89 stddef.h
+ *      -   GCC/Clang __atomic builtins
+ *
+ * API:
+ *      ====  TYPES  ====
+ *      -   typedef struct SkipList SkipList
+ *      -   typedef struct SkipListNode SkipListNode
+ *
+ *      ====  FUNCTIONS  ====
+ *      Initializers:
+ *          -   skiplist_init
+ *      Properties:
+ *          -   skiplist_first
+ *          -   skiplist_next
+ *          -   skiplist_size
+ *          -   skiplist_empty
+ *          -   skiplist_contains_key
+ *      Insertion:
+ *          -   skiplist_insert
+ *      Lookup:
+ *          -   skiplist_lookup_key
+ *          -   skiplist_lower_bound
+ *      Removal:
+ *          -   skiplist_remove
+ *          -   skiplist_remove_key
+ *
+ *      ====  MACROS  ====
+ *      Constants:
+ *          -   SKIPLIST_MAX_HEIGHT
+ *      Properties:
+ *          -   skiplist_entry
+ *      Traversal:
+ *          -   skiplist_for_each
+ *          -   skiplist_for_each_from
+ */
+
+#ifndef SKIPLIST_H
+#define SKIPLIST_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif /* __cplusplus */
+
+#include <stddef.h>
+
+/* ========================================================================================================
+ *
+ *                                                CONSTANTS
+ *
+ * ======================================================================================================== */
+
+/**
+ * The number of levels of a @ref SkipList, and of links in a @ref SkipListNode. Lookups stay O(log(n)) up to
+ * about 4^@ref SKIPLIST_MAX_HEIGHT @ref SkipListNode's. Can be overridden by defining it, the same way for
+ * skiplist.c and every file including skiplist.h.
+ */
+#ifndef SKIPLIST_MAX_HEIGHT
+    #define SKIPLIST_MAX_HEIGHT 16
+#endif
+
+/* ========================================================================================================
+ *
+ *                                                  TYPES
+ *
+ * ======================================================================================================== */
+
+/* Struct type declarations. */
+struct SkipList;
+struct SkipListNode;
+
+/* Struct typedef's. */
+typedef struct SkipList SkipList;
+typedef struct SkipListNode SkipListNode;
+
+/**
+ * Represents a node in a @ref SkipList. Embed this into your structure to make it a node. "next[i]" links to
+ * the next @ref SkipListNode at level i, with its lowest bit set once the @ref SkipListNode is being removed.
+ * Only the first "height" links are used.
+ */
+struct SkipListNode {
+    SkipListNode *next[SKIPLIST_MAX_HEIGHT];
+    size_t height;
+};
+
+/**
+ * Represents a lock-free skip list. The "head" member links to the first @ref SkipListNode of every level.
+ */
+struct SkipList {
+    int (*compare)(const void *key, const SkipListNode *node);
+    void (*collide)(const SkipListNode *old_node, const SkipListNode *new_node, void *auxiliary_data);
+    void *auxiliary_data;
+    SkipListNode head;
+    size_t size;
+};
+
+/* ========================================================================================================
+ *
+ *                                               PROTOTYPES
+ *
+ * ======================================================================================================== */
+
+/**
+ * Initializes/resets the @ref list. This is NOT thread-safe.
+ *
+ * Requirements:
+ *      -   @ref list != NULL
+ *      -   @ref compare != NULL
+ *      -   No other thread is using the @ref list.
+ *
+ * Time complexity:
+ *      -   O(1)
+ *
+ * @param list                  The @ref SkipList to be initialized/reset.
+ * @param compare               The callback function used to compare a key with the key of a
+ *                              @ref SkipListNode.
+ * @param collide               The OPTIONAL (i.e. can be NULL) callback function used to handle key
+ *                              collisions. If non-NULL, @ref collide will be called after the old
+ *                              @ref SkipListNode is replaced by the new @ref SkipListNode, by the thread that
+ *                              removed the old @ref SkipListNode.
+ * @param auxiliary_data        The auxiliary data passed to the OPTIONAL @ref collide callback function if
+ *                              the @ref collide callback function is non-NULL. This data is NEVER manipulated
+ *                              by the @ref list.
+ */
+void skiplist_init(
+    SkipList *list,
+    int (*compare)(const void *key, const SkipListNode *node),
+    void (*collide)(const SkipListNode *old_node, const SkipListNode *new_node, void *auxiliary_data),
+    void *auxiliary_data
+);
+
+/**
+ * Returns the first @ref SkipListNode of the @ref list.
+ *
+ * Requirements:
+ *      -   @ref list != NULL
+ *
+ * Time complexity:
+ *      -   O(1), plus the @ref SkipListNode's being removed that are skipped
+ *
+ * @param list                  The @ref SkipList to be operated on.
+ * @return                      The first @ref SkipListNode, or NULL if the @ref list is empty.
+ */
+SkipListNode* skiplist_first(const SkipList *list);
+
+/**
+ * Returns the @ref SkipListNode after the @ref node. The @ref node may have been removed meanwhile, as long
+ * as it has not been reused.
+ *
+ * Requirements:
+ *      -   @ref node != NULL
+ *
+ * Time complexity:
+ *      -   O(1), plus the @ref SkipListNode's being removed that are skipped
+ *
+ * @param node                  The @ref SkipListNode to be operated on.
+ * @return                      The next @ref SkipListNode, or NULL after the last one.
+ */
+SkipListNode* skiplist_next(const SkipListNode *node);
+
+/**
+ * Returns the number of @ref SkipListNode's in the @ref list.
+ *
+ * Requirements:
+ *      -   @ref list != NULL
+ *
+ * Time complexity:
+ *      -   O(1)
+ *
+ * @param list                  The @ref SkipList to be operated on.
+ * @return                      The number of @ref SkipListNode's, counting the updates that completed.
+ */
+size_t skiplist_size(const SkipList *list);
+
+/**
+ * Determines if the @ref list is empty.
+ *
+ * Requirements:
+ *      -   @ref list != NULL
+ *
+ * Time complexity:
+ *      -   O(1), plus the @ref SkipListNode's being removed that are skipped
+ *
+ * @param list                  The @ref SkipList to be operated on.
+ * @return                      1 if the @ref list is empty, otherwise 0.
+ */
+int skiplist_empty(const SkipList *list);
+
+/**
+ * Determines if the @ref list contains the @ref key.
+ *
+ * Requirements:
+ *      -   @ref list != NULL
+ *
+ * Time complexity:
+ *      -   O(log(n)) on average
+ *
+ * @param list                  The @ref SkipList to be operated on.
+ * @param key                   The key used for lookup.
+ * @return                      1 if the @ref list contains the @ref key, otherwise 0.
+ */
+int skiplist_contains_key(const SkipList *list, const void *key);
+
+/**
+ * Inserts the @ref node with associated @ref key into the @ref list. If a @ref SkipListNode already exists
+ * with the same @ref key, the already existing @ref SkipListNode will be replaced by the new
+ * @ref SkipListNode, and then the @ref list->collide function will be called (if non-NULL).
+ *
+ * Requirements:
+ *      -   @ref list != NULL
+ *      -   @ref node != NULL
+ *      -   The @ref node is not in a @ref SkipList, and is not being read by another thread.
+ *
+ * Time complexity:
+ *      -   O(log(n)) on average, without contention
+ *
+ * @param list                  The @ref SkipList to be operated on.
+ * @param key                   The key associated with the @ref node.
+ * @param node                  The @ref SkipListNode to be inserted.
+ */
+void skiplist_insert(SkipList *list, const void *key, SkipListNode *node);
+
+/**
+ * Returns the @ref SkipListNode associated with the @ref key in the @ref list. NULL if a match for the
+ * @ref key is not found.
+ *
+ * Requirements:
+ *      -   @ref list != NULL
+ *
+ * Time complexity:
+ *      -   O(log(n)) on average
+ *
+ * @param list                  The @ref SkipList to be operated on.
+ * @param key                   The key used for lookup.
+ * @return                      The @ref SkipListNode associated with the @ref key, or NULL.
+ */
+SkipListNode* skiplist_lookup_key(const SkipList *list, const void *key);
+
+/**
+ * Returns the first @ref SkipListNode of the @ref list whose key is not less than the @ref key, e.g. to
+ * start a range scan with @ref skiplist_for_each_from.
+ *
+ * Requirements:
+ *      -   @ref list != NULL
+ *
+ * Time complexity:
+ *      -   O(log(n)) on average
+ *
+ * @param list                  The @ref SkipList to be operated on.
+ * @param key                   The lower bound.
+ * @return                      The first @ref SkipListNode not less than the @ref key, or NULL.
+ */
+SkipListNode* skiplist_lower_bound(const SkipList *list, const void *key);
+
+/**
+ * Removes the @ref node from the @ref list. If several threads remove the same @ref node at once, only one
+ * of them succeeds. Once this returns, the @ref node can no longer be reached from the @ref list, but
+ * threads that were already reading it may still do so.
+ *
+ * Requirements:
+ *      -   @ref list != NULL
+ *      -   @ref node != NULL
+ *      -   The @ref node was inserted into the @ref list, and has not been reused since.
+ *      -   @ref key is the key associated with the @ref node.
+ *
+ * Time complexity:
+ *      -   O(log(n)) on average, without contention
+ *
+ * @param list                  The @ref SkipList to be operated on.
+ * @param key                   The key associated with the @ref node.
+ * @param node                  The @ref SkipListNode to be removed.
+ * @return                      1 if this call removed the @ref node, 0 if it had already been removed.
+ */
+int skiplist_remove(SkipList *list, const void *key, SkipListNode *node);
+
+/**
+ * Removes the @ref SkipListNode associated with the @ref key from the @ref list, if there is one.
+ *
+ * Requirements:
+ *      -   @ref list != NULL
+ *
+ * Time complexity:
+ *      -   O(log(n)) on average, without contention
+ *
+ * @param list                  The @ref SkipList to be operated on.
+ * @param key                   The key used for lookup.
+ * @return                      The @ref SkipListNode this call removed, or NULL if there was none.
+ */
+SkipListNode* skiplist_remove_key(SkipList *list, const void *key);
+
+/* ========================================================================================================
+ *
+ *                                                 MACROS
+ *
+ * ======================================================================================================== */
+
+/**
+ * Obtains the pointer to the struct for this entry.
+ *
+ * Requirements:
+ *      -   @ref node_ptr != NULL
+ *
+ * @param node_ptr              The pointer to the @ref SkipListNode in the struct.
+ * @param type                  The type of the struct the @ref SkipListNode is embedded in.
+ * @param member                The name of the @ref SkipListNode in the struct.
+ */
+#if defined(__GNUC__) && !defined(__STRICT_ANSI__)
+    #define skiplist_entry(node_ptr, type, member) \
+        ({ \
+            const typeof(((type*)0)->member) *__mptr = (node_ptr); \
+            (type*) ((char*)__mptr - offsetof(type, member)); \
+        })
+#else
+    #define skiplist_entry(node_ptr, type, member) \
+        ( \
+            (type*) ((char*)(node_ptr) - offsetof(type, member)) \
+        )
+#endif
+
+/**
+ * Iterates over the @ref SkipList in key order, from the first @ref SkipListNode to the last
+ * @ref SkipListNode. The @ref cursor_node_ptr may be removed in the loop's body, but NOT reused.
+ *
+ * Requirements:
+ *      -   @ref list_ptr != NULL
+ *      -   The @ref cursor_node_ptr is not reassigned in the loop's body.
+ *
+ * @param cursor_node_ptr       The @ref SkipListNode to use as a loop cursor.
+ * @param list_ptr              The pointer to a @ref SkipList that will be iterated over.
+ */
+#define skiplist_for_each(cursor_node_ptr, list_ptr) \
+    for ( \
+        cursor_node_ptr = skiplist_first(list_ptr); \
+        cursor_node_ptr; \
+        cursor_node_ptr = skiplist_next(cursor_node_ptr) \
+    )
+
+/**
+ * Continues iterating over the @ref SkipList in key order, continuing FROM the current position. The
+ * @ref cursor_node_ptr may be removed in the loop's body, but NOT reused.
+ *
+ * Requirements:
+ *      -   The @ref cursor_node_ptr is not reassigned in the loop's body.
+ *
+ * @param cursor_node_ptr       The @ref SkipListNode to use as a loop cursor.
+ */
+#define skiplist_for_each_from(cursor_node_ptr) \
+    for ( \
+        ; \
+        cursor_node_ptr; \
+        cursor_node_ptr = skiplist_next(cursor_node_ptr) \
+    )
+
+#ifdef __cplusplus
+}
+#endif /* __cplusplus */
+
+#endif /* SKIPLIST_H */
@@ -77,6 +77,7 @@ CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
  *          -   stack_entry
  *      Traversal:
  *          -   stack_for_each
+ *          -   stack_for_each_prefetch
  *          -   stack_for_each_safe
  */
 
@@ -282,6 +283,31 @@ void stack_remove_all(Stack *stack);
         cursor_node_ptr = cursor_node_ptr->prev \
     )
 
+/**
+ * Iterates over the @ref Stack from top to bottom, and prefetches the next @ref StackNode while the loop's
+ * body runs, so that the body overlaps with the cache miss of the next step. Without GNU extensions, this is
+ * simply @ref stack_for_each.
+ *
+ * Requirements:
+ *      -   @ref stack_ptr != NULL
+ *      -   The @ref cursor_node_ptr is neither reassigned nor removed from its associated @ref Stack in the
+ *          loop's body.
+ *
+ * @param cursor_node_ptr       The @ref StackNode to use as a loop cursor.
+ * @param stack_ptr             The pointer to a @ref Stack that will be iterated over.
+ */
+#if defined(__GNUC__) && !defined(__STRICT_ANSI__)
+    #define stack_for_each_prefetch(cursor_node_ptr, stack_ptr) \
+        for ( \
+            cursor_node_ptr = (stack_ptr)->tail; \
+            cursor_node_ptr && (__builtin_prefetch(cursor_node_ptr->prev), 1); \
+            cursor_node_ptr = cursor_node_ptr->prev \
+        )
+#else
+    #define stack_for_each_prefetch(cursor_node_ptr, stack_ptr) \
+        stack_for_each(cursor_node_ptr, stack_ptr)
+#endif
+
 /**
  * Iterates over the @ref Stack from top to bottom, and is safe against reassignment and/or removal of the
  * @ref cursor_node_ptr.
@@ -0,0 +1,226 @@
+/*
+Copyright (c) 2017, Michael J Welsh
+
+Permission to use, copy, modify, and/or distribute this software
+for any purpose with or without fee is hereby granted, provided
+that the above copyright notice and this permission notice appear
+in all copies.
+
+THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL
+WARRANTIES WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE
+AUTHOR BE LIABLE FOR ANY SPECIAL, DIRECT, INDIRECT, OR
+CONSEQUENTIAL DAMAGES OR ANY DAMAGES WHATSOEVER RESULTING FROM
+LOSS OF USE, DATA OR PROFITS, WHETHER IN AN ACTION OF CONTRACT,
+NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF OR IN
+CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+
+#include <assert.h>
+#include <stddef.h>
+
+#include "static_index.h"
+
+/* ========================================================================================================
+ *
+ *                                        STATIC FUNCTION PROTOTYPES
+ *
+ * ======================================================================================================== */
+
+/*
+ * Returns the leftmost slot of the subtree rooted at the @ref slot, in a tree of @ref size slots.
+ */
+static size_t leftmost(size_t slot, size_t size);
+
+/*
+ * Returns the rightmost slot of the subtree rooted at the @ref slot, in a tree of @ref size slots.
+ */
+static size_t rightmost(size_t slot, size_t size);
+
+/* ========================================================================================================
+ *
+ *                                        STATIC FUNCTION DEFINITIONS
+ *
+ * ======================================================================================================== */
+
+static size_t leftmost(size_t slot, size_t size) {
+    while (2 * slot <= size) {
+        slot = 2 * slot;
+    }
+
+    return slot;
+}
+
+static size_t rightmost(size_t slot, size_t size) {
+    while (2 * slot + 1 <= size) {
+        slot = 2 * slot + 1;
+    }
+
+    return slot;
+}
+
+/* ========================================================================================================
+ *
+ *                                        EXTERN FUNCTION DEFINITIONS
+ *
+ * ======================================================================================================== */
+
+void static_index_init(StaticIndex *index, StaticIndexKey *key_array, void **value_array, size_t size) {
+    assert(index && key_array && value_array);
+
+    index->keys = key_array;
+    index->values = value_array;
+    index->size = size;
+    index->cursor = size ? leftmost(1, size) : 0;
+}
+
+void static_index_append(StaticIndex *index, StaticIndexKey key, void *value) {
+    size_t prev;
+
+    assert(index && index->cursor);
+
+    prev = static_index_prev(index, index->cursor);
+    assert(!prev || !(key < index->keys[prev]));
+    (void) prev;
+
+    index->keys[index->cursor] = key;
+    index->values[index->cursor] = value;
+    index->cursor = static_index_next(index, index->cursor);
+}
+
+void static_index_append_array(
+    StaticIndex *index,
+    const StaticIndexKey *keys,
+    void *const *values,
+    size_t num_keys
+) {
+    size_t i;
+
+    assert(index && ((keys && values) || num_keys == 0));
+
+    for (i = 0; i < num_keys; ++i) {
+        static_index_append(index, keys[i], values[i]);
+    }
+}
+
+size_t static_index_first(const StaticIndex *index) {
+    assert(index);
+
+    return index->size ? leftmost(1, index->size) : 0;
+}
+
+size_t static_index_last(const StaticIndex *index) {
+    assert(index);
+
+    return index->size ? rightmost(1, index->size) : 0;
+}
+
+size_t static_index_prev(const StaticIndex *index, size_t slot) {
+    assert(index && slot && slot <= index->size);
+
+    if (2 * slot <= index->size) {
+        return rightmost(2 * slot, index->size);
+    }
+
+    /* Climbs while coming from a left child, then once more. */
+    while (slot % 2 == 0) {
+        slot /= 2;
+    }
+
+    return slot / 2;
+}
+
+size_t static_index_next(const StaticIndex *index, size_t slot) {
+    assert(index && slot && slot <= index->size);
+
+    if (2 * slot + 1 <= index->size) {
+        return leftmost(2 * slot + 1, index->size);
+    }
+
+    /* Climbs while coming from a right child, then once more. */
+    while (slot % 2 == 1) {
+        slot /= 2;
+    }
+
+    return slot / 2;
+}
+
+StaticIndexKey static_index_key(const StaticIndex *index, size_t slot) {
+    assert(index && slot && slot <= index->size);
+
+    return index->keys[slot];
+}
+
+void* static_index_value(const StaticIndex *index, size_t slot) {
+    assert(index && slot && slot <= index->size);
+
+    return index->values[slot];
+}
+
+size_t static_index_size(const StaticIndex *index) {
+    assert(index);
+
+    return index->size;
+}
+
+int static_index_contains_key(const StaticIndex *index, StaticIndexKey key) {
+    size_t slot;
+
+    assert(index);
+
+    slot = static_index_lower_bound(index, key);
+
+    return slot && index->keys[slot] == key;
+}
+
+void* static_index_lookup_key(const StaticIndex *index, StaticIndexKey key) {
+    size_t slot;
+
+    assert(index);
+
+    slot = static_index_lower_bound(index, key);
+
+    return slot && index->keys[slot] == key ? index->values[slot] : NULL;
+}
+
+size_t static_index_lower_bound(const StaticIndex *index, StaticIndexKey key) {
+    const StaticIndexKey *keys;
+    size_t size, slot;
+
+    assert(index && !index->cursor);
+
+    keys = index->keys;
+    size = index->size;
+
+    /*
+     * Goes right when the key in the slot is less than the @ref key, and left otherwise, down to a slot past
+     * the bottom. The prefetched slot is clamped to slot 0 so that it never points past the array.
+     */
+    for (slot = 1; slot <= size; ) {
+#if defined(__GNUC__) && !defined(__STRICT_ANSI__)
+        size_t ahead = slot << STATIC_INDEX_PREFETCH_DISTANCE;
+
+        __builtin_prefetch(keys + (ahead <= size ? ahead : 0));
+#endif
+        slot = 2 * slot + (keys[slot] < key);
+    }
+
+    /*
+     * The answer is the last slot where the search went left: strips the right turns taken after it, then
+     * the left turn itself. The count of trailing ones uses the long long builtin where size_t is wider than
+     * unsigned long (e.g. 64-bit Windows), so that the slot is never truncated.
+     */
+#if defined(__GNUC__) && !defined(__STRICT_ANSI__)
+    if (sizeof(size_t) > sizeof(unsigned long)) {
+        return slot >> (__builtin_ctzll(~(unsigned long long) slot) + 1);
+    }
+
+    return slot >> (__builtin_ctzl(~(unsigned long) slot) + 1);
+#else
+    while (slot % 2 == 1) {
+        slot /= 2;
+    }
+
+    return slot / 2;
+#endif
+}
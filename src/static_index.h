@@ -0,0 +1,434 @@
+/*
+Copyright (c) 2017, Michael J Welsh
+
+Permission to use, copy, modify, and/or distribute this software
+for any purpose with or without fee is hereby granted, provided
+that the above copyright notice and this permission notice appear
+in all copies.
+
+THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL
+WARRANTIES WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE
+AUTHOR BE LIABLE FOR ANY SPECIAL, DIRECT, INDIRECT, OR
+CONSEQUENTIAL DAMAGES OR ANY DAMAGES WHATSOEVER RESULTING FROM
+LOSS OF USE, DATA OR PROFITS, WHETHER IN AN ACTION OF CONTRACT,
+NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF OR IN
+CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+
+/**
+ * @file    static_index.h
+ * @brief   STATIC SEARCH INDEX
+ *
+ * A sorted set of keys, each associated with a value, that is built once and then only searched. The keys
+ * are stored in Eytzinger order: the implicit binary search tree whose root is in slot 1, and whose node in
+ * slot k has its children in slots 2k and 2k + 1 (slot 0 is unused). A search touches one key per level, as
+ * in a balanced binary search tree, but the first levels share a few cache lines, the keys of the next
+ * levels are prefetched ahead of the search, and each step is a branchless comparison. A lookup thus waits
+ * on far fewer cache misses than in a @ref RBTree, whose nodes are scattered in memory. The values are kept
+ * in a separate array, and only the one found is read.
+ *
+ * A @ref StaticIndex does NOT allocate memory: it is given an array of n + 1 keys and an array of n + 1
+ * values, where n is its final size, and is then filled by appending the keys in ascending order (e.g. with
+ * @ref rbtree_for_each, or from a sorted array). Aligning the key array to 64 bytes keeps the keys of each
+ * group of levels within as few cache lines as possible. Once the last key is appended, any number of
+ * threads can search the @ref StaticIndex at the same time. Positions in the @ref StaticIndex are slots,
+ * where slot 0 means no position.
+ *
+ * The key type is @ref STATIC_INDEX_KEY_TYPE, which can be overridden by defining it (the same way for
+ * static_index.c and every file including static_index.h) with any type that can be compared with < and ==.
+ *
+ * Example:
+ *          struct Object {
+ *              size_t key;
+ *              int val;
+ *              RBTreeNode n;
+ *          };
+ *
+ *          int main(void) {
+ *              StaticIndexKey keys[1001];
+ *              void *values[1001];
+ *              StaticIndex index;
+ *              RBTree rbtree;
+ *              RBTreeNode *node;
+ *              size_t slot;
+ *
+ *              ... fill the rbtree with 1000 struct Object's ...
+ *
+ *              static_index_init(&index, keys, values, rbtree_size(&rbtree));
+ *              rbtree_for_each(node, &rbtree) {
+ *                  static_index_append(&index, rbtree_entry(node, struct Object, n)->key, node);
+ *              }
+ *
+ *              slot = static_index_lower_bound(&index, 500);
+ *              static_index_for_each_from(slot, &index) {
+ *                  node = (RBTreeNode*) static_index_value(&index, slot);
+ *              }
+ *              return 0;
+ *          }
+ *
+ * Dependencies:
+ *      -   C89 assert.h
+ *      -   C89 stddef.h
+ *
+ * API:
+ *      ====  TYPES  ====
+ *      -   typedef STATIC_INDEX_KEY_TYPE StaticIndexKey
+ *      -   typedef struct StaticIndex StaticIndex
+ *
+ *      ====  FUNCTIONS  ====
+ *      Initializers:
+ *          -   static_index_init
+ *      Construction:
+ *          -   static_index_append
+ *          -   static_index_append_array
+ *      Properties:
+ *          -   static_index_first
+ *          -   static_index_last
+ *          -   static_index_prev
+ *          -   static_index_next
+ *          -   static_index_key
+ *          -   static_index_value
+ *          -   static_index_size
+ *          -   static_index_contains_key
+ *      Lookup:
+ *          -   static_index_lookup_key
+ *          -   static_index_lower_bound
+ *
+ *      ====  MACROS  ====
+ *      Constants:
+ *          -   STATIC_INDEX_KEY_TYPE
+ *          -   STATIC_INDEX_PREFETCH_DISTANCE
+ *      Traversal:
+ *          -   static_index_for_each
+ *          -   static_index_for_each_from
+ */
+
+#ifndef STATIC_INDEX_H
+#define STATIC_INDEX_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif /* __cplusplus */
+
+#include <stddef.h>
+
+/* ========================================================================================================
+ *
+ *                                                CONSTANTS
+ *
+ * ======================================================================================================== */
+
+/**
+ * The type of the keys of a @ref StaticIndex. Can be overridden by defining it, the same way for
+ * static_index.c and every file including static_index.h.
+ */
+#ifndef STATIC_INDEX_KEY_TYPE
+    #define STATIC_INDEX_KEY_TYPE size_t
+#endif
+
+/**
+ * How many levels below the current slot a search prefetches. The keys 4 levels down from slot k are the 16
+ * keys from slot 16k, i.e. two cache lines of 8-byte keys. Only used with GCC/Clang extensions. Can be
+ * overridden by defining it, the same way for static_index.c and every file including static_index.h.
+ */
+#ifndef STATIC_INDEX_PREFETCH_DISTANCE
+    #define STATIC_INDEX_PREFETCH_DISTANCE 4
+#endif
+
+/* ========================================================================================================
+ *
+ *                                                  TYPES
+ *
+ * ======================================================================================================== */
+
+/* Struct type declarations. */
+struct StaticIndex;
+
+/* Struct typedef's. */
+typedef STATIC_INDEX_KEY_TYPE StaticIndexKey;
+typedef struct StaticIndex StaticIndex;
+
+/**
+ * Represents a static search index. "keys[k]" and "values[k]" hold the key and the value in slot k. The
+ * "cursor" member is the slot the next appended key goes into, and is 0 once the @ref StaticIndex is full.
+ */
+struct StaticIndex {
+    StaticIndexKey *keys;
+    void **values;
+    size_t size;
+    size_t cursor;
+};
+
+/* ========================================================================================================
+ *
+ *                                               PROTOTYPES
+ *
+ * ======================================================================================================== */
+
+/**
+ * Initializes/resets the @ref index to hold @ref size keys, which must then all be appended before it is
+ * searched or traversed.
+ *
+ * Requirements:
+ *      -   @ref index != NULL
+ *      -   @ref key_array != NULL and @ref value_array != NULL, each of @ref size + 1 elements
+ *
+ * Time complexity:
+ *      -   O(log(n))
+ *
+ * @param index                 The @ref StaticIndex to be initialized.
+ * @param key_array             The array that will hold the keys. Its first element is never used.
+ * @param value_array           The array that will hold the values. Its first element is never used.
+ * @param size                  The number of keys that will be appended.
+ */
+void static_index_init(StaticIndex *index, StaticIndexKey *key_array, void **value_array, size_t size);
+
+/**
+ * Appends the @ref key, associated with the @ref value, to the @ref index. Keys must be appended in
+ * ascending order; equal keys are allowed, and are found in the order they were appended.
+ *
+ * Requirements:
+ *      -   @ref index != NULL
+ *      -   Fewer than @ref index->size keys have been appended
+ *      -   @ref key is not less than the last appended key
+ *
+ * Time complexity:
+ *      -   Amortized O(1)
+ *
+ * @param index                 The @ref StaticIndex to be operated on.
+ * @param key                   The key to be appended.
+ * @param value                 The value associated with the @ref key. This data is NEVER manipulated by
+ *                              the @ref index.
+ */
+void static_index_append(StaticIndex *index, StaticIndexKey key, void *value);
+
+/**
+ * Appends the @ref num_keys sorted @ref keys, associated with the @ref values, to the @ref index, as if each
+ * one was appended with @ref static_index_append.
+ *
+ * Requirements:
+ *      -   @ref index != NULL
+ *      -   @ref keys != NULL and @ref values != NULL, or @ref num_keys == 0
+ *      -   At most @ref index->size keys are appended in total
+ *      -   The @ref keys are in ascending order, and not less than the last appended key
+ *
+ * Time complexity:
+ *      -   O(k)
+ *
+ * @param index                 The @ref StaticIndex to be operated on.
+ * @param keys                  The keys to be appended.
+ * @param values                The values associated with the @ref keys, values[i] with keys[i].
+ * @param num_keys              The number of @ref keys.
+ */
+void static_index_append_array(
+    StaticIndex *index,
+    const StaticIndexKey *keys,
+    void *const *values,
+    size_t num_keys
+);
+
+/**
+ * Returns the slot of the smallest key in the @ref index.
+ *
+ * Requirements:
+ *      -   @ref index != NULL
+ *
+ * Time complexity:
+ *      -   O(log(n))
+ *
+ * @param index                 The @ref StaticIndex to be operated on.
+ * @return                      The first slot, or 0 if the @ref index is empty.
+ */
+size_t static_index_first(const StaticIndex *index);
+
+/**
+ * Returns the slot of the largest key in the @ref index.
+ *
+ * Requirements:
+ *      -   @ref index != NULL
+ *
+ * Time complexity:
+ *      -   O(log(n))
+ *
+ * @param index                 The @ref StaticIndex to be operated on.
+ * @return                      The last slot, or 0 if the @ref index is empty.
+ */
+size_t static_index_last(const StaticIndex *index);
+
+/**
+ * Returns the slot before the @ref slot, in key order.
+ *
+ * Requirements:
+ *      -   @ref index != NULL
+ *      -   0 < @ref slot <= @ref index->size
+ *
+ * Time complexity:
+ *      -   Amortized O(1), worst case O(log(n))
+ *
+ * @param index                 The @ref StaticIndex to be operated on.
+ * @param slot                  The slot to start from.
+ * @return                      The previous slot, or 0 if the @ref slot is the first one.
+ */
+size_t static_index_prev(const StaticIndex *index, size_t slot);
+
+/**
+ * Returns the slot after the @ref slot, in key order.
+ *
+ * Requirements:
+ *      -   @ref index != NULL
+ *      -   0 < @ref slot <= @ref index->size
+ *
+ * Time complexity:
+ *      -   Amortized O(1), worst case O(log(n))
+ *
+ * @param index                 The @ref StaticIndex to be operated on.
+ * @param slot                  The slot to start from.
+ * @return                      The next slot, or 0 if the @ref slot is the last one.
+ */
+size_t static_index_next(const StaticIndex *index, size_t slot);
+
+/**
+ * Returns the key in the @ref slot.
+ *
+ * Requirements:
+ *      -   @ref index != NULL
+ *      -   0 < @ref slot <= @ref index->size
+ *
+ * Time complexity:
+ *      -   O(1)
+ *
+ * @param index                 The @ref StaticIndex to be operated on.
+ * @param slot                  The slot of the key.
+ * @return                      The key in the @ref slot.
+ */
+StaticIndexKey static_index_key(const StaticIndex *index, size_t slot);
+
+/**
+ * Returns the value associated with the key in the @ref slot.
+ *
+ * Requirements:
+ *      -   @ref index != NULL
+ *      -   0 < @ref slot <= @ref index->size
+ *
+ * Time complexity:
+ *      -   O(1)
+ *
+ * @param index                 The @ref StaticIndex to be operated on.
+ * @param slot                  The slot of the value.
+ * @return                      The value in the @ref slot.
+ */
+void* static_index_value(const StaticIndex *index, size_t slot);
+
+/**
+ * Returns the number of keys in the @ref index.
+ *
+ * Requirements:
+ *      -   @ref index != NULL
+ *
+ * Time complexity:
+ *      -   O(1)
+ *
+ * @param index                 The @ref StaticIndex to be operated on.
+ * @return                      The number of keys.
+ */
+size_t static_index_size(const StaticIndex *index);
+
+/**
+ * Determines if the @ref index contains the @ref key.
+ *
+ * Requirements:
+ *      -   @ref index != NULL
+ *      -   Every key has been appended
+ *
+ * Time complexity:
+ *      -   O(log(n))
+ *
+ * @param index                 The @ref StaticIndex to be operated on.
+ * @param key                   The key used for lookup.
+ * @return                      1 if the @ref index contains the @ref key, otherwise 0.
+ */
+int static_index_contains_key(const StaticIndex *index, StaticIndexKey key);
+
+/**
+ * Returns the value associated with the @ref key in the @ref index. If equal keys were appended, the value
+ * of the first one is returned.
+ *
+ * Requirements:
+ *      -   @ref index != NULL
+ *      -   Every key has been appended
+ *
+ * Time complexity:
+ *      -   O(log(n))
+ *
+ * @param index                 The @ref StaticIndex to be operated on.
+ * @param key                   The key used for lookup.
+ * @return                      NULL if a match for the @ref key is not found; otherwise, the value
+ *                              associated with the @ref key.
+ */
+void* static_index_lookup_key(const StaticIndex *index, StaticIndexKey key);
+
+/**
+ * Returns the slot of the first key in the @ref index that is not less than the @ref key. The search runs
+ * down every level of the @ref index without branching on the comparisons, so its time barely depends on
+ * the @ref key.
+ *
+ * Requirements:
+ *      -   @ref index != NULL
+ *      -   Every key has been appended
+ *
+ * Time complexity:
+ *      -   O(log(n))
+ *
+ * @param index                 The @ref StaticIndex to be operated on.
+ * @param key                   The key used for lookup.
+ * @return                      The slot of the first key not less than the @ref key, or 0 if every key is
+ *                              less than the @ref key.
+ */
+size_t static_index_lower_bound(const StaticIndex *index, StaticIndexKey key);
+
+/* ========================================================================================================
+ *
+ *                                                 MACROS
+ *
+ * ======================================================================================================== */
+
+/**
+ * Iterates over the @ref StaticIndex in key order, from the first slot to the last slot.
+ *
+ * Requirements:
+ *      -   @ref index_ptr != NULL
+ *      -   The @ref cursor_slot is not reassigned in the loop's body.
+ *
+ * @param cursor_slot           The size_t to use as a loop cursor.
+ * @param index_ptr             The pointer to a @ref StaticIndex that will be iterated over.
+ */
+#define static_index_for_each(cursor_slot, index_ptr) \
+    for ( \
+        cursor_slot = static_index_first(index_ptr); \
+        cursor_slot; \
+        cursor_slot = static_index_next(index_ptr, cursor_slot) \
+    )
+
+/**
+ * Continues iterating over the @ref StaticIndex in key order, continuing FROM the current slot.
+ *
+ * Requirements:
+ *      -   @ref index_ptr != NULL
+ *      -   The @ref cursor_slot is not reassigned in the loop's body.
+ *
+ * @param cursor_slot           The size_t to use as a loop cursor.
+ * @param index_ptr             The pointer to a @ref StaticIndex that will be iterated over.
+ */
+#define static_index_for_each_from(cursor_slot, index_ptr) \
+    for ( \
+        ; \
+        cursor_slot; \
+        cursor_slot = static_index_next(index_ptr, cursor_slot) \
+    )
+
+#ifdef __cplusplus
+}
+#endif /* __cplusplus */
+
+#endif /* STATIC_INDEX_H */
@@ -0,0 +1,177 @@
+/*
+Copyright (c) 2017, Michael J Welsh
+
+Permission to use, copy, modify, and/or distribute this software
+for any purpose with or without fee is hereby granted, provided
+that the above copyright notice and this permission notice appear
+in all copies.
+
+THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL
+WARRANTIES WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE
+AUTHOR BE LIABLE FOR ANY SPECIAL, DIRECT, INDIRECT, OR
+CONSEQUENTIAL DAMAGES OR ANY DAMAGES WHATSOEVER RESULTING FROM
+LOSS OF USE, DATA OR PROFITS, WHETHER IN AN ACTION OF CONTRACT,
+NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF OR IN
+CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+
+#include <assert.h>
+#include <stddef.h>
+
+#include "timer_wheel.h"
+
+/* ========================================================================================================
+ *
+ *                                        STATIC FUNCTION PROTOTYPES
+ *
+ * ======================================================================================================== */
+
+/*
+ * Appends the @ref node to the slot of its expiry tick, in the lowest level of the @ref wheel whose turn
+ * reaches it from the last tick processed. The @ref node must not expire before that tick.
+ */
+static void place(TimerWheel *wheel, TimerWheelNode *node);
+
+/* ========================================================================================================
+ *
+ *                                        STATIC FUNCTION DEFINITIONS
+ *
+ * ======================================================================================================== */
+
+static void place(TimerWheel *wheel, TimerWheelNode *node) {
+    unsigned long expires, delta, range;
+    size_t level;
+
+    assert(wheel && node && node->expires >= wheel->now);
+
+    expires = node->expires;
+    delta = expires - wheel->now;
+    range = 1ul << (TIMER_WHEEL_SLOT_BITS * TIMER_WHEEL_LEVELS);
+
+    /* Out of range, the last slot of the top level holds the node until it is cascaded and placed again. */
+    if (delta >= range) {
+        expires = wheel->now + range - 1;
+        delta = range - 1;
+    }
+
+    for (level = 0; delta >> (TIMER_WHEEL_SLOT_BITS * (level + 1)); ++level) {
+    }
+
+    node->list = &wheel->slots[level][(expires >> (TIMER_WHEEL_SLOT_BITS * level)) % TIMER_WHEEL_SLOTS];
+    list_insert_back(node->list, &node->node);
+}
+
+/* ========================================================================================================
+ *
+ *                                        EXTERN FUNCTION DEFINITIONS
+ *
+ * ======================================================================================================== */
+
+void timer_wheel_init(TimerWheel *wheel, unsigned long now) {
+    size_t level, i;
+
+    assert(wheel);
+
+    for (level = 0; level < TIMER_WHEEL_LEVELS; ++level) {
+        for (i = 0; i < TIMER_WHEEL_SLOTS; ++i) {
+            list_init(&wheel->slots[level][i]);
+        }
+    }
+
+    wheel->now = now;
+    wheel->size = 0;
+}
+
+unsigned long timer_wheel_now(const TimerWheel *wheel) {
+    assert(wheel);
+
+    return wheel->now;
+}
+
+size_t timer_wheel_size(const TimerWheel *wheel) {
+    assert(wheel);
+
+    return wheel->size;
+}
+
+int timer_wheel_empty(const TimerWheel *wheel) {
+    assert(wheel);
+
+    return wheel->size == 0;
+}
+
+int timer_wheel_armed(const TimerWheelNode *node) {
+    assert(node);
+
+    return node->list != NULL;
+}
+
+unsigned long timer_wheel_expires(const TimerWheelNode *node) {
+    assert(node);
+
+    return node->expires;
+}
+
+void timer_wheel_arm(TimerWheel *wheel, TimerWheelNode *node, unsigned long expires) {
+    assert(wheel && node);
+
+    node->expires = expires > wheel->now ? expires : wheel->now + 1;
+    place(wheel, node);
+    ++wheel->size;
+}
+
+void timer_wheel_cancel(TimerWheel *wheel, TimerWheelNode *node) {
+    assert(wheel && node && node->list);
+
+    list_remove(node->list, &node->node);
+    node->list = NULL;
+    --wheel->size;
+}
+
+void timer_wheel_tick(TimerWheel *wheel, List *expired) {
+    List cascaded, *slot;
+    ListNode *n;
+    size_t level;
+
+    assert(wheel && expired);
+
+    ++wheel->now;
+
+    /*
+     * Each level whose turn the tick completes cascades its next slot into the levels below. Those are
+     * lower than the slots being cascaded, which therefore never get a timer back.
+     */
+    list_init(&cascaded);
+    for (level = 1; level < TIMER_WHEEL_LEVELS; ++level) {
+        if ((wheel->now >> (TIMER_WHEEL_SLOT_BITS * (level - 1))) % TIMER_WHEEL_SLOTS) {
+            break;
+        }
+
+        slot = &wheel->slots[level][(wheel->now >> (TIMER_WHEEL_SLOT_BITS * level)) % TIMER_WHEEL_SLOTS];
+        list_splice_back(&cascaded, slot);
+        while ((n = list_front(&cascaded))) {
+            list_remove_front(&cascaded);
+            place(wheel, list_entry(n, TimerWheelNode, node));
+        }
+    }
+
+    slot = &wheel->slots[0][wheel->now % TIMER_WHEEL_SLOTS];
+    list_for_each(n, slot) {
+        list_entry(n, TimerWheelNode, node)->list = NULL;
+    }
+    wheel->size -= list_size(slot);
+    list_splice_back(expired, slot);
+}
+
+void timer_wheel_advance(TimerWheel *wheel, unsigned long now, List *expired) {
+    assert(wheel && expired && now >= wheel->now);
+
+    while (wheel->now != now) {
+        if (wheel->size == 0) {
+            wheel->now = now;
+            break;
+        }
+        timer_wheel_tick(wheel, expired);
+    }
+}
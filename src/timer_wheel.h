@@ -0,0 +1,382 @@
+/*
+Copyright (c) 2017, Michael J Welsh
+
+Permission to use, copy, modify, and/or distribute this software
+for any purpose with or without fee is hereby granted, provided
+that the above copyright notice and this permission notice appear
+in all copies.
+
+THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL
+WARRANTIES WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE
+AUTHOR BE LIABLE FOR ANY SPECIAL, DIRECT, INDIRECT, OR
+CONSEQUENTIAL DAMAGES OR ANY DAMAGES WHATSOEVER RESULTING FROM
+LOSS OF USE, DATA OR PROFITS, WHETHER IN AN ACTION OF CONTRACT,
+NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF OR IN
+CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+
+/**
+ * @file    timer_wheel.h
+ * @brief   HIERARCHICAL TIMER WHEEL
+ *
+ * Embed a @ref TimerWheelNode into your struct to make it a potential timer in a timer wheel. A
+ * @ref TimerWheel measures time in ticks, and keeps its timers in TIMER_WHEEL_LEVELS levels of
+ * TIMER_WHEEL_SLOTS slots, each of which is a @ref List of the "node" members of its @ref TimerWheelNode's.
+ * Level 0 has one slot per tick, and every slot of the next level spans a whole turn of the level below it.
+ * Arming a timer appends it to the slot of its expiry tick in the lowest level that reaches that far, and
+ * cancelling it unlinks it from that slot, both in O(1) whatever the number of timers. When a level
+ * completes a turn, the next slot of the level above is cascaded: its timers are placed again into the
+ * levels below, so a timer moves down at most TIMER_WHEEL_LEVELS - 1 times before it expires, and most
+ * timers of a network server are cancelled long before that.
+ *
+ * A @ref TimerWheel structure MUST be initialized before it is used. A @ref TimerWheelNode structure does
+ * NOT need to be initialized before it is used, unless @ref timer_wheel_armed is called on it before it is
+ * armed for the first time. A @ref TimerWheelNode should belong to at most ONE @ref TimerWheel. The expired
+ * timers are moved into a @ref List given by the caller, and are no longer armed: they can be armed again
+ * right away, once they are removed from that @ref List.
+ *
+ * Example:
+ *          struct Connection {
+ *              int fd;
+ *              TimerWheelNode timeout;
+ *          };
+ *
+ *          int main(void) {
+ *              struct Connection conns[100];
+ *              TimerWheel wheel;
+ *              List expired;
+ *              TimerWheelNode *node;
+ *              int i;
+ *
+ *              timer_wheel_init(&wheel, 0);
+ *              list_init(&expired);
+ *              for (i = 0; i < 100; ++i) {
+ *                  conns[i].fd = i;
+ *                  timer_wheel_arm(&wheel, &conns[i].timeout, 1000);
+ *              }
+ *
+ *              timer_wheel_cancel(&wheel, &conns[50].timeout);
+ *              timer_wheel_arm(&wheel, &conns[50].timeout, 10);
+ *
+ *              timer_wheel_advance(&wheel, 10, &expired);
+ *              node = list_entry(list_front(&expired), TimerWheelNode, node);
+ *              assert(timer_wheel_entry(node, struct Connection, timeout)->fd == 50);
+ *
+ *              return 0;
+ *          }
+ *
+ * Dependencies:
+ *      -   C89 assert.h
+ *      -   C89 stddef.h
+ *      -   list.h/list.c
+ *
+ * API:
+ *      ====  TYPES  ====
+ *      -   typedef struct TimerWheel TimerWheel
+ *      -   typedef struct TimerWheelNode TimerWheelNode
+ *
+ *      ====  FUNCTIONS  ====
+ *      Initializers:
+ *          -   timer_wheel_init
+ *      Properties:
+ *          -   timer_wheel_now
+ *          -   timer_wheel_size
+ *          -   timer_wheel_empty
+ *          -   timer_wheel_armed
+ *          -   timer_wheel_expires
+ *      Arming:
+ *          -   timer_wheel_arm
+ *          -   timer_wheel_cancel
+ *      Ticking:
+ *          -   timer_wheel_tick
+ *          -   timer_wheel_advance
+ *
+ *      ====  MACROS  ====
+ *      Constants:
+ *          -   TIMER_WHEEL_LEVELS
+ *          -   TIMER_WHEEL_SLOT_BITS
+ *          -   TIMER_WHEEL_SLOTS
+ *      Convenient Node Initializer:
+ *          -   TIMER_WHEEL_NODE_INIT
+ *      Properties:
+ *          -   timer_wheel_entry
+ */
+
+#ifndef TIMER_WHEEL_H
+#define TIMER_WHEEL_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif /* __cplusplus */
+
+#include <stddef.h>
+
+#include "list.h"
+
+/* ========================================================================================================
+ *
+ *                                                CONSTANTS
+ *
+ * ======================================================================================================== */
+
+/**
+ * The number of levels of a @ref TimerWheel. Can be overridden by defining it, the same way for
+ * timer_wheel.c and every file including timer_wheel.h.
+ */
+#ifndef TIMER_WHEEL_LEVELS
+    #define TIMER_WHEEL_LEVELS 5
+#endif
+
+/**
+ * The base 2 logarithm of the number of slots of each level. Can be overridden by defining it, the same way
+ * for timer_wheel.c and every file including timer_wheel.h. A timer further than
+ * 2^(TIMER_WHEEL_SLOT_BITS * TIMER_WHEEL_LEVELS) ticks waits in the top level until it is in range, so this
+ * product must be less than the number of bits of an unsigned long.
+ */
+#ifndef TIMER_WHEEL_SLOT_BITS
+    #define TIMER_WHEEL_SLOT_BITS 6
+#endif
+
+/**
+ * The number of slots of each level.
+ */
+#define TIMER_WHEEL_SLOTS (1 << TIMER_WHEEL_SLOT_BITS)
+
+/* ========================================================================================================
+ *
+ *                                                  TYPES
+ *
+ * ======================================================================================================== */
+
+/* Struct type declarations. */
+struct TimerWheel;
+struct TimerWheelNode;
+
+/* Struct typedef's. */
+typedef struct TimerWheel TimerWheel;
+typedef struct TimerWheelNode TimerWheelNode;
+
+/**
+ * Represents a hierarchical timer wheel. "now" is the last tick processed, and "slots[level][i]" holds the
+ * timers whose expiry tick, shifted right by TIMER_WHEEL_SLOT_BITS * level bits, ends with the bits of i.
+ */
+struct TimerWheel {
+    List slots[TIMER_WHEEL_LEVELS][TIMER_WHEEL_SLOTS];
+    unsigned long now;
+    size_t size;
+};
+
+/**
+ * Represents a timer in a @ref TimerWheel. Embed this into your structure to make it a timer. The "list"
+ * member is the slot holding the "node" member while the timer is armed, and NULL otherwise.
+ */
+struct TimerWheelNode {
+    ListNode node;
+    unsigned long expires;
+    List *list;
+};
+
+/* ========================================================================================================
+ *
+ *                                               PROTOTYPES
+ *
+ * ======================================================================================================== */
+
+/**
+ * Initializes/resets the @ref wheel, with no timers, at the tick @ref now.
+ *
+ * Requirements:
+ *      -   @ref wheel != NULL
+ *
+ * Time complexity:
+ *      -   O(TIMER_WHEEL_LEVELS * TIMER_WHEEL_SLOTS)
+ *
+ * @param wheel                 The @ref TimerWheel to be initialized/reset.
+ * @param now                   The current tick.
+ */
+void timer_wheel_init(TimerWheel *wheel, unsigned long now);
+
+/**
+ * Returns the last tick processed by the @ref wheel.
+ *
+ * Requirements:
+ *      -   @ref wheel != NULL
+ *
+ * Time complexity:
+ *      -   O(1)
+ *
+ * @param wheel                 The @ref TimerWheel whose "now" member will be returned.
+ * @return                      @ref wheel->now.
+ */
+unsigned long timer_wheel_now(const TimerWheel *wheel);
+
+/**
+ * Returns the number of armed timers in the @ref wheel.
+ *
+ * Requirements:
+ *      -   @ref wheel != NULL
+ *
+ * Time complexity:
+ *      -   O(1)
+ *
+ * @param wheel                 The @ref TimerWheel whose "size" member will be returned.
+ * @return                      @ref wheel->size.
+ */
+size_t timer_wheel_size(const TimerWheel *wheel);
+
+/**
+ * Returns whether or not the @ref wheel is empty (i.e. @ref wheel->size == 0).
+ *
+ * Requirements:
+ *      -   @ref wheel != NULL
+ *
+ * Time complexity:
+ *      -   O(1)
+ *
+ * @param wheel                 The @ref TimerWheel whose "size" member will be used to determine if it is
+ *                              empty.
+ * @return                      Whether or not the @ref wheel is empty (i.e. @ref wheel->size == 0).
+ */
+int timer_wheel_empty(const TimerWheel *wheel);
+
+/**
+ * Returns whether or not the @ref node is armed in a @ref TimerWheel.
+ *
+ * Requirements:
+ *      -   @ref node != NULL
+ *      -   @ref node has been armed before, or initialized with TIMER_WHEEL_NODE_INIT
+ *
+ * Time complexity:
+ *      -   O(1)
+ *
+ * @param node                  The @ref TimerWheelNode to be checked.
+ * @return                      Whether or not the @ref node is armed.
+ */
+int timer_wheel_armed(const TimerWheelNode *node);
+
+/**
+ * Returns the tick at which the @ref node expires, or expired.
+ *
+ * Requirements:
+ *      -   @ref node != NULL
+ *      -   @ref node has been armed before
+ *
+ * Time complexity:
+ *      -   O(1)
+ *
+ * @param node                  The @ref TimerWheelNode whose "expires" member will be returned.
+ * @return                      @ref node->expires.
+ */
+unsigned long timer_wheel_expires(const TimerWheelNode *node);
+
+/**
+ * Arms the @ref node in the @ref wheel, to expire at the tick @ref expires. If @ref expires is not after
+ * the last tick processed, the @ref node expires at the next tick.
+ *
+ * Requirements:
+ *      -   @ref wheel != NULL
+ *      -   @ref node != NULL
+ *      -   @ref node is not armed
+ *
+ * Time complexity:
+ *      -   O(1)
+ *
+ * @param wheel                 The @ref TimerWheel to be operated on.
+ * @param node                  The @ref TimerWheelNode to be armed.
+ * @param expires               The tick at which the @ref node expires.
+ */
+void timer_wheel_arm(TimerWheel *wheel, TimerWheelNode *node, unsigned long expires);
+
+/**
+ * Cancels the @ref node, removing it from the @ref wheel.
+ *
+ * Requirements:
+ *      -   @ref wheel != NULL
+ *      -   @ref node is armed in the @ref wheel
+ *
+ * Time complexity:
+ *      -   O(1)
+ *
+ * @param wheel                 The @ref TimerWheel containing the @ref node.
+ * @param node                  The @ref TimerWheelNode to be cancelled.
+ */
+void timer_wheel_cancel(TimerWheel *wheel, TimerWheelNode *node);
+
+/**
+ * Processes the tick after the last one processed by the @ref wheel, moving the timers expiring at it to
+ * the back of the @ref expired list, in the order they were armed or cascaded.
+ *
+ * Requirements:
+ *      -   @ref wheel != NULL
+ *      -   @ref expired != NULL
+ *
+ * Time complexity:
+ *      -   O(1) amortized, plus O(k) for the k timers expiring
+ *
+ * @param wheel                 The @ref TimerWheel to be operated on.
+ * @param expired               The @ref List to which the "node" members of the expired
+ *                              @ref TimerWheelNode's are moved.
+ */
+void timer_wheel_tick(TimerWheel *wheel, List *expired);
+
+/**
+ * Processes every tick up to @ref now, moving the timers expiring at them to the back of the @ref expired
+ * list, in the order they expire. Once the @ref wheel is empty, the remaining ticks are skipped.
+ *
+ * Requirements:
+ *      -   @ref wheel != NULL
+ *      -   @ref expired != NULL
+ *      -   @ref now >= @ref wheel->now
+ *
+ * Time complexity:
+ *      -   O(t) for the t ticks processed, plus O(k) for the k timers expiring
+ *
+ * @param wheel                 The @ref TimerWheel to be operated on.
+ * @param now                   The last tick to be processed.
+ * @param expired               The @ref List to which the "node" members of the expired
+ *                              @ref TimerWheelNode's are moved.
+ */
+void timer_wheel_advance(TimerWheel *wheel, unsigned long now, List *expired);
+
+/* ========================================================================================================
+ *
+ *                                                 MACROS
+ *
+ * ======================================================================================================== */
+
+/**
+ * Initializing a @ref TimerWheelNode before it is used is NOT required, unless @ref timer_wheel_armed is
+ * called on it first. This macro is simply for allowing you to initialize a struct (containing one or more
+ * @ref TimerWheelNode's) with an initializer-list conveniently.
+ */
+#define TIMER_WHEEL_NODE_INIT { LIST_NODE_INIT, 0, NULL }
+
+/**
+ * Obtains the pointer to the struct for this entry.
+ *
+ * Requirements:
+ *      -   @ref node_ptr != NULL
+ *
+ * @param node_ptr              The pointer to the @ref TimerWheelNode in the struct.
+ * @param type                  The type of the struct the @ref TimerWheelNode is embedded in.
+ * @param member                The name of the @ref TimerWheelNode in the struct.
+ */
+#if defined(__GNUC__) && !defined(__STRICT_ANSI__)
+    #define timer_wheel_entry(node_ptr, type, member) \
+        ({ \
+            const typeof(((type*)0)->member) *__mptr = (node_ptr); \
+            (type*) ((char*)__mptr - offsetof(type, member)); \
+        })
+#else
+    #define timer_wheel_entry(node_ptr, type, member) \
+        ( \
+            (type*) ((char*)(node_ptr) - offsetof(type, member)) \
+        )
+#endif
+
+#ifdef __cplusplus
+}
+#endif /* __cplusplus */
+
+#endif /* TIMER_WHEEL_H */
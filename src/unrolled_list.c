@@ -0,0 +1,369 @@
+/*
+Copyright (c) 2017, Michael J Welsh
+
+Permission to use, copy, modify, and/or distribute this software
+for any purpose with or without fee is hereby granted, provided
+that the above copyright notice and this permission notice appear
+in all copies.
+
+THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL
+WARRANTIES WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE
+AUTHOR BE LIABLE FOR ANY SPECIAL, DIRECT, INDIRECT, OR
+CONSEQUENTIAL DAMAGES OR ANY DAMAGES WHATSOEVER RESULTING FROM
+LOSS OF USE, DATA OR PROFITS, WHETHER IN AN ACTION OF CONTRACT,
+NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF OR IN
+CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+
+#include <assert.h>
+#include <stddef.h>
+#include <stdlib.h>
+
+#include "unrolled_list.h"
+
+/* ========================================================================================================
+ *
+ *                                              STATIC MACROS
+ *
+ * ======================================================================================================== */
+
+/* A chunk holding at most this many nodes after a removal is merged into a neighbor, if they fit. */
+#define SPARSE_CHUNK_SIZE (UNROLLED_LIST_CHUNK_CAPACITY / 4)
+
+/* Merged chunks are left with at least this much room, so that they are not split right away. */
+#define MERGED_CHUNK_MAX_SIZE (UNROLLED_LIST_CHUNK_CAPACITY * 3 / 4)
+
+/* ========================================================================================================
+ *
+ *                                        STATIC FUNCTION PROTOTYPES
+ *
+ * ======================================================================================================== */
+
+/*
+ * Allocates an empty chunk whose free slots all precede (@ref at_front) or follow the nodes. Returns NULL on
+ * failure.
+ */
+static UnrolledListChunk* allocate_chunk(UnrolledList *list, int at_front);
+
+/*
+ * Unlinks the @ref chunk from the @ref list and frees it.
+ */
+static void deallocate_chunk(UnrolledList *list, UnrolledListChunk *chunk);
+
+/*
+ * Moves the nodes of the @ref chunk so that they start at the index @ref new_begin.
+ */
+static void relocate(UnrolledListChunk *chunk, size_t new_begin);
+
+/*
+ * Moves the nodes of the @ref right chunk to the back of the @ref left chunk, which precedes it, and frees
+ * the @ref right chunk.
+ */
+static void merge_chunks(UnrolledList *list, UnrolledListChunk *left, UnrolledListChunk *right);
+
+/* ========================================================================================================
+ *
+ *                                        STATIC FUNCTION DEFINITIONS
+ *
+ * ======================================================================================================== */
+
+static UnrolledListChunk* allocate_chunk(UnrolledList *list, int at_front) {
+    UnrolledListChunk *chunk;
+
+    assert(list);
+
+    if (list->allocate) {
+        chunk = (UnrolledListChunk*) list->allocate(sizeof(UnrolledListChunk), list->allocator_data);
+    } else {
+        chunk = (UnrolledListChunk*) malloc(sizeof(UnrolledListChunk));
+    }
+
+    if (chunk) {
+        chunk->prev = NULL;
+        chunk->next = NULL;
+        chunk->begin = chunk->end = at_front ? UNROLLED_LIST_CHUNK_CAPACITY : 0;
+    }
+
+    return chunk;
+}
+
+static void deallocate_chunk(UnrolledList *list, UnrolledListChunk *chunk) {
+    assert(list && chunk);
+
+    if (chunk->prev) {
+        chunk->prev->next = chunk->next;
+    } else {
+        list->head = chunk->next;
+    }
+
+    if (chunk->next) {
+        chunk->next->prev = chunk->prev;
+    } else {
+        list->tail = chunk->prev;
+    }
+
+    if (list->deallocate) {
+        list->deallocate(chunk, sizeof(UnrolledListChunk), list->allocator_data);
+    } else {
+        free(chunk);
+    }
+}
+
+static void relocate(UnrolledListChunk *chunk, size_t new_begin) {
+    size_t size, i;
+
+    assert(chunk && new_begin + (chunk->end - chunk->begin) <= UNROLLED_LIST_CHUNK_CAPACITY);
+
+    size = chunk->end - chunk->begin;
+
+    if (new_begin < chunk->begin) {
+        for (i = 0; i < size; ++i) {
+            chunk->nodes[new_begin + i] = chunk->nodes[chunk->begin + i];
+            chunk->nodes[new_begin + i]->index = new_begin + i;
+        }
+    } else if (new_begin > chunk->begin) {
+        for (i = size; i > 0; --i) {
+            chunk->nodes[new_begin + i - 1] = chunk->nodes[chunk->begin + i - 1];
+            chunk->nodes[new_begin + i - 1]->index = new_begin + i - 1;
+        }
+    }
+
+    chunk->begin = new_begin;
+    chunk->end = new_begin + size;
+}
+
+static void merge_chunks(UnrolledList *list, UnrolledListChunk *left, UnrolledListChunk *right) {
+    size_t i;
+
+    assert(list && left && right && left->next == right);
+    assert((left->end - left->begin) + (right->end - right->begin) <= UNROLLED_LIST_CHUNK_CAPACITY);
+
+    if (left->end + (right->end - right->begin) > UNROLLED_LIST_CHUNK_CAPACITY) {
+        relocate(left, 0);
+    }
+
+    for (i = right->begin; i < right->end; ++i) {
+        left->nodes[left->end] = right->nodes[i];
+        left->nodes[left->end]->chunk = left;
+        left->nodes[left->end]->index = left->end;
+        ++left->end;
+    }
+
+    deallocate_chunk(list, right);
+}
+
+/* ========================================================================================================
+ *
+ *                                        EXTERN FUNCTION DEFINITIONS
+ *
+ * ======================================================================================================== */
+
+void unrolled_list_init(
+    UnrolledList *list,
+    void* (*allocate)(size_t size, void *allocator_data),
+    void (*deallocate)(void *ptr, size_t size, void *allocator_data),
+    void *allocator_data
+) {
+    assert(list && ((!allocate && !deallocate) || (allocate && deallocate)));
+
+    list->head = NULL;
+    list->tail = NULL;
+    list->size = 0;
+    list->allocate = allocate;
+    list->deallocate = deallocate;
+    list->allocator_data = allocator_data;
+}
+
+UnrolledListNode* unrolled_list_front(const UnrolledList *list) {
+    assert(list);
+
+    return list->head ? list->head->nodes[list->head->begin] : NULL;
+}
+
+UnrolledListNode* unrolled_list_back(const UnrolledList *list) {
+    assert(list);
+
+    return list->tail ? list->tail->nodes[list->tail->end - 1] : NULL;
+}
+
+UnrolledListNode* unrolled_list_prev(const UnrolledListNode *node) {
+    UnrolledListChunk *chunk;
+
+    if (!node) {
+        return NULL;
+    }
+
+    chunk = node->chunk;
+
+    if (node->index > chunk->begin) {
+        return chunk->nodes[node->index - 1];
+    }
+
+    return chunk->prev ? chunk->prev->nodes[chunk->prev->end - 1] : NULL;
+}
+
+UnrolledListNode* unrolled_list_next(const UnrolledListNode *node) {
+    UnrolledListChunk *chunk;
+
+    if (!node) {
+        return NULL;
+    }
+
+    chunk = node->chunk;
+
+    if (node->index + 1 < chunk->end) {
+        return chunk->nodes[node->index + 1];
+    }
+
+    return chunk->next ? chunk->next->nodes[chunk->next->begin] : NULL;
+}
+
+size_t unrolled_list_size(const UnrolledList *list) {
+    assert(list);
+
+    return list->size;
+}
+
+int unrolled_list_empty(const UnrolledList *list) {
+    assert(list);
+
+    return list->size == 0;
+}
+
+int unrolled_list_insert_front(UnrolledList *list, UnrolledListNode *new_node) {
+    UnrolledListChunk *chunk;
+
+    assert(list && new_node);
+
+    chunk = list->head;
+
+    if (chunk && chunk->begin == 0 && chunk->end < UNROLLED_LIST_CHUNK_CAPACITY) {
+        /* Center the nodes to make room at the front, leaving room at the back as well. */
+        relocate(chunk, (UNROLLED_LIST_CHUNK_CAPACITY - chunk->end + 1) / 2);
+    } else if (!chunk || chunk->begin == 0) {
+        chunk = allocate_chunk(list, 1);
+
+        if (!chunk) {
+            return 0;
+        }
+
+        chunk->next = list->head;
+        if (list->head) {
+            list->head->prev = chunk;
+        } else {
+            list->tail = chunk;
+        }
+        list->head = chunk;
+    }
+
+    --chunk->begin;
+    chunk->nodes[chunk->begin] = new_node;
+    new_node->chunk = chunk;
+    new_node->index = chunk->begin;
+
+    ++list->size;
+
+    return 1;
+}
+
+int unrolled_list_insert_back(UnrolledList *list, UnrolledListNode *new_node) {
+    UnrolledListChunk *chunk;
+
+    assert(list && new_node);
+
+    chunk = list->tail;
+
+    if (chunk && chunk->end == UNROLLED_LIST_CHUNK_CAPACITY && chunk->begin > 0) {
+        /* Center the nodes to make room at the back, leaving room at the front as well. */
+        relocate(chunk, chunk->begin / 2);
+    } else if (!chunk || chunk->end == UNROLLED_LIST_CHUNK_CAPACITY) {
+        chunk = allocate_chunk(list, 0);
+
+        if (!chunk) {
+            return 0;
+        }
+
+        chunk->prev = list->tail;
+        if (list->tail) {
+            list->tail->next = chunk;
+        } else {
+            list->head = chunk;
+        }
+        list->tail = chunk;
+    }
+
+    chunk->nodes[chunk->end] = new_node;
+    new_node->chunk = chunk;
+    new_node->index = chunk->end;
+    ++chunk->end;
+
+    ++list->size;
+
+    return 1;
+}
+
+void unrolled_list_remove(UnrolledList *list, UnrolledListNode *node) {
+    UnrolledListChunk *chunk;
+    size_t i, size;
+
+    assert(list);
+
+    if (!node) {
+        return;
+    }
+
+    chunk = node->chunk;
+
+    /* Close the gap by shifting the shorter side. */
+    if (node->index - chunk->begin < chunk->end - 1 - node->index) {
+        for (i = node->index; i > chunk->begin; --i) {
+            chunk->nodes[i] = chunk->nodes[i - 1];
+            chunk->nodes[i]->index = i;
+        }
+        ++chunk->begin;
+    } else {
+        for (i = node->index; i + 1 < chunk->end; ++i) {
+            chunk->nodes[i] = chunk->nodes[i + 1];
+            chunk->nodes[i]->index = i;
+        }
+        --chunk->end;
+    }
+
+    node->chunk = UNROLLED_LIST_POISON_CHUNK;
+    --list->size;
+
+    size = chunk->end - chunk->begin;
+
+    if (size == 0) {
+        deallocate_chunk(list, chunk);
+    } else if (size <= SPARSE_CHUNK_SIZE) {
+        if (chunk->next && size + (chunk->next->end - chunk->next->begin) <= MERGED_CHUNK_MAX_SIZE) {
+            merge_chunks(list, chunk, chunk->next);
+        } else if (chunk->prev && size + (chunk->prev->end - chunk->prev->begin) <= MERGED_CHUNK_MAX_SIZE) {
+            merge_chunks(list, chunk->prev, chunk);
+        }
+    }
+}
+
+void unrolled_list_remove_front(UnrolledList *list) {
+    assert(list);
+
+    unrolled_list_remove(list, unrolled_list_front(list));
+}
+
+void unrolled_list_remove_back(UnrolledList *list) {
+    assert(list);
+
+    unrolled_list_remove(list, unrolled_list_back(list));
+}
+
+void unrolled_list_remove_all(UnrolledList *list) {
+    assert(list);
+
+    while (list->head) {
+        deallocate_chunk(list, list->head);
+    }
+
+    list->size = 0;
+}
@@ -0,0 +1,476 @@
+/*
+Copyright (c) 2017, Michael J Welsh
+
+Permission to use, copy, modify, and/or distribute this software
+for any purpose with or without fee is hereby granted, provided
+that the above copyright notice and this permission notice appear
+in all copies.
+
+THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL
+WARRANTIES WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE
+AUTHOR BE LIABLE FOR ANY SPECIAL, DIRECT, INDIRECT, OR
+CONSEQUENTIAL DAMAGES OR ANY DAMAGES WHATSOEVER RESULTING FROM
+LOSS OF USE, DATA OR PROFITS, WHETHER IN AN ACTION OF CONTRACT,
+NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF OR IN
+CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+
+/**
+ * @file    unrolled_list.h
+ * @brief   UNROLLED LIST
+ *
+ * Embed one or more @ref UnrolledListNode's into your struct to make it a potential node in one or more
+ * unrolled lists. The @ref UnrolledList structure keeps track of a sequence of @ref UnrolledListNode's by
+ * storing pointers to them in a chain of @ref UnrolledListChunk's, each holding up to
+ * @ref UNROLLED_LIST_CHUNK_CAPACITY pointers in a contiguous array. A @ref UnrolledList structure MUST be
+ * initialized before it is used. A @ref UnrolledListNode structure does NOT need to be initialized before it
+ * is used. A @ref UnrolledListNode should belong to at most ONE @ref UnrolledList.
+ *
+ * Iterating over a @ref List is a chain of dependent loads: the address of the next @ref ListNode is only
+ * known once the current one has been fetched from memory. Iterating over a @ref UnrolledList reads the
+ * pointer arrays sequentially instead, so the processor can fetch many nodes at once, and only has to follow
+ * one "next" pointer per chunk. This makes full scans of large lists several times faster. The price is that
+ * insertion is limited to the front and the back, and that the @ref UnrolledList allocates its chunks.
+ *
+ * Chunks are allocated with the OPTIONAL allocate and deallocate functions given during initialization, and
+ * with malloc() and free() otherwise. The allocator data given during initialization is passed to both, and
+ * is NEVER manipulated by the @ref UnrolledList.
+ *
+ * Example:
+ *          struct Object {
+ *              int val;
+ *              UnrolledListNode n;
+ *          };
+ *
+ *          int main(void) {
+ *              struct Object obj1, obj2;
+ *              UnrolledList list;
+ *              UnrolledListChunk *chunk;
+ *              UnrolledListNode *n;
+ *              size_t index;
+ *              int sum = 0;
+ *
+ *              obj1.val = 1;
+ *              obj2.val = 2;
+ *
+ *              unrolled_list_init(&list, NULL, NULL, NULL);
+ *              if (!unrolled_list_insert_back(&list, &obj1.n)) {
+ *                  return 1;
+ *              }
+ *              if (!unrolled_list_insert_back(&list, &obj2.n)) {
+ *                  unrolled_list_remove_all(&list);
+ *                  return 1;
+ *              }
+ *
+ *              unrolled_list_for_each(n, chunk, index, &list) {
+ *                  sum += unrolled_list_entry(n, struct Object, n)->val;
+ *              }
+ *              assert(sum == 3);
+ *
+ *              unrolled_list_remove_all(&list);
+ *
+ *              return 0;
+ *          }
+ *
+ * Dependencies:
+ *      -   C89 assert.h
+ *      -   C89 stddef.h
+ *      -   C89 stdlib.h
+ *
+ * API:
+ *      ====  TYPES  ====
+ *      -   typedef struct UnrolledList UnrolledList
+ *      -   typedef struct UnrolledListChunk UnrolledListChunk
+ *      -   typedef struct UnrolledListNode UnrolledListNode
+ *
+ *      ====  FUNCTIONS  ====
+ *      Initializers:
+ *          -   unrolled_list_init
+ *      Properties:
+ *          -   unrolled_list_front
+ *          -   unrolled_list_back
+ *          -   unrolled_list_prev
+ *          -   unrolled_list_next
+ *          -   unrolled_list_size
+ *          -   unrolled_list_empty
+ *      Insertion:
+ *          -   unrolled_list_insert_front
+ *          -   unrolled_list_insert_back
+ *      Removal:
+ *          -   unrolled_list_remove
+ *          -   unrolled_list_remove_front
+ *          -   unrolled_list_remove_back
+ *          -   unrolled_list_remove_all
+ *
+ *      ====  MACROS  ====
+ *      Constants:
+ *          -   UNROLLED_LIST_CHUNK_CAPACITY
+ *          -   UNROLLED_LIST_POISON_CHUNK
+ *      Properties:
+ *          -   unrolled_list_entry
+ *      Traversal:
+ *          -   unrolled_list_for_each
+ *          -   unrolled_list_for_each_reverse
+ */
+
+#ifndef UNROLLED_LIST_H
+#define UNROLLED_LIST_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif /* __cplusplus */
+
+#include <stddef.h>
+
+/* ========================================================================================================
+ *
+ *                                                  TYPES
+ *
+ * ======================================================================================================== */
+
+/**
+ * The maximum number of @ref UnrolledListNode's in a @ref UnrolledListChunk. By default, a chunk spans four
+ * 64-byte cache lines on 64-bit platforms. Can be overridden by defining it before including this header; it
+ * must then have the same value in every translation unit.
+ */
+#ifndef UNROLLED_LIST_CHUNK_CAPACITY
+    #define UNROLLED_LIST_CHUNK_CAPACITY 28
+#endif
+
+/* Struct type declarations. */
+struct UnrolledList;
+struct UnrolledListChunk;
+struct UnrolledListNode;
+
+/* Struct typedef's. */
+typedef struct UnrolledList UnrolledList;
+typedef struct UnrolledListChunk UnrolledListChunk;
+typedef struct UnrolledListNode UnrolledListNode;
+
+/**
+ * Represents an unrolled list.
+ */
+struct UnrolledList {
+    UnrolledListChunk *head;
+    UnrolledListChunk *tail;
+    size_t size;
+    void* (*allocate)(size_t size, void *allocator_data);
+    void (*deallocate)(void *ptr, size_t size, void *allocator_data);
+    void *allocator_data;
+};
+
+/**
+ * Represents a chunk of a @ref UnrolledList. The @ref UnrolledListNode's of the chunk are in
+ * nodes[begin, end). Managed by the @ref UnrolledList.
+ */
+struct UnrolledListChunk {
+    UnrolledListChunk *prev;
+    UnrolledListChunk *next;
+    size_t begin;
+    size_t end;
+    UnrolledListNode *nodes[UNROLLED_LIST_CHUNK_CAPACITY];
+};
+
+/**
+ * Represents a node in a @ref UnrolledList. Embed this into your structure to make it a node. Records where
+ * the @ref UnrolledListNode is stored, so that it can be removed without searching.
+ */
+struct UnrolledListNode {
+    UnrolledListChunk *chunk;
+    size_t index;
+};
+
+/* ========================================================================================================
+ *
+ *                                               PROTOTYPES
+ *
+ * ======================================================================================================== */
+
+/**
+ * Initializes the @ref list. Use @ref unrolled_list_remove_all to reset a @ref list that is not empty,
+ * otherwise its chunks are leaked.
+ *
+ * Requirements:
+ *      -   @ref list != NULL
+ *      -   Either @ref allocate and @ref deallocate are both NULL, or are both non-NULL
+ *
+ * Time complexity:
+ *      -   O(1)
+ *
+ * @param list                  The @ref UnrolledList to be initialized.
+ * @param allocate              The OPTIONAL (i.e. can be NULL) function used to allocate a chunk of
+ *                              @ref size bytes. Returns NULL on failure. If NULL, malloc() is used.
+ * @param deallocate            The OPTIONAL (i.e. can be NULL) function used to free a chunk of @ref size
+ *                              bytes allocated by @ref allocate. If NULL, free() is used.
+ * @param allocator_data        The OPTIONAL (i.e. can be NULL) data passed to @ref allocate and
+ *                              @ref deallocate. This data is NEVER manipulated by the @ref list.
+ */
+void unrolled_list_init(
+    UnrolledList *list,
+    void* (*allocate)(size_t size, void *allocator_data),
+    void (*deallocate)(void *ptr, size_t size, void *allocator_data),
+    void *allocator_data
+);
+
+/**
+ * Returns the front of the @ref list. NULL if the @ref list is empty.
+ *
+ * Requirements:
+ *      -   @ref list != NULL
+ *
+ * Time complexity:
+ *      -   O(1)
+ *
+ * @param list                  The @ref UnrolledList whose first @ref UnrolledListNode will be returned.
+ * @return                      The first @ref UnrolledListNode of the @ref list.
+ */
+UnrolledListNode* unrolled_list_front(const UnrolledList *list);
+
+/**
+ * Returns the back of the @ref list. NULL if the @ref list is empty.
+ *
+ * Requirements:
+ *      -   @ref list != NULL
+ *
+ * Time complexity:
+ *      -   O(1)
+ *
+ * @param list                  The @ref UnrolledList whose last @ref UnrolledListNode will be returned.
+ * @return                      The last @ref UnrolledListNode of the @ref list.
+ */
+UnrolledListNode* unrolled_list_back(const UnrolledList *list);
+
+/**
+ * Returns the @ref UnrolledListNode before the @ref node. NULL if @ref node == NULL.
+ *
+ * Requirements:
+ *      -   None
+ *
+ * Time complexity:
+ *      -   O(1)
+ *
+ * @param node                  The @ref UnrolledListNode whose predecessor will be returned.
+ * @return                      NULL if @ref node == NULL; otherwise, the predecessor of the @ref node.
+ */
+UnrolledListNode* unrolled_list_prev(const UnrolledListNode *node);
+
+/**
+ * Returns the @ref UnrolledListNode after the @ref node. NULL if @ref node == NULL.
+ *
+ * Requirements:
+ *      -   None
+ *
+ * Time complexity:
+ *      -   O(1)
+ *
+ * @param node                  The @ref UnrolledListNode whose successor will be returned.
+ * @return                      NULL if @ref node == NULL; otherwise, the successor of the @ref node.
+ */
+UnrolledListNode* unrolled_list_next(const UnrolledListNode *node);
+
+/**
+ * Returns the size of the @ref list.
+ *
+ * Requirements:
+ *      -   @ref list != NULL
+ *
+ * Time complexity:
+ *      -   O(1)
+ *
+ * @param list                  The @ref UnrolledList whose "size" member will be returned.
+ * @return                      @ref list->size.
+ */
+size_t unrolled_list_size(const UnrolledList *list);
+
+/**
+ * Returns whether or not the @ref list is empty (i.e. @ref list->size == 0).
+ *
+ * Requirements:
+ *      -   @ref list != NULL
+ *
+ * Time complexity:
+ *      -   O(1)
+ *
+ * @param list                  The @ref UnrolledList whose "size" member will be used to determine if it is
+ *                              empty.
+ * @return                      Whether or not the @ref list is empty (i.e. @ref list->size == 0).
+ */
+int unrolled_list_empty(const UnrolledList *list);
+
+/**
+ * Inserts the @ref new_node into the front of the @ref list. Allocates a chunk if the front chunk is full.
+ *
+ * Requirements:
+ *      -   @ref list != NULL
+ *      -   @ref new_node != NULL
+ *
+ * Time complexity:
+ *      -   O(@ref UNROLLED_LIST_CHUNK_CAPACITY), i.e. O(1)
+ *
+ * @param list                  The @ref UnrolledList to be operated on.
+ * @param new_node              The @ref UnrolledListNode to be inserted.
+ * @return                      0 if a chunk could not be allocated (the @ref list is left unchanged);
+ *                              otherwise, 1.
+ */
+int unrolled_list_insert_front(UnrolledList *list, UnrolledListNode *new_node);
+
+/**
+ * Inserts the @ref new_node into the back of the @ref list. Allocates a chunk if the back chunk is full.
+ *
+ * Requirements:
+ *      -   @ref list != NULL
+ *      -   @ref new_node != NULL
+ *
+ * Time complexity:
+ *      -   O(@ref UNROLLED_LIST_CHUNK_CAPACITY), i.e. O(1)
+ *
+ * @param list                  The @ref UnrolledList to be operated on.
+ * @param new_node              The @ref UnrolledListNode to be inserted.
+ * @return                      0 if a chunk could not be allocated (the @ref list is left unchanged);
+ *                              otherwise, 1.
+ */
+int unrolled_list_insert_back(UnrolledList *list, UnrolledListNode *new_node);
+
+/**
+ * Removes the @ref node from the @ref list. If @ref node == NULL, this function simply returns. The
+ * neighbors of the @ref node within its chunk are shifted to close the gap, a chunk that becomes empty is
+ * freed, and a chunk that becomes sparse is merged with a neighboring chunk, so that scans stay dense.
+ *
+ * Requirements:
+ *      -   @ref list != NULL
+ *
+ * Time complexity:
+ *      -   O(@ref UNROLLED_LIST_CHUNK_CAPACITY), i.e. O(1)
+ *
+ * @param list                  The @ref UnrolledList containing the @ref node to be removed.
+ * @param node                  The @ref UnrolledListNode in the @ref list to be removed.
+ */
+void unrolled_list_remove(UnrolledList *list, UnrolledListNode *node);
+
+/**
+ * Removes the front of the @ref list. If the @ref list is empty, this function simply returns.
+ *
+ * Requirements:
+ *      -   @ref list != NULL
+ *
+ * Time complexity:
+ *      -   O(@ref UNROLLED_LIST_CHUNK_CAPACITY), i.e. O(1)
+ *
+ * @param list                  The @ref UnrolledList to be operated on.
+ */
+void unrolled_list_remove_front(UnrolledList *list);
+
+/**
+ * Removes the back of the @ref list. If the @ref list is empty, this function simply returns.
+ *
+ * Requirements:
+ *      -   @ref list != NULL
+ *
+ * Time complexity:
+ *      -   O(@ref UNROLLED_LIST_CHUNK_CAPACITY), i.e. O(1)
+ *
+ * @param list                  The @ref UnrolledList to be operated on.
+ */
+void unrolled_list_remove_back(UnrolledList *list);
+
+/**
+ * Removes all the @ref UnrolledListNode's from the @ref list, and frees all of its chunks. If the @ref list
+ * is empty, this function simply returns.
+ *
+ * Requirements:
+ *      -   @ref list != NULL
+ *
+ * Time complexity:
+ *      -   O(n / @ref UNROLLED_LIST_CHUNK_CAPACITY)
+ *
+ * @param list                  The @ref UnrolledList to be operated on.
+ */
+void unrolled_list_remove_all(UnrolledList *list);
+
+/* ========================================================================================================
+ *
+ *                                                 MACROS
+ *
+ * ======================================================================================================== */
+
+/**
+ * Non-NULL pointer that will result in page faults under normal circumstances. Is the "chunk" member of a
+ * removed @ref UnrolledListNode. Useful for identifying bugs.
+ */
+#define UNROLLED_LIST_POISON_CHUNK ((UnrolledListChunk*) 0x100)
+
+/**
+ * Obtains the pointer to the struct for this entry.
+ *
+ * Requirements:
+ *      -   @ref node_ptr != NULL
+ *
+ * @param node_ptr              The pointer to the @ref UnrolledListNode in the struct.
+ * @param type                  The type of the struct the @ref UnrolledListNode is embedded in.
+ * @param member                The name of the @ref UnrolledListNode in the struct.
+ */
+#if defined(__GNUC__) && !defined(__STRICT_ANSI__)
+    #define unrolled_list_entry(node_ptr, type, member) \
+        ({ \
+            const typeof(((type*)0)->member) *__mptr = (node_ptr); \
+            (type*) ((char*)__mptr - offsetof(type, member)); \
+        })
+#else
+    #define unrolled_list_entry(node_ptr, type, member) \
+        ( \
+            (type*) ((char*)(node_ptr) - offsetof(type, member)) \
+        )
+#endif
+
+/**
+ * Iterates over the @ref UnrolledList from the front to the back.
+ *
+ * Requirements:
+ *      -   @ref list_ptr != NULL
+ *      -   The @ref UnrolledList is not modified in the loop's body.
+ *      -   The @ref cursor_node_ptr, @ref cursor_chunk_ptr, and @ref index are not reassigned.
+ *
+ * @param cursor_node_ptr       The @ref UnrolledListNode to use as a loop cursor.
+ * @param cursor_chunk_ptr      The @ref UnrolledListChunk to use to keep track of the current chunk.
+ * @param index                 The size_t to use to keep track of the current index in the chunk.
+ * @param list_ptr              The pointer to a @ref UnrolledList that will be iterated over.
+ */
+#define unrolled_list_for_each(cursor_node_ptr, cursor_chunk_ptr, index, list_ptr) \
+    for ( \
+        cursor_chunk_ptr = (list_ptr)->head, index = cursor_chunk_ptr ? cursor_chunk_ptr->begin : 0; \
+        cursor_chunk_ptr && ( \
+            index < cursor_chunk_ptr->end || \
+            ((cursor_chunk_ptr = cursor_chunk_ptr->next) && ((index = cursor_chunk_ptr->begin), 1)) \
+        ) && ((cursor_node_ptr = cursor_chunk_ptr->nodes[index]), 1); \
+        ++index \
+    )
+
+/**
+ * Iterates over the @ref UnrolledList from the back to the front.
+ *
+ * Requirements:
+ *      -   @ref list_ptr != NULL
+ *      -   The @ref UnrolledList is not modified in the loop's body.
+ *      -   The @ref cursor_node_ptr, @ref cursor_chunk_ptr, and @ref index are not reassigned.
+ *
+ * @param cursor_node_ptr       The @ref UnrolledListNode to use as a loop cursor.
+ * @param cursor_chunk_ptr      The @ref UnrolledListChunk to use to keep track of the current chunk.
+ * @param index                 The size_t to use to keep track of the current index in the chunk, plus one.
+ * @param list_ptr              The pointer to a @ref UnrolledList that will be iterated over.
+ */
+#define unrolled_list_for_each_reverse(cursor_node_ptr, cursor_chunk_ptr, index, list_ptr) \
+    for ( \
+        cursor_chunk_ptr = (list_ptr)->tail, index = cursor_chunk_ptr ? cursor_chunk_ptr->end : 0; \
+        cursor_chunk_ptr && ( \
+            index > cursor_chunk_ptr->begin || \
+            ((cursor_chunk_ptr = cursor_chunk_ptr->prev) && ((index = cursor_chunk_ptr->end), 1)) \
+        ) && ((cursor_node_ptr = cursor_chunk_ptr->nodes[index - 1]), 1); \
+        --index \
+    )
+
+#ifdef __cplusplus
+}
+#endif /* __cplusplus */
+
+#endif /* UNROLLED_LIST_H */
@@ -0,0 +1,405 @@
+/*
+Copyright (c) 2017, Michael J Welsh
+
+Permission to use, copy, modify, and/or distribute this software
+for any purpose with or without fee is hereby granted, provided
+that the above copyright notice and this permission notice appear
+in all copies.
+
+THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL
+WARRANTIES WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE
+AUTHOR BE LIABLE FOR ANY SPECIAL, DIRECT, INDIRECT, OR
+CONSEQUENTIAL DAMAGES OR ANY DAMAGES WHATSOEVER RESULTING FROM
+LOSS OF USE, DATA OR PROFITS, WHETHER IN AN ACTION OF CONTRACT,
+NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF OR IN
+CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <stddef.h>
+#include <string.h>
+#include <assert.h>
+
+#include "testing_framework.h"
+
+/* Test header guard. */
+#include "../src/arena.h"
+#include "../src/arena.h"
+
+/* ========================================================================================================
+ *
+ *                                             TESTING UTILITIES
+ *
+ * ======================================================================================================== */
+
+#define CHUNK_SIZE 1024
+#define NUM_BLOCKS 1000
+
+Arena arena;
+char *blocks[NUM_BLOCKS];
+size_t block_sizes[NUM_BLOCKS];
+
+/* The chunks currently allocated through the counting allocator, and whether it should fail. */
+size_t num_chunks;
+int fail_allocations;
+
+static void* allocate_(size_t size, void *allocator_data) {
+    assert(size >= CHUNK_SIZE);
+    assert(allocator_data == &num_chunks);
+
+    if (fail_allocations) {
+        return NULL;
+    }
+
+    ++num_chunks;
+    return malloc(size);
+}
+
+static void deallocate_(void *ptr, size_t size, void *allocator_data) {
+    assert(ptr && size >= CHUNK_SIZE);
+    assert(allocator_data == &num_chunks);
+
+    --num_chunks;
+    free(ptr);
+}
+
+/* Allocates num_blocks blocks of 1 to 100 bytes into the blocks array, and fills each with its index. */
+static void alloc_blocks_(size_t num_blocks) {
+    size_t i;
+
+    for (i = 0; i < num_blocks; ++i) {
+        block_sizes[i] = 1 + i * 37 % 100;
+        blocks[i] = (char*) arena_alloc(&arena, block_sizes[i]);
+        assert(blocks[i]);
+        assert((size_t) blocks[i] % ARENA_ALIGNMENT == 0);
+        memset(blocks[i], (int) i, block_sizes[i]);
+    }
+}
+
+/* Asserts the first num_blocks blocks still hold their contents, so none of them overlap. */
+static void assert_blocks_intact_(size_t num_blocks) {
+    size_t i, j;
+
+    for (i = 0; i < num_blocks; ++i) {
+        for (j = 0; j < block_sizes[i]; ++j) {
+            assert(blocks[i][j] == (char) i);
+        }
+    }
+}
+
+static void reset_globals(void) {
+    /* Free whatever the previous test left behind. */
+    arena_release(&arena);
+    assert(num_chunks == 0);
+
+    fail_allocations = 0;
+    arena_init(&arena, CHUNK_SIZE, allocate_, deallocate_, &num_chunks);
+    memset(blocks, 0, sizeof(blocks));
+    memset(block_sizes, 0, sizeof(block_sizes));
+}
+
+/* ========================================================================================================
+ *
+ *                                             TESTING FUNCTIONS
+ *
+ * ======================================================================================================== */
+
+void test_arena_init(void) {
+    Arena other_arena;
+
+    assert(arena.head == NULL && arena.current == NULL);
+    assert(arena.cursor == NULL && arena.limit == NULL);
+    assert(arena.size == 0);
+    assert(arena.chunk_size == CHUNK_SIZE);
+    assert(arena.allocate == allocate_ && arena.deallocate == deallocate_);
+    assert(arena.allocator_data == &num_chunks);
+
+    /* Without a chunk size, nothing is allocated. */
+    arena_init(&other_arena, 0, NULL, NULL, NULL);
+    assert(other_arena.chunk_size == 0);
+    assert(other_arena.allocate == NULL && other_arena.deallocate == NULL);
+    assert(arena_alloc(&other_arena, 1) == NULL);
+    assert(arena_alloc(&other_arena, 0) == NULL);
+
+    /* Without an allocator, malloc() and free() are used. */
+    arena_init(&other_arena, CHUNK_SIZE, NULL, NULL, NULL);
+    assert(arena_alloc(&other_arena, 1) != NULL);
+    assert(other_arena.head && other_arena.head->owned);
+    arena_release(&other_arena);
+    assert(other_arena.head == NULL);
+}
+
+void test_arena_size(void) {
+    ArenaMark mark;
+
+    assert(arena_size(&arena) == 0);
+    arena_alloc(&arena, 1);
+    assert(arena_size(&arena) == 1);
+    arena_alloc(&arena, 100);
+    assert(arena_size(&arena) == 101);
+    arena_mark(&arena, &mark);
+    arena_alloc_aligned(&arena, 10, 64);
+    assert(arena_size(&arena) == 111);
+    arena_rewind(&arena, &mark);
+    assert(arena_size(&arena) == 101);
+    arena_reset(&arena);
+    assert(arena_size(&arena) == 0);
+}
+
+void test_arena_add_chunk(void) {
+    char *memory1 = (char*) malloc(CHUNK_SIZE), *memory2 = (char*) malloc(CHUNK_SIZE / 4);
+    char *block;
+    size_t i;
+
+    assert(memory1 && memory2);
+
+    /* An arena without a chunk size only uses the chunks given to it. */
+    arena_init(&arena, 0, NULL, NULL, NULL);
+    arena_add_chunk(&arena, memory1, CHUNK_SIZE);
+    assert(arena.head == (ArenaChunk*) memory1 && !arena.head->owned);
+
+    block = (char*) arena_alloc(&arena, 1);
+    assert(block == memory1 + ARENA_CHUNK_OVERHEAD);
+    for (i = 1; i < (CHUNK_SIZE - ARENA_CHUNK_OVERHEAD) / ARENA_ALIGNMENT; ++i) {
+        block = (char*) arena_alloc(&arena, 1);
+        assert(block == memory1 + ARENA_CHUNK_OVERHEAD + i * ARENA_ALIGNMENT);
+    }
+    assert(arena_alloc(&arena, 1) == NULL);
+
+    /* Chunks added later are used next. */
+    arena_add_chunk(&arena, memory2, CHUNK_SIZE / 4);
+    assert(arena.head->next == (ArenaChunk*) memory2);
+    block = (char*) arena_alloc(&arena, 1);
+    assert(block == memory2 + ARENA_CHUNK_OVERHEAD);
+
+    /* A block too large for the remaining chunks fails, and the chunks are skipped. */
+    arena_reset(&arena);
+    block = (char*) arena_alloc(&arena, CHUNK_SIZE / 2);
+    assert(block == memory1 + ARENA_CHUNK_OVERHEAD);
+    assert(arena_alloc(&arena, CHUNK_SIZE / 2) == NULL);
+
+    /* The memory is never freed by the arena. */
+    arena_release(&arena);
+    assert(arena.head == NULL);
+    memset(memory1, 0, CHUNK_SIZE);
+    memset(memory2, 0, CHUNK_SIZE / 4);
+    free(memory1);
+    free(memory2);
+
+    /* The given chunks come before the allocated ones. */
+    memory1 = (char*) malloc(CHUNK_SIZE);
+    assert(memory1);
+    arena_init(&arena, CHUNK_SIZE, allocate_, deallocate_, &num_chunks);
+    arena_add_chunk(&arena, memory1, CHUNK_SIZE);
+    alloc_blocks_(NUM_BLOCKS);
+    assert(blocks[0] == memory1 + ARENA_CHUNK_OVERHEAD);
+    assert(num_chunks > 0);
+    assert_blocks_intact_(NUM_BLOCKS);
+    arena_release(&arena);
+    assert(num_chunks == 0);
+    free(memory1);
+}
+
+void test_arena_alloc(void) {
+    char *block;
+
+    alloc_blocks_(NUM_BLOCKS);
+    assert_blocks_intact_(NUM_BLOCKS);
+    assert(num_chunks > 1);
+
+    /* Consecutive blocks are contiguous within a chunk. */
+    arena_reset(&arena);
+    blocks[0] = (char*) arena_alloc(&arena, ARENA_ALIGNMENT);
+    blocks[1] = (char*) arena_alloc(&arena, 1);
+    blocks[2] = (char*) arena_alloc(&arena, ARENA_ALIGNMENT);
+    assert(blocks[1] == blocks[0] + ARENA_ALIGNMENT);
+    assert(blocks[2] == blocks[1] + ARENA_ALIGNMENT);
+
+    /* A block larger than the chunk size gets a chunk of its own. */
+    block = (char*) arena_alloc(&arena, 10 * CHUNK_SIZE);
+    assert(block);
+    assert(arena.current->size >= ARENA_CHUNK_OVERHEAD + 10 * CHUNK_SIZE);
+    memset(block, 0, 10 * CHUNK_SIZE);
+
+    /* Running out of memory returns NULL, and leaves the arena usable. */
+    arena_reset(&arena);
+    alloc_blocks_(NUM_BLOCKS);
+    fail_allocations = 1;
+    assert(arena_alloc(&arena, CHUNK_SIZE) == NULL);
+    fail_allocations = 0;
+    assert(arena_alloc(&arena, CHUNK_SIZE) != NULL);
+    assert_blocks_intact_(NUM_BLOCKS);
+}
+
+void test_arena_alloc_aligned(void) {
+    size_t alignment, i;
+    char *block;
+
+    for (alignment = 1; alignment <= 256; alignment *= 2) {
+        for (i = 0; i < 50; ++i) {
+            block = (char*) arena_alloc_aligned(&arena, i, alignment);
+            assert(block);
+            assert((size_t) block % alignment == 0);
+            memset(block, 0, i);
+        }
+    }
+
+    /* Small alignments pack blocks together. */
+    arena_reset(&arena);
+    blocks[0] = (char*) arena_alloc_aligned(&arena, 3, 1);
+    blocks[1] = (char*) arena_alloc_aligned(&arena, 3, 1);
+    blocks[2] = (char*) arena_alloc_aligned(&arena, 2, 4);
+    assert(blocks[1] == blocks[0] + 3);
+    assert(blocks[2] == blocks[1] + 5);
+
+    /* A large block with a large alignment fits in its own chunk. */
+    block = (char*) arena_alloc_aligned(&arena, 4 * CHUNK_SIZE, 4 * CHUNK_SIZE);
+    assert(block);
+    assert((size_t) block % (4 * CHUNK_SIZE) == 0);
+    memset(block, 0, 4 * CHUNK_SIZE);
+}
+
+void test_arena_alloc_zeroed(void) {
+    size_t i;
+    char *block;
+
+    /* Dirty the chunks first, so that the zeroes do not come from malloc(). */
+    alloc_blocks_(NUM_BLOCKS);
+    arena_reset(&arena);
+
+    for (i = 0; i < 20; ++i) {
+        block = (char*) arena_alloc_zeroed(&arena, i * 10);
+        assert(block);
+        assert((size_t) block % ARENA_ALIGNMENT == 0);
+        for (; block < arena.cursor; ++block) {
+            assert(*block == 0);
+        }
+    }
+
+    fail_allocations = 1;
+    assert(arena_alloc_zeroed(&arena, 10 * CHUNK_SIZE) == NULL);
+}
+
+void test_arena_mark(void) {
+    ArenaMark mark;
+
+    arena_mark(&arena, &mark);
+    assert(mark.chunk == NULL && mark.cursor == NULL && mark.size == 0);
+
+    alloc_blocks_(10);
+    arena_mark(&arena, &mark);
+    assert(mark.chunk == arena.current);
+    assert(mark.cursor == arena.cursor);
+    assert(mark.size == arena.size);
+}
+
+void test_arena_rewind(void) {
+    ArenaMark outer_mark, inner_mark;
+    size_t chunks_before;
+    char *block;
+
+    alloc_blocks_(10);
+    arena_mark(&arena, &outer_mark);
+    block = (char*) arena_alloc(&arena, 1);
+
+    /* Blocks allocated after the mark are reused, across chunks, and no chunk is freed. */
+    alloc_blocks_(NUM_BLOCKS);
+    chunks_before = num_chunks;
+    arena_rewind(&arena, &outer_mark);
+    assert(num_chunks == chunks_before);
+    assert(arena_alloc(&arena, 1) == block);
+    alloc_blocks_(NUM_BLOCKS);
+    assert(num_chunks == chunks_before);
+    assert_blocks_intact_(NUM_BLOCKS);
+
+    /* Marks nest. */
+    arena_rewind(&arena, &outer_mark);
+    arena_alloc(&arena, 100);
+    arena_mark(&arena, &inner_mark);
+    block = (char*) arena_alloc(&arena, 100);
+    alloc_blocks_(NUM_BLOCKS);
+    arena_rewind(&arena, &inner_mark);
+    assert(arena_alloc(&arena, 100) == block);
+    arena_rewind(&arena, &outer_mark);
+    assert(arena.size == outer_mark.size);
+    chunks_before = num_chunks;
+
+    /* A mark taken before anything was allocated rewinds to the first chunk. */
+    arena_reset(&arena);
+    arena_mark(&arena, &outer_mark);
+    block = (char*) arena_alloc(&arena, 1);
+    alloc_blocks_(NUM_BLOCKS);
+    arena_rewind(&arena, &outer_mark);
+    assert(arena.size == 0);
+    assert(arena_alloc(&arena, 1) == block);
+    assert(num_chunks == chunks_before);
+}
+
+void test_arena_reset(void) {
+    size_t chunks_before;
+    char *first_block;
+
+    /* Resetting an empty arena does nothing. */
+    arena_reset(&arena);
+    assert(arena.head == NULL && arena_size(&arena) == 0);
+
+    alloc_blocks_(NUM_BLOCKS);
+    first_block = blocks[0];
+    chunks_before = num_chunks;
+
+    arena_reset(&arena);
+    assert(arena_size(&arena) == 0);
+    assert(num_chunks == chunks_before);
+
+    /* The same memory is handed out again, without allocating chunks. */
+    alloc_blocks_(NUM_BLOCKS);
+    assert(blocks[0] == first_block);
+    assert(num_chunks == chunks_before);
+    assert_blocks_intact_(NUM_BLOCKS);
+}
+
+void test_arena_release(void) {
+    /* Releasing an empty arena does nothing. */
+    arena_release(&arena);
+    assert(arena.head == NULL);
+
+    alloc_blocks_(NUM_BLOCKS);
+    assert(num_chunks > 0);
+
+    arena_release(&arena);
+    assert(num_chunks == 0);
+    assert(arena.head == NULL && arena.current == NULL);
+    assert(arena.cursor == NULL && arena.limit == NULL);
+    assert(arena_size(&arena) == 0);
+    assert(arena.chunk_size == CHUNK_SIZE);
+
+    /* The arena can be used again. */
+    alloc_blocks_(NUM_BLOCKS);
+    assert_blocks_intact_(NUM_BLOCKS);
+}
+
+TestFunc test_funcs[] = {
+    test_arena_init,
+    test_arena_size,
+    test_arena_add_chunk,
+    test_arena_alloc,
+    test_arena_alloc_aligned,
+    test_arena_alloc_zeroed,
+    test_arena_mark,
+    test_arena_rewind,
+    test_arena_reset,
+    test_arena_release
+};
+
+int main(int argc, char *argv[]) {
+    char msg[100] = "Arena ";
+    assert(argc == 2);
+    strcat(msg, argv[1]);
+
+    assert(sizeof(test_funcs) / sizeof(TestFunc) == 10);
+    run_tests(test_funcs, sizeof(test_funcs) / sizeof(TestFunc), msg, reset_globals);
+
+    return 0;
+}
@@ -39,6 +39,9 @@ CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
 #define ASSERT_HASH_STRING(string, hashcode) \
     assert(hash_string(string) == hashcode##ul)
 
+#define ASSERT_HASH_STRING_SEEDED(string, seed_ptr, hashcode) \
+    assert(hash_string_seeded(string, seed_ptr) == hashcode##ul)
+
 
 static size_t mirror_hash_string(const char *str) {
     size_t hash = 5381;
@@ -65,7 +68,10 @@ void test_hashtable_compatibility(void) {
     HashTable hashtable;
     HashTableNode *bkt_arr[1];
 
+    HashStringSeed seed;
+
     hashtable_init(&hashtable, bkt_arr, 1, hash_string, dummy_equal_func, NULL, NULL);
+    hashtable_seed(&hashtable, hash_string_seeded, &seed);
 }
 
 void test_hash_string(void) {
@@ -97,9 +103,71 @@ void test_hash_string(void) {
     }
 }
 
+void test_hash_string_seeded(void) {
+    HashStringSeed seed, other_seed;
+    size_t counter, num_equal_hashes = 0;
+
+    seed.k0 = 0x0706050403020100ul;
+    seed.k1 = 0x0f0e0d0c0b0a0908ul;
+
+    ASSERT_HASH_STRING_SEEDED("", &seed, 12370263754033579228);
+    ASSERT_HASH_STRING_SEEDED("a", &seed, 2028475444892426807);
+    ASSERT_HASH_STRING_SEEDED("abcde", &seed, 6029444629434399096);
+    ASSERT_HASH_STRING_SEEDED("12abc12", &seed, 15285301132033321428);
+    ASSERT_HASH_STRING_SEEDED("asdfjkl;", &seed, 14095778990250402861);
+    ASSERT_HASH_STRING_SEEDED("content-type", &seed, 12613466607873568004);
+    ASSERT_HASH_STRING_SEEDED("qwertyuiopasdfghjkl;lkjhgfdsapoiuytrewqqwerty;;;", &seed, 2200833361515234713);
+
+    other_seed = seed;
+    other_seed.k1 ^= 1;
+
+    for (counter = 0; counter < 50000; ++counter) {
+        char str[100], cpy[100];
+        size_t i, len = (size_t) rand() % 99;
+
+        for (i = 0; i < len; ++i) {
+            str[i] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz;:[]{}-=_+!@#$^&*()~`"[rand() % 73];
+        }
+        str[len] = '\0';
+        strcpy(cpy, str);
+
+        /* Equal strings hash equally, and a different seed gives a different hash. */
+        assert(hash_string_seeded(str, &seed) == hash_string_seeded(cpy, &seed));
+        num_equal_hashes += hash_string_seeded(str, &seed) == hash_string_seeded(str, &other_seed);
+    }
+    assert(num_equal_hashes < 5);
+}
+
+void test_hash_string_long(void) {
+    static char buf[3000];
+    size_t counter;
+
+    for (counter = 0; counter < 2000; ++counter) {
+        size_t i, offset = (size_t) rand() % 32, len = (size_t) rand() % (sizeof(buf) - 32);
+
+        /* Every non-zero character value, including the ones with the high bit set. */
+        for (i = 0; i < len; ++i) {
+            buf[offset + i] = (char) (1 + rand() % 255);
+        }
+        buf[offset + len] = '\0';
+
+        assert(hash_string(buf + offset) == mirror_hash_string(buf + offset));
+    }
+
+    memset(buf, '\x80', sizeof(buf) - 1);
+    buf[sizeof(buf) - 1] = '\0';
+    assert(hash_string(buf) == mirror_hash_string(buf));
+    memset(buf, '\x7f', sizeof(buf) - 1);
+    assert(hash_string(buf) == mirror_hash_string(buf));
+    memset(buf, '\xff', sizeof(buf) - 1);
+    assert(hash_string(buf) == mirror_hash_string(buf));
+}
+
 TestFunc test_funcs[] = {
     test_hashtable_compatibility,
-    test_hash_string
+    test_hash_string,
+    test_hash_string_long,
+    test_hash_string_seeded
 };
 
 int main(int argc, char *argv[]) {
@@ -107,7 +175,7 @@ int main(int argc, char *argv[]) {
     assert(argc == 2);
     strcat(msg, argv[1]);
 
-    assert(sizeof(test_funcs) / sizeof(TestFunc) == 2);
+    assert(sizeof(test_funcs) / sizeof(TestFunc) == 4);
     run_tests(test_funcs, sizeof(test_funcs) / sizeof(TestFunc), msg, NULL);
 
     return 0;
@@ -0,0 +1,120 @@
+/*
+Copyright (c) 2017, Michael J Welsh
+
+Permission to use, copy, modify, and/or distribute this software
+for any purpose with or without fee is hereby granted, provided
+that the above copyright notice and this permission notice appear
+in all copies.
+
+THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL
+WARRANTIES WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE
+AUTHOR BE LIABLE FOR ANY SPECIAL, DIRECT, INDIRECT, OR
+CONSEQUENTIAL DAMAGES OR ANY DAMAGES WHATSOEVER RESULTING FROM
+LOSS OF USE, DATA OR PROFITS, WHETHER IN AN ACTION OF CONTRACT,
+NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF OR IN
+CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <stddef.h>
+#include <string.h>
+#include <stdarg.h>
+#include <assert.h>
+
+#include "testing_framework.h"
+#include "../src/hashtable.h"
+
+/* Test header guard. */
+#include "../src/hash_string.hpp"
+#include "../src/hash_string.hpp"
+
+/* ========================================================================================================
+ *
+ *                                             TESTING UTILITIES
+ *
+ * ======================================================================================================== */
+
+#define STATIC_ASSERT_HASH_STRING_CONSTEXPR(string, hashcode) \
+    static_assert(hash_string_constexpr(string) == hashcode##ul, string)
+
+typedef struct TestStruct {
+    const char *key;
+    HashTableNode node;
+} TestStruct;
+
+static int equal_func(const void *key, const HashTableNode *node) {
+    return strcmp((const char*) key, hashtable_entry(node, TestStruct, node)->key) == 0;
+}
+
+/* ========================================================================================================
+ *
+ *                                             TESTING FUNCTIONS
+ *
+ * ======================================================================================================== */
+
+void test_hash_string_constexpr(void) {
+    size_t counter;
+
+    STATIC_ASSERT_HASH_STRING_CONSTEXPR("", 5381);
+    STATIC_ASSERT_HASH_STRING_CONSTEXPR("abcde", 210706217108);
+    STATIC_ASSERT_HASH_STRING_CONSTEXPR("12abc12", 229395199025009);
+    STATIC_ASSERT_HASH_STRING_CONSTEXPR("asdfjkl;", 7572171320972735);
+    STATIC_ASSERT_HASH_STRING_CONSTEXPR("qwertyuiopasdfghjkl;lkjhgfdsapoiuytrewqqwerty;;;", 16245301107329722347);
+    STATIC_ASSERT_HASH_STRING_CONSTEXPR("1", 177622);
+    STATIC_ASSERT_HASH_STRING_CONSTEXPR("BADADASDADADSADFADF", 15974083569823714108);
+    STATIC_ASSERT_HASH_STRING_CONSTEXPR("send_help college_debt_high btc_addr_below:", 10862613210741622356);
+
+    assert(hash_string_constexpr("content-type") == hash_string("content-type"));
+    assert(hash_string_constexpr("\x80\xff\x7f high bits") == hash_string("\x80\xff\x7f high bits"));
+
+    for (counter = 0; counter < 5000; ++counter) {
+        char str[300];
+        size_t i;
+
+        for (i = 0; i < 299; ++i) {
+            str[i] = (char) (rand() % 256);
+        }
+        str[299] = '\0';
+
+        assert(hash_string_constexpr(str) == hash_string(str));
+    }
+}
+
+void test_hashtable_lookup_key_hashed_compatibility(void) {
+    static const char *keys[] = { "content-type", "content-length", "accept", "host", "user-agent" };
+    constexpr size_t content_type_hash = hash_string_constexpr("content-type");
+    constexpr size_t host_hash = hash_string_constexpr("host");
+    HashTable hashtable;
+    HashTableNode *bkt_arr[3];
+    TestStruct vars[5];
+    size_t i;
+
+    hashtable_init(&hashtable, bkt_arr, 3, hash_string, equal_func, NULL, NULL);
+
+    for (i = 0; i < 5; ++i) {
+        vars[i].key = keys[i];
+        hashtable_insert(&hashtable, vars[i].key, &vars[i].node);
+    }
+
+    assert(hashtable_lookup_key_hashed(&hashtable, "content-type", content_type_hash) == &vars[0].node);
+    assert(hashtable_lookup_key_hashed(&hashtable, "host", host_hash) == &vars[3].node);
+    assert(hashtable_lookup_key_hashed(&hashtable, "hosts", hash_string_constexpr("hosts")) == NULL);
+}
+
+TestFunc test_funcs[] = {
+    test_hash_string_constexpr,
+    test_hashtable_lookup_key_hashed_compatibility
+};
+
+int main(int argc, char *argv[]) {
+    char msg[100] = "hash_string.hpp ";
+    assert(argc == 2);
+    strcat(msg, argv[1]);
+
+    assert(sizeof(test_funcs) / sizeof(TestFunc) == 2);
+    run_tests(test_funcs, sizeof(test_funcs) / sizeof(TestFunc), msg, NULL);
+
+    return 0;
+}
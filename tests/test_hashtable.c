@@ -103,6 +103,9 @@ void *aux_ptr;
 #define HASHTABLE_REMOVE_KEY_BY_NODE(hashtable_ptr, node_ptr) \
     hashtable_remove_key(hashtable_ptr, &hashtable_entry(node_ptr, TestStruct, node)->key)
 
+#define HASHCODE(var) \
+    hashtable_hash_key(&hashtable, &(var).key)
+
 #define POISON_BUCKET_ARRAY() \
     do { \
         size_t i; \
@@ -236,6 +239,10 @@ static size_t hash_func(const void *key) {
     return 81 + k;
 }
 
+static size_t seeded_hash_func(const void *key, const void *seed) {
+    return (size_t) (*(const int*) key + *(const int*) seed);
+}
+
 static int equal_func(const void *key, const HashTableNode *node) {
     return *(const int*)key == hashtable_entry(node, TestStruct, node)->key;
 }
@@ -292,6 +299,8 @@ void test_hashtable_init(void) {
     assert(hashtable.bucket_array == bkt_arr);
     assert(hashtable.num_buckets == 3);
     assert(hashtable.hash == hash_func);
+    assert(hashtable.seeded_hash == NULL);
+    assert(hashtable.hash_seed == NULL);
     assert(hashtable.equal == equal_func);
     assert(hashtable.collide == collide_func);
     assert((void**) hashtable.auxiliary_data == &aux_ptr);
@@ -302,6 +311,8 @@ void test_hashtable_init(void) {
     assert(hashtable.bucket_array == bkt_arr);
     assert(hashtable.num_buckets == 3);
     assert(hashtable.hash == hash_func);
+    assert(hashtable.seeded_hash == NULL);
+    assert(hashtable.hash_seed == NULL);
     assert(hashtable.equal == equal_func);
     assert(hashtable.collide == NULL);
     assert(hashtable.auxiliary_data == NULL);
@@ -315,6 +326,8 @@ void test_hashtable_fast_init(void) {
     assert(hashtable.bucket_array == bkt_arr);
     assert(hashtable.num_buckets == 3);
     assert(hashtable.hash == hash_func);
+    assert(hashtable.seeded_hash == NULL);
+    assert(hashtable.hash_seed == NULL);
     assert(hashtable.equal == equal_func);
     assert(hashtable.collide == collide_func);
     assert((void**) hashtable.auxiliary_data == &aux_ptr);
@@ -325,11 +338,61 @@ void test_hashtable_fast_init(void) {
     assert(hashtable.bucket_array == bkt_arr);
     assert(hashtable.num_buckets == 3);
     assert(hashtable.hash == hash_func);
+    assert(hashtable.seeded_hash == NULL);
+    assert(hashtable.hash_seed == NULL);
     assert(hashtable.equal == equal_func);
     assert(hashtable.collide == NULL);
     assert(hashtable.auxiliary_data == NULL);
 }
 
+void test_hashtable_seed(void) {
+    HashTableNode *n;
+    int seed = 7;
+    size_t i;
+
+    hashtable_seed(&hashtable, seeded_hash_func, &seed);
+    assert(hashtable.seeded_hash == seeded_hash_func);
+    assert((const int*) hashtable.hash_seed == &seed);
+    assert(hashtable.hash == hash_func);
+
+    loop {
+        FILL_RANDOMLY(hashtable);
+        ASSERT_HASHTABLE(hashtable, 6);
+        assert(hashtable_lookup_key(&hashtable, &var1.key) == &var1.node);
+        assert(hashtable_lookup_key(&hashtable, &var2.key) == &var2.node);
+        assert(hashtable_lookup_key(&hashtable, &var3.key) == &var3.node);
+        assert(hashtable_lookup_key(&hashtable, &var4.key) == &var4.node);
+        assert(hashtable_lookup_key(&hashtable, &var5.key) == &var5.node);
+        assert(hashtable_lookup_key(&hashtable, &var6.key) == &var6.node);
+
+        /* Every node must be in the bucket chosen by the seeded hash. */
+        for (i = 0; i < 3; ++i) {
+            for (n = bkt_arr[i]; n; n = n->next) {
+                assert((size_t) (hashtable_entry(n, TestStruct, node)->key + seed) % 3 == i);
+            }
+        }
+
+        i = 0;
+        hashtable_for_each_possible(n, &var1.key, &hashtable) {
+            assert((hashtable_entry(n, TestStruct, node)->key + seed) % 3 == (var1.key + seed) % 3);
+            ++i;
+        }
+        assert(i == 2);
+
+        DRAIN_RANDOMLY(hashtable);
+        ASSERT_HASHTABLE(hashtable, 0);
+        ASSERT_BUCKET_ARRAY_NULLIFIED();
+    }
+
+    hashtable_seed(&hashtable, NULL, NULL);
+    assert(hashtable.seeded_hash == NULL);
+    assert(hashtable.hash_seed == NULL);
+    FILL_FOR_TESTING_FOR_EACH(hashtable);
+    assert(bkt_arr[0] == &var1.node);
+    assert(bkt_arr[1] == &var3.node);
+    assert(bkt_arr[2] == &var5.node);
+}
+
 void test_hashtable_bucket_array(void) {
     assert(hashtable_bucket_array(&hashtable) == bkt_arr);
     hashtable.bucket_array = NULL;
@@ -450,6 +513,53 @@ void test_hashtable_contains_key(void) {
     }
 }
 
+void test_hashtable_contains_key_hashed(void) {
+    assert(hashtable_contains_key_hashed(&hashtable, &var1.key, HASHCODE(var1)) == 0);
+
+    hashtable_insert(&hashtable, &var1.key, &var1.node);
+    assert(hashtable_contains_key_hashed(&hashtable, &var1.key, HASHCODE(var1)) == 1);
+    assert(hashtable_contains_key_hashed(&hashtable, &var1.key, HASHCODE(var3)) == 0);
+    hashtable_insert(&hashtable, &var3.key, &var3.node);
+    assert(hashtable_contains_key_hashed(&hashtable, &var3.key, HASHCODE(var3)) == 1);
+    HASHTABLE_REMOVE_KEY_BY_NODE(&hashtable, &var3.node);
+    assert(hashtable_contains_key_hashed(&hashtable, &var3.key, HASHCODE(var3)) == 0);
+    reset_globals();
+
+    loop {
+        FILL_RANDOMLY(hashtable);
+        assert(hashtable_contains_key_hashed(&hashtable, &var1.key, HASHCODE(var1)) == 1);
+        assert(hashtable_contains_key_hashed(&hashtable, &var2.key, HASHCODE(var2)) == 1);
+        assert(hashtable_contains_key_hashed(&hashtable, &var3.key, HASHCODE(var3)) == 1);
+        assert(hashtable_contains_key_hashed(&hashtable, &var4.key, HASHCODE(var4)) == 1);
+        assert(hashtable_contains_key_hashed(&hashtable, &var5.key, HASHCODE(var5)) == 1);
+        assert(hashtable_contains_key_hashed(&hashtable, &var6.key, HASHCODE(var6)) == 1);
+        DRAIN_RANDOMLY(hashtable);
+        assert(hashtable_contains_key_hashed(&hashtable, &var1.key, HASHCODE(var1)) == 0);
+        assert(hashtable_contains_key_hashed(&hashtable, &var2.key, HASHCODE(var2)) == 0);
+        assert(hashtable_contains_key_hashed(&hashtable, &var3.key, HASHCODE(var3)) == 0);
+        assert(hashtable_contains_key_hashed(&hashtable, &var4.key, HASHCODE(var4)) == 0);
+        assert(hashtable_contains_key_hashed(&hashtable, &var5.key, HASHCODE(var5)) == 0);
+        assert(hashtable_contains_key_hashed(&hashtable, &var6.key, HASHCODE(var6)) == 0);
+        reset_globals();
+    }
+}
+
+void test_hashtable_hash_key(void) {
+    int seed = 7;
+
+    assert(hashtable_hash_key(&hashtable, &var1.key) == 84);
+    assert(hashtable_hash_key(&hashtable, &var3.key) == 82);
+    assert(hashtable_hash_key(&hashtable, &var6.key) == 83);
+
+    hashtable_seed(&hashtable, seeded_hash_func, &seed);
+    assert(hashtable_hash_key(&hashtable, &var1.key) == 8);
+    assert(hashtable_hash_key(&hashtable, &var3.key) == 10);
+    assert(hashtable_hash_key(&hashtable, &var6.key) == 13);
+
+    hashtable_seed(&hashtable, NULL, NULL);
+    assert(hashtable_hash_key(&hashtable, &var1.key) == 84);
+}
+
 void test_hashtable_insert(void) {
     hashtable.collide = NULL;
     hashtable_insert(&hashtable, &var1.key, &var1.node);
@@ -559,6 +669,152 @@ void test_hashtable_insert(void) {
     }
 }
 
+void test_hashtable_insert_hashed(void) {
+    hashtable.collide = NULL;
+    hashtable_insert_hashed(&hashtable, &var1.key, HASHCODE(var1), &var1.node);
+    ASSERT_HASHTABLE(hashtable, 1);
+    ASSERT_NODE(var1.node, NULL);
+    hashtable_insert_hashed(&hashtable, &var2.key, HASHCODE(var2), &var2.node);
+    ASSERT_HASHTABLE(hashtable, 2);
+    ASSERT_NODE(var1.node, NULL);
+    ASSERT_NODE(var2.node, &var1.node);
+    hashtable_insert_hashed(&hashtable, &var3.key, HASHCODE(var3), &var3.node);
+    ASSERT_HASHTABLE(hashtable, 3);
+    ASSERT_NODE(var3.node, NULL);
+    assert(bkt_arr[0] == &var2.node);
+    assert(bkt_arr[1] == &var3.node);
+    assert(bkt_arr[2] == NULL);
+    reset_globals();
+
+    /* Key collision: the old node is replaced and collide is called. */
+    hashtable_insert_hashed(&hashtable, &var6.key, HASHCODE(var6), &var6.node);
+    hashtable_insert_hashed(&hashtable, &var5.key, HASHCODE(var5), &var5.node);
+    var3.key = var6.key;
+    hashtable_insert_hashed(&hashtable, &var3.key, HASHCODE(var3), &var3.node);
+    assert(var3.num_similar_keys == 1);
+    ASSERT_HASHTABLE(hashtable, 2);
+    ASSERT_NODE(var6.node, HASHTABLE_POISON_NEXT);
+    ASSERT_NODE(var5.node, &var3.node);
+    ASSERT_NODE(var3.node, NULL);
+    reset_globals();
+
+    /* The hashcode alone picks the bucket. */
+    hashtable_insert_hashed(&hashtable, &var1.key, HASHCODE(var5), &var1.node);
+    ASSERT_HASHTABLE(hashtable, 1);
+    assert(bkt_arr[2] == &var1.node);
+    assert(hashtable_lookup_key(&hashtable, &var1.key) == NULL);
+    assert(hashtable_lookup_key_hashed(&hashtable, &var1.key, HASHCODE(var5)) == &var1.node);
+    reset_globals();
+
+    loop {
+        hashtable_insert_hashed(&hashtable, &var1.key, HASHCODE(var1), &var1.node);
+        hashtable_insert_hashed(&hashtable, &var2.key, HASHCODE(var2), &var2.node);
+        hashtable_insert_hashed(&hashtable, &var3.key, HASHCODE(var3), &var3.node);
+        hashtable_insert_hashed(&hashtable, &var4.key, HASHCODE(var4), &var4.node);
+        hashtable_insert_hashed(&hashtable, &var5.key, HASHCODE(var5), &var5.node);
+        hashtable_insert_hashed(&hashtable, &var6.key, HASHCODE(var6), &var6.node);
+        ASSERT_HASHTABLE(hashtable, 6);
+        DRAIN_RANDOMLY(hashtable);
+        ASSERT_HASHTABLE(hashtable, 0);
+        reset_globals();
+    }
+}
+
+void test_hashtable_insert_unique(void) {
+    assert(hashtable_insert_unique(&hashtable, &var1.key, &var1.node) == NULL);
+    ASSERT_HASHTABLE(hashtable, 1);
+    ASSERT_NODE(var1.node, NULL);
+    assert(hashtable_insert_unique(&hashtable, &var2.key, &var2.node) == NULL);
+    ASSERT_HASHTABLE(hashtable, 2);
+    ASSERT_NODE(var2.node, &var1.node);
+    var4.key = var1.key;
+    assert(hashtable_insert_unique(&hashtable, &var4.key, &var4.node) == &var1.node);
+    ASSERT_HASHTABLE(hashtable, 2);
+    ASSERT_NODE(var1.node, NULL);
+    ASSERT_NODE(var2.node, &var1.node);
+    ASSERT_NODE(var4.node, HASHTABLE_POISON_NEXT);
+    assert(var4.num_similar_keys == 0);
+    assert(hashtable_insert_unique(&hashtable, &var2.key, &var2.node) == &var2.node);
+    ASSERT_HASHTABLE(hashtable, 2);
+    reset_globals();
+
+    loop {
+        FILL_RANDOMLY(hashtable);
+        assert(hashtable_insert_unique(&hashtable, &var1.key, &var2.node) == &var1.node);
+        assert(hashtable_insert_unique(&hashtable, &var3.key, &var4.node) == &var3.node);
+        assert(hashtable_insert_unique(&hashtable, &var6.key, &var5.node) == &var6.node);
+        ASSERT_HASHTABLE(hashtable, 6);
+        DRAIN_RANDOMLY(hashtable);
+        assert(hashtable_insert_unique(&hashtable, &var5.key, &var5.node) == NULL);
+        ASSERT_HASHTABLE(hashtable, 1);
+        reset_globals();
+    }
+}
+
+void test_hashtable_insert_unique_hashed(void) {
+    assert(hashtable_insert_unique_hashed(&hashtable, &var1.key, HASHCODE(var1), &var1.node) == NULL);
+    assert(hashtable_insert_unique_hashed(&hashtable, &var3.key, HASHCODE(var3), &var3.node) == NULL);
+    ASSERT_HASHTABLE(hashtable, 2);
+    var4.key = var1.key;
+    assert(hashtable_insert_unique_hashed(&hashtable, &var4.key, HASHCODE(var4), &var4.node) == &var1.node);
+    ASSERT_HASHTABLE(hashtable, 2);
+    ASSERT_NODE(var4.node, HASHTABLE_POISON_NEXT);
+
+    /* The hashcode alone picks the bucket, so the duplicate goes unnoticed in another bucket. */
+    assert(hashtable_insert_unique_hashed(&hashtable, &var4.key, HASHCODE(var5), &var4.node) == NULL);
+    ASSERT_HASHTABLE(hashtable, 3);
+    assert(bkt_arr[2] == &var4.node);
+    reset_globals();
+
+    loop {
+        FILL_RANDOMLY(hashtable);
+        assert(hashtable_insert_unique_hashed(&hashtable, &var2.key, HASHCODE(var2), &var1.node) == &var2.node);
+        assert(hashtable_insert_unique_hashed(&hashtable, &var5.key, HASHCODE(var5), &var6.node) == &var5.node);
+        ASSERT_HASHTABLE(hashtable, 6);
+        reset_globals();
+    }
+}
+
+void test_hashtable_insert_at_slot(void) {
+    HashTableNode **slot;
+
+    slot = hashtable_lookup_slot(&hashtable, &var1.key);
+    assert(slot == &bkt_arr[0] && *slot == NULL);
+    hashtable_insert_at_slot(&hashtable, slot, &var1.node);
+    ASSERT_HASHTABLE(hashtable, 1);
+    ASSERT_NODE(var1.node, NULL);
+    assert(bkt_arr[0] == &var1.node);
+
+    slot = hashtable_lookup_slot(&hashtable, &var2.key);
+    assert(slot == &var1.node.next && *slot == NULL);
+    hashtable_insert_at_slot(&hashtable, slot, &var2.node);
+    ASSERT_HASHTABLE(hashtable, 2);
+    ASSERT_NODE(var1.node, &var2.node);
+    ASSERT_NODE(var2.node, NULL);
+
+    slot = hashtable_lookup_slot_hashed(&hashtable, &var3.key, HASHCODE(var3));
+    assert(slot == &bkt_arr[1] && *slot == NULL);
+    hashtable_insert_at_slot(&hashtable, slot, &var3.node);
+    ASSERT_HASHTABLE(hashtable, 3);
+    assert(hashtable_lookup_key(&hashtable, &var3.key) == &var3.node);
+    reset_globals();
+
+    /* Find or create. */
+    loop {
+        FILL_RANDOMLY(hashtable);
+        DRAIN_RANDOMLY(hashtable);
+
+        slot = hashtable_lookup_slot(&hashtable, &var6.key);
+        if (!*slot) {
+            hashtable_insert_at_slot(&hashtable, slot, &var6.node);
+        }
+        slot = hashtable_lookup_slot(&hashtable, &var6.key);
+        assert(*slot == &var6.node);
+        ASSERT_HASHTABLE(hashtable, 1);
+        reset_globals();
+    }
+}
+
 void test_hashtable_lookup_key(void) {
     assert(hashtable_lookup_key(&hashtable, &var1.key) == NULL);
 
@@ -598,6 +854,76 @@ void test_hashtable_lookup_key(void) {
     }
 }
 
+void test_hashtable_lookup_key_hashed(void) {
+    assert(hashtable_lookup_key_hashed(&hashtable, &var1.key, hash_func(&var1.key)) == NULL);
+
+    loop {
+        FILL_RANDOMLY(hashtable);
+        assert(hashtable_lookup_key_hashed(&hashtable, &var1.key, hash_func(&var1.key)) == &var1.node);
+        assert(hashtable_lookup_key_hashed(&hashtable, &var2.key, hash_func(&var2.key)) == &var2.node);
+        assert(hashtable_lookup_key_hashed(&hashtable, &var3.key, hash_func(&var3.key)) == &var3.node);
+        assert(hashtable_lookup_key_hashed(&hashtable, &var4.key, hash_func(&var4.key)) == &var4.node);
+        assert(hashtable_lookup_key_hashed(&hashtable, &var5.key, hash_func(&var5.key)) == &var5.node);
+        assert(hashtable_lookup_key_hashed(&hashtable, &var6.key, hash_func(&var6.key)) == &var6.node);
+
+        /* The hashcode alone picks the bucket, even when it is not the key's real hashcode. */
+        assert(hashtable_lookup_key_hashed(&hashtable, &var1.key, hash_func(&var3.key)) == NULL);
+        assert(hashtable_lookup_key_hashed(&hashtable, &var3.key, hash_func(&var4.key)) == &var3.node);
+
+        DRAIN_RANDOMLY(hashtable);
+        assert(hashtable_lookup_key_hashed(&hashtable, &var1.key, hash_func(&var1.key)) == NULL);
+        assert(hashtable_lookup_key_hashed(&hashtable, &var6.key, hash_func(&var6.key)) == NULL);
+        reset_globals();
+    }
+}
+
+void test_hashtable_lookup_slot(void) {
+    HashTableNode **slot;
+
+    slot = hashtable_lookup_slot(&hashtable, &var1.key);
+    assert(slot == &bkt_arr[0] && *slot == NULL);
+
+    FILL_FOR_TESTING_FOR_EACH(hashtable);
+
+    slot = hashtable_lookup_slot(&hashtable, &var1.key);
+    assert(slot == &bkt_arr[0] && *slot == &var1.node);
+    slot = hashtable_lookup_slot(&hashtable, &var2.key);
+    assert(slot == &var1.node.next && *slot == &var2.node);
+    slot = hashtable_lookup_slot(&hashtable, &var4.key);
+    assert(slot == &var3.node.next && *slot == &var4.node);
+    HASHTABLE_REMOVE_KEY_BY_NODE(&hashtable, &var6.node);
+    slot = hashtable_lookup_slot(&hashtable, &var6.key);
+    assert(slot == &var5.node.next && *slot == NULL);
+    reset_globals();
+
+    loop {
+        FILL_RANDOMLY(hashtable);
+        assert(*hashtable_lookup_slot(&hashtable, &var1.key) == &var1.node);
+        assert(*hashtable_lookup_slot(&hashtable, &var2.key) == &var2.node);
+        assert(*hashtable_lookup_slot(&hashtable, &var3.key) == &var3.node);
+        assert(*hashtable_lookup_slot(&hashtable, &var4.key) == &var4.node);
+        assert(*hashtable_lookup_slot(&hashtable, &var5.key) == &var5.node);
+        assert(*hashtable_lookup_slot(&hashtable, &var6.key) == &var6.node);
+        DRAIN_RANDOMLY(hashtable);
+        assert(*hashtable_lookup_slot(&hashtable, &var1.key) == NULL);
+        assert(*hashtable_lookup_slot(&hashtable, &var6.key) == NULL);
+        reset_globals();
+    }
+}
+
+void test_hashtable_lookup_slot_hashed(void) {
+    HashTableNode **slot;
+
+    FILL_FOR_TESTING_FOR_EACH(hashtable);
+
+    slot = hashtable_lookup_slot_hashed(&hashtable, &var2.key, HASHCODE(var2));
+    assert(slot == &var1.node.next && *slot == &var2.node);
+    slot = hashtable_lookup_slot_hashed(&hashtable, &var5.key, HASHCODE(var5));
+    assert(slot == &bkt_arr[2] && *slot == &var5.node);
+    slot = hashtable_lookup_slot_hashed(&hashtable, &var5.key, HASHCODE(var3));
+    assert(slot == &var4.node.next && *slot == NULL);
+}
+
 void test_hashtable_remove_key(void) {
     hashtable_remove_key(&hashtable, &var1.key);
 
@@ -660,6 +986,45 @@ void test_hashtable_remove_key(void) {
     }
 }
 
+void test_hashtable_remove_key_hashed(void) {
+    hashtable_remove_key_hashed(&hashtable, &var1.key, HASHCODE(var1));
+
+    FILL_FOR_TESTING_FOR_EACH(hashtable);
+
+    /* A hashcode of another bucket finds nothing to remove. */
+    hashtable_remove_key_hashed(&hashtable, &var1.key, HASHCODE(var3));
+    ASSERT_HASHTABLE(hashtable, 6);
+
+    hashtable_remove_key_hashed(&hashtable, &var1.key, HASHCODE(var1));
+    ASSERT_HASHTABLE(hashtable, 5);
+    ASSERT_NODE(var1.node, HASHTABLE_POISON_NEXT);
+    assert(bkt_arr[0] == &var2.node);
+    hashtable_remove_key_hashed(&hashtable, &var4.key, HASHCODE(var4));
+    ASSERT_HASHTABLE(hashtable, 4);
+    ASSERT_NODE(var4.node, HASHTABLE_POISON_NEXT);
+    ASSERT_NODE(var3.node, NULL);
+    hashtable_remove_key_hashed(&hashtable, &var2.key, HASHCODE(var2));
+    hashtable_remove_key_hashed(&hashtable, &var3.key, HASHCODE(var3));
+    hashtable_remove_key_hashed(&hashtable, &var5.key, HASHCODE(var5));
+    hashtable_remove_key_hashed(&hashtable, &var6.key, HASHCODE(var6));
+    ASSERT_HASHTABLE(hashtable, 0);
+    ASSERT_BUCKET_ARRAY_NULLIFIED();
+    reset_globals();
+
+    loop {
+        FILL_RANDOMLY(hashtable);
+        hashtable_remove_key_hashed(&hashtable, &var3.key, HASHCODE(var3));
+        hashtable_remove_key_hashed(&hashtable, &var6.key, HASHCODE(var6));
+        hashtable_remove_key_hashed(&hashtable, &var1.key, HASHCODE(var1));
+        hashtable_remove_key_hashed(&hashtable, &var4.key, HASHCODE(var4));
+        hashtable_remove_key_hashed(&hashtable, &var2.key, HASHCODE(var2));
+        hashtable_remove_key_hashed(&hashtable, &var5.key, HASHCODE(var5));
+        ASSERT_HASHTABLE(hashtable, 0);
+        ASSERT_BUCKET_ARRAY_NULLIFIED();
+        reset_globals();
+    }
+}
+
 void test_hashtable_remove_all(void) {
     hashtable_remove_all(&hashtable);
     ASSERT_HASHTABLE(hashtable, 0);
@@ -711,6 +1076,24 @@ void test_hashtable_for_each(void) {
     assert(i == 6);
 }
 
+void test_hashtable_for_each_prefetch(void) {
+    HashTableNode *n;
+    size_t i, bkt;
+
+    hashtable_for_each_prefetch(n, bkt, &hashtable) {
+        assert(0);
+    }
+
+    FILL_FOR_TESTING_FOR_EACH(hashtable);
+
+    i = 0;
+    hashtable_for_each_prefetch(n, bkt, &hashtable) {
+        ASSERT_FOR_EACH(n, i);
+        ++i;
+    }
+    assert(i == 6);
+}
+
 void test_hashtable_for_each_safe(void) {
     HashTableNode *n, *backup;
     size_t i, bkt;
@@ -757,6 +1140,32 @@ void test_hashtable_for_each_possible(void) {
     assert(i == 6);
 }
 
+void test_hashtable_for_each_possible_hashed(void) {
+    HashTableNode *n;
+    size_t i;
+
+    hashtable_for_each_possible_hashed(n, HASHCODE(var1), &hashtable) {
+        assert(0);
+    }
+
+    FILL_FOR_TESTING_FOR_EACH(hashtable);
+
+    i = 0;
+    hashtable_for_each_possible_hashed(n, HASHCODE(var1), &hashtable) {
+        ASSERT_FOR_EACH(n, i);
+        ++i;
+    }
+    hashtable_for_each_possible_hashed(n, HASHCODE(var4), &hashtable) {
+        ASSERT_FOR_EACH(n, i);
+        ++i;
+    }
+    hashtable_for_each_possible_hashed(n, HASHCODE(var6), &hashtable) {
+        ASSERT_FOR_EACH(n, i);
+        ++i;
+    }
+    assert(i == 6);
+}
+
 void test_hashtable_for_each_possible_safe(void) {
     HashTableNode *n, *backup;
     size_t i;
@@ -789,23 +1198,69 @@ void test_hashtable_for_each_possible_safe(void) {
     assert(i == 6);
 }
 
+void test_hashtable_for_each_possible_safe_hashed(void) {
+    HashTableNode *n, *backup;
+    size_t i;
+
+    hashtable_for_each_possible_safe_hashed(n, backup, HASHCODE(var1), &hashtable) {
+        assert(0);
+    }
+
+    FILL_FOR_TESTING_FOR_EACH(hashtable);
+
+    i = 0;
+    hashtable_for_each_possible_safe_hashed(n, backup, HASHCODE(var1), &hashtable) {
+        ASSERT_FOR_EACH(n, i);
+        HASHTABLE_REMOVE_KEY_BY_NODE(&hashtable, n);
+        n = NULL;
+        ++i;
+    }
+    hashtable_for_each_possible_safe_hashed(n, backup, HASHCODE(var4), &hashtable) {
+        ASSERT_FOR_EACH(n, i);
+        HASHTABLE_REMOVE_KEY_BY_NODE(&hashtable, n);
+        n = NULL;
+        ++i;
+    }
+    hashtable_for_each_possible_safe_hashed(n, backup, HASHCODE(var6), &hashtable) {
+        ASSERT_FOR_EACH(n, i);
+        HASHTABLE_REMOVE_KEY_BY_NODE(&hashtable, n);
+        n = NULL;
+        ++i;
+    }
+    assert(i == 6);
+}
+
 TestFunc test_funcs[] = {
     test_hashtable_init,
     test_hashtable_fast_init,
+    test_hashtable_seed,
     test_hashtable_bucket_array,
     test_hashtable_num_buckets,
     test_hashtable_size,
     test_hashtable_empty,
     test_hashtable_contains_key,
+    test_hashtable_contains_key_hashed,
+    test_hashtable_hash_key,
     test_hashtable_insert,
+    test_hashtable_insert_hashed,
+    test_hashtable_insert_unique,
+    test_hashtable_insert_unique_hashed,
+    test_hashtable_insert_at_slot,
     test_hashtable_lookup_key,
+    test_hashtable_lookup_key_hashed,
+    test_hashtable_lookup_slot,
+    test_hashtable_lookup_slot_hashed,
     test_hashtable_remove_key,
+    test_hashtable_remove_key_hashed,
     test_hashtable_remove_all,
     test_hashtable_entry,
     test_hashtable_for_each,
+    test_hashtable_for_each_prefetch,
     test_hashtable_for_each_safe,
     test_hashtable_for_each_possible,
-    test_hashtable_for_each_possible_safe
+    test_hashtable_for_each_possible_hashed,
+    test_hashtable_for_each_possible_safe,
+    test_hashtable_for_each_possible_safe_hashed
 };
 
 int main(int argc, char *argv[]) {
@@ -813,7 +1268,7 @@ int main(int argc, char *argv[]) {
     assert(argc == 2);
     strcat(msg, argv[1]);
 
-    assert(sizeof(test_funcs) / sizeof(TestFunc) == 16);
+    assert(sizeof(test_funcs) / sizeof(TestFunc) == 30);
     run_tests(test_funcs, sizeof(test_funcs) / sizeof(TestFunc), msg, reset_globals);
 
     return 0;
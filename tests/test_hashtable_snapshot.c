@@ -0,0 +1,385 @@
+/*
+Copyright (c) 2017, Michael J Welsh
+
+Permission to use, copy, modify, and/or distribute this software
+for any purpose with or without fee is hereby granted, provided
+that the above copyright notice and this permission notice appear
+in all copies.
+
+THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL
+WARRANTIES WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE
+AUTHOR BE LIABLE FOR ANY SPECIAL, DIRECT, INDIRECT, OR
+CONSEQUENTIAL DAMAGES OR ANY DAMAGES WHATSOEVER RESULTING FROM
+LOSS OF USE, DATA OR PROFITS, WHETHER IN AN ACTION OF CONTRACT,
+NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF OR IN
+CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <stddef.h>
+#include <string.h>
+#include <assert.h>
+
+#include "testing_framework.h"
+
+/* Test header guard. */
+#include "../src/hashtable_snapshot.h"
+#include "../src/hashtable_snapshot.h"
+
+/* ========================================================================================================
+ *
+ *                                             TESTING UTILITIES
+ *
+ * ======================================================================================================== */
+
+#define NUM_OBJECTS 1000
+#define NUM_BUCKETS 97
+
+typedef struct TestStruct {
+    size_t key;
+    size_t val;
+    HashTableNode node;
+} TestStruct;
+
+HashTable hashtable, loaded;
+HashTableNode *bucket_array[NUM_BUCKETS], *loaded_bucket;
+TestStruct objects[NUM_OBJECTS];
+
+/* The snapshot of the hashtable, written by write_snapshot_. */
+void *snapshot;
+size_t snapshot_size;
+
+static size_t hash_(const void *key) {
+    return *(const size_t*) key;
+}
+
+/* Puts the keys in other buckets than hash_ does. */
+static size_t other_hash_(const void *key) {
+    return *(const size_t*) key * 3 + 1;
+}
+
+static int equal_(const void *key, const HashTableNode *node) {
+    return *(const size_t*) key == hashtable_entry(node, TestStruct, node)->key;
+}
+
+static const void* node_key_(const HashTableNode *node) {
+    return &hashtable_entry(node, TestStruct, node)->key;
+}
+
+/* Writes a snapshot of the hashtable into newly allocated memory. */
+static void write_snapshot_(void) {
+    free(snapshot);
+    snapshot_size = hashtable_snapshot_bytes(&hashtable, sizeof(TestStruct));
+    snapshot = malloc(snapshot_size);
+    assert(snapshot);
+    hashtable_snapshot_write(&hashtable, snapshot, sizeof(TestStruct), offsetof(TestStruct, node));
+}
+
+/* Returns the offset held by the "next" member of a node inside a snapshot that has not been loaded. */
+static size_t next_offset_(const HashTableNode *node) {
+    size_t offset;
+
+    memcpy(&offset, &node->next, sizeof(offset));
+    return offset;
+}
+
+/* Returns whether or not the node lies inside the snapshot. */
+static int in_snapshot_(const HashTableNode *node) {
+    const char *ptr = (const char*) node;
+
+    return ptr >= (const char*) snapshot && ptr < (const char*) snapshot + snapshot_size;
+}
+
+static void reset_globals(void) {
+    size_t i;
+
+    free(snapshot);
+    snapshot = NULL;
+    snapshot_size = 0;
+
+    hashtable_init(&hashtable, bucket_array, NUM_BUCKETS, hash_, equal_, NULL, NULL);
+    hashtable_init(&loaded, &loaded_bucket, 1, hash_, equal_, NULL, NULL);
+
+    for (i = 0; i < NUM_OBJECTS; ++i) {
+        objects[i].key = i * 7 + 3;
+        objects[i].val = i;
+        hashtable_insert(&hashtable, &objects[i].key, &objects[i].node);
+    }
+}
+
+/* ========================================================================================================
+ *
+ *                                             TESTING FUNCTIONS
+ *
+ * ======================================================================================================== */
+
+void test_hashtable_snapshot_bytes(void) {
+    size_t records_offset = sizeof(HashTableSnapshot) + NUM_BUCKETS * sizeof(size_t);
+
+    records_offset = (records_offset + HASHTABLE_SNAPSHOT_ALIGNMENT - 1) / HASHTABLE_SNAPSHOT_ALIGNMENT;
+    records_offset *= HASHTABLE_SNAPSHOT_ALIGNMENT;
+
+    assert(
+        hashtable_snapshot_bytes(&hashtable, sizeof(TestStruct)) ==
+        records_offset + NUM_OBJECTS * sizeof(TestStruct)
+    );
+    assert(
+        hashtable_snapshot_bytes(&hashtable, 2 * sizeof(TestStruct)) ==
+        records_offset + NUM_OBJECTS * 2 * sizeof(TestStruct)
+    );
+
+    hashtable_remove_all(&hashtable);
+    assert(hashtable_snapshot_bytes(&hashtable, sizeof(TestStruct)) == records_offset);
+}
+
+void test_hashtable_snapshot_write(void) {
+    const HashTableSnapshot *header;
+    const TestStruct *record;
+    const size_t *buckets;
+    size_t i, offset, expected, count = 0;
+
+    write_snapshot_();
+    header = (const HashTableSnapshot*) snapshot;
+    buckets = (const size_t*) (header + 1);
+
+    assert(header->magic == HASHTABLE_SNAPSHOT_MAGIC);
+    assert(header->snapshot_size == snapshot_size);
+    assert(header->record_size == sizeof(TestStruct));
+    assert(header->node_offset == offsetof(TestStruct, node));
+    assert(header->num_buckets == NUM_BUCKETS);
+    assert(header->size == NUM_OBJECTS);
+    assert(header->records_offset % HASHTABLE_SNAPSHOT_ALIGNMENT == 0);
+    assert(header->records_offset + NUM_OBJECTS * sizeof(TestStruct) == snapshot_size);
+
+    /* Every bucket is followed through offsets to consecutive copies of the objects, in bucket order. */
+    expected = header->records_offset + offsetof(TestStruct, node);
+    for (i = 0; i < NUM_BUCKETS; ++i) {
+        for (offset = buckets[i]; offset; offset = next_offset_(&record->node)) {
+            assert(offset == expected);
+            record = hashtable_entry((const HashTableNode*) ((char*) snapshot + offset), TestStruct, node);
+            assert(record->key % NUM_BUCKETS == i);
+            assert(record->key == objects[record->val].key);
+            expected += sizeof(TestStruct);
+            ++count;
+        }
+    }
+    assert(count == NUM_OBJECTS);
+
+    /* The hashtable is left untouched. */
+    assert(hashtable.size == NUM_OBJECTS);
+    for (i = 0; i < NUM_OBJECTS; ++i) {
+        assert(hashtable_lookup_key(&hashtable, &objects[i].key) == &objects[i].node);
+    }
+
+    /* An empty hashtable has no records. */
+    hashtable_remove_all(&hashtable);
+    write_snapshot_();
+    header = (const HashTableSnapshot*) snapshot;
+    buckets = (const size_t*) (header + 1);
+    assert(header->size == 0 && header->records_offset == snapshot_size);
+    for (i = 0; i < NUM_BUCKETS; ++i) {
+        assert(buckets[i] == 0);
+    }
+}
+
+void test_hashtable_snapshot_check(void) {
+    HashTableSnapshot *header;
+    HashTable other;
+    HashTableNode *other_bucket;
+    size_t *buckets, saved;
+    char *bigger;
+
+    write_snapshot_();
+    header = (HashTableSnapshot*) snapshot;
+    buckets = (size_t*) (header + 1);
+
+    assert(hashtable_snapshot_check(&loaded, snapshot, snapshot_size, NULL));
+    assert(hashtable_snapshot_check(&loaded, snapshot, snapshot_size, node_key_));
+
+    /* The memory may be larger than the snapshot (e.g. a file padded to a page), but not smaller. */
+    bigger = (char*) malloc(snapshot_size + 64);
+    memcpy(bigger, snapshot, snapshot_size);
+    assert(hashtable_snapshot_check(&loaded, bigger, snapshot_size + 64, node_key_));
+    free(bigger);
+    assert(!hashtable_snapshot_check(&loaded, snapshot, snapshot_size - 1, NULL));
+    assert(!hashtable_snapshot_check(&loaded, snapshot, sizeof(HashTableSnapshot) - 1, NULL));
+
+    /* A corrupted header. */
+    header->magic ^= 1;
+    assert(!hashtable_snapshot_check(&loaded, snapshot, snapshot_size, NULL));
+    header->magic ^= 1;
+    --header->size;
+    assert(!hashtable_snapshot_check(&loaded, snapshot, snapshot_size, NULL));
+    ++header->size;
+    header->record_size += sizeof(size_t);
+    assert(!hashtable_snapshot_check(&loaded, snapshot, snapshot_size, NULL));
+    header->record_size -= sizeof(size_t);
+    header->num_buckets = 0;
+    assert(!hashtable_snapshot_check(&loaded, snapshot, snapshot_size, NULL));
+    header->num_buckets = NUM_BUCKETS;
+    assert(hashtable_snapshot_check(&loaded, snapshot, snapshot_size, NULL));
+
+    /* A corrupted offset, e.g. one that would make a cycle. */
+    saved = buckets[NUM_BUCKETS - 1];
+    buckets[NUM_BUCKETS - 1] = buckets[0];
+    assert(!hashtable_snapshot_check(&loaded, snapshot, snapshot_size, NULL));
+    buckets[NUM_BUCKETS - 1] = 1;
+    assert(!hashtable_snapshot_check(&loaded, snapshot, snapshot_size, NULL));
+    buckets[NUM_BUCKETS - 1] = 0;
+    assert(!hashtable_snapshot_check(&loaded, snapshot, snapshot_size, NULL));
+    buckets[NUM_BUCKETS - 1] = saved;
+    assert(hashtable_snapshot_check(&loaded, snapshot, snapshot_size, node_key_));
+
+    /* A different hash function is only noticed through the node_key function. */
+    hashtable_init(&other, &other_bucket, 1, other_hash_, equal_, NULL, NULL);
+    assert(hashtable_snapshot_check(&other, snapshot, snapshot_size, NULL));
+    assert(!hashtable_snapshot_check(&other, snapshot, snapshot_size, node_key_));
+
+    /* A snapshot of an empty hashtable. */
+    hashtable_remove_all(&hashtable);
+    write_snapshot_();
+    assert(hashtable_snapshot_check(&loaded, snapshot, snapshot_size, node_key_));
+}
+
+void test_hashtable_snapshot_load(void) {
+    HashTableNode *n;
+    TestStruct extra;
+    char *copy;
+    size_t i, count = 0;
+
+    write_snapshot_();
+
+    /* A snapshot that fails the check is left untouched, and so is the hashtable. */
+    copy = (char*) malloc(snapshot_size);
+    memcpy(copy, snapshot, snapshot_size);
+    ((HashTableSnapshot*) snapshot)->size = 0;
+    assert(!hashtable_snapshot_load(&loaded, snapshot, snapshot_size, NULL));
+    ((HashTableSnapshot*) snapshot)->size = NUM_OBJECTS;
+    assert(memcmp(copy, snapshot, snapshot_size) == 0);
+    assert(loaded.bucket_array == &loaded_bucket && loaded.num_buckets == 1 && loaded.size == 0);
+    free(copy);
+
+    assert(hashtable_snapshot_load(&loaded, snapshot, snapshot_size, node_key_));
+    assert(loaded.num_buckets == NUM_BUCKETS);
+    assert(loaded.size == NUM_OBJECTS);
+    assert(loaded.hash == hash_ && loaded.equal == equal_);
+
+    hashtable_for_each(n, i, &loaded) {
+        assert(in_snapshot_(n));
+        assert(hashtable_entry(n, TestStruct, node)->key % NUM_BUCKETS == i);
+        ++count;
+    }
+    assert(count == NUM_OBJECTS);
+
+    for (i = 0; i < NUM_OBJECTS; ++i) {
+        n = hashtable_lookup_key(&loaded, &objects[i].key);
+        assert(n && in_snapshot_(n) && n != &objects[i].node);
+        assert(hashtable_entry(n, TestStruct, node)->val == i);
+    }
+
+    /* The loaded hashtable is an ordinary one. */
+    extra.key = 2;
+    extra.val = NUM_OBJECTS;
+    hashtable_insert(&loaded, &extra.key, &extra.node);
+    assert(hashtable_lookup_key(&loaded, &extra.key) == &extra.node);
+    hashtable_remove_key(&loaded, &objects[0].key);
+    assert(!hashtable_contains_key(&loaded, &objects[0].key));
+    assert(loaded.size == NUM_OBJECTS);
+
+    /* A loaded snapshot can not be loaded again. */
+    assert(!hashtable_snapshot_check(&loaded, snapshot, snapshot_size, NULL));
+    hashtable_init(&loaded, &loaded_bucket, 1, hash_, equal_, NULL, NULL);
+    assert(!hashtable_snapshot_load(&loaded, snapshot, snapshot_size, NULL));
+}
+
+void test_hashtable_snapshot_num_buckets(void) {
+    write_snapshot_();
+    assert(hashtable_snapshot_num_buckets(snapshot) == NUM_BUCKETS);
+
+    hashtable_init(&hashtable, bucket_array, 13, hash_, equal_, NULL, NULL);
+    write_snapshot_();
+    assert(hashtable_snapshot_num_buckets(snapshot) == 13);
+}
+
+void test_hashtable_snapshot_size(void) {
+    write_snapshot_();
+    assert(hashtable_snapshot_size(snapshot) == NUM_OBJECTS);
+
+    hashtable_remove_key(&hashtable, &objects[0].key);
+    write_snapshot_();
+    assert(hashtable_snapshot_size(snapshot) == NUM_OBJECTS - 1);
+
+    hashtable_remove_all(&hashtable);
+    write_snapshot_();
+    assert(hashtable_snapshot_size(snapshot) == 0);
+}
+
+void test_hashtable_snapshot_lookup_key(void) {
+    const HashTableNode *n;
+    size_t i, key;
+
+    write_snapshot_();
+    assert(hashtable_snapshot_check(&loaded, snapshot, snapshot_size, node_key_));
+
+    for (i = 0; i < NUM_OBJECTS; ++i) {
+        n = hashtable_snapshot_lookup_key(&loaded, snapshot, &objects[i].key);
+        assert(n && in_snapshot_(n));
+        assert(hashtable_entry(n, TestStruct, node)->key == objects[i].key);
+        assert(hashtable_entry(n, TestStruct, node)->val == i);
+    }
+
+    for (key = 0; key < 7 * NUM_OBJECTS; key += 7) {
+        assert(hashtable_snapshot_lookup_key(&loaded, snapshot, &key) == NULL);
+    }
+
+    /* The snapshot is not modified. */
+    assert(hashtable_snapshot_check(&loaded, snapshot, snapshot_size, node_key_));
+}
+
+void test_hashtable_snapshot_lookup_key_hashed(void) {
+    const HashTableNode *n;
+    size_t i, key = 0;
+
+    write_snapshot_();
+    assert(hashtable_snapshot_check(&loaded, snapshot, snapshot_size, NULL));
+
+    for (i = 0; i < NUM_OBJECTS; ++i) {
+        n = hashtable_snapshot_lookup_key_hashed(
+            &loaded,
+            snapshot,
+            &objects[i].key,
+            hashtable_hash_key(&loaded, &objects[i].key)
+        );
+        assert(n == hashtable_snapshot_lookup_key(&loaded, snapshot, &objects[i].key));
+        assert(hashtable_entry(n, TestStruct, node)->val == i);
+    }
+
+    n = hashtable_snapshot_lookup_key_hashed(&loaded, snapshot, &key, hashtable_hash_key(&loaded, &key));
+    assert(n == NULL);
+}
+
+TestFunc test_funcs[] = {
+    test_hashtable_snapshot_bytes,
+    test_hashtable_snapshot_write,
+    test_hashtable_snapshot_check,
+    test_hashtable_snapshot_load,
+    test_hashtable_snapshot_num_buckets,
+    test_hashtable_snapshot_size,
+    test_hashtable_snapshot_lookup_key,
+    test_hashtable_snapshot_lookup_key_hashed
+};
+
+int main(int argc, char *argv[]) {
+    char msg[100] = "HashTableSnapshot ";
+    assert(argc == 2);
+    strcat(msg, argv[1]);
+
+    assert(sizeof(test_funcs) / sizeof(TestFunc) == 8);
+    run_tests(test_funcs, sizeof(test_funcs) / sizeof(TestFunc), msg, reset_globals);
+
+    free(snapshot);
+
+    return 0;
+}
@@ -0,0 +1,318 @@
+/*
+Copyright (c) 2017, Michael J Welsh
+
+Permission to use, copy, modify, and/or distribute this software
+for any purpose with or without fee is hereby granted, provided
+that the above copyright notice and this permission notice appear
+in all copies.
+
+THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL
+WARRANTIES WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE
+AUTHOR BE LIABLE FOR ANY SPECIAL, DIRECT, INDIRECT, OR
+CONSEQUENTIAL DAMAGES OR ANY DAMAGES WHATSOEVER RESULTING FROM
+LOSS OF USE, DATA OR PROFITS, WHETHER IN AN ACTION OF CONTRACT,
+NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF OR IN
+CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <stddef.h>
+#include <string.h>
+#include <assert.h>
+
+#include "testing_framework.h"
+
+/* Test header guard. */
+#include "../src/heap.h"
+#include "../src/heap.h"
+
+/* ========================================================================================================
+ *
+ *                                             TESTING UTILITIES
+ *
+ * ======================================================================================================== */
+
+#define NUM_OBJECTS 1000
+
+typedef struct TestStruct {
+    int key;
+    HeapNode node;
+} TestStruct;
+
+TestStruct objects[NUM_OBJECTS];
+HeapNode *node_array[NUM_OBJECTS];
+HeapNode *other_array[NUM_OBJECTS];
+Heap heap;
+
+static int compare_func(const HeapNode *a, const HeapNode *b) {
+    return heap_entry(a, TestStruct, node)->key - heap_entry(b, TestStruct, node)->key;
+}
+
+/* Asserts that no @ref HeapNode has a smaller key than its parent, and that every index is right. */
+static void assert_heap_(void) {
+    size_t i;
+
+    for (i = 0; i < heap.size; ++i) {
+        assert(heap.nodes[i]->index == i);
+        if (i > 0) {
+            assert(compare_func(heap.nodes[(i - 1) / HEAP_ARITY], heap.nodes[i]) <= 0);
+        }
+    }
+}
+
+/* Pushes every object, with the keys in a scrambled order. */
+static void push_objects_(void) {
+    size_t i;
+
+    for (i = 0; i < NUM_OBJECTS; ++i) {
+        heap_push(&heap, &objects[i].node);
+    }
+}
+
+static void reset_globals(void) {
+    size_t i;
+
+    heap_init(&heap, node_array, NUM_OBJECTS, compare_func);
+
+    for (i = 0; i < NUM_OBJECTS; ++i) {
+        objects[i].key = (int) ((i * 7919) % NUM_OBJECTS);
+        objects[i].node.index = HEAP_POISON_INDEX;
+    }
+}
+
+/* ========================================================================================================
+ *
+ *                                             TESTING FUNCTIONS
+ *
+ * ======================================================================================================== */
+
+void test_heap_init(void) {
+    HeapNode node_init_with_macro = HEAP_NODE_INIT;
+
+    assert(node_init_with_macro.index == HEAP_POISON_INDEX);
+
+    heap_init(&heap, NULL, 0, compare_func);
+    assert(heap.nodes == NULL);
+    assert(heap.size == 0);
+    assert(heap.capacity == 0);
+    assert(heap.compare == compare_func);
+
+    heap_init(&heap, node_array, NUM_OBJECTS, compare_func);
+    assert(heap.nodes == node_array);
+    assert(heap.capacity == NUM_OBJECTS);
+}
+
+void test_heap_set_array(void) {
+    int key;
+
+    heap_init(&heap, node_array, 10, compare_func);
+    heap_push(&heap, &objects[0].node);
+    heap_push(&heap, &objects[1].node);
+    heap_push(&heap, &objects[2].node);
+
+    heap_set_array(&heap, other_array, NUM_OBJECTS);
+    assert(heap.nodes == other_array);
+    assert(heap_capacity(&heap) == NUM_OBJECTS);
+    assert(heap_size(&heap) == 3);
+    assert_heap_();
+
+    heap_remove_all(&heap);
+    push_objects_();
+    assert_heap_();
+    for (key = 0; key < NUM_OBJECTS; ++key) {
+        assert(heap_entry(heap_pop(&heap), TestStruct, node)->key == key);
+    }
+}
+
+void test_heap_peek(void) {
+    assert(heap_peek(&heap) == NULL);
+
+    heap_push(&heap, &objects[1].node);
+    assert(heap_peek(&heap) == &objects[1].node);
+    heap_push(&heap, &objects[0].node);
+    assert(heap_peek(&heap) == &objects[0].node);
+    heap_push(&heap, &objects[2].node);
+    assert(heap_peek(&heap) == &objects[0].node);
+}
+
+void test_heap_size(void) {
+    assert(heap_size(&heap) == 0);
+
+    push_objects_();
+    assert(heap_size(&heap) == NUM_OBJECTS);
+
+    heap_pop(&heap);
+    assert(heap_size(&heap) == NUM_OBJECTS - 1);
+}
+
+void test_heap_capacity(void) {
+    assert(heap_capacity(&heap) == NUM_OBJECTS);
+
+    heap_init(&heap, node_array, 5, compare_func);
+    assert(heap_capacity(&heap) == 5);
+}
+
+void test_heap_empty(void) {
+    assert(heap_empty(&heap));
+
+    heap_push(&heap, &objects[0].node);
+    assert(!heap_empty(&heap));
+
+    heap_pop(&heap);
+    assert(heap_empty(&heap));
+}
+
+void test_heap_push(void) {
+    size_t i;
+
+    heap_push(&heap, &objects[0].node);
+    assert(heap.nodes[0] == &objects[0].node);
+    assert(objects[0].node.index == 0);
+
+    for (i = 1; i < NUM_OBJECTS; ++i) {
+        heap_push(&heap, &objects[i].node);
+        assert(heap_size(&heap) == i + 1);
+        assert_heap_();
+    }
+    assert(heap_entry(heap_peek(&heap), TestStruct, node)->key == 0);
+
+    /* Equal keys. */
+    reset_globals();
+    for (i = 0; i < NUM_OBJECTS; ++i) {
+        objects[i].key = (int) (i % 3);
+    }
+    push_objects_();
+    assert_heap_();
+}
+
+void test_heap_update(void) {
+    size_t i;
+    int key;
+
+    push_objects_();
+
+    /* Decrease-key. */
+    objects[500].key = -1;
+    heap_update(&heap, &objects[500].node);
+    assert(heap_peek(&heap) == &objects[500].node);
+    assert_heap_();
+
+    /* Increase-key. */
+    objects[500].key = NUM_OBJECTS;
+    heap_update(&heap, &objects[500].node);
+    assert(heap.nodes[0] != &objects[500].node);
+    assert_heap_();
+
+    /* Unchanged key. */
+    heap_update(&heap, heap_peek(&heap));
+    assert_heap_();
+
+    for (i = 0; i < NUM_OBJECTS; ++i) {
+        objects[i].key = rand() % NUM_OBJECTS;
+        heap_update(&heap, &objects[i].node);
+        assert_heap_();
+    }
+
+    for (key = -1; !heap_empty(&heap); ) {
+        TestStruct *obj = heap_entry(heap_pop(&heap), TestStruct, node);
+
+        assert(obj->key >= key);
+        key = obj->key;
+    }
+}
+
+void test_heap_pop(void) {
+    int key;
+
+    assert(heap_pop(&heap) == NULL);
+
+    heap_push(&heap, &objects[0].node);
+    assert(heap_pop(&heap) == &objects[0].node);
+    assert(objects[0].node.index == HEAP_POISON_INDEX);
+    assert(heap_empty(&heap));
+
+    push_objects_();
+    for (key = 0; key < NUM_OBJECTS; ++key) {
+        TestStruct *obj = heap_entry(heap_pop(&heap), TestStruct, node);
+
+        assert(obj->key == key);
+        assert(obj->node.index == HEAP_POISON_INDEX);
+        assert_heap_();
+    }
+    assert(heap_pop(&heap) == NULL);
+}
+
+void test_heap_remove(void) {
+    size_t i;
+    int key;
+
+    push_objects_();
+
+    /* The last HeapNode, the top and then every odd key. */
+    heap_remove(&heap, heap.nodes[heap.size - 1]);
+    heap_remove(&heap, heap.nodes[0]);
+    assert(heap_size(&heap) == NUM_OBJECTS - 2);
+    assert_heap_();
+    for (i = 0; i < NUM_OBJECTS; ++i) {
+        if (objects[i].key % 2 == 1 && objects[i].node.index != HEAP_POISON_INDEX) {
+            heap_remove(&heap, &objects[i].node);
+            assert(objects[i].node.index == HEAP_POISON_INDEX);
+            assert_heap_();
+        }
+    }
+
+    for (key = 0; !heap_empty(&heap); ) {
+        TestStruct *obj = heap_entry(heap_pop(&heap), TestStruct, node);
+
+        assert(obj->key % 2 == 0 && obj->key >= key);
+        key = obj->key;
+    }
+}
+
+void test_heap_remove_all(void) {
+    size_t i;
+
+    heap_remove_all(&heap);
+    assert(heap_empty(&heap));
+
+    push_objects_();
+    heap_remove_all(&heap);
+    assert(heap_empty(&heap));
+    assert(heap_peek(&heap) == NULL);
+    for (i = 0; i < NUM_OBJECTS; ++i) {
+        assert(objects[i].node.index == HEAP_POISON_INDEX);
+    }
+}
+
+void test_heap_entry(void) {
+    assert(heap_entry(&objects[1].node, TestStruct, node) == &objects[1]);
+    assert(heap_entry(&objects[1].node, TestStruct, node)->key == 7919 % NUM_OBJECTS);
+}
+
+TestFunc test_funcs[] = {
+    test_heap_init,
+    test_heap_set_array,
+    test_heap_peek,
+    test_heap_size,
+    test_heap_capacity,
+    test_heap_empty,
+    test_heap_push,
+    test_heap_update,
+    test_heap_pop,
+    test_heap_remove,
+    test_heap_remove_all,
+    test_heap_entry
+};
+
+int main(int argc, char *argv[]) {
+    char msg[100] = "Heap ";
+    assert(argc == 2);
+    strcat(msg, argv[1]);
+
+    assert(sizeof(test_funcs) / sizeof(TestFunc) == 12);
+    run_tests(test_funcs, sizeof(test_funcs) / sizeof(TestFunc), msg, reset_globals);
+
+    return 0;
+}
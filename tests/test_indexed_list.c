@@ -0,0 +1,661 @@
+/*
+Copyright (c) 2017, Michael J Welsh
+
+Permission to use, copy, modify, and/or distribute this software
+for any purpose with or without fee is hereby granted, provided
+that the above copyright notice and this permission notice appear
+in all copies.
+
+THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL
+WARRANTIES WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE
+AUTHOR BE LIABLE FOR ANY SPECIAL, DIRECT, INDIRECT, OR
+CONSEQUENTIAL DAMAGES OR ANY DAMAGES WHATSOEVER RESULTING FROM
+LOSS OF USE, DATA OR PROFITS, WHETHER IN AN ACTION OF CONTRACT,
+NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF OR IN
+CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <stddef.h>
+#include <string.h>
+#include <stdarg.h>
+#include <assert.h>
+
+#include "testing_framework.h"
+
+/* Test header guard. */
+#include "../src/indexed_list.h"
+#include "../src/indexed_list.h"
+
+/* ========================================================================================================
+ *
+ *                                             TESTING UTILITIES
+ *
+ * ======================================================================================================== */
+
+#define NUM_BIG_VARS 1000
+
+typedef struct TestStruct {
+    int val;
+    IndexedListNode node;
+} TestStruct;
+
+TestStruct var1, var2, var3, var4, var5;
+TestStruct big_vars[NUM_BIG_VARS];
+IndexedListNode *model[NUM_BIG_VARS];
+IndexedList list, other_list;
+
+static size_t count_(const IndexedListNode *node) {
+    return node ? node->count : 0;
+}
+
+/* Checks the red-black properties, the parent links and the counts of the subtree; returns its black height. */
+static size_t check_subtree_(const IndexedListNode *node, const IndexedListNode *parent) {
+    size_t left_height, right_height;
+
+    if (!node) {
+        return 1;
+    }
+
+    assert(node->parent == parent);
+    assert(node->count == count_(node->left_child) + count_(node->right_child) + 1);
+
+    if (node->color == INDEXED_LIST_NODE_RED) {
+        assert(!node->left_child || node->left_child->color == INDEXED_LIST_NODE_BLACK);
+        assert(!node->right_child || node->right_child->color == INDEXED_LIST_NODE_BLACK);
+    }
+
+    left_height = check_subtree_(node->left_child, node);
+    right_height = check_subtree_(node->right_child, node);
+    assert(left_height == right_height);
+
+    return left_height + (node->color == INDEXED_LIST_NODE_BLACK);
+}
+
+#define ASSERT_PROPERTIES(list) \
+    do { \
+        assert(!(list).root || (list).root->color == INDEXED_LIST_NODE_BLACK); \
+        check_subtree_((list).root, NULL); \
+        assert((list).size == count_((list).root)); \
+    } while (0)
+
+/* Asserts the list holds exactly the given nodes in order, through every way of accessing them. */
+static void assert_order_(const IndexedList *l, size_t num_nodes, ...) {
+    const IndexedListNode *n;
+    va_list args;
+    size_t i;
+
+    ASSERT_PROPERTIES(*l);
+    assert(l->size == num_nodes);
+
+    va_start(args, num_nodes);
+    for (i = 0, n = indexed_list_front(l); i < num_nodes; ++i, n = indexed_list_next(n)) {
+        const IndexedListNode *expected = va_arg(args, const IndexedListNode*);
+
+        assert(n == expected);
+        assert(indexed_list_at(l, i) == expected);
+        assert(indexed_list_index_of(l, expected) == i);
+    }
+    va_end(args);
+
+    assert(n == NULL);
+}
+
+/* Asserts the list holds exactly the first num_nodes nodes of the model in order. */
+static void assert_matches_model_(const IndexedList *l, size_t num_nodes) {
+    size_t i;
+
+    ASSERT_PROPERTIES(*l);
+    assert(l->size == num_nodes);
+
+    for (i = 0; i < num_nodes; ++i) {
+        assert(indexed_list_at(l, i) == model[i]);
+        assert(indexed_list_index_of(l, model[i]) == i);
+        assert(indexed_list_next(model[i]) == (i + 1 < num_nodes ? model[i + 1] : NULL));
+    }
+}
+
+static void reset_globals(void) {
+    size_t i;
+
+    var1.val = 1;
+    var2.val = 2;
+    var3.val = 3;
+    var4.val = 4;
+    var5.val = 5;
+
+    for (i = 0; i < NUM_BIG_VARS; ++i) {
+        big_vars[i].val = (int) i;
+    }
+
+    indexed_list_init(&list);
+    indexed_list_init(&other_list);
+}
+
+/* ========================================================================================================
+ *
+ *                                             TESTING FUNCTIONS
+ *
+ * ======================================================================================================== */
+
+void test_indexed_list_init(void) {
+    list.root = &var1.node;
+    list.size = 100;
+    indexed_list_init(&list);
+    assert(list.root == NULL);
+    assert(list.size == 0);
+}
+
+void test_indexed_list_front(void) {
+    assert(indexed_list_front(&list) == NULL);
+    indexed_list_insert_back(&list, &var2.node);
+    assert(indexed_list_front(&list) == &var2.node);
+    indexed_list_insert_back(&list, &var3.node);
+    indexed_list_insert_front(&list, &var1.node);
+    assert(indexed_list_front(&list) == &var1.node);
+    indexed_list_remove(&list, &var1.node);
+    assert(indexed_list_front(&list) == &var2.node);
+}
+
+void test_indexed_list_back(void) {
+    assert(indexed_list_back(&list) == NULL);
+    indexed_list_insert_back(&list, &var2.node);
+    assert(indexed_list_back(&list) == &var2.node);
+    indexed_list_insert_front(&list, &var1.node);
+    indexed_list_insert_back(&list, &var3.node);
+    assert(indexed_list_back(&list) == &var3.node);
+    indexed_list_remove(&list, &var3.node);
+    assert(indexed_list_back(&list) == &var2.node);
+}
+
+void test_indexed_list_prev(void) {
+    size_t i;
+
+    assert(indexed_list_prev(NULL) == NULL);
+    indexed_list_insert_back(&list, &var1.node);
+    assert(indexed_list_prev(&var1.node) == NULL);
+
+    for (i = 0; i < NUM_BIG_VARS; ++i) {
+        indexed_list_insert_back(&list, &big_vars[i].node);
+    }
+    assert(indexed_list_prev(&big_vars[0].node) == &var1.node);
+    for (i = 1; i < NUM_BIG_VARS; ++i) {
+        assert(indexed_list_prev(&big_vars[i].node) == &big_vars[i - 1].node);
+    }
+}
+
+void test_indexed_list_next(void) {
+    size_t i;
+
+    assert(indexed_list_next(NULL) == NULL);
+    indexed_list_insert_back(&list, &var1.node);
+    assert(indexed_list_next(&var1.node) == NULL);
+
+    for (i = 0; i < NUM_BIG_VARS; ++i) {
+        indexed_list_insert_front(&list, &big_vars[i].node);
+    }
+    assert(indexed_list_next(&big_vars[0].node) == &var1.node);
+    for (i = 1; i < NUM_BIG_VARS; ++i) {
+        assert(indexed_list_next(&big_vars[i].node) == &big_vars[i - 1].node);
+    }
+}
+
+void test_indexed_list_size(void) {
+    assert(indexed_list_size(&list) == 0);
+    indexed_list_insert_back(&list, &var1.node);
+    assert(indexed_list_size(&list) == 1);
+    indexed_list_insert_back(&list, &var2.node);
+    assert(indexed_list_size(&list) == 2);
+    indexed_list_remove(&list, &var1.node);
+    assert(indexed_list_size(&list) == 1);
+}
+
+void test_indexed_list_empty(void) {
+    assert(indexed_list_empty(&list) == 1);
+    indexed_list_insert_back(&list, &var1.node);
+    assert(indexed_list_empty(&list) == 0);
+    indexed_list_remove(&list, &var1.node);
+    assert(indexed_list_empty(&list) == 1);
+}
+
+void test_indexed_list_index_of(void) {
+    size_t i;
+
+    indexed_list_insert_back(&list, &var1.node);
+    assert(indexed_list_index_of(&list, &var1.node) == 0);
+    indexed_list_insert_front(&list, &var2.node);
+    assert(indexed_list_index_of(&list, &var2.node) == 0);
+    assert(indexed_list_index_of(&list, &var1.node) == 1);
+
+    indexed_list_init(&list);
+    for (i = 0; i < NUM_BIG_VARS; ++i) {
+        indexed_list_insert_back(&list, &big_vars[i].node);
+    }
+    for (i = 0; i < NUM_BIG_VARS; ++i) {
+        assert(indexed_list_index_of(&list, &big_vars[i].node) == i);
+    }
+}
+
+void test_indexed_list_at(void) {
+    size_t i;
+
+    indexed_list_insert_back(&list, &var1.node);
+    assert(indexed_list_at(&list, 0) == &var1.node);
+    indexed_list_insert_front(&list, &var2.node);
+    assert(indexed_list_at(&list, 0) == &var2.node);
+    assert(indexed_list_at(&list, 1) == &var1.node);
+
+    indexed_list_init(&list);
+    for (i = 0; i < NUM_BIG_VARS; ++i) {
+        indexed_list_insert_front(&list, &big_vars[i].node);
+    }
+    for (i = 0; i < NUM_BIG_VARS; ++i) {
+        assert(indexed_list_at(&list, i) == &big_vars[NUM_BIG_VARS - 1 - i].node);
+    }
+}
+
+void test_indexed_list_insert_left(void) {
+    indexed_list_insert_left(&list, &var3.node, NULL);
+    assert_order_(&list, 1, &var3.node);
+    indexed_list_insert_left(&list, &var1.node, &var3.node);
+    assert_order_(&list, 2, &var1.node, &var3.node);
+    indexed_list_insert_left(&list, &var2.node, &var3.node);
+    assert_order_(&list, 3, &var1.node, &var2.node, &var3.node);
+    indexed_list_insert_left(&list, &var4.node, NULL);
+    assert_order_(&list, 4, &var4.node, &var1.node, &var2.node, &var3.node);
+    indexed_list_insert_left(&list, &var5.node, &var4.node);
+    assert_order_(&list, 5, &var5.node, &var4.node, &var1.node, &var2.node, &var3.node);
+}
+
+void test_indexed_list_insert_right(void) {
+    indexed_list_insert_right(&list, &var1.node, NULL);
+    assert_order_(&list, 1, &var1.node);
+    indexed_list_insert_right(&list, &var3.node, &var1.node);
+    assert_order_(&list, 2, &var1.node, &var3.node);
+    indexed_list_insert_right(&list, &var2.node, &var1.node);
+    assert_order_(&list, 3, &var1.node, &var2.node, &var3.node);
+    indexed_list_insert_right(&list, &var4.node, NULL);
+    assert_order_(&list, 4, &var1.node, &var2.node, &var3.node, &var4.node);
+    indexed_list_insert_right(&list, &var5.node, &var4.node);
+    assert_order_(&list, 5, &var1.node, &var2.node, &var3.node, &var4.node, &var5.node);
+}
+
+void test_indexed_list_insert_front(void) {
+    size_t i;
+
+    indexed_list_insert_front(&list, &var3.node);
+    assert_order_(&list, 1, &var3.node);
+    indexed_list_insert_front(&list, &var2.node);
+    indexed_list_insert_front(&list, &var1.node);
+    assert_order_(&list, 3, &var1.node, &var2.node, &var3.node);
+
+    indexed_list_init(&list);
+    for (i = 0; i < NUM_BIG_VARS; ++i) {
+        indexed_list_insert_front(&list, &big_vars[NUM_BIG_VARS - 1 - i].node);
+        model[NUM_BIG_VARS - 1 - i] = &big_vars[NUM_BIG_VARS - 1 - i].node;
+    }
+    assert_matches_model_(&list, NUM_BIG_VARS);
+}
+
+void test_indexed_list_insert_back(void) {
+    size_t i;
+
+    indexed_list_insert_back(&list, &var1.node);
+    assert_order_(&list, 1, &var1.node);
+    indexed_list_insert_back(&list, &var2.node);
+    indexed_list_insert_back(&list, &var3.node);
+    assert_order_(&list, 3, &var1.node, &var2.node, &var3.node);
+
+    indexed_list_init(&list);
+    for (i = 0; i < NUM_BIG_VARS; ++i) {
+        indexed_list_insert_back(&list, &big_vars[i].node);
+        model[i] = &big_vars[i].node;
+    }
+    assert_matches_model_(&list, NUM_BIG_VARS);
+}
+
+void test_indexed_list_insert_at(void) {
+    size_t i, j, index;
+
+    indexed_list_insert_at(&list, &var3.node, 0);
+    indexed_list_insert_at(&list, &var1.node, 0);
+    indexed_list_insert_at(&list, &var5.node, 2);
+    indexed_list_insert_at(&list, &var2.node, 1);
+    indexed_list_insert_at(&list, &var4.node, 3);
+    assert_order_(&list, 5, &var1.node, &var2.node, &var3.node, &var4.node, &var5.node);
+
+    indexed_list_init(&list);
+    for (i = 0; i < NUM_BIG_VARS; ++i) {
+        index = (size_t) rand() % (i + 1);
+        indexed_list_insert_at(&list, &big_vars[i].node, index);
+
+        for (j = i; j > index; --j) {
+            model[j] = model[j - 1];
+        }
+        model[index] = &big_vars[i].node;
+
+        if (i % 97 == 0) {
+            assert_matches_model_(&list, i + 1);
+        }
+    }
+    assert_matches_model_(&list, NUM_BIG_VARS);
+}
+
+void test_indexed_list_splice_left(void) {
+    indexed_list_splice_left(&list, &other_list, NULL);
+    assert_order_(&list, 0);
+
+    indexed_list_insert_back(&other_list, &var2.node);
+    indexed_list_insert_back(&other_list, &var3.node);
+    indexed_list_splice_left(&list, &other_list, NULL);
+    assert_order_(&list, 2, &var2.node, &var3.node);
+    assert_order_(&other_list, 0);
+
+    indexed_list_insert_back(&other_list, &var1.node);
+    indexed_list_splice_left(&list, &other_list, NULL);
+    assert_order_(&list, 3, &var1.node, &var2.node, &var3.node);
+
+    indexed_list_insert_back(&other_list, &var4.node);
+    indexed_list_insert_back(&other_list, &var5.node);
+    indexed_list_splice_left(&list, &other_list, &var3.node);
+    assert_order_(&list, 5, &var1.node, &var2.node, &var4.node, &var5.node, &var3.node);
+    assert_order_(&other_list, 0);
+}
+
+void test_indexed_list_splice_right(void) {
+    indexed_list_splice_right(&list, &other_list, NULL);
+    assert_order_(&list, 0);
+
+    indexed_list_insert_back(&other_list, &var1.node);
+    indexed_list_insert_back(&other_list, &var2.node);
+    indexed_list_splice_right(&list, &other_list, NULL);
+    assert_order_(&list, 2, &var1.node, &var2.node);
+    assert_order_(&other_list, 0);
+
+    indexed_list_insert_back(&other_list, &var3.node);
+    indexed_list_splice_right(&list, &other_list, NULL);
+    assert_order_(&list, 3, &var1.node, &var2.node, &var3.node);
+
+    indexed_list_insert_back(&other_list, &var4.node);
+    indexed_list_insert_back(&other_list, &var5.node);
+    indexed_list_splice_right(&list, &other_list, &var1.node);
+    assert_order_(&list, 5, &var1.node, &var4.node, &var5.node, &var2.node, &var3.node);
+    assert_order_(&other_list, 0);
+}
+
+void test_indexed_list_splice_front(void) {
+    size_t i;
+
+    indexed_list_splice_front(&list, &other_list);
+    assert_order_(&list, 0);
+
+    indexed_list_insert_back(&other_list, &var4.node);
+    indexed_list_insert_back(&other_list, &var5.node);
+    indexed_list_splice_front(&list, &other_list);
+    assert_order_(&list, 2, &var4.node, &var5.node);
+    assert_order_(&other_list, 0);
+
+    indexed_list_insert_back(&other_list, &var1.node);
+    indexed_list_insert_back(&other_list, &var2.node);
+    indexed_list_insert_back(&other_list, &var3.node);
+    indexed_list_splice_front(&list, &other_list);
+    assert_order_(&list, 5, &var1.node, &var2.node, &var3.node, &var4.node, &var5.node);
+    assert_order_(&other_list, 0);
+
+    indexed_list_init(&list);
+    for (i = 0; i < NUM_BIG_VARS; ++i) {
+        indexed_list_insert_back(i < NUM_BIG_VARS / 3 ? &other_list : &list, &big_vars[i].node);
+        model[i] = &big_vars[i].node;
+    }
+    indexed_list_splice_front(&list, &other_list);
+    assert_matches_model_(&list, NUM_BIG_VARS);
+    assert_order_(&other_list, 0);
+}
+
+void test_indexed_list_splice_back(void) {
+    size_t i;
+
+    indexed_list_splice_back(&list, &other_list);
+    assert_order_(&list, 0);
+
+    indexed_list_insert_back(&other_list, &var1.node);
+    indexed_list_insert_back(&other_list, &var2.node);
+    indexed_list_splice_back(&list, &other_list);
+    assert_order_(&list, 2, &var1.node, &var2.node);
+    assert_order_(&other_list, 0);
+
+    indexed_list_insert_back(&other_list, &var3.node);
+    indexed_list_insert_back(&other_list, &var4.node);
+    indexed_list_insert_back(&other_list, &var5.node);
+    indexed_list_splice_back(&list, &other_list);
+    assert_order_(&list, 5, &var1.node, &var2.node, &var3.node, &var4.node, &var5.node);
+    assert_order_(&other_list, 0);
+
+    indexed_list_init(&list);
+    for (i = 0; i < NUM_BIG_VARS; ++i) {
+        indexed_list_insert_back(i < NUM_BIG_VARS / 3 ? &list : &other_list, &big_vars[i].node);
+        model[i] = &big_vars[i].node;
+    }
+    indexed_list_splice_back(&list, &other_list);
+    assert_matches_model_(&list, NUM_BIG_VARS);
+    assert_order_(&other_list, 0);
+}
+
+void test_indexed_list_remove(void) {
+    size_t i, j, index;
+
+    indexed_list_remove(&list, NULL);
+    assert_order_(&list, 0);
+
+    indexed_list_insert_back(&list, &var1.node);
+    indexed_list_insert_back(&list, &var2.node);
+    indexed_list_insert_back(&list, &var3.node);
+    indexed_list_insert_back(&list, &var4.node);
+    indexed_list_insert_back(&list, &var5.node);
+    indexed_list_remove(&list, &var3.node);
+    assert_order_(&list, 4, &var1.node, &var2.node, &var4.node, &var5.node);
+    assert(var3.node.parent == INDEXED_LIST_POISON_PARENT);
+    assert(var3.node.left_child == INDEXED_LIST_POISON_LEFT_CHILD);
+    assert(var3.node.right_child == INDEXED_LIST_POISON_RIGHT_CHILD);
+    indexed_list_remove(&list, &var1.node);
+    indexed_list_remove(&list, &var5.node);
+    assert_order_(&list, 2, &var2.node, &var4.node);
+    indexed_list_remove(&list, &var2.node);
+    indexed_list_remove(&list, &var4.node);
+    assert_order_(&list, 0);
+
+    for (i = 0; i < NUM_BIG_VARS; ++i) {
+        indexed_list_insert_back(&list, &big_vars[i].node);
+        model[i] = &big_vars[i].node;
+    }
+    for (i = NUM_BIG_VARS; i > 0; --i) {
+        index = (size_t) rand() % i;
+        indexed_list_remove(&list, model[index]);
+
+        for (j = index; j + 1 < i; ++j) {
+            model[j] = model[j + 1];
+        }
+
+        if (i % 97 == 0) {
+            assert_matches_model_(&list, i - 1);
+        }
+    }
+    assert_order_(&list, 0);
+}
+
+void test_indexed_list_remove_front(void) {
+    indexed_list_remove_front(&list);
+    assert_order_(&list, 0);
+
+    indexed_list_insert_back(&list, &var1.node);
+    indexed_list_insert_back(&list, &var2.node);
+    indexed_list_insert_back(&list, &var3.node);
+    indexed_list_remove_front(&list);
+    assert_order_(&list, 2, &var2.node, &var3.node);
+    indexed_list_remove_front(&list);
+    assert_order_(&list, 1, &var3.node);
+    indexed_list_remove_front(&list);
+    assert_order_(&list, 0);
+}
+
+void test_indexed_list_remove_back(void) {
+    indexed_list_remove_back(&list);
+    assert_order_(&list, 0);
+
+    indexed_list_insert_back(&list, &var1.node);
+    indexed_list_insert_back(&list, &var2.node);
+    indexed_list_insert_back(&list, &var3.node);
+    indexed_list_remove_back(&list);
+    assert_order_(&list, 2, &var1.node, &var2.node);
+    indexed_list_remove_back(&list);
+    assert_order_(&list, 1, &var1.node);
+    indexed_list_remove_back(&list);
+    assert_order_(&list, 0);
+}
+
+void test_indexed_list_remove_all(void) {
+    IndexedListNode *root;
+
+    indexed_list_remove_all(&list);
+    assert_order_(&list, 0);
+
+    indexed_list_insert_back(&list, &var1.node);
+    indexed_list_insert_back(&list, &var2.node);
+    indexed_list_insert_back(&list, &var3.node);
+    root = list.root;
+    indexed_list_remove_all(&list);
+    assert_order_(&list, 0);
+    assert(root->parent == INDEXED_LIST_POISON_PARENT);
+    assert(root->left_child == INDEXED_LIST_POISON_LEFT_CHILD);
+    assert(root->right_child == INDEXED_LIST_POISON_RIGHT_CHILD);
+}
+
+void test_indexed_list_entry(void) {
+    TestStruct var = { 7, INDEXED_LIST_NODE_INIT };
+
+    assert(indexed_list_entry(&var1.node, TestStruct, node)->val == 1);
+    assert(indexed_list_entry(&var5.node, TestStruct, node) == &var5);
+    assert(indexed_list_entry(&var.node, TestStruct, node)->val == 7);
+    assert(indexed_list_entry(&var.node, TestStruct, node)->node.parent == INDEXED_LIST_POISON_PARENT);
+}
+
+void test_indexed_list_for_each(void) {
+    IndexedListNode *n;
+    size_t i = 0;
+
+    indexed_list_for_each(n, &list) {
+        assert(0);
+    }
+
+    for (i = 0; i < NUM_BIG_VARS; ++i) {
+        indexed_list_insert_back(&list, &big_vars[i].node);
+    }
+    i = 0;
+    indexed_list_for_each(n, &list) {
+        assert(indexed_list_entry(n, TestStruct, node)->val == (int) i);
+        ++i;
+    }
+    assert(i == NUM_BIG_VARS);
+}
+
+void test_indexed_list_for_each_reverse(void) {
+    IndexedListNode *n;
+    size_t i;
+
+    indexed_list_for_each_reverse(n, &list) {
+        assert(0);
+    }
+
+    for (i = 0; i < NUM_BIG_VARS; ++i) {
+        indexed_list_insert_back(&list, &big_vars[i].node);
+    }
+    indexed_list_for_each_reverse(n, &list) {
+        --i;
+        assert(indexed_list_entry(n, TestStruct, node)->val == (int) i);
+    }
+    assert(i == 0);
+}
+
+void test_indexed_list_for_each_safe(void) {
+    IndexedListNode *n, *backup;
+    size_t i = 0;
+
+    indexed_list_for_each_safe(n, backup, &list) {
+        assert(0);
+    }
+
+    for (i = 0; i < NUM_BIG_VARS; ++i) {
+        indexed_list_insert_back(&list, &big_vars[i].node);
+    }
+    i = 0;
+    indexed_list_for_each_safe(n, backup, &list) {
+        assert(indexed_list_entry(n, TestStruct, node)->val == (int) i);
+        indexed_list_remove(&list, n);
+        ++i;
+    }
+    assert(i == NUM_BIG_VARS);
+    assert_order_(&list, 0);
+}
+
+void test_indexed_list_for_each_safe_reverse(void) {
+    IndexedListNode *n, *backup;
+    size_t i;
+
+    indexed_list_for_each_safe_reverse(n, backup, &list) {
+        assert(0);
+    }
+
+    for (i = 0; i < NUM_BIG_VARS; ++i) {
+        indexed_list_insert_back(&list, &big_vars[i].node);
+    }
+    indexed_list_for_each_safe_reverse(n, backup, &list) {
+        --i;
+        assert(indexed_list_entry(n, TestStruct, node)->val == (int) i);
+        indexed_list_remove(&list, n);
+    }
+    assert(i == 0);
+    assert_order_(&list, 0);
+}
+
+TestFunc test_funcs[] = {
+    test_indexed_list_init,
+    test_indexed_list_front,
+    test_indexed_list_back,
+    test_indexed_list_prev,
+    test_indexed_list_next,
+    test_indexed_list_size,
+    test_indexed_list_empty,
+    test_indexed_list_index_of,
+    test_indexed_list_at,
+    test_indexed_list_insert_left,
+    test_indexed_list_insert_right,
+    test_indexed_list_insert_front,
+    test_indexed_list_insert_back,
+    test_indexed_list_insert_at,
+    test_indexed_list_splice_left,
+    test_indexed_list_splice_right,
+    test_indexed_list_splice_front,
+    test_indexed_list_splice_back,
+    test_indexed_list_remove,
+    test_indexed_list_remove_front,
+    test_indexed_list_remove_back,
+    test_indexed_list_remove_all,
+    test_indexed_list_entry,
+    test_indexed_list_for_each,
+    test_indexed_list_for_each_reverse,
+    test_indexed_list_for_each_safe,
+    test_indexed_list_for_each_safe_reverse
+};
+
+int main(int argc, char *argv[]) {
+    char msg[100] = "IndexedList ";
+    assert(argc == 2);
+    strcat(msg, argv[1]);
+
+    assert(sizeof(test_funcs) / sizeof(TestFunc) == 27);
+    run_tests(test_funcs, sizeof(test_funcs) / sizeof(TestFunc), msg, reset_globals);
+
+    return 0;
+}
@@ -16,6 +16,7 @@ NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF OR IN
 CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
 */
 
+#include <limits.h>
 #include <stdlib.h>
 #include <stdio.h>
 #include <stddef.h>
@@ -79,6 +80,96 @@ List list, other_list;
         } \
     } while (0)
 
+#define NUM_SORT_VARS 2000
+#define NUM_SORT_PATTERNS 7
+
+typedef struct SortStruct {
+    int val;
+    size_t id;
+    ListNode node;
+} SortStruct;
+
+SortStruct sort_vars[NUM_SORT_VARS];
+ListSortEntry sort_buffer[2 * NUM_SORT_VARS];
+ListSortTask sort_tasks[9];
+
+static int sort_cmp(const ListNode *a, const ListNode *b) {
+    return list_entry(a, SortStruct, node)->val - list_entry(b, SortStruct, node)->val;
+}
+
+/* Order-preserving keys for sort_cmp; stragglers can take vals slightly below zero. */
+static size_t sort_key(const ListNode *n) {
+    return (size_t) (list_entry(n, SortStruct, node)->val + 16);
+}
+
+/* Keys for sort_cmp that only differ in the two highest bytes. */
+static size_t sort_high_key(const ListNode *n) {
+    return sort_key(n) << (sizeof(size_t) * CHAR_BIT - 16);
+}
+
+/* A coarse key consistent with sort_cmp, leaving ties for sort_cmp to break. */
+static size_t sort_prefix_key(const ListNode *n) {
+    return sort_key(n) / 4;
+}
+
+/*
+ * Fills the empty list with the first num_vars sort_vars, numbered in insertion order, following a pattern:
+ * random with many duplicates, sorted, reversed, nearly sorted, sawtooth, late stragglers among duplicates, or
+ * all equal.
+ */
+static void fill_for_sorting(List *l, size_t num_vars, int pattern) {
+    size_t i;
+
+    for (i = 0; i < num_vars; ++i) {
+        switch (pattern) {
+            case 0:
+                sort_vars[i].val = rand() % 50;
+                break;
+            case 1:
+                sort_vars[i].val = (int) i;
+                break;
+            case 2:
+                sort_vars[i].val = (int) (num_vars - i);
+                break;
+            case 3:
+                sort_vars[i].val = (rand() % 20 == 0) ? rand() % (int) num_vars : (int) i;
+                break;
+            case 4:
+                sort_vars[i].val = (int) (i % 37);
+                break;
+            case 5:
+                sort_vars[i].val = (int) (i / 8) - ((rand() % 10 == 0) ? rand() % 4 : 0);
+                break;
+            default:
+                sort_vars[i].val = 7;
+        }
+        sort_vars[i].id = i;
+        list_insert_back(l, &sort_vars[i].node);
+    }
+}
+
+/* Asserts the list is well-formed, sorted by val, and that equal vals kept their insertion order. */
+static void assert_sorted_stable(const List *l, size_t num_vars) {
+    const ListNode *n, *prev = NULL;
+    size_t count = 0;
+
+    assert(l->size == num_vars);
+
+    for (n = l->head; n; prev = n, n = n->next) {
+        assert(n->prev == prev);
+
+        if (prev) {
+            const SortStruct *a = list_entry(prev, SortStruct, node), *b = list_entry(n, SortStruct, node);
+            assert(a->val < b->val || (a->val == b->val && a->id < b->id));
+        }
+
+        ++count;
+    }
+
+    assert(l->tail == prev);
+    assert(count == num_vars);
+}
+
 static void reset_globals(void) {
     list_init(&list);
     list_init(&other_list);
@@ -425,6 +516,208 @@ void test_list_sort(void) {
     ASSERT_NODE(var5.node, &var4cpy.node, NULL);
 }
 
+void test_list_sort_natural(void) {
+    TestStruct var4cpy = var4;
+    size_t num_vars;
+    int pattern;
+
+    list_sort_natural(&list, cmp);
+    ASSERT_LIST(list, NULL, NULL, 0);
+    list_insert_back(&list, &var1.node);
+    list_sort_natural(&list, cmp);
+    ASSERT_LIST(list, &var1.node, &var1.node, 1);
+    ASSERT_NODE(var1.node, NULL, NULL);
+    reset_globals();
+
+    list_insert_back(&list, &var2.node);
+    list_insert_back(&list, &var1.node);
+    list_insert_back(&list, &var5.node);
+    list_insert_back(&list, &var4.node);
+    list_insert_back(&list, &var4cpy.node);
+    list_insert_back(&list, &var3.node);
+    list_sort_natural(&list, cmp);
+    ASSERT_LIST(list, &var1.node, &var5.node, 6);
+    ASSERT_NODE(var1.node, NULL, &var2.node);
+    ASSERT_NODE(var2.node, &var1.node, &var3.node);
+    ASSERT_NODE(var3.node, &var2.node, &var4.node);
+    ASSERT_NODE(var4.node, &var3.node, &var4cpy.node);
+    ASSERT_NODE(var4cpy.node, &var4.node, &var5.node);
+    ASSERT_NODE(var5.node, &var4cpy.node, NULL);
+    list_sort_natural(&list, cmp);
+    ASSERT_LIST(list, &var1.node, &var5.node, 6);
+    ASSERT_NODE(var1.node, NULL, &var2.node);
+    ASSERT_NODE(var2.node, &var1.node, &var3.node);
+    ASSERT_NODE(var3.node, &var2.node, &var4.node);
+    ASSERT_NODE(var4.node, &var3.node, &var4cpy.node);
+    ASSERT_NODE(var4cpy.node, &var4.node, &var5.node);
+    ASSERT_NODE(var5.node, &var4cpy.node, NULL);
+
+    for (pattern = 0; pattern < NUM_SORT_PATTERNS; ++pattern) {
+        for (num_vars = 2; num_vars <= NUM_SORT_VARS; num_vars += 1 + num_vars / 3) {
+            list_init(&list);
+            fill_for_sorting(&list, num_vars, pattern);
+            list_sort_natural(&list, sort_cmp);
+            assert_sorted_stable(&list, num_vars);
+        }
+    }
+}
+
+void test_list_sort_buffered(void) {
+    TestStruct var4cpy = var4;
+    size_t num_vars;
+    int pattern;
+
+    list_sort_buffered(&list, sort_buffer, NULL, cmp);
+    ASSERT_LIST(list, NULL, NULL, 0);
+    list_insert_back(&list, &var1.node);
+    list_sort_buffered(&list, sort_buffer, NULL, cmp);
+    ASSERT_LIST(list, &var1.node, &var1.node, 1);
+    ASSERT_NODE(var1.node, NULL, NULL);
+    reset_globals();
+
+    list_insert_back(&list, &var2.node);
+    list_insert_back(&list, &var1.node);
+    list_insert_back(&list, &var5.node);
+    list_insert_back(&list, &var4.node);
+    list_insert_back(&list, &var4cpy.node);
+    list_insert_back(&list, &var3.node);
+    list_sort_buffered(&list, sort_buffer, NULL, cmp);
+    ASSERT_LIST(list, &var1.node, &var5.node, 6);
+    ASSERT_NODE(var1.node, NULL, &var2.node);
+    ASSERT_NODE(var2.node, &var1.node, &var3.node);
+    ASSERT_NODE(var3.node, &var2.node, &var4.node);
+    ASSERT_NODE(var4.node, &var3.node, &var4cpy.node);
+    ASSERT_NODE(var4cpy.node, &var4.node, &var5.node);
+    ASSERT_NODE(var5.node, &var4cpy.node, NULL);
+
+    for (pattern = 0; pattern < NUM_SORT_PATTERNS; ++pattern) {
+        for (num_vars = 2; num_vars <= NUM_SORT_VARS; num_vars += 1 + num_vars / 3) {
+            list_init(&list);
+            fill_for_sorting(&list, num_vars, pattern);
+            list_sort_buffered(&list, sort_buffer, NULL, sort_cmp);
+            assert_sorted_stable(&list, num_vars);
+
+            list_init(&list);
+            fill_for_sorting(&list, num_vars, pattern);
+            list_sort_buffered(&list, sort_buffer, sort_key, NULL);
+            assert_sorted_stable(&list, num_vars);
+
+            list_init(&list);
+            fill_for_sorting(&list, num_vars, pattern);
+            list_sort_buffered(&list, sort_buffer, sort_prefix_key, sort_cmp);
+            assert_sorted_stable(&list, num_vars);
+        }
+    }
+}
+
+static size_t key(const ListNode *n) {
+    return (size_t) list_entry(n, TestStruct, node)->val;
+}
+
+void test_list_sort_radix(void) {
+    TestStruct var4cpy = var4;
+    size_t num_vars;
+    int pattern;
+
+    list_sort_radix(&list, key);
+    ASSERT_LIST(list, NULL, NULL, 0);
+    list_insert_back(&list, &var1.node);
+    list_sort_radix(&list, key);
+    ASSERT_LIST(list, &var1.node, &var1.node, 1);
+    ASSERT_NODE(var1.node, NULL, NULL);
+    reset_globals();
+
+    list_insert_back(&list, &var2.node);
+    list_insert_back(&list, &var1.node);
+    list_insert_back(&list, &var5.node);
+    list_insert_back(&list, &var4.node);
+    list_insert_back(&list, &var4cpy.node);
+    list_insert_back(&list, &var3.node);
+    list_sort_radix(&list, key);
+    ASSERT_LIST(list, &var1.node, &var5.node, 6);
+    ASSERT_NODE(var1.node, NULL, &var2.node);
+    ASSERT_NODE(var2.node, &var1.node, &var3.node);
+    ASSERT_NODE(var3.node, &var2.node, &var4.node);
+    ASSERT_NODE(var4.node, &var3.node, &var4cpy.node);
+    ASSERT_NODE(var4cpy.node, &var4.node, &var5.node);
+    ASSERT_NODE(var5.node, &var4cpy.node, NULL);
+
+    for (pattern = 0; pattern < NUM_SORT_PATTERNS; ++pattern) {
+        for (num_vars = 2; num_vars <= NUM_SORT_VARS; num_vars += 1 + num_vars / 3) {
+            list_init(&list);
+            fill_for_sorting(&list, num_vars, pattern);
+            list_sort_radix(&list, sort_key);
+            assert_sorted_stable(&list, num_vars);
+
+            list_init(&list);
+            fill_for_sorting(&list, num_vars, pattern);
+            list_sort_radix(&list, sort_high_key);
+            assert_sorted_stable(&list, num_vars);
+        }
+    }
+}
+
+/* Runs the tasks last to first, counting the batches in the executor data. */
+static void reverse_execute(
+    void (*run)(ListSortTask *task),
+    ListSortTask *tasks,
+    size_t num_tasks,
+    void *executor_data
+) {
+    ++*(size_t*) executor_data;
+    while (num_tasks > 0) {
+        run(&tasks[--num_tasks]);
+    }
+}
+
+void test_list_sort_parallel(void) {
+    TestStruct var4cpy = var4;
+    size_t num_vars, num_tasks, num_batches = 0;
+    int pattern;
+
+    list_sort_parallel(&list, cmp, sort_tasks, 4, NULL, NULL);
+    ASSERT_LIST(list, NULL, NULL, 0);
+    list_insert_back(&list, &var1.node);
+    list_sort_parallel(&list, cmp, sort_tasks, 4, reverse_execute, &num_batches);
+    ASSERT_LIST(list, &var1.node, &var1.node, 1);
+    ASSERT_NODE(var1.node, NULL, NULL);
+    assert(num_batches == 0);
+    reset_globals();
+
+    list_insert_back(&list, &var2.node);
+    list_insert_back(&list, &var1.node);
+    list_insert_back(&list, &var5.node);
+    list_insert_back(&list, &var4.node);
+    list_insert_back(&list, &var4cpy.node);
+    list_insert_back(&list, &var3.node);
+    list_sort_parallel(&list, cmp, sort_tasks, 4, reverse_execute, &num_batches);
+    ASSERT_LIST(list, &var1.node, &var5.node, 6);
+    ASSERT_NODE(var1.node, NULL, &var2.node);
+    ASSERT_NODE(var2.node, &var1.node, &var3.node);
+    ASSERT_NODE(var3.node, &var2.node, &var4.node);
+    ASSERT_NODE(var4.node, &var3.node, &var4cpy.node);
+    ASSERT_NODE(var4cpy.node, &var4.node, &var5.node);
+    ASSERT_NODE(var5.node, &var4cpy.node, NULL);
+    /* One batch of sorts and two rounds of merges. */
+    assert(num_batches == 3);
+
+    for (pattern = 0; pattern < NUM_SORT_PATTERNS; ++pattern) {
+        for (num_vars = 2; num_vars <= NUM_SORT_VARS; num_vars += 1 + num_vars / 3) {
+            for (num_tasks = 1; num_tasks <= 9; num_tasks += 2) {
+                list_init(&list);
+                fill_for_sorting(&list, num_vars, pattern);
+                list_sort_parallel(&list, sort_cmp, sort_tasks, num_tasks, NULL, NULL);
+                assert_sorted_stable(&list, num_vars);
+
+                list_init(&list);
+                fill_for_sorting(&list, num_vars, pattern);
+                list_sort_parallel(&list, sort_cmp, sort_tasks, num_tasks, reverse_execute, &num_batches);
+                assert_sorted_stable(&list, num_vars);
+            }
+        }
+    }
+}
+
 void test_list_entry(void) {
     assert(list_entry(&var1.node, TestStruct, node)->val == 1);
     assert(list_entry(&var1.node, TestStruct, node)->node.prev == LIST_POISON_PREV);
@@ -473,6 +766,48 @@ void test_list_for_each_reverse(void) {
     assert(i == 0);
 }
 
+void test_list_for_each_prefetch(void) {
+    ListNode *n;
+    size_t i = 0;
+
+    list_for_each_prefetch(n, &list) {
+        assert(0);
+    }
+
+    list_insert_back(&list, &var1.node);
+    list_insert_back(&list, &var2.node);
+    list_insert_back(&list, &var3.node);
+    list_insert_back(&list, &var4.node);
+    list_insert_back(&list, &var5.node);
+
+    list_for_each_prefetch(n, &list) {
+        ASSERT_FOR_EACH(n, i);
+        ++i;
+    }
+    assert(i == 5);
+}
+
+void test_list_for_each_prefetch_reverse(void) {
+    ListNode *n;
+    size_t i = 5;
+
+    list_for_each_prefetch_reverse(n, &list) {
+        assert(0);
+    }
+
+    list_insert_back(&list, &var1.node);
+    list_insert_back(&list, &var2.node);
+    list_insert_back(&list, &var3.node);
+    list_insert_back(&list, &var4.node);
+    list_insert_back(&list, &var5.node);
+
+    list_for_each_prefetch_reverse(n, &list) {
+        --i;
+        ASSERT_FOR_EACH(n, i);
+    }
+    assert(i == 0);
+}
+
 void test_list_for_each_safe(void) {
     ListNode *n, *backup;
     size_t i = 0;
@@ -728,9 +1063,15 @@ TestFunc test_funcs[] = {
     test_list_cut,
     test_list_paste,
     test_list_sort,
+    test_list_sort_natural,
+    test_list_sort_buffered,
+    test_list_sort_radix,
+    test_list_sort_parallel,
     test_list_entry,
     test_list_for_each,
     test_list_for_each_reverse,
+    test_list_for_each_prefetch,
+    test_list_for_each_prefetch_reverse,
     test_list_for_each_safe,
     test_list_for_each_safe_reverse,
     test_list_for_each_after,
@@ -748,7 +1089,7 @@ int main(int argc, char *argv[]) {
     assert(argc == 2);
     strcat(msg, argv[1]);
 
-    assert(sizeof(test_funcs) / sizeof(TestFunc) == 37);
+    assert(sizeof(test_funcs) / sizeof(TestFunc) == 43);
     run_tests(test_funcs, sizeof(test_funcs) / sizeof(TestFunc), msg, reset_globals);
 
     return 0;
@@ -0,0 +1,501 @@
+/*
+Copyright (c) 2017, Michael J Welsh
+
+Permission to use, copy, modify, and/or distribute this software
+for any purpose with or without fee is hereby granted, provided
+that the above copyright notice and this permission notice appear
+in all copies.
+
+THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL
+WARRANTIES WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE
+AUTHOR BE LIABLE FOR ANY SPECIAL, DIRECT, INDIRECT, OR
+CONSEQUENTIAL DAMAGES OR ANY DAMAGES WHATSOEVER RESULTING FROM
+LOSS OF USE, DATA OR PROFITS, WHETHER IN AN ACTION OF CONTRACT,
+NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF OR IN
+CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <stddef.h>
+#include <string.h>
+#include <assert.h>
+
+#include "testing_framework.h"
+
+/* Test header guard. */
+#include "../src/managed_hashtable.h"
+#include "../src/managed_hashtable.h"
+
+/* ========================================================================================================
+ *
+ *                                             TESTING UTILITIES
+ *
+ * ======================================================================================================== */
+
+#define NUM_OBJECTS 1000
+
+typedef struct TestStruct {
+    size_t key;
+    size_t val;
+    HashTableNode node;
+} TestStruct;
+
+ManagedHashTable table;
+TestStruct objects[NUM_OBJECTS];
+size_t num_collisions;
+
+/* The bucket arrays currently allocated through the counting allocator, and whether it should fail. */
+size_t num_arrays;
+int fail_allocations;
+
+static size_t hash_(const void *key) {
+    return *(const size_t*) key;
+}
+
+static int equal_(const void *key, const HashTableNode *node) {
+    return *(const size_t*) key == hashtable_entry(node, TestStruct, node)->key;
+}
+
+static const void* node_key_(const HashTableNode *node) {
+    return &hashtable_entry(node, TestStruct, node)->key;
+}
+
+static void collide_(const HashTableNode *old_node, const HashTableNode *new_node, void *auxiliary_data) {
+    assert(old_node && new_node && old_node != new_node);
+    assert(auxiliary_data == &num_collisions);
+
+    ++num_collisions;
+}
+
+static void* allocate_(size_t size, void *allocator_data) {
+    assert(size > 0 && size % sizeof(HashTableNode*) == 0);
+    assert(allocator_data == &num_arrays);
+
+    if (fail_allocations) {
+        return NULL;
+    }
+
+    ++num_arrays;
+    return malloc(size);
+}
+
+static void deallocate_(void *ptr, size_t size, void *allocator_data) {
+    assert(ptr && size > 0 && size % sizeof(HashTableNode*) == 0);
+    assert(allocator_data == &num_arrays);
+
+    --num_arrays;
+    free(ptr);
+}
+
+/* Inserts the objects [begin, end) into the table. */
+static void insert_objects_(size_t begin, size_t end) {
+    size_t i;
+
+    for (i = begin; i < end; ++i) {
+        managed_hashtable_insert(&table, &objects[i].key, &objects[i].node);
+    }
+}
+
+/*
+ * Asserts that the table holds exactly the objects [begin, end), each in the bucket of its hashcode, and that
+ * the load factor is at most the maximum load factor.
+ */
+static void assert_table_holds_(size_t begin, size_t end) {
+    const HashTable *hashtable = &table.hashtable;
+    HashTableNode *n;
+    size_t i, count = 0;
+
+    assert(managed_hashtable_size(&table) == end - begin);
+
+    hashtable_for_each(n, i, hashtable) {
+        assert(hashtable_entry(n, TestStruct, node)->key % hashtable->num_buckets == i);
+        ++count;
+    }
+    assert(count == end - begin);
+
+    for (i = begin; i < end; ++i) {
+        assert(managed_hashtable_lookup_key(&table, &objects[i].key) == &objects[i].node);
+    }
+
+    assert(hashtable->size * 100 <= hashtable->num_buckets * table.max_load);
+}
+
+static void reset_globals(void) {
+    size_t i;
+
+    /* Free whatever the previous test left behind. */
+    managed_hashtable_remove_all(&table);
+    assert(num_arrays == 0);
+
+    for (i = 0; i < NUM_OBJECTS; ++i) {
+        objects[i].key = i * 7 + 3;
+        objects[i].val = i;
+        objects[i].node.next = HASHTABLE_POISON_NEXT;
+    }
+
+    num_collisions = 0;
+    fail_allocations = 0;
+    managed_hashtable_init(&table, hash_, equal_, node_key_, collide_, &num_collisions);
+    managed_hashtable_set_allocator(&table, allocate_, deallocate_, &num_arrays);
+}
+
+/* ========================================================================================================
+ *
+ *                                             TESTING FUNCTIONS
+ *
+ * ======================================================================================================== */
+
+void test_managed_hashtable_init(void) {
+    ManagedHashTable other_table;
+
+    managed_hashtable_init(&other_table, hash_, equal_, node_key_, NULL, NULL);
+    assert(other_table.hashtable.bucket_array == &other_table.empty_bucket);
+    assert(other_table.empty_bucket == NULL);
+    assert(other_table.hashtable.num_buckets == 1);
+    assert(other_table.hashtable.size == 0);
+    assert(other_table.hashtable.hash == hash_ && other_table.hashtable.equal == equal_);
+    assert(other_table.hashtable.collide == NULL);
+    assert(other_table.node_key == node_key_);
+    assert(other_table.allocate == NULL && other_table.deallocate == NULL);
+    assert(other_table.max_load == MANAGED_HASHTABLE_MAX_LOAD);
+    assert(other_table.min_load == MANAGED_HASHTABLE_MIN_LOAD);
+
+    /* Lookups work before anything is inserted. */
+    assert(managed_hashtable_lookup_key(&other_table, &objects[0].key) == NULL);
+
+    /* Without an allocator, malloc() and free() are used. */
+    managed_hashtable_insert(&other_table, &objects[0].key, &objects[0].node);
+    assert(other_table.hashtable.bucket_array != &other_table.empty_bucket);
+    assert(other_table.hashtable.num_buckets == MANAGED_HASHTABLE_MIN_BUCKETS);
+    managed_hashtable_remove_all(&other_table);
+    assert(other_table.hashtable.bucket_array == &other_table.empty_bucket);
+}
+
+void test_managed_hashtable_set_allocator(void) {
+    assert(table.allocate == allocate_ && table.deallocate == deallocate_);
+    assert(table.allocator_data == &num_arrays);
+
+    insert_objects_(0, 1);
+    assert(num_arrays == 1);
+
+    /* A bucket array left over from removals is freed with the old allocator. */
+    managed_hashtable_remove_key(&table, &objects[0].key);
+    assert(num_arrays == 1);
+    managed_hashtable_set_allocator(&table, NULL, NULL, NULL);
+    assert(num_arrays == 0);
+    assert(table.allocate == NULL && table.deallocate == NULL && table.allocator_data == NULL);
+
+    insert_objects_(0, NUM_OBJECTS);
+    assert(num_arrays == 0);
+    assert_table_holds_(0, NUM_OBJECTS);
+    managed_hashtable_remove_all(&table);
+}
+
+void test_managed_hashtable_set_load_factors(void) {
+    managed_hashtable_set_load_factors(&table, 400, 100);
+    assert(table.max_load == 400 && table.min_load == 100);
+
+    insert_objects_(0, NUM_OBJECTS);
+    assert_table_holds_(0, NUM_OBJECTS);
+    assert(table.hashtable.num_buckets * 4 >= NUM_OBJECTS && table.hashtable.num_buckets * 2 < NUM_OBJECTS);
+
+    /* A lower maximum load factor makes the table grow further on the next insertion. */
+    managed_hashtable_set_load_factors(&table, 50, 0);
+    managed_hashtable_remove_key(&table, &objects[0].key);
+    insert_objects_(0, 1);
+    assert_table_holds_(0, NUM_OBJECTS);
+    assert(table.hashtable.num_buckets >= 2 * NUM_OBJECTS);
+
+    /* Without a minimum load factor, the table never shrinks. */
+    managed_hashtable_remove_all(&table);
+    insert_objects_(0, NUM_OBJECTS);
+    for (; table.hashtable.size > 1;) {
+        managed_hashtable_remove_key(&table, &objects[table.hashtable.size - 1].key);
+    }
+    assert(table.hashtable.num_buckets >= 2 * NUM_OBJECTS);
+    assert_table_holds_(0, 1);
+}
+
+void test_managed_hashtable_hashtable(void) {
+    HashTable *hashtable = managed_hashtable_hashtable(&table);
+    HashTableNode *n;
+    size_t i, count = 0;
+
+    assert(hashtable == &table.hashtable);
+
+    insert_objects_(0, NUM_OBJECTS);
+    hashtable_for_each(n, i, hashtable) {
+        ++count;
+    }
+    assert(count == NUM_OBJECTS);
+    assert(hashtable_lookup_key(hashtable, &objects[10].key) == &objects[10].node);
+    assert(hashtable_size(hashtable) == NUM_OBJECTS);
+}
+
+void test_managed_hashtable_num_buckets(void) {
+    assert(managed_hashtable_num_buckets(&table) == 1);
+    insert_objects_(0, 1);
+    assert(managed_hashtable_num_buckets(&table) == MANAGED_HASHTABLE_MIN_BUCKETS);
+    insert_objects_(1, NUM_OBJECTS);
+    assert(managed_hashtable_num_buckets(&table) == table.hashtable.num_buckets);
+    assert(managed_hashtable_num_buckets(&table) * MANAGED_HASHTABLE_MAX_LOAD >= NUM_OBJECTS * 100);
+}
+
+void test_managed_hashtable_size(void) {
+    assert(managed_hashtable_size(&table) == 0);
+    insert_objects_(0, NUM_OBJECTS);
+    assert(managed_hashtable_size(&table) == NUM_OBJECTS);
+    managed_hashtable_remove_key(&table, &objects[0].key);
+    assert(managed_hashtable_size(&table) == NUM_OBJECTS - 1);
+    managed_hashtable_remove_all(&table);
+    assert(managed_hashtable_size(&table) == 0);
+}
+
+void test_managed_hashtable_empty(void) {
+    assert(managed_hashtable_empty(&table));
+    insert_objects_(0, 1);
+    assert(!managed_hashtable_empty(&table));
+    managed_hashtable_remove_key(&table, &objects[0].key);
+    assert(managed_hashtable_empty(&table));
+}
+
+void test_managed_hashtable_contains_key(void) {
+    size_t missing_key = 1;
+
+    assert(!managed_hashtable_contains_key(&table, &objects[0].key));
+    insert_objects_(0, NUM_OBJECTS);
+    assert(managed_hashtable_contains_key(&table, &objects[0].key));
+    assert(managed_hashtable_contains_key(&table, &objects[NUM_OBJECTS - 1].key));
+    assert(!managed_hashtable_contains_key(&table, &missing_key));
+}
+
+void test_managed_hashtable_reserve(void) {
+    size_t num_buckets;
+
+    assert(managed_hashtable_reserve(&table, NUM_OBJECTS));
+    assert(num_arrays == 1);
+    num_buckets = table.hashtable.num_buckets;
+    assert(num_buckets * MANAGED_HASHTABLE_MAX_LOAD >= NUM_OBJECTS * 100);
+
+    /* No resizing happens while inserting the reserved number of nodes. */
+    insert_objects_(0, NUM_OBJECTS);
+    assert(table.hashtable.num_buckets == num_buckets);
+    assert_table_holds_(0, NUM_OBJECTS);
+
+    /* Reserving less than the current capacity does nothing. */
+    assert(managed_hashtable_reserve(&table, 1));
+    assert(table.hashtable.num_buckets == num_buckets);
+
+    /* A failed reservation leaves the table untouched. */
+    fail_allocations = 1;
+    assert(!managed_hashtable_reserve(&table, 10 * NUM_OBJECTS));
+    assert(table.hashtable.num_buckets == num_buckets);
+    assert_table_holds_(0, NUM_OBJECTS);
+}
+
+void test_managed_hashtable_rehash(void) {
+    insert_objects_(0, NUM_OBJECTS);
+
+    /* Rehashing ignores the load factors. */
+    assert(managed_hashtable_rehash(&table, 7));
+    assert(table.hashtable.num_buckets == 7);
+    assert(num_arrays == 1);
+    assert(managed_hashtable_size(&table) == NUM_OBJECTS);
+    assert(managed_hashtable_lookup_key(&table, &objects[500].key) == &objects[500].node);
+
+    assert(managed_hashtable_rehash(&table, 4099));
+    assert(table.hashtable.num_buckets == 4099);
+    assert(num_arrays == 1);
+    assert_table_holds_(0, NUM_OBJECTS);
+
+    fail_allocations = 1;
+    assert(!managed_hashtable_rehash(&table, 100));
+    assert(table.hashtable.num_buckets == 4099);
+    assert_table_holds_(0, NUM_OBJECTS);
+}
+
+void test_managed_hashtable_insert(void) {
+    TestStruct duplicate;
+    size_t i, num_used_buckets, num_buckets;
+
+    /* The bucket array grows with the table, and is never much larger than needed. */
+    for (i = 0; i < NUM_OBJECTS; ++i) {
+        insert_objects_(i, i + 1);
+        assert(table.hashtable.num_buckets * MANAGED_HASHTABLE_MAX_LOAD >= (i + 1) * 100);
+        assert(table.hashtable.num_buckets * MANAGED_HASHTABLE_MAX_LOAD < 3 * (i + 1) * 100 ||
+            table.hashtable.num_buckets == MANAGED_HASHTABLE_MIN_BUCKETS);
+    }
+    assert_table_holds_(0, NUM_OBJECTS);
+    assert(num_arrays == 1);
+
+    /* Inserting an existing key replaces the node and calls collide. */
+    duplicate.key = objects[10].key;
+    managed_hashtable_insert(&table, &duplicate.key, &duplicate.node);
+    assert(num_collisions == 1);
+    assert(managed_hashtable_size(&table) == NUM_OBJECTS);
+    assert(managed_hashtable_lookup_key(&table, &duplicate.key) == &duplicate.node);
+    managed_hashtable_insert(&table, &objects[10].key, &objects[10].node);
+    assert(num_collisions == 2);
+
+    /* Replacing a node at the maximum load factor does not grow the bucket array. */
+    assert(managed_hashtable_rehash(&table, NUM_OBJECTS * 100 / MANAGED_HASHTABLE_MAX_LOAD));
+    num_buckets = managed_hashtable_num_buckets(&table);
+    managed_hashtable_insert(&table, &duplicate.key, &duplicate.node);
+    assert(managed_hashtable_num_buckets(&table) == num_buckets);
+    managed_hashtable_insert(&table, &objects[10].key, &objects[10].node);
+    assert(managed_hashtable_num_buckets(&table) == num_buckets);
+    assert(num_collisions == 4);
+
+    /* Insertion still succeeds when the bucket array cannot grow. */
+    managed_hashtable_remove_all(&table);
+    fail_allocations = 1;
+    insert_objects_(0, NUM_OBJECTS);
+    assert(table.hashtable.num_buckets == 1);
+    assert(managed_hashtable_size(&table) == NUM_OBJECTS);
+    assert(managed_hashtable_lookup_key(&table, &objects[999].key) == &objects[999].node);
+
+    /* Growth resumes as soon as allocation succeeds again. */
+    fail_allocations = 0;
+    managed_hashtable_remove_key(&table, &objects[0].key);
+    insert_objects_(0, 1);
+    assert(num_arrays == 1);
+    assert_table_holds_(0, NUM_OBJECTS);
+
+    /* Keys sharing a common factor still spread over the buckets. */
+    managed_hashtable_remove_all(&table);
+    for (i = 0; i < NUM_OBJECTS; ++i) {
+        objects[i].key = i * 64;
+    }
+    insert_objects_(0, NUM_OBJECTS);
+    for (i = 0, num_used_buckets = 0; i < table.hashtable.num_buckets; ++i) {
+        num_used_buckets += table.hashtable.bucket_array[i] != NULL;
+    }
+    assert(num_used_buckets * 2 > table.hashtable.num_buckets);
+}
+
+void test_managed_hashtable_insert_unique(void) {
+    TestStruct duplicate;
+    size_t i, num_buckets;
+
+    for (i = 0; i < NUM_OBJECTS; ++i) {
+        assert(managed_hashtable_insert_unique(&table, &objects[i].key, &objects[i].node) == NULL);
+    }
+    assert_table_holds_(0, NUM_OBJECTS);
+
+    duplicate.key = objects[10].key;
+    assert(managed_hashtable_insert_unique(&table, &duplicate.key, &duplicate.node) == &objects[10].node);
+    assert(num_collisions == 0);
+    assert_table_holds_(0, NUM_OBJECTS);
+
+    /* Neither does a failed insertion at the maximum load factor, but an added node does. */
+    assert(managed_hashtable_rehash(&table, NUM_OBJECTS * 100 / MANAGED_HASHTABLE_MAX_LOAD));
+    num_buckets = managed_hashtable_num_buckets(&table);
+    assert(managed_hashtable_insert_unique(&table, &duplicate.key, &duplicate.node) == &objects[10].node);
+    assert(managed_hashtable_num_buckets(&table) == num_buckets);
+    managed_hashtable_remove_key(&table, &objects[10].key);
+    assert(managed_hashtable_insert_unique(&table, &duplicate.key, &duplicate.node) == NULL);
+    assert(managed_hashtable_num_buckets(&table) == num_buckets);
+    duplicate.key = 1;
+    assert(managed_hashtable_insert_unique(&table, &duplicate.key, &duplicate.node) == NULL);
+    assert(managed_hashtable_num_buckets(&table) > num_buckets);
+}
+
+void test_managed_hashtable_lookup_key(void) {
+    size_t missing_key = 1;
+
+    assert(managed_hashtable_lookup_key(&table, &objects[0].key) == NULL);
+    insert_objects_(0, NUM_OBJECTS);
+    assert(managed_hashtable_lookup_key(&table, &objects[0].key) == &objects[0].node);
+    assert(managed_hashtable_lookup_key(&table, &objects[500].key) == &objects[500].node);
+    assert(managed_hashtable_lookup_key(&table, &missing_key) == NULL);
+}
+
+void test_managed_hashtable_remove_key(void) {
+    size_t i, max_num_buckets, missing_key = 1;
+
+    insert_objects_(0, NUM_OBJECTS);
+    max_num_buckets = table.hashtable.num_buckets;
+
+    /* Removing a missing key does nothing. */
+    managed_hashtable_remove_key(&table, &missing_key);
+    assert_table_holds_(0, NUM_OBJECTS);
+
+    /* The bucket array shrinks with the table, keeping the load factor above the minimum. */
+    for (i = 0; i < NUM_OBJECTS; ++i) {
+        managed_hashtable_remove_key(&table, &objects[i].key);
+        assert(objects[i].node.next == HASHTABLE_POISON_NEXT);
+        assert(table.hashtable.size * 100 >= table.hashtable.num_buckets * MANAGED_HASHTABLE_MIN_LOAD ||
+            table.hashtable.num_buckets == MANAGED_HASHTABLE_MIN_BUCKETS);
+        if (i % 100 == 0) {
+            assert_table_holds_(i + 1, NUM_OBJECTS);
+        }
+    }
+    assert(table.hashtable.num_buckets == MANAGED_HASHTABLE_MIN_BUCKETS);
+    assert(num_arrays == 1);
+
+    /* Growing and shrinking do not thrash around the same size. */
+    insert_objects_(0, NUM_OBJECTS);
+    assert(table.hashtable.num_buckets == max_num_buckets);
+    managed_hashtable_remove_key(&table, &objects[0].key);
+    insert_objects_(0, 1);
+    managed_hashtable_remove_key(&table, &objects[0].key);
+    assert(table.hashtable.num_buckets == max_num_buckets);
+
+    /* Shrinking is skipped when the bucket array cannot be allocated. */
+    fail_allocations = 1;
+    for (i = 1; i < NUM_OBJECTS - 1; ++i) {
+        managed_hashtable_remove_key(&table, &objects[i].key);
+    }
+    assert(table.hashtable.num_buckets == max_num_buckets);
+    assert_table_holds_(NUM_OBJECTS - 1, NUM_OBJECTS);
+}
+
+void test_managed_hashtable_remove_all(void) {
+    /* Removing all from an empty table does nothing. */
+    managed_hashtable_remove_all(&table);
+    assert(table.hashtable.bucket_array == &table.empty_bucket);
+
+    insert_objects_(0, NUM_OBJECTS);
+    assert(num_arrays == 1);
+    managed_hashtable_remove_all(&table);
+    assert(num_arrays == 0);
+    assert(managed_hashtable_empty(&table));
+    assert(table.hashtable.bucket_array == &table.empty_bucket);
+    assert(table.hashtable.num_buckets == 1);
+    assert(managed_hashtable_lookup_key(&table, &objects[0].key) == NULL);
+
+    /* The table can be used again. */
+    insert_objects_(0, NUM_OBJECTS);
+    assert_table_holds_(0, NUM_OBJECTS);
+}
+
+TestFunc test_funcs[] = {
+    test_managed_hashtable_init,
+    test_managed_hashtable_set_allocator,
+    test_managed_hashtable_set_load_factors,
+    test_managed_hashtable_hashtable,
+    test_managed_hashtable_num_buckets,
+    test_managed_hashtable_size,
+    test_managed_hashtable_empty,
+    test_managed_hashtable_contains_key,
+    test_managed_hashtable_reserve,
+    test_managed_hashtable_rehash,
+    test_managed_hashtable_insert,
+    test_managed_hashtable_insert_unique,
+    test_managed_hashtable_lookup_key,
+    test_managed_hashtable_remove_key,
+    test_managed_hashtable_remove_all
+};
+
+int main(int argc, char *argv[]) {
+    char msg[100] = "ManagedHashTable ";
+    assert(argc == 2);
+    strcat(msg, argv[1]);
+
+    assert(sizeof(test_funcs) / sizeof(TestFunc) == 15);
+    run_tests(test_funcs, sizeof(test_funcs) / sizeof(TestFunc), msg, reset_globals);
+
+    return 0;
+}
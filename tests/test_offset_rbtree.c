@@ -0,0 +1,468 @@
+/*
+Copyright (c) 2017, Michael J Welsh
+
+Permission to use, copy, modify, and/or distribute this software
+for any purpose with or without fee is hereby granted, provided
+that the above copyright notice and this permission notice appear
+in all copies.
+
+THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL
+WARRANTIES WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE
+AUTHOR BE LIABLE FOR ANY SPECIAL, DIRECT, INDIRECT, OR
+CONSEQUENTIAL DAMAGES OR ANY DAMAGES WHATSOEVER RESULTING FROM
+LOSS OF USE, DATA OR PROFITS, WHETHER IN AN ACTION OF CONTRACT,
+NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF OR IN
+CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <stddef.h>
+#include <string.h>
+#include <assert.h>
+
+#include "testing_framework.h"
+
+/* Test header guard. */
+#include "../src/offset_rbtree.h"
+#include "../src/offset_rbtree.h"
+
+/* ========================================================================================================
+ *
+ *                                             TESTING UTILITIES
+ *
+ * ======================================================================================================== */
+
+#define NUM_OBJECTS 1000
+
+typedef struct TestStruct {
+    int key;
+    int val;
+    OffsetRBTreeNode node;
+} TestStruct;
+
+/* Stands in for a shared memory segment. */
+typedef struct Segment {
+    OffsetRBTree tree;
+    TestStruct objects[NUM_OBJECTS];
+} Segment;
+
+/* The segment the tree is built in, and a copy of it at another address. */
+Segment *segment, *moved;
+
+static int compare_(const void *key, const OffsetRBTreeNode *node) {
+    return *(const int*) key - offset_rbtree_entry(node, TestStruct, node)->key;
+}
+
+/* Returns the key inserted i-th, so that keys are not inserted in order. */
+static int shuffled_key_(int i) {
+    return (int) ((i * 7919L) % NUM_OBJECTS);
+}
+
+static OffsetRBTreeNode* follow_(const ptrdiff_t *link) {
+    return *link ? (OffsetRBTreeNode*) ((const char*) link + *link) : NULL;
+}
+
+/* Checks the links, order and colors below the node, and returns its black height. */
+static int assert_subtree_(const OffsetRBTreeNode *node, const OffsetRBTreeNode *parent, size_t *count) {
+    const OffsetRBTreeNode *l, *r;
+    int black_height, key;
+
+    if (!node) {
+        return 1;
+    }
+
+    assert(follow_(&node->parent) == parent);
+    ++*count;
+
+    l = follow_(&node->left_child);
+    r = follow_(&node->right_child);
+
+    if (node->color == OFFSET_RBTREE_NODE_RED) {
+        assert(!l || l->color == OFFSET_RBTREE_NODE_BLACK);
+        assert(!r || r->color == OFFSET_RBTREE_NODE_BLACK);
+    }
+
+    key = offset_rbtree_entry(node, TestStruct, node)->key;
+    assert(!l || offset_rbtree_entry(l, TestStruct, node)->key < key);
+    assert(!r || offset_rbtree_entry(r, TestStruct, node)->key > key);
+
+    black_height = assert_subtree_(l, node, count);
+    assert(black_height == assert_subtree_(r, node, count));
+
+    return black_height + (node->color == OFFSET_RBTREE_NODE_BLACK);
+}
+
+/* Asserts that the tree is a valid red-black tree of the given size. */
+static void assert_tree_(const OffsetRBTree *tree, size_t size) {
+    const OffsetRBTreeNode *root = follow_(&tree->root);
+    size_t count = 0;
+
+    assert(!root || root->color == OFFSET_RBTREE_NODE_BLACK);
+    assert_subtree_(root, NULL, &count);
+    assert(count == size && tree->size == size);
+}
+
+/* Copies the segment to another address, as if it was mapped there by another process. */
+static void move_segment_(void) {
+    free(moved);
+    moved = (Segment*) malloc(sizeof(Segment));
+    assert(moved);
+    memcpy(moved, segment, sizeof(Segment));
+    memset(segment, 0xAB, sizeof(Segment));
+}
+
+/* Inserts the objects whose keys are [0, num_objects), in shuffled order. */
+static void insert_objects_(int num_objects) {
+    int i, key;
+
+    for (i = 0; i < NUM_OBJECTS; ++i) {
+        key = shuffled_key_(i);
+
+        if (key < num_objects) {
+            assert(!offset_rbtree_insert(&segment->tree, compare_, &key, &segment->objects[key].node));
+        }
+    }
+}
+
+static void reset_globals(void) {
+    int i;
+
+    free(moved);
+    moved = NULL;
+
+    if (!segment) {
+        segment = (Segment*) malloc(sizeof(Segment));
+        assert(segment);
+    }
+
+    offset_rbtree_init(&segment->tree);
+
+    for (i = 0; i < NUM_OBJECTS; ++i) {
+        segment->objects[i].key = i;
+        segment->objects[i].val = i * i;
+    }
+}
+
+/* ========================================================================================================
+ *
+ *                                             TESTING FUNCTIONS
+ *
+ * ======================================================================================================== */
+
+void test_offset_rbtree_init(void) {
+    segment->tree.root = 1;
+    segment->tree.size = 1;
+
+    offset_rbtree_init(&segment->tree);
+    assert(segment->tree.root == 0);
+    assert(segment->tree.size == 0);
+    assert_tree_(&segment->tree, 0);
+}
+
+void test_offset_rbtree_first(void) {
+    assert(offset_rbtree_first(&segment->tree) == NULL);
+
+    insert_objects_(NUM_OBJECTS);
+    assert(offset_rbtree_first(&segment->tree) == &segment->objects[0].node);
+
+    move_segment_();
+    assert(offset_rbtree_first(&moved->tree) == &moved->objects[0].node);
+}
+
+void test_offset_rbtree_last(void) {
+    assert(offset_rbtree_last(&segment->tree) == NULL);
+
+    insert_objects_(NUM_OBJECTS);
+    assert(offset_rbtree_last(&segment->tree) == &segment->objects[NUM_OBJECTS - 1].node);
+
+    move_segment_();
+    assert(offset_rbtree_last(&moved->tree) == &moved->objects[NUM_OBJECTS - 1].node);
+}
+
+void test_offset_rbtree_prev(void) {
+    int i;
+
+    assert(offset_rbtree_prev(NULL) == NULL);
+
+    insert_objects_(NUM_OBJECTS);
+    move_segment_();
+
+    assert(offset_rbtree_prev(&moved->objects[0].node) == NULL);
+    for (i = 1; i < NUM_OBJECTS; ++i) {
+        assert(offset_rbtree_prev(&moved->objects[i].node) == &moved->objects[i - 1].node);
+    }
+}
+
+void test_offset_rbtree_next(void) {
+    int i;
+
+    assert(offset_rbtree_next(NULL) == NULL);
+
+    insert_objects_(NUM_OBJECTS);
+    move_segment_();
+
+    for (i = 0; i < NUM_OBJECTS - 1; ++i) {
+        assert(offset_rbtree_next(&moved->objects[i].node) == &moved->objects[i + 1].node);
+    }
+    assert(offset_rbtree_next(&moved->objects[NUM_OBJECTS - 1].node) == NULL);
+}
+
+void test_offset_rbtree_size(void) {
+    assert(offset_rbtree_size(&segment->tree) == 0);
+
+    insert_objects_(10);
+    assert(offset_rbtree_size(&segment->tree) == 10);
+
+    offset_rbtree_remove_first(&segment->tree);
+    assert(offset_rbtree_size(&segment->tree) == 9);
+
+    move_segment_();
+    assert(offset_rbtree_size(&moved->tree) == 9);
+}
+
+void test_offset_rbtree_empty(void) {
+    assert(offset_rbtree_empty(&segment->tree));
+
+    insert_objects_(1);
+    assert(!offset_rbtree_empty(&segment->tree));
+
+    offset_rbtree_remove_first(&segment->tree);
+    assert(offset_rbtree_empty(&segment->tree));
+}
+
+void test_offset_rbtree_contains_key(void) {
+    int key;
+
+    key = 5;
+    assert(!offset_rbtree_contains_key(&segment->tree, compare_, &key));
+
+    insert_objects_(NUM_OBJECTS / 2);
+    move_segment_();
+
+    for (key = 0; key < NUM_OBJECTS; ++key) {
+        assert(offset_rbtree_contains_key(&moved->tree, compare_, &key) == (key < NUM_OBJECTS / 2));
+    }
+}
+
+void test_offset_rbtree_insert(void) {
+    TestStruct *replacement;
+    OffsetRBTreeNode *n;
+    int i, key;
+
+    for (i = 0; i < NUM_OBJECTS; ++i) {
+        key = shuffled_key_(i);
+        assert(!offset_rbtree_insert(&segment->tree, compare_, &key, &segment->objects[key].node));
+        assert_tree_(&segment->tree, (size_t) i + 1);
+    }
+
+    /* The tree keeps working after it is moved, insertions included. */
+    move_segment_();
+    assert_tree_(&moved->tree, NUM_OBJECTS);
+    offset_rbtree_remove_all(&moved->tree);
+    for (i = NUM_OBJECTS - 1; i >= 0; --i) {
+        assert(!offset_rbtree_insert(&moved->tree, compare_, &i, &moved->objects[i].node));
+    }
+    assert_tree_(&moved->tree, NUM_OBJECTS);
+
+    /* A node with an existing key replaces the old node, which is returned. */
+    key = 0;
+    offset_rbtree_remove_key(&moved->tree, compare_, &key);
+    replacement = &moved->objects[0];
+    replacement->key = 500;
+    key = 500;
+    n = offset_rbtree_insert(&moved->tree, compare_, &key, &replacement->node);
+    assert(n == &moved->objects[500].node);
+    assert(n->parent == 0 && n->left_child == 0 && n->right_child == 0);
+    assert(offset_rbtree_lookup_key(&moved->tree, compare_, &key) == &replacement->node);
+    assert_tree_(&moved->tree, NUM_OBJECTS - 1);
+}
+
+void test_offset_rbtree_lookup_key(void) {
+    OffsetRBTreeNode *n;
+    int key;
+
+    key = 0;
+    assert(offset_rbtree_lookup_key(&segment->tree, compare_, &key) == NULL);
+
+    insert_objects_(NUM_OBJECTS);
+    move_segment_();
+
+    for (key = 0; key < NUM_OBJECTS; ++key) {
+        n = offset_rbtree_lookup_key(&moved->tree, compare_, &key);
+        assert(n == &moved->objects[key].node);
+        assert(offset_rbtree_entry(n, TestStruct, node)->val == key * key);
+    }
+
+    key = NUM_OBJECTS;
+    assert(offset_rbtree_lookup_key(&moved->tree, compare_, &key) == NULL);
+    key = -1;
+    assert(offset_rbtree_lookup_key(&moved->tree, compare_, &key) == NULL);
+}
+
+void test_offset_rbtree_remove(void) {
+    size_t size = NUM_OBJECTS;
+    int i, key;
+
+    offset_rbtree_remove(&segment->tree, NULL);
+    assert_tree_(&segment->tree, 0);
+
+    insert_objects_(NUM_OBJECTS);
+    move_segment_();
+
+    /* Removing in shuffled order exercises every case of the repair, and swapping places with children. */
+    for (i = 0; i < NUM_OBJECTS; ++i) {
+        key = shuffled_key_(i * 3 % NUM_OBJECTS);
+
+        if (i % 2 == 0) {
+            offset_rbtree_remove(&moved->tree, &moved->objects[key].node);
+            assert(!offset_rbtree_contains_key(&moved->tree, compare_, &key));
+            assert_tree_(&moved->tree, --size);
+        }
+    }
+
+    for (key = 0; key < NUM_OBJECTS; ++key) {
+        offset_rbtree_remove(&moved->tree, offset_rbtree_lookup_key(&moved->tree, compare_, &key));
+    }
+    assert_tree_(&moved->tree, 0);
+}
+
+void test_offset_rbtree_remove_key(void) {
+    int key;
+
+    insert_objects_(NUM_OBJECTS);
+    move_segment_();
+
+    key = NUM_OBJECTS;
+    offset_rbtree_remove_key(&moved->tree, compare_, &key);
+    assert_tree_(&moved->tree, NUM_OBJECTS);
+
+    for (key = 0; key < NUM_OBJECTS; key += 2) {
+        offset_rbtree_remove_key(&moved->tree, compare_, &key);
+    }
+    assert_tree_(&moved->tree, NUM_OBJECTS / 2);
+
+    for (key = 0; key < NUM_OBJECTS; ++key) {
+        assert(offset_rbtree_contains_key(&moved->tree, compare_, &key) == (key % 2 == 1));
+    }
+}
+
+void test_offset_rbtree_remove_first(void) {
+    int i;
+
+    offset_rbtree_remove_first(&segment->tree);
+    assert_tree_(&segment->tree, 0);
+
+    insert_objects_(NUM_OBJECTS);
+    move_segment_();
+
+    for (i = 0; i < NUM_OBJECTS; ++i) {
+        assert(offset_rbtree_first(&moved->tree) == &moved->objects[i].node);
+        offset_rbtree_remove_first(&moved->tree);
+    }
+    assert_tree_(&moved->tree, 0);
+}
+
+void test_offset_rbtree_remove_last(void) {
+    int i;
+
+    offset_rbtree_remove_last(&segment->tree);
+    assert_tree_(&segment->tree, 0);
+
+    insert_objects_(NUM_OBJECTS);
+    move_segment_();
+
+    for (i = NUM_OBJECTS - 1; i >= 0; --i) {
+        assert(offset_rbtree_last(&moved->tree) == &moved->objects[i].node);
+        offset_rbtree_remove_last(&moved->tree);
+    }
+    assert_tree_(&moved->tree, 0);
+}
+
+void test_offset_rbtree_remove_all(void) {
+    insert_objects_(NUM_OBJECTS);
+
+    offset_rbtree_remove_all(&segment->tree);
+    assert_tree_(&segment->tree, 0);
+    assert(offset_rbtree_first(&segment->tree) == NULL);
+
+    /* The tree can be used again. */
+    insert_objects_(NUM_OBJECTS);
+    assert_tree_(&segment->tree, NUM_OBJECTS);
+}
+
+void test_offset_rbtree_entry(void) {
+    assert(offset_rbtree_entry(&segment->objects[3].node, TestStruct, node) == &segment->objects[3]);
+}
+
+void test_offset_rbtree_for_each(void) {
+    OffsetRBTreeNode *n;
+    int i = 0;
+
+    offset_rbtree_for_each(n, &segment->tree) {
+        assert(0);
+    }
+
+    insert_objects_(NUM_OBJECTS);
+    move_segment_();
+
+    offset_rbtree_for_each(n, &moved->tree) {
+        assert(n == &moved->objects[i].node);
+        ++i;
+    }
+    assert(i == NUM_OBJECTS);
+}
+
+void test_offset_rbtree_for_each_reverse(void) {
+    OffsetRBTreeNode *n;
+    int i = NUM_OBJECTS;
+
+    offset_rbtree_for_each_reverse(n, &segment->tree) {
+        assert(0);
+    }
+
+    insert_objects_(NUM_OBJECTS);
+    move_segment_();
+
+    offset_rbtree_for_each_reverse(n, &moved->tree) {
+        --i;
+        assert(n == &moved->objects[i].node);
+    }
+    assert(i == 0);
+}
+
+TestFunc test_funcs[] = {
+    test_offset_rbtree_init,
+    test_offset_rbtree_first,
+    test_offset_rbtree_last,
+    test_offset_rbtree_prev,
+    test_offset_rbtree_next,
+    test_offset_rbtree_size,
+    test_offset_rbtree_empty,
+    test_offset_rbtree_contains_key,
+    test_offset_rbtree_insert,
+    test_offset_rbtree_lookup_key,
+    test_offset_rbtree_remove,
+    test_offset_rbtree_remove_key,
+    test_offset_rbtree_remove_first,
+    test_offset_rbtree_remove_last,
+    test_offset_rbtree_remove_all,
+    test_offset_rbtree_entry,
+    test_offset_rbtree_for_each,
+    test_offset_rbtree_for_each_reverse
+};
+
+int main(int argc, char *argv[]) {
+    char msg[100] = "OffsetRBTree ";
+    assert(argc == 2);
+    strcat(msg, argv[1]);
+
+    assert(sizeof(test_funcs) / sizeof(TestFunc) == 18);
+    run_tests(test_funcs, sizeof(test_funcs) / sizeof(TestFunc), msg, reset_globals);
+
+    free(segment);
+    free(moved);
+
+    return 0;
+}
@@ -0,0 +1,541 @@
+/*
+Copyright (c) 2017, Michael J Welsh
+
+Permission to use, copy, modify, and/or distribute this software
+for any purpose with or without fee is hereby granted, provided
+that the above copyright notice and this permission notice appear
+in all copies.
+
+THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL
+WARRANTIES WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE
+AUTHOR BE LIABLE FOR ANY SPECIAL, DIRECT, INDIRECT, OR
+CONSEQUENTIAL DAMAGES OR ANY DAMAGES WHATSOEVER RESULTING FROM
+LOSS OF USE, DATA OR PROFITS, WHETHER IN AN ACTION OF CONTRACT,
+NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF OR IN
+CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <stddef.h>
+#include <string.h>
+#include <assert.h>
+
+#include "testing_framework.h"
+
+/* Test header guard. */
+#include "../src/persistent_rbtree.h"
+#include "../src/persistent_rbtree.h"
+
+/* ========================================================================================================
+ *
+ *                                             TESTING UTILITIES
+ *
+ * ======================================================================================================== */
+
+#define NUM_OBJECTS 1000
+
+typedef struct TestStruct {
+    int key;
+    int val;
+} TestStruct;
+
+TestStruct objects[NUM_OBJECTS];
+PersistentRBTree tree;
+PersistentRBTree versions[NUM_OBJECTS + 1];
+
+/* The number of nodes allocated and not yet freed. */
+long num_nodes;
+
+/* The number of allocations that succeed before one fails, or -1 if none fails. */
+long allocations_left;
+
+static int compare_(const void *key, const void *value) {
+    return *(const int*) key - ((const TestStruct*) value)->key;
+}
+
+static void* allocate_(size_t size, void *allocator_data) {
+    assert(size == sizeof(PersistentRBTreeNode) && allocator_data == &num_nodes);
+
+    if (allocations_left == 0) {
+        return NULL;
+    }
+    if (allocations_left > 0) {
+        --allocations_left;
+    }
+
+    ++num_nodes;
+    return malloc(size);
+}
+
+static void deallocate_(void *ptr, size_t size, void *allocator_data) {
+    assert(ptr && size == sizeof(PersistentRBTreeNode) && allocator_data == &num_nodes);
+
+    --num_nodes;
+    free(ptr);
+}
+
+/* Returns the key inserted i-th, so that keys are not inserted in order. */
+static int shuffled_key_(int i) {
+    return (int) ((i * 7919L) % NUM_OBJECTS);
+}
+
+/* Checks the order, colors and reference counts below the node, and returns its black height. */
+static int assert_subtree_(const PersistentRBTreeNode *node, size_t *count) {
+    const PersistentRBTreeNode *l, *r;
+    int black_height, key;
+
+    if (!node) {
+        return 1;
+    }
+
+    assert(node->refs > 0 && !node->fresh);
+    ++*count;
+
+    l = node->child[0];
+    r = node->child[1];
+
+    if (node->color == PERSISTENT_RBTREE_NODE_RED) {
+        assert(!l || l->color == PERSISTENT_RBTREE_NODE_BLACK);
+        assert(!r || r->color == PERSISTENT_RBTREE_NODE_BLACK);
+    }
+
+    key = ((const TestStruct*) node->value)->key;
+    assert(!l || ((const TestStruct*) l->value)->key < key);
+    assert(!r || ((const TestStruct*) r->value)->key > key);
+
+    black_height = assert_subtree_(l, count);
+    assert(black_height == assert_subtree_(r, count));
+
+    return black_height + (node->color == PERSISTENT_RBTREE_NODE_BLACK);
+}
+
+/* Asserts that the version is a valid red-black tree of the given size. */
+static void assert_tree_(const PersistentRBTree *version, size_t size) {
+    size_t count = 0;
+
+    assert(!version->root || version->root->color == PERSISTENT_RBTREE_NODE_BLACK);
+    assert_subtree_(version->root, &count);
+    assert(count == size && version->size == size);
+}
+
+/* Inserts the objects whose keys are [0, num_objects) into the tree, in shuffled order. */
+static void insert_objects_(int num_objects) {
+    PersistentRBTree next;
+    int i, key;
+
+    for (i = 0; i < NUM_OBJECTS; ++i) {
+        key = shuffled_key_(i);
+
+        if (key < num_objects) {
+            assert(persistent_rbtree_insert(&tree, &next, &key, &objects[key]));
+            persistent_rbtree_release(&tree);
+            tree = next;
+        }
+    }
+}
+
+static void reset_globals(void) {
+    int i;
+
+    assert(num_nodes == 0);
+    allocations_left = -1;
+
+    persistent_rbtree_init(&tree, compare_, allocate_, deallocate_, &num_nodes);
+
+    for (i = 0; i < NUM_OBJECTS; ++i) {
+        objects[i].key = i;
+        objects[i].val = i * i;
+    }
+}
+
+/* ========================================================================================================
+ *
+ *                                             TESTING FUNCTIONS
+ *
+ * ======================================================================================================== */
+
+void test_persistent_rbtree_init(void) {
+    PersistentRBTree other;
+
+    assert(tree.root == NULL);
+    assert(tree.size == 0);
+    assert(tree.compare == compare_);
+    assert(tree.allocate == allocate_);
+    assert(tree.deallocate == deallocate_);
+    assert(tree.allocator_data == &num_nodes);
+    assert_tree_(&tree, 0);
+
+    persistent_rbtree_init(&other, compare_, NULL, NULL, NULL);
+    assert(other.root == NULL && other.size == 0 && other.allocate == NULL && other.deallocate == NULL);
+    persistent_rbtree_release(&other);
+}
+
+void test_persistent_rbtree_copy(void) {
+    PersistentRBTree copy;
+
+    persistent_rbtree_copy(&tree, &copy);
+    assert(copy.root == NULL && copy.size == 0);
+
+    insert_objects_(100);
+    persistent_rbtree_copy(&tree, &copy);
+    assert(copy.root == tree.root && copy.root->refs == 2);
+
+    persistent_rbtree_release(&tree);
+    assert(num_nodes == 100);
+    assert_tree_(&copy, 100);
+
+    persistent_rbtree_release(&copy);
+    assert(num_nodes == 0);
+}
+
+void test_persistent_rbtree_first(void) {
+    PersistentRBTree next;
+    int key = 0;
+
+    assert(persistent_rbtree_first(&tree) == NULL);
+
+    insert_objects_(NUM_OBJECTS);
+    assert(persistent_rbtree_first(&tree) == &objects[0]);
+
+    assert(persistent_rbtree_remove_key(&tree, &next, &key));
+    assert(persistent_rbtree_first(&next) == &objects[1]);
+    assert(persistent_rbtree_first(&tree) == &objects[0]);
+
+    persistent_rbtree_release(&next);
+    persistent_rbtree_release(&tree);
+}
+
+void test_persistent_rbtree_last(void) {
+    PersistentRBTree next;
+    int key = NUM_OBJECTS - 1;
+
+    assert(persistent_rbtree_last(&tree) == NULL);
+
+    insert_objects_(NUM_OBJECTS);
+    assert(persistent_rbtree_last(&tree) == &objects[NUM_OBJECTS - 1]);
+
+    assert(persistent_rbtree_remove_key(&tree, &next, &key));
+    assert(persistent_rbtree_last(&next) == &objects[NUM_OBJECTS - 2]);
+    assert(persistent_rbtree_last(&tree) == &objects[NUM_OBJECTS - 1]);
+
+    persistent_rbtree_release(&next);
+    persistent_rbtree_release(&tree);
+}
+
+void test_persistent_rbtree_size(void) {
+    PersistentRBTree next;
+    int key = 10;
+
+    assert(persistent_rbtree_size(&tree) == 0);
+
+    insert_objects_(NUM_OBJECTS);
+    assert(persistent_rbtree_size(&tree) == NUM_OBJECTS);
+
+    assert(persistent_rbtree_remove_key(&tree, &next, &key));
+    assert(persistent_rbtree_size(&next) == NUM_OBJECTS - 1);
+    assert(persistent_rbtree_size(&tree) == NUM_OBJECTS);
+
+    persistent_rbtree_release(&next);
+    persistent_rbtree_release(&tree);
+    assert(persistent_rbtree_size(&tree) == 0);
+}
+
+void test_persistent_rbtree_empty(void) {
+    PersistentRBTree next;
+    int key = 0;
+
+    assert(persistent_rbtree_empty(&tree));
+
+    insert_objects_(1);
+    assert(!persistent_rbtree_empty(&tree));
+
+    assert(persistent_rbtree_remove_key(&tree, &next, &key));
+    assert(persistent_rbtree_empty(&next));
+    assert(!persistent_rbtree_empty(&tree));
+
+    persistent_rbtree_release(&next);
+    persistent_rbtree_release(&tree);
+    assert(persistent_rbtree_empty(&tree));
+}
+
+void test_persistent_rbtree_contains_key(void) {
+    PersistentRBTree next;
+    int key;
+
+    key = 0;
+    assert(!persistent_rbtree_contains_key(&tree, &key));
+
+    insert_objects_(NUM_OBJECTS);
+    for (key = 0; key < NUM_OBJECTS; ++key) {
+        assert(persistent_rbtree_contains_key(&tree, &key));
+    }
+    key = -1;
+    assert(!persistent_rbtree_contains_key(&tree, &key));
+    key = NUM_OBJECTS;
+    assert(!persistent_rbtree_contains_key(&tree, &key));
+
+    key = 500;
+    assert(persistent_rbtree_remove_key(&tree, &next, &key));
+    assert(!persistent_rbtree_contains_key(&next, &key));
+    assert(persistent_rbtree_contains_key(&tree, &key));
+
+    persistent_rbtree_release(&next);
+    persistent_rbtree_release(&tree);
+}
+
+void test_persistent_rbtree_insert(void) {
+    PersistentRBTree next, untouched;
+    TestStruct replacement, extra;
+    long fail, before;
+    int i, key;
+
+    /* Every version keeps the keys it had when it was created. */
+    persistent_rbtree_copy(&tree, &versions[0]);
+    for (i = 0; i < NUM_OBJECTS; ++i) {
+        key = shuffled_key_(i);
+        assert(persistent_rbtree_insert(&versions[i], &versions[i + 1], &key, &objects[key]));
+    }
+    for (i = 0; i <= NUM_OBJECTS; i += 37) {
+        assert_tree_(&versions[i], (size_t) i);
+        if (i > 0) {
+            key = shuffled_key_(i - 1);
+            assert(persistent_rbtree_lookup_key(&versions[i], &key) == &objects[key]);
+            assert(persistent_rbtree_lookup_key(&versions[i - 1], &key) == NULL);
+        }
+    }
+
+    /* Replacing a value copies the path to it. */
+    replacement.key = 5;
+    key = 5;
+    assert(persistent_rbtree_insert(&versions[NUM_OBJECTS], &next, &key, &replacement));
+    assert_tree_(&next, NUM_OBJECTS);
+    assert(persistent_rbtree_lookup_key(&next, &key) == &replacement);
+    assert(persistent_rbtree_lookup_key(&versions[NUM_OBJECTS], &key) == &objects[5]);
+    persistent_rbtree_release(&next);
+
+    /* A failed allocation leaves everything as it was. */
+    untouched.root = NULL;
+    untouched.size = 12345;
+    extra.key = NUM_OBJECTS;
+    key = NUM_OBJECTS;
+    before = num_nodes;
+    for (fail = 0; fail < 100; ++fail) {
+        allocations_left = fail;
+        if (persistent_rbtree_insert(&versions[NUM_OBJECTS], &untouched, &key, &extra)) {
+            break;
+        }
+        assert(untouched.root == NULL && untouched.size == 12345 && num_nodes == before);
+    }
+    assert(fail > 0 && fail < 100);
+    allocations_left = -1;
+    assert_tree_(&untouched, NUM_OBJECTS + 1);
+    assert_tree_(&versions[NUM_OBJECTS], NUM_OBJECTS);
+    persistent_rbtree_release(&untouched);
+
+    for (i = 0; i <= NUM_OBJECTS; ++i) {
+        persistent_rbtree_release(&versions[i]);
+    }
+    persistent_rbtree_release(&tree);
+    assert(num_nodes == 0);
+}
+
+void test_persistent_rbtree_lookup_key(void) {
+    PersistentRBTree next;
+    int key;
+
+    key = 0;
+    assert(persistent_rbtree_lookup_key(&tree, &key) == NULL);
+
+    insert_objects_(NUM_OBJECTS);
+    for (key = 0; key < NUM_OBJECTS; ++key) {
+        assert(persistent_rbtree_lookup_key(&tree, &key) == &objects[key]);
+    }
+    key = NUM_OBJECTS;
+    assert(persistent_rbtree_lookup_key(&tree, &key) == NULL);
+
+    key = 0;
+    assert(persistent_rbtree_remove_key(&tree, &next, &key));
+    assert(persistent_rbtree_lookup_key(&next, &key) == NULL);
+    assert(persistent_rbtree_lookup_key(&tree, &key) == &objects[0]);
+
+    persistent_rbtree_release(&next);
+    persistent_rbtree_release(&tree);
+}
+
+void test_persistent_rbtree_remove_key(void) {
+    PersistentRBTree untouched;
+    long fail, before;
+    int i, key;
+
+    insert_objects_(NUM_OBJECTS);
+
+    /* Every version keeps the keys it had when it was created. */
+    persistent_rbtree_copy(&tree, &versions[0]);
+    for (i = 0; i < NUM_OBJECTS; ++i) {
+        key = shuffled_key_(i);
+        assert(persistent_rbtree_remove_key(&versions[i], &versions[i + 1], &key));
+    }
+    for (i = 0; i <= NUM_OBJECTS; i += 37) {
+        assert_tree_(&versions[i], (size_t) (NUM_OBJECTS - i));
+        if (i > 0) {
+            key = shuffled_key_(i - 1);
+            assert(persistent_rbtree_lookup_key(&versions[i], &key) == NULL);
+            assert(persistent_rbtree_lookup_key(&versions[i - 1], &key) == &objects[key]);
+        }
+    }
+    assert(versions[NUM_OBJECTS].root == NULL);
+
+    /* Removing a missing key makes a copy. */
+    key = NUM_OBJECTS;
+    before = num_nodes;
+    assert(persistent_rbtree_remove_key(&tree, &untouched, &key));
+    assert(untouched.root == tree.root && untouched.size == NUM_OBJECTS && num_nodes == before);
+    persistent_rbtree_release(&untouched);
+
+    /* A failed allocation leaves everything as it was. */
+    untouched.root = NULL;
+    untouched.size = 12345;
+    key = 0;
+    for (fail = 0; fail < 100; ++fail) {
+        allocations_left = fail;
+        if (persistent_rbtree_remove_key(&tree, &untouched, &key)) {
+            break;
+        }
+        assert(untouched.root == NULL && untouched.size == 12345 && num_nodes == before);
+    }
+    assert(fail > 0 && fail < 100);
+    allocations_left = -1;
+    assert_tree_(&untouched, NUM_OBJECTS - 1);
+    assert_tree_(&tree, NUM_OBJECTS);
+    persistent_rbtree_release(&untouched);
+
+    /* Versions can be released in any order. */
+    for (i = 0; i <= NUM_OBJECTS; ++i) {
+        persistent_rbtree_release(&versions[(i * 7919L) % (NUM_OBJECTS + 1)]);
+    }
+    persistent_rbtree_release(&tree);
+    assert(num_nodes == 0);
+}
+
+void test_persistent_rbtree_release(void) {
+    PersistentRBTree next;
+    int key = 0;
+
+    persistent_rbtree_release(&tree);
+    assert(tree.root == NULL && tree.size == 0);
+
+    insert_objects_(NUM_OBJECTS);
+    assert(num_nodes == NUM_OBJECTS);
+
+    /* Only the nodes the other version does not share are freed. */
+    assert(persistent_rbtree_remove_key(&tree, &next, &key));
+    assert(num_nodes > NUM_OBJECTS);
+    persistent_rbtree_release(&tree);
+    assert(num_nodes == NUM_OBJECTS - 1);
+    assert(tree.root == NULL && tree.size == 0);
+    assert_tree_(&next, NUM_OBJECTS - 1);
+
+    persistent_rbtree_release(&next);
+    assert(num_nodes == 0);
+}
+
+void test_persistent_rbtree_iterator_init(void) {
+    PersistentRBTreeIterator iterator;
+    int i;
+
+    persistent_rbtree_iterator_init(&iterator, &tree);
+    assert(persistent_rbtree_iterator_next(&iterator) == NULL);
+
+    insert_objects_(NUM_OBJECTS);
+    persistent_rbtree_iterator_init(&iterator, &tree);
+    for (i = 0; i < NUM_OBJECTS; ++i) {
+        assert(persistent_rbtree_iterator_next(&iterator) == &objects[i]);
+    }
+    assert(persistent_rbtree_iterator_next(&iterator) == NULL);
+
+    persistent_rbtree_release(&tree);
+}
+
+void test_persistent_rbtree_iterator_seek(void) {
+    PersistentRBTreeIterator iterator;
+    PersistentRBTree next;
+    int i, key;
+
+    key = 0;
+    persistent_rbtree_iterator_seek(&iterator, &tree, &key);
+    assert(persistent_rbtree_iterator_next(&iterator) == NULL);
+
+    /* Only the even keys. */
+    insert_objects_(NUM_OBJECTS);
+    for (key = 1; key < NUM_OBJECTS; key += 2) {
+        assert(persistent_rbtree_remove_key(&tree, &next, &key));
+        persistent_rbtree_release(&tree);
+        tree = next;
+    }
+
+    for (key = -1; key < NUM_OBJECTS; ++key) {
+        persistent_rbtree_iterator_seek(&iterator, &tree, &key);
+        for (i = key < 0 ? 0 : key + key % 2; i < NUM_OBJECTS; i += 2) {
+            assert(persistent_rbtree_iterator_next(&iterator) == &objects[i]);
+        }
+        assert(persistent_rbtree_iterator_next(&iterator) == NULL);
+    }
+
+    persistent_rbtree_release(&tree);
+}
+
+void test_persistent_rbtree_iterator_next(void) {
+    PersistentRBTreeIterator iterator;
+    PersistentRBTree old, next;
+    int i, key;
+
+    insert_objects_(NUM_OBJECTS);
+    persistent_rbtree_copy(&tree, &old);
+
+    /* Iterating over a version is not disturbed by the versions created meanwhile. */
+    persistent_rbtree_iterator_init(&iterator, &old);
+    for (i = 0; i < NUM_OBJECTS; ++i) {
+        assert(persistent_rbtree_iterator_next(&iterator) == &objects[i]);
+
+        key = shuffled_key_(i);
+        assert(persistent_rbtree_remove_key(&tree, &next, &key));
+        persistent_rbtree_release(&tree);
+        tree = next;
+    }
+    assert(persistent_rbtree_iterator_next(&iterator) == NULL);
+    assert(persistent_rbtree_empty(&tree));
+
+    persistent_rbtree_release(&old);
+    persistent_rbtree_release(&tree);
+    assert(num_nodes == 0);
+}
+
+TestFunc test_funcs[] = {
+    test_persistent_rbtree_init,
+    test_persistent_rbtree_copy,
+    test_persistent_rbtree_first,
+    test_persistent_rbtree_last,
+    test_persistent_rbtree_size,
+    test_persistent_rbtree_empty,
+    test_persistent_rbtree_contains_key,
+    test_persistent_rbtree_insert,
+    test_persistent_rbtree_lookup_key,
+    test_persistent_rbtree_remove_key,
+    test_persistent_rbtree_release,
+    test_persistent_rbtree_iterator_init,
+    test_persistent_rbtree_iterator_seek,
+    test_persistent_rbtree_iterator_next
+};
+
+int main(int argc, char *argv[]) {
+    char msg[100] = "PersistentRBTree ";
+    assert(argc == 2);
+    strcat(msg, argv[1]);
+
+    assert(sizeof(test_funcs) / sizeof(TestFunc) == 14);
+    run_tests(test_funcs, sizeof(test_funcs) / sizeof(TestFunc), msg, reset_globals);
+
+    return 0;
+}
@@ -0,0 +1,499 @@
+/*
+Copyright (c) 2017, Michael J Welsh
+
+Permission to use, copy, modify, and/or distribute this software
+for any purpose with or without fee is hereby granted, provided
+that the above copyright notice and this permission notice appear
+in all copies.
+
+THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL
+WARRANTIES WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE
+AUTHOR BE LIABLE FOR ANY SPECIAL, DIRECT, INDIRECT, OR
+CONSEQUENTIAL DAMAGES OR ANY DAMAGES WHATSOEVER RESULTING FROM
+LOSS OF USE, DATA OR PROFITS, WHETHER IN AN ACTION OF CONTRACT,
+NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF OR IN
+CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <stddef.h>
+#include <string.h>
+#include <assert.h>
+
+#include "testing_framework.h"
+
+/* Test header guard. */
+#include "../src/pool.h"
+#include "../src/pool.h"
+
+/* ========================================================================================================
+ *
+ *                                             TESTING UTILITIES
+ *
+ * ======================================================================================================== */
+
+#define OBJECT_SIZE 40
+#define OBJECT_SLOT_SIZE ((OBJECT_SIZE + POOL_ALIGNMENT - 1) / POOL_ALIGNMENT * POOL_ALIGNMENT)
+#define OBJECTS_PER_CHUNK 10
+#define CHUNK_SIZE (POOL_CHUNK_OVERHEAD + OBJECTS_PER_CHUNK * OBJECT_SLOT_SIZE)
+#define NUM_OBJECTS 1000
+
+typedef struct TestStruct {
+    size_t val;
+    char bytes[OBJECT_SIZE - sizeof(size_t)];
+} TestStruct;
+
+Pool pool;
+PoolCache cache;
+TestStruct *objects[NUM_OBJECTS];
+
+/* The chunks currently allocated through the counting allocator, and whether it should fail. */
+size_t num_chunks;
+int fail_allocations;
+
+/* How many times the counting lock was taken, and whether it is held. */
+size_t num_locks;
+int locked;
+
+static void* allocate_(size_t size, void *allocator_data) {
+    assert(size == CHUNK_SIZE);
+    assert(allocator_data == &num_chunks);
+
+    if (fail_allocations) {
+        return NULL;
+    }
+
+    ++num_chunks;
+    return malloc(size);
+}
+
+static void deallocate_(void *ptr, size_t size, void *allocator_data) {
+    assert(ptr && size == CHUNK_SIZE);
+    assert(allocator_data == &num_chunks);
+
+    --num_chunks;
+    free(ptr);
+}
+
+static void lock_(void *lock_data) {
+    assert(lock_data == &num_locks && !locked);
+
+    locked = 1;
+    ++num_locks;
+}
+
+static void unlock_(void *lock_data) {
+    assert(lock_data == &num_locks && locked);
+
+    locked = 0;
+}
+
+/* Allocates num_objects objects into the objects array, and fills each with its index. */
+static void alloc_objects_(size_t num_objects) {
+    size_t i;
+
+    for (i = 0; i < num_objects; ++i) {
+        objects[i] = (TestStruct*) pool_alloc(&pool);
+        assert(objects[i]);
+        assert((size_t) objects[i] % POOL_ALIGNMENT == 0);
+        memset(objects[i], (int) i, OBJECT_SIZE);
+        objects[i]->val = i;
+    }
+}
+
+/* Asserts the first num_objects objects still hold their contents, so none of them overlap. */
+static void assert_objects_intact_(size_t num_objects) {
+    size_t i, j;
+
+    for (i = 0; i < num_objects; ++i) {
+        assert(objects[i]->val == i);
+        for (j = 0; j < sizeof(objects[i]->bytes); ++j) {
+            assert(objects[i]->bytes[j] == (char) i);
+        }
+    }
+}
+
+static void reset_globals(void) {
+    /* Free whatever the previous test left behind. */
+    pool_release(&pool);
+    assert(num_chunks == 0);
+
+    fail_allocations = 0;
+    num_locks = 0;
+    locked = 0;
+    pool_init(&pool, OBJECT_SIZE, CHUNK_SIZE, allocate_, deallocate_, &num_chunks);
+    memset(objects, 0, sizeof(objects));
+}
+
+/* ========================================================================================================
+ *
+ *                                             TESTING FUNCTIONS
+ *
+ * ======================================================================================================== */
+
+void test_pool_init(void) {
+    Pool other_pool;
+
+    assert(pool.head == NULL && pool.current == NULL);
+    assert(pool.size == 0);
+    assert(pool.chunk_size == CHUNK_SIZE);
+    assert(pool.allocate == allocate_ && pool.deallocate == deallocate_);
+    assert(pool.allocator_data == &num_chunks);
+    assert(pool.lock == NULL && pool.unlock == NULL);
+    assert(stack_empty(&pool.free_objects));
+
+    /* Object sizes are rounded up to the alignment, and can hold a StackNode. */
+    pool_init(&other_pool, 1, 0, NULL, NULL, NULL);
+    assert(other_pool.object_size == POOL_ALIGNMENT);
+    assert(other_pool.object_size >= sizeof(StackNode));
+    pool_init(&other_pool, POOL_ALIGNMENT, 0, NULL, NULL, NULL);
+    assert(other_pool.object_size == POOL_ALIGNMENT);
+    pool_init(&other_pool, POOL_ALIGNMENT + 1, 0, NULL, NULL, NULL);
+    assert(other_pool.object_size == 2 * POOL_ALIGNMENT);
+    assert(other_pool.chunk_size == 0);
+    assert(other_pool.allocate == NULL && other_pool.deallocate == NULL);
+
+    /* Without a chunk size, nothing is allocated. */
+    assert(pool_alloc(&other_pool) == NULL);
+
+    /* Without an allocator, malloc() and free() are used. */
+    pool_init(&other_pool, OBJECT_SIZE, CHUNK_SIZE, NULL, NULL, NULL);
+    assert(pool_alloc(&other_pool) != NULL);
+    assert(other_pool.head && other_pool.head->owned);
+    pool_release(&other_pool);
+    assert(other_pool.head == NULL);
+}
+
+void test_pool_set_lock(void) {
+    void *object;
+
+    pool_set_lock(&pool, lock_, unlock_, &num_locks);
+    assert(pool.lock == lock_ && pool.unlock == unlock_ && pool.lock_data == &num_locks);
+
+    object = pool_alloc(&pool);
+    assert(object && num_locks == 1 && !locked);
+    pool_free(&pool, object);
+    assert(num_locks == 2 && !locked);
+    pool_free(&pool, NULL);
+    assert(num_locks == 2);
+
+    pool_set_lock(&pool, NULL, NULL, NULL);
+    assert(pool.lock == NULL && pool.unlock == NULL && pool.lock_data == NULL);
+    object = pool_alloc(&pool);
+    assert(object && num_locks == 2);
+    pool_free(&pool, object);
+}
+
+void test_pool_cache_init(void) {
+    pool_cache_init(&cache, &pool, 8);
+    assert(cache.pool == &pool);
+    assert(cache.capacity == 8);
+    assert(stack_empty(&cache.free_objects));
+}
+
+void test_pool_size(void) {
+    assert(pool_size(&pool) == 0);
+    alloc_objects_(NUM_OBJECTS);
+    assert(pool_size(&pool) == NUM_OBJECTS);
+    pool_free(&pool, objects[0]);
+    assert(pool_size(&pool) == NUM_OBJECTS - 1);
+    pool_reset(&pool);
+    assert(pool_size(&pool) == 0);
+}
+
+void test_pool_object_size(void) {
+    assert(pool_object_size(&pool) == OBJECT_SLOT_SIZE);
+    assert(pool_object_size(&pool) >= OBJECT_SIZE);
+    assert(pool_object_size(&pool) % POOL_ALIGNMENT == 0);
+}
+
+void test_pool_add_chunk(void) {
+    void *memory = malloc(CHUNK_SIZE), *other_memory = malloc(CHUNK_SIZE);
+    size_t i;
+
+    /* Only the chunks given to the pool are used when the chunk size is 0. */
+    pool_init(&pool, OBJECT_SIZE, 0, allocate_, deallocate_, &num_chunks);
+    pool_set_lock(&pool, lock_, unlock_, &num_locks);
+    pool_add_chunk(&pool, memory, CHUNK_SIZE);
+    assert(num_locks == 1);
+    pool_add_chunk(&pool, other_memory, CHUNK_SIZE);
+
+    for (i = 0; i < 2 * OBJECTS_PER_CHUNK; ++i) {
+        objects[i] = (TestStruct*) pool_alloc(&pool);
+        assert(objects[i]);
+        assert(
+            ((char*) objects[i] >= (char*) memory + POOL_CHUNK_OVERHEAD &&
+                (char*) objects[i] + OBJECT_SIZE <= (char*) memory + CHUNK_SIZE) ||
+            ((char*) objects[i] >= (char*) other_memory + POOL_CHUNK_OVERHEAD &&
+                (char*) objects[i] + OBJECT_SIZE <= (char*) other_memory + CHUNK_SIZE)
+        );
+    }
+    assert(pool_alloc(&pool) == NULL);
+    assert(num_chunks == 0);
+
+    /* A chunk given in the middle of a chunk is used once the current chunk is used up. */
+    pool_init(&pool, OBJECT_SIZE, CHUNK_SIZE, allocate_, deallocate_, &num_chunks);
+    alloc_objects_(1);
+    assert(num_chunks == 1);
+    pool_add_chunk(&pool, memory, CHUNK_SIZE);
+    alloc_objects_(2 * OBJECTS_PER_CHUNK);
+    assert(num_chunks == 2);
+    assert_objects_intact_(2 * OBJECTS_PER_CHUNK);
+
+    /* Chunks given by the user are not freed. */
+    pool_release(&pool);
+    assert(num_chunks == 0);
+
+    free(memory);
+    free(other_memory);
+}
+
+void test_pool_alloc(void) {
+    void *object;
+    size_t i;
+
+    alloc_objects_(NUM_OBJECTS);
+    assert_objects_intact_(NUM_OBJECTS);
+    assert(num_chunks == (NUM_OBJECTS + OBJECTS_PER_CHUNK - 1) / OBJECTS_PER_CHUNK);
+
+    /* Objects are carved in order within a chunk. */
+    for (i = 1; i < OBJECTS_PER_CHUNK; ++i) {
+        assert((char*) objects[i] == (char*) objects[i - 1] + pool_object_size(&pool));
+    }
+
+    /* The most recently freed object is reused first. */
+    pool_free(&pool, objects[3]);
+    pool_free(&pool, objects[7]);
+    assert(pool_alloc(&pool) == objects[7]);
+    assert(pool_alloc(&pool) == objects[3]);
+
+    /* A failed chunk allocation leaves the pool usable. */
+    pool_release(&pool);
+    pool_init(&pool, OBJECT_SIZE, CHUNK_SIZE, allocate_, deallocate_, &num_chunks);
+    fail_allocations = 1;
+    assert(pool_alloc(&pool) == NULL);
+    assert(pool_size(&pool) == 0);
+    fail_allocations = 0;
+    alloc_objects_(OBJECTS_PER_CHUNK);
+    fail_allocations = 1;
+    assert(pool_alloc(&pool) == NULL);
+    assert(pool_size(&pool) == OBJECTS_PER_CHUNK);
+    pool_free(&pool, objects[0]);
+    object = pool_alloc(&pool);
+    assert(object == objects[0]);
+    fail_allocations = 0;
+    assert(pool_alloc(&pool) != NULL);
+    assert(num_chunks == 2);
+}
+
+void test_pool_free(void) {
+    size_t i;
+
+    pool_free(&pool, NULL);
+    assert(pool_size(&pool) == 0);
+
+    alloc_objects_(NUM_OBJECTS);
+    for (i = 0; i < NUM_OBJECTS; i += 2) {
+        pool_free(&pool, objects[i]);
+    }
+    assert(pool_size(&pool) == NUM_OBJECTS / 2);
+
+    /* Freed objects are reused before any new chunk is allocated, and the others are left intact. */
+    for (i = 0; i < NUM_OBJECTS; i += 2) {
+        objects[i] = (TestStruct*) pool_alloc(&pool);
+        memset(objects[i], (int) i, OBJECT_SIZE);
+        objects[i]->val = i;
+    }
+    assert(num_chunks == (NUM_OBJECTS + OBJECTS_PER_CHUNK - 1) / OBJECTS_PER_CHUNK);
+    assert_objects_intact_(NUM_OBJECTS);
+}
+
+void test_pool_cache_alloc(void) {
+    size_t i;
+
+    pool_set_lock(&pool, lock_, unlock_, &num_locks);
+    pool_cache_init(&cache, &pool, 8);
+
+    /* The first allocation takes a batch of half the capacity from the pool. */
+    objects[0] = (TestStruct*) pool_cache_alloc(&cache);
+    assert(objects[0]);
+    assert(num_locks == 1);
+    assert(pool_size(&pool) == 4);
+    assert(stack_size(&cache.free_objects) == 3);
+
+    for (i = 1; i < 4; ++i) {
+        objects[i] = (TestStruct*) pool_cache_alloc(&cache);
+        assert(objects[i]);
+    }
+    assert(num_locks == 1);
+    assert(stack_empty(&cache.free_objects));
+
+    for (i = 4; i < NUM_OBJECTS; ++i) {
+        objects[i] = (TestStruct*) pool_cache_alloc(&cache);
+        assert(objects[i]);
+    }
+    assert(num_locks == NUM_OBJECTS / 4);
+    assert(pool_size(&pool) == NUM_OBJECTS);
+
+    for (i = 0; i < NUM_OBJECTS; ++i) {
+        memset(objects[i], (int) i, OBJECT_SIZE);
+        objects[i]->val = i;
+    }
+    assert_objects_intact_(NUM_OBJECTS);
+
+    /* A cache of capacity 1 takes one object at a time, and returns NULL when the pool is out of memory. */
+    pool_release(&pool);
+    pool_init(&pool, OBJECT_SIZE, CHUNK_SIZE, allocate_, deallocate_, &num_chunks);
+    pool_cache_init(&cache, &pool, 1);
+    assert(pool_cache_alloc(&cache) != NULL);
+    assert(pool_size(&pool) == 1);
+    fail_allocations = 1;
+    for (i = 1; i < OBJECTS_PER_CHUNK; ++i) {
+        assert(pool_cache_alloc(&cache) != NULL);
+    }
+    assert(pool_cache_alloc(&cache) == NULL);
+    assert(pool_size(&pool) == OBJECTS_PER_CHUNK);
+}
+
+void test_pool_cache_free(void) {
+    size_t i;
+
+    pool_set_lock(&pool, lock_, unlock_, &num_locks);
+    pool_cache_init(&cache, &pool, 8);
+
+    pool_cache_free(&cache, NULL);
+    assert(num_locks == 0);
+
+    alloc_objects_(NUM_OBJECTS);
+    num_locks = 0;
+
+    /* Objects stay in the cache up to its capacity. */
+    for (i = 0; i < 8; ++i) {
+        pool_cache_free(&cache, objects[i]);
+    }
+    assert(num_locks == 0);
+    assert(stack_size(&cache.free_objects) == 8);
+    assert(pool_size(&pool) == NUM_OBJECTS);
+
+    /* Going over capacity gives objects back to the pool until the cache is half full. */
+    pool_cache_free(&cache, objects[8]);
+    assert(num_locks == 1);
+    assert(stack_size(&cache.free_objects) == 4);
+    assert(pool_size(&pool) == NUM_OBJECTS - 5);
+
+    /* The cache hands out its own objects first, most recently freed first. */
+    assert(pool_cache_alloc(&cache) == objects[3]);
+    assert(num_locks == 1);
+
+    for (i = 9; i < NUM_OBJECTS; ++i) {
+        pool_cache_free(&cache, objects[i]);
+    }
+
+    /* Only the object taken back from the cache is still in use. */
+    assert(stack_size(&cache.free_objects) <= 8);
+    assert(pool_size(&pool) - stack_size(&cache.free_objects) == 1);
+}
+
+void test_pool_cache_flush(void) {
+    size_t i;
+
+    pool_set_lock(&pool, lock_, unlock_, &num_locks);
+    pool_cache_init(&cache, &pool, 64);
+
+    pool_cache_flush(&cache);
+    assert(num_locks == 0);
+
+    for (i = 0; i < NUM_OBJECTS; ++i) {
+        objects[i] = (TestStruct*) pool_cache_alloc(&cache);
+    }
+    for (i = 0; i < 50; ++i) {
+        pool_cache_free(&cache, objects[i]);
+    }
+    assert(!stack_empty(&cache.free_objects));
+
+    num_locks = 0;
+    pool_cache_flush(&cache);
+    assert(num_locks == 1);
+    assert(stack_empty(&cache.free_objects));
+    assert(pool_size(&pool) == NUM_OBJECTS - 50);
+    assert(stack_size(&pool.free_objects) >= 50);
+}
+
+void test_pool_reset(void) {
+    size_t i;
+
+    pool_reset(&pool);
+    assert(pool_size(&pool) == 0);
+
+    alloc_objects_(NUM_OBJECTS);
+    for (i = 0; i < NUM_OBJECTS; i += 3) {
+        pool_free(&pool, objects[i]);
+    }
+
+    /* The chunks are kept and carved again in the same order. */
+    pool_reset(&pool);
+    assert(pool_size(&pool) == 0);
+    assert(stack_empty(&pool.free_objects));
+    for (i = 0; i < NUM_OBJECTS; ++i) {
+        assert(pool_alloc(&pool) == objects[i]);
+    }
+    assert(num_chunks == (NUM_OBJECTS + OBJECTS_PER_CHUNK - 1) / OBJECTS_PER_CHUNK);
+    assert(pool_size(&pool) == NUM_OBJECTS);
+
+    /* Allocating past the kept chunks allocates new ones. */
+    assert(pool_alloc(&pool) != NULL);
+    assert(num_chunks == (NUM_OBJECTS + OBJECTS_PER_CHUNK - 1) / OBJECTS_PER_CHUNK + 1);
+}
+
+void test_pool_release(void) {
+    void *memory = malloc(CHUNK_SIZE);
+
+    pool_release(&pool);
+    assert(pool.head == NULL && pool_size(&pool) == 0);
+
+    alloc_objects_(NUM_OBJECTS);
+    pool_add_chunk(&pool, memory, CHUNK_SIZE);
+    assert(num_chunks > 0);
+
+    pool_release(&pool);
+    assert(num_chunks == 0);
+    assert(pool.head == NULL && pool.current == NULL);
+    assert(pool_size(&pool) == 0);
+    assert(stack_empty(&pool.free_objects));
+
+    /* The pool can be used again. */
+    alloc_objects_(OBJECTS_PER_CHUNK + 1);
+    assert_objects_intact_(OBJECTS_PER_CHUNK + 1);
+    assert(num_chunks == 2);
+
+    free(memory);
+}
+
+TestFunc test_funcs[] = {
+    test_pool_init,
+    test_pool_set_lock,
+    test_pool_cache_init,
+    test_pool_size,
+    test_pool_object_size,
+    test_pool_add_chunk,
+    test_pool_alloc,
+    test_pool_free,
+    test_pool_cache_alloc,
+    test_pool_cache_free,
+    test_pool_cache_flush,
+    test_pool_reset,
+    test_pool_release
+};
+
+int main(int argc, char *argv[]) {
+    char msg[100] = "Pool ";
+    assert(argc == 2);
+    strcat(msg, argv[1]);
+
+    assert(sizeof(test_funcs) / sizeof(TestFunc) == 13);
+    run_tests(test_funcs, sizeof(test_funcs) / sizeof(TestFunc), msg, reset_globals);
+
+    return 0;
+}
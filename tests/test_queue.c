@@ -203,6 +203,25 @@ void test_queue_for_each(void) {
     assert(i == 3);
 }
 
+void test_queue_for_each_prefetch(void) {
+    QueueNode *n;
+    size_t i = 0;
+
+    queue_for_each_prefetch(n, &queue) {
+        assert(0);
+    }
+
+    queue_push(&queue, &var1.node);
+    queue_push(&queue, &var2.node);
+    queue_push(&queue, &var3.node);
+
+    queue_for_each_prefetch(n, &queue) {
+        ASSERT_FOR_EACH(n, i);
+        ++i;
+    }
+    assert(i == 3);
+}
+
 void test_queue_for_each_safe(void) {
     QueueNode *n, *backup;
     size_t i = 0;
@@ -234,6 +253,7 @@ TestFunc test_funcs[] = {
     test_queue_remove_all,
     test_queue_entry,
     test_queue_for_each,
+    test_queue_for_each_prefetch,
     test_queue_for_each_safe
 };
 
@@ -242,7 +262,7 @@ int main(int argc, char *argv[]) {
     assert(argc == 2);
     strcat(msg, argv[1]);
 
-    assert(sizeof(test_funcs) / sizeof(TestFunc) == 10);
+    assert(sizeof(test_funcs) / sizeof(TestFunc) == 11);
     run_tests(test_funcs, sizeof(test_funcs) / sizeof(TestFunc), msg, reset_globals);
 
     return 0;
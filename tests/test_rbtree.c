@@ -46,6 +46,9 @@ RBTree rbtree;
 size_t counter;
 void *aux_ptr;
 
+/* The number of times compare_func was called. */
+size_t num_compares;
+
 #define ASSERT_RBTREE(rbtree, root_ptr, size_of_rbtree) \
     do { \
         assert(rbtree.root == (RBTreeNode*) (root_ptr)); \
@@ -345,6 +348,7 @@ static void p3_(RBTreeNode *node) {
     for (counter = 0; counter < 5000; ++counter)
 
 static int compare_func(const void *key, const RBTreeNode *node) {
+    ++num_compares;
     return *(const int*)key - rbtree_entry(node, TestStruct, node)->key;
 }
 
@@ -355,8 +359,40 @@ static void collide_func(const RBTreeNode *old_node, const RBTreeNode *new_node,
     rbtree_entry(new_node, TestStruct, node)->num_similar_keys += 1 + rbtree_entry(old_node, TestStruct, node)->num_similar_keys;
 }
 
+/* Checks that every child in the subtree of the @ref node links back to its parent. */
+static void links_(RBTreeNode *node) {
+    if (!node) {
+        return;
+    }
+
+    assert(!node->left_child || node->left_child->parent == node);
+    assert(!node->right_child || node->right_child->parent == node);
+
+    links_(node->left_child);
+    links_(node->right_child);
+}
+
+/* Fills @ref objects with the keys 0, 2, 4, ... in a random order. */
+static void shuffle_(TestStruct *objects, size_t num_objects) {
+    size_t i, j;
+    int key;
+
+    for (i = 0; i < num_objects; ++i) {
+        objects[i].key = (int) (2 * i);
+        objects[i].num_similar_keys = 0;
+    }
+
+    for (i = num_objects; i > 1; --i) {
+        j = (size_t) rand() % i;
+        key = objects[i - 1].key;
+        objects[i - 1].key = objects[j].key;
+        objects[j].key = key;
+    }
+}
+
 static void reset_globals(void) {
     rbtree_init(&rbtree, compare_func, collide_func, &aux_ptr);
+    num_compares = 0;
 
     var1.key = 1;
     var1.num_similar_keys = 0;
@@ -924,6 +960,188 @@ void test_rbtree_insert(void) {
     }
 }
 
+void test_rbtree_insert_near(void) {
+    TestStruct *vars[7];
+    size_t i;
+
+    vars[0] = &var1; vars[1] = &var2; vars[2] = &var3; vars[3] = &var4;
+    vars[4] = &var5; vars[5] = &var6; vars[6] = &var7;
+
+    /* A NULL hint searches from the root, which gives the same tree as rbtree_insert. */
+    rbtree_insert_near(&rbtree, NULL, &var1.key, &var1.node);
+    ASSERT_RBTREE(rbtree, &var1.node, 1);
+    ASSERT_NODE(var1.node, NULL, NULL, NULL, RBTREE_NODE_BLACK);
+
+    /* Ascending keys, each one near the one before it. */
+    for (i = 1; i < 7; ++i) {
+        rbtree_insert_near(&rbtree, &vars[i - 1]->node, &vars[i]->key, &vars[i]->node);
+        ASSERT_PROPERTIES(rbtree);
+    }
+    ASSERT_RBTREE(rbtree, &var2.node, 7);
+    ASSERT_NODE(var1.node, &var2.node, NULL, NULL, RBTREE_NODE_BLACK);
+    ASSERT_NODE(var2.node, NULL, &var1.node, &var4.node, RBTREE_NODE_BLACK);
+    ASSERT_NODE(var3.node, &var4.node, NULL, NULL, RBTREE_NODE_BLACK);
+    ASSERT_NODE(var4.node, &var2.node, &var3.node, &var6.node, RBTREE_NODE_RED);
+    ASSERT_NODE(var5.node, &var6.node, NULL, NULL, RBTREE_NODE_RED);
+    ASSERT_NODE(var6.node, &var4.node, &var5.node, &var7.node, RBTREE_NODE_BLACK);
+    ASSERT_NODE(var7.node, &var6.node, NULL, NULL, RBTREE_NODE_RED);
+    ASSERT_INORDERNESS(rbtree);
+
+    /* An equal key collides, whether it is found above or below the hint. */
+    rbtree_remove(&rbtree, &var7.node);
+    var7.key = 4;
+    rbtree_insert_near(&rbtree, &var1.node, &var7.key, &var7.node);
+    assert(var7.num_similar_keys == 1);
+    ASSERT_RBTREE(rbtree, &var2.node, 6);
+    ASSERT_NODE(var7.node, &var2.node, &var3.node, &var6.node, RBTREE_NODE_RED);
+    ASSERT_PROPERTIES(rbtree);
+    rbtree_insert_near(&rbtree, &var6.node, &var4.key, &var4.node);
+    assert(var4.num_similar_keys == 2);
+    ASSERT_RBTREE(rbtree, &var2.node, 6);
+    ASSERT_NODE(var4.node, &var2.node, &var3.node, &var6.node, RBTREE_NODE_RED);
+    ASSERT_PROPERTIES(rbtree);
+    reset_globals();
+
+    /* Descending keys, each one near the one before it. */
+    rbtree_insert_near(&rbtree, NULL, &var7.key, &var7.node);
+    for (i = 6; i-- > 0;) {
+        rbtree_insert_near(&rbtree, &vars[i + 1]->node, &vars[i]->key, &vars[i]->node);
+        ASSERT_PROPERTIES(rbtree);
+    }
+    ASSERT_RBTREE(rbtree, &var6.node, 7);
+    ASSERT_INORDERNESS(rbtree);
+    reset_globals();
+
+    /* Random keys, near random hints. */
+    loop {
+        int vars_used[7] = { 0, 0, 0, 0, 0, 0, 0 };
+        int x, hint;
+
+        for (i = 0; i < 7; ++i) {
+            do {
+                x = rand() % 7;
+            } while (vars_used[x]);
+            do {
+                hint = rand() % 8;
+            } while (hint < 7 && !vars_used[hint]);
+
+            rbtree_insert_near(&rbtree, hint < 7 ? &vars[hint]->node : NULL, &vars[x]->key, &vars[x]->node);
+            vars_used[x] = 1;
+            ASSERT_PROPERTIES(rbtree);
+        }
+        ASSERT_INORDERNESS(rbtree);
+
+        reset_globals();
+    }
+}
+
+void test_rbtree_insert_sorted(void) {
+    static TestStruct objects[1000];
+    const void *keys[1000];
+    RBTreeNode *nodes[1000];
+    size_t i, num_root_compares;
+
+    rbtree_insert_sorted(&rbtree, NULL, NULL, 0);
+    ASSERT_RBTREE(rbtree, NULL, 0);
+
+    keys[0] = &var1.key; keys[1] = &var2.key; keys[2] = &var3.key; keys[3] = &var4.key;
+    keys[4] = &var5.key; keys[5] = &var6.key; keys[6] = &var7.key;
+    nodes[0] = &var1.node; nodes[1] = &var2.node; nodes[2] = &var3.node; nodes[3] = &var4.node;
+    nodes[4] = &var5.node; nodes[5] = &var6.node; nodes[6] = &var7.node;
+    rbtree_insert_sorted(&rbtree, keys, nodes, 7);
+    ASSERT_RBTREE(rbtree, &var2.node, 7);
+    ASSERT_PROPERTIES(rbtree);
+    ASSERT_INORDERNESS(rbtree);
+
+    /* Equal keys collide, within the batch and with the tree. */
+    rbtree_remove(&rbtree, &var6.node);
+    rbtree_remove(&rbtree, &var7.node);
+    var6.key = 2;
+    var7.key = 2;
+    rbtree_insert_sorted(&rbtree, keys + 5, nodes + 5, 2);
+    assert(var6.num_similar_keys == 1);
+    assert(var7.num_similar_keys == 2);
+    assert(rbtree_size(&rbtree) == 5 && rbtree_at(&rbtree, 1) == &var7.node);
+    ASSERT_PROPERTIES(rbtree);
+    reset_globals();
+
+    /* Sorted keys take far fewer comparisons than inserting each one from the root. */
+    for (i = 0; i < 1000; ++i) {
+        objects[i].key = (int) i;
+        keys[i] = &objects[i].key;
+        nodes[i] = &objects[i].node;
+        rbtree_insert(&rbtree, keys[i], nodes[i]);
+    }
+    num_root_compares = num_compares;
+    reset_globals();
+
+    rbtree_insert_sorted(&rbtree, keys, nodes, 1000);
+    assert(rbtree_size(&rbtree) == 1000);
+    ASSERT_PROPERTIES(rbtree);
+    for (i = 0; i < 1000; ++i) {
+        assert(rbtree_at(&rbtree, i) == nodes[i]);
+    }
+    assert(num_compares * 3 < num_root_compares);
+}
+
+void test_rbtree_insert_top_down(void) {
+    static TestStruct objects[1000];
+    RBTreeNode *node;
+    size_t i;
+    int key;
+
+    rbtree_insert_top_down(&rbtree, &var1.key, &var1.node);
+    ASSERT_RBTREE(rbtree, &var1.node, 1);
+    ASSERT_NODE(var1.node, NULL, NULL, NULL, RBTREE_NODE_BLACK);
+    rbtree_insert_top_down(&rbtree, &var2.key, &var2.node);
+    rbtree_insert_top_down(&rbtree, &var3.key, &var3.node);
+    rbtree_insert_top_down(&rbtree, &var4.key, &var4.node);
+    rbtree_insert_top_down(&rbtree, &var5.key, &var5.node);
+    rbtree_insert_top_down(&rbtree, &var6.key, &var6.node);
+    rbtree_insert_top_down(&rbtree, &var7.key, &var7.node);
+    ASSERT_RBTREE(rbtree, &var2.node, 7);
+    ASSERT_PROPERTIES(rbtree);
+    ASSERT_INORDERNESS(rbtree);
+    links_(rbtree.root);
+
+    /* An equal key replaces the existing node. */
+    rbtree_remove(&rbtree, &var7.node);
+    var7.key = 4;
+    rbtree_insert_top_down(&rbtree, &var7.key, &var7.node);
+    assert(var7.num_similar_keys == 1);
+    assert(rbtree_size(&rbtree) == 6 && rbtree_lookup_key(&rbtree, &var7.key) == &var7.node);
+    ASSERT_PROPERTIES(rbtree);
+    links_(rbtree.root);
+    reset_globals();
+
+    rbtree_insert_top_down(&rbtree, &var7.key, &var7.node);
+    rbtree_insert_top_down(&rbtree, &var6.key, &var6.node);
+    rbtree_insert_top_down(&rbtree, &var5.key, &var5.node);
+    rbtree_insert_top_down(&rbtree, &var4.key, &var4.node);
+    rbtree_insert_top_down(&rbtree, &var3.key, &var3.node);
+    rbtree_insert_top_down(&rbtree, &var2.key, &var2.node);
+    rbtree_insert_top_down(&rbtree, &var1.key, &var1.node);
+    assert(rbtree_size(&rbtree) == 7);
+    ASSERT_PROPERTIES(rbtree);
+    ASSERT_INORDERNESS(rbtree);
+    links_(rbtree.root);
+    reset_globals();
+
+    shuffle_(objects, 1000);
+    for (i = 0; i < 1000; ++i) {
+        rbtree_insert_top_down(&rbtree, &objects[i].key, &objects[i].node);
+        ASSERT_PROPERTIES(rbtree);
+    }
+    assert(rbtree_size(&rbtree) == 1000);
+    links_(rbtree.root);
+    key = 0;
+    rbtree_for_each(node, &rbtree) {
+        assert(rbtree_entry(node, TestStruct, node)->key == key);
+        key += 2;
+    }
+    reset_globals();
+}
+
 void test_rbtree_lookup_key(void) {
     assert(rbtree_lookup_key(&rbtree, &var1.key) == NULL);
 
@@ -1190,6 +1408,74 @@ void test_rbtree_remove_key(void) {
     }
 }
 
+void test_rbtree_remove_key_top_down(void) {
+    static TestStruct objects[1000];
+    RBTreeNode *node;
+    size_t i, size;
+    int key;
+
+    assert(rbtree_remove_key_top_down(&rbtree, &var1.key) == NULL);
+    ASSERT_RBTREE(rbtree, NULL, 0);
+
+    rbtree_insert(&rbtree, &var1.key, &var1.node);
+    assert(rbtree_remove_key_top_down(&rbtree, &var2.key) == NULL);
+    assert(rbtree_remove_key_top_down(&rbtree, &var1.key) == &var1.node);
+    ASSERT_RBTREE(rbtree, NULL, 0);
+    ASSERT_NODE(var1.node, RBTREE_POISON_PARENT, RBTREE_POISON_LEFT_CHILD, RBTREE_POISON_RIGHT_CHILD, var1.node.color);
+    reset_globals();
+
+    FILL_SEQUENTIALLY(rbtree);
+    assert(rbtree_remove_key_top_down(&rbtree, &var2.key) == &var2.node);
+    ASSERT_NODE(var2.node, RBTREE_POISON_PARENT, RBTREE_POISON_LEFT_CHILD, RBTREE_POISON_RIGHT_CHILD, var2.node.color);
+    assert(rbtree_size(&rbtree) == 6 && rbtree_contains_key(&rbtree, &var2.key) == 0);
+    ASSERT_PROPERTIES(rbtree);
+    links_(rbtree.root);
+    assert(rbtree_remove_key_top_down(&rbtree, &var4.key) == &var4.node);
+    assert(rbtree_remove_key_top_down(&rbtree, &var1.key) == &var1.node);
+    assert(rbtree_remove_key_top_down(&rbtree, &var7.key) == &var7.node);
+    assert(rbtree_size(&rbtree) == 3);
+    ASSERT_PROPERTIES(rbtree);
+    links_(rbtree.root);
+    assert(rbtree_next(&var3.node) == &var5.node && rbtree_next(&var5.node) == &var6.node);
+    assert(rbtree_remove_key_top_down(&rbtree, &var5.key) == &var5.node);
+    assert(rbtree_remove_key_top_down(&rbtree, &var3.key) == &var3.node);
+    assert(rbtree_remove_key_top_down(&rbtree, &var6.key) == &var6.node);
+    ASSERT_RBTREE(rbtree, NULL, 0);
+    reset_globals();
+
+    /* Keys are even, so looking up odd keys restructures the tree without removing anything. */
+    loop {
+        if (counter % 100 == 0) {
+            reset_globals();
+            shuffle_(objects, 1000);
+            for (i = 0; i < 1000; ++i) {
+                rbtree_insert(&rbtree, &objects[i].key, &objects[i].node);
+            }
+        }
+
+        key = rand() % 2000;
+        size = rbtree_size(&rbtree);
+        node = rbtree_remove_key_top_down(&rbtree, &key);
+        if (node) {
+            assert(key % 2 == 0 && rbtree_entry(node, TestStruct, node)->key == key);
+            assert(node->parent == RBTREE_POISON_PARENT);
+            assert(rbtree_size(&rbtree) == size - 1);
+        } else {
+            assert(rbtree_size(&rbtree) == size);
+        }
+        assert(rbtree_contains_key(&rbtree, &key) == 0);
+        ASSERT_PROPERTIES(rbtree);
+        links_(rbtree.root);
+    }
+
+    i = 0;
+    rbtree_for_each(node, &rbtree) {
+        ++i;
+    }
+    assert(i == rbtree_size(&rbtree));
+    reset_globals();
+}
+
 void test_rbtree_remove_first(void) {
     rbtree_remove_first(&rbtree);
     ASSERT_RBTREE(rbtree, NULL, 0);
@@ -1457,6 +1743,50 @@ void test_rbtree_for_each_reverse(void) {
     }
 }
 
+void test_rbtree_for_each_prefetch(void) {
+    RBTreeNode *n;
+
+    rbtree_for_each_prefetch(n, &rbtree) {
+        assert(0);
+    }
+
+    loop {
+        size_t i = 0;
+
+        FILL_RANDOMLY(rbtree);
+
+        rbtree_for_each_prefetch(n, &rbtree) {
+            ASSERT_FOR_EACH(n, i);
+            ++i;
+        }
+        assert(i == 7);
+
+        reset_globals();
+    }
+}
+
+void test_rbtree_for_each_prefetch_reverse(void) {
+    RBTreeNode *n;
+
+    rbtree_for_each_prefetch_reverse(n, &rbtree) {
+        assert(0);
+    }
+
+    loop {
+        size_t i = 7;
+
+        FILL_RANDOMLY(rbtree);
+
+        rbtree_for_each_prefetch_reverse(n, &rbtree) {
+            --i;
+            ASSERT_FOR_EACH(n, i);
+        }
+        assert(i == 0);
+
+        reset_globals();
+    }
+}
+
 void test_rbtree_for_each_safe(void) {
     RBTreeNode *n, *backup;
 
@@ -1709,15 +2039,21 @@ TestFunc test_funcs[] = {
     test_rbtree_index_of,
     test_rbtree_at,
     test_rbtree_insert,
+    test_rbtree_insert_near,
+    test_rbtree_insert_sorted,
+    test_rbtree_insert_top_down,
     test_rbtree_lookup_key,
     test_rbtree_remove,
     test_rbtree_remove_key,
+    test_rbtree_remove_key_top_down,
     test_rbtree_remove_first,
     test_rbtree_remove_last,
     test_rbtree_remove_all,
     test_rbtree_entry,
     test_rbtree_for_each,
     test_rbtree_for_each_reverse,
+    test_rbtree_for_each_prefetch,
+    test_rbtree_for_each_prefetch_reverse,
     test_rbtree_for_each_safe,
     test_rbtree_for_each_safe_reverse,
     test_rbtree_for_each_after,
@@ -1735,7 +2071,7 @@ int main(int argc, char *argv[]) {
     assert(argc == 2);
     strcat(msg, argv[1]);
 
-    assert(sizeof(test_funcs) / sizeof(TestFunc) == 30);
+    assert(sizeof(test_funcs) / sizeof(TestFunc) == 36);
     run_tests(test_funcs, sizeof(test_funcs) / sizeof(TestFunc), msg, reset_globals);
 
     return 0;
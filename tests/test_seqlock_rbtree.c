@@ -0,0 +1,377 @@
+/*
+Copyright (c) 2017, Michael J Welsh
+
+Permission to use, copy, modify, and/or distribute this software
+for any purpose with or without fee is hereby granted, provided
+that the above copyright notice and this permission notice appear
+in all copies.
+
+THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL
+WARRANTIES WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE
+AUTHOR BE LIABLE FOR ANY SPECIAL, DIRECT, INDIRECT, OR
+CONSEQUENTIAL DAMAGES OR ANY DAMAGES WHATSOEVER RESULTING FROM
+LOSS OF USE, DATA OR PROFITS, WHETHER IN AN ACTION OF CONTRACT,
+NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF OR IN
+CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <stddef.h>
+#include <string.h>
+#include <assert.h>
+#include <pthread.h>
+
+#include "testing_framework.h"
+
+/* Test header guard. */
+#include "../src/seqlock_rbtree.h"
+#include "../src/seqlock_rbtree.h"
+
+/* ========================================================================================================
+ *
+ *                                             TESTING UTILITIES
+ *
+ * ======================================================================================================== */
+
+#define NUM_OBJECTS 1000
+#define NUM_READERS 3
+#define NUM_UPDATES 20000
+
+/* The number of consecutive keys a reader scan visits. */
+#define SCAN_LENGTH 8
+
+typedef struct TestStruct {
+    int key;
+    int val;
+    RBTreeNode n;
+} TestStruct;
+
+typedef struct Reader {
+    pthread_t thread;
+    unsigned long random_state;
+    size_t num_reads;
+} Reader;
+
+TestStruct objects[NUM_OBJECTS];
+SeqlockRBTree tree;
+Reader readers[NUM_READERS];
+int done;
+
+static int compare_(const void *key, const RBTreeNode *node) {
+    return *(const int*) key - rbtree_entry(node, TestStruct, n)->key;
+}
+
+static int key_of_(const RBTreeNode *node) {
+    return rbtree_entry(node, TestStruct, n)->key;
+}
+
+/* Returns the key inserted i-th, so that keys are not inserted in order. */
+static int shuffled_key_(int i) {
+    return (int) ((i * 7919L) % NUM_OBJECTS);
+}
+
+static void insert_objects_(void) {
+    int i;
+
+    for (i = 0; i < NUM_OBJECTS; ++i) {
+        seqlock_rbtree_insert(&tree, &objects[shuffled_key_(i)].key, &objects[shuffled_key_(i)].n);
+    }
+}
+
+static int reader_random_(Reader *reader) {
+    reader->random_state ^= reader->random_state << 13;
+    reader->random_state ^= reader->random_state >> 17;
+    reader->random_state ^= reader->random_state << 5;
+
+    return (int) (reader->random_state % NUM_OBJECTS);
+}
+
+/*
+ * Checks lookups and scans against the writer, which only ever inserts and removes odd keys: a validated
+ * read section always finds the even keys, and scans keys in order without skipping an even key.
+ */
+static void* run_reader_(void *arg) {
+    Reader *reader = (Reader*) arg;
+    const RBTreeNode *found, *node;
+    int keys[SCAN_LENGTH], key, num_keys, i;
+    size_t sequence;
+
+    while (!__atomic_load_n(&done, __ATOMIC_ACQUIRE)) {
+        key = reader_random_(reader) & ~1;
+
+        do {
+            sequence = seqlock_rbtree_read_begin(&tree);
+            found = seqlock_rbtree_find(&tree, &key);
+            num_keys = 0;
+            for (node = found; node && num_keys < SCAN_LENGTH; node = seqlock_rbtree_next(node)) {
+                keys[num_keys++] = key_of_(node);
+            }
+        } while (seqlock_rbtree_read_retry(&tree, sequence));
+
+        assert(found && key_of_(found) == key);
+        assert(num_keys == SCAN_LENGTH || keys[num_keys - 1] >= NUM_OBJECTS - 2);
+        for (i = 1; i < num_keys; ++i) {
+            assert(keys[i] > keys[i - 1] && keys[i] - keys[i - 1] <= 2);
+        }
+
+        ++reader->num_reads;
+    }
+
+    return NULL;
+}
+
+static void reset_globals(void) {
+    int i;
+
+    for (i = 0; i < NUM_OBJECTS; ++i) {
+        objects[i].key = i;
+        objects[i].val = i * i;
+    }
+    seqlock_rbtree_init(&tree, compare_, NULL, NULL);
+    done = 0;
+}
+
+/* ========================================================================================================
+ *
+ *                                             TESTING FUNCTIONS
+ *
+ * ======================================================================================================== */
+
+void test_seqlock_rbtree_init(void) {
+    int aux;
+
+    seqlock_rbtree_init(&tree, compare_, NULL, &aux);
+    assert(tree.rbtree.compare == compare_);
+    assert(tree.rbtree.collide == NULL);
+    assert(tree.rbtree.auxiliary_data == &aux);
+    assert(tree.rbtree.root == NULL);
+    assert(tree.rbtree.size == 0);
+    assert(tree.sequence == 0);
+}
+
+void test_seqlock_rbtree_rbtree(void) {
+    assert(seqlock_rbtree_rbtree(&tree) == &tree.rbtree);
+
+    insert_objects_();
+    assert(rbtree_size(seqlock_rbtree_rbtree(&tree)) == NUM_OBJECTS);
+    assert(rbtree_first(seqlock_rbtree_rbtree(&tree)) == &objects[0].n);
+}
+
+void test_seqlock_rbtree_size(void) {
+    assert(seqlock_rbtree_size(&tree) == 0);
+
+    insert_objects_();
+    assert(seqlock_rbtree_size(&tree) == NUM_OBJECTS);
+
+    seqlock_rbtree_remove(&tree, &objects[3].n);
+    assert(seqlock_rbtree_size(&tree) == NUM_OBJECTS - 1);
+}
+
+void test_seqlock_rbtree_write_begin(void) {
+    size_t sequence;
+
+    sequence = seqlock_rbtree_read_begin(&tree);
+    seqlock_rbtree_write_begin(&tree);
+    assert(tree.sequence % 2 == 1);
+    assert(seqlock_rbtree_read_retry(&tree, sequence));
+
+    /* Any number of RBTree updates make up one write. */
+    rbtree_insert(seqlock_rbtree_rbtree(&tree), &objects[1].key, &objects[1].n);
+    rbtree_insert(seqlock_rbtree_rbtree(&tree), &objects[2].key, &objects[2].n);
+    seqlock_rbtree_write_end(&tree);
+    assert(tree.sequence == 2);
+    assert(seqlock_rbtree_size(&tree) == 2);
+}
+
+void test_seqlock_rbtree_write_end(void) {
+    size_t sequence;
+
+    seqlock_rbtree_write_begin(&tree);
+    seqlock_rbtree_write_end(&tree);
+    assert(tree.sequence == 2);
+
+    sequence = seqlock_rbtree_read_begin(&tree);
+    assert(sequence == 2);
+    assert(!seqlock_rbtree_read_retry(&tree, sequence));
+}
+
+void test_seqlock_rbtree_insert(void) {
+    int i;
+
+    insert_objects_();
+    assert(tree.sequence == 2 * NUM_OBJECTS);
+    assert(seqlock_rbtree_size(&tree) == NUM_OBJECTS);
+    for (i = 0; i < NUM_OBJECTS; ++i) {
+        assert(seqlock_rbtree_lookup_key(&tree, &i) == &objects[i].n);
+    }
+}
+
+void test_seqlock_rbtree_remove(void) {
+    int i, key;
+
+    insert_objects_();
+    for (i = 0; i < NUM_OBJECTS; i += 2) {
+        key = shuffled_key_(i);
+        seqlock_rbtree_remove(&tree, &objects[key].n);
+        assert(!seqlock_rbtree_contains_key(&tree, &key));
+    }
+    assert(seqlock_rbtree_size(&tree) == NUM_OBJECTS / 2);
+    assert(tree.sequence == 2 * NUM_OBJECTS + NUM_OBJECTS);
+}
+
+void test_seqlock_rbtree_remove_key(void) {
+    int key = NUM_OBJECTS;
+
+    insert_objects_();
+    assert(seqlock_rbtree_remove_key(&tree, &key) == NULL);
+
+    for (key = 0; key < NUM_OBJECTS; ++key) {
+        assert(seqlock_rbtree_remove_key(&tree, &key) == &objects[key].n);
+        assert(seqlock_rbtree_remove_key(&tree, &key) == NULL);
+    }
+    assert(seqlock_rbtree_size(&tree) == 0);
+}
+
+void test_seqlock_rbtree_read_begin(void) {
+    assert(seqlock_rbtree_read_begin(&tree) == 0);
+
+    insert_objects_();
+    assert(seqlock_rbtree_read_begin(&tree) == 2 * NUM_OBJECTS);
+}
+
+void test_seqlock_rbtree_read_retry(void) {
+    size_t sequence;
+    int key = 5;
+
+    sequence = seqlock_rbtree_read_begin(&tree);
+    assert(!seqlock_rbtree_read_retry(&tree, sequence));
+
+    seqlock_rbtree_insert(&tree, &objects[key].key, &objects[key].n);
+    assert(seqlock_rbtree_read_retry(&tree, sequence));
+
+    sequence = seqlock_rbtree_read_begin(&tree);
+    assert(seqlock_rbtree_find(&tree, &key) == &objects[key].n);
+    assert(!seqlock_rbtree_read_retry(&tree, sequence));
+}
+
+void test_seqlock_rbtree_find(void) {
+    int key = -1;
+
+    assert(seqlock_rbtree_find(&tree, &key) == NULL);
+
+    insert_objects_();
+    assert(seqlock_rbtree_find(&tree, &key) == NULL);
+    for (key = 0; key < NUM_OBJECTS; ++key) {
+        assert(seqlock_rbtree_find(&tree, &key) == &objects[key].n);
+    }
+    assert(seqlock_rbtree_find(&tree, &key) == NULL);
+}
+
+void test_seqlock_rbtree_first(void) {
+    assert(seqlock_rbtree_first(&tree) == NULL);
+
+    insert_objects_();
+    assert(seqlock_rbtree_first(&tree) == &objects[0].n);
+
+    seqlock_rbtree_remove(&tree, &objects[0].n);
+    assert(seqlock_rbtree_first(&tree) == &objects[1].n);
+}
+
+void test_seqlock_rbtree_next(void) {
+    const RBTreeNode *node;
+    int i = 0;
+
+    insert_objects_();
+    for (node = seqlock_rbtree_first(&tree); node; node = seqlock_rbtree_next(node)) {
+        assert(node == &objects[i].n);
+        ++i;
+    }
+    assert(i == NUM_OBJECTS);
+}
+
+void test_seqlock_rbtree_lookup_key(void) {
+    int key = 7;
+
+    assert(seqlock_rbtree_lookup_key(&tree, &key) == NULL);
+
+    insert_objects_();
+    assert(seqlock_rbtree_lookup_key(&tree, &key) == &objects[key].n);
+
+    seqlock_rbtree_remove(&tree, &objects[key].n);
+    assert(seqlock_rbtree_lookup_key(&tree, &key) == NULL);
+}
+
+void test_seqlock_rbtree_contains_key(void) {
+    int key = NUM_OBJECTS;
+
+    insert_objects_();
+    assert(!seqlock_rbtree_contains_key(&tree, &key));
+    for (key = 0; key < NUM_OBJECTS; ++key) {
+        assert(seqlock_rbtree_contains_key(&tree, &key));
+    }
+}
+
+void test_seqlock_rbtree_readers(void) {
+    unsigned long random_state = 88172645463325252ul;
+    int i, key;
+
+    insert_objects_();
+    for (i = 0; i < NUM_READERS; ++i) {
+        readers[i].random_state = 2463534242ul + i;
+        readers[i].num_reads = 0;
+        assert(pthread_create(&readers[i].thread, NULL, run_reader_, &readers[i]) == 0);
+    }
+
+    /* Toggles random odd keys, which rebalances the tree under the readers. */
+    for (i = 0; i < NUM_UPDATES; ++i) {
+        random_state ^= random_state << 13;
+        random_state ^= random_state >> 7;
+        random_state ^= random_state << 17;
+        key = (int) (random_state % NUM_OBJECTS) | 1;
+
+        if (!seqlock_rbtree_remove_key(&tree, &key)) {
+            seqlock_rbtree_insert(&tree, &objects[key].key, &objects[key].n);
+        }
+    }
+
+    __atomic_store_n(&done, 1, __ATOMIC_RELEASE);
+    for (i = 0; i < NUM_READERS; ++i) {
+        assert(pthread_join(readers[i].thread, NULL) == 0);
+    }
+    assert(tree.sequence % 2 == 0);
+    for (key = 0; key < NUM_OBJECTS; key += 2) {
+        assert(seqlock_rbtree_lookup_key(&tree, &key) == &objects[key].n);
+    }
+}
+
+TestFunc test_funcs[] = {
+    test_seqlock_rbtree_init,
+    test_seqlock_rbtree_rbtree,
+    test_seqlock_rbtree_size,
+    test_seqlock_rbtree_write_begin,
+    test_seqlock_rbtree_write_end,
+    test_seqlock_rbtree_insert,
+    test_seqlock_rbtree_remove,
+    test_seqlock_rbtree_remove_key,
+    test_seqlock_rbtree_read_begin,
+    test_seqlock_rbtree_read_retry,
+    test_seqlock_rbtree_find,
+    test_seqlock_rbtree_first,
+    test_seqlock_rbtree_next,
+    test_seqlock_rbtree_lookup_key,
+    test_seqlock_rbtree_contains_key,
+    test_seqlock_rbtree_readers
+};
+
+int main(int argc, char *argv[]) {
+    char msg[100] = "SeqlockRBTree ";
+    assert(argc == 2);
+    strcat(msg, argv[1]);
+
+    assert(sizeof(test_funcs) / sizeof(TestFunc) == 16);
+    run_tests(test_funcs, sizeof(test_funcs) / sizeof(TestFunc), msg, reset_globals);
+
+    return 0;
+}
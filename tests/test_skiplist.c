@@ -0,0 +1,426 @@
+/*
+Copyright (c) 2017, Michael J Welsh
+
+Permission to use, copy, modify, and/or distribute this software
+for any purpose with or without fee is hereby granted, provided
+that the above copyright notice and this permission notice appear
+in all copies.
+
+THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL
+WARRANTIES WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE
+AUTHOR BE LIABLE FOR ANY SPECIAL, DIRECT, INDIRECT, OR
+CONSEQUENTIAL DAMAGES OR ANY DAMAGES WHATSOEVER RESULTING FROM
+LOSS OF USE, DATA OR PROFITS, WHETHER IN AN ACTION OF CONTRACT,
+NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF OR IN
+CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <stddef.h>
+#include <string.h>
+#include <assert.h>
+#include <pthread.h>
+
+#include "testing_framework.h"
+
+/* Test header guard. */
+#include "../src/skiplist.h"
+#include "../src/skiplist.h"
+
+/* ========================================================================================================
+ *
+ *                                             TESTING UTILITIES
+ *
+ * ======================================================================================================== */
+
+#define NUM_OBJECTS 1000
+#define NUM_THREADS 4
+
+typedef struct TestStruct {
+    int key;
+    int val;
+    SkipListNode n;
+} TestStruct;
+
+typedef struct Worker {
+    pthread_t thread;
+    TestStruct *objects;
+    int first_key;
+    size_t num_removed;
+} Worker;
+
+TestStruct objects[NUM_THREADS][NUM_OBJECTS];
+SkipList list;
+Worker workers[NUM_THREADS];
+
+/* The number of times collide_ was called. */
+size_t num_collisions;
+
+static int compare_(const void *key, const SkipListNode *node) {
+    return *(const int*) key - skiplist_entry(node, TestStruct, n)->key;
+}
+
+static void collide_(const SkipListNode *old_node, const SkipListNode *new_node, void *auxiliary_data) {
+    assert(old_node && new_node && old_node != new_node && auxiliary_data == &num_collisions);
+    assert(skiplist_entry(old_node, TestStruct, n)->key == skiplist_entry(new_node, TestStruct, n)->key);
+
+    __atomic_add_fetch(&num_collisions, 1, __ATOMIC_RELAXED);
+}
+
+/* Returns the key inserted i-th, so that keys are not inserted in order. */
+static int shuffled_key_(int i) {
+    return (int) ((i * 7919L) % NUM_OBJECTS);
+}
+
+/* Asserts that every level of the list is sorted, that no removed node is linked, and the list's size. */
+static void assert_list_(size_t size) {
+    const SkipListNode *node;
+    size_t level, count;
+    int prev;
+
+    for (level = 0; level < SKIPLIST_MAX_HEIGHT; ++level) {
+        count = 0;
+        prev = -1;
+        for (node = list.head.next[level]; node; node = node->next[level]) {
+            assert(((size_t) node & 1) == 0 && level < node->height);
+            assert(skiplist_entry(node, TestStruct, n)->key > prev);
+            prev = skiplist_entry(node, TestStruct, n)->key;
+            ++count;
+        }
+        assert(level > 0 || count == size);
+    }
+    assert(skiplist_size(&list) == size);
+}
+
+/* Inserts objects[0] in shuffled order. */
+static void insert_objects_(void) {
+    int i;
+
+    for (i = 0; i < NUM_OBJECTS; ++i) {
+        skiplist_insert(&list, &objects[0][shuffled_key_(i)].key, &objects[0][shuffled_key_(i)].n);
+    }
+}
+
+/* Inserts the worker's objects, whose keys overlap with those of the other workers. */
+static void* insert_worker_(void *arg) {
+    Worker *worker = (Worker*) arg;
+    int i;
+
+    for (i = 0; i < NUM_OBJECTS; ++i) {
+        skiplist_insert(&list, &worker->objects[shuffled_key_(i)].key, &worker->objects[shuffled_key_(i)].n);
+    }
+
+    return NULL;
+}
+
+/* Removes every key, starting at the worker's first key so that workers race for the same keys. */
+static void* remove_worker_(void *arg) {
+    Worker *worker = (Worker*) arg;
+    int i, key;
+
+    for (i = 0; i < NUM_OBJECTS; ++i) {
+        key = (worker->first_key + i) % NUM_OBJECTS;
+        if (skiplist_remove_key(&list, &key)) {
+            ++worker->num_removed;
+        }
+    }
+
+    return NULL;
+}
+
+static void run_workers_(void* (*func)(void *arg)) {
+    int i;
+
+    for (i = 0; i < NUM_THREADS; ++i) {
+        workers[i].objects = objects[i];
+        workers[i].first_key = i * (NUM_OBJECTS / NUM_THREADS) / 2;
+        workers[i].num_removed = 0;
+        assert(pthread_create(&workers[i].thread, NULL, func, &workers[i]) == 0);
+    }
+    for (i = 0; i < NUM_THREADS; ++i) {
+        assert(pthread_join(workers[i].thread, NULL) == 0);
+    }
+}
+
+static void reset_globals(void) {
+    int i, j;
+
+    for (i = 0; i < NUM_THREADS; ++i) {
+        for (j = 0; j < NUM_OBJECTS; ++j) {
+            objects[i][j].key = j;
+            objects[i][j].val = i;
+        }
+    }
+    skiplist_init(&list, compare_, collide_, &num_collisions);
+    num_collisions = 0;
+}
+
+/* ========================================================================================================
+ *
+ *                                             TESTING FUNCTIONS
+ *
+ * ======================================================================================================== */
+
+void test_skiplist_init(void) {
+    size_t level;
+
+    skiplist_init(&list, compare_, NULL, NULL);
+    assert(list.compare == compare_);
+    assert(list.collide == NULL);
+    assert(list.auxiliary_data == NULL);
+    assert(list.size == 0);
+
+    skiplist_init(&list, compare_, collide_, &num_collisions);
+    assert(list.collide == collide_);
+    assert(list.auxiliary_data == &num_collisions);
+    assert(list.head.height == SKIPLIST_MAX_HEIGHT);
+    for (level = 0; level < SKIPLIST_MAX_HEIGHT; ++level) {
+        assert(list.head.next[level] == NULL);
+    }
+}
+
+void test_skiplist_first(void) {
+    int key = 0;
+
+    assert(skiplist_first(&list) == NULL);
+
+    insert_objects_();
+    assert(skiplist_first(&list) == &objects[0][0].n);
+
+    assert(skiplist_remove(&list, &key, &objects[0][0].n));
+    assert(skiplist_first(&list) == &objects[0][1].n);
+}
+
+void test_skiplist_next(void) {
+    int key = 1;
+
+    insert_objects_();
+    assert(skiplist_next(&objects[0][0].n) == &objects[0][1].n);
+    assert(skiplist_next(&objects[0][NUM_OBJECTS - 1].n) == NULL);
+
+    /* A removed node still leads back into the list. */
+    assert(skiplist_remove(&list, &key, &objects[0][1].n));
+    assert(skiplist_next(&objects[0][0].n) == &objects[0][2].n);
+    assert(skiplist_next(&objects[0][1].n) == &objects[0][2].n);
+}
+
+void test_skiplist_size(void) {
+    int key = 5;
+
+    assert(skiplist_size(&list) == 0);
+
+    insert_objects_();
+    assert(skiplist_size(&list) == NUM_OBJECTS);
+
+    assert(skiplist_remove_key(&list, &key) == &objects[0][5].n);
+    assert(skiplist_size(&list) == NUM_OBJECTS - 1);
+
+    skiplist_insert(&list, &objects[1][6].key, &objects[1][6].n);
+    assert(skiplist_size(&list) == NUM_OBJECTS - 1);
+}
+
+void test_skiplist_empty(void) {
+    int key = 0;
+
+    assert(skiplist_empty(&list));
+
+    skiplist_insert(&list, &objects[0][0].key, &objects[0][0].n);
+    assert(!skiplist_empty(&list));
+
+    assert(skiplist_remove(&list, &key, &objects[0][0].n));
+    assert(skiplist_empty(&list));
+}
+
+void test_skiplist_contains_key(void) {
+    int key = NUM_OBJECTS;
+
+    insert_objects_();
+    assert(!skiplist_contains_key(&list, &key));
+    for (key = 0; key < NUM_OBJECTS; ++key) {
+        assert(skiplist_contains_key(&list, &key));
+    }
+
+    key = 7;
+    assert(skiplist_remove_key(&list, &key));
+    assert(!skiplist_contains_key(&list, &key));
+}
+
+void test_skiplist_insert(void) {
+    const SkipListNode *node;
+    int i;
+
+    insert_objects_();
+    assert_list_(NUM_OBJECTS);
+    assert(num_collisions == 0);
+
+    /* Replacing every node calls collide once per replaced node. */
+    for (i = 0; i < NUM_OBJECTS; ++i) {
+        skiplist_insert(&list, &objects[1][i].key, &objects[1][i].n);
+    }
+    assert_list_(NUM_OBJECTS);
+    assert(num_collisions == NUM_OBJECTS);
+    for (i = 0; i < NUM_OBJECTS; ++i) {
+        assert(skiplist_lookup_key(&list, &i) == &objects[1][i].n);
+    }
+
+    /* Concurrent inserts of the same keys leave one node per key. */
+    reset_globals();
+    run_workers_(insert_worker_);
+    assert_list_(NUM_OBJECTS);
+    assert(num_collisions == (NUM_THREADS - 1) * NUM_OBJECTS);
+    i = 0;
+    skiplist_for_each(node, &list) {
+        assert(skiplist_entry(node, TestStruct, n)->key == i++);
+    }
+    assert(i == NUM_OBJECTS);
+}
+
+void test_skiplist_lookup_key(void) {
+    int key = -1;
+
+    assert(skiplist_lookup_key(&list, &key) == NULL);
+
+    insert_objects_();
+    assert(skiplist_lookup_key(&list, &key) == NULL);
+    for (key = 0; key < NUM_OBJECTS; ++key) {
+        assert(skiplist_lookup_key(&list, &key) == &objects[0][key].n);
+    }
+    assert(skiplist_lookup_key(&list, &key) == NULL);
+}
+
+void test_skiplist_lower_bound(void) {
+    int key = 0;
+
+    assert(skiplist_lower_bound(&list, &key) == NULL);
+
+    for (key = 0; key < NUM_OBJECTS; key += 2) {
+        skiplist_insert(&list, &objects[0][key].key, &objects[0][key].n);
+    }
+
+    key = -1;
+    assert(skiplist_lower_bound(&list, &key) == &objects[0][0].n);
+    for (key = 0; key < NUM_OBJECTS - 1; ++key) {
+        assert(skiplist_lower_bound(&list, &key) == &objects[0][(key + 1) / 2 * 2].n);
+    }
+    key = NUM_OBJECTS - 1;
+    assert(skiplist_lower_bound(&list, &key) == NULL);
+}
+
+void test_skiplist_remove(void) {
+    int i, key;
+
+    insert_objects_();
+    for (i = 0; i < NUM_OBJECTS; i += 2) {
+        key = shuffled_key_(i);
+        assert(skiplist_remove(&list, &key, &objects[0][key].n));
+        assert(!skiplist_remove(&list, &key, &objects[0][key].n));
+        assert(!skiplist_contains_key(&list, &key));
+    }
+    assert_list_(NUM_OBJECTS / 2);
+
+    for (i = 1; i < NUM_OBJECTS; i += 2) {
+        key = shuffled_key_(i);
+        assert(skiplist_remove(&list, &key, &objects[0][key].n));
+    }
+    assert_list_(0);
+    assert(skiplist_empty(&list));
+}
+
+void test_skiplist_remove_key(void) {
+    size_t num_removed = 0;
+    int i, key;
+
+    insert_objects_();
+    key = NUM_OBJECTS;
+    assert(skiplist_remove_key(&list, &key) == NULL);
+    for (i = 0; i < NUM_OBJECTS; ++i) {
+        key = shuffled_key_(i);
+        assert(skiplist_remove_key(&list, &key) == &objects[0][key].n);
+        assert(skiplist_remove_key(&list, &key) == NULL);
+    }
+    assert_list_(0);
+
+    /* Concurrent removes of the same keys succeed once per key. */
+    insert_objects_();
+    run_workers_(remove_worker_);
+    for (i = 0; i < NUM_THREADS; ++i) {
+        num_removed += workers[i].num_removed;
+    }
+    assert(num_removed == NUM_OBJECTS);
+    assert_list_(0);
+}
+
+void test_skiplist_entry(void) {
+    TestStruct *entry;
+
+    entry = skiplist_entry(&objects[0][3].n, TestStruct, n);
+    assert(entry == &objects[0][3]);
+    assert(entry->key == 3);
+}
+
+void test_skiplist_for_each(void) {
+    SkipListNode *node;
+    int i = 0;
+
+    skiplist_for_each(node, &list) {
+        assert(0);
+    }
+
+    insert_objects_();
+    skiplist_for_each(node, &list) {
+        assert(skiplist_entry(node, TestStruct, n)->key == i);
+
+        /* The cursor may be removed in the loop's body. */
+        assert(skiplist_remove(&list, &i, node));
+        ++i;
+    }
+    assert(i == NUM_OBJECTS);
+    assert(skiplist_empty(&list));
+}
+
+void test_skiplist_for_each_from(void) {
+    SkipListNode *node;
+    int i = NUM_OBJECTS / 2;
+
+    node = skiplist_first(&list);
+    skiplist_for_each_from(node) {
+        assert(0);
+    }
+
+    insert_objects_();
+    node = skiplist_lower_bound(&list, &i);
+    skiplist_for_each_from(node) {
+        assert(skiplist_entry(node, TestStruct, n)->key == i++);
+    }
+    assert(i == NUM_OBJECTS);
+}
+
+TestFunc test_funcs[] = {
+    test_skiplist_init,
+    test_skiplist_first,
+    test_skiplist_next,
+    test_skiplist_size,
+    test_skiplist_empty,
+    test_skiplist_contains_key,
+    test_skiplist_insert,
+    test_skiplist_lookup_key,
+    test_skiplist_lower_bound,
+    test_skiplist_remove,
+    test_skiplist_remove_key,
+    test_skiplist_entry,
+    test_skiplist_for_each,
+    test_skiplist_for_each_from
+};
+
+int main(int argc, char *argv[]) {
+    char msg[100] = "SkipList ";
+    assert(argc == 2);
+    strcat(msg, argv[1]);
+
+    assert(sizeof(test_funcs) / sizeof(TestFunc) == 14);
+    run_tests(test_funcs, sizeof(test_funcs) / sizeof(TestFunc), msg, reset_globals);
+
+    return 0;
+}
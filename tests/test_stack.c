@@ -201,6 +201,25 @@ void test_stack_for_each(void) {
     assert(i == 3);
 }
 
+void test_stack_for_each_prefetch(void) {
+    StackNode *n;
+    size_t i = 0;
+
+    stack_for_each_prefetch(n, &stack) {
+        assert(0);
+    }
+
+    stack_push(&stack, &var3.node);
+    stack_push(&stack, &var2.node);
+    stack_push(&stack, &var1.node);
+
+    stack_for_each_prefetch(n, &stack) {
+        ASSERT_FOR_EACH(n, i);
+        ++i;
+    }
+    assert(i == 3);
+}
+
 void test_stack_for_each_safe(void) {
     StackNode *n, *backup;
     size_t i = 0;
@@ -232,6 +251,7 @@ TestFunc test_funcs[] = {
     test_stack_remove_all,
     test_stack_entry,
     test_stack_for_each,
+    test_stack_for_each_prefetch,
     test_stack_for_each_safe
 };
 
@@ -240,7 +260,7 @@ int main(int argc, char *argv[]) {
     assert(argc == 2);
     strcat(msg, argv[1]);
 
-    assert(sizeof(test_funcs) / sizeof(TestFunc) == 10);
+    assert(sizeof(test_funcs) / sizeof(TestFunc) == 11);
     run_tests(test_funcs, sizeof(test_funcs) / sizeof(TestFunc), msg, reset_globals);
 
     return 0;
@@ -0,0 +1,311 @@
+/*
+Copyright (c) 2017, Michael J Welsh
+
+Permission to use, copy, modify, and/or distribute this software
+for any purpose with or without fee is hereby granted, provided
+that the above copyright notice and this permission notice appear
+in all copies.
+
+THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL
+WARRANTIES WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE
+AUTHOR BE LIABLE FOR ANY SPECIAL, DIRECT, INDIRECT, OR
+CONSEQUENTIAL DAMAGES OR ANY DAMAGES WHATSOEVER RESULTING FROM
+LOSS OF USE, DATA OR PROFITS, WHETHER IN AN ACTION OF CONTRACT,
+NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF OR IN
+CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <stddef.h>
+#include <string.h>
+#include <assert.h>
+
+#include "testing_framework.h"
+
+/* Test header guard. */
+#include "../src/static_index.h"
+#include "../src/static_index.h"
+
+/* ========================================================================================================
+ *
+ *                                             TESTING UTILITIES
+ *
+ * ======================================================================================================== */
+
+#define NUM_KEYS 1000
+
+StaticIndexKey key_array[NUM_KEYS + 1];
+void *value_array[NUM_KEYS + 1];
+StaticIndex index_;
+
+/* The keys 0, 2, 4, ... in ascending order, and the values associated with them. */
+StaticIndexKey sorted_keys[NUM_KEYS];
+int objects[NUM_KEYS];
+void *sorted_values[NUM_KEYS];
+
+/* Builds index_ out of the first @ref size sorted keys. */
+static void build_(size_t size) {
+    static_index_init(&index_, key_array, value_array, size);
+    static_index_append_array(&index_, sorted_keys, sorted_values, size);
+}
+
+/* Returns the index in sorted_keys of the first key not less than the @ref key, among the first @ref size. */
+static size_t linear_lower_bound_(size_t size, StaticIndexKey key) {
+    size_t i;
+
+    for (i = 0; i < size && sorted_keys[i] < key; ++i) {
+    }
+
+    return i;
+}
+
+static void reset_globals(void) {
+    size_t i;
+
+    for (i = 0; i < NUM_KEYS; ++i) {
+        sorted_keys[i] = 2 * i;
+        objects[i] = (int) i;
+        sorted_values[i] = &objects[i];
+    }
+
+    memset(key_array, 0, sizeof(key_array));
+    memset(value_array, 0, sizeof(value_array));
+    build_(NUM_KEYS);
+}
+
+/* ========================================================================================================
+ *
+ *                                             TESTING FUNCTIONS
+ *
+ * ======================================================================================================== */
+
+void test_static_index_init(void) {
+    static_index_init(&index_, key_array, value_array, 0);
+    assert(index_.keys == key_array);
+    assert(index_.values == value_array);
+    assert(index_.size == 0);
+    assert(index_.cursor == 0);
+
+    static_index_init(&index_, key_array, value_array, 6);
+    assert(index_.size == 6);
+    assert(index_.cursor == 4);
+}
+
+void test_static_index_append(void) {
+    size_t i;
+
+    /* In-order positions of the implicit tree 1 (2 (4, 5), 3 (6)). */
+    static_index_init(&index_, key_array, value_array, 6);
+    for (i = 0; i < 6; ++i) {
+        static_index_append(&index_, sorted_keys[i], sorted_values[i]);
+    }
+    assert(index_.cursor == 0);
+    assert(key_array[4] == 0 && key_array[2] == 2 && key_array[5] == 4);
+    assert(key_array[1] == 6 && key_array[6] == 8 && key_array[3] == 10);
+    assert(value_array[4] == &objects[0] && value_array[3] == &objects[5]);
+
+    /* Equal keys. */
+    static_index_init(&index_, key_array, value_array, 3);
+    static_index_append(&index_, 7, &objects[0]);
+    static_index_append(&index_, 7, &objects[1]);
+    static_index_append(&index_, 7, &objects[2]);
+    assert(static_index_lookup_key(&index_, 7) == &objects[0]);
+    assert(static_index_lower_bound(&index_, 7) == static_index_first(&index_));
+    assert(static_index_lower_bound(&index_, 8) == 0);
+}
+
+void test_static_index_append_array(void) {
+    size_t i;
+
+    static_index_init(&index_, key_array, value_array, NUM_KEYS);
+    static_index_append_array(&index_, NULL, NULL, 0);
+    assert(index_.cursor == static_index_first(&index_));
+    static_index_append_array(&index_, sorted_keys, sorted_values, 10);
+    static_index_append_array(&index_, sorted_keys + 10, sorted_values + 10, NUM_KEYS - 10);
+    assert(index_.cursor == 0);
+    for (i = 0; i < NUM_KEYS; ++i) {
+        assert(static_index_lookup_key(&index_, sorted_keys[i]) == &objects[i]);
+    }
+}
+
+void test_static_index_first(void) {
+    build_(0);
+    assert(static_index_first(&index_) == 0);
+
+    build_(1);
+    assert(static_index_first(&index_) == 1);
+
+    build_(NUM_KEYS);
+    assert(static_index_first(&index_) == 512);
+    assert(static_index_key(&index_, static_index_first(&index_)) == 0);
+}
+
+void test_static_index_last(void) {
+    build_(0);
+    assert(static_index_last(&index_) == 0);
+
+    build_(2);
+    assert(static_index_last(&index_) == 1);
+
+    build_(NUM_KEYS);
+    assert(static_index_last(&index_) == 511);
+    assert(static_index_key(&index_, static_index_last(&index_)) == 2 * (NUM_KEYS - 1));
+}
+
+void test_static_index_prev(void) {
+    size_t size, slot, i;
+
+    for (size = 1; size <= 70; ++size) {
+        build_(size);
+        slot = static_index_last(&index_);
+        for (i = size; i-- > 0; ) {
+            assert(slot && static_index_key(&index_, slot) == sorted_keys[i]);
+            slot = static_index_prev(&index_, slot);
+        }
+        assert(slot == 0);
+    }
+}
+
+void test_static_index_next(void) {
+    size_t size, slot, i;
+
+    for (size = 1; size <= 70; ++size) {
+        build_(size);
+        slot = static_index_first(&index_);
+        for (i = 0; i < size; ++i) {
+            assert(slot && static_index_key(&index_, slot) == sorted_keys[i]);
+            slot = static_index_next(&index_, slot);
+        }
+        assert(slot == 0);
+    }
+}
+
+void test_static_index_key(void) {
+    assert(static_index_key(&index_, 1) == 2 * 511);
+    assert(static_index_key(&index_, 2) == 2 * 255);
+    assert(static_index_key(&index_, 3) == 2 * 767);
+}
+
+void test_static_index_value(void) {
+    assert(static_index_value(&index_, 1) == &objects[511]);
+    assert(static_index_value(&index_, 2) == &objects[255]);
+    assert(static_index_value(&index_, 3) == &objects[767]);
+}
+
+void test_static_index_size(void) {
+    assert(static_index_size(&index_) == NUM_KEYS);
+
+    build_(0);
+    assert(static_index_size(&index_) == 0);
+}
+
+void test_static_index_contains_key(void) {
+    StaticIndexKey key;
+
+    for (key = 0; key < 2 * NUM_KEYS + 2; ++key) {
+        assert(static_index_contains_key(&index_, key) == (key % 2 == 0 && key < 2 * NUM_KEYS));
+    }
+
+    build_(0);
+    assert(!static_index_contains_key(&index_, 0));
+}
+
+void test_static_index_lookup_key(void) {
+    StaticIndexKey key;
+
+    for (key = 0; key < 2 * NUM_KEYS + 2; ++key) {
+        if (key % 2 == 0 && key < 2 * NUM_KEYS) {
+            assert(static_index_lookup_key(&index_, key) == &objects[key / 2]);
+        } else {
+            assert(static_index_lookup_key(&index_, key) == NULL);
+        }
+    }
+
+    build_(0);
+    assert(static_index_lookup_key(&index_, 0) == NULL);
+}
+
+void test_static_index_lower_bound(void) {
+    size_t size, slot, i;
+    StaticIndexKey key;
+
+    for (size = 0; size <= 70; ++size) {
+        build_(size);
+        for (key = 0; key < 2 * size + 2; ++key) {
+            i = linear_lower_bound_(size, key);
+            slot = static_index_lower_bound(&index_, key);
+            if (i == size) {
+                assert(slot == 0);
+            } else {
+                assert(slot && static_index_value(&index_, slot) == &objects[i]);
+            }
+        }
+    }
+
+    build_(NUM_KEYS);
+    for (key = 0; key < 2 * NUM_KEYS + 2; ++key) {
+        i = linear_lower_bound_(NUM_KEYS, key);
+        slot = static_index_lower_bound(&index_, key);
+        assert(i == NUM_KEYS ? slot == 0 : static_index_value(&index_, slot) == &objects[i]);
+    }
+}
+
+void test_static_index_for_each(void) {
+    size_t slot, i = 0;
+
+    static_index_for_each(slot, &index_) {
+        assert(static_index_value(&index_, slot) == &objects[i++]);
+    }
+    assert(i == NUM_KEYS);
+
+    build_(0);
+    static_index_for_each(slot, &index_) {
+        assert(0);
+    }
+}
+
+void test_static_index_for_each_from(void) {
+    size_t slot, i = NUM_KEYS / 2;
+
+    slot = static_index_lower_bound(&index_, 2 * i - 1);
+    static_index_for_each_from(slot, &index_) {
+        assert(static_index_value(&index_, slot) == &objects[i++]);
+    }
+    assert(i == NUM_KEYS);
+
+    slot = static_index_lower_bound(&index_, 2 * NUM_KEYS);
+    static_index_for_each_from(slot, &index_) {
+        assert(0);
+    }
+}
+
+TestFunc test_funcs[] = {
+    test_static_index_init,
+    test_static_index_append,
+    test_static_index_append_array,
+    test_static_index_first,
+    test_static_index_last,
+    test_static_index_prev,
+    test_static_index_next,
+    test_static_index_key,
+    test_static_index_value,
+    test_static_index_size,
+    test_static_index_contains_key,
+    test_static_index_lookup_key,
+    test_static_index_lower_bound,
+    test_static_index_for_each,
+    test_static_index_for_each_from
+};
+
+int main(int argc, char *argv[]) {
+    char msg[100] = "StaticIndex ";
+    assert(argc == 2);
+    strcat(msg, argv[1]);
+
+    assert(sizeof(test_funcs) / sizeof(TestFunc) == 15);
+    run_tests(test_funcs, sizeof(test_funcs) / sizeof(TestFunc), msg, reset_globals);
+
+    return 0;
+}
@@ -0,0 +1,356 @@
+/*
+Copyright (c) 2017, Michael J Welsh
+
+Permission to use, copy, modify, and/or distribute this software
+for any purpose with or without fee is hereby granted, provided
+that the above copyright notice and this permission notice appear
+in all copies.
+
+THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL
+WARRANTIES WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE
+AUTHOR BE LIABLE FOR ANY SPECIAL, DIRECT, INDIRECT, OR
+CONSEQUENTIAL DAMAGES OR ANY DAMAGES WHATSOEVER RESULTING FROM
+LOSS OF USE, DATA OR PROFITS, WHETHER IN AN ACTION OF CONTRACT,
+NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF OR IN
+CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <stddef.h>
+#include <string.h>
+#include <assert.h>
+
+#include "testing_framework.h"
+
+/* Test header guard. */
+#include "../src/timer_wheel.h"
+#include "../src/timer_wheel.h"
+
+/* ========================================================================================================
+ *
+ *                                             TESTING UTILITIES
+ *
+ * ======================================================================================================== */
+
+#define NUM_OBJECTS 1000
+
+/* Long enough for every object to start in one of the first four levels. */
+#define MAX_DELAY 300000ul
+
+typedef struct TestStruct {
+    size_t id;
+    TimerWheelNode timer;
+} TestStruct;
+
+TestStruct objects[NUM_OBJECTS];
+TimerWheel wheel;
+List expired;
+
+/* A delay in [1, MAX_DELAY], scrambled by the @ref id. */
+static unsigned long delay_(size_t id) {
+    return (unsigned long) id * 2654435761ul % MAX_DELAY + 1;
+}
+
+/* Arms every object, after its delay. */
+static void arm_objects_(void) {
+    size_t i;
+
+    for (i = 0; i < NUM_OBJECTS; ++i) {
+        timer_wheel_arm(&wheel, &objects[i].timer, timer_wheel_now(&wheel) + delay_(i));
+    }
+}
+
+/* Removes the front of @ref expired, asserting that it is no longer armed. */
+static TestStruct* pop_expired_(void) {
+    TimerWheelNode *timer = list_entry(list_front(&expired), TimerWheelNode, node);
+
+    list_remove_front(&expired);
+    assert(!timer_wheel_armed(timer));
+
+    return timer_wheel_entry(timer, TestStruct, timer);
+}
+
+/* Ticks until the wheel is empty, asserting that every timer expires at its tick. Returns the number. */
+static size_t run_wheel_(void) {
+    size_t count = 0;
+
+    while (!timer_wheel_empty(&wheel)) {
+        timer_wheel_tick(&wheel, &expired);
+        for ( ; !list_empty(&expired); ++count) {
+            assert(timer_wheel_expires(&pop_expired_()->timer) == timer_wheel_now(&wheel));
+        }
+    }
+
+    return count;
+}
+
+static void reset_globals(void) {
+    size_t i;
+
+    timer_wheel_init(&wheel, 0);
+    list_init(&expired);
+
+    for (i = 0; i < NUM_OBJECTS; ++i) {
+        objects[i].id = i;
+        objects[i].timer.expires = 0;
+        objects[i].timer.list = NULL;
+    }
+}
+
+/* ========================================================================================================
+ *
+ *                                             TESTING FUNCTIONS
+ *
+ * ======================================================================================================== */
+
+void test_timer_wheel_init(void) {
+    TimerWheelNode node_init_with_macro = TIMER_WHEEL_NODE_INIT;
+    size_t level, i;
+
+    assert(node_init_with_macro.node.prev == LIST_POISON_PREV);
+    assert(node_init_with_macro.node.next == LIST_POISON_NEXT);
+    assert(!timer_wheel_armed(&node_init_with_macro));
+
+    timer_wheel_arm(&wheel, &objects[0].timer, 10);
+    timer_wheel_init(&wheel, 100);
+    assert(wheel.now == 100);
+    assert(wheel.size == 0);
+    for (level = 0; level < TIMER_WHEEL_LEVELS; ++level) {
+        for (i = 0; i < TIMER_WHEEL_SLOTS; ++i) {
+            assert(list_empty(&wheel.slots[level][i]));
+        }
+    }
+}
+
+void test_timer_wheel_now(void) {
+    assert(timer_wheel_now(&wheel) == 0);
+
+    timer_wheel_tick(&wheel, &expired);
+    assert(timer_wheel_now(&wheel) == 1);
+
+    timer_wheel_advance(&wheel, 50, &expired);
+    assert(timer_wheel_now(&wheel) == 50);
+
+    timer_wheel_init(&wheel, 7);
+    assert(timer_wheel_now(&wheel) == 7);
+}
+
+void test_timer_wheel_size(void) {
+    assert(timer_wheel_size(&wheel) == 0);
+
+    timer_wheel_arm(&wheel, &objects[0].timer, 1);
+    timer_wheel_arm(&wheel, &objects[1].timer, 2);
+    timer_wheel_arm(&wheel, &objects[2].timer, 1000);
+    assert(timer_wheel_size(&wheel) == 3);
+
+    timer_wheel_cancel(&wheel, &objects[2].timer);
+    assert(timer_wheel_size(&wheel) == 2);
+
+    timer_wheel_tick(&wheel, &expired);
+    assert(timer_wheel_size(&wheel) == 1);
+    assert(list_size(&expired) == 1);
+}
+
+void test_timer_wheel_empty(void) {
+    assert(timer_wheel_empty(&wheel));
+
+    timer_wheel_arm(&wheel, &objects[0].timer, 5);
+    assert(!timer_wheel_empty(&wheel));
+
+    timer_wheel_advance(&wheel, 5, &expired);
+    assert(timer_wheel_empty(&wheel));
+}
+
+void test_timer_wheel_armed(void) {
+    assert(!timer_wheel_armed(&objects[0].timer));
+
+    timer_wheel_arm(&wheel, &objects[0].timer, 3);
+    assert(timer_wheel_armed(&objects[0].timer));
+
+    timer_wheel_cancel(&wheel, &objects[0].timer);
+    assert(!timer_wheel_armed(&objects[0].timer));
+
+    timer_wheel_arm(&wheel, &objects[0].timer, 3);
+    timer_wheel_advance(&wheel, 2, &expired);
+    assert(timer_wheel_armed(&objects[0].timer));
+    timer_wheel_tick(&wheel, &expired);
+    assert(!timer_wheel_armed(&objects[0].timer));
+}
+
+void test_timer_wheel_expires(void) {
+    timer_wheel_arm(&wheel, &objects[0].timer, 10);
+    assert(timer_wheel_expires(&objects[0].timer) == 10);
+
+    /* Not after the last tick processed. */
+    timer_wheel_advance(&wheel, 20, &expired);
+    timer_wheel_arm(&wheel, &objects[1].timer, 5);
+    assert(timer_wheel_expires(&objects[1].timer) == 21);
+    timer_wheel_arm(&wheel, &objects[2].timer, 20);
+    assert(timer_wheel_expires(&objects[2].timer) == 21);
+
+    timer_wheel_tick(&wheel, &expired);
+    assert(list_size(&expired) == 3);
+    assert(timer_wheel_expires(&objects[0].timer) == 10);
+}
+
+void test_timer_wheel_arm(void) {
+    unsigned long range = 1ul << (TIMER_WHEEL_SLOT_BITS * TIMER_WHEEL_LEVELS);
+
+    /* The lowest level reaching the expiry tick. */
+    timer_wheel_arm(&wheel, &objects[0].timer, 1);
+    assert(objects[0].timer.list == &wheel.slots[0][1]);
+    timer_wheel_arm(&wheel, &objects[1].timer, TIMER_WHEEL_SLOTS - 1);
+    assert(objects[1].timer.list == &wheel.slots[0][TIMER_WHEEL_SLOTS - 1]);
+    timer_wheel_arm(&wheel, &objects[2].timer, TIMER_WHEEL_SLOTS);
+    assert(objects[2].timer.list == &wheel.slots[1][1]);
+    timer_wheel_arm(&wheel, &objects[3].timer, TIMER_WHEEL_SLOTS * TIMER_WHEEL_SLOTS + 5);
+    assert(objects[3].timer.list == &wheel.slots[2][1]);
+
+    /* Out of range. */
+    timer_wheel_arm(&wheel, &objects[4].timer, range + 100);
+    assert(objects[4].timer.list == &wheel.slots[TIMER_WHEEL_LEVELS - 1][TIMER_WHEEL_SLOTS - 1]);
+    assert(timer_wheel_expires(&objects[4].timer) == range + 100);
+    timer_wheel_cancel(&wheel, &objects[4].timer);
+
+    assert(timer_wheel_size(&wheel) == 4);
+    assert(run_wheel_() == 4);
+
+    /* Scrambled delays, from a tick that is not at the start of a turn. */
+    reset_globals();
+    timer_wheel_advance(&wheel, 12345, &expired);
+    arm_objects_();
+    assert(timer_wheel_size(&wheel) == NUM_OBJECTS);
+    assert(run_wheel_() == NUM_OBJECTS);
+}
+
+void test_timer_wheel_cancel(void) {
+    size_t i, count;
+
+    arm_objects_();
+    for (i = 1; i < NUM_OBJECTS; i += 2) {
+        timer_wheel_cancel(&wheel, &objects[i].timer);
+        assert(!timer_wheel_armed(&objects[i].timer));
+    }
+    assert(timer_wheel_size(&wheel) == NUM_OBJECTS / 2);
+
+    /* After some cascades, cancel and re-arm every third object. */
+    timer_wheel_advance(&wheel, MAX_DELAY / 2, &expired);
+    for (count = 0; !list_empty(&expired); ++count) {
+        assert(pop_expired_()->id % 2 == 0);
+    }
+    assert(count + timer_wheel_size(&wheel) == NUM_OBJECTS / 2);
+    for (i = 0; i < NUM_OBJECTS; i += 3) {
+        if (timer_wheel_armed(&objects[i].timer)) {
+            timer_wheel_cancel(&wheel, &objects[i].timer);
+        }
+        timer_wheel_arm(&wheel, &objects[i].timer, timer_wheel_now(&wheel) + delay_(i + 1));
+    }
+
+    count = timer_wheel_size(&wheel);
+    assert(run_wheel_() == count);
+    for (i = 0; i < NUM_OBJECTS; ++i) {
+        assert(!timer_wheel_armed(&objects[i].timer));
+    }
+}
+
+void test_timer_wheel_tick(void) {
+    size_t i;
+
+    /* Empty. */
+    timer_wheel_tick(&wheel, &expired);
+    assert(list_empty(&expired));
+    assert(timer_wheel_now(&wheel) == 1);
+
+    /* In the order they were armed. */
+    timer_wheel_arm(&wheel, &objects[2].timer, 2);
+    timer_wheel_arm(&wheel, &objects[0].timer, 2);
+    timer_wheel_arm(&wheel, &objects[1].timer, 2);
+    timer_wheel_tick(&wheel, &expired);
+    assert(pop_expired_() == &objects[2]);
+    assert(pop_expired_() == &objects[0]);
+    assert(pop_expired_() == &objects[1]);
+    assert(list_empty(&expired));
+
+    /* Appended to the timers already in the list. */
+    list_insert_back(&expired, &objects[5].timer.node);
+    timer_wheel_arm(&wheel, &objects[3].timer, 3);
+    timer_wheel_tick(&wheel, &expired);
+    assert(list_size(&expired) == 2);
+    assert(list_back(&expired) == &objects[3].timer.node);
+    list_remove_all(&expired);
+
+    /* Cascaded through every level but the top one. */
+    timer_wheel_arm(&wheel, &objects[4].timer, 3ul << (TIMER_WHEEL_SLOT_BITS * (TIMER_WHEEL_LEVELS - 2)));
+    assert(objects[4].timer.list == &wheel.slots[TIMER_WHEEL_LEVELS - 2][3]);
+    assert(run_wheel_() == 1);
+
+    /* Every expiry tick of a few turns of level 0. */
+    reset_globals();
+    for (i = 0; i < NUM_OBJECTS; ++i) {
+        timer_wheel_arm(&wheel, &objects[i].timer, i % (4 * TIMER_WHEEL_SLOTS) + 1);
+    }
+    assert(run_wheel_() == NUM_OBJECTS);
+    assert(timer_wheel_now(&wheel) == 4 * TIMER_WHEEL_SLOTS);
+}
+
+void test_timer_wheel_advance(void) {
+    unsigned long last = 0;
+    size_t count;
+    TestStruct *obj;
+
+    /* Nothing armed. */
+    timer_wheel_advance(&wheel, 1000000, &expired);
+    assert(timer_wheel_now(&wheel) == 1000000);
+    assert(list_empty(&expired));
+    timer_wheel_advance(&wheel, 1000000, &expired);
+    assert(timer_wheel_now(&wheel) == 1000000);
+
+    /* In the order they expire. */
+    arm_objects_();
+    timer_wheel_advance(&wheel, 1000000 + MAX_DELAY / 2, &expired);
+    for (count = 0; !list_empty(&expired); ++count) {
+        obj = pop_expired_();
+        assert(timer_wheel_expires(&obj->timer) >= last);
+        assert(timer_wheel_expires(&obj->timer) <= 1000000 + MAX_DELAY / 2);
+        last = timer_wheel_expires(&obj->timer);
+    }
+    assert(count + timer_wheel_size(&wheel) == NUM_OBJECTS);
+
+    /* The ticks after the last timer are skipped. */
+    timer_wheel_advance(&wheel, 5000000, &expired);
+    assert(timer_wheel_now(&wheel) == 5000000);
+    assert(list_size(&expired) + count == NUM_OBJECTS);
+    assert(timer_wheel_empty(&wheel));
+}
+
+void test_timer_wheel_entry(void) {
+    assert(timer_wheel_entry(&objects[1].timer, TestStruct, timer) == &objects[1]);
+    assert(timer_wheel_entry(&objects[1].timer, TestStruct, timer)->id == 1);
+}
+
+TestFunc test_funcs[] = {
+    test_timer_wheel_init,
+    test_timer_wheel_now,
+    test_timer_wheel_size,
+    test_timer_wheel_empty,
+    test_timer_wheel_armed,
+    test_timer_wheel_expires,
+    test_timer_wheel_arm,
+    test_timer_wheel_cancel,
+    test_timer_wheel_tick,
+    test_timer_wheel_advance,
+    test_timer_wheel_entry
+};
+
+int main(int argc, char *argv[]) {
+    char msg[100] = "TimerWheel ";
+    assert(argc == 2);
+    strcat(msg, argv[1]);
+
+    assert(sizeof(test_funcs) / sizeof(TestFunc) == 11);
+    run_tests(test_funcs, sizeof(test_funcs) / sizeof(TestFunc), msg, reset_globals);
+
+    return 0;
+}
@@ -0,0 +1,549 @@
+/*
+Copyright (c) 2017, Michael J Welsh
+
+Permission to use, copy, modify, and/or distribute this software
+for any purpose with or without fee is hereby granted, provided
+that the above copyright notice and this permission notice appear
+in all copies.
+
+THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL
+WARRANTIES WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE
+AUTHOR BE LIABLE FOR ANY SPECIAL, DIRECT, INDIRECT, OR
+CONSEQUENTIAL DAMAGES OR ANY DAMAGES WHATSOEVER RESULTING FROM
+LOSS OF USE, DATA OR PROFITS, WHETHER IN AN ACTION OF CONTRACT,
+NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF OR IN
+CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <stddef.h>
+#include <string.h>
+#include <assert.h>
+
+#include "testing_framework.h"
+
+/* Test header guard. */
+#include "../src/unrolled_list.h"
+#include "../src/unrolled_list.h"
+
+/* ========================================================================================================
+ *
+ *                                             TESTING UTILITIES
+ *
+ * ======================================================================================================== */
+
+#define NUM_BIG_VARS 1000
+
+typedef struct TestStruct {
+    int val;
+    UnrolledListNode node;
+} TestStruct;
+
+TestStruct var1, var2, var3;
+TestStruct big_vars[NUM_BIG_VARS];
+UnrolledListNode *model[NUM_BIG_VARS];
+UnrolledList list;
+
+/* The chunks currently allocated through the counting allocator, and whether it should fail. */
+size_t num_chunks;
+int fail_allocations;
+
+static void* allocate_(size_t size, void *allocator_data) {
+    assert(size == sizeof(UnrolledListChunk));
+    assert(allocator_data == &num_chunks);
+
+    if (fail_allocations) {
+        return NULL;
+    }
+
+    ++num_chunks;
+    return malloc(size);
+}
+
+static void deallocate_(void *ptr, size_t size, void *allocator_data) {
+    assert(ptr && size == sizeof(UnrolledListChunk));
+    assert(allocator_data == &num_chunks);
+
+    --num_chunks;
+    free(ptr);
+}
+
+/* Asserts the list holds exactly the first num_nodes nodes of the model in order, and checks its chunks. */
+static void assert_matches_model_(const UnrolledList *l, size_t num_nodes) {
+    const UnrolledListChunk *chunk, *prev = NULL;
+    size_t i, j = 0, chunks = 0;
+
+    assert(l->size == num_nodes);
+    assert(!l->head == !l->tail);
+
+    for (chunk = l->head; chunk; prev = chunk, chunk = chunk->next) {
+        assert(chunk->prev == prev);
+        assert(chunk->begin < chunk->end && chunk->end <= UNROLLED_LIST_CHUNK_CAPACITY);
+
+        for (i = chunk->begin; i < chunk->end; ++i, ++j) {
+            assert(j < num_nodes && chunk->nodes[i] == model[j]);
+            assert(model[j]->chunk == chunk && model[j]->index == i);
+            assert(unrolled_list_prev(model[j]) == (j > 0 ? model[j - 1] : NULL));
+            assert(unrolled_list_next(model[j]) == (j + 1 < num_nodes ? model[j + 1] : NULL));
+        }
+
+        ++chunks;
+    }
+
+    assert(l->tail == prev);
+    assert(j == num_nodes);
+    assert(chunks == num_chunks);
+}
+
+static void reset_globals(void) {
+    size_t i;
+
+    var1.val = 1;
+    var2.val = 2;
+    var3.val = 3;
+
+    for (i = 0; i < NUM_BIG_VARS; ++i) {
+        big_vars[i].val = (int) i;
+    }
+
+    /* Free whatever the previous test left behind. */
+    unrolled_list_remove_all(&list);
+    assert(num_chunks == 0);
+
+    fail_allocations = 0;
+    unrolled_list_init(&list, allocate_, deallocate_, &num_chunks);
+}
+
+/* ========================================================================================================
+ *
+ *                                             TESTING FUNCTIONS
+ *
+ * ======================================================================================================== */
+
+void test_unrolled_list_init(void) {
+    UnrolledList other_list;
+
+    other_list.head = other_list.tail = (UnrolledListChunk*) &var1;
+    other_list.size = 100;
+    unrolled_list_init(&other_list, NULL, NULL, NULL);
+    assert(other_list.head == NULL);
+    assert(other_list.tail == NULL);
+    assert(other_list.size == 0);
+    assert(other_list.allocate == NULL);
+    assert(other_list.deallocate == NULL);
+    assert(other_list.allocator_data == NULL);
+
+    /* Without an allocator, malloc() and free() are used. */
+    assert(unrolled_list_insert_back(&other_list, &var1.node) == 1);
+    assert(other_list.head && other_list.head == other_list.tail);
+    unrolled_list_remove_all(&other_list);
+    assert(other_list.head == NULL);
+
+    assert(list.allocate == allocate_);
+    assert(list.deallocate == deallocate_);
+    assert(list.allocator_data == &num_chunks);
+    assert(list.head == NULL && list.tail == NULL && list.size == 0);
+}
+
+void test_unrolled_list_front(void) {
+    assert(unrolled_list_front(&list) == NULL);
+    unrolled_list_insert_back(&list, &var2.node);
+    assert(unrolled_list_front(&list) == &var2.node);
+    unrolled_list_insert_back(&list, &var3.node);
+    unrolled_list_insert_front(&list, &var1.node);
+    assert(unrolled_list_front(&list) == &var1.node);
+    unrolled_list_remove(&list, &var1.node);
+    assert(unrolled_list_front(&list) == &var2.node);
+}
+
+void test_unrolled_list_back(void) {
+    assert(unrolled_list_back(&list) == NULL);
+    unrolled_list_insert_back(&list, &var2.node);
+    assert(unrolled_list_back(&list) == &var2.node);
+    unrolled_list_insert_front(&list, &var1.node);
+    unrolled_list_insert_back(&list, &var3.node);
+    assert(unrolled_list_back(&list) == &var3.node);
+    unrolled_list_remove(&list, &var3.node);
+    assert(unrolled_list_back(&list) == &var2.node);
+}
+
+void test_unrolled_list_prev(void) {
+    size_t i;
+
+    assert(unrolled_list_prev(NULL) == NULL);
+    unrolled_list_insert_back(&list, &var1.node);
+    assert(unrolled_list_prev(&var1.node) == NULL);
+
+    for (i = 0; i < NUM_BIG_VARS; ++i) {
+        unrolled_list_insert_back(&list, &big_vars[i].node);
+    }
+    assert(unrolled_list_prev(&big_vars[0].node) == &var1.node);
+    for (i = 1; i < NUM_BIG_VARS; ++i) {
+        assert(unrolled_list_prev(&big_vars[i].node) == &big_vars[i - 1].node);
+    }
+}
+
+void test_unrolled_list_next(void) {
+    size_t i;
+
+    assert(unrolled_list_next(NULL) == NULL);
+    unrolled_list_insert_back(&list, &var1.node);
+    assert(unrolled_list_next(&var1.node) == NULL);
+
+    for (i = 0; i < NUM_BIG_VARS; ++i) {
+        unrolled_list_insert_front(&list, &big_vars[i].node);
+    }
+    assert(unrolled_list_next(&big_vars[0].node) == &var1.node);
+    for (i = 1; i < NUM_BIG_VARS; ++i) {
+        assert(unrolled_list_next(&big_vars[i].node) == &big_vars[i - 1].node);
+    }
+}
+
+void test_unrolled_list_size(void) {
+    assert(unrolled_list_size(&list) == 0);
+    unrolled_list_insert_back(&list, &var1.node);
+    assert(unrolled_list_size(&list) == 1);
+    unrolled_list_insert_front(&list, &var2.node);
+    assert(unrolled_list_size(&list) == 2);
+    unrolled_list_remove(&list, &var1.node);
+    assert(unrolled_list_size(&list) == 1);
+}
+
+void test_unrolled_list_empty(void) {
+    assert(unrolled_list_empty(&list) == 1);
+    unrolled_list_insert_back(&list, &var1.node);
+    assert(unrolled_list_empty(&list) == 0);
+    unrolled_list_remove(&list, &var1.node);
+    assert(unrolled_list_empty(&list) == 1);
+}
+
+void test_unrolled_list_insert_front(void) {
+    size_t i;
+
+    assert(unrolled_list_insert_front(&list, &big_vars[0].node) == 1);
+    model[0] = &big_vars[0].node;
+    assert_matches_model_(&list, 1);
+
+    for (i = 1; i < NUM_BIG_VARS; ++i) {
+        assert(unrolled_list_insert_front(&list, &big_vars[i].node) == 1);
+    }
+    for (i = 0; i < NUM_BIG_VARS; ++i) {
+        model[i] = &big_vars[NUM_BIG_VARS - 1 - i].node;
+    }
+    assert_matches_model_(&list, NUM_BIG_VARS);
+
+    /* Front insertions fill the chunks completely. */
+    assert(num_chunks == (NUM_BIG_VARS + UNROLLED_LIST_CHUNK_CAPACITY - 1) / UNROLLED_LIST_CHUNK_CAPACITY);
+
+    /* A failed allocation leaves the list unchanged. */
+    unrolled_list_remove_all(&list);
+    fail_allocations = 1;
+    assert(unrolled_list_insert_front(&list, &var1.node) == 0);
+    assert_matches_model_(&list, 0);
+    fail_allocations = 0;
+
+    for (i = 0; i < UNROLLED_LIST_CHUNK_CAPACITY; ++i) {
+        assert(unrolled_list_insert_front(&list, &big_vars[i].node) == 1);
+        model[UNROLLED_LIST_CHUNK_CAPACITY - 1 - i] = &big_vars[i].node;
+    }
+    fail_allocations = 1;
+    assert(unrolled_list_insert_front(&list, &var1.node) == 0);
+    assert_matches_model_(&list, UNROLLED_LIST_CHUNK_CAPACITY);
+
+    /* The back chunk has room once a node is removed from it, so no allocation is needed. */
+    unrolled_list_remove_back(&list);
+    assert(unrolled_list_insert_front(&list, &var1.node) == 1);
+    memmove(model + 1, model, (UNROLLED_LIST_CHUNK_CAPACITY - 1) * sizeof(UnrolledListNode*));
+    model[0] = &var1.node;
+    assert_matches_model_(&list, UNROLLED_LIST_CHUNK_CAPACITY);
+}
+
+void test_unrolled_list_insert_back(void) {
+    size_t i;
+
+    assert(unrolled_list_insert_back(&list, &big_vars[0].node) == 1);
+    model[0] = &big_vars[0].node;
+    assert_matches_model_(&list, 1);
+
+    for (i = 1; i < NUM_BIG_VARS; ++i) {
+        assert(unrolled_list_insert_back(&list, &big_vars[i].node) == 1);
+        model[i] = &big_vars[i].node;
+    }
+    assert_matches_model_(&list, NUM_BIG_VARS);
+
+    /* Back insertions fill the chunks completely. */
+    assert(num_chunks == (NUM_BIG_VARS + UNROLLED_LIST_CHUNK_CAPACITY - 1) / UNROLLED_LIST_CHUNK_CAPACITY);
+
+    /* A failed allocation leaves the list unchanged. */
+    unrolled_list_remove_all(&list);
+    fail_allocations = 1;
+    assert(unrolled_list_insert_back(&list, &var1.node) == 0);
+    assert_matches_model_(&list, 0);
+    fail_allocations = 0;
+
+    for (i = 0; i < UNROLLED_LIST_CHUNK_CAPACITY; ++i) {
+        assert(unrolled_list_insert_back(&list, &big_vars[i].node) == 1);
+        model[i] = &big_vars[i].node;
+    }
+    fail_allocations = 1;
+    assert(unrolled_list_insert_back(&list, &var1.node) == 0);
+    assert_matches_model_(&list, UNROLLED_LIST_CHUNK_CAPACITY);
+
+    /* The front chunk has room once a node is removed from it, so no allocation is needed. */
+    unrolled_list_remove_front(&list);
+    assert(unrolled_list_insert_back(&list, &var1.node) == 1);
+    memmove(model, model + 1, (UNROLLED_LIST_CHUNK_CAPACITY - 1) * sizeof(UnrolledListNode*));
+    model[UNROLLED_LIST_CHUNK_CAPACITY - 1] = &var1.node;
+    assert_matches_model_(&list, UNROLLED_LIST_CHUNK_CAPACITY);
+
+    /* Alternating insertions at both ends of a single chunk. */
+    unrolled_list_remove_all(&list);
+    fail_allocations = 0;
+    for (i = 0; i < UNROLLED_LIST_CHUNK_CAPACITY; ++i) {
+        if (i % 2) {
+            unrolled_list_insert_back(&list, &big_vars[i].node);
+        } else {
+            unrolled_list_insert_front(&list, &big_vars[i].node);
+        }
+    }
+    for (i = 0; i < UNROLLED_LIST_CHUNK_CAPACITY / 2; ++i) {
+        model[UNROLLED_LIST_CHUNK_CAPACITY / 2 - 1 - i] = &big_vars[2 * i].node;
+        model[UNROLLED_LIST_CHUNK_CAPACITY / 2 + i] = &big_vars[2 * i + 1].node;
+    }
+    assert_matches_model_(&list, UNROLLED_LIST_CHUNK_CAPACITY);
+    assert(num_chunks == 1);
+}
+
+void test_unrolled_list_remove(void) {
+    size_t i, size;
+
+    unrolled_list_remove(&list, NULL);
+    assert_matches_model_(&list, 0);
+
+    unrolled_list_insert_back(&list, &var1.node);
+    unrolled_list_insert_back(&list, &var2.node);
+    unrolled_list_insert_back(&list, &var3.node);
+    unrolled_list_remove(&list, &var2.node);
+    assert(var2.node.chunk == UNROLLED_LIST_POISON_CHUNK);
+    model[0] = &var1.node;
+    model[1] = &var3.node;
+    assert_matches_model_(&list, 2);
+    unrolled_list_remove(&list, &var1.node);
+    unrolled_list_remove(&list, &var3.node);
+    assert_matches_model_(&list, 0);
+
+    /* Removing random nodes, which merges sparse chunks. */
+    for (i = 0; i < NUM_BIG_VARS; ++i) {
+        unrolled_list_insert_back(&list, &big_vars[i].node);
+        model[i] = &big_vars[i].node;
+    }
+    for (size = NUM_BIG_VARS; size > 0; --size) {
+        i = (size_t) rand() % size;
+        unrolled_list_remove(&list, model[i]);
+        assert(model[i]->chunk == UNROLLED_LIST_POISON_CHUNK);
+        memmove(model + i, model + i + 1, (size - i - 1) * sizeof(UnrolledListNode*));
+        assert_matches_model_(&list, size - 1);
+
+        /* Sparse chunks are merged, so the list never spreads over many more chunks than it needs. */
+        assert(num_chunks <= 4 * (size - 1) / UNROLLED_LIST_CHUNK_CAPACITY + 2);
+    }
+    assert(num_chunks == 0);
+}
+
+void test_unrolled_list_remove_front(void) {
+    size_t i;
+
+    unrolled_list_remove_front(&list);
+    assert_matches_model_(&list, 0);
+
+    for (i = 0; i < NUM_BIG_VARS; ++i) {
+        unrolled_list_insert_back(&list, &big_vars[i].node);
+    }
+    for (i = 0; i < NUM_BIG_VARS; ++i) {
+        assert(unrolled_list_front(&list) == &big_vars[i].node);
+        unrolled_list_remove_front(&list);
+        assert(big_vars[i].node.chunk == UNROLLED_LIST_POISON_CHUNK);
+        assert(unrolled_list_size(&list) == NUM_BIG_VARS - 1 - i);
+    }
+    assert_matches_model_(&list, 0);
+
+    /* Used as a queue, the list keeps at most two partially filled chunks. */
+    for (i = 0; i < NUM_BIG_VARS; ++i) {
+        unrolled_list_insert_back(&list, &big_vars[i].node);
+        if (i >= 2 * UNROLLED_LIST_CHUNK_CAPACITY) {
+            unrolled_list_remove_front(&list);
+        }
+        assert(num_chunks <= 3);
+    }
+    for (i = 0; i < 2 * UNROLLED_LIST_CHUNK_CAPACITY; ++i) {
+        model[i] = &big_vars[NUM_BIG_VARS - 2 * UNROLLED_LIST_CHUNK_CAPACITY + i].node;
+    }
+    assert_matches_model_(&list, 2 * UNROLLED_LIST_CHUNK_CAPACITY);
+}
+
+void test_unrolled_list_remove_back(void) {
+    size_t i;
+
+    unrolled_list_remove_back(&list);
+    assert_matches_model_(&list, 0);
+
+    for (i = 0; i < NUM_BIG_VARS; ++i) {
+        unrolled_list_insert_front(&list, &big_vars[i].node);
+    }
+    for (i = 0; i < NUM_BIG_VARS; ++i) {
+        assert(unrolled_list_back(&list) == &big_vars[i].node);
+        unrolled_list_remove_back(&list);
+        assert(big_vars[i].node.chunk == UNROLLED_LIST_POISON_CHUNK);
+        assert(unrolled_list_size(&list) == NUM_BIG_VARS - 1 - i);
+    }
+    assert_matches_model_(&list, 0);
+
+    /* Used as a stack, the list does not thrash between allocating and freeing a chunk. */
+    for (i = 0; i < UNROLLED_LIST_CHUNK_CAPACITY + 1; ++i) {
+        unrolled_list_insert_back(&list, &big_vars[i].node);
+        model[i] = &big_vars[i].node;
+    }
+    for (i = 0; i < 10; ++i) {
+        unrolled_list_remove_back(&list);
+        unrolled_list_insert_back(&list, &big_vars[UNROLLED_LIST_CHUNK_CAPACITY].node);
+    }
+    assert_matches_model_(&list, UNROLLED_LIST_CHUNK_CAPACITY + 1);
+}
+
+void test_unrolled_list_remove_all(void) {
+    size_t i;
+
+    unrolled_list_remove_all(&list);
+    assert_matches_model_(&list, 0);
+
+    for (i = 0; i < NUM_BIG_VARS; ++i) {
+        unrolled_list_insert_back(&list, &big_vars[i].node);
+    }
+    unrolled_list_remove_all(&list);
+    assert(num_chunks == 0);
+    assert_matches_model_(&list, 0);
+
+    /* The list can be reused. */
+    unrolled_list_insert_front(&list, &var1.node);
+    model[0] = &var1.node;
+    assert_matches_model_(&list, 1);
+}
+
+void test_unrolled_list_entry(void) {
+    UnrolledListNode *n;
+
+    unrolled_list_insert_back(&list, &var1.node);
+    unrolled_list_insert_back(&list, &var2.node);
+
+    n = unrolled_list_front(&list);
+    assert(unrolled_list_entry(n, TestStruct, node) == &var1);
+    assert(unrolled_list_entry(n, TestStruct, node)->val == 1);
+    n = unrolled_list_next(n);
+    assert(unrolled_list_entry(n, TestStruct, node) == &var2);
+    assert(unrolled_list_entry(n, TestStruct, node)->val == 2);
+}
+
+void test_unrolled_list_for_each(void) {
+    UnrolledListChunk *chunk;
+    UnrolledListNode *n;
+    size_t index, i = 0;
+
+    unrolled_list_for_each(n, chunk, index, &list) {
+        assert(0);
+    }
+
+    for (i = 0; i < NUM_BIG_VARS; ++i) {
+        if (i % 3) {
+            unrolled_list_insert_back(&list, &big_vars[i].node);
+        }
+    }
+    for (i = 0; i < NUM_BIG_VARS; i += 3) {
+        unrolled_list_insert_front(&list, &big_vars[i].node);
+    }
+
+    /* The front holds the multiples of 3 in reverse, followed by the others in order. */
+    i = 0;
+    unrolled_list_for_each(n, chunk, index, &list) {
+        assert(n->chunk == chunk && n->index == index);
+        model[i++] = n;
+    }
+    assert(i == NUM_BIG_VARS);
+    assert(unrolled_list_entry(model[0], TestStruct, node)->val == (NUM_BIG_VARS - 1) / 3 * 3);
+    assert(unrolled_list_entry(model[NUM_BIG_VARS - 1], TestStruct, node)->val == NUM_BIG_VARS - 2);
+    for (i = 1; i < NUM_BIG_VARS; ++i) {
+        assert(unrolled_list_next(model[i - 1]) == model[i]);
+    }
+
+    /* Breaking out of the loop leaves the cursor on the current node. */
+    unrolled_list_for_each(n, chunk, index, &list) {
+        if (unrolled_list_entry(n, TestStruct, node)->val == 1) {
+            break;
+        }
+    }
+    assert(n == &big_vars[1].node && chunk == n->chunk && index == n->index);
+}
+
+void test_unrolled_list_for_each_reverse(void) {
+    UnrolledListChunk *chunk;
+    UnrolledListNode *n;
+    size_t index, i;
+
+    unrolled_list_for_each_reverse(n, chunk, index, &list) {
+        assert(0);
+    }
+
+    for (i = 0; i < NUM_BIG_VARS; ++i) {
+        unrolled_list_insert_back(&list, &big_vars[i].node);
+    }
+    for (i = 0; i < NUM_BIG_VARS; i += 2) {
+        unrolled_list_remove(&list, &big_vars[i].node);
+    }
+
+    i = NUM_BIG_VARS;
+    unrolled_list_for_each_reverse(n, chunk, index, &list) {
+        i -= 2;
+        assert(n == &big_vars[i + 1].node);
+        assert(n->chunk == chunk && n->index == index - 1);
+    }
+    assert(i == 0);
+
+    /* Breaking out of the loop leaves the cursor on the current node. */
+    unrolled_list_for_each_reverse(n, chunk, index, &list) {
+        if (unrolled_list_entry(n, TestStruct, node)->val == 1) {
+            break;
+        }
+    }
+    assert(n == &big_vars[1].node && chunk == n->chunk && index == n->index + 1);
+}
+
+TestFunc test_funcs[] = {
+    test_unrolled_list_init,
+    test_unrolled_list_front,
+    test_unrolled_list_back,
+    test_unrolled_list_prev,
+    test_unrolled_list_next,
+    test_unrolled_list_size,
+    test_unrolled_list_empty,
+    test_unrolled_list_insert_front,
+    test_unrolled_list_insert_back,
+    test_unrolled_list_remove,
+    test_unrolled_list_remove_front,
+    test_unrolled_list_remove_back,
+    test_unrolled_list_remove_all,
+    test_unrolled_list_entry,
+    test_unrolled_list_for_each,
+    test_unrolled_list_for_each_reverse
+};
+
+int main(int argc, char *argv[]) {
+    char msg[100] = "UnrolledList ";
+    assert(argc == 2);
+    strcat(msg, argv[1]);
+
+    assert(sizeof(test_funcs) / sizeof(TestFunc) == 16);
+    run_tests(test_funcs, sizeof(test_funcs) / sizeof(TestFunc), msg, reset_globals);
+
+    return 0;
+}